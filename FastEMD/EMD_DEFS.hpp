@@ -7,6 +7,14 @@
 typedef int NODE_T;
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+// The min cost flow solver used by emd_hat and emd_hat_gd_metric
+enum MIN_COST_FLOW_T {
+    SUCCESSIVE_SHORTEST_PATH= 0, // min_cost_flow.hpp
+    NETWORK_SIMPLEX              // network_simplex.hpp, warm starts between calls
+};
+//------------------------------------------------------------------------------
+
 #endif 
 
 // Copyright (c) 2009-2012, Ofir Pele
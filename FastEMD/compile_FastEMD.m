@@ -1,5 +1,11 @@
 mex -O -DNDEBUG emd_hat_gd_metric_mex.cxx 
 mex -O -DNDEBUG emd_hat_mex.cxx
+% multithreaded with OpenMP
+if (ispc)
+    mex -O -DNDEBUG COMPFLAGS="$COMPFLAGS /openmp" emd_hat_pairwise_mex.cxx
+else
+    mex -O -DNDEBUG CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" emd_hat_pairwise_mex.cxx
+end
 
 % Copyright (c) 2009-2012, Ofir Pele
 % All rights reserved.
@@ -148,12 +148,24 @@ int main( int argc, char* argv[]) {
     timer.toc();
     std::cout << "emd_hat time in seconds: " << timer.totalTimeSec() << std::endl;
 
+    timer.clear();
+    timer.tic();
+    int emd_hat_network_simplex_val= emd_hat<int,NO_FLOW,NETWORK_SIMPLEX>()(im1,im2, cost_mat,THRESHOLD);
+    timer.toc();
+    std::cout << "emd_hat (network simplex) time in seconds: " << timer.totalTimeSec() << std::endl;
+
     timer.clear();
     timer.tic();
     int emd_hat_signatures_interface_val= emd_hat_signature_interface<int>(&Psig2, &Qsig2, cost_mat_dist_int,-1);
     timer.toc();
     std::cout << "emd_hat_signatures_interface time in seconds: " << timer.totalTimeSec() << std::endl;
 
+    timer.clear();
+    timer.tic();
+    int emd_hat_thresholded_signature_interface_val= emd_hat_thresholded_signature_interface<int>()(&Psig2, &Qsig2, cost_mat_dist_int,THRESHOLD,THRESHOLD);
+    timer.toc();
+    std::cout << "emd_hat_thresholded_signature_interface time in seconds: " << timer.totalTimeSec() << std::endl;
+
     #ifdef COMPUTE_RUBNER_VERSION
     timer.clear();
     timer.tic();
@@ -184,7 +196,9 @@ int main( int argc, char* argv[]) {
     delete[] Qsig2.Weights;
 
     if (emd_hat_gd_metric_val!=emd_hat_val||
-        emd_hat_gd_metric_val!=emd_hat_signatures_interface_val
+        emd_hat_gd_metric_val!=emd_hat_network_simplex_val||
+        emd_hat_gd_metric_val!=emd_hat_signatures_interface_val||
+        emd_hat_gd_metric_val!=emd_hat_thresholded_signature_interface_val
         #ifdef COMPUTE_RUBNER_VERSION
         || emd_hat_gd_metric_val!=emd_rubner_val
         #endif
@@ -192,7 +206,9 @@ int main( int argc, char* argv[]) {
         std::cerr << "EMDs that were computed with different interfaces are different!" << std::endl;
         std::cerr << "emd_hat_gd_metric_val==" << emd_hat_gd_metric_val << std::endl;
         std::cerr << "emd_hat_val==" << emd_hat_val << std::endl;
+        std::cerr << "emd_hat_network_simplex_val==" << emd_hat_network_simplex_val << std::endl;
         std::cerr << "emd_hat_signatures_interface_val==" << emd_hat_signatures_interface_val << std::endl;
+        std::cerr << "emd_hat_thresholded_signature_interface_val==" << emd_hat_thresholded_signature_interface_val << std::endl;
         #ifdef COMPUTE_RUBNER_VERSION
         std::cerr << "emd_rubner_val==" << emd_rubner_val << std::endl;
         #endif
@@ -0,0 +1,115 @@
+#include "mex.h"
+#include "color_spatial_ground_distance.hpp"
+#include "../emd_hat_thresholded.hpp"
+#include <vector>
+
+using namespace std;
+
+// adds the pairs to the sparse thresholded ground distance
+struct add_to_thresholded_ground_distance {
+    thresholded_ground_distance<double>* C;
+    void operator()(int i, int j, double dist) {
+        C->add(i,j,dist);
+    }
+}; // add_to_thresholded_ground_distance
+
+
+// The ground distance and the solver of the last call. The ground distance is
+// recomputed only if the images or the distance parameters change, so calling
+// again with other weights (or extra_mass_penalty) only warm starts the solver.
+static thresholded_ground_distance<double> last_C;
+static emd_hat_thresholded<double> last_emd;
+static vector<double> last_key;
+
+static void make_key(const color_spatial_input& input, vector<double>& key) {
+    key.clear();
+    key.push_back(input.im1_X);
+    key.push_back(input.im1_Y);
+    key.push_back(input.im2_X);
+    key.push_back(input.im2_Y);
+    key.push_back(input.alpha_color);
+    key.push_back(input.threshold);
+    key.push_back(input.t);
+    key.insert(key.end(), input.im1, input.im1+3*input.im1_N);
+    key.insert(key.end(), input.im2, input.im2+3*input.im2_N);
+} // make_key
+
+static void get_weights(const mxArray* w, int n, const char* name, vector<double>& v) {
+    if (w==NULL || mxIsEmpty(w)) {
+        v.assign(n,1.0);
+        return;
+    }
+    if (!mxIsDouble(w) || mxIsComplex(w) || static_cast<int>(mxGetNumberOfElements(w))!=n) {
+        mexPrintf("%s ",name);
+        mexErrMsgTxt("should be a double array with one weight per pixel");
+    }
+    const double* p= mxGetPr(w);
+    v.assign(p,p+n);
+} // get_weights
+
+
+void mexFunction(int nout, mxArray *out[],
+                 int nin, const mxArray *in[]) {
+
+    //----------------------------------------------------------------------
+    // extract input
+    //----------------------------------------------------------------------
+    color_spatial_input input(nin,in);
+    if (nin>8) mexErrMsgTxt("Too many input arguments");
+    if (nout>2) mexErrMsgTxt("Too many output arguments");
+
+    vector<double> P,Q;
+    get_weights(nin>5 ? in[5] : NULL, input.im1_N, "P", P);
+    get_weights(nin>6 ? in[6] : NULL, input.im2_N, "Q", Q);
+    double extra_mass_penalty= -1;
+    if (nin>7) extra_mass_penalty= mxGetScalar(in[7]);
+    //----------------------------------------------------------------------
+
+    //----------------------------------------------------------------------
+    // sparse ground distance, only pairs closer than the threshold
+    //----------------------------------------------------------------------
+    vector<double> key;
+    make_key(input,key);
+    if (key!=last_key) {
+        last_C.reset(input.im1_N,input.im2_N,input.threshold);
+        add_to_thresholded_ground_distance f;
+        f.C= &last_C;
+        for_each_color_spatial_pair(input,f);
+        last_key.swap(key);
+    }
+    //----------------------------------------------------------------------
+
+    //----------------------------------------------------------------------
+    // emd_hat and the output
+    //----------------------------------------------------------------------
+    vector<double> F;
+    out[0]= mxCreateDoubleScalar(last_emd(P,Q,last_C,extra_mass_penalty, nout>1 ? &F : NULL));
+
+    if (nout>1) {
+        mwSize nnz= 0;
+        {for (size_t a=0; a<F.size(); ++a) if (F[a]!=0) ++nnz;}
+        // pairs of each pixel of im1 are consecutive, in increasing im2 order,
+        // so the transpose of F is filled column by column.
+        mxArray* Ft= mxCreateSparse(input.im2_N,input.im1_N,nnz,mxREAL);
+        double* pr= mxGetPr(Ft);
+        mwIndex* ir= mxGetIr(Ft);
+        mwIndex* jc= mxGetJc(Ft);
+        mwIndex k= 0;
+        NODE_T a= 0;
+        {for (int i=0; i<input.im1_N; ++i) {
+            jc[i]= k;
+            for (; a<last_C.num_pairs() && last_C.from(a)==i; ++a) {
+                if (F[a]==0) continue;
+                ir[k]= last_C.to(a);
+                pr[k]= F[a];
+                ++k;
+            }
+        }}
+        jc[input.im1_N]= k;
+        mxArray* rhs[1]= { Ft };
+        mexCallMATLAB(1,&out[1],1,rhs,"transpose");
+        mxDestroyArray(Ft);
+    }
+    //----------------------------------------------------------------------
+    
+} // mexFunction
@@ -0,0 +1,36 @@
+% [dist F]= color_spatial_emd_hat(im1,im2,alpha_color,threshold,coordinates_transformation,P,Q,extra_mass_penalty)
+%
+% Computes emd_hat between im1 and im2 (ims should be in L*a*b* space)
+% with the thresholded color-spatial ground distance of
+% color_spatial_EMD_ground_distance, without creating the N*N ground
+% distance matrix (N=numel(im1)/3+numel(im2)/3). Only pairs of pixels that
+% are closer than the threshold are kept, so memory is near linear in the
+% number of pixels and large images can be compared. The result is the
+% same as:
+%  D= color_spatial_EMD_ground_distance(im1,im2,alpha_color,threshold,coordinates_transformation);
+%  dist= emd_hat_mex([P(:);zeros(im2_N,1)],[zeros(im1_N,1);Q(:)],D,extra_mass_penalty);
+%
+% The sparse ground distance of the last call is cached. Calling again
+% with the same images and distance parameters (e.g. with other P,Q)
+% does not recompute it, and the solver starts from the last solution.
+%
+% Required params:
+% im1,im2,alpha_color,threshold,coordinates_transformation - see
+%  color_spatial_EMD_ground_distance.
+%
+% Optional params:
+% P - weights of the pixels of im1 (numel(im1)/3 doubles). Default or []
+%     is one for each pixel.
+% Q - weights of the pixels of im2. Default or [] is one for each pixel.
+% extra_mass_penalty - see emd_hat_mex. Default value is -1 which means the
+%                      threshold (the maximum distance).
+%
+% Returns:
+% dist - emd_hat
+% F - sparse im1_N x im2_N flow between the pixels of im1 and the pixels of
+%     im2. Flow through the transhipment vertex (pixels that are farther
+%     than the threshold) is not returned, that is F is like flowType 2 of
+%     emd_hat_mex (WITHOUT_TRANSHIPMENT_FLOW).
+%
+% Compile with (in this directory):
+%  mex -O -DNDEBUG color_spatial_emd_hat.cxx
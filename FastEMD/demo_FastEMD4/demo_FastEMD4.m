@@ -80,6 +80,17 @@ tic
 [emd_hat_mex_val_with_flow F]= emd_hat_mex(P,Q,ground_distance_matrix,extra_mass_penalty,flowType);
 fprintf(1,'Note that the ground distance here is not a metric.\n');
 fprintf(1,'emd_hat_mex, time in seconds: %f\n',toc);
+
+% The same distance without the N*N ground distance matrix. Only pairs of
+% pixels that are closer than the threshold are kept, so this can be used
+% for much larger images (e.g. imresize with 1/5 instead of 1/30).
+tic
+[emd_hat_sparse_val F_sparse]= color_spatial_emd_hat(im1_lab,im2_lab,...
+                                                     alpha_color,threshold, ...
+                                                     coordinates_transformation,...
+                                                     [],[],extra_mass_penalty);
+fprintf(1,'color_spatial_emd_hat, time in seconds: %f\n',toc);
+assert(abs(emd_hat_sparse_val-emd_hat_mex_val_with_flow)<=1e-6*emd_hat_mex_val_with_flow);
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 
@@ -27,6 +27,13 @@ tic
 [emd_hat_mex_val_with_flow F2]= emd_hat_mex(P,Q,D,extra_mass_penalty,flowType);
 fprintf(1,'emd_hat_mex computing the flow also, time in seconds: %f\n',toc);
 
+% Many distances - all pairs of the columns of [P Q] with one call, in
+% parallel. Use this instead of calling emd_hat_mex in a double loop.
+tic
+emd_hat_pairwise_mex_val= emd_hat_pairwise_mex([P(:) Q(:)],[],D,extra_mass_penalty);
+fprintf(1,'emd_hat_pairwise_mex (all pairs of P and Q) time in seconds: %f\n',toc);
+assert(abs(double(emd_hat_pairwise_mex_val(1,2))-double(emd_hat_mex_val))<=1e-9*abs(double(emd_hat_mex_val)));
+
 %  %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %  % Comparison with Rubner (much slower than my versions) -
 %  % You'll need to:
@@ -2,9 +2,12 @@
 #define EMD_HAT_HPP
 
 #include <vector>
+#include <cstddef>
 #include "EMD_DEFS.hpp"
 #include "flow_utils.hpp"
 
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE> struct emd_hat_impl;
+
 /// Fastest version of EMD. Also, in my experience metric ground distance yields better
 /// performance. 
 ///
@@ -37,23 +40,33 @@
 ///           == WITHOUT_EXTRA_MASS_FLOW - fills F with the flows between all bins, except the flow
 ///              to the extra mass bin.
 ///           Note that if F is the default NULL then FLOW_TYPE must be NO_FLOW.
-template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE= NO_FLOW>
+/// MCF_TYPE == SUCCESSIVE_SHORTEST_PATH - the original min cost flow solver.
+///          == NETWORK_SIMPLEX - a network simplex on flat arrays. The object keeps the
+///             graph and the last solution, so when computing many distances with the
+///             same ground distance, reuse one object; each call then starts from the
+///             previous optimal tree and no graph is rebuilt.
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE= NO_FLOW, MIN_COST_FLOW_T MCF_TYPE= SUCCESSIVE_SHORTEST_PATH>
 struct emd_hat_gd_metric {
     NUM_T operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
                      const std::vector< std::vector<NUM_T> >& C,
                      NUM_T extra_mass_penalty= -1,
                      std::vector< std::vector<NUM_T> >* F= NULL);
+private:
+    std::vector<NUM_T> _P;
+    std::vector<NUM_T> _Q;
+    emd_hat_impl<NUM_T,FLOW_TYPE,MCF_TYPE> _impl;
 };
 
 /// Same as emd_hat_gd_metric, but does not assume metric property for the ground distance (C).
 /// Note that C should still be symmetric and non-negative!
-template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE= NO_FLOW>
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE= NO_FLOW, MIN_COST_FLOW_T MCF_TYPE= SUCCESSIVE_SHORTEST_PATH>
 struct emd_hat {
     NUM_T operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
                      const std::vector< std::vector<NUM_T> >& C,
                      NUM_T extra_mass_penalty= -1,
                      std::vector< std::vector<NUM_T> >* F= NULL);
-        
+private:
+    emd_hat_impl<NUM_T,FLOW_TYPE,MCF_TYPE> _impl;
 };
 
 #include "emd_hat_impl.hpp"
@@ -6,6 +6,7 @@
 //=======================================================================================
 
 #include "min_cost_flow.hpp"
+#include "network_simplex.hpp"
 #include <set>
 #include <limits>
 #include <cassert>
@@ -21,11 +22,15 @@ void fillFWithZeros(std::vector< std::vector<NUM_T> >& F) {
     }
 }
         
-// Forward declarations 
-template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE> struct emd_hat_impl;
+// C[i][j], or C[j][i] if transposed (instead of copying a transposed C)
+template<typename NUM_T>
+inline NUM_T ground_dist(const std::vector< std::vector<NUM_T> >& C, bool transposed,
+                         NODE_T i, NODE_T j) {
+    return transposed ? C[j][i] : C[i][j];
+}
 
-template<typename NUM_T,FLOW_TYPE_T FLOW_TYPE>
-NUM_T emd_hat_gd_metric<NUM_T,FLOW_TYPE>::operator()(const std::vector<NUM_T>& Pc, const std::vector<NUM_T>& Qc,
+template<typename NUM_T,FLOW_TYPE_T FLOW_TYPE,MIN_COST_FLOW_T MCF_TYPE>
+NUM_T emd_hat_gd_metric<NUM_T,FLOW_TYPE,MCF_TYPE>::operator()(const std::vector<NUM_T>& Pc, const std::vector<NUM_T>& Qc,
                                                      const std::vector< std::vector<NUM_T> >& C,
                                                      NUM_T extra_mass_penalty,
                                                      std::vector< std::vector<NUM_T> >* F) {
@@ -34,8 +39,11 @@ NUM_T emd_hat_gd_metric<NUM_T,FLOW_TYPE>::operator()(const std::vector<NUM_T>& P
         
     assert( (F!=NULL) || (FLOW_TYPE==NO_FLOW) );
     
-    std::vector<NUM_T> P= Pc;
-    std::vector<NUM_T> Q= Qc;
+    // members, so that repeated calls do not allocate
+    std::vector<NUM_T>& P= _P;
+    std::vector<NUM_T>& Q= _Q;
+    P= Pc;
+    Q= Qc;
     
     // Assuming metric property we can pre-flow 0-cost edges
     {for (NODE_T i=0; i<P.size(); ++i) {
@@ -54,18 +62,18 @@ NUM_T emd_hat_gd_metric<NUM_T,FLOW_TYPE>::operator()(const std::vector<NUM_T>& P
             }
     }}
 
-    return emd_hat_impl<NUM_T,FLOW_TYPE>()(Pc,Qc,P,Q,C,extra_mass_penalty,F);
+    return _impl(Pc,Qc,P,Q,C,extra_mass_penalty,F);
     
 } // emd_hat_gd_metric
 
-template<typename NUM_T,FLOW_TYPE_T FLOW_TYPE>
-NUM_T emd_hat<NUM_T,FLOW_TYPE>::operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
+template<typename NUM_T,FLOW_TYPE_T FLOW_TYPE,MIN_COST_FLOW_T MCF_TYPE>
+NUM_T emd_hat<NUM_T,FLOW_TYPE,MCF_TYPE>::operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
                                            const std::vector< std::vector<NUM_T> >& C,
                                            NUM_T extra_mass_penalty,
                                            std::vector< std::vector<NUM_T> >* F) {
 
     if (FLOW_TYPE!=NO_FLOW) fillFWithZeros(*F);
-    return emd_hat_impl<NUM_T,FLOW_TYPE>()(P,Q,P,Q,C,extra_mass_penalty,F);
+    return _impl(P,Q,P,Q,C,extra_mass_penalty,F);
 
 } // emd_hat
 
@@ -75,7 +83,7 @@ NUM_T emd_hat<NUM_T,FLOW_TYPE>::operator()(const std::vector<NUM_T>& P, const st
 //-----------------------------------------------------------------------------------------------
 
 // Blocking instantiation for a non-overloaded template param
-template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE>
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
 struct emd_hat_impl {
         
 }; // emd_hat_impl
@@ -84,7 +92,7 @@ struct emd_hat_impl {
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 // Main implementation
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
-template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE>
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
 struct emd_hat_impl_integral_types {
 
     NUM_T operator()(
@@ -101,7 +109,6 @@ struct emd_hat_impl_integral_types {
     // Ensuring that the supplier - P, have more mass.
     std::vector<NUM_T> P;
     std::vector<NUM_T> Q;
-    std::vector< std::vector<NUM_T> > C(Cc);
     NUM_T abs_diff_sum_P_sum_Q;
     NUM_T sum_P= 0;
     NUM_T sum_Q= 0;
@@ -112,12 +119,6 @@ struct emd_hat_impl_integral_types {
         needToSwapFlow= true;
         P= Qc;
         Q= Pc;
-        // transpose C
-        for (NODE_T i=0; i<N; ++i) {
-            for (NODE_T j=0; j<N; ++j) {
-                C[i][j]= Cc[j][i];
-            }
-        }
         abs_diff_sum_P_sum_Q= sum_Q-sum_P;
     } else {
         P= Pc;
@@ -150,8 +151,8 @@ struct emd_hat_impl_integral_types {
     NUM_T maxC= 0;
     {for (NODE_T i=0; i<N; ++i) {
         {for (NODE_T j=0; j<N; ++j) {
-                assert(C[i][j]>=0);
-                if ( C[i][j]>maxC ) maxC= C[i][j];
+                assert(Cc[i][j]>=0);
+                if ( Cc[i][j]>maxC ) maxC= Cc[i][j];
         }}
     }}
     if (extra_mass_penalty==-1) extra_mass_penalty= maxC;
@@ -173,8 +174,9 @@ struct emd_hat_impl_integral_types {
         if (b[i]==0) continue;
         {for (NODE_T j=0; j<N; ++j) {
             if (b[j+N]==0) continue;
-            if (C[i][j]==maxC) continue;
-            c[i].push_back( edge<NUM_T>(j+N , C[i][j]) );
+            NUM_T Cij= ground_dist(Cc,needToSwapFlow,i,j);
+            if (Cij==maxC) continue;
+            c[i].push_back( edge<NUM_T>(j+N , Cij) );
             }} // j
     }}// i
 
@@ -183,7 +185,7 @@ struct emd_hat_impl_integral_types {
         if (b[i]==0) continue;
         {for (NODE_T j=0; j<N; ++j) {
             if (b[j+N]==0) continue;
-            if (C[i][j]==maxC) continue;
+            if (ground_dist(Cc,needToSwapFlow,i,j)==maxC) continue;
             sources_that_flow_not_only_to_thresh.insert(i);
             sinks_that_get_flow_not_only_from_thresh.insert(j+N);
         }} // j
@@ -335,13 +337,135 @@ struct emd_hat_impl_integral_types {
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+// Network simplex implementation
+// The graph contains all sources, sinks and the threshold node (zero supply nodes
+// are kept) so that it depends only on C. It is rebuilt only when C changes and
+// the network simplex warm starts from the last tree otherwise. The root of the
+// network simplex plays the role of the artificial node of the main implementation.
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+template<typename NUM_T, FLOW_TYPE_T FLOW_TYPE>
+struct emd_hat_impl_integral_types<NUM_T,FLOW_TYPE,NETWORK_SIMPLEX> {
+
+    network_simplex<NUM_T> _mcf;
+    std::vector<NUM_T> _C; // C of the last call (transposed if needed), row major
+    std::vector<NUM_T> _b;
+    std::vector<NODE_T> _from;
+    std::vector<NODE_T> _to;
+    std::vector<NUM_T> _cost;
+
+    NUM_T operator()(
+        const std::vector<NUM_T>& POrig, const std::vector<NUM_T>& QOrig,
+        const std::vector<NUM_T>& Pc, const std::vector<NUM_T>& Qc,
+        const std::vector< std::vector<NUM_T> >& Cc,
+        NUM_T extra_mass_penalty,
+        std::vector< std::vector<NUM_T> >* F) {
+
+    //-------------------------------------------------------
+    NODE_T N= Pc.size();
+    assert(Qc.size()==N);
+
+    // Ensuring that the supplier - P, have more mass.
+    NUM_T sum_P= 0;
+    NUM_T sum_Q= 0;
+    {for (NODE_T i=0; i<N; ++i) sum_P+= Pc[i];}
+    {for (NODE_T i=0; i<N; ++i) sum_Q+= Qc[i];}
+    const bool needToSwapFlow= sum_Q>sum_P;
+    const std::vector<NUM_T>& P= needToSwapFlow ? Qc : Pc;
+    const std::vector<NUM_T>& Q= needToSwapFlow ? Pc : Qc;
+    NUM_T abs_diff_sum_P_sum_Q= needToSwapFlow ? sum_Q-sum_P : sum_P-sum_Q;
+    //-------------------------------------------------------
+
+    //-------------------------------------------------------
+    // maxC and checking whether C is the one of the last call
+    bool same_C= (_C.size()==static_cast<size_t>(N)*N);
+    if (!same_C) _C.resize(static_cast<size_t>(N)*N);
+    NUM_T maxC= 0;
+    {for (NODE_T i=0; i<N; ++i) {
+        NUM_T* Ci= &_C[static_cast<size_t>(i)*N];
+        {for (NODE_T j=0; j<N; ++j) {
+            NUM_T Cij= ground_dist(Cc,needToSwapFlow,i,j);
+            assert(Cij>=0);
+            if (Cij>maxC) maxC= Cij;
+            if (Ci[j]!=Cij) {
+                same_C= false;
+                Ci[j]= Cij;
+            }
+        }}
+    }}
+    if (extra_mass_penalty==-1) extra_mass_penalty= maxC;
+    //-------------------------------------------------------
+
+    //-------------------------------------------------------
+    // sources are 0..N-1, sinks N..2N-1 and the threshold node is 2N.
+    // Note that as in the main implementation, costs of the threshold node
+    // edges are reversed to the paper.
+    const NODE_T THRESHOLD_NODE= 2*N;
+    if (!same_C) {
+        _from.clear();
+        _to.clear();
+        _cost.clear();
+        {for (NODE_T i=0; i<N; ++i) {
+            const NUM_T* Ci= &_C[static_cast<size_t>(i)*N];
+            {for (NODE_T j=0; j<N; ++j) {
+                if (Ci[j]==maxC) continue;
+                _from.push_back(i);
+                _to.push_back(j+N);
+                _cost.push_back(Ci[j]);
+            }}
+            _from.push_back(i);
+            _to.push_back(THRESHOLD_NODE);
+            _cost.push_back(0);
+        }}
+        {for (NODE_T j=0; j<N; ++j) {
+            _from.push_back(THRESHOLD_NODE);
+            _to.push_back(j+N);
+            _cost.push_back(maxC);
+        }}
+        _mcf.build(2*N+1,_from,_to,_cost,maxC+1);
+    }
+
+    _b.resize(2*N+1);
+    {for (NODE_T i=0; i<N; ++i) {
+        _b[i]= P[i];
+        _b[i+N]= -Q[i];
+    }}
+    _b[THRESHOLD_NODE]= -abs_diff_sum_P_sum_Q;
+    //-------------------------------------------------------
+
+    NUM_T mcf_dist= _mcf(_b);
+
+    if (FLOW_TYPE!=NO_FLOW) {
+        {for (NODE_T i=0; i<N; ++i) {
+            {for (NODE_T a=_mcf.arc_begin(i); a<_mcf.arc_end(i); ++a) {
+                NODE_T j= _mcf.arc_target(a)-N;
+                NUM_T flow= _mcf.arc_flow(a);
+                if (j==N||flow==0) continue; // threshold node
+                if (needToSwapFlow) (*F)[j][i]+= flow;
+                else (*F)[i][j]+= flow;
+            }}
+        }}
+    }
+
+    if (FLOW_TYPE==WITHOUT_EXTRA_MASS_FLOW) transform_flow_to_regular(*F,POrig,QOrig);
+
+    return
+        mcf_dist + // solution of the transportation problem
+        (abs_diff_sum_P_sum_Q*extra_mass_penalty); // emd-hat extra mass penalty
+
+} // emd_hat_impl_integral_types (network simplex implementation) operator()
+};
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
 //----------------------------------------------------------------------------------------
 // integral types
 //----------------------------------------------------------------------------------------
-template<FLOW_TYPE_T FLOW_TYPE>
-struct emd_hat_impl<int,FLOW_TYPE> {
+template<FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
+struct emd_hat_impl<int,FLOW_TYPE,MCF_TYPE> {
 
     typedef int NUM_T;
+    emd_hat_impl_integral_types<NUM_T,FLOW_TYPE,MCF_TYPE> _impl;
     
     NUM_T operator()(
         const std::vector<NUM_T>& POrig, const std::vector<NUM_T>& QOrig,
@@ -349,15 +473,16 @@ struct emd_hat_impl<int,FLOW_TYPE> {
         const std::vector< std::vector<NUM_T> >& C,
         NUM_T extra_mass_penalty,
         std::vector< std::vector<NUM_T> >* F) {
-        return emd_hat_impl_integral_types<NUM_T,FLOW_TYPE>()(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
+        return _impl(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
     }
     
 }; // emd_hat_impl<int>
 
-template<FLOW_TYPE_T FLOW_TYPE>
-struct emd_hat_impl<long int,FLOW_TYPE> {
+template<FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
+struct emd_hat_impl<long int,FLOW_TYPE,MCF_TYPE> {
 
     typedef long int NUM_T;
+    emd_hat_impl_integral_types<NUM_T,FLOW_TYPE,MCF_TYPE> _impl;
         
     NUM_T operator()(
         const std::vector<NUM_T>& POrig, const std::vector<NUM_T>& QOrig,
@@ -365,16 +490,17 @@ struct emd_hat_impl<long int,FLOW_TYPE> {
         const std::vector< std::vector<NUM_T> >& C,
         NUM_T extra_mass_penalty,
         std::vector< std::vector<NUM_T> >* F) {
-        return emd_hat_impl_integral_types<NUM_T,FLOW_TYPE>()(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
+        return _impl(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
     }
 
     
 }; // emd_hat_impl<long int>
 
-template<FLOW_TYPE_T FLOW_TYPE>
-struct emd_hat_impl<long long int,FLOW_TYPE> {
+template<FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
+struct emd_hat_impl<long long int,FLOW_TYPE,MCF_TYPE> {
 
     typedef long long int NUM_T;
+    emd_hat_impl_integral_types<NUM_T,FLOW_TYPE,MCF_TYPE> _impl;
     
     NUM_T operator()(
         const std::vector<NUM_T>& POrig, const std::vector<NUM_T>& QOrig,
@@ -382,7 +508,7 @@ struct emd_hat_impl<long long int,FLOW_TYPE> {
         const std::vector< std::vector<NUM_T> >& C,
         NUM_T extra_mass_penalty,
         std::vector< std::vector<NUM_T> >* F) {
-        return emd_hat_impl_integral_types<NUM_T,FLOW_TYPE>()(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
+        return _impl(POrig,QOrig,P,Q,C,extra_mass_penalty,F);
     }
     
 }; // emd_hat_impl<long long int>
@@ -392,11 +518,21 @@ struct emd_hat_impl<long long int,FLOW_TYPE> {
 //----------------------------------------------------------------------------------------
 // floating types
 //----------------------------------------------------------------------------------------
-template<FLOW_TYPE_T FLOW_TYPE>
-struct emd_hat_impl<double,FLOW_TYPE> {
+template<FLOW_TYPE_T FLOW_TYPE, MIN_COST_FLOW_T MCF_TYPE>
+struct emd_hat_impl<double,FLOW_TYPE,MCF_TYPE> {
 
     typedef double NUM_T;
     typedef long long int CONVERT_TO_T;
+
+    // The integral solver and the converted input are kept between calls,
+    // so that repeated calls do not allocate.
+    emd_hat_impl<CONVERT_TO_T,FLOW_TYPE,MCF_TYPE> _impl;
+    std::vector<CONVERT_TO_T> iPOrig;
+    std::vector<CONVERT_TO_T> iQOrig;
+    std::vector<CONVERT_TO_T> iP;
+    std::vector<CONVERT_TO_T> iQ;
+    std::vector< std::vector<CONVERT_TO_T> > iC;
+    std::vector< std::vector<CONVERT_TO_T> > iF;
         
     NUM_T operator()(
         const std::vector<NUM_T>& POrig, const std::vector<NUM_T>& QOrig,
@@ -417,12 +553,16 @@ struct emd_hat_impl<double,FLOW_TYPE> {
 
     // Constructing the input
     const NODE_T N= P.size();
-    std::vector<CONVERT_TO_T> iPOrig(N);
-    std::vector<CONVERT_TO_T> iQOrig(N);
-    std::vector<CONVERT_TO_T> iP(N);
-    std::vector<CONVERT_TO_T> iQ(N);
-    std::vector< std::vector<CONVERT_TO_T> > iC(N, std::vector<CONVERT_TO_T>(N) );
-    std::vector< std::vector<CONVERT_TO_T> > iF(N, std::vector<CONVERT_TO_T>(N) );
+    iPOrig.resize(N);
+    iQOrig.resize(N);
+    iP.resize(N);
+    iQ.resize(N);
+    iC.resize(N);
+    {for (NODE_T i= 0; i<N; ++i) iC[i].resize(N);}
+    if (FLOW_TYPE!=NO_FLOW) {
+        iF.resize(N);
+        {for (NODE_T i= 0; i<N; ++i) iF[i].resize(N);}
+    }
 
     // Converting to CONVERT_TO_T
     double sumP= 0.0;
@@ -453,7 +593,7 @@ struct emd_hat_impl<double,FLOW_TYPE> {
     }
 
     // computing distance without extra mass penalty
-    double dist= emd_hat_impl<CONVERT_TO_T,FLOW_TYPE>()(iPOrig,iQOrig,iP,iQ,iC,0,&iF);
+    double dist= _impl(iPOrig,iQOrig,iP,iQ,iC,0,&iF);
     // unnormalize
     dist= dist/PQnormFactor;
     dist= dist/CnormFactor;
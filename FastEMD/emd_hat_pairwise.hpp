@@ -0,0 +1,83 @@
+#ifndef EMD_HAT_PAIRWISE_HPP
+#define EMD_HAT_PAIRWISE_HPP
+
+#include <vector>
+#include <cstddef>
+#include "emd_hat.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// Computes the emd_hat between all pairs of histograms.
+///
+/// Required params:
+/// P - nP histograms of size N.
+/// Q - nQ histograms of size N. If empty, P is compared to itself and, when C is
+///     symmetric, only half of the pairs are computed.
+/// C - The NxN ground distance (see emd_hat.hpp).
+/// D - Output, filled with the nPxnQ (or nPxnP) distances in column major order,
+///     that is the distance between P[i] and Q[j] is D[i+j*nP].
+///
+/// Optional params:
+/// extra_mass_penalty - see emd_hat.hpp.
+/// num_threads - The number of threads (when compiled with OpenMP). Default value is
+///               -1 which means all available threads.
+///
+/// Optional template params:
+/// EMD_T - the emd functor. Every thread keeps its own functor, which with the default
+///         NETWORK_SIMPLEX solver means its own graph, built once from C, and a warm
+///         start along each row of D. Use emd_hat_gd_metric<NUM_T,NO_FLOW,NETWORK_SIMPLEX>
+///         if C is a metric.
+template<typename NUM_T, typename EMD_T= emd_hat<NUM_T,NO_FLOW,NETWORK_SIMPLEX> >
+struct emd_hat_pairwise {
+    void operator()(const std::vector< std::vector<NUM_T> >& P,
+                    const std::vector< std::vector<NUM_T> >& Q,
+                    const std::vector< std::vector<NUM_T> >& C,
+                    NUM_T* D,
+                    NUM_T extra_mass_penalty= -1,
+                    int num_threads= -1) {
+
+    const bool self= Q.empty();
+    const std::vector< std::vector<NUM_T> >& Qr= self ? P : Q;
+    const int nP= P.size();
+    const int nQ= Qr.size();
+    
+    // With a symmetric C the distance is symmetric as well
+    bool symmetric= self;
+    {for (size_t i=0; i<C.size() && symmetric; ++i) {
+        {for (size_t j=0; j<i; ++j) {
+            if (C[i][j]!=C[j][i]) {
+                symmetric= false;
+                break;
+            }
+        }}
+    }}
+
+    #ifdef _OPENMP
+    if (num_threads<1) num_threads= omp_get_max_threads();
+    #pragma omp parallel num_threads(num_threads)
+    #endif
+    {
+        EMD_T emd; // per thread solver and scratch buffers
+        #ifdef _OPENMP
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (int i=0; i<nP; ++i) {
+            {for (int j=(symmetric ? i : 0); j<nQ; ++j) {
+                D[i+static_cast<size_t>(j)*nP]= emd(P[i],Qr[j],C,extra_mass_penalty);
+            }}
+        }
+    }
+
+    if (symmetric) {
+        {for (int i=0; i<nP; ++i) {
+            {for (int j=0; j<i; ++j) {
+                D[i+static_cast<size_t>(j)*nP]= D[j+static_cast<size_t>(i)*nP];
+            }}
+        }}
+    }
+
+    } // operator()
+}; // emd_hat_pairwise
+
+#endif
@@ -0,0 +1,103 @@
+#include "mex.h"
+#include "emd_hat_pairwise.hpp"
+#include <vector>
+
+template<typename NUM_T>
+void emd_hat_pairwise_mex_impl(int nout, mxArray *out[], int nin, const mxArray *in[],
+                               bool gd_metric, int num_threads, mxClassID classID) {
+
+    const NUM_T* P= static_cast<const NUM_T*>( mxGetData(in[0]) );
+    const NUM_T* Q= static_cast<const NUM_T*>( mxGetData(in[1]) );
+    const NUM_T* C= static_cast<const NUM_T*>( mxGetData(in[2]) );
+    const size_t N= mxGetM(in[0]);
+    const size_t nP= mxGetN(in[0]);
+    const size_t nQ= mxIsEmpty(in[1]) ? nP : mxGetN(in[1]);
+
+    // Converting the input once for all pairs
+    std::vector< std::vector<NUM_T> > Pv(nP);
+    std::vector< std::vector<NUM_T> > Qv(mxIsEmpty(in[1]) ? 0 : nQ);
+    std::vector< std::vector<NUM_T> > Cv(N, std::vector<NUM_T>(N));
+    {for (size_t i=0; i<Pv.size(); ++i) Pv[i].assign(P+i*N,P+(i+1)*N);}
+    {for (size_t i=0; i<Qv.size(); ++i) Qv[i].assign(Q+i*N,Q+(i+1)*N);}
+    {for (size_t i=0; i<N; ++i) {
+        {for (size_t j=0; j<N; ++j) {
+            if (C[i+j*N]<0) mexErrMsgTxt("There is a negative cost edge");
+            Cv[i][j]= C[i+j*N];
+        }}
+    }}
+    NUM_T extra_mass_penalty= -1;
+    if (nin>=4&&!mxIsEmpty(in[3])) {
+        extra_mass_penalty= *static_cast<const NUM_T*>( mxGetData(in[3]) );
+    }
+
+    out[0]= mxCreateNumericMatrix(nP, nQ, classID, mxREAL);
+    NUM_T* D= static_cast<NUM_T*>( mxGetData(out[0]) );
+    if (gd_metric) {
+        emd_hat_pairwise<NUM_T, emd_hat_gd_metric<NUM_T,NO_FLOW,NETWORK_SIMPLEX> >()(Pv,Qv,Cv,D,extra_mass_penalty,num_threads);
+    } else {
+        emd_hat_pairwise<NUM_T, emd_hat<NUM_T,NO_FLOW,NETWORK_SIMPLEX> >()(Pv,Qv,Cv,D,extra_mass_penalty,num_threads);
+    }
+
+} // emd_hat_pairwise_mex_impl
+
+void mexFunction(int nout, mxArray *out[],
+                 int nin, const mxArray *in[]) {
+
+    //-------------------------------------------------------
+    // Check the arguments
+    //-------------------------------------------------------
+    if (nin<3||nin>6) {
+        mexErrMsgTxt("3 to 6 arguments are required");
+    }
+    if (nout>1) {
+        mexErrMsgTxt("Too many output arguments");
+    }
+    {for (int i=0; i<nin; ++i) {
+        if (!mxIsNumeric(in[i])&&!(i>=4&&mxIsLogical(in[i]))) {
+            mexErrMsgTxt("Input arguments must be numeric matrices");
+        }
+        if (mxIsSparse(in[i])) {
+            mexErrMsgTxt("Sparse matrices are not supported");
+        }
+        if (mxGetNumberOfDimensions(in[i])>2) {
+            mexErrMsgTxt("Multidimensional arrays are not supported");
+        }
+    }}
+    const mxClassID classID= mxGetClassID(in[0]);
+    if ((!mxIsEmpty(in[1])&&mxGetClassID(in[1])!=classID) ||
+        mxGetClassID(in[2])!=classID ||
+        ((nin>=4)&&!mxIsEmpty(in[3])&&mxGetClassID(in[3])!=classID)) {
+        mexErrMsgTxt("P, Q, D and extra_mass_penalty should be of the same class");
+    }
+    if (mxIsEmpty(in[0])) {
+        mexErrMsgTxt("P can not be empty");
+    }
+    const size_t N= mxGetM(in[0]);
+    if ((!mxIsEmpty(in[1])&&mxGetM(in[1])!=N) ||
+        mxGetM(in[2])!=N || mxGetN(in[2])!=N) {
+        mexErrMsgTxt("P and Q and D should have the same corresponding size");
+    }
+    const bool gd_metric= (nin>=5) ? (mxGetScalar(in[4])!=0) : false;
+    const int num_threads= (nin>=6) ? static_cast<int>(mxGetScalar(in[5])) : -1;
+    //-------------------------------------------------------
+
+    switch (classID) {
+
+    case mxINT32_CLASS:
+        emd_hat_pairwise_mex_impl<int>(nout,out,nin,in,gd_metric,num_threads,classID);
+        break;
+
+    case mxINT64_CLASS:
+        emd_hat_pairwise_mex_impl<long long int>(nout,out,nin,in,gd_metric,num_threads,classID);
+        break;
+
+    case mxDOUBLE_CLASS:
+        emd_hat_pairwise_mex_impl<double>(nout,out,nin,in,gd_metric,num_threads,classID);
+        break;
+
+    default:
+        mexErrMsgTxt("Support only int32, int64 and double types");
+        break;
+    }
+
+} // end mexFunction
@@ -0,0 +1,28 @@
+% D= emd_hat_pairwise_mex(P,Q,C,extra_mass_penalty,gd_metric,nThreads)
+%
+% Computes emd_hat between all pairs of histograms with one call, in
+% parallel (when compiled with OpenMP, see compile_FastEMD). The ground
+% distance is converted once and every thread keeps its own network simplex
+% solver, that warm starts from the previous pair of the same row.
+%
+% Output:
+%  D - the nPxnQ matrix of distances, D(i,j) is the distance between P(:,i)
+%      and Q(:,j). Same class as P.
+%
+% Required Input:
+%  P - NxnP matrix, each column is a histogram.
+%  Q - NxnQ matrix, each column is a histogram. If empty ([]), P is compared
+%      with itself and if C is symmetric only half of the pairs are computed.
+%  C - the NxN matrix of the ground distance between bins.
+%
+% Optional Input:
+%  extra_mass_penalty - see emd_hat_gd_metric_mex. Default value is -1
+%                       which means 1*max(C(:)).
+%  gd_metric - if true, C is assumed to be a metric and the faster
+%              emd_hat_gd_metric is used. Default value is false.
+%  nThreads - number of threads. Default value is all available threads.
+%
+% P, Q, C and extra_mass_penalty should be of the same class (int32, int64
+% or double).
+%
+% Note: it is much faster than calling emd_hat_mex in a double loop.
@@ -3,6 +3,8 @@
 
 #include "EMD_DEFS.hpp"
 #include "emd_hat.hpp"
+#include "emd_hat_thresholded.hpp"
+#include <cstring>
 
 //=============================================================================
 // This interface is similar to Rubner's interface. See:
@@ -34,6 +36,8 @@
 //  Fast and Robust Earth Mover's Distances
 //	Ofir Pele, Michael Werman
 //  ICCV 2009
+// If you know the threshold, use emd_hat_thresholded_signature_interface (below)
+// which never builds the dense ground distance matrix.
 //
 // If you use this code, please cite the papers.
 //=============================================================================
@@ -83,6 +87,70 @@ NUM_T emd_hat_signature_interface(signature_tt<NUM_T>* Signature1, signature_tt<
 
 } // emd_hat_signature_interface
 
+
+/// Similar to emd_hat_signature_interface, for the thresholded ground distance
+/// min(func(f1,f2),threshold). Only the pairs of features that are closer than
+/// the threshold are kept (see emd_hat_thresholded.hpp), so memory is near linear
+/// in the number of features instead of quadratic.
+/// The sparse ground distance and the solver graph are cached in the functor. They
+/// are rebuilt only when the features, func or the threshold change, so comparing
+/// many weightings of the same features (e.g. histograms on a fixed color-spatial
+/// grid) evaluates func and builds the graph only once.
+/// extra_mass_penalty - see emd_hat_signature_interface. Default value is -1 which
+///                      means the threshold.
+template<typename NUM_T>
+struct emd_hat_thresholded_signature_interface {
+
+    NUM_T (*_func)(feature_tt*, feature_tt*);
+    NUM_T _threshold;
+    std::vector<feature_tt> _features1;
+    std::vector<feature_tt> _features2;
+    thresholded_ground_distance<NUM_T> _C;
+    emd_hat_thresholded<NUM_T> _emd;
+    std::vector<NUM_T> _P;
+    std::vector<NUM_T> _Q;
+
+    emd_hat_thresholded_signature_interface() : _func(NULL), _threshold(0) {}
+
+    NUM_T operator()(signature_tt<NUM_T>* Signature1, signature_tt<NUM_T>* Signature2,
+                     NUM_T (*func)(feature_tt*, feature_tt*),
+                     NUM_T threshold,
+                     NUM_T extra_mass_penalty= -1) {
+
+    if (!same_layout(Signature1,Signature2,func,threshold)) {
+        _func= func;
+        _threshold= threshold;
+        _features1.assign(Signature1->Features, Signature1->Features+Signature1->n);
+        _features2.assign(Signature2->Features, Signature2->Features+Signature2->n);
+        _C.reset(Signature1->n, Signature2->n, threshold);
+        {for (int i=0; i<Signature1->n; ++i) {
+            {for (int j=0; j<Signature2->n; ++j) {
+                _C.add(i,j, func( (Signature1->Features+i) , (Signature2->Features+j) ));
+            }}
+        }}
+    }
+
+    _P.assign(Signature1->Weights, Signature1->Weights+Signature1->n);
+    _Q.assign(Signature2->Weights, Signature2->Weights+Signature2->n);
+    return _emd(_P,_Q,_C, extra_mass_penalty);
+
+    } // operator()
+
+private:
+
+    bool same_layout(signature_tt<NUM_T>* Signature1, signature_tt<NUM_T>* Signature2,
+                     NUM_T (*func)(feature_tt*, feature_tt*),
+                     NUM_T threshold) const {
+        // features are compared bitwise as feature_tt may be a user struct
+        return func==_func && threshold==_threshold &&
+            Signature1->n==static_cast<int>(_features1.size()) &&
+            Signature2->n==static_cast<int>(_features2.size()) &&
+            (Signature1->n==0 || memcmp(Signature1->Features,&_features1[0],Signature1->n*sizeof(feature_tt))==0) &&
+            (Signature2->n==0 || memcmp(Signature2->Features,&_features2[0],Signature2->n*sizeof(feature_tt))==0);
+    } // same_layout
+
+}; // emd_hat_thresholded_signature_interface
+
 #endif
 
 // Copyright (c) 2009-2012, Ofir Pele
@@ -0,0 +1,276 @@
+#ifndef EMD_HAT_THRESHOLDED_HPP
+#define EMD_HAT_THRESHOLDED_HPP
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include "EMD_DEFS.hpp"
+#include "network_simplex.hpp"
+
+//=============================================================================
+// emd_hat with a sparse thresholded ground distance.
+//
+// The ground distance between the N1 bins of P and the N2 bins of Q is
+// min(d(i,j),threshold). Only the pairs with d(i,j)<threshold are stored, all
+// other pairs are connected through one transhipment vertex (an edge of cost
+// 0 from every bin of P to it and an edge of cost threshold from it to every
+// bin of Q). Memory is linear in N1+N2 plus the number of pairs that are
+// closer than the threshold, instead of quadratic in N1+N2. See paper:
+//  Fast and Robust Earth Mover's Distances
+//  Ofir Pele, Michael Werman
+//  ICCV 2009
+//=============================================================================
+
+/// Sparse thresholded ground distance between N1 bins and N2 bins.
+/// Add the pairs that are closer than the threshold with add(i,j,d), pairs
+/// with d>=threshold are ignored (their distance is the threshold).
+template<typename NUM_T>
+class thresholded_ground_distance {
+
+    NODE_T _N1;
+    NODE_T _N2;
+    NUM_T _threshold;
+    std::vector<NODE_T> _from;
+    std::vector<NODE_T> _to;
+    std::vector<NUM_T> _cost;
+
+public:
+
+    thresholded_ground_distance(NODE_T N1= 0, NODE_T N2= 0, NUM_T threshold= 0)
+        : _N1(N1), _N2(N2), _threshold(threshold) {}
+
+    /// Removes all pairs and sets the sizes and the threshold.
+    void reset(NODE_T N1, NODE_T N2, NUM_T threshold) {
+        _N1= N1;
+        _N2= N2;
+        _threshold= threshold;
+        _from.clear();
+        _to.clear();
+        _cost.clear();
+    } // reset
+
+    void add(NODE_T i, NODE_T j, NUM_T d) {
+        assert(i>=0 && i<_N1 && j>=0 && j<_N2);
+        assert(d>=0);
+        if (d>=_threshold) return;
+        _from.push_back(i);
+        _to.push_back(j);
+        _cost.push_back(d);
+    } // add
+
+    NODE_T N1() const { return _N1; }
+    NODE_T N2() const { return _N2; }
+    NUM_T threshold() const { return _threshold; }
+    NODE_T num_pairs() const { return _cost.size(); }
+    NODE_T from(NODE_T a) const { return _from[a]; }
+    NODE_T to(NODE_T a) const { return _to[a]; }
+    NUM_T cost(NODE_T a) const { return _cost[a]; }
+
+    bool operator==(const thresholded_ground_distance& o) const {
+        return _N1==o._N1 && _N2==o._N2 && _threshold==o._threshold &&
+            _from==o._from && _to==o._to && _cost==o._cost;
+    }
+    bool operator!=(const thresholded_ground_distance& o) const { return !(*this==o); }
+
+}; // thresholded_ground_distance
+
+
+/// emd_hat with a thresholded_ground_distance.
+///
+/// The reduced graph (bins of P, bins of Q and the transhipment vertex) is
+/// built from C once and kept in the functor together with the last network
+/// simplex solution. Calling the functor again with the same C (for example
+/// one signature layout against many weightings) only warm starts the solver.
+///
+/// Required params:
+/// P - Weights of the N1 bins (the first signature).
+/// Q - Weights of the N2 bins (the second signature).
+/// C - The sparse thresholded ground distance between them. A zero threshold
+///     is allowed, all distances are then zero.
+///
+/// Optional params:
+/// extra_mass_penalty - See emd_hat.hpp. Default value is -1 which means
+///                      the threshold (the maximum distance).
+/// F - If not NULL, F[a] is set to the flow between the bins of the a'th
+///     pair of C. Flow that goes through the transhipment vertex is not
+///     returned, that is F is like WITHOUT_TRANSHIPMENT_FLOW in emd_hat.
+///
+/// NUM_T should be int, long int, long long int or double.
+template<typename NUM_T>
+struct emd_hat_thresholded;
+
+//-----------------------------------------------------------------------------
+// integral types
+//-----------------------------------------------------------------------------
+template<typename NUM_T>
+struct emd_hat_thresholded_integral_types {
+
+    network_simplex<NUM_T> _mcf;
+    thresholded_ground_distance<NUM_T> _C; // C of the last call
+    std::vector<NUM_T> _b;
+    std::vector<NODE_T> _arc; // network simplex arc of each pair of C
+    bool _built;
+
+    emd_hat_thresholded_integral_types() : _built(false) {}
+
+    NUM_T operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
+                     const thresholded_ground_distance<NUM_T>& C,
+                     NUM_T extra_mass_penalty= -1,
+                     std::vector<NUM_T>* F= NULL) {
+
+    const NODE_T N1= C.N1();
+    const NODE_T N2= C.N2();
+    assert(P.size()==static_cast<size_t>(N1));
+    assert(Q.size()==static_cast<size_t>(N2));
+    const NUM_T threshold= C.threshold();
+
+    //-------------------------------------------------------
+    // bins of P are 0..N1-1, bins of Q are N1..N1+N2-1 and the
+    // transhipment vertex is N1+N2. As in emd_hat_impl.hpp the
+    // transhipment vertex absorbs the extra mass of P with cost zero.
+    const NODE_T THRESHOLD_NODE= N1+N2;
+    if (!_built || C!=_C) {
+        _C= C;
+        std::vector<NODE_T> from;
+        std::vector<NODE_T> to;
+        std::vector<NUM_T> cost;
+        const NODE_T m= C.num_pairs();
+        from.reserve(m+N1+N2);
+        to.reserve(m+N1+N2);
+        cost.reserve(m+N1+N2);
+        {for (NODE_T a=0; a<m; ++a) {
+            from.push_back(C.from(a));
+            to.push_back(C.to(a)+N1);
+            cost.push_back(C.cost(a));
+        }}
+        {for (NODE_T i=0; i<N1; ++i) {
+            from.push_back(i);
+            to.push_back(THRESHOLD_NODE);
+            cost.push_back(0);
+        }}
+        {for (NODE_T j=0; j<N2; ++j) {
+            from.push_back(THRESHOLD_NODE);
+            to.push_back(j+N1);
+            cost.push_back(threshold);
+        }}
+        _mcf.build(N1+N2+1,from,to,cost,threshold+1);
+
+        // the network simplex sorts the arcs by source (stable), so the
+        // pairs of C keep their relative order among the arcs of their source
+        _arc.resize(m);
+        std::vector<NODE_T> next(N1);
+        {for (NODE_T i=0; i<N1; ++i) next[i]= _mcf.arc_begin(i);}
+        {for (NODE_T a=0; a<m; ++a) _arc[a]= next[C.from(a)]++;}
+        _built= true;
+    }
+    //-------------------------------------------------------
+
+    //-------------------------------------------------------
+    // If Q has more mass, the transhipment vertex supplies the extra mass
+    // to Q, which costs exactly threshold*(sum_Q-sum_P) more than absorbing
+    // it for free. So the graph does not depend on which side is heavier.
+    NUM_T sum_P= 0;
+    NUM_T sum_Q= 0;
+    _b.resize(N1+N2+1);
+    {for (NODE_T i=0; i<N1; ++i) {
+        _b[i]= P[i];
+        sum_P+= P[i];
+    }}
+    {for (NODE_T j=0; j<N2; ++j) {
+        _b[j+N1]= -Q[j];
+        sum_Q+= Q[j];
+    }}
+    _b[THRESHOLD_NODE]= sum_Q-sum_P;
+    NUM_T abs_diff_sum_P_sum_Q= sum_P>sum_Q ? sum_P-sum_Q : sum_Q-sum_P;
+    //-------------------------------------------------------
+
+    NUM_T mcf_dist= _mcf(_b);
+    if (sum_Q>sum_P) mcf_dist-= threshold*abs_diff_sum_P_sum_Q;
+
+    if (F!=NULL) {
+        F->resize(_arc.size());
+        {for (NODE_T a=0; a<static_cast<NODE_T>(_arc.size()); ++a) {
+            (*F)[a]= _mcf.arc_flow(_arc[a]);
+        }}
+    }
+
+    if (extra_mass_penalty==-1) extra_mass_penalty= threshold;
+    return
+        mcf_dist + // solution of the transportation problem
+        (abs_diff_sum_P_sum_Q*extra_mass_penalty); // emd-hat extra mass penalty
+
+    } // operator()
+};
+
+template<>
+struct emd_hat_thresholded<int> : public emd_hat_thresholded_integral_types<int> {};
+template<>
+struct emd_hat_thresholded<long int> : public emd_hat_thresholded_integral_types<long int> {};
+template<>
+struct emd_hat_thresholded<long long int> : public emd_hat_thresholded_integral_types<long long int> {};
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// floating types
+//-----------------------------------------------------------------------------
+template<>
+struct emd_hat_thresholded<double> {
+
+    typedef double NUM_T;
+    typedef long long int CONVERT_TO_T;
+
+    emd_hat_thresholded<CONVERT_TO_T> _impl;
+    thresholded_ground_distance<CONVERT_TO_T> iC;
+    std::vector<CONVERT_TO_T> iP;
+    std::vector<CONVERT_TO_T> iQ;
+    std::vector<CONVERT_TO_T> iF;
+
+    NUM_T operator()(const std::vector<NUM_T>& P, const std::vector<NUM_T>& Q,
+                     const thresholded_ground_distance<NUM_T>& C,
+                     NUM_T extra_mass_penalty= -1,
+                     std::vector<NUM_T>* F= NULL) {
+
+    // See emd_hat_impl<double> in emd_hat_impl.hpp
+    const double MULT_FACTOR= 1000000;
+
+    double sumP= 0.0;
+    double sumQ= 0.0;
+    {for (size_t i=0; i<P.size(); ++i) sumP+= P[i];}
+    {for (size_t j=0; j<Q.size(); ++j) sumQ+= Q[j];}
+    double minSum= std::min(sumP,sumQ);
+    double maxSum= std::max(sumP,sumQ);
+    double PQnormFactor= MULT_FACTOR/maxSum;
+    // a zero threshold makes every ground distance zero, any scale will do
+    double CnormFactor= (C.threshold()>0) ? MULT_FACTOR/C.threshold() : 1.0;
+
+    // the converted C depends only on C, so the solver keeps its graph
+    iC.reset(C.N1(),C.N2(),static_cast<CONVERT_TO_T>(floor(C.threshold()*CnormFactor+0.5)));
+    {for (NODE_T a=0; a<C.num_pairs(); ++a) {
+        iC.add(C.from(a),C.to(a),static_cast<CONVERT_TO_T>(floor(C.cost(a)*CnormFactor+0.5)));
+    }}
+    iP.resize(P.size());
+    iQ.resize(Q.size());
+    {for (size_t i=0; i<P.size(); ++i) iP[i]= static_cast<CONVERT_TO_T>(floor(P[i]*PQnormFactor+0.5));}
+    {for (size_t j=0; j<Q.size(); ++j) iQ[j]= static_cast<CONVERT_TO_T>(floor(Q[j]*PQnormFactor+0.5));}
+
+    // computing distance without extra mass penalty
+    double dist= _impl(iP,iQ,iC,0,F!=NULL ? &iF : NULL);
+    dist= dist/PQnormFactor;
+    dist= dist/CnormFactor;
+
+    if (extra_mass_penalty==-1) extra_mass_penalty= C.threshold();
+    dist+= (maxSum-minSum)*extra_mass_penalty;
+
+    if (F!=NULL) {
+        F->resize(iF.size());
+        {for (size_t a=0; a<iF.size(); ++a) (*F)[a]= iF[a]/PQnormFactor;}
+    }
+
+    return dist;
+    } // operator()
+
+}; // emd_hat_thresholded<double>
+//-----------------------------------------------------------------------------
+
+#endif
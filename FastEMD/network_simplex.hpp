@@ -0,0 +1,381 @@
+#ifndef NETWORK_SIMPLEX_HPP
+#define NETWORK_SIMPLEX_HPP
+
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include "EMD_DEFS.hpp"
+
+//------------------------------------------------------------------------------
+/// Primal network simplex for uncapacitated min cost flow problems.
+///
+/// The graph is kept in flat CSR arrays: the out arcs of node u are
+/// [arc_begin(u),arc_end(u)). An extra root node is connected to every node
+/// with two artificial arcs (one in each direction) whose cost must be large
+/// enough so that they carry no flow in an optimal solution.
+///
+/// The spanning tree basis and the node potentials are kept between calls.
+/// When the object is called again with new supplies (same graph), the old
+/// tree is reused: subtrees whose tree arc would get a negative flow are hung
+/// directly below the root, which gives a feasible (strongly feasible) basis
+/// that is usually only a few pivots away from the new optimum.
+template<typename NUM_T>
+class network_simplex {
+
+    enum { UP= 1, DOWN= -1 }; // pred arc goes to / comes from the parent
+    enum { STATE_TREE= 0, STATE_LOWER= 1 };
+
+    NODE_T _num_nodes;
+    NODE_T _root;
+    NODE_T _num_real_arcs;
+    NODE_T _num_arcs;
+
+    // graph (CSR, arcs sorted by source; artificial arcs are last)
+    std::vector<NODE_T> _first;
+    std::vector<NODE_T> _source;
+    std::vector<NODE_T> _target;
+    std::vector<NUM_T> _cost;
+
+    // flows, states of arcs and node potentials
+    std::vector<NUM_T> _flow;
+    std::vector<signed char> _state;
+    std::vector<NUM_T> _pi;
+
+    // spanning tree, children are kept in doubly linked sibling lists
+    std::vector<NODE_T> _parent;
+    std::vector<NODE_T> _pred;
+    std::vector<signed char> _dir;
+    std::vector<NODE_T> _depth;
+    std::vector<NODE_T> _child;
+    std::vector<NODE_T> _next;
+    std::vector<NODE_T> _prev;
+    bool _has_tree;
+
+    // scratch
+    std::vector<NODE_T> _order;
+    std::vector<NODE_T> _stack;
+    std::vector<NUM_T> _excess;
+
+    // block search pivot rule
+    NODE_T _block_size;
+    NODE_T _next_arc;
+    NODE_T _in_arc;
+
+public:
+
+    network_simplex() : _num_nodes(0), _root(0), _num_real_arcs(0), _num_arcs(0), _has_tree(false) {}
+
+    /// Sets the graph. from[a]->to[a] is an arc with cost cost[a] (>=0).
+    /// art_cost - the cost of the artificial arcs to/from the root.
+    /// Forgets the last solution.
+    void build(NODE_T num_nodes,
+               const std::vector<NODE_T>& from, const std::vector<NODE_T>& to,
+               const std::vector<NUM_T>& cost,
+               NUM_T art_cost) {
+
+        assert(from.size()==to.size() && from.size()==cost.size());
+
+        _num_nodes= num_nodes;
+        _root= num_nodes;
+        _num_real_arcs= from.size();
+        _num_arcs= _num_real_arcs + 2*num_nodes;
+
+        _first.assign(_num_nodes+2, 0);
+        _source.resize(_num_arcs);
+        _target.resize(_num_arcs);
+        _cost.resize(_num_arcs);
+        _flow.assign(_num_arcs, 0);
+        _state.assign(_num_arcs, STATE_LOWER);
+
+        // counting sort by source
+        {for (NODE_T a=0; a<_num_real_arcs; ++a) ++_first[from[a]+1];}
+        {for (NODE_T u=0; u<_num_nodes; ++u) _first[u+1]+= _first[u];}
+        _order.assign(_first.begin(), _first.begin()+_num_nodes);
+        {for (NODE_T a=0; a<_num_real_arcs; ++a) {
+            NODE_T k= _order[from[a]]++;
+            _source[k]= from[a];
+            _target[k]= to[a];
+            _cost[k]= cost[a];
+        }}
+        _first[_num_nodes+1]= _num_arcs;
+
+        // artificial arcs
+        {for (NODE_T u=0; u<_num_nodes; ++u) {
+            _source[art_up(u)]= u;
+            _target[art_up(u)]= _root;
+            _cost[art_up(u)]= art_cost;
+            _source[art_down(u)]= _root;
+            _target[art_down(u)]= u;
+            _cost[art_down(u)]= art_cost;
+        }}
+
+        const NODE_T n= _num_nodes+1;
+        _pi.resize(n);
+        _parent.resize(n);
+        _pred.resize(n);
+        _dir.resize(n);
+        _depth.resize(n);
+        _child.resize(n);
+        _next.resize(n);
+        _prev.resize(n);
+        _excess.resize(n);
+        _order.resize(n);
+        _stack.resize(n);
+
+        _block_size= std::max(static_cast<NODE_T>(sqrt(static_cast<double>(_num_arcs))), static_cast<NODE_T>(10));
+        _next_arc= 0;
+        _has_tree= false;
+
+    } // build
+
+    /// e - supply(positive) and demand(negative) of the num_nodes nodes, sums to zero.
+    /// warm_start - start from the spanning tree of the last call (if any).
+    /// Returns the cost of the flow. Flows are available with arc_flow.
+    NUM_T operator()(const std::vector<NUM_T>& e, bool warm_start= true) {
+
+        assert(e.size()==static_cast<size_t>(_num_nodes));
+
+        if (_has_tree&&warm_start) {
+            init_tree_from_last(e);
+        } else {
+            init_tree(e);
+        }
+        _has_tree= true;
+
+        while (find_entering_arc()) {
+            pivot();
+        }
+
+        NUM_T dist= 0;
+        {for (NODE_T a=0; a<_num_real_arcs; ++a) {
+            dist+= _cost[a]*_flow[a];
+        }}
+        #ifndef NDEBUG
+        {for (NODE_T a=_num_real_arcs; a<_num_arcs; ++a) assert(_flow[a]==0);}
+        #endif
+        return dist;
+
+    } // operator()
+
+    NODE_T arc_begin(NODE_T u) const { return _first[u]; }
+    NODE_T arc_end(NODE_T u) const { return _first[u+1]; }
+    NODE_T arc_target(NODE_T a) const { return _target[a]; }
+    NUM_T arc_flow(NODE_T a) const { return _flow[a]; }
+
+private:
+
+    NODE_T art_up(NODE_T u) const { return _num_real_arcs+2*u; }
+    NODE_T art_down(NODE_T u) const { return _num_real_arcs+2*u+1; }
+
+    void link(NODE_T p, NODE_T u) {
+        _parent[u]= p;
+        _prev[u]= -1;
+        _next[u]= _child[p];
+        if (_child[p]>=0) _prev[_child[p]]= u;
+        _child[p]= u;
+    } // link
+
+    void unlink(NODE_T u) {
+        if (_prev[u]>=0) _next[_prev[u]]= _next[u];
+        else _child[_parent[u]]= _next[u];
+        if (_next[u]>=0) _prev[_next[u]]= _prev[u];
+    } // unlink
+
+    // hangs u below the root with the artificial arc that can carry s
+    void hang_on_root(NODE_T u, NUM_T s) {
+        NODE_T a;
+        if (s>=0) {
+            a= art_up(u);
+            _dir[u]= UP;
+            _flow[a]= s;
+        } else {
+            a= art_down(u);
+            _dir[u]= DOWN;
+            _flow[a]= -s;
+        }
+        _pred[u]= a;
+        _state[a]= STATE_TREE;
+        link(_root,u);
+    } // hang_on_root
+
+    // all nodes hang below the root, as in the classic big-M start
+    void init_tree(const std::vector<NUM_T>& e) {
+        std::fill(_flow.begin(), _flow.end(), 0);
+        std::fill(_state.begin(), _state.end(), STATE_LOWER);
+        std::fill(_child.begin(), _child.end(), -1);
+        _parent[_root]= -1;
+        _pred[_root]= -1;
+        {for (NODE_T u=0; u<_num_nodes; ++u) {
+            hang_on_root(u,e[u]);
+        }}
+        update_subtree(_root,0);
+    } // init_tree
+
+    // keeps the last tree, cutting subtrees whose pred arc becomes infeasible
+    void init_tree_from_last(const std::vector<NUM_T>& e) {
+        NODE_T n= preorder(_root);
+        {for (NODE_T u=0; u<_num_nodes; ++u) _excess[u]= e[u];}
+        _excess[_root]= 0;
+        // children before parents; non tree arcs carry no flow already
+        {for (NODE_T k=n-1; k>0; --k) {
+            NODE_T u= _order[k];
+            NUM_T s= _excess[u];
+            // zero flow is only kept on arcs that point to the root
+            if (_dir[u]==UP ? s>=0 : s<0) {
+                _flow[_pred[u]]= _dir[u]*s;
+                _excess[_parent[u]]+= s;
+            } else {
+                _flow[_pred[u]]= 0;
+                _state[_pred[u]]= STATE_LOWER;
+                unlink(u);
+                hang_on_root(u,s);
+            }
+        }}
+        update_subtree(_root,0);
+    } // init_tree_from_last
+
+    // fills _order with the preorder of the subtree of u, returns its size
+    NODE_T preorder(NODE_T u) {
+        NODE_T n= 0;
+        NODE_T top= 0;
+        _stack[top++]= u;
+        while (top>0) {
+            NODE_T v= _stack[--top];
+            _order[n++]= v;
+            {for (NODE_T c=_child[v]; c>=0; c=_next[c]) {
+                _stack[top++]= c;
+            }}
+        }
+        return n;
+    } // preorder
+
+    // adds sigma to the potentials of the subtree of u and fixes the depths.
+    // For the root, potentials are recomputed from scratch.
+    void update_subtree(NODE_T u, NUM_T sigma) {
+        NODE_T n= preorder(u);
+        if (u==_root) {
+            _pi[_root]= 0;
+            _depth[_root]= 0;
+            {for (NODE_T i=1; i<n; ++i) {
+                NODE_T v= _order[i];
+                NODE_T p= _parent[v];
+                _pi[v]= _pi[p] - _dir[v]*_cost[_pred[v]];
+                _depth[v]= _depth[p]+1;
+            }}
+            return;
+        }
+        {for (NODE_T i=0; i<n; ++i) {
+            NODE_T v= _order[i];
+            _pi[v]+= sigma;
+            _depth[v]= _depth[_parent[v]]+1;
+        }}
+    } // update_subtree
+
+    // block search pivot rule, reduced cost of a is c[a]+pi[source]-pi[target]
+    bool find_entering_arc() {
+        NUM_T min= 0;
+        NODE_T cnt= _block_size;
+        NODE_T a;
+        for (a=_next_arc; a<_num_arcs; ++a) {
+            NUM_T c= _state[a]*(_cost[a]+_pi[_source[a]]-_pi[_target[a]]);
+            if (c<min) {
+                min= c;
+                _in_arc= a;
+            }
+            if (--cnt==0) {
+                if (min<0) goto search_end;
+                cnt= _block_size;
+            }
+        }
+        for (a=0; a<_next_arc; ++a) {
+            NUM_T c= _state[a]*(_cost[a]+_pi[_source[a]]-_pi[_target[a]]);
+            if (c<min) {
+                min= c;
+                _in_arc= a;
+            }
+            if (--cnt==0) {
+                if (min<0) goto search_end;
+                cnt= _block_size;
+            }
+        }
+        if (min>=0) return false;
+    search_end:
+        _next_arc= _in_arc;
+        return true;
+    } // find_entering_arc
+
+    void pivot() {
+        const NODE_T first= _source[_in_arc];
+        const NODE_T second= _target[_in_arc];
+
+        // join node of the cycle
+        NODE_T u= first;
+        NODE_T v= second;
+        while (u!=v) {
+            if (_depth[u]>=_depth[v]) u= _parent[u];
+            else v= _parent[v];
+        }
+        const NODE_T join= u;
+
+        // leaving arc, the cycle goes first->second->join->first.
+        // Ties are broken as in the strongly feasible tree rule.
+        NUM_T delta= std::numeric_limits<NUM_T>::max();
+        NODE_T u_out= -1;
+        bool out_on_first= true;
+        {for (u=first; u!=join; u=_parent[u]) {
+            if (_dir[u]==UP && _flow[_pred[u]]<delta) {
+                delta= _flow[_pred[u]];
+                u_out= u;
+            }
+        }}
+        {for (u=second; u!=join; u=_parent[u]) {
+            if (_dir[u]==DOWN && _flow[_pred[u]]<=delta) {
+                delta= _flow[_pred[u]];
+                u_out= u;
+                out_on_first= false;
+            }
+        }}
+        assert(u_out!=-1); // otherwise unbounded (negative cycle)
+
+        // augment
+        if (delta>0) {
+            _flow[_in_arc]+= delta;
+            {for (u=first; u!=join; u=_parent[u]) _flow[_pred[u]]-= _dir[u]*delta;}
+            {for (u=second; u!=join; u=_parent[u]) _flow[_pred[u]]+= _dir[u]*delta;}
+        }
+        _state[_in_arc]= STATE_TREE;
+        _state[_pred[u_out]]= STATE_LOWER;
+
+        // reverse the tree path u_in..u_out and hang it below v_in
+        const NODE_T u_in= out_on_first ? first : second;
+        const NODE_T v_in= out_on_first ? second : first;
+        NUM_T sigma= _cost[_in_arc]+_pi[first]-_pi[second];
+        if (out_on_first) sigma= -sigma;
+        NODE_T a_new= _in_arc;
+        signed char dir_new= out_on_first ? UP : DOWN;
+        NODE_T p_new= v_in;
+        u= u_in;
+        while (true) {
+            NODE_T p_old= _parent[u];
+            NODE_T a_old= _pred[u];
+            signed char dir_old= _dir[u];
+            unlink(u);
+            link(p_new,u);
+            _pred[u]= a_new;
+            _dir[u]= dir_new;
+            if (u==u_out) break;
+            a_new= a_old;
+            dir_new= -dir_old;
+            p_new= u;
+            u= p_old;
+        }
+
+        update_subtree(u_in,sigma);
+    } // pivot
+
+}; // end network_simplex
+//------------------------------------------------------------------------------
+
+#endif
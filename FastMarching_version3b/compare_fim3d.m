@@ -0,0 +1,46 @@
+% This script compares the timing and the accuracy of fim3d with msfm3d,
+% for three speed images : constant, smoothly varying, and a slow wall
+% with a hole in it. Run compile_c_files first, with OpenMP for the
+% multi-core timings of fim3d.
+%
+% For each size and stencil it prints the time of msfm3d, the time of
+% fim3d with one thread and with all threads, the maximum relative
+% difference of T and the maximum difference of Y between both.
+% Without cross neighbours the results should be equal (1e-8), with
+% cross neighbours they depend on the order in which msfm3d freezes
+% pixels with the same distance, see fim3d.m.
+
+functiondir=which('compile_c_files.m');
+functiondir=functiondir(1:end-length('compile_c_files.m'));
+addpath([functiondir '/functions'])
+
+Sizes = [64 128 256];
+Stencils = [true false; true true];
+SpeedNames = {'constant', 'smooth', 'wall'};
+
+fprintf('size  speed     cross  msfm3d(s)  fim3d 1(s)  fim3d all(s)  T rel.err  Y err\n');
+for n = Sizes
+    [X,Y,Z] = ndgrid(1:n, 1:n, 1:n);
+    for s = 1:3
+        switch(s)
+            case 1
+                F = ones([n n n]);
+            case 2
+                F = 1 + 0.5*sin(X*0.2).*cos(Y*0.15+Z*0.1);
+            case 3
+                F = ones([n n n]);
+                F(X>n/3 & X<n/3+3 & ~(Y>n/2 & Y<n/2+4)) = 0.01;
+        end
+        SourcePoints = [round(n/4) round(n/2) round(n/2); n-2 5 round(n/3)]';
+        for q = 1:size(Stencils,1)
+            UseSecond = Stencils(q,1); UseCross = Stencils(q,2);
+            tic; [T1,Y1] = msfm3d(F, SourcePoints, UseSecond, UseCross); t1 = toc;
+            tic; [T2,Y2] = fim3d(F, SourcePoints, UseSecond, UseCross, [], 1); t2 = toc;
+            tic; [T3,Y3] = fim3d(F, SourcePoints, UseSecond, UseCross, [], 0); t3 = toc;
+            if(~isequal(T2,T3)), warning('compare_fim3d:threads', 'fim3d result depends on the number of threads'); end
+            Terr = max(abs(T1(:)-T3(:))./max(T1(:),eps));
+            Yerr = max(abs(Y1(:)-Y3(:)));
+            fprintf('%4d  %-8s  %5d  %9.3f  %10.3f  %12.3f  %9.2e  %9.2e\n', n, SpeedNames{s}, UseCross, t1, t2, t3, Terr, Yerr);
+        end
+    end
+end
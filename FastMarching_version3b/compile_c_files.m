@@ -3,11 +3,23 @@ cd('functions');
 files=dir('*.c');
 clear msfm2d
 clear msfm3d
+clear fim3d
 mex -compatibleArrayDims msfm2d.c 
 mex -compatibleArrayDims msfm3d.c 
+if ispc
+    mex -compatibleArrayDims COMPFLAGS="$COMPFLAGS /openmp" fim3d.c
+else
+    mex -compatibleArrayDims CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" fim3d.c
+end
 
 cd('..');
 cd('shortestpath');
 clear rk4
+clear tracepath
 mex -compatibleArrayDims rk4.c
+if ispc
+    mex -compatibleArrayDims COMPFLAGS="$COMPFLAGS /openmp" tracepath.c
+else
+    mex -compatibleArrayDims CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" tracepath.c
+end
 cd('..')
@@ -0,0 +1,600 @@
+#include "mex.h"
+#include "math.h"
+#include "common.c"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*This function FIM3D calculates the shortest distance from a list of */
+/*points to all other pixels in an image volume, with the same multi */
+/*stencils as MSFM3D, but using a block based Fast Iterative Method (FIM) */
+/*instead of a single narrow band, so that it can run on multiple cores. */
+/* */
+/*[T,Y]=fim3d(F, SourcePoints, UseSecond, UseCross, Tolerance, NumThreads) */
+/* */
+/*inputs, */
+/*   F: The 3D speed image. The speed function must always be larger */
+/*			than zero (min value 1e-8), otherwise some regions will */
+/*			never be reached because the time will go to infinity.  */
+/*  SourcePoints : A list of starting points [3 x N] (distance zero) */
+/*  UseSecond : Boolean Set to true if not only first but also second */
+/*               order derivatives are used (default) */
+/*  UseCross: Boolean Set to true if also cross neighbours */
+/*               are used (default false, see below) */
+/*  Tolerance: A block is solved again if the relative change of the */
+/*               distance of one of its neighbour pixels is larger than */
+/*               Tolerance (default 1e-6) */
+/*  NumThreads: Number of threads, 0 for all the cores (default) */
+/*outputs, */
+/*  T : Image with distance from SourcePoints to all pixels */
+/*  Y : Image for augmented fastmarching with, euclidian distance from */
+/*      SourcePoints to all pixels. */
+/* */
+/*The volume is split in blocks of BSIZE^3 pixels, and an active list */
+/*holds the blocks which can still change. A block of the list is solved */
+/*by a local fast marching, in which the pixels of the neighbour blocks */
+/*within reach of the stencils are frozen at their current distance when */
+/*the narrow band reaches their value. The update of a pixel is the one of */
+/*msfm3d, thus the msfm3d solution is a fixed point of this iteration. If */
+/*the distances of a block change, the neighbour blocks which have a */
+/*changed pixel in their border are put in the list for the next round, */
+/*until no block changes anymore. */
+/*The blocks are processed in 8 phases by the parity of their x, y and z */
+/*block coordinates : two blocks of the same phase are at least BSIZE */
+/*pixels apart, larger than the reach of the stencils, so the threads */
+/*never write a pixel which is read by another thread and no locks are */
+/*needed. */
+/*The cross stencils of msfm3d read the neighbours frozen before the */
+/*pixel, so their result depends on the order in which pixels with the */
+/*same distance are frozen, which is arbitrary in msfm3d and different */
+/*in each block here. Already a single narrow band with another tie */
+/*order changes msfm3d's cross stencil result by up to 25%, thus cross */
+/*neighbours are off by default, and the result then equals msfm3d */
+/*with UseCross false. */
+/* */
+/*Literature : W. Jeong, R. Whitaker, A Fast Iterative Method for Eikonal */
+/*   Equations, SIAM J. Sci. Comput. 2008 */
+/*   J. Yang, F. Stern, A highly scalable massively parallel fast marching */
+/*   method for the Eikonal equation, J. Comput. Phys. 2017 */
+
+/* Size of the blocks */
+#define BSIZE 8
+
+/* Border around a block, the reach of the second order stencils */
+#define BORDER 2
+
+/* Size of a block with its border */
+#define LSIZE (BSIZE+2*BORDER)
+#define LPIXELS (LSIZE*LSIZE*LSIZE)
+
+/* The stencils of msfm3d use the pixels frozen before, thus the result */
+/* depends on the order of pixels with the same distance, and the blocks */
+/* can oscillate by tiny amounts around the solution. A block solved */
+/* MAXSOLVE times only accepts smaller distances, which ends the iteration */
+#define MAXSOLVE 8
+
+/* Pixel states in the local fast marching of a block */
+#define FAR 0
+#define BAND 1
+#define KNOWN 2
+#define FROZEN 3
+#define OUTSIDE 4
+
+/* The 13 stencil directions, x, y, z and the cross directions */
+static const int dirs[39]={ 1, 0, 0,   0, 1, 0,   0, 0, 1,
+                            0, 1, 1,   0, 1,-1,   1, 0,-1,   1, 0, 1,
+                            1, 1, 0,   1,-1, 0,   1, 1,-1,   1,-1,-1,
+                            1, 1, 1,   1,-1, 1};
+
+/* The 6 stencils of msfm3d as triplets of directions, with their constants */
+static const int stencils[18]={ 0, 1, 2,   0, 3, 4,   1, 5, 6,   2, 7, 8,   6, 9, 10,   5, 11, 12};
+static const double G1[18]={1, 1, 1, 1, 0.5, 0.5, 1, 0.5, 0.5, 1, 0.5, 0.5, 0.5, 0.3333333333333, 0.3333333333333, 0.5, 0.3333333333333, 0.3333333333333};
+static const double G2[18]={2.250, 2.250, 2.250, 2.250, 1.125, 1.125, 2.250, 1.125, 1.125, 2.250, 1.125, 1.125, 1.125, 0.750, 0.750, 1.125, 0.750, 0.750};
+
+double second_derivative(double Txm1, double Txm2, double Txp1, double Txp2) {
+    bool ch1, ch2;
+    double Tm;
+    Tm=INF;
+    ch1=(Txm2<Txm1)&&IsFinite(Txm1); ch2=(Txp2<Txp1)&&IsFinite(Txp1);
+    if(ch1&&ch2) { Tm =min( (4.0*Txm1-Txm2)/3.0 , (4.0*Txp1-Txp2)/3.0);}
+    else if(ch1) { Tm =(4.0*Txm1-Txm2)/3.0; }
+    else if(ch2) { Tm =(4.0*Txp1-Txp2)/3.0; }
+    return Tm;
+}
+
+/* Distance of a pixel from the values Tn of its frozen neighbours (INF */
+/* if not frozen), same equations as CalculateDistance in msfm3d.c */
+double StencilDistance(double *Tn, double Fijk, bool usesecond, bool usecross) {
+    /* Loop variables */
+    int q, t, d;
+
+    /* Derivatives for each direction */
+    double Tm[13], Tm2[13];
+    int Order[13];
+    double Coeff[3];
+    double m1, m2, p1, p2;
+    double Tt, Tt2, Tmin;
+    int ndir=usecross ? 13 : 3;
+
+    /* Return values root of polynomial */
+    double ansroot[2]={0, 0};
+
+    /*The values in order is 0 if no neighbours in that direction */
+    /*1 if 1e order derivatives is used and 2 if second order */
+    /*derivatives are used */
+    Tmin=INF;
+    for(d=0; d<ndir; d++) {
+        m1=Tn[d*4+1]; p1=Tn[d*4+2];
+        Tm[d]=min(m1, p1); if(IsFinite(Tm[d])){ Order[d]=1; } else { Order[d]=0; }
+        Tm2[d]=0;
+        if(usesecond) {
+            m2=Tn[d*4]; p2=Tn[d*4+3];
+            Tm2[d]=second_derivative(m1, m2, p1, p2); if(IsInf(Tm2[d])) { Tm2[d]=0; } else { Order[d]=2; }
+        }
+        if(Tm[d]<Tmin) { Tmin=Tm[d]; }
+    }
+
+    /*Calculate the distance using x and y direction */
+    Coeff[0]=0; Coeff[1]=0; Coeff[2]=-1/(max(pow2(Fijk),eps));
+    for (t=0; t<3; t++) {
+        d=stencils[t];
+        switch(Order[d]) {
+            case 1:
+                Coeff[0]+=G1[t]; Coeff[1]+=-2.0*Tm[d]*G1[t]; Coeff[2]+=pow2(Tm[d])*G1[t];
+                break;
+            case 2:
+                Coeff[0]+=G2[t]; Coeff[1]+=-2.0*Tm2[d]*G2[t]; Coeff[2]+=pow2(Tm2[d])*G2[t];
+                break;
+        }
+    }
+    roots(Coeff, ansroot);
+    Tt=max(ansroot[0], ansroot[1]);
+
+    /*Calculate the distance using the cross directions */
+    if(usecross) {
+        for(q=1; q<6; q++) {
+            /* The coefficients are summed over the stencils, as in msfm3d */
+            Coeff[2]+=-1/(max(pow2(Fijk),eps));
+            for (t=q*3; t<((q+1)*3); t++) {
+                d=stencils[t];
+                switch(Order[d]) {
+                    case 1:
+                        Coeff[0]+=G1[t]; Coeff[1]+=-2.0*Tm[d]*G1[t]; Coeff[2]+=pow2(Tm[d])*G1[t];
+                        break;
+                    case 2:
+                        Coeff[0]+=G2[t]; Coeff[1]+=-2.0*Tm2[d]*G2[t]; Coeff[2]+=pow2(Tm2[d])*G2[t];
+                        break;
+                }
+            }
+            /*Select maximum root solution and minimum distance value of both stensils */
+            if(Coeff[0]>0) { roots(Coeff, ansroot); Tt2=max(ansroot[0], ansroot[1]); Tt=min(Tt, Tt2); }
+        }
+    }
+
+    /*Upwind condition check, current distance must be larger */
+    /*then direct neighbours used in solution */
+    for(d=0; d<ndir; d++) {
+        if(IsFinite(Tm[d])&&(Tt<Tm[d])) { Tt=Tmin+(1/(max(Fijk,eps))); break; }
+    }
+    return Tt;
+}
+
+/* Memory of the local fast marching of a block, with its border */
+typedef struct {
+    double T[LPIXELS];
+    double Y[LPIXELS];
+    int index[LPIXELS];
+    unsigned char state[LPIXELS];
+    /* Binary heap of the narrow band, and position of the pixels in it */
+    int heap[LPIXELS];
+    int pos[LPIXELS];
+    int nheap;
+} block_march;
+
+void heap_up(block_march *bm, int h) {
+    int p, l=bm->heap[h];
+    while(h>0) {
+        p=(h-1)/2;
+        if(bm->T[bm->heap[p]]<=bm->T[l]) { break; }
+        bm->heap[h]=bm->heap[p]; bm->pos[bm->heap[h]]=h;
+        h=p;
+    }
+    bm->heap[h]=l; bm->pos[l]=h;
+}
+
+void heap_push(block_march *bm, int l) {
+    bm->heap[bm->nheap]=l;
+    bm->nheap++;
+    heap_up(bm, bm->nheap-1);
+}
+
+int heap_pop(block_march *bm) {
+    int h=0, c, l, top=bm->heap[0];
+    bm->nheap--;
+    l=bm->heap[bm->nheap];
+    while((c=2*h+1)<bm->nheap) {
+        if((c+1<bm->nheap)&&(bm->T[bm->heap[c+1]]<bm->T[bm->heap[c]])) { c++; }
+        if(bm->T[l]<=bm->T[bm->heap[c]]) { break; }
+        bm->heap[h]=bm->heap[c]; bm->pos[bm->heap[h]]=h;
+        h=c;
+    }
+    bm->heap[h]=l; bm->pos[l]=h;
+    return top;
+}
+
+/* Get the frozen neighbours of local pixel l along the 13 directions, */
+/* stored as m2, m1, p1, p2 (INF if not frozen) */
+void get_frozen_neighbours(double *Tl, unsigned char *state, int l, int ndir, double *Tn) {
+    int d, s, o, ln;
+    int steps[4]={-2, -1, 1, 2};
+    for(d=0; d<ndir; d++) {
+        o=dirs[d*3]+dirs[d*3+1]*LSIZE+dirs[d*3+2]*LSIZE*LSIZE;
+        for(s=0; s<4; s++) {
+            ln=l+steps[s]*o;
+            Tn[d*4+s]=(state[ln]==FROZEN) ? Tl[ln] : INF;
+        }
+    }
+}
+
+/* Set in mask the neighbour blocks which have pixel (li,lj,lk) of the */
+/* block in their border, bit (x+1)+(y+1)*3+(z+1)*9 for neighbour (x,y,z) */
+void border_mask(int li, int lj, int lk, int *mask) {
+    int x, y, z, s[3], p[3];
+    p[0]=li-BORDER; p[1]=lj-BORDER; p[2]=lk-BORDER;
+    for(x=0; x<3; x++) { s[x]=2|((p[x]<BORDER)?1:0)|((p[x]>=BSIZE-BORDER)?4:0); }
+    for(z=0; z<3; z++) {
+        if(!(s[2]&(1<<z))) { continue; }
+        for(y=0; y<3; y++) {
+            if(!(s[1]&(1<<y))) { continue; }
+            for(x=0; x<3; x++) {
+                if(s[0]&(1<<x)) { mask[0]|=1<<(x+y*3+z*9); }
+            }
+        }
+    }
+}
+
+/* Solve block b by fast marching, with the current distances of the */
+/* pixels around it, returns the mask of the neighbour blocks which have */
+/* a changed pixel in their border (0 if nothing changed). */
+/* With decrease only the distances are only replaced by smaller ones */
+int solve_block(double *T, double *Y, double *F, bool *Fixed, int *dims, int *bdims, int b,
+        bool usesecond, bool usecross, double tol, bool decrease, bool Ed, block_march *bm) {
+    /* Neighbours 6x3 */
+    int ne[6]={-1, 1, -LSIZE, LSIZE, -LSIZE*LSIZE, LSIZE*LSIZE};
+    /* Loop variables */
+    int i, j, k, li, lj, lk, w;
+    int l, ln, index;
+    int ndir=usecross ? 13 : 3;
+    double Tt;
+    double Tn[52];
+    bool inside, border;
+    int mask=0;
+
+    /* Origin of the block with its border */
+    int i0=(b%bdims[0])*BSIZE-BORDER;
+    int j0=((b/bdims[0])%bdims[1])*BSIZE-BORDER;
+    int k0=(b/(bdims[0]*bdims[1]))*BSIZE-BORDER;
+
+    /* The pixels of the border with a distance, and the source points */
+    /* are known, they are frozen when the narrow band reaches them */
+    bm->nheap=0;
+    for(lk=0; lk<LSIZE; lk++) {
+        for(lj=0; lj<LSIZE; lj++) {
+            for(li=0; li<LSIZE; li++) {
+                l=li+lj*LSIZE+lk*LSIZE*LSIZE;
+                i=i0+li; j=j0+lj; k=k0+lk;
+                inside=(i>=0)&&(j>=0)&&(k>=0)&&(i<dims[0])&&(j<dims[1])&&(k<dims[2]);
+                border=(li<BORDER)||(lj<BORDER)||(lk<BORDER)||(li>=BSIZE+BORDER)||(lj>=BSIZE+BORDER)||(lk>=BSIZE+BORDER);
+                bm->T[l]=INF; bm->Y[l]=INF;
+                if(!inside) { bm->state[l]=OUTSIDE; continue; }
+                index=mindex3(i, j, k, dims[0], dims[1]);
+                bm->index[l]=index;
+                if(border) {
+                    if(IsFinite(T[index])) {
+                        bm->T[l]=T[index];
+                        if(Ed) { bm->Y[l]=Y[index]; }
+                        bm->state[l]=KNOWN; heap_push(bm, l);
+                    }
+                    else {
+                        bm->state[l]=OUTSIDE;
+                    }
+                }
+                else if(Fixed[index]) {
+                    bm->T[l]=0; bm->Y[l]=0;
+                    bm->state[l]=KNOWN; heap_push(bm, l);
+                }
+                else {
+                    bm->state[l]=FAR;
+                }
+            }
+        }
+    }
+
+    /* Local fast marching, as in msfm3d */
+    while(bm->nheap>0) {
+        l=heap_pop(bm);
+        bm->state[l]=FROZEN;
+        /* The outer pixels of the border have no neighbour in the block */
+        li=l%LSIZE; lj=(l/LSIZE)%LSIZE; lk=l/(LSIZE*LSIZE);
+        if((li<1)||(lj<1)||(lk<1)||(li>=LSIZE-1)||(lj>=LSIZE-1)||(lk>=LSIZE-1)) { continue; }
+        for (w=0; w<6; w++) {
+            ln=l+ne[w];
+            if((bm->state[ln]!=FAR)&&(bm->state[ln]!=BAND)) { continue; }
+            if(Fixed[bm->index[l]]) {
+                /* Neighbour of a starting point, as in msfm3d */
+                Tt=1/(max(F[bm->index[ln]],eps));
+            }
+            else {
+                get_frozen_neighbours(bm->T, bm->state, ln, ndir, Tn);
+                Tt=StencilDistance(Tn, F[bm->index[ln]], usesecond, usecross);
+            }
+            if(bm->state[ln]==FAR) {
+                bm->T[ln]=Tt;
+                if(Ed&&!Fixed[bm->index[l]]) {
+                    get_frozen_neighbours(bm->Y, bm->state, ln, ndir, Tn);
+                    bm->Y[ln]=StencilDistance(Tn, 1, usesecond, usecross);
+                }
+                else if(Ed) {
+                    bm->Y[ln]=0;
+                }
+                bm->state[ln]=BAND; heap_push(bm, ln);
+            }
+            else if(Tt<bm->T[ln]) {
+                bm->T[ln]=Tt;
+                heap_up(bm, bm->pos[ln]);
+            }
+        }
+    }
+
+    /* Store the distances of the block */
+    for(lk=BORDER; lk<BSIZE+BORDER; lk++) {
+        for(lj=BORDER; lj<BSIZE+BORDER; lj++) {
+            for(li=BORDER; li<BSIZE+BORDER; li++) {
+                l=li+lj*LSIZE+lk*LSIZE*LSIZE;
+                if(bm->state[l]==OUTSIDE) { continue; }
+                index=bm->index[l];
+                if(decrease&&!(bm->T[l]<T[index])) { continue; }
+                if(fabs(bm->T[l]-T[index])>tol*bm->T[l]) { border_mask(li, lj, lk, &mask); }
+                T[index]=bm->T[l];
+                if(Ed) { Y[index]=bm->Y[l]; }
+            }
+        }
+    }
+    return mask;
+}
+
+/* The matlab mex function */
+void mexFunction( int nlhs, mxArray *plhs[],
+        int nrhs, const mxArray *prhs[] ) {
+    /* The input variables */
+    double *F, *SourcePoints;
+    bool *useseconda, *usecrossa;
+    bool usesecond=true;
+    bool usecross=false;
+    double tol=1e-6;
+    int nthreads=0;
+
+    /* The output distance image */
+    double *T;
+
+    /* Euclidian distance image */
+    double *Y=NULL;
+
+    /* Source pixels, which keep distance zero */
+    bool *Fixed;
+
+    /* Augmented Fast Marching (For skeletonize) */
+    bool Ed;
+
+    /* Size of input image */
+    const mwSize *dims_c;
+    mwSize dims_m[3];
+    int dims[3];
+
+    /* Number of pixels in image */
+    int npixels;
+
+    /* Number of blocks, and number of blocks in each dimension */
+    int nblocks;
+    int bdims[3];
+
+    /* Active list for the current round, and for the next round */
+    int *active, *next;
+    int nactive, nnext;
+    bool *inlist;
+    int *changed;
+    /* Number of times each block was solved */
+    unsigned char *nsolved;
+    block_march *bm;
+    /* Start of the blocks of each phase in the active list */
+    int phase_start[9];
+    int *phase_list;
+
+    /* Loop variables */
+    int s, q, p, c, bx, by, bz, nb;
+
+    /* Current location */
+    int x, y, z;
+
+    /* Index */
+    int XYZ_index;
+
+    /* Check for proper number of input and output arguments. */
+    if((nrhs<2)||(nrhs>6)) {
+        mexErrMsgTxt("2 to 6 inputs are required.");
+    }
+    if(nlhs<=1) { Ed=0; }
+    else if (nlhs==2) { Ed=1; }
+    else {
+        mexErrMsgTxt("One or Two outputs required");
+    }
+
+    /* Check data input types */
+    if(mxGetClassID(prhs[0])!=mxDOUBLE_CLASS) {
+        mexErrMsgTxt("Speed image must be of class double");
+    }
+    if(mxGetClassID(prhs[1])!=mxDOUBLE_CLASS) {
+        mexErrMsgTxt("SourcePoints must be of class double");
+    }
+    if((nrhs>2)&&(mxGetClassID(prhs[2])!= mxLOGICAL_CLASS)) {
+        mexErrMsgTxt("UseSecond must be of class boolean / logical");
+    }
+    if((nrhs>3)&&(mxGetClassID(prhs[3])!= mxLOGICAL_CLASS)) {
+        mexErrMsgTxt("UseCross must be of class boolean / logical");
+    }
+
+    /* Get the sizes of the input image volume */
+    if(mxGetNumberOfDimensions(prhs[0])==3) {
+        dims_c= mxGetDimensions(prhs[0]);
+        dims_m[0]=dims_c[0]; dims_m[1]=dims_c[1]; dims_m[2]=dims_c[2];
+        dims[0]=(int)dims_c[0]; dims[1]=(int)dims_c[1]; dims[2]=(int)dims_c[2];
+        npixels=dims[0]*dims[1]*dims[2];
+    }
+    else {
+        mexErrMsgTxt("Speed image must be 3d.");
+    }
+
+    /* Get the sizes of the  SourcePoints */
+    if(mxGetM(prhs[1])!=3) {
+        mexErrMsgTxt("SourcePoints must be a 3xn matrix.");
+    }
+
+    /* Get pointers/data from  to each input. */
+    F=(double*)mxGetPr(prhs[0]);
+    SourcePoints=(double*)mxGetPr(prhs[1]);
+    if(nrhs>2){ useseconda = (bool*)mxGetPr(prhs[2]); usesecond=useseconda[0];}
+    if(nrhs>3){ usecrossa = (bool*)mxGetPr(prhs[3]); usecross=usecrossa[0];}
+    if((nrhs>4)&&!mxIsEmpty(prhs[4])){ tol=mxGetScalar(prhs[4]); }
+    if(nrhs>5){ nthreads=(int)mxGetScalar(prhs[5]); }
+#ifdef _OPENMP
+    if(nthreads<=0) { nthreads=omp_get_max_threads(); }
+#else
+    nthreads=1;
+#endif
+
+    for (s=0; s<(int)mxGetN(prhs[1]); s++) {
+        x= (int)SourcePoints[0+s*3]-1;
+        y= (int)SourcePoints[1+s*3]-1;
+        z= (int)SourcePoints[2+s*3]-1;
+        if((x<0)||(y<0)||(z<0)||(x>=dims[0])||(y>=dims[1])||(z>=dims[2])) {
+            mexErrMsgTxt("SourcePoints must be inside the image.");
+        }
+    }
+
+    /* Create the distance output array */
+    plhs[0] = mxCreateNumericArray(3, dims_m, mxDOUBLE_CLASS, mxREAL);
+    T= mxGetPr(plhs[0]);
+    if(Ed) {
+        plhs[1] = mxCreateNumericArray(3, dims_m, mxDOUBLE_CLASS, mxREAL);
+        Y= mxGetPr(plhs[1]);
+    }
+
+    /* Blocks */
+    bdims[0]=(dims[0]+BSIZE-1)/BSIZE; bdims[1]=(dims[1]+BSIZE-1)/BSIZE; bdims[2]=(dims[2]+BSIZE-1)/BSIZE;
+    nblocks=bdims[0]*bdims[1]*bdims[2];
+    active = (int*)malloc( nblocks* sizeof(int) );
+    next = (int*)malloc( nblocks* sizeof(int) );
+    changed = (int*)malloc( nblocks* sizeof(int) );
+    nsolved = (unsigned char*)malloc( nblocks* sizeof(unsigned char) );
+    phase_list = (int*)malloc( nblocks* sizeof(int) );
+    inlist = (bool*)malloc( nblocks* sizeof(bool) );
+    for(q=0;q<nblocks;q++){inlist[q]=0; nsolved[q]=0;}
+    nactive=0;
+
+    Fixed = (bool*)malloc( npixels* sizeof(bool) );
+    for(q=0;q<npixels;q++){Fixed[q]=0; T[q]=INF;}
+    if(Ed) {
+        for(q=0;q<npixels;q++){Y[q]=INF;}
+    }
+
+    /* set all starting points to distance zero and fixed, and put */
+    /* the blocks around them in the active list */
+    for (s=0; s<(int)mxGetN(prhs[1]); s++) {
+        x= (int)SourcePoints[0+s*3]-1;
+        y= (int)SourcePoints[1+s*3]-1;
+        z= (int)SourcePoints[2+s*3]-1;
+        XYZ_index=mindex3(x, y, z, dims[0], dims[1]);
+        Fixed[XYZ_index]=1;
+        T[XYZ_index]=0;
+        if(Ed) { Y[XYZ_index]=0; }
+        for(bz=max(z/BSIZE-1,0); bz<=min(z/BSIZE+1,bdims[2]-1); bz++) {
+            for(by=max(y/BSIZE-1,0); by<=min(y/BSIZE+1,bdims[1]-1); by++) {
+                for(bx=max(x/BSIZE-1,0); bx<=min(x/BSIZE+1,bdims[0]-1); bx++) {
+                    nb=mindex3(bx, by, bz, bdims[0], bdims[1]);
+                    if(!inlist[nb]) { inlist[nb]=1; active[nactive++]=nb; }
+                }
+            }
+        }
+    }
+
+    /* Process the active list until no block changes anymore */
+    while(nactive>0) {
+        /* Sort the active blocks by phase */
+        for(c=0; c<9; c++) { phase_start[c]=0; }
+        for(q=0; q<nactive; q++) {
+            p=active[q];
+            c=(p%bdims[0])%2 + (((p/bdims[0])%bdims[1])%2)*2 + ((p/(bdims[0]*bdims[1]))%2)*4;
+            phase_start[c+1]++;
+            inlist[p]=0;
+        }
+        for(c=0; c<8; c++) { phase_start[c+1]+=phase_start[c]; }
+        for(q=0; q<nactive; q++) {
+            p=active[q];
+            c=(p%bdims[0])%2 + (((p/bdims[0])%bdims[1])%2)*2 + ((p/(bdims[0]*bdims[1]))%2)*4;
+            phase_list[phase_start[c]++]=p;
+        }
+        for(c=8; c>0; c--) { phase_start[c]=phase_start[c-1]; }
+        phase_start[0]=0;
+
+        nnext=0;
+        for(c=0; c<8; c++) {
+            /* Blocks of the same phase do not share pixels within the */
+            /* reach of the stencils and are solved in parallel */
+#ifdef _OPENMP
+            #pragma omp parallel private(bm) num_threads(nthreads) if(nthreads>1)
+#endif
+            {
+                bm = (block_march*)malloc( sizeof(block_march) );
+#ifdef _OPENMP
+                #pragma omp for schedule(dynamic,1)
+#endif
+                for(q=phase_start[c]; q<phase_start[c+1]; q++) {
+                    int b=phase_list[q];
+                    changed[q]=solve_block(T, Y, F, Fixed, dims, bdims, b, usesecond, usecross, tol, nsolved[b]>=MAXSOLVE, Ed, bm);
+                    if(nsolved[b]<MAXSOLVE) { nsolved[b]++; }
+                }
+                free(bm);
+            }
+
+            /* Put the neighbours of the changed blocks in the next list, */
+            /* if the change is within their border */
+            for(q=phase_start[c]; q<phase_start[c+1]; q++) {
+                if(changed[q]==0) { continue; }
+                p=phase_list[q];
+                x=p%bdims[0]; y=(p/bdims[0])%bdims[1]; z=p/(bdims[0]*bdims[1]);
+                for(bz=max(z-1,0); bz<=min(z+1,bdims[2]-1); bz++) {
+                    for(by=max(y-1,0); by<=min(y+1,bdims[1]-1); by++) {
+                        for(bx=max(x-1,0); bx<=min(x+1,bdims[0]-1); bx++) {
+                            nb=mindex3(bx, by, bz, bdims[0], bdims[1]);
+                            /* A block only changes again if a neighbour changes */
+                            if(nb==p) { continue; }
+                            if(!(changed[q]&(1<<((bx-x+1)+(by-y+1)*3+(bz-z+1)*9)))) { continue; }
+                            if(!inlist[nb]) { inlist[nb]=1; next[nnext++]=nb; }
+                        }
+                    }
+                }
+            }
+        }
+        for(q=0; q<nnext; q++) { active[q]=next[q]; }
+        nactive=nnext;
+    }
+
+    /* Free memory */
+    free(active);
+    free(next);
+    free(changed);
+    free(nsolved);
+    free(phase_list);
+    free(inlist);
+    free(Fixed);
+}
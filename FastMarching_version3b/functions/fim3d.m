@@ -0,0 +1,46 @@
+% This function FIM3D calculates the shortest distance from a list of
+% points to all other pixels in an image volume, as MSFM3D and with the
+% same stencils, but with a block parallel iterative method which uses all
+% cores. The volume is split in blocks of 8x8x8 pixels, each active block
+% is solved by a local fast marching with the current distances around
+% it, and blocks are solved again while the distances in their neighbours
+% change. Blocks which do not touch are solved in parallel.
+%
+% [T,Y]=fim3d(F, SourcePoints, UseSecond, UseCross, Tolerance, NumThreads)
+%
+% inputs,
+%   F: The 3D speed image. The speed function must always be larger
+%			than zero (min value 1e-8), otherwise some regions will
+%			never be reached because the time will go to infinity.
+%   SourcePoints : A list of starting points [3 x N] (distance zero)
+%   UseSecond : Boolean Set to true if not only first but also second
+%                order derivatives are used (default)
+%   UseCross : Boolean Set to true if also cross neighbours
+%                are used (default false)
+%   Tolerance : Relative change of the distance below which a block is
+%                converged (default 1e-6)
+%   NumThreads : Number of threads, 0 for all cores (default)
+% outputs,
+%   T : Image with distance from SourcePoints to all pixels
+%   Y : Image with the euclidean distance from SourcePoints to all pixels
+%
+% Note:
+%   Without cross neighbours the result equals the result of msfm3d with
+%   UseCross false. The cross stencils of msfm3d depend on the order in
+%   which pixels with the same distance are frozen, which differs between
+%   the blocks, so with UseCross true the results differ (up to 25% near
+%   obstacles). Compile with OpenMP to use more than one core, see
+%   compile_c_files, and see compare_fim3d for timings and errors.
+%
+% Literature : W.K. Jeong and R.T. Whitaker, A Fast Iterative Method
+%   for Eikonal Equations, SIAM J. Sci. Comput. 2008
+%   J. Yang and F. Stern, A highly scalable massively parallel fast
+%   marching method for the Eikonal equation, J. Comput. Phys. 2017
+%
+% Example,
+%   SourcePoint = [21; 21; 21];
+%   SpeedImage = ones([81 81 81]);
+%
+%   tic; T1 = msfm3d(SpeedImage, SourcePoint, true, false); toc;
+%   tic; T2 = fim3d(SpeedImage, SourcePoint, true, false); toc;
+%   fprintf('mean difference %9.5f\n', mean(abs(T1(:)-T2(:))));
@@ -20,6 +20,20 @@
  *outputs,
  *  T : Image with distance from SourcePoints to all pixels
  *
+ *[T,Y]=msfm2d(F, SourcePoints, UseSecond, UseCross, T0, Y0)
+ *
+ *Incremental mode, adds SourcePoints to the sources of a previous result
+ *T0 (and Y0), as used by skeleton.m for every new branch. The pixels of
+ *T0 are kept, and only pixels whose distance becomes smaller are opened
+ *again, thus the cost is that of the region which is closer to the new
+ *SourcePoints instead of the whole image.
+ *
+ *The Y of a pixel is computed when it is frozen, from the pixels of its
+ *stencils which were frozen before its first frozen neighbour, so it only
+ *depends on the final T. It is the Y the pixel gets when it enters the
+ *narrow band of a full run, and the incremental mode gives the Y of a
+ *full run with all sources.
+ *
  *Function is written by D.Kroon University of Twente (June 2009)
  */
 
@@ -199,6 +213,90 @@ double CalculateDistance(double *T, double Fij, int *dims, int i, int j, bool us
     return Tt;
 }
 
+/* Y of the frozen pixel i,j, from the stencil pixels with a distance up to */
+/* the one of its first frozen neighbour (kept pixels of the incremental */
+/* mode included), these are the pixels which were frozen when it entered */
+/* the narrow band */
+double CalculateY(double *T, double *Y, int *dims, int i, int j, bool usesecond, bool usecross, bool *Frozen, unsigned char *Old) {
+    int ne[8]={-1, 1, 0, 0, 0, 0, -1, 1};
+    int flipped[25];
+    int in, jn, s, t, k, nflipped=0, index;
+    double Tq=INF, Ty;
+    bool final;
+
+    /* Distance of the first frozen neighbour */
+    for (k=0; k<4; k++) {
+        in=i+ne[k]; jn=j+ne[k+4];
+        if((in<0)||(jn<0)||(in>=dims[0])||(jn>=dims[1])) { continue; }
+        index=in+jn*dims[0];
+        final=Frozen[index]||((Old!=NULL)&&(Old[index]==1));
+        if(final&&(T[index]<Tq)) { Tq=T[index]; }
+    }
+
+    /* Neighbour of a source point */
+    if(Tq<=0) { return 1; }
+
+    /* Only freeze the stencil pixels up to distance Tq */
+    for (t=-2; t<=2; t++) {
+        for (s=-2; s<=2; s++) {
+            in=i+s; jn=j+t;
+            if(((s==0)&&(t==0))||(in<0)||(jn<0)||(in>=dims[0])||(jn>=dims[1])) { continue; }
+            index=in+jn*dims[0];
+            final=Frozen[index]||((Old!=NULL)&&(Old[index]==1));
+            final=final&&(T[index]<=Tq);
+            if(Frozen[index]!=final) { Frozen[index]=final; flipped[nflipped++]=index; }
+        }
+    }
+    Ty=CalculateDistance(Y, 1, dims, i, j, usesecond, usecross, Frozen);
+    for (k=0; k<nflipped; k++) { Frozen[flipped[k]]=!Frozen[flipped[k]]; }
+    return Ty;
+}
+
+/* Incremental mode : freeze the kept pixels within reach of the stencils */
+/* of pixel i,j, which have a distance below the current distance Tc */
+void freeze_old2d(int i, int j, int *dims, unsigned char *Old, bool *Frozen, double *T, double Tc, bool usesecond) {
+    int in, jn, s, t, r, IJ_index;
+    for (r=1; r<=(usesecond?2:1); r++) {
+        for (t=-1; t<=1; t++) {
+            for (s=-1; s<=1; s++) {
+                in=i+s*r; jn=j+t*r;
+                if((in<0)||(jn<0)||(in>=dims[0])||(jn>=dims[1])) { continue; }
+                IJ_index=in+jn*dims[0];
+                if((Old[IJ_index]==1)&&(T[IJ_index]<=Tc)) { Old[IJ_index]=0; Frozen[IJ_index]=1; }
+            }
+        }
+    }
+}
+
+/* Incremental mode : the kept pixels within reach of the stencils of */
+/* the opened pixel i,j are added to the narrow band with their kept */
+/* distance, thus they update the opened pixels when they are frozen */
+void push_old2d(int i, int j, int *dims, unsigned char *Old, bool *Frozen, double *T, double Tc, bool usesecond, double **listval, int *listprop, int *neg_pos, int *neg_free, double **neg_listx, double **neg_listy) {
+    int in, jn, s, t, r, IJ_index;
+    for (r=1; r<=(usesecond?2:1); r++) {
+        for (t=-1; t<=1; t++) {
+            for (s=-1; s<=1; s++) {
+                in=i+s*r; jn=j+t*r;
+                if((in<0)||(jn<0)||(in>=dims[0])||(jn>=dims[1])) { continue; }
+                IJ_index=in+jn*dims[0];
+                if(Old[IJ_index]!=1) { continue; }
+                if(T[IJ_index]<=Tc) { Old[IJ_index]=0; Frozen[IJ_index]=1; continue; }
+                Old[IJ_index]=2;
+                /*If running out of memory at a new block  */
+                if((*neg_pos)>=(*neg_free)) {
+                    (*neg_free)+=100000;
+                    (*neg_listx) = (double *)realloc((*neg_listx), (*neg_free)*sizeof(double) );
+                    (*neg_listy) = (double *)realloc((*neg_listy), (*neg_free)*sizeof(double) );
+                }
+                list_add(listval, listprop, T[IJ_index]);
+                (*neg_listx)[*neg_pos]=in; (*neg_listy)[*neg_pos]=jn;
+                T[IJ_index]=(*neg_pos);
+                (*neg_pos)++;
+            }
+        }
+    }
+}
+
 /* The matlab mex function  */
 void mexFunction( int nlhs, mxArray *plhs[],
         int nrhs, const mxArray *prhs[] ) {
@@ -215,7 +313,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
     double *Y;
     
     /* Current distance values */
-    double Tt, Ty;
+    double Tt;
     
     /* Matrix containing the Frozen Pixels" */
     bool *Frozen;
@@ -223,6 +321,13 @@ void mexFunction( int nlhs, mxArray *plhs[],
     /* Augmented Fast Marching (For skeletonize) */
     bool Ed;
     
+    /* Incremental mode, previous distances and the state of the pixels, */
+    /* 1 : kept previous distance, 2 : kept distance in the narrow band */
+    bool changed=true;
+    bool incremental=false;
+    double *T0, *Y0;
+    unsigned char *Old;
+    
     /* Size of input image */
     const mwSize *dims_c;
     mwSize dims[2];
@@ -240,7 +345,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
     double *neg_listv;
     double *neg_listx;
     double *neg_listy;
-    double *neg_listo;
     
     int *listprop;
     double **listval;
@@ -259,7 +363,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
     
     /* Check for proper number of input and output arguments. */
     if(nrhs<3) {
-        mexErrMsgTxt("2 to 4 inputs are required.");
+        mexErrMsgTxt("2 to 6 inputs are required.");
     }
     if(nlhs==1) { Ed=0; }
     else if (nlhs==2) { Ed=1; }
@@ -281,6 +385,19 @@ void mexFunction( int nlhs, mxArray *plhs[],
     if((nrhs>3)&&(mxGetClassID(prhs[3])!= mxLOGICAL_CLASS)) {
         mexErrMsgTxt("UseCross must be of class boolean / logical");
     }
+    
+    if(nrhs>4) {
+        incremental=true;
+        if(mxGetClassID(prhs[4])!=mxDOUBLE_CLASS) {
+            mexErrMsgTxt("T0 must be of class double");
+        }
+        if(Ed&&(nrhs<6)) {
+            mexErrMsgTxt("Y0 is required for the Y output in incremental mode");
+        }
+        if((nrhs>5)&&(mxGetClassID(prhs[5])!=mxDOUBLE_CLASS)) {
+            mexErrMsgTxt("Y0 must be of class double");
+        }
+    }
         
     /* Get the sizes of the input image */
     if(mxGetNumberOfDimensions(prhs[0])==2) {
@@ -300,6 +417,17 @@ void mexFunction( int nlhs, mxArray *plhs[],
     }
     dims_sp[0]=dims_sp_c [0]; dims_sp[1]=dims_sp_c[1];
     
+    if(incremental) {
+        if(mxGetNumberOfElements(prhs[4])!=npixels) {
+            mexErrMsgTxt("T0 must have the size of the speed image");
+        }
+        if((nrhs>5)&&(mxGetNumberOfElements(prhs[5])!=npixels)) {
+            mexErrMsgTxt("Y0 must have the size of the speed image");
+        }
+        T0=(double*)mxGetPr(prhs[4]);
+        if(nrhs>5) { Y0=(double*)mxGetPr(prhs[5]); }
+    }
+    
     
     /* Get pointers/data from  to each input. */
     F=(double*)mxGetPr(prhs[0]);
@@ -326,15 +454,23 @@ void mexFunction( int nlhs, mxArray *plhs[],
     for(q=0;q<npixels;q++){Y[q]=-1;}
     }
     
+    /* Incremental mode, the pixels with a previous distance are kept */
+    if(incremental) {
+        Old = (unsigned char*)malloc( npixels* sizeof(unsigned char) );
+        for(q=0;q<npixels;q++) {
+            Old[q]=IsFinite(T0[q])&&(T0[q]>=0);
+            if(Old[q]) {
+                T[q]=T0[q];
+                if(Ed) { Y[q]=Y0[q]; }
+            }
+        }
+    }
+    
     /*Free memory to store neighbours of the (segmented) region */
     neg_free = 100000;
     neg_pos=0;
     neg_listx = (double *)malloc( neg_free*sizeof(double) );
     neg_listy = (double *)malloc( neg_free*sizeof(double) );
-    if(Ed) {
-        neg_listo = (double *)malloc( neg_free*sizeof(double) );
-        for(q=0;q<neg_free;q++) { neg_listo[q]=0; }
-    }
     
     /* List parameters array */
     listprop=(int*)malloc(3* sizeof(int));
@@ -362,6 +498,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
         Frozen[XY_index]=1;
         T[XY_index]=0;
         if(Ed) { Y[XY_index]=0; }
+        if(incremental) { Old[XY_index]=0; }
     }
     
     for (z=0; z<dims_sp[1]; z++) {
@@ -369,6 +506,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
         x= (int)SourcePoints[0+z*2]-1;
         y= (int)SourcePoints[1+z*2]-1;
         XY_index=x+y*dims[0];
+        if(incremental) {
+            push_old2d(x, y, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+            neg_listv=listval[listprop[1]-1];
+        }
         
         /* Add neigbours of starting points  */
         for (k=0; k<4; k++) {
@@ -381,15 +522,25 @@ void mexFunction( int nlhs, mxArray *plhs[],
             if(isntfrozen2d(i, j, dims, Frozen)) {
                 Tt=(1/(max(F[IJ_index],eps)));
 					
-                Ty=1;
+                /* Incremental mode, a kept pixel is only opened again if */
+                /* it becomes closer */
+                if(incremental&&(Old[IJ_index]==1)) {
+                    if(!(Tt<T[IJ_index])) {
+                        push_old2d(i, j, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                        neg_listv=listval[listprop[1]-1];
+                        continue;
+                    }
+                    Old[IJ_index]=0; T[IJ_index]=-1;
+                }
                 /*Update distance in neigbour list or add to neigbour list */
-                if(T[IJ_index]>0) {
+                if((T[IJ_index]>0)||(incremental&&(T[IJ_index]>-1))) {
                     if(neg_listv[(int)T[IJ_index]]>Tt) {
                         listupdate(listval, listprop, (int)T[IJ_index], Tt);
-                    }
-                    if(Ed)
-                    {
-                        neg_listo[(int)T[IJ_index]]=min(neg_listo[(int)T[IJ_index]],Ty);
+                        if(incremental&&(Old[IJ_index]==2)) {
+                            Old[IJ_index]=0;
+                            push_old2d(i, j, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                            neg_listv=listval[listprop[1]-1];
+                        }
                     }
                 }
                 else {
@@ -398,19 +549,17 @@ void mexFunction( int nlhs, mxArray *plhs[],
                         neg_free+=100000;
                         neg_listx = (double *)realloc(neg_listx, neg_free*sizeof(double) );
                         neg_listy = (double *)realloc(neg_listy, neg_free*sizeof(double) );
-                        if(Ed) {
-                            neg_listo = (double *)realloc(neg_listo, neg_free*sizeof(double) );
-                        }
                     }
                     list_add(listval, listprop, Tt);
                     neg_listv=listval[listprop[1]-1];
                     neg_listx[neg_pos]=i;
                     neg_listy[neg_pos]=j;
-                    if(Ed){
-                        neg_listo[neg_pos]=Ty;
-                    }
                     T[IJ_index]=neg_pos;
                     neg_pos++;
+                    if(incremental) {
+                        push_old2d(i, j, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                        neg_listv=listval[listprop[1]-1];
+                    }
                 }
             }
         }
@@ -429,7 +578,9 @@ void mexFunction( int nlhs, mxArray *plhs[],
         XY_index=x+y*dims[0];
         Frozen[XY_index]=1;
         T[XY_index]=neg_listv[index];
-        if(Ed) { Y[XY_index]=neg_listo[index]; }
+        /* A kept pixel which did not become closer changes no neighbour */
+        if(incremental) { changed=(Old[XY_index]!=2); }
+        if(Ed) { Y[XY_index]=CalculateY(T, Y, dims, x, y, usesecond, usecross, Frozen, incremental ? Old : NULL); }
       
      
         /*Remove min value by replacing it with the last value in the array  */
@@ -438,9 +589,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
         if(index<(neg_pos-1)) {
             neg_listx[index]=neg_listx[neg_pos-1];
             neg_listy[index]=neg_listy[neg_pos-1];
-            if(Ed){
-                neg_listo[index]=neg_listo[neg_pos-1];
-            }
             T[(int)(neg_listx[index]+neg_listy[index]*dims[0])]=index;
         }
         neg_pos =neg_pos-1;
@@ -453,25 +601,44 @@ void mexFunction( int nlhs, mxArray *plhs[],
             i=x+ne[k]; j=y+ne[k+4];
             IJ_index=i+j*dims[0];
 
+            /* Incremental mode, the kept pixels with a distance below */
+            /* the current distance are frozen */
+            if(incremental&&isntfrozen2d(i, j, dims, Frozen)) {
+                freeze_old2d(i, j, dims, Old, Frozen, T, T[XY_index], usesecond);
+            }
+            
             /*Check if current neighbour is not yet frozen and inside the  */
             /*picture  */
             if(isntfrozen2d(i, j, dims, Frozen)) {
 				
                 Tt=CalculateDistance(T, F[IJ_index], dims, i, j, usesecond, usecross, Frozen);
-				        
-				if(Ed) {
-                    Ty=CalculateDistance(Y, 1, dims, i, j, usesecond, usecross, Frozen);
-                }
 
                 /*Update distance in neigbour list or add to neigbour list */
                 IJ_index=i+j*dims[0];
+                /* Incremental mode, a kept pixel is only opened again if */
+                /* it becomes closer */
+                if(incremental&&(Old[IJ_index]==1)) {
+                    if(!(Tt<T[IJ_index])) {
+                        /* As in a full run, the other stencil pixels of the */
+                        /* kept pixel must update it again after this change */
+                        if(changed) {
+                            push_old2d(i, j, dims, Old, Frozen, T, T[XY_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                            neg_listv=listval[listprop[1]-1];
+                        }
+                        continue;
+                    }
+                    Old[IJ_index]=0; T[IJ_index]=-1;
+                }
                 if((T[IJ_index]>-1)&&T[IJ_index]<=listprop[0]) {
                     if(neg_listv[(int)T[IJ_index]]>Tt) {
                         listupdate(listval, listprop,    (int)T[IJ_index], Tt);
-                    }
-                    if(Ed)
-                    {
-                        neg_listo[neg_pos]=min(neg_listo[neg_pos],Ty);
+                        /* A kept pixel in the narrow band which becomes */
+                        /* closer is opened */
+                        if(incremental&&(Old[IJ_index]==2)) {
+                            Old[IJ_index]=0;
+                            push_old2d(i, j, dims, Old, Frozen, T, T[XY_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                            neg_listv=listval[listprop[1]-1];
+                        }
                     }
                 }
                 else {
@@ -480,18 +647,16 @@ void mexFunction( int nlhs, mxArray *plhs[],
                         neg_free+=100000;
                         neg_listx = (double *)realloc(neg_listx, neg_free*sizeof(double) );
                         neg_listy = (double *)realloc(neg_listy, neg_free*sizeof(double) );
-                        if(Ed) {
-                            neg_listo = (double *)realloc(neg_listo, neg_free*sizeof(double) );
-                        }
                     }
                     list_add(listval, listprop, Tt);
                     neg_listv=listval[listprop[1]-1];
                     neg_listx[neg_pos]=i; neg_listy[neg_pos]=j;
-                    if(Ed) {
-                        neg_listo[neg_pos]=Ty;
-                    }
                     T[IJ_index]=neg_pos;
                     neg_pos++;
+                    if(incremental) {
+                        push_old2d(i, j, dims, Old, Frozen, T, T[XY_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy);
+                        neg_listv=listval[listprop[1]-1];
+                    }
                 }
             }
         }
@@ -502,8 +667,8 @@ void mexFunction( int nlhs, mxArray *plhs[],
     destroy_list(listval, listprop);
     free(neg_listx);
     free(neg_listy);
-    if(Ed) {
-        free(neg_listo);
+    if(incremental) {
+        free(Old);
     }
     free(Frozen);
 }
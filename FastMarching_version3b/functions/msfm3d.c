@@ -20,7 +20,21 @@
 /*               are used (default) */
 /*outputs, */
 /*  T : Image with distance from SourcePoints to all pixels */
-
+/* */
+/*[T,Y]=msfm3d(F, SourcePoints, UseSecond, UseCross, T0, Y0) */
+/* */
+/*Incremental mode, adds SourcePoints to the sources of a previous result */
+/*T0 (and Y0), as used by skeleton.m for every new branch. The pixels of */
+/*T0 are kept, and only pixels whose distance becomes smaller are opened */
+/*again, thus the cost is that of the region which is closer to the new */
+/*SourcePoints instead of the whole image. A kept pixel is frozen (used by */
+/*the stencils) when the narrow band passes its distance, as in a full run. */
+/* */
+/*The Y of a pixel is computed when it is frozen, from the pixels of its */
+/*stencils which were frozen before its first frozen neighbour, so it only */
+/*depends on the final T. It is the Y the pixel gets when it enters the */
+/*narrow band of a full run, and the incremental mode gives the Y of a */
+/*full run with all sources. */
 /* */
 /*Function is written by D.Kroon University of Twente (June 2009) */
 
@@ -292,6 +306,97 @@ double CalculateDistance(double *T, double Fijk, int *dims, int i, int j, int k,
     return Tt;
 }
 
+/* Y of the frozen pixel i,j,k, from the stencil pixels with a distance up */
+/* to the one of its first frozen neighbour (kept pixels of the incremental */
+/* mode included), these are the pixels which were frozen when it entered */
+/* the narrow band */
+double CalculateY(double *T, double *Y, int *dims, int i, int j, int k, bool usesecond, bool usecross, bool *Frozen, unsigned char *Old) {
+    int ne[18]={-1,  0,  0, 1, 0, 0, 0, -1,  0, 0, 1, 0, 0,  0, -1, 0, 0, 1};
+    int flipped[125];
+    int in, jn, kn, s, t, u, w, nflipped=0, index;
+    double Tq=INF, Ty;
+    bool final;
+    
+    /* Distance of the first frozen neighbour */
+    for (w=0; w<6; w++) {
+        in=i+ne[w]; jn=j+ne[w+6]; kn=k+ne[w+12];
+        if((in<0)||(jn<0)||(kn<0)||(in>=dims[0])||(jn>=dims[1])||(kn>=dims[2])) { continue; }
+        index=mindex3(in, jn, kn, dims[0], dims[1]);
+        final=Frozen[index]||((Old!=NULL)&&(Old[index]==1));
+        if(final&&(T[index]<Tq)) { Tq=T[index]; }
+    }
+    
+    /* Neighbour of a source point */
+    if(Tq<=0) { return 0; }
+    
+    /* Only freeze the stencil pixels up to distance Tq */
+    for (u=-2; u<=2; u++) {
+        for (t=-2; t<=2; t++) {
+            for (s=-2; s<=2; s++) {
+                in=i+s; jn=j+t; kn=k+u;
+                if(((s==0)&&(t==0)&&(u==0))||(in<0)||(jn<0)||(kn<0)||(in>=dims[0])||(jn>=dims[1])||(kn>=dims[2])) { continue; }
+                index=mindex3(in, jn, kn, dims[0], dims[1]);
+                final=Frozen[index]||((Old!=NULL)&&(Old[index]==1));
+                final=final&&(T[index]<=Tq);
+                if(Frozen[index]!=final) { Frozen[index]=final; flipped[nflipped++]=index; }
+            }
+        }
+    }
+    Ty=CalculateDistance(Y, 1, dims, i, j, k, usesecond, usecross, Frozen);
+    for (w=0; w<nflipped; w++) { Frozen[flipped[w]]=!Frozen[flipped[w]]; }
+    return Ty;
+}
+
+/* Incremental mode : freeze the kept pixels within reach of the stencils */
+/* of pixel i,j,k, which have a distance below the current distance Tc */
+void freeze_old3d(int i, int j, int k, int *dims, unsigned char *Old, bool *Frozen, double *T, double Tc, bool usesecond) {
+    int in, jn, kn, s, t, u, r, IJK_index;
+    for (r=1; r<=(usesecond?2:1); r++) {
+        for (u=-1; u<=1; u++) {
+            for (t=-1; t<=1; t++) {
+                for (s=-1; s<=1; s++) {
+                    in=i+s*r; jn=j+t*r; kn=k+u*r;
+                    if((in<0)||(jn<0)||(kn<0)||(in>=dims[0])||(jn>=dims[1])||(kn>=dims[2])) { continue; }
+                    IJK_index=mindex3(in, jn, kn, dims[0], dims[1]);
+                    if((Old[IJK_index]==1)&&(T[IJK_index]<=Tc)) { Old[IJK_index]=0; Frozen[IJK_index]=1; }
+                }
+            }
+        }
+    }
+}
+
+/* Incremental mode : the kept pixels within reach of the stencils of */
+/* the opened pixel i,j,k are added to the narrow band with their kept */
+/* distance, thus they update the opened pixels when they are frozen */
+void push_old3d(int i, int j, int k, int *dims, unsigned char *Old, bool *Frozen, double *T, double Tc, bool usesecond, double **listval, int *listprop, int *neg_pos, int *neg_free, double **neg_listx, double **neg_listy, double **neg_listz) {
+    int in, jn, kn, s, t, u, r, IJK_index;
+    for (r=1; r<=(usesecond?2:1); r++) {
+        for (u=-1; u<=1; u++) {
+            for (t=-1; t<=1; t++) {
+                for (s=-1; s<=1; s++) {
+                    in=i+s*r; jn=j+t*r; kn=k+u*r;
+                    if((in<0)||(jn<0)||(kn<0)||(in>=dims[0])||(jn>=dims[1])||(kn>=dims[2])) { continue; }
+                    IJK_index=mindex3(in, jn, kn, dims[0], dims[1]);
+                    if(Old[IJK_index]!=1) { continue; }
+                    if(T[IJK_index]<=Tc) { Old[IJK_index]=0; Frozen[IJK_index]=1; continue; }
+                    Old[IJK_index]=2;
+                    /*If running out of memory at a new block */
+                    if((*neg_pos)>=(*neg_free)) {
+                        (*neg_free)+=100000;
+                        (*neg_listx) = (double *)realloc((*neg_listx), (*neg_free)*sizeof(double) );
+                        (*neg_listy) = (double *)realloc((*neg_listy), (*neg_free)*sizeof(double) );
+                        (*neg_listz) = (double *)realloc((*neg_listz), (*neg_free)*sizeof(double) );
+                    }
+                    list_add(listval, listprop, T[IJK_index]);
+                    (*neg_listx)[*neg_pos]=in; (*neg_listy)[*neg_pos]=jn; (*neg_listz)[*neg_pos]=kn;
+                    T[IJK_index]=(*neg_pos);
+                    (*neg_pos)++;
+                }
+            }
+        }
+    }
+}
+
 /* The matlab mex function */
 void mexFunction( int nlhs, mxArray *plhs[],
         int nrhs, const mxArray *prhs[] ) {
@@ -308,7 +413,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
     double *Y;
     
     /* Current distance values */
-    double Tt, Ty;
+    double Tt;
     
     /* Matrix containing the Frozen Pixels" */
     bool *Frozen;
@@ -316,6 +421,13 @@ void mexFunction( int nlhs, mxArray *plhs[],
     /* Augmented Fast Marching (For skeletonize) */
     bool Ed;
     
+    /* Incremental mode, previous distances and the state of the pixels, */
+    /* 1 : kept previous distance, 2 : kept distance in the narrow band */
+    bool changed=true;
+    bool incremental=false;
+    double *T0, *Y0;
+    unsigned char *Old;
+    
     /* Size of input image */
     const mwSize *dims_c;
     mwSize dims[3];
@@ -334,7 +446,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
     double *neg_listx;
     double *neg_listy;
     double *neg_listz;
-    double *neg_listo;
     
     int *listprop;
     double **listval;
@@ -353,7 +464,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
     
     /* Check for proper number of input and output arguments. */
     if(nrhs<3) {
-        mexErrMsgTxt("2 to 4 inputs are required.");
+        mexErrMsgTxt("2 to 6 inputs are required.");
     }
     if(nlhs==1) { Ed=0; }
     else if (nlhs==2) { Ed=1; }
@@ -377,6 +488,19 @@ void mexFunction( int nlhs, mxArray *plhs[],
         mexErrMsgTxt("UseCross must be of class boolean / logical");
     }
     
+    if(nrhs>4) {
+        incremental=true;
+        if(mxGetClassID(prhs[4])!=mxDOUBLE_CLASS) {
+            mexErrMsgTxt("T0 must be of class double");
+        }
+        if(Ed&&(nrhs<6)) {
+            mexErrMsgTxt("Y0 is required for the Y output in incremental mode");
+        }
+        if((nrhs>5)&&(mxGetClassID(prhs[5])!=mxDOUBLE_CLASS)) {
+            mexErrMsgTxt("Y0 must be of class double");
+        }
+    }
+    
     /* Get the sizes of the input image volume */
     if(mxGetNumberOfDimensions(prhs[0])==3) {
         dims_c= mxGetDimensions(prhs[0]);
@@ -395,6 +519,17 @@ void mexFunction( int nlhs, mxArray *plhs[],
     }
     dims_sp[0]=dims_sp_c[0]; dims_sp[1]=dims_sp_c[1]; dims_sp[2]=dims_sp_c[2];
     
+    if(incremental) {
+        if(mxGetNumberOfElements(prhs[4])!=npixels) {
+            mexErrMsgTxt("T0 must have the size of the speed image");
+        }
+        if((nrhs>5)&&(mxGetNumberOfElements(prhs[5])!=npixels)) {
+            mexErrMsgTxt("Y0 must have the size of the speed image");
+        }
+        T0=(double*)mxGetPr(prhs[4]);
+        if(nrhs>5) { Y0=(double*)mxGetPr(prhs[5]); }
+    }
+    
     /* Get pointers/data from  to each input. */
     F=(double*)mxGetPr(prhs[0]);
     SourcePoints=(double*)mxGetPr(prhs[1]);
@@ -419,6 +554,18 @@ void mexFunction( int nlhs, mxArray *plhs[],
         for(q=0;q<npixels;q++){Y[q]=-1;}
     }
     
+    /* Incremental mode, the pixels with a previous distance are kept */
+    if(incremental) {
+        Old = (unsigned char*)malloc( npixels* sizeof(unsigned char) );
+        for(q=0;q<npixels;q++) {
+            Old[q]=IsFinite(T0[q])&&(T0[q]>=0);
+            if(Old[q]) {
+                T[q]=T0[q];
+                if(Ed) { Y[q]=Y0[q]; }
+            }
+        }
+    }
+    
     
     /*Free memory to store neighbours of the (segmented) region */
     neg_free = 100000;
@@ -427,10 +574,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
     neg_listx = (double *)malloc( neg_free*sizeof(double) );
     neg_listy = (double *)malloc( neg_free*sizeof(double) );
     neg_listz = (double *)malloc( neg_free*sizeof(double) );
-    if(Ed) {
-        neg_listo = (double *)malloc( neg_free*sizeof(double) );
-        for(q=0;q<neg_free;q++) { neg_listo[q]=0; }
-    }
     
     /* List parameters array */
     listprop=(int*)malloc(3* sizeof(int));
@@ -459,6 +602,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
         Frozen[XYZ_index]=1;
         T[XYZ_index]=0;
         if(Ed) { Y[XYZ_index]=0; }
+        if(incremental) { Old[XYZ_index]=0; }
     }
     
     for (s=0; s<dims_sp[1]; s++) {
@@ -470,6 +614,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
         
         
         XYZ_index=mindex3(x, y, z, dims[0], dims[1]);
+        if(incremental) {
+            push_old3d(x, y, z, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+            neg_listv=listval[listprop[1]-1];
+        }
         for (w=0; w<6; w++) {
             /*Location of neighbour */
             i=x+ne[w];
@@ -483,10 +631,25 @@ void mexFunction( int nlhs, mxArray *plhs[],
             /*picture */
             if(isntfrozen3d(i, j, k, dims, Frozen)) {
                 Tt=(1/(max(F[IJK_index],eps)));
+                /* Incremental mode, a kept pixel is only opened again if */
+                /* it becomes closer */
+                if(incremental&&(Old[IJK_index]==1)) {
+                    if(!(Tt<T[IJK_index])) {
+                        push_old3d(i, j, k, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                        neg_listv=listval[listprop[1]-1];
+                        continue;
+                    }
+                    Old[IJK_index]=0; T[IJK_index]=-1;
+                }
                 /*Update distance in neigbour list or add to neigbour list */
-                if(T[IJK_index]>0) {
+                if((T[IJK_index]>0)||(incremental&&(T[IJK_index]>-1))) {
                     if(neg_listv[(int)T[IJK_index]]>Tt) {
                         listupdate(listval, listprop, (int)T[IJK_index], Tt);
+                        if(incremental&&(Old[IJK_index]==2)) {
+                            Old[IJK_index]=0;
+                            push_old3d(i, j, k, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                            neg_listv=listval[listprop[1]-1];
+                        }
                     }
                 }
                 else {
@@ -496,9 +659,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
                         neg_listx = (double *)realloc(neg_listx, neg_free*sizeof(double) );
                         neg_listy = (double *)realloc(neg_listy, neg_free*sizeof(double) );
                         neg_listz = (double *)realloc(neg_listz, neg_free*sizeof(double) );
-                        if(Ed) {
-                            neg_listo = (double *)realloc(neg_listo, neg_free*sizeof(double) );
-                        }
                     }
                     list_add(listval, listprop, Tt);
                     neg_listv=listval[listprop[1]-1];
@@ -507,6 +667,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
                     neg_listz[neg_pos]=k;
                     T[IJK_index]=neg_pos;
                     neg_pos++;
+                    if(incremental) {
+                        push_old3d(i, j, k, dims, Old, Frozen, T, 0, usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                        neg_listv=listval[listprop[1]-1];
+                    }
                 }
             }
         }
@@ -526,7 +690,9 @@ void mexFunction( int nlhs, mxArray *plhs[],
         XYZ_index=mindex3(x, y, z, dims[0], dims[1]);
         Frozen[XYZ_index]=1;
         T[XYZ_index]=neg_listv[index];
-        if(Ed) { Y[XYZ_index]=neg_listo[index]; }
+        /* A kept pixel which did not become closer changes no neighbour */
+        if(incremental) { changed=(Old[XYZ_index]!=2); }
+        if(Ed) { Y[XYZ_index]=CalculateY(T, Y, dims, x, y, z, usesecond, usecross, Frozen, incremental ? Old : NULL); }
         
         /*Remove min value by replacing it with the last value in the array */
         list_remove_replace(listval, listprop, index) ;
@@ -535,9 +701,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
             neg_listx[index]=neg_listx[neg_pos-1];
             neg_listy[index]=neg_listy[neg_pos-1];
             neg_listz[index]=neg_listz[neg_pos-1];
-            if(Ed){
-                neg_listo[index]=neg_listo[neg_pos-1];
-            }
             T[(int)mindex3((int)neg_listx[index], (int)neg_listy[index], (int)neg_listz[index], dims[0], dims[1])]=index;
         }
         neg_pos =neg_pos-1;
@@ -548,19 +711,43 @@ void mexFunction( int nlhs, mxArray *plhs[],
             i=x+ne[w]; j=y+ne[w+6]; k=z+ne[w+12];
             IJK_index=mindex3(i, j, k, dims[0], dims[1]);
             
+            /* Incremental mode, the kept pixels with a distance below */
+            /* the current distance are frozen */
+            if(incremental&&isntfrozen3d(i, j, k, dims, Frozen)) {
+                freeze_old3d(i, j, k, dims, Old, Frozen, T, T[XYZ_index], usesecond);
+            }
+            
             /*Check if current neighbour is not yet frozen and inside the */
             /*picture */
             if(isntfrozen3d(i, j, k, dims, Frozen)) {
                 Tt=CalculateDistance(T, F[IJK_index], dims, i, j, k, usesecond, usecross, Frozen);
-                if(Ed) {
-                    Ty=CalculateDistance(Y, 1, dims, i, j, k, usesecond, usecross, Frozen);
-                }
                 
                 /*Update distance in neigbour list or add to neigbour list */
                 IJK_index=mindex3(i, j, k, dims[0], dims[1]);
+                /* Incremental mode, a kept pixel is only opened again if */
+                /* it becomes closer */
+                if(incremental&&(Old[IJK_index]==1)) {
+                    if(!(Tt<T[IJK_index])) {
+                        /* As in a full run, the other stencil pixels of the */
+                        /* kept pixel must update it again after this change */
+                        if(changed) {
+                            push_old3d(i, j, k, dims, Old, Frozen, T, T[XYZ_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                            neg_listv=listval[listprop[1]-1];
+                        }
+                        continue;
+                    }
+                    Old[IJK_index]=0; T[IJK_index]=-1;
+                }
                 if((T[IJK_index]>-1)&&T[IJK_index]<=listprop[0]) {
                     if(neg_listv[(int)T[IJK_index]]>Tt) {
                         listupdate(listval, listprop, (int)T[IJK_index], Tt);
+                        /* A kept pixel in the narrow band which becomes */
+                        /* closer is opened */
+                        if(incremental&&(Old[IJK_index]==2)) {
+                            Old[IJK_index]=0;
+                            push_old3d(i, j, k, dims, Old, Frozen, T, T[XYZ_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                            neg_listv=listval[listprop[1]-1];
+                        }
                     }
                 }
                 else {
@@ -570,19 +757,17 @@ void mexFunction( int nlhs, mxArray *plhs[],
                         neg_listx = (double *)realloc(neg_listx, neg_free*sizeof(double) );
                         neg_listy = (double *)realloc(neg_listy, neg_free*sizeof(double) );
                         neg_listz = (double *)realloc(neg_listz, neg_free*sizeof(double) );
-                        if(Ed) {
-                            neg_listo = (double *)realloc(neg_listo, neg_free*sizeof(double) );
-                        }
                     }
                     list_add(listval, listprop, Tt);
                     neg_listv=listval[listprop[1]-1];
                     neg_listx[neg_pos]=i; neg_listy[neg_pos]=j; neg_listz[neg_pos]=k;
-                    if(Ed) {
-                        neg_listo[neg_pos]=Ty;
-                    }
                     
                     T[IJK_index]=neg_pos;
                     neg_pos++;
+                    if(incremental) {
+                        push_old3d(i, j, k, dims, Old, Frozen, T, T[XYZ_index], usesecond, listval, listprop, &neg_pos, &neg_free, &neg_listx, &neg_listy, &neg_listz);
+                        neg_listv=listval[listprop[1]-1];
+                    }
                 }
             }
         }
@@ -594,6 +779,9 @@ void mexFunction( int nlhs, mxArray *plhs[],
     free(neg_listx);
     free(neg_listy);
     free(neg_listz);
+    if(incremental) {
+        free(Old);
+    }
     free(Frozen);
 }
 
@@ -14,6 +14,10 @@
 %                order derivatives are used (default)
 %   UseCross : Boolean Set to true if also cross neighbours 
 %                are used (default)
+%   T0, Y0 : (optional) T and Y of a previous run, the SourcePoints are
+%                added to its sources, and only the region which becomes
+%                closer to them is marched again. Without UseSecond and
+%                UseCross, T and Y are those of a full run with all sources.
 % outputs,
 %   T : Image with distance from SourcePoints to all pixels
 %
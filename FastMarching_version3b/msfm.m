@@ -1,10 +1,11 @@
-function [T,Y]=msfm(F, SourcePoints, UseSecond, UseCross)
+function [T,Y]=msfm(F, SourcePoints, UseSecond, UseCross, T0, Y0)
 % This function MSFM calculates the shortest distance from a list of
 % points to all other pixels in an image volume, using the  
 % Multistencil Fast Marching Method (MSFM). This method gives more accurate 
 % distances by using second order derivatives and cross neighbours.
 % 
 %   [T,Y]=msfm(F, SourcePoints, UseSecond, UseCross)
+%   [T,Y]=msfm(F, SourcePoints, UseSecond, UseCross, T0, Y0)
 %
 % inputs,
 %   F: The 2D or 3D speed image. The speed function must always be larger
@@ -15,6 +16,12 @@ function [T,Y]=msfm(F, SourcePoints, UseSecond, UseCross)
 %                order derivatives are used (default)
 %   UseCross : Boolean Set to true if also cross neighbours 
 %                are used (default)
+%   T0, Y0 : (optional) T and Y of a previous run, the SourcePoints are
+%                added to its sources, and only the region which becomes
+%                closer to them is marched again (compiled c-code only).
+%                Without UseSecond and UseCross, T and Y are those of a
+%                full run with all sources, the other schemes are not
+%                monotone and give small differences.
 % outputs,
 %   T : Image with distance from SourcePoints to all pixels
 %   Y : Image for augmented fastmarching with, euclidian distance from 
@@ -94,17 +101,22 @@ add_function_paths();
 if(nargin<3), UseSecond=false; end
 if(nargin<4), UseCross=false; end
 
+% Previous result for the incremental mode
+Previous={};
+if(nargin>4), Previous={T0}; end
+if(nargin>5), Previous={T0,Y0}; end
+
 if(nargout>1)
     if(size(F,3)>1)
-        [T,Y]=msfm3d(F, SourcePoints, UseSecond, UseCross);        
+        [T,Y]=msfm3d(F, SourcePoints, UseSecond, UseCross, Previous{:});        
     else
-        [T,Y]=msfm2d(F, SourcePoints, UseSecond, UseCross);
+        [T,Y]=msfm2d(F, SourcePoints, UseSecond, UseCross, Previous{:});
     end
 else
     if(size(F,3)>1)
-        T=msfm3d(F, SourcePoints, UseSecond, UseCross);
+        T=msfm3d(F, SourcePoints, UseSecond, UseCross, Previous{:});
     else
-        T=msfm2d(F, SourcePoints, UseSecond, UseCross);
+        T=msfm2d(F, SourcePoints, UseSecond, UseCross, Previous{:});
     end
 end
 
@@ -6,14 +6,18 @@ function ShortestLine=shortestpath(DistanceMap,StartPoint,SourcePoint,Stepsize,M
 % 
 % inputs,
 %   DistanceMap : A 2D or 3D distance map (from the functions msfm2d or msfm3d)
-%   StartPoint : Start point of the shortest path
+%   StartPoint : Start point of the shortest path, or a list of start points
+%           [2 x N] or [3 x N] which are traced in parallel
 %   SourcePoint : (Optional), End point of the shortest path
 %   Stepsize: (Optional), Line trace step size 
 %   Method: (Optional), 'rk4' (default), 'euler' ,'simple'
 % output,
-%   ShortestLine: M x 2 or M x 3 array with the Shortest Path
+%   ShortestLine: M x 2 or M x 3 array with the Shortest Path, a cell array
+%           with a Shortest Path per start point for N>1
 %
-% Note, first compile the rk4 c-code with compile_c_files
+% Note, first compile the rk4 and tracepath c-code with compile_c_files,
+% without the compiled tracepath the path is traced step by step in Matlab
+% (the 'euler' and 'simple' methods then need no compiled code at all)
 %   
 % Example,
 %   % Load a maze image
@@ -38,9 +42,12 @@ function ShortestLine=shortestpath(DistanceMap,StartPoint,SourcePoint,Stepsize,M
 if(~exist('Stepsize','var')), Stepsize=0.5; end
 if(~exist('SourcePoint','var')), SourcePoint=[]; end
 if(~exist('Method','var')), Method='rk4'; end
+if(isvector(StartPoint)), StartPoint=StartPoint(:); end
 
 % Calculate gradient of DistanceMap
-if(ndims(DistanceMap)==2) % Select 2D or 3D
+if(strcmpi(Method,'simple'))
+    % The simple method only uses the DistanceMap
+elseif(ndims(DistanceMap)==2) % Select 2D or 3D
     [Fy,Fx] = pointmin(DistanceMap);
     GradientVolume(:,:,1)=-Fx;
     GradientVolume(:,:,2)=-Fy;
@@ -51,31 +58,55 @@ else
     GradientVolume(:,:,:,3)=-Fz;
 end
 
+% Trace the shortest lines in one call, the stopping rules are those of
+% the step by step loop with rk4, e1 and s1 (see tracepath.c)
+switch(lower(Method))
+    case {'rk4','euler'}
+        Field=GradientVolume;
+    case 'simple'
+        Field=DistanceMap;
+    otherwise
+        error('shortestpath:input','unknown method');
+end
+if(exist('tracepath','file')==3)
+    [ShortestLine,Finished]=tracepath(StartPoint, Field, SourcePoint, Stepsize, lower(Method));
+elseif(size(StartPoint,2)==1)
+    [ShortestLine,Finished]=tracepath_loop(StartPoint, Field, SourcePoint, Stepsize, lower(Method));
+else
+    ShortestLine=cell(1,size(StartPoint,2)); Finished=false(1,size(StartPoint,2));
+    for j=1:size(StartPoint,2)
+        [ShortestLine{j},Finished(j)]=tracepath_loop(StartPoint(:,j), Field, SourcePoint, Stepsize, lower(Method));
+    end
+end
+
+if(~all(Finished))
+    disp('The shortest path trace did not finish at the source point');
+end
+
+function [ShortestLine,Finished]=tracepath_loop(StartPoint, Field, SourcePoint, Stepsize, Method)
+% Step by step trace of one shortest line with the rk4, e1 or s1 functions,
+% used when tracepath is not compiled
 i=0;
 % Reserve a block of memory for the shortest line array
 ifree=10000;
-ShortestLine=zeros(ifree,ndims(DistanceMap));
+ShortestLine=zeros(ifree,size(StartPoint,1));
+DistancetoEnd=inf;
 
 % Iteratively trace the shortest line
 while(true)
     % Calculate the next point using runge kutta
-    switch(lower(Method))
+    switch(Method)
         case 'rk4'
-            EndPoint=rk4(StartPoint, GradientVolume, Stepsize);
+            EndPoint=rk4(StartPoint, Field, Stepsize);
         case 'euler'
-            EndPoint=e1(StartPoint, GradientVolume, Stepsize);
+            EndPoint=e1(StartPoint, Field, Stepsize);
         case 'simple'
-            EndPoint=s1(StartPoint,DistanceMap);
-        otherwise
-            error('shortestpath:input','unknown method');
+            EndPoint=s1(StartPoint, Field);
     end
 
     % Calculate the distance to the end point
     if(~isempty(SourcePoint))
         [DistancetoEnd,ind]=min(sqrt(sum((SourcePoint-repmat(EndPoint,1,size(SourcePoint,2))).^2,1)));
-    else
-        
-        DistancetoEnd=inf;
     end
     
     % Calculate the movement between current point and point 10 itterations back
@@ -104,12 +135,7 @@ while(true)
     % Current point is next Starting Point
     StartPoint=EndPoint;
 end
-
-if((DistancetoEnd>1)&&(~isempty(SourcePoint)))
-    disp('The shortest path trace did not finish at the source point');
-end
+Finished=isempty(SourcePoint)||(DistancetoEnd<=1);
 
 % Remove unused memory from array
 ShortestLine=ShortestLine(1:i,:);
-
-
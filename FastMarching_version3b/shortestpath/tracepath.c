@@ -0,0 +1,482 @@
+#include "mex.h"
+#include "math.h"
+#include "string.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* TRACEPATH traces whole shortest paths in a 2D or 3D distance map, it
+ * does the iteration of shortestpath.m in one call instead of one rk4 call
+ * per step.
+ *
+ * [Lines, Finished] = TRACEPATH(StartPoints, Field, SourcePoint, StepSize, Method, NumThreads);
+ *
+ * inputs :
+ *      StartPoints: Start points [2 x N] or [3 x N]
+ *      Field: The GradientVolume for 'rk4' and 'euler' (as in rk4.c), the
+ *              DistanceMap for 'simple'
+ *      SourcePoint: End points of the paths [2 x M] or [3 x M], or []
+ *      StepSize : The stepsize
+ *      Method: 'rk4' (default), 'euler' or 'simple'
+ *      NumThreads: Number of threads used for N>1, 0 for all cores (default)
+ *
+ * outputs :
+ *      Lines : The path (K x 2 or K x 3) for one start point, a cell array
+ *              with a path per start point for N>1
+ *      Finished : True for a path which ended within one pixel of a source
+ *              point (always true without source points)
+ *
+ * A path stops as in shortestpath.m : if it leaves the image, if it moved
+ * less than StepSize in the last 10 steps, or if it comes closer than
+ * StepSize to a source point, which is then added as last point. These
+ * rules miss some stalls, which made shortestpath.m loop forever, thus it
+ * also stops if the gradient vanishes, if the path returns exactly to one
+ * of its last CYCLE_STEPS points (a step only depends on its start point,
+ * so the path cycles), or after 2*N/StepSize points with N the number of
+ * pixels. A cycle is followed until the movement rule has seen all its
+ * points, so paths which shortestpath.m stops are the same.
+ *
+ * The source points are sorted in a grid of cells of at least StepSize, so
+ * the distance to the nearest source point only checks the neighbour cells
+ * instead of all source points (skeleton.m uses all found branch points as
+ * source points). The paths of a batch are traced in parallel.
+ */
+
+#define INF 2e50
+
+#define METHOD_RK4 0
+#define METHOD_EULER 1
+#define METHOD_SIMPLE 2
+
+/* Movement is checked against the point this many steps back */
+#define MOVEMENT_STEPS 10
+
+/* A path which returns to one of its last CYCLE_STEPS points is a cycle */
+#define CYCLE_STEPS 16
+
+/* Distance from point to stored point npoints-steps-1 */
+__inline double movement(double *point, double *line, int npoints, int steps, int dim) {
+    double m=0, t;
+    int i;
+    for(i=0; i<dim; i++) { t=point[i]-line[(npoints-steps-1)*dim+i]; m+=t*t; }
+    return sqrt(m);
+}
+
+__inline int mindex2(int x, int y, int sizx)  { return y*sizx+x;}
+__inline int mindex3(int x, int y, int z, int sizx, int sizy)  { return z*sizy*sizx+y*sizx+x;}
+
+__inline bool checkBounds( double *point, int *Isize, int dim) {
+    int i;
+    for(i=0; i<dim; i++) {
+        if(!((point[i]>=0)&&(point[i]<=(Isize[i]-1)))) { return false; }
+    }
+    return true;
+}
+
+/* Linear interpolation of the dim gradient components, as in rk4.c */
+void interpgrad(double *Ireturn, double *I, int *Isize, double *point, int dim) {
+    int xBas0, xBas1, yBas0, yBas1, zBas0, zBas1;
+    double perc[8];
+    double xCom, yCom, zCom;
+    int index[8];
+    int f, n, i, j;
+
+    xBas0=(int)floor(point[0]); yBas0=(int)floor(point[1]);
+    xCom=point[0]-xBas0; yCom=point[1]-yBas0;
+    xBas1=xBas0+1; yBas1=yBas0+1;
+
+    /* Stick to boundary */
+    if(xBas0<0) { xBas0=0; if(xBas1<0) { xBas1=0; }}
+    if(yBas0<0) { yBas0=0; if(yBas1<0) { yBas1=0; }}
+    if(xBas1>(Isize[0]-1)) { xBas1=Isize[0]-1; if(xBas0>(Isize[0]-1)) { xBas0=Isize[0]-1; }}
+    if(yBas1>(Isize[1]-1)) { yBas1=Isize[1]-1; if(yBas0>(Isize[1]-1)) { yBas0=Isize[1]-1; }}
+
+    if(dim==2) {
+        perc[0]=(1-xCom)*(1-yCom); perc[1]=(1-xCom)*yCom;
+        perc[2]=xCom*(1-yCom);     perc[3]=xCom*yCom;
+        index[0]=mindex2(xBas0, yBas0, Isize[0]);
+        index[1]=mindex2(xBas0, yBas1, Isize[0]);
+        index[2]=mindex2(xBas1, yBas0, Isize[0]);
+        index[3]=mindex2(xBas1, yBas1, Isize[0]);
+        f=Isize[0]*Isize[1]; n=4;
+    }
+    else {
+        zBas0=(int)floor(point[2]); zCom=point[2]-zBas0; zBas1=zBas0+1;
+        if(zBas0<0) { zBas0=0; if(zBas1<0) { zBas1=0; }}
+        if(zBas1>(Isize[2]-1)) { zBas1=Isize[2]-1; if(zBas0>(Isize[2]-1)) { zBas0=Isize[2]-1; }}
+        perc[0]=(1-xCom)*(1-yCom); perc[1]=perc[0]*zCom; perc[0]=perc[0]*(1-zCom);
+        perc[2]=(1-xCom)*yCom;     perc[3]=perc[2]*zCom; perc[2]=perc[2]*(1-zCom);
+        perc[4]=xCom*(1-yCom);     perc[5]=perc[4]*zCom; perc[4]=perc[4]*(1-zCom);
+        perc[6]=xCom*yCom;         perc[7]=perc[6]*zCom; perc[6]=perc[6]*(1-zCom);
+        index[0]=mindex3(xBas0, yBas0, zBas0, Isize[0], Isize[1]);
+        index[1]=mindex3(xBas0, yBas0, zBas1, Isize[0], Isize[1]);
+        index[2]=mindex3(xBas0, yBas1, zBas0, Isize[0], Isize[1]);
+        index[3]=mindex3(xBas0, yBas1, zBas1, Isize[0], Isize[1]);
+        index[4]=mindex3(xBas1, yBas0, zBas0, Isize[0], Isize[1]);
+        index[5]=mindex3(xBas1, yBas0, zBas1, Isize[0], Isize[1]);
+        index[6]=mindex3(xBas1, yBas1, zBas0, Isize[0], Isize[1]);
+        index[7]=mindex3(xBas1, yBas1, zBas1, Isize[0], Isize[1]);
+        f=Isize[0]*Isize[1]*Isize[2]; n=8;
+    }
+
+    for(j=0; j<dim; j++) {
+        Ireturn[j]=0;
+        for(i=0; i<n; i++) { Ireturn[j]+=I[index[i]+j*f]*perc[i]; }
+    }
+}
+
+/* Interpolated gradient scaled to length stepSize, false if it vanishes */
+__inline bool stepgrad(double *k, double *I, int *Isize, double *point, int dim, double stepSize, double epsnorm) {
+    double tempnorm=0;
+    int i;
+    interpgrad(k, I, Isize, point, dim);
+    for(i=0; i<dim; i++) { tempnorm+=k[i]*k[i]; }
+    tempnorm=sqrt(tempnorm)+epsnorm;
+    if(!(tempnorm>0)) { return false; }
+    for(i=0; i<dim; i++) { k[i]=k[i]*stepSize/tempnorm; }
+    return true;
+}
+
+/* One step of Runge-Kutta 4, the same as RK4STEP_2D/3D in rk4.c */
+bool RK4STEP(double *I, int *Isize, double *startPoint, double *nextPoint, double stepSize, int dim) {
+    double k1[3], k2[3], k3[3], k4[3];
+    double tempPoint[3];
+    int i;
+
+    if(!stepgrad(k1, I, Isize, startPoint, dim, stepSize, 0)) { return false; }
+    for(i=0; i<dim; i++) { tempPoint[i]=startPoint[i]-k1[i]*0.5; }
+    if(!checkBounds(tempPoint, Isize, dim)) { return false; }
+
+    if(!stepgrad(k2, I, Isize, tempPoint, dim, stepSize, 0)) { return false; }
+    for(i=0; i<dim; i++) { tempPoint[i]=startPoint[i]-k2[i]*0.5; }
+    if(!checkBounds(tempPoint, Isize, dim)) { return false; }
+
+    if(!stepgrad(k3, I, Isize, tempPoint, dim, stepSize, 0)) { return false; }
+    for(i=0; i<dim; i++) { tempPoint[i]=startPoint[i]-k3[i]; }
+    if(!checkBounds(tempPoint, Isize, dim)) { return false; }
+
+    if(!stepgrad(k4, I, Isize, tempPoint, dim, stepSize, 0)) { return false; }
+    for(i=0; i<dim; i++) { nextPoint[i]=startPoint[i]-(k1[i]+k2[i]*2.0+k3[i]*2.0+k4[i])/6.0; }
+
+    return checkBounds(nextPoint, Isize, dim);
+}
+
+/* One step of Euler, the same as e1.m */
+bool EULERSTEP(double *I, int *Isize, double *startPoint, double *nextPoint, double stepSize, int dim) {
+    double k[3];
+    int i;
+
+    if(!stepgrad(k, I, Isize, startPoint, dim, stepSize, 2.220446049250313e-16)) { return false; }
+    for(i=0; i<dim; i++) { nextPoint[i]=startPoint[i]-k[i]; }
+
+    return checkBounds(nextPoint, Isize, dim);
+}
+
+/* Move to the lowest pixel of the smallest neighbourhood (radius 1 to 3) */
+/* with a lower value than the current pixel, the same as s1.m */
+bool SIMPLESTEP(double *I, int *Isize, double *startPoint, double *nextPoint, int dim) {
+    int S[3]={0, 0, 0}, sm[3]={0, 0, 0}, sp[3]={0, 0, 0}, best[3]={0, 0, 0};
+    int stepsize, x, y, z, i, index;
+    double Istart, Imin;
+    bool check=false;
+
+    for(i=0; i<dim; i++) {
+        S[i]=(int)floor(startPoint[i]+0.5);
+        if(S[i]<0) { S[i]=0; }
+        if(S[i]>Isize[i]-1) { S[i]=Isize[i]-1; }
+    }
+    Istart=I[mindex3(S[0], S[1], S[2], Isize[0], Isize[1])];
+
+    for(stepsize=1; stepsize<=3; stepsize++) {
+        for(i=0; i<3; i++) {
+            sm[i]=S[i]-stepsize; if(sm[i]<0) { sm[i]=0; }
+            sp[i]=S[i]+stepsize; if(sp[i]>Isize[i]-1) { sp[i]=Isize[i]-1; }
+        }
+        if(dim==2) { sm[2]=0; sp[2]=0; }
+        Imin=Istart;
+        for(z=sm[2]; z<=sp[2]; z++) {
+            for(y=sm[1]; y<=sp[1]; y++) {
+                for(x=sm[0]; x<=sp[0]; x++) {
+                    index=mindex3(x, y, z, Isize[0], Isize[1]);
+                    if(I[index]<Imin) { Imin=I[index]; best[0]=x; best[1]=y; best[2]=z; check=true; }
+                }
+            }
+        }
+        if(check) { break; }
+    }
+
+    for(i=0; i<dim; i++) { nextPoint[i]=check ? best[i] : S[i]; }
+    return true;
+}
+
+/* Source points sorted in a grid of cells */
+typedef struct {
+    double *points;
+    int npoints;
+    int dim;
+    double cellsize;
+    int ncells[3];
+    int *cellstart;
+    int *cellpoints;
+} source_grid;
+
+__inline int cellcoord(double p, double cellsize, int n) {
+    int c=(int)floor(p/cellsize);
+    if(c<0) { c=0; }
+    if(c>n-1) { c=n-1; }
+    return c;
+}
+
+__inline int cellindex(source_grid *g, double *point) {
+    int c[3]={0, 0, 0}, i;
+    for(i=0; i<g->dim; i++) { c[i]=cellcoord(point[i], g->cellsize, g->ncells[i]); }
+    return mindex3(c[0], c[1], c[2], g->ncells[0], g->ncells[1]);
+}
+
+void source_grid_init(source_grid *g, double *points, int npoints, int dim, int *Isize, double cellsize) {
+    int i, c, ntotal=1;
+    int *count;
+    g->points=points; g->npoints=npoints; g->dim=dim; g->cellsize=cellsize;
+    g->ncells[2]=1;
+    for(i=0; i<dim; i++) { g->ncells[i]=(int)ceil(Isize[i]/cellsize)+1; ntotal*=g->ncells[i]; }
+    g->cellstart=(int*)mxCalloc(ntotal+1, sizeof(int));
+    g->cellpoints=(int*)mxMalloc((npoints+1)*sizeof(int));
+    count=(int*)mxCalloc(ntotal+1, sizeof(int));
+    for(i=0; i<npoints; i++) { g->cellstart[cellindex(g, &points[i*dim])+1]++; }
+    for(c=0; c<ntotal; c++) { g->cellstart[c+1]+=g->cellstart[c]; }
+    for(i=0; i<npoints; i++) {
+        c=cellindex(g, &points[i*dim]);
+        g->cellpoints[g->cellstart[c]+count[c]]=i; count[c]++;
+    }
+    mxFree(count);
+}
+
+/* Distance to the nearest source point within cellsize, INF if none, */
+/* nearest gets its index. Ties go to the first point as min in Matlab */
+double source_grid_nearest(source_grid *g, double *point, int *nearest) {
+    int c[3]={0, 0, 0}, lo[3]={0, 0, 0}, hi[3]={0, 0, 0};
+    int x, y, z, i, j, k, cell;
+    double d, dmin=INF, t;
+    *nearest=-1;
+    for(i=0; i<g->dim; i++) {
+        c[i]=cellcoord(point[i], g->cellsize, g->ncells[i]);
+        lo[i]=c[i]>0 ? c[i]-1 : 0;
+        hi[i]=c[i]<g->ncells[i]-1 ? c[i]+1 : g->ncells[i]-1;
+    }
+    for(z=lo[2]; z<=hi[2]; z++) {
+        for(y=lo[1]; y<=hi[1]; y++) {
+            for(x=lo[0]; x<=hi[0]; x++) {
+                cell=mindex3(x, y, z, g->ncells[0], g->ncells[1]);
+                for(k=g->cellstart[cell]; k<g->cellstart[cell+1]; k++) {
+                    j=g->cellpoints[k]; d=0;
+                    for(i=0; i<g->dim; i++) { t=point[i]-g->points[j*g->dim+i]; d+=t*t; }
+                    d=sqrt(d);
+                    if((d<dmin)||((d==dmin)&&(j<*nearest))) { dmin=d; *nearest=j; }
+                }
+            }
+        }
+    }
+    return dmin;
+}
+
+/* Trace one path from startPoint (0-based), the points are stored in */
+/* *line (realloc'ed, 0-based, dim values per point), returns the number */
+/* of points, or -1 if out of memory. Does not call the mex API so it can */
+/* run in a thread */
+int trace_path(double *I, int *Isize, int dim, source_grid *g, double *startPoint, double stepSize, int method, int maxpoints, double **line, int *capacity, bool *finished) {
+    double StartPoint[3], EndPoint[3];
+    double DistancetoEnd=INF;
+    int npoints=0, nearest=-1, cycleleft=-1, i, p;
+    bool inside;
+
+    for(i=0; i<dim; i++) { StartPoint[i]=startPoint[i]; }
+
+    while(true) {
+        /* Calculate the next point */
+        switch(method) {
+            case METHOD_RK4:
+                inside=RK4STEP(I, Isize, StartPoint, EndPoint, stepSize, dim); break;
+            case METHOD_EULER:
+                inside=EULERSTEP(I, Isize, StartPoint, EndPoint, stepSize, dim); break;
+            default:
+                inside=SIMPLESTEP(I, Isize, StartPoint, EndPoint, dim); break;
+        }
+
+        /* Calculate the distance to the end point */
+        if(g->npoints>0) {
+            DistancetoEnd=inside ? source_grid_nearest(g, EndPoint, &nearest) : INF;
+        }
+
+        /* Stop if out of boundary, or if we have not moved for 10 iterations */
+        if(!inside) { break; }
+        if(npoints>MOVEMENT_STEPS) {
+            if(movement(EndPoint, *line, npoints, MOVEMENT_STEPS, dim)<stepSize) { break; }
+        }
+        if(npoints>=maxpoints) { break; }
+
+        /* Stop a cycle when the movement rule can not stop it */
+        if(cycleleft<0) {
+            for(p=1; (p<=CYCLE_STEPS)&&(p<=npoints); p++) {
+                if(movement(EndPoint, *line, npoints+1, p, dim)==0) { cycleleft=p+MOVEMENT_STEPS+1; break; }
+            }
+        }
+        else if(cycleleft==0) { break; }
+        else { cycleleft--; }
+
+        /* Add the point to the line, with room for the source point */
+        if(npoints+2>*capacity) {
+            double *grown;
+            *capacity=*capacity*2+1000;
+            grown=(double*)realloc(*line, (*capacity)*dim*sizeof(double));
+            /* Keep the old block in *line, the caller frees it */
+            if(grown==NULL) { return -1; }
+            *line=grown;
+        }
+        for(i=0; i<dim; i++) { (*line)[npoints*dim+i]=EndPoint[i]; }
+        npoints++;
+
+        if(DistancetoEnd<stepSize) {
+            /* Add (Last) Source point to the line */
+            for(i=0; i<dim; i++) { (*line)[npoints*dim+i]=g->points[nearest*dim+i]; }
+            npoints++;
+            break;
+        }
+
+        /* Current point is next Starting Point */
+        for(i=0; i<dim; i++) { StartPoint[i]=EndPoint[i]; }
+    }
+
+    *finished=(g->npoints==0)||(DistancetoEnd<=1);
+    return npoints;
+}
+
+/* Copy a 0-based line to a Matlab K x dim array with 1-based points */
+mxArray *line_to_matlab(double *line, int npoints, int dim) {
+    mxArray *A;
+    double *Ap;
+    int i, j;
+    A=mxCreateDoubleMatrix(npoints, dim, mxREAL);
+    Ap=mxGetPr(A);
+    for(i=0; i<npoints; i++) {
+        for(j=0; j<dim; j++) { Ap[i+j*npoints]=line[i*dim+j]+1.0; }
+    }
+    return A;
+}
+
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] ) {
+    double *I, *startPoints, *sourcePoints=NULL, *sources0=NULL, *starts0;
+    const mwSize *dimsF;
+    int Isize[3]={1, 1, 1};
+    int dim, nstart, nsource=0, ndimsF, method=METHOD_RK4, nthreads=0, maxpoints;
+    int i, q;
+    double stepSize=0.5, cellsize;
+    char methodname[16];
+    double **lines;
+    int *npoints;
+    bool *finished;
+    source_grid g;
+
+    /* Check for proper number of input and output arguments. */
+    if(nrhs<3) { mexErrMsgTxt("3 to 6 inputs are required."); }
+    if(nrhs>6) { mexErrMsgTxt("3 to 6 inputs are required."); }
+    if(nlhs>2) { mexErrMsgTxt("1 or 2 outputs are required."); }
+
+    /* Check data input types */
+    if(mxGetClassID(prhs[0])!=mxDOUBLE_CLASS) { mexErrMsgTxt("inputs must be of class double"); }
+    if(mxGetClassID(prhs[1])!=mxDOUBLE_CLASS) { mexErrMsgTxt("inputs must be of class double"); }
+    if(!mxIsEmpty(prhs[2])&&(mxGetClassID(prhs[2])!=mxDOUBLE_CLASS)) { mexErrMsgTxt("inputs must be of class double"); }
+
+    /* Get the method */
+    if(nrhs>4) {
+        if(!mxIsChar(prhs[4])) { mexErrMsgTxt("Method must be a string"); }
+        mxGetString(prhs[4], methodname, 16);
+        for(i=0; methodname[i]; i++) { if((methodname[i]>='A')&&(methodname[i]<='Z')) { methodname[i]+='a'-'A'; } }
+        if(strcmp(methodname, "rk4")==0) { method=METHOD_RK4; }
+        else if(strcmp(methodname, "euler")==0) { method=METHOD_EULER; }
+        else if(strcmp(methodname, "simple")==0) { method=METHOD_SIMPLE; }
+        else { mexErrMsgTxt("unknown method"); }
+    }
+    if(nrhs>3) { stepSize=mxGetScalar(prhs[3]); }
+    if(nrhs>5) { nthreads=(int)mxGetScalar(prhs[5]); }
+#ifdef _OPENMP
+    if(nthreads<=0) { nthreads=omp_get_max_threads(); }
+#else
+    (void) nthreads;
+#endif
+    if(!(stepSize>0)) { mexErrMsgTxt("StepSize must be larger than zero"); }
+
+    /* Get the start points */
+    dim=(int)mxGetM(prhs[0]);
+    nstart=(int)mxGetN(prhs[0]);
+    if((dim!=2)&&(dim!=3)) { mexErrMsgTxt("Starting Point must be 2D or 3D"); }
+    startPoints=mxGetPr(prhs[0]);
+
+    /* Get the gradient volume or distance map */
+    ndimsF=mxGetNumberOfDimensions(prhs[1]);
+    dimsF=mxGetDimensions(prhs[1]);
+    for(i=0; i<dim; i++) { Isize[i]=(i<ndimsF) ? (int)dimsF[i] : 1; }
+    if(method==METHOD_SIMPLE) {
+        if(ndimsF>dim) { mexErrMsgTxt("DistanceMap must have the dimension of the points"); }
+    }
+    else {
+        if((ndimsF!=dim+1)||((int)dimsF[dim]!=dim)) { mexErrMsgTxt("GradientVolume must be [X Y 2] or [X Y Z 3]"); }
+    }
+    I=mxGetPr(prhs[1]);
+
+    /* Get the source points */
+    if(!mxIsEmpty(prhs[2])) {
+        if((int)mxGetM(prhs[2])!=dim) { mexErrMsgTxt("SourcePoint must have the dimension of the start points"); }
+        nsource=(int)mxGetN(prhs[2]);
+        sourcePoints=mxGetPr(prhs[2]);
+    }
+
+    /* Points to 0-based coordinates */
+    starts0=(double*)mxMalloc(nstart*dim*sizeof(double));
+    for(i=0; i<nstart*dim; i++) { starts0[i]=startPoints[i]-1.0; }
+    sources0=(double*)mxMalloc((nsource*dim+1)*sizeof(double));
+    for(i=0; i<nsource*dim; i++) { sources0[i]=sourcePoints[i]-1.0; }
+    cellsize=(stepSize>1) ? stepSize : 1;
+    maxpoints=(int)fmin(2.0*Isize[0]*Isize[1]*Isize[2]/stepSize+1000, 1e9);
+    source_grid_init(&g, sources0, nsource, dim, Isize, cellsize);
+
+    lines=(double**)mxCalloc(nstart, sizeof(double*));
+    npoints=(int*)mxCalloc(nstart, sizeof(int));
+    finished=(bool*)mxCalloc(nstart, sizeof(bool));
+
+    /* Trace the paths, in parallel for a batch */
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,1) num_threads(nthreads) if(nthreads>1&&nstart>1)
+#endif
+    for(q=0; q<nstart; q++) {
+        int capacity=0;
+        double *line=NULL;
+        npoints[q]=trace_path(I, Isize, dim, &g, &starts0[q*dim], stepSize, method, maxpoints, &line, &capacity, &finished[q]);
+        lines[q]=line;
+    }
+
+    /* Report a failed allocation only now, outside of the threads */
+    for(q=0; q<nstart; q++) {
+        if(npoints[q]<0) {
+            for(i=0; i<nstart; i++) { free(lines[i]); }
+            mexErrMsgTxt("Out of memory while tracing the shortest path");
+        }
+    }
+
+    /* Create the outputs */
+    if(nstart==1) {
+        plhs[0]=line_to_matlab(lines[0], npoints[0], dim);
+    }
+    else {
+        plhs[0]=mxCreateCellMatrix(1, nstart);
+        for(q=0; q<nstart; q++) { mxSetCell(plhs[0], q, line_to_matlab(lines[q], npoints[q], dim)); }
+    }
+    if(nlhs>1) {
+        plhs[1]=mxCreateLogicalMatrix(1, nstart);
+        for(q=0; q<nstart; q++) { mxGetLogicals(plhs[1])[q]=finished[q]; }
+    }
+
+    for(q=0; q<nstart; q++) { free(lines[q]); }
+    mxFree(lines); mxFree(npoints); mxFree(finished);
+    mxFree(starts0); mxFree(sources0);
+    mxFree(g.cellstart); mxFree(g.cellpoints);
+}
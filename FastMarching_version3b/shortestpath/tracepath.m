@@ -0,0 +1,21 @@
+% TRACEPATH traces whole shortest paths in a 2D or 3D distance map, it does
+% the iteration of shortestpath in one call instead of one rk4 call per step
+%
+% [Lines, Finished] = TRACEPATH(StartPoints, Field, SourcePoint, StepSize, Method, NumThreads);
+%
+%  inputs :
+%      StartPoints: Start points [2 x N] or [3 x N]
+%      Field: The GradientVolume for 'rk4' and 'euler', the DistanceMap
+%             for 'simple'
+%      SourcePoint: End points of the paths [2 x M] or [3 x M], or []
+%      StepSize : The stepsize
+%      Method: 'rk4' (default), 'euler' or 'simple'
+%      NumThreads: Number of threads used for N>1, 0 for all cores (default)
+%
+% outputs :
+%      Lines : The path (K x 2 or K x 3) for one start point, a cell array
+%              with a path per start point for N>1
+%      Finished : True for a path which ended within one pixel of a source
+%              point
+%
+% note: This function is c-coded thus first compile it with compile_c_files
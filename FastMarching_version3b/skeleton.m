@@ -89,7 +89,14 @@ while(true)
 
     % Do fast marching using the maximum distance value in the image
     % and the points describing all found branches are sourcepoints.
-    [T,Y] = msfm(SpeedImage, SourcePoint, false, false);
+    % With the compiled c-code only the last found branch is added to
+    % the previous distance map, which gives the same T and Y as marching
+    % the whole image again.
+    if((itt>0)&&(IS3D||(exist('msfm2d','file')==3)))
+        [T,Y] = msfm(SpeedImage, ShortestLine', false, false, T, Y);
+    else
+        [T,Y] = msfm(SpeedImage, SourcePoint, false, false);
+    end
       
     % Trace a branch back to the used sourcepoints
     StartPoint=maxDistancePoint(Y,I,IS3D);
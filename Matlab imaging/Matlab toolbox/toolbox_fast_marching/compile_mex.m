@@ -7,16 +7,27 @@ mex mex/perform_circular_front_propagation_2d.cpp mex/perform_front_propagation_
 mex mex/anisotropic-fm//perform_front_propagation_anisotropic.cpp
 mex mex/anisotropic-fm-feth/fm2dAniso.cpp
 
-% compiling skeleton
-mex mex/skeleton.cpp
+% compiling skeleton (OpenMP for volumes)
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/skeleton.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/skeleton.cpp
+end
 % compiling distance transform
 mex mex/eucdist2.c
+% N-D distance transform, lines processed in parallel with OpenMP
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/eucdistn.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/eucdistn.cpp
+end
 
 disp('Compiling perform_front_propagation_mesh, might time some time.');
 rep = 'mex/';
 files =  { ...
     'perform_front_propagation_mesh.cpp', ...
     'gw/gw_core/GW_Config.cpp',           ...
+    'gw/gw_core/GW_CompactMesh.cpp',      ...
     'gw/gw_core/GW_FaceIterator.cpp',     ...
     'gw/gw_core/GW_SmartCounter.cpp',     ...
     'gw/gw_core/GW_VertexIterator.cpp',   ...
@@ -25,6 +36,7 @@ files =  { ...
     'gw/gw_core/GW_Vertex.cpp',       ...
     'gw/gw_geodesic/GW_GeodesicFace.cpp', ...                                              
     'gw/gw_geodesic/GW_GeodesicMesh.cpp',     ...                                 
+    'gw/gw_geodesic/GW_CompactGeodesicMesh.cpp', ...
     'gw/gw_geodesic/GW_GeodesicPath.cpp',         ...                       
     'gw/gw_geodesic/GW_GeodesicPoint.cpp',            ...           
     'gw/gw_geodesic/GW_TriangularInterpolation_Cubic.cpp', ...      
@@ -38,3 +50,36 @@ for i=1:length(files)
 end
 eval(str);
 
+disp('Compiling perform_fps_mesh.');
+files =  { ...
+    'perform_fps_mesh.cpp', ...
+    'gw/gw_core/GW_Config.cpp',           ...
+    'gw/gw_core/GW_CompactMesh.cpp',      ...
+    'gw/gw_core/GW_FaceIterator.cpp',     ...
+    'gw/gw_core/GW_SmartCounter.cpp',     ...
+    'gw/gw_core/GW_VertexIterator.cpp',   ...
+    'gw/gw_core/GW_Face.cpp',             ...
+    'gw/gw_core/GW_Mesh.cpp',             ...
+    'gw/gw_core/GW_Vertex.cpp',       ...
+    'gw/gw_geodesic/GW_GeodesicFace.cpp', ...
+    'gw/gw_geodesic/GW_GeodesicMesh.cpp',     ...
+    'gw/gw_geodesic/GW_CompactGeodesicMesh.cpp', ...
+    'gw/gw_geodesic/GW_FarthestPointSampler.cpp', ...
+    'gw/gw_geodesic/GW_GeodesicPath.cpp',         ...
+    'gw/gw_geodesic/GW_GeodesicPoint.cpp',            ...
+    'gw/gw_geodesic/GW_TriangularInterpolation_Cubic.cpp', ...
+    'gw/gw_geodesic/GW_GeodesicVertex.cpp',                    ...
+    'gw/gw_geodesic/GW_TriangularInterpolation_Linear.cpp',      ...
+    'gw/gw_geodesic/GW_TriangularInterpolation_Quadratic.cpp',  ...
+};
+% the batches of seeds are propagated in parallel with OpenMP
+if ispc
+    str = 'mex COMPFLAGS="$COMPFLAGS /openmp" ';
+else
+    str = 'mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" ';
+end
+for i=1:length(files)
+    str = [str rep files{i} ' '];
+end
+eval(str);
+
@@ -0,0 +1,21 @@
+function varargout = eucdistn(varargin)
+%EUCDISTN Compute N-D Euclidean distance transform.
+%   D = EUCDISTN(BW) computes the exact Euclidean distance transform of
+%   the binary array BW, of any dimension. Specifically, it computes the
+%   distance to the nearest nonzero-valued element.
+%
+%   [D,L] = EUCDISTN(BW) returns a linear index array L representing a
+%   nearest-neighbor map.  L(i) is the linear index of the nonzero-valued
+%   element of BW closest to element i.
+%
+%   [D,L] = EUCDISTN(BW,SPACING) uses voxels of size SPACING(k) along
+%   dimension k (default ones(1,ndims(BW))).
+%
+%   [D,L] = EUCDISTN(BW,SPACING,NB_THREADS) uses NB_THREADS threads
+%   (default 0, all of them).
+%
+%   See also EUCDIST2, BWDIST.
+
+%#mex
+
+error('eucdistn:missingMEXFile', 'Missing MEX-file: %s', mfilename);
\ No newline at end of file
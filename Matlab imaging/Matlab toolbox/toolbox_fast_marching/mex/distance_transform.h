@@ -0,0 +1,197 @@
+#ifndef _DISTANCE_TRANSFORM_H_
+#define _DISTANCE_TRANSFORM_H_
+
+#include <math.h>
+#include <vector>
+#include <limits>
+#include "mex.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+	Exact squared Euclidean distance transform by one pass along each
+	dimension, each pass computing the lower envelope of the parabolas
+	rooted at the elements of a line (Felzenszwalb-Huttenlocher, Meijster).
+
+	D holds the squared distances (0 on the features, infinity elsewhere
+	before the first pass) and L the label of the nearest feature. Td is
+	float or double, Tl any type able to store the labels.
+	These functions do not call the mex API, so they can run in threads.
+*/
+
+/* number of neighbor lines processed together */
+#define EDT_NB_LINES 16
+
+/* the buffers of a thread */
+template<class Td, class Tl>
+struct edt_buffers
+{
+	std::vector<Td> f;			// squared distances along the line
+	std::vector<Tl> lab;		// nearest features along the line
+	std::vector<int> v;			// roots of the parabolas of the lower envelope
+	std::vector<double> z;		// boundaries between the parabolas
+	std::vector<Td> fd;			// result of the line
+	std::vector<Tl> labd;
+	std::vector<Td> F;			// group of lines, F[l*n+i] is the i-th element of line l
+	std::vector<Tl> Lab;
+
+	void resize( int n )
+	{
+		f.resize(n); lab.resize(n);
+		fd.resize(n); labd.resize(n);
+		v.resize(n); z.resize(n+1);
+		F.resize(n*EDT_NB_LINES); Lab.resize(n*EDT_NB_LINES);
+	}
+};
+
+/*
+	1D squared distance transform of the line f of length n, with spacing h :
+		d(p) = min_q ( h*(p-q) )^2 + f(q)
+	lab is the label of each q, labd the label of the q reaching the minimum
+	(unchanged if the line has no feature).
+*/
+template<class Td, class Tl>
+void edt_line( const Td* f, const Tl* lab, Td* d, Tl* labd, int n, double h, edt_buffers<Td,Tl>& buf )
+{
+	const Td inf = std::numeric_limits<Td>::infinity();
+	int* v = &buf.v[0];
+	double* z = &buf.z[0];
+	int k = -1;
+	for( int q=0; q<n; ++q )
+	{
+		if( f[q]==inf )
+			continue;
+		double xq = h*q;
+		if( k<0 )
+		{
+			k = 0;
+			v[0] = q;
+			z[0] = -HUGE_VAL;
+			z[1] = HUGE_VAL;
+			continue;
+		}
+		// intersection with the last parabola of the envelope
+		double xv = h*v[k];
+		double s = ( ((double) f[q]+xq*xq) - ((double) f[v[k]]+xv*xv) ) / ( 2*(xq-xv) );
+		while( s<=z[k] )
+		{
+			k--;
+			xv = h*v[k];
+			s = ( ((double) f[q]+xq*xq) - ((double) f[v[k]]+xv*xv) ) / ( 2*(xq-xv) );
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k+1] = HUGE_VAL;
+	}
+	if( k<0 )
+	{
+		// no feature on this line
+		for( int p=0; p<n; ++p )
+		{
+			d[p] = inf;
+			labd[p] = lab[p];
+		}
+		return;
+	}
+	k = 0;
+	for( int p=0; p<n; ++p )
+	{
+		double xp = h*p;
+		while( z[k+1]<xp )
+			k++;
+		double dx = xp - h*v[k];
+		d[p] = (Td) ( dx*dx + f[v[k]] );
+		labd[p] = lab[v[k]];
+	}
+}
+
+/*
+	pass along the nb neighbor lines of length n starting at base,
+	stride being the distance between two elements of a line.
+*/
+template<class Td, class Tl>
+void edt_group( Td* D, Tl* L, size_t base, size_t stride, int n, int nb, double h, edt_buffers<Td,Tl>& buf )
+{
+	if( nb==1 )
+	{
+		// a single line (always the case for the first dimension)
+		for( int i=0; i<n; ++i )
+		{
+			buf.f[i] = D[base+i*stride];
+			buf.lab[i] = L[base+i*stride];
+		}
+		edt_line( &buf.f[0], &buf.lab[0], &buf.fd[0], &buf.labd[0], n, h, buf );
+		for( int i=0; i<n; ++i )
+		{
+			D[base+i*stride] = buf.fd[i];
+			L[base+i*stride] = buf.labd[i];
+		}
+		return;
+	}
+	// copy the group, reading nb contiguous values per element
+	for( int i=0; i<n; ++i )
+	for( int l=0; l<nb; ++l )
+	{
+		buf.F[l*n+i] = D[base+i*stride+l];
+		buf.Lab[l*n+i] = L[base+i*stride+l];
+	}
+	for( int l=0; l<nb; ++l )
+	{
+		edt_line( &buf.F[l*n], &buf.Lab[l*n], &buf.fd[0], &buf.labd[0], n, h, buf );
+		for( int i=0; i<n; ++i )
+		{
+			buf.F[l*n+i] = buf.fd[i];
+			buf.Lab[l*n+i] = buf.labd[i];
+		}
+	}
+	for( int i=0; i<n; ++i )
+	for( int l=0; l<nb; ++l )
+	{
+		D[base+i*stride+l] = buf.F[l*n+i];
+		L[base+i*stride+l] = buf.Lab[l*n+i];
+	}
+}
+
+/*
+	pass along dimension d of the array D (labels L) of size dims[0] x ... x dims[nd-1].
+	The lines are processed in parallel, by groups of EDT_NB_LINES neighbor
+	lines copied in a buffer to read the memory contiguously.
+*/
+template<class Td, class Tl>
+void edt_pass( Td* D, Tl* L, const mwSize* dims, int nd, int d, double h, int nb_threads )
+{
+	int n = (int) dims[d];
+	size_t stride = 1, N = 1;
+	for( int i=0; i<d; ++i )
+		stride *= dims[i];
+	for( int i=0; i<nd; ++i )
+		N *= dims[i];
+	if( n<=1 || N==0 )
+		return;
+	size_t nb_outer = N/(stride*n);
+	size_t groups_per_outer = (stride+EDT_NB_LINES-1)/EDT_NB_LINES;
+	long long nb_groups = (long long) (nb_outer*groups_per_outer);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nb_threads) if(nb_threads>1)
+#else
+	(void) nb_threads;
+#endif
+	{
+		edt_buffers<Td,Tl> buf;
+		buf.resize(n);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+		for( long long g=0; g<nb_groups; ++g )
+		{
+			size_t outer = (size_t) g/groups_per_outer;
+			size_t inner = ((size_t) g%groups_per_outer)*EDT_NB_LINES;
+			int nb = (int) ( stride-inner<EDT_NB_LINES ? stride-inner : EDT_NB_LINES );
+			edt_group( D, L, inner + outer*stride*n, stride, n, nb, h, buf );
+		}
+	}
+}
+
+#endif // _DISTANCE_TRANSFORM_H_
@@ -0,0 +1,123 @@
+/*=================================================================
+% eucdistn - exact Euclidean distance transform of a N-D binary array.
+%
+%   [D,L] = eucdistn(BW, spacing, nb_threads);
+%
+%	D is the distance of each element to the nearest nonzero element of BW
+%		(Inf everywhere if BW has no nonzero element).
+%	L is the linear index (1-based) of this nearest nonzero element, as the
+%		L output of eucdist2 (0 if BW has no nonzero element).
+%	'spacing' is the size of the voxels along each dimension (default ones).
+%	'nb_threads' is the number of threads (0 for all, the default).
+%
+%	BW can be logical, uint8, single or double, of any dimension.
+%
+%	The squared distance is separable : it is computed by one pass along
+%	each dimension, each pass computing the lower envelope of the parabolas
+%	rooted at the elements of a line, see
+%		P. Felzenszwalb and D. Huttenlocher, "Distance Transforms of Sampled
+%		Functions", Theory of Computing, 2012
+%		A. Meijster, J. Roerdink and W. Hesselink, "A General Algorithm for
+%		Computing Distance Transforms in Linear Time", 2000.
+%	The lines of a pass are independent and processed in parallel, by
+%	groups of neighbor lines copied in a buffer to read the memory
+%	contiguously.
+*=================================================================*/
+
+#include <math.h>
+#include <vector>
+#include "mex.h"
+#include "distance_transform.h"
+
+template<class T>
+void init_distance( const T* bw, double* D, double* L, size_t N )
+{
+	for( size_t i=0; i<N; ++i )
+	{
+		if( bw[i]!=0 )
+		{
+			D[i] = 0;
+			L[i] = (double) (i+1);
+		}
+		else
+		{
+			D[i] = HUGE_VAL;
+			L[i] = 0;
+		}
+	}
+}
+
+void mexFunction(	int nlhs, mxArray *plhs[],
+				 int nrhs, const mxArray*prhs[] )
+{
+	/* retrive arguments */
+	if( nrhs<1 || nrhs>3 )
+		mexErrMsgTxt("1 to 3 input arguments are required.");
+	if( nlhs>2 )
+		mexErrMsgTxt("1 or 2 output arguments are required.");
+
+	// arg1 : BW
+	int nd = (int) mxGetNumberOfDimensions(prhs[0]);
+	const mwSize* dims = mxGetDimensions(prhs[0]);
+	size_t N = mxGetNumberOfElements(prhs[0]);
+	// arg2 : spacing
+	std::vector<double> spacing(nd, 1.0);
+	if( nrhs>=2 && !mxIsEmpty(prhs[1]) )
+	{
+		if( (int) mxGetNumberOfElements(prhs[1])!=nd )
+			mexErrMsgTxt("spacing should have one entry per dimension of BW.");
+		for( int d=0; d<nd; ++d )
+		{
+			spacing[d] = mxGetPr(prhs[1])[d];
+			if( !(spacing[d]>0) )
+				mexErrMsgTxt("spacing should be positive.");
+		}
+	}
+	// arg3 : nb_threads
+	int nb_threads = 0;
+	if( nrhs>=3 )
+		nb_threads = (int) mxGetScalar(prhs[2]);
+#ifdef _OPENMP
+	if( nb_threads<=0 )
+		nb_threads = omp_get_max_threads();
+#endif
+
+	// first output : D
+	plhs[0] = mxCreateNumericArray(nd, dims, mxDOUBLE_CLASS, mxREAL);
+	double* D = mxGetPr(plhs[0]);
+	// second output : L (kept in a temporary array if not asked)
+	mxArray* Lmx = mxCreateNumericArray(nd, dims, mxDOUBLE_CLASS, mxREAL);
+	double* L = mxGetPr(Lmx);
+
+	switch( mxGetClassID(prhs[0]) )
+	{
+	case mxLOGICAL_CLASS:
+		init_distance( (const mxLogical*) mxGetData(prhs[0]), D, L, N );
+		break;
+	case mxUINT8_CLASS:
+		init_distance( (const unsigned char*) mxGetData(prhs[0]), D, L, N );
+		break;
+	case mxSINGLE_CLASS:
+		init_distance( (const float*) mxGetData(prhs[0]), D, L, N );
+		break;
+	case mxDOUBLE_CLASS:
+		init_distance( (const double*) mxGetData(prhs[0]), D, L, N );
+		break;
+	default:
+		mxDestroyArray(Lmx);
+		mexErrMsgTxt("BW should be logical, uint8, single or double.");
+	}
+
+	// one pass per dimension
+	for( int d=0; d<nd; ++d )
+		edt_pass<double,double>( D, L, dims, nd, d, spacing[d], nb_threads );
+
+	// distance instead of squared distance
+	for( size_t i=0; i<N; ++i )
+		D[i] = sqrt(D[i]);
+
+	if( nlhs>=2 )
+		plhs[1] = Lmx;
+	else
+		mxDestroyArray(Lmx);
+}
@@ -0,0 +1,213 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactMesh.cpp
+ *  \brief  Definition of class \c GW_CompactMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+
+#include "stdafx.h"
+#include "GW_CompactMesh.h"
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#ifndef GW_USE_INLINE
+    #include "GW_CompactMesh.inl"
+#endif
+
+using namespace GW;
+
+const GW_Index GW_CompactMesh::kNoIndex;
+
+/** an half edge together with the key of its (unoriented) edge */
+struct GW_EdgeKey
+{
+	unsigned long long nKey;
+	GW_Index nHalfEdge;
+	bool operator<( const GW_EdgeKey& k ) const
+	{
+		return nKey<k.nKey || (nKey==k.nKey && nHalfEdge<k.nHalfEdge);
+	}
+};
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_SortEdgeKeys
+/**
+ *  \param  Keys [std::vector<GW_EdgeKey>&] The keys to sort.
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ *
+ *  Parallel sort : each thread sorts a chunk, then chunks are merged by
+ *	pairs in log2(nNbrThreads) rounds. Plain std::sort without OpenMP.
+ */
+/*------------------------------------------------------------------------------*/
+static void GW_SortEdgeKeys( std::vector<GW_EdgeKey>& Keys, GW_I32 nNbrThreads )
+{
+#ifdef _OPENMP
+	if( nNbrThreads<=0 )
+		nNbrThreads = omp_get_max_threads();
+	/* not worth it for small meshes */
+	if( Keys.size()<(size_t) 65536*nNbrThreads )
+		nNbrThreads = 1;
+	std::vector<size_t> Bound(nNbrThreads+1);
+	for( GW_I32 c=0; c<=nNbrThreads; ++c )
+		Bound[c] = Keys.size()*c/nNbrThreads;
+	#pragma omp parallel for num_threads(nNbrThreads)
+	for( GW_I32 c=0; c<nNbrThreads; ++c )
+		std::sort( Keys.begin()+Bound[c], Keys.begin()+Bound[c+1] );
+	for( GW_I32 w=1; w<nNbrThreads; w*=2 )
+	{
+		#pragma omp parallel for num_threads(nNbrThreads)
+		for( GW_I32 c=0; c<nNbrThreads-w; c+=2*w )
+			std::inplace_merge( Keys.begin()+Bound[c], Keys.begin()+Bound[c+w],
+								Keys.begin()+Bound[GW_MIN(c+2*w,nNbrThreads)] );
+	}
+#else
+	std::sort( Keys.begin(), Keys.end() );
+#endif
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::SetNbrVertex
+/**
+ *  \param  nNum [GW_U32] The number.
+ *  \date   10-19-2026
+ *
+ *  Resize the vertex arrays. Connectivity must be rebuilt.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactMesh::SetNbrVertex( GW_U32 nNum )
+{
+	Position_.resize( 3*nNum, 0 );
+	VertexHalfEdge_.assign( nNum, kNoIndex );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::SetNbrFace
+/**
+ *  \param  nNum [GW_U32] The number.
+ *  \date   10-19-2026
+ *
+ *  Resize the face arrays. Connectivity must be rebuilt.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactMesh::SetNbrFace( GW_U32 nNum )
+{
+	Face_.resize( 3*nNum, 0 );
+	Twin_.assign( 3*nNum, kNoIndex );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::Reset
+/**
+ *  \date   10-19-2026
+ *
+ *  Free all the data.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactMesh::Reset()
+{
+	T_FloatVector().swap( Position_ );
+	std::vector<GW_Index>().swap( Face_ );
+	std::vector<GW_Index>().swap( Twin_ );
+	std::vector<GW_Index>().swap( VertexHalfEdge_ );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::BuildConnectivity
+/**
+ *  \param  nNbrThreads [GW_I32] Number of threads for the sort, <=0 for all.
+ *  \date   10-19-2026
+ *
+ *  Compute the twin of each half edge and the half edge leaving each vertex.
+ *	Half edges are sorted by the key (min(i,j),max(i,j)) of their edge, so
+ *	that the 2 half edges of an inner edge end up next to each other.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactMesh::BuildConnectivity( GW_I32 nNbrThreads )
+{
+	GW_Index nNbrHalfEdge = (GW_Index) Face_.size();
+	std::vector<GW_EdgeKey> Keys(nNbrHalfEdge);
+	#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads>0 ? nNbrThreads : omp_get_max_threads())
+	#endif
+	for( GW_I32 h=0; h<(GW_I32) nNbrHalfEdge; ++h )
+	{
+		unsigned long long i = this->HalfEdgeOrigin(h);
+		unsigned long long j = this->HalfEdgeTarget(h);
+		Keys[h].nKey = i<j ? (i<<32)|j : (j<<32)|i;
+		Keys[h].nHalfEdge = (GW_Index) h;
+	}
+	GW_SortEdgeKeys( Keys, nNbrThreads );
+
+	/* pair the 2 half edges of each manifold, consistently oriented edge */
+	Twin_.assign( nNbrHalfEdge, kNoIndex );
+	for( GW_Index k=0; k<nNbrHalfEdge; )
+	{
+		GW_Index e = k+1;
+		while( e<nNbrHalfEdge && Keys[e].nKey==Keys[k].nKey )
+			e++;
+		if( e==k+2 )
+		{
+			GW_Index h1 = Keys[k].nHalfEdge;
+			GW_Index h2 = Keys[k+1].nHalfEdge;
+			if( this->HalfEdgeOrigin(h1)==this->HalfEdgeTarget(h2) )
+			{
+				Twin_[h1] = h2;
+				Twin_[h2] = h1;
+			}
+		}
+		k = e;
+	}
+
+	/* an half edge leaving each vertex, on the boundary if possible */
+	VertexHalfEdge_.assign( VertexHalfEdge_.size(), kNoIndex );
+	for( GW_Index h=0; h<nNbrHalfEdge; ++h )
+	{
+		GW_Index& hv = VertexHalfEdge_[Face_[h]];
+		if( hv==kNoIndex || Twin_[h]==kNoIndex )
+			hv = h;
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetNbrBoundaryHalfEdge
+/**
+ *  \return [GW_U32] The number.
+ *  \date   10-19-2026
+ *
+ *  Number of half edges without twin (boundary and non manifold edges).
+ */
+/*------------------------------------------------------------------------------*/
+GW_U32 GW_CompactMesh::GetNbrBoundaryHalfEdge() const
+{
+	GW_U32 nNum = 0;
+	for( size_t h=0; h<Twin_.size(); ++h )
+		if( Twin_[h]==kNoIndex )
+			nNum++;
+	return nNum;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetMemoryUsage
+/**
+ *  \return [size_t] Number of bytes.
+ *  \date   10-19-2026
+ *
+ *  Memory used by the mesh arrays.
+ */
+/*------------------------------------------------------------------------------*/
+size_t GW_CompactMesh::GetMemoryUsage() const
+{
+	return Position_.capacity()*sizeof(GW_Float) +
+		( Face_.capacity()+Twin_.capacity()+VertexHalfEdge_.capacity() )*sizeof(GW_Index);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactMesh.h
+ *  \brief  Definition of class \c GW_CompactMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_COMPACTMESH_H_
+#define _GW_COMPACTMESH_H_
+
+#include "GW_Config.h"
+
+namespace GW {
+
+/** 32 bits index of a vertex, a face or an half edge of a \c GW_CompactMesh. */
+typedef unsigned int GW_Index;
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_CompactMesh
+ *  \brief  A triangle mesh stored as flat arrays with half edge connectivity.
+ *  \date   10-19-2026
+ *
+ *  Alternative to \c GW_Mesh for large meshes : no object is allocated per
+ *	vertex or per face. The mesh is made of
+ *		- \c Position_ : the 3 coords of each vertex, contiguous.
+ *		- \c Face_ : the 3 vertex of each face (32 bits indices).
+ *		- \c Twin_ : the opposite half edge of each half edge.
+ *		- \c VertexHalfEdge_ : one half edge leaving each vertex.
+ *
+ *	Half edge \c 3*f+k of face \c f goes from vertex \c Face_[3*f+k] to
+ *	vertex \c Face_[3*f+(k+1)%3], so that next/previous half edges and the
+ *	origin of an half edge need no storage. The twin of a boundary half edge
+ *	is \c kNoIndex, and the half edge leaving a boundary vertex is chosen on
+ *	the boundary so that \c RotateHalfEdge visits all its faces.
+ *
+ *	Like \c GW_Mesh, faces must be consistently oriented. Edges shared by
+ *	more than 2 faces, or by 2 faces with opposite orientations, are
+ *	considered as boundary edges.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_CompactMesh
+{
+
+public:
+
+	/** index of a missing half edge (boundary) or vertex */
+	static const GW_Index kNoIndex = 0xFFFFFFFFu;
+
+    /*------------------------------------------------------------------------------*/
+    /** \name Constructor and destructor */
+    /*------------------------------------------------------------------------------*/
+    //@{
+    GW_CompactMesh();
+    virtual ~GW_CompactMesh();
+    //@}
+
+    //-------------------------------------------------------------------------
+    /** \name Resize manager. */
+    //-------------------------------------------------------------------------
+    //@{
+	void SetNbrVertex( GW_U32 nNum );
+	void SetNbrFace( GW_U32 nNum );
+
+	GW_U32 GetNbrVertex() const;
+	GW_U32 GetNbrFace() const;
+
+	void Reset();
+    //@}
+
+	//-------------------------------------------------------------------------
+    /** \name Vertex/Face management */
+    //-------------------------------------------------------------------------
+    //@{
+	void SetPosition( GW_U32 nVert, GW_Float x, GW_Float y, GW_Float z );
+	const GW_Float* GetPosition( GW_U32 nVert ) const;
+	void SetFace( GW_U32 nFace, GW_U32 nVert0, GW_U32 nVert1, GW_U32 nVert2 );
+	GW_Index GetFaceVertex( GW_U32 nFace, GW_U32 k ) const;
+    //@}
+
+	void BuildConnectivity( GW_I32 nNbrThreads = 0 );
+
+	//-------------------------------------------------------------------------
+    /** \name Half edge navigation */
+    //-------------------------------------------------------------------------
+    //@{
+	static GW_Index HalfEdgeFace( GW_Index h );
+	static GW_Index HalfEdgeNext( GW_Index h );
+	static GW_Index HalfEdgePrev( GW_Index h );
+	GW_Index HalfEdgeOrigin( GW_Index h ) const;
+	GW_Index HalfEdgeTarget( GW_Index h ) const;
+	GW_Index HalfEdgeTwin( GW_Index h ) const;
+	GW_Index VertexHalfEdge( GW_U32 nVert ) const;
+	GW_Index RotateHalfEdge( GW_Index h ) const;
+	GW_Bool IsBoundaryVertex( GW_U32 nVert ) const;
+    //@}
+
+	GW_U32 GetNbrBoundaryHalfEdge() const;
+	size_t GetMemoryUsage() const;
+
+protected:
+
+	/** x,y,z coords of each vertex */
+	T_FloatVector Position_;
+	/** the 3 vertex of each face, i.e. the origin of each half edge */
+	std::vector<GW_Index> Face_;
+	/** the opposite half edge, or kNoIndex on the boundary */
+	std::vector<GW_Index> Twin_;
+	/** one half edge leaving each vertex, or kNoIndex for isolated vertex */
+	std::vector<GW_Index> VertexHalfEdge_;
+
+};
+
+
+} // End namespace GW
+
+#ifdef GW_USE_INLINE
+    #include "GW_CompactMesh.inl"
+#endif
+
+
+#endif // _GW_COMPACTMESH_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
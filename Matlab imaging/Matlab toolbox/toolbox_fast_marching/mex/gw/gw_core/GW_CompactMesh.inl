@@ -0,0 +1,290 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactMesh.inl
+ *  \brief  Inlined methods for \c GW_CompactMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#include "GW_CompactMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh constructor
+/**
+ *  \date   10-19-2026
+ *
+ *  Constructor.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_CompactMesh::GW_CompactMesh()
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh destructor
+/**
+ *  \date   10-19-2026
+ *
+ *  Destructor.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_CompactMesh::~GW_CompactMesh()
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetNbrVertex
+/**
+ *  \return [GW_U32] The number.
+ *  \date   10-19-2026
+ *
+ *  Get the number of vertex of the mesh.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_U32 GW_CompactMesh::GetNbrVertex() const
+{
+	return (GW_U32) VertexHalfEdge_.size();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetNbrFace
+/**
+ *  \return [GW_U32] The number.
+ *  \date   10-19-2026
+ *
+ *  Get the number of faces of the mesh.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_U32 GW_CompactMesh::GetNbrFace() const
+{
+	return (GW_U32) Face_.size()/3;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::SetPosition
+/**
+ *  \param  nVert [GW_U32] Number of the vertex.
+ *  \param  x [GW_Float] 1st coord.
+ *  \param  y [GW_Float] 2nd coord.
+ *  \param  z [GW_Float] 3rd coord.
+ *  \date   10-19-2026
+ *
+ *  Set the position of a vertex.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactMesh::SetPosition( GW_U32 nVert, GW_Float x, GW_Float y, GW_Float z )
+{
+	GW_ASSERT( nVert<this->GetNbrVertex() );
+	Position_[3*nVert+0] = x;
+	Position_[3*nVert+1] = y;
+	Position_[3*nVert+2] = z;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetPosition
+/**
+ *  \param  nVert [GW_U32] Number of the vertex.
+ *  \return [const GW_Float*] Its 3 coords.
+ *  \date   10-19-2026
+ *
+ *  Get the position of a vertex.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+const GW_Float* GW_CompactMesh::GetPosition( GW_U32 nVert ) const
+{
+	GW_ASSERT( nVert<this->GetNbrVertex() );
+	return &Position_[3*nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::SetFace
+/**
+ *  \param  nFace [GW_U32] Number of the face.
+ *  \param  nVert0 [GW_U32] 1st vertex.
+ *  \param  nVert1 [GW_U32] 2nd vertex.
+ *  \param  nVert2 [GW_U32] 3rd vertex.
+ *  \date   10-19-2026
+ *
+ *  Set the vertex of a face. \c BuildConnectivity must be called once
+ *	all the faces are set.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactMesh::SetFace( GW_U32 nFace, GW_U32 nVert0, GW_U32 nVert1, GW_U32 nVert2 )
+{
+	GW_ASSERT( nFace<this->GetNbrFace() );
+	GW_ASSERT( nVert0<this->GetNbrVertex() && nVert1<this->GetNbrVertex() && nVert2<this->GetNbrVertex() );
+	Face_[3*nFace+0] = (GW_Index) nVert0;
+	Face_[3*nFace+1] = (GW_Index) nVert1;
+	Face_[3*nFace+2] = (GW_Index) nVert2;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::GetFaceVertex
+/**
+ *  \param  nFace [GW_U32] Number of the face.
+ *  \param  k [GW_U32] 0, 1 or 2.
+ *  \return [GW_Index] The k-th vertex of the face.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::GetFaceVertex( GW_U32 nFace, GW_U32 k ) const
+{
+	GW_ASSERT( nFace<this->GetNbrFace() && k<3 );
+	return Face_[3*nFace+k];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgeFace
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The face it belongs to.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgeFace( GW_Index h )
+{
+	return h/3;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgeNext
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The next half edge in the same face.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgeNext( GW_Index h )
+{
+	return (h%3==2) ? h-2 : h+1;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgePrev
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The previous half edge in the same face.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgePrev( GW_Index h )
+{
+	return (h%3==0) ? h+2 : h-1;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgeOrigin
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The vertex it leaves.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgeOrigin( GW_Index h ) const
+{
+	return Face_[h];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgeTarget
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The vertex it points to.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgeTarget( GW_Index h ) const
+{
+	return Face_[GW_CompactMesh::HalfEdgeNext(h)];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::HalfEdgeTwin
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The opposite half edge, \c kNoIndex on the boundary.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::HalfEdgeTwin( GW_Index h ) const
+{
+	return Twin_[h];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::VertexHalfEdge
+/**
+ *  \param  nVert [GW_U32] A vertex.
+ *  \return [GW_Index] An half edge leaving it, \c kNoIndex if it is isolated.
+ *  \date   10-19-2026
+ *
+ *  For a boundary vertex this is the boundary half edge leaving it.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::VertexHalfEdge( GW_U32 nVert ) const
+{
+	return VertexHalfEdge_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::RotateHalfEdge
+/**
+ *  \param  h [GW_Index] An half edge.
+ *  \return [GW_Index] The next half edge leaving the same vertex.
+ *  \date   10-19-2026
+ *
+ *  Turn around the origin of \c h. Return \c kNoIndex when the boundary
+ *	is reached. Starting from \c VertexHalfEdge, the loop
+ *		h = RotateHalfEdge(h)
+ *	visits each face around the vertex once.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactMesh::RotateHalfEdge( GW_Index h ) const
+{
+	return Twin_[GW_CompactMesh::HalfEdgePrev(h)];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactMesh::IsBoundaryVertex
+/**
+ *  \param  nVert [GW_U32] A vertex.
+ *  \return [GW_Bool] Is the vertex on the boundary of the mesh ?
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Bool GW_CompactMesh::IsBoundaryVertex( GW_U32 nVert ) const
+{
+	GW_Index h = VertexHalfEdge_[nVert];
+	return h==kNoIndex || Twin_[h]==kNoIndex;
+}
+
+
+} // End namespace GW
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
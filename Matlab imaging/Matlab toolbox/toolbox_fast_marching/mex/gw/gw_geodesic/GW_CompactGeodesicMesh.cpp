@@ -0,0 +1,540 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactGeodesicMesh.cpp
+ *  \brief  Definition of class \c GW_CompactGeodesicMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+
+#include "stdafx.h"
+#include "GW_CompactGeodesicMesh.h"
+#if defined(_OPENMP) && defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#ifndef GW_USE_INLINE
+    #include "GW_CompactGeodesicMesh.inl"
+#endif
+
+using namespace GW;
+
+/** relaxed atomic read of a shared distance */
+static inline GW_Float GW_AtomicLoad( const GW_Float* p )
+{
+#if defined(_OPENMP) && defined(__GNUC__)
+	GW_Float r;
+	__atomic_load( p, &r, __ATOMIC_RELAXED );
+	return r;
+#else
+	return *p;
+#endif
+}
+
+/** lock free *p = min(*p,v) on a shared distance */
+static inline void GW_AtomicMin( GW_Float* p, GW_Float v )
+{
+#if defined(_OPENMP) && defined(__GNUC__)
+	GW_Float old;
+	__atomic_load( p, &old, __ATOMIC_RELAXED );
+	while( v<old && !__atomic_compare_exchange( p, &old, &v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+	{ }
+#elif defined(_OPENMP) && defined(_MSC_VER)
+	volatile __int64* q = (volatile __int64*) p;
+	__int64 nOld = *q, nNew;
+	memcpy( &nNew, &v, sizeof(GW_Float) );
+	while( v<*(GW_Float*) &nOld )
+	{
+		__int64 nRead = _InterlockedCompareExchange64( q, nNew, nOld );
+		if( nRead==nOld )
+			break;
+		nOld = nRead;
+	}
+#else
+	if( v<*p )
+		*p = v;
+#endif
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::ResetGeodesicMesh
+/**
+ *  \date   10-19-2026
+ *
+ *  Reset the distance, state and front of all vertex for a new fast
+ *  marching computation. Must be called once the mesh is built.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::ResetGeodesicMesh()
+{
+	GW_U32 nNbrVertex = pGeometry_->GetNbrVertex();
+	Distance_.assign( nNbrVertex, GW_INFINITE );
+	State_.assign( nNbrVertex, (GW_U8) kFar );
+	Front_.assign( nNbrVertex, GW_CompactMesh::kNoIndex );
+	HeapPos_.assign( nNbrVertex, GW_CompactMesh::kNoIndex );
+	Heap_.clear();
+	HeapKey_.clear();
+	Touched_.clear();
+	bIsMarchingBegin_ = GW_False;
+	bIsMarchingEnd_ = GW_False;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::ResetTouchedVertex
+/**
+ *  \date   10-19-2026
+ *
+ *  Same as \c ResetGeodesicMesh but only for the vertex reached since the
+ *	last reset, so that the cost is proportional to the explored region.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::ResetTouchedVertex()
+{
+	for( size_t i=0; i<Touched_.size(); ++i )
+	{
+		GW_Index nVert = Touched_[i];
+		Distance_[nVert] = GW_INFINITE;
+		State_[nVert] = (GW_U8) kFar;
+		Front_[nVert] = GW_CompactMesh::kNoIndex;
+		HeapPos_[nVert] = GW_CompactMesh::kNoIndex;
+	}
+	Heap_.clear();
+	HeapKey_.clear();
+	Touched_.clear();
+	bIsMarchingBegin_ = GW_False;
+	bIsMarchingEnd_ = GW_False;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::AddStartVertex
+/**
+ *  \param  nVert [GW_U32] The new starting point.
+ *  \param  rDistance [GW_Float] Its initial distance.
+ *  \date   10-19-2026
+ *
+ *  Add a new vertex as a starting point for the next fire.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::AddStartVertex( GW_U32 nVert, GW_Float rDistance )
+{
+	GW_ASSERT( nVert<pGeometry_->GetNbrVertex() );
+	if( State_[nVert]==kFar )
+		Touched_.push_back( (GW_Index) nVert );
+	Distance_[nVert] = rDistance;
+	State_[nVert] = (GW_U8) kAlive;
+	Front_[nVert] = (GW_Index) nVert;
+	if( HeapPos_[nVert]==GW_CompactMesh::kNoIndex )
+	{
+		/* the heap is ordered in SetUpFastMarching */
+		HeapPos_[nVert] = (GW_Index) Heap_.size();
+		Heap_.push_back( (GW_Index) nVert );
+		HeapKey_.push_back( rDistance );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::SetUpFastMarching
+/**
+ *  \date   10-19-2026
+ *
+ *  Just initialize the fast marching process : order the start vertex
+ *	according to the current callbacks.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::SetUpFastMarching()
+{
+	GW_ASSERT( WeightCallback_!=NULL );
+	GW_Index nSize = (GW_Index) Heap_.size();
+	for( GW_Index i=0; i<nSize; ++i )
+		HeapKey_[i] = this->GetHeapKey( Heap_[i] );
+	for( GW_Index i=nSize/2; i>0; --i )
+		this->HeapSiftDown( i-1, Heap_[i-1], HeapKey_[i-1] );
+
+	bIsMarchingBegin_ = GW_True;
+	bIsMarchingEnd_ = GW_False;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::PerformFastMarching
+/**
+ *  \date   10-19-2026
+ *
+ *  Compute geodesic distance from the start vertex to the other ones.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::PerformFastMarching()
+{
+	this->SetUpFastMarching();
+	/* main loop */
+	while( !this->PerformFastMarchingOneStep() )
+	{ }
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::PerformFastMarchingFlush
+/**
+ *  \date   10-19-2026
+ *
+ *  Continue the algorithm until it termins.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::PerformFastMarchingFlush()
+{
+	if( !bIsMarchingBegin_ )
+		this->SetUpFastMarching();
+	/* main loop */
+	while( !this->PerformFastMarchingOneStep() )
+	{ }
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::PerformFastMarchingOneStep
+/**
+ *  \return [GW_Bool] Is the marching process finished ?
+ *  \date   10-19-2026
+ *
+ *  Just one update step of the marching algorithm.
+ */
+/*------------------------------------------------------------------------------*/
+GW_Bool GW_CompactGeodesicMesh::PerformFastMarchingOneStep()
+{
+	if( Heap_.empty() )
+		return GW_True;
+
+	GW_ASSERT( bIsMarchingBegin_ );
+	GW_Index nCurVert = this->HeapPop();
+	State_[nCurVert] = (GW_U8) kDead;
+	if( pDistanceBound_!=NULL )
+		GW_AtomicMin( &pDistanceBound_[nCurVert], Distance_[nCurVert] );
+
+	if( NewDeadVertexCallback_!=NULL )
+		NewDeadVertexCallback_( nCurVert );
+
+	/* update the neighbors : the target of each half edge leaving the vertex,
+	   plus the last vertex of the fan for a boundary vertex */
+	GW_Index nFront = Front_[nCurVert];
+	GW_Index h0 = pGeometry_->VertexHalfEdge(nCurVert);
+	GW_Index h = h0;
+	while( h!=GW_CompactMesh::kNoIndex )
+	{
+		this->UpdateNeighbor( pGeometry_->HalfEdgeTarget(h), nFront );
+		GW_Index hNext = pGeometry_->RotateHalfEdge(h);
+		if( hNext==GW_CompactMesh::kNoIndex )
+			this->UpdateNeighbor( pGeometry_->HalfEdgeOrigin( GW_CompactMesh::HalfEdgePrev(h) ), nFront );
+		if( hNext==h0 )
+			break;
+		h = hNext;
+	}
+
+	/* have we finished ? */
+	bIsMarchingEnd_ = Heap_.empty();
+	/* the user can force ending of the algorithm */
+	if( ForceStopCallback_!=NULL && bIsMarchingEnd_==GW_False )
+		bIsMarchingEnd_ = ForceStopCallback_( nCurVert );
+
+	return bIsMarchingEnd_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::UpdateNeighbor
+/**
+ *  \param  nNewVert [GW_Index] Neighbor of the new dead vertex.
+ *  \param  nFront [GW_Index] Front of the new dead vertex.
+ *  \date   10-19-2026
+ *
+ *  Compute the new distance of a vertex using all the triangles around it.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_CompactGeodesicMesh::UpdateNeighbor( GW_Index nNewVert, GW_Index nFront )
+{
+	if( State_[nNewVert]==kDead )
+		return;
+
+	/* compute it's new distance using neighborhood information */
+	GW_Float rNewDistance = GW_INFINITE;
+	GW_Index h0 = pGeometry_->VertexHalfEdge(nNewVert);
+	GW_Index h = h0;
+	do
+	{
+		GW_Index nVert1 = pGeometry_->HalfEdgeTarget(h);
+		GW_Index nVert2 = pGeometry_->HalfEdgeOrigin( GW_CompactMesh::HalfEdgePrev(h) );
+		if( Distance_[nVert1]>Distance_[nVert2] )
+		{
+			GW_Index nTemp = nVert1;
+			nVert1 = nVert2;
+			nVert2 = nTemp;
+		}
+		rNewDistance = GW_MIN( rNewDistance, this->ComputeVertexDistance( h, nNewVert, nVert1, nVert2, nFront ) );
+		h = pGeometry_->RotateHalfEdge(h);
+	}
+	while( h!=GW_CompactMesh::kNoIndex && h!=h0 );
+
+	if( State_[nNewVert]==kFar )
+	{
+		/* only explore vertex whose known distance can decrease */
+		if( pDistanceBound_!=NULL && rNewDistance>=GW_AtomicLoad( &pDistanceBound_[nNewVert] ) )
+			return;
+		/* ask to the callback if we should update this vertex and add it to the path */
+		if( VertexInsersionCallback_==NULL ||
+			VertexInsersionCallback_( nNewVert, rNewDistance ) )
+		{
+			Touched_.push_back( nNewVert );
+			Distance_[nNewVert] = rNewDistance;
+			State_[nNewVert] = (GW_U8) kAlive;
+			Front_[nNewVert] = nFront;
+			this->HeapPush( nNewVert );
+		}
+	}
+	else if( rNewDistance<=Distance_[nNewVert] )
+	{
+		/* alive : just update it's value */
+		Distance_[nNewVert] = rNewDistance;
+		Front_[nNewVert] = nFront;
+		this->HeapDecrease( nNewVert );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::ComputeVertexDistance
+/**
+ *  \param  nHalfEdge [GW_Index] Half edge from nVert in the current face.
+ *  \param  nVert [GW_Index] The vertex to update.
+ *  \param  nVert1 [GW_Index] It's 1st neighbor in the face.
+ *  \param  nVert2 [GW_Index] 2nd neighbor.
+ *  \param  nFront [GW_Index] The front being propagated.
+ *  \return [GW_Float] The value of the distance according to this triangle contribution.
+ *  \date   10-19-2026
+ *
+ *  Compute the update of a vertex from inside of a triangle, see
+ *	\c GW_GeodesicMesh::ComputeVertexDistance.
+ */
+/*------------------------------------------------------------------------------*/
+GW_Float GW_CompactGeodesicMesh::ComputeVertexDistance( GW_Index nHalfEdge, GW_Index nVert, GW_Index nVert1, GW_Index nVert2, GW_Index nFront )
+{
+	GW_Bool bVert1Usable = State_[nVert1]!=kFar && Front_[nVert1]==nFront;
+	GW_Bool bVert2Usable = State_[nVert2]!=kFar && Front_[nVert2]==nFront;
+	if( !bVert1Usable && !bVert2Usable )
+		return GW_INFINITE;
+
+	GW_Float F = pWeight_!=NULL ? pWeight_[nVert] : this->WeightCallback_( nVert );
+	GW_Vector3D Pos = this->GetVector( nVert );
+	GW_Vector3D Edge1 = this->GetVector( nVert1 ) - Pos;
+	GW_Float b = Edge1.Norm();
+	Edge1 /= b;
+	GW_Vector3D Edge2 = this->GetVector( nVert2 ) - Pos;
+	GW_Float a = Edge2.Norm();
+	Edge2 /= a;
+
+	GW_Float d1 = Distance_[nVert1];
+	GW_Float d2 = Distance_[nVert2];
+
+	if( !bVert1Usable )
+	{
+		/* only one point is a contributor */
+		return d2 + a * F;
+	}
+	if( !bVert2Usable )
+	{
+		/* only one point is a contributor */
+		return d1 + b * F;
+	}
+
+	GW_Float dot = Edge1*Edge2;
+
+	/* first special case for obtuse angles */
+	if( dot<0 && bUseUnfolding_ )
+	{
+		GW_Float c, dot1, dot2;
+		GW_Index nVert3 = this->UnfoldTriangle( nHalfEdge, nVert, nVert1, nVert2, c, dot1, dot2 );
+		if( nVert3!=GW_CompactMesh::kNoIndex && State_[nVert3]!=kFar )
+		{
+			GW_Float d3 = Distance_[nVert3];
+			/* use the unfolded value */
+			GW_Float t = GW_GeodesicMesh::ComputeUpdate_SethianMethod( d1, d3, c, b, dot1, F );
+			return GW_MIN( t, GW_GeodesicMesh::ComputeUpdate_SethianMethod( d3, d2, a, c, dot2, F ) );
+		}
+	}
+
+	return GW_GeodesicMesh::ComputeUpdate_SethianMethod( d1, d2, a, b, dot, F );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::UnfoldTriangle
+/**
+ *  \param  nHalfEdge [GW_Index] Half edge from nVert in the current face.
+ *  \param  nVert [GW_Index] Vertex to update.
+ *  \param  nVert1 [GW_Index] 1st neighbor.
+ *  \param  nVert2 [GW_Index] 2nd neighbor.
+ *  \return [GW_Index] The vertex, GW_CompactMesh::kNoIndex if none was found.
+ *  \date   10-19-2026
+ *
+ *  Find a correct vertex to update \c nVert, see
+ *	\c GW_GeodesicMesh::UnfoldTriangle. The faces crossed by the unfolding
+ *	are reached through the twin of the edge opposite to the last vertex.
+ */
+/*------------------------------------------------------------------------------*/
+GW_Index GW_CompactGeodesicMesh::UnfoldTriangle( GW_Index nHalfEdge, GW_Index nVert, GW_Index nVert1, GW_Index nVert2,
+												 GW_Float& dist, GW_Float& dot1, GW_Float& dot2 ) const
+{
+	GW_Vector3D v  = this->GetVector( nVert );
+	GW_Vector3D v1 = this->GetVector( nVert1 );
+	GW_Vector3D v2 = this->GetVector( nVert2 );
+
+	GW_Vector3D e1 = v1-v;
+	GW_Float rNorm1 = ~e1;
+	e1 /= rNorm1;
+	GW_Vector3D e2 = v2-v;
+	GW_Float rNorm2 = ~e2;
+	e2 /= rNorm2;
+
+	GW_Float dot = e1*e2;
+	GW_ASSERT( dot<0 );
+
+	/* the equation of the lines defining the unfolding region [e.g. line 1 : {x ; <x,eq1>=0} ]*/
+	GW_Vector2D eq1 = GW_Vector2D( dot, sqrt(1-dot*dot) );
+	GW_Vector2D eq2 = GW_Vector2D(1,0);
+
+	/* position of the 2 points on the unfolding plane */
+	GW_Vector2D x1(rNorm1, 0 );
+	GW_Vector2D x2 = eq1*rNorm2;
+
+	/* keep track of the starting point */
+	GW_Vector2D xstart1 = x1;
+	GW_Vector2D xstart2 = x2;
+
+	GW_Index nV1 = nVert1;
+	GW_Index nV2 = nVert2;
+	/* the half edge of [nV1 nV2] in the face to unfold */
+	GW_Index h = pGeometry_->HalfEdgeTwin( GW_CompactMesh::HalfEdgeNext(nHalfEdge) );
+
+	GW_U32 nNum = 0;
+	while( nNum<50 && h!=GW_CompactMesh::kNoIndex )
+	{
+		GW_Index nV = pGeometry_->HalfEdgeOrigin( GW_CompactMesh::HalfEdgePrev(h) );
+		GW_Vector3D p1 = this->GetVector( nV1 );
+
+		e1 = this->GetVector( nV2 ) - p1;
+		GW_Float rNorm1 = ~e1;
+		e1 /= rNorm1;
+		e2 = this->GetVector( nV ) - p1;
+		GW_Float rNorm2 = ~e2;
+		e2 /= rNorm2;
+		/* compute the position of the new point x on the unfolding plane (via a rotation of -alpha on (x2-x1)/rNorm1 ) */
+		GW_Vector2D vv = (x2 - x1)*rNorm2/rNorm1;
+		dot = e1*e2;
+		GW_Vector2D x = vv.Rotate( -acos(dot) ) + x1;
+
+		/* compute the intersection points.
+		   We look for x=x1+lambda*(x-x1) or x=x2+lambda*(x-x2) with <x,eqi>=0, so */
+		GW_Float lambda11 = - (x1*eq1) / ( (x-x1)*eq1 );	// left most
+		GW_Float lambda12 = - (x1*eq2) / ( (x-x1)*eq2 );	// right most
+		GW_Float lambda21 = - (x2*eq1) / ( (x-x2)*eq1 );	// left most
+		GW_Float lambda22 = - (x2*eq2) / ( (x-x2)*eq2 );	// right most
+		GW_Bool bIntersect11 = (lambda11>=0) && (lambda11<=1);
+		GW_Bool bIntersect12 = (lambda12>=0) && (lambda12<=1);
+		GW_Bool bIntersect21 = (lambda21>=0) && (lambda21<=1);
+		GW_Bool bIntersect22 = (lambda22>=0) && (lambda22<=1);
+		if( bIntersect11 && bIntersect12 )
+		{
+			/* we should unfold on edge [x x1] */
+			h = pGeometry_->HalfEdgeTwin( pGeometry_->HalfEdgeTarget(h)==nV1 ? GW_CompactMesh::HalfEdgeNext(h) : GW_CompactMesh::HalfEdgePrev(h) );
+			nV2 = nV;
+			x2 = x;
+		}
+		else if( bIntersect21 && bIntersect22 )
+		{
+			/* we should unfold on edge [x x2] */
+			h = pGeometry_->HalfEdgeTwin( pGeometry_->HalfEdgeTarget(h)==nV2 ? GW_CompactMesh::HalfEdgeNext(h) : GW_CompactMesh::HalfEdgePrev(h) );
+			nV1 = nV;
+			x1 = x;
+		}
+		else
+		{
+			/* that's it, we have found the point */
+			dist = ~x;
+			dot1 = x*xstart1 / (dist * ~xstart1);
+			dot2 = x*xstart2 / (dist * ~xstart2);
+			return nV;
+		}
+		nNum++;
+	}
+
+	return GW_CompactMesh::kNoIndex;
+}
+
+/*------------------------------------------------------------------------------*/
+/** \name Indexed binary heap of the alive vertex. */
+/*------------------------------------------------------------------------------*/
+//@{
+void GW_CompactGeodesicMesh::HeapSiftUp( GW_Index i, GW_Index nVert, GW_Float rKey )
+{
+	while( i>0 )
+	{
+		GW_Index p = (i-1)/2;
+		if( HeapKey_[p]<=rKey )
+			break;
+		Heap_[i] = Heap_[p];
+		HeapKey_[i] = HeapKey_[p];
+		HeapPos_[Heap_[i]] = i;
+		i = p;
+	}
+	Heap_[i] = nVert;
+	HeapKey_[i] = rKey;
+	HeapPos_[nVert] = i;
+}
+
+void GW_CompactGeodesicMesh::HeapSiftDown( GW_Index i, GW_Index nVert, GW_Float rKey )
+{
+	GW_Index nSize = (GW_Index) Heap_.size();
+	while( GW_True )
+	{
+		GW_Index c = 2*i+1;
+		if( c>=nSize )
+			break;
+		if( c+1<nSize && HeapKey_[c+1]<HeapKey_[c] )
+			c++;
+		if( HeapKey_[c]>=rKey )
+			break;
+		Heap_[i] = Heap_[c];
+		HeapKey_[i] = HeapKey_[c];
+		HeapPos_[Heap_[i]] = i;
+		i = c;
+	}
+	Heap_[i] = nVert;
+	HeapKey_[i] = rKey;
+	HeapPos_[nVert] = i;
+}
+
+void GW_CompactGeodesicMesh::HeapPush( GW_Index nVert )
+{
+	Heap_.push_back( nVert );
+	HeapKey_.push_back( 0 );
+	this->HeapSiftUp( (GW_Index) Heap_.size()-1, nVert, this->GetHeapKey(nVert) );
+}
+
+GW_Index GW_CompactGeodesicMesh::HeapPop()
+{
+	GW_Index nVert = Heap_.front();
+	HeapPos_[nVert] = GW_CompactMesh::kNoIndex;
+	GW_Index nLast = Heap_.back();
+	GW_Float rLastKey = HeapKey_.back();
+	Heap_.pop_back();
+	HeapKey_.pop_back();
+	if( !Heap_.empty() )
+		this->HeapSiftDown( 0, nLast, rLastKey );
+	return nVert;
+}
+
+void GW_CompactGeodesicMesh::HeapDecrease( GW_Index nVert )
+{
+	GW_ASSERT( HeapPos_[nVert]!=GW_CompactMesh::kNoIndex );
+	this->HeapSiftUp( HeapPos_[nVert], nVert, this->GetHeapKey(nVert) );
+}
+//@}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
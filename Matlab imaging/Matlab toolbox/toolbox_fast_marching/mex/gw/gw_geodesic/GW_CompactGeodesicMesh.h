@@ -0,0 +1,184 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactGeodesicMesh.h
+ *  \brief  Definition of class \c GW_CompactGeodesicMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_COMPACTGEODESICMESH_H_
+#define _GW_COMPACTGEODESICMESH_H_
+
+#include "../gw_core/GW_Config.h"
+#include "../gw_core/GW_CompactMesh.h"
+#include "GW_GeodesicMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_CompactGeodesicMesh
+ *  \brief  Fast marching of \c GW_GeodesicMesh on a \c GW_CompactMesh.
+ *  \date   10-19-2026
+ *
+ *  Same propagation as \c GW_GeodesicMesh (Sethian update, unfolding of
+ *	obtuse triangles, one front per start vertex) but vertex are referred
+ *	to by their index and the distance, state and front of each vertex are
+ *	stored in flat arrays. The active vertex are kept in an indexed heap so
+ *	that an update costs log(n) instead of a rebuild of the whole heap.
+ *
+ *	The mesh is given to the constructor and is not copied, so it must
+ *	outlive the propagation, and several propagations (e.g. one per thread)
+ *	can share it. A propagation can be bounded by known distances (see
+ *	\c SetDistanceBound) so that adding a start vertex only explores the
+ *	region it gets closer to.
+ *
+ *	Front overlap informations and stopping vertex of \c GW_GeodesicVertex
+ *	are not supported. If an heuristic callback is registered, vertex are
+ *	sorted according to distance+heuristic (A* like propagation).
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_CompactGeodesicMesh
+{
+
+public:
+
+	/** same values as GW_GeodesicVertex::T_GeodesicVertexState */
+	enum T_GeodesicVertexState
+	{
+		kFar,
+		kAlive,
+		kDead
+	};
+
+    /*------------------------------------------------------------------------------*/
+    /** \name Constructor and destructor */
+    /*------------------------------------------------------------------------------*/
+    //@{
+    GW_CompactGeodesicMesh( const GW_CompactMesh& Geometry );
+    virtual ~GW_CompactGeodesicMesh();
+    //@}
+
+    //-------------------------------------------------------------------------
+    /** \name Fast marching computations. */
+    //-------------------------------------------------------------------------
+	//@{
+	void ResetGeodesicMesh();
+	void AddStartVertex( GW_U32 nVert, GW_Float rDistance = 0 );
+	void PerformFastMarching();
+	void SetUpFastMarching();
+	GW_Bool PerformFastMarchingOneStep();
+	void PerformFastMarchingFlush();
+	GW_Bool IsFastMarchingFinished();
+    //@}
+
+    //-------------------------------------------------------------------------
+    /** \name Incremental propagation. */
+    //-------------------------------------------------------------------------
+	//@{
+	void SetWeight( const GW_Float* pWeight );
+	void SetDistanceBound( GW_Float* pBound );
+	void ResetTouchedVertex();
+	const std::vector<GW_Index>& GetTouchedVertex() const;
+	//@}
+
+	void SetUseUnfolding( GW_Bool bUseUnfolding );
+	GW_Bool GetUseUnfolding();
+
+    //-------------------------------------------------------------------------
+    /** \name Result of the propagation. */
+    //-------------------------------------------------------------------------
+	//@{
+	GW_Float GetDistance( GW_U32 nVert ) const;
+	T_GeodesicVertexState GetState( GW_U32 nVert ) const;
+	GW_Index GetFront( GW_U32 nVert ) const;
+	//@}
+
+    //-------------------------------------------------------------------------
+    /** \name Callback management. */
+    //-------------------------------------------------------------------------
+    //@{
+	typedef GW_Float (*T_WeightCallbackFunction)( GW_U32 nVert );
+	void RegisterWeightCallbackFunction( T_WeightCallbackFunction pFunc );
+	typedef GW_Bool (*T_FastMarchingCallbackFunction)( GW_U32 nVert );
+	void RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunction pFunc );
+	typedef void (*T_NewDeadVertexCallbackFunction)( GW_U32 nVert );
+	void RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunction pFunc );
+	typedef GW_Bool (*T_VertexInsersionCallbackFunction)( GW_U32 nVert, GW_Float rNewDist );
+	void RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunction pFunc );
+	typedef GW_Float (*T_HeuristicToGoalCallbackFunction)( GW_U32 nVert );
+	void RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc );
+	//@}
+
+	static GW_Float BasicWeightCallback( GW_U32 nVert );
+
+protected:
+
+	/** the mesh we propagate on */
+	const GW_CompactMesh* pGeometry_;
+	/** weight of each vertex, overrides WeightCallback_ */
+	const GW_Float* pWeight_;
+	/** known distances, may be shared between threads */
+	GW_Float* pDistanceBound_;
+	/** vertex that left the kFar state since the last reset */
+	std::vector<GW_Index> Touched_;
+
+	/** distance of each vertex to the front */
+	T_FloatVector Distance_;
+	/** T_GeodesicVertexState of each vertex */
+	std::vector<GW_U8> State_;
+	/** start vertex that reached each vertex, kNoIndex if none */
+	std::vector<GW_Index> Front_;
+
+	/** indexed binary heap of the alive vertex, ordered by HeapKey_ */
+	std::vector<GW_Index> Heap_;
+	T_FloatVector HeapKey_;
+	/** position of each vertex in the heap, kNoIndex if it is not in it */
+	std::vector<GW_Index> HeapPos_;
+
+	T_WeightCallbackFunction WeightCallback_;
+	T_FastMarchingCallbackFunction ForceStopCallback_;
+	T_NewDeadVertexCallbackFunction NewDeadVertexCallback_;
+	T_VertexInsersionCallbackFunction VertexInsersionCallback_;
+	T_HeuristicToGoalCallbackFunction HeuristicToGoalCallbackFunction_;
+
+	/** just to controle interactive mode */
+	GW_Bool bIsMarchingBegin_;
+	GW_Bool bIsMarchingEnd_;
+	/** Do we use unfolding to correct problem with non acute angles ? */
+	GW_Bool bUseUnfolding_;
+
+private:
+
+	GW_Float ComputeVertexDistance( GW_Index nHalfEdge, GW_Index nVert, GW_Index nVert1, GW_Index nVert2, GW_Index nFront );
+	GW_Index UnfoldTriangle( GW_Index nHalfEdge, GW_Index nVert, GW_Index nVert1, GW_Index nVert2,
+							 GW_Float& dist, GW_Float& dot1, GW_Float& dot2 ) const;
+	void UpdateNeighbor( GW_Index nNewVert, GW_Index nFront );
+
+	GW_Vector3D GetVector( GW_Index nVert ) const;
+	GW_Float GetHeapKey( GW_Index nVert );
+	void HeapPush( GW_Index nVert );
+	GW_Index HeapPop();
+	void HeapDecrease( GW_Index nVert );
+	void HeapSiftUp( GW_Index i, GW_Index nVert, GW_Float rKey );
+	void HeapSiftDown( GW_Index i, GW_Index nVert, GW_Float rKey );
+
+};
+
+
+} // End namespace GW
+
+#ifdef GW_USE_INLINE
+    #include "GW_CompactGeodesicMesh.inl"
+#endif
+
+
+#endif // _GW_COMPACTGEODESICMESH_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
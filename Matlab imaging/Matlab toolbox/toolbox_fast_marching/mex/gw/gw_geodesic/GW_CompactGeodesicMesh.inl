@@ -0,0 +1,321 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_CompactGeodesicMesh.inl
+ *  \brief  Inlined methods for \c GW_CompactGeodesicMesh
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#include "GW_CompactGeodesicMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh constructor
+/**
+ *  \param  Geometry [const GW_CompactMesh&] The mesh to propagate on.
+ *  \date   10-19-2026
+ *
+ *  Constructor. The mesh must outlive this object.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_CompactGeodesicMesh::GW_CompactGeodesicMesh( const GW_CompactMesh& Geometry )
+:	pGeometry_			( &Geometry ),
+	pWeight_			( NULL ),
+	pDistanceBound_		( NULL ),
+	WeightCallback_		( GW_CompactGeodesicMesh::BasicWeightCallback ),
+	ForceStopCallback_			( NULL ),
+	NewDeadVertexCallback_		( NULL ),
+	VertexInsersionCallback_	( NULL ),
+	HeuristicToGoalCallbackFunction_	( NULL ),
+	bIsMarchingBegin_			( GW_False ),
+	bIsMarchingEnd_				( GW_False ),
+	bUseUnfolding_				( GW_True )
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh destructor
+/**
+ *  \date   10-19-2026
+ *
+ *  Destructor.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_CompactGeodesicMesh::~GW_CompactGeodesicMesh()
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::BasicWeightCallback
+/**
+ *  \param  nVert [GW_U32] Current vertex.
+ *  \return [GW_Float] 1
+ *  \date   10-19-2026
+ *
+ *  Just the constant function = 1.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_CompactGeodesicMesh::BasicWeightCallback( GW_U32 /*nVert*/ )
+{
+	return 1;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetDistance
+/**
+ *  \param  nVert [GW_U32] The vertex.
+ *  \return [GW_Float] Its distance to the front.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_CompactGeodesicMesh::GetDistance( GW_U32 nVert ) const
+{
+	return Distance_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetState
+/**
+ *  \param  nVert [GW_U32] The vertex.
+ *  \return [T_GeodesicVertexState] Its state.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_CompactGeodesicMesh::T_GeodesicVertexState GW_CompactGeodesicMesh::GetState( GW_U32 nVert ) const
+{
+	return (T_GeodesicVertexState) State_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetFront
+/**
+ *  \param  nVert [GW_U32] The vertex.
+ *  \return [GW_Index] The start vertex that reached it, \c kNoIndex if none.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_CompactGeodesicMesh::GetFront( GW_U32 nVert ) const
+{
+	return Front_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::SetWeight
+/**
+ *  \param  pWeight [const GW_Float*] Weight of each vertex, NULL to use the callback.
+ *  \date   10-19-2026
+ *
+ *  Define the metric by an array instead of a callback.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::SetWeight( const GW_Float* pWeight )
+{
+	pWeight_ = pWeight;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::SetDistanceBound
+/**
+ *  \param  pBound [GW_Float*] Known distance of each vertex, NULL for none.
+ *  \date   10-19-2026
+ *
+ *  Only vertex whose new distance is smaller than the bound are explored,
+ *	and the bound is lowered to the distance of each new dead vertex.
+ *	The updates are atomic, so several propagations running on different
+ *	threads can share the same bound.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::SetDistanceBound( GW_Float* pBound )
+{
+	pDistanceBound_ = pBound;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetTouchedVertex
+/**
+ *  \return [const std::vector<GW_Index>&] The vertex.
+ *  \date   10-19-2026
+ *
+ *  The vertex reached since the last reset.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+const std::vector<GW_Index>& GW_CompactGeodesicMesh::GetTouchedVertex() const
+{
+	return Touched_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::RegisterWeightCallbackFunction
+/**
+ *  \param  pFunc [T_WeightCallbackFunction] The function.
+ *  \date   10-19-2026
+ *
+ *  Set the function used to define the metric on the mesh.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::RegisterWeightCallbackFunction( T_WeightCallbackFunction pFunc )
+{
+	GW_ASSERT( pFunc!=NULL );
+	WeightCallback_ = pFunc;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::RegisterForceStopCallbackFunction
+/**
+ *  \param  pFunc [T_FastMarchingCallbackFunction] The function.
+ *  \date   10-19-2026
+ *
+ *  Set the function used to test if we should end the fast marching or not.
+ *	The function return GW_True if the algorithm should be stopped.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunction pFunc )
+{
+	ForceStopCallback_ = pFunc;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::RegisterNewDeadVertexCallbackFunction
+/**
+ *  \param  pFunc [T_NewDeadVertexCallbackFunction] New function.
+ *  \date   10-19-2026
+ *
+ *  Set the function we use when a new dead vertex is set.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunction pFunc )
+{
+	NewDeadVertexCallback_ = pFunc;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::RegisterVertexInsersionCallbackFunction
+/**
+ *  \param  pFunc [T_VertexInsersionCallbackFunction] New function.
+ *  \date   10-19-2026
+ *
+ *  Set the function we use when trying to insert a new vertex.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunction pFunc )
+{
+	VertexInsersionCallback_ = pFunc;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::RegisterHeuristicToGoalCallbackFunction
+/**
+ *  \param  pFunc [T_HeuristicToGoalCallbackFunction] Callback function.
+ *  \date   10-19-2026
+ *
+ *  Turn the propagation into an A* like.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc )
+{
+	HeuristicToGoalCallbackFunction_ = pFunc;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::SetUseUnfolding
+/**
+ *  \param  bUseUnfolding [GW_Bool] Use it or not ?
+ *  \date   10-19-2026
+ *
+ *  Set wether to use or not the special handling of obtuse angles
+ *  via unfolding.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_CompactGeodesicMesh::SetUseUnfolding( GW_Bool bUseUnfolding )
+{
+	bUseUnfolding_ = bUseUnfolding;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetUseUnfolding
+/**
+ *  \return [GW_Bool] Answer.
+ *  \date   10-19-2026
+ *
+ *  Does the fast marching computations use unfolding of the obtuse angles ?
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Bool GW_CompactGeodesicMesh::GetUseUnfolding()
+{
+	return bUseUnfolding_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::IsFastMarchingFinished
+/**
+ *  \return [GW_Bool] Response.
+ *  \date   10-19-2026
+ *
+ *  Is the algorithm finished ?
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Bool GW_CompactGeodesicMesh::IsFastMarchingFinished()
+{
+	return bIsMarchingEnd_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetVector
+/**
+ *  \param  nVert [GW_Index] The vertex.
+ *  \return [GW_Vector3D] Its position.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Vector3D GW_CompactGeodesicMesh::GetVector( GW_Index nVert ) const
+{
+	const GW_Float* p = pGeometry_->GetPosition( nVert );
+	return GW_Vector3D( p[0], p[1], p[2] );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_CompactGeodesicMesh::GetHeapKey
+/**
+ *  \param  nVert [GW_Index] The vertex.
+ *  \return [GW_Float] Its priority in the heap.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_CompactGeodesicMesh::GetHeapKey( GW_Index nVert )
+{
+	if( HeuristicToGoalCallbackFunction_!=NULL )
+		return Distance_[nVert] + HeuristicToGoalCallbackFunction_( nVert );
+	return Distance_[nVert];
+}
+
+
+} // End namespace GW
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
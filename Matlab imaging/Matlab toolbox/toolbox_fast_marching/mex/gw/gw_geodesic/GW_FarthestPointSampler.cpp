@@ -0,0 +1,395 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FarthestPointSampler.cpp
+ *  \brief  Definition of class \c GW_FarthestPointSampler
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+
+#include "stdafx.h"
+#include "GW_FarthestPointSampler.h"
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#ifndef GW_USE_INLINE
+    #include "GW_FarthestPointSampler.inl"
+#endif
+
+using namespace GW;
+
+/** a vertex reached by a propagation, with its distance */
+struct GW_SampledVertex
+{
+	GW_Index nVert;
+	GW_Float rDistance;
+};
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler constructor
+/**
+ *  \param  Mesh [const GW_CompactMesh&] The mesh, with its connectivity built.
+ *  \date   10-19-2026
+ *
+ *  The mesh must outlive the sampler.
+ */
+/*------------------------------------------------------------------------------*/
+GW_FarthestPointSampler::GW_FarthestPointSampler( const GW_CompactMesh& Mesh )
+:	Mesh_		( Mesh ),
+	pWeight_	( NULL ),
+	rMinWeight_	( 1 ),
+	nNbrThreads_	( 0 )
+{
+	this->Reset();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler destructor
+/**
+ *  \date   10-19-2026
+ *
+ *  Destructor.
+ */
+/*------------------------------------------------------------------------------*/
+GW_FarthestPointSampler::~GW_FarthestPointSampler()
+{
+	for( size_t i=0; i<Propagation_.size(); ++i )
+		GW_DELETE( Propagation_[i] );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::Reset
+/**
+ *  \param  pConstraint [const GW_Float*] Upper bound on the distance of each vertex, or NULL.
+ *  \date   10-19-2026
+ *
+ *  Remove all the seeds. The distance map is initialized to the constraint,
+ *	so that the distance computed is min(constraint,distance to seeds).
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::Reset( const GW_Float* pConstraint )
+{
+	GW_U32 nNbrVertex = Mesh_.GetNbrVertex();
+	if( pConstraint==NULL )
+		Distance_.assign( nNbrVertex, GW_INFINITE );
+	else
+		Distance_.assign( pConstraint, pConstraint+nNbrVertex );
+	Voronoi_.assign( nNbrVertex, GW_CompactMesh::kNoIndex );
+	Seeds_.clear();
+	for( size_t i=0; i<Propagation_.size(); ++i )
+		Propagation_[i]->SetDistanceBound( nNbrVertex>0 ? &Distance_[0] : NULL );
+
+	/* every vertex is a candidate */
+	Heap_.resize( nNbrVertex );
+	HeapKey_.resize( nNbrVertex );
+	HeapPos_.resize( nNbrVertex );
+	for( GW_Index i=0; i<nNbrVertex; ++i )
+	{
+		Heap_[i] = i;
+		HeapKey_[i] = this->GetKey( i );
+		HeapPos_[i] = i;
+	}
+	for( GW_Index i=nNbrVertex/2; i>0; --i )
+		this->HeapSiftDown( i-1, Heap_[i-1], HeapKey_[i-1] );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::SetWeight
+/**
+ *  \param  pWeight [const GW_Float*] Weight of each vertex, NULL for a constant weight of 1.
+ *  \date   10-19-2026
+ *
+ *  The array must stay valid while seeds are added.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::SetWeight( const GW_Float* pWeight )
+{
+	pWeight_ = pWeight;
+	rMinWeight_ = 1;
+	if( pWeight!=NULL && Mesh_.GetNbrVertex()>0 )
+		rMinWeight_ = *std::min_element( pWeight, pWeight+Mesh_.GetNbrVertex() );
+	for( size_t i=0; i<Propagation_.size(); ++i )
+		Propagation_[i]->SetWeight( pWeight_ );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::AddSeed
+/**
+ *  \param  nVert [GW_U32] The new seed.
+ *  \date   10-19-2026
+ *
+ *  Update the distance map and the Voronoi diagram with a new seed.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::AddSeed( GW_U32 nVert )
+{
+	std::vector<GW_Index> NewSeeds( 1, (GW_Index) nVert );
+	this->AddSeeds( NewSeeds );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::AddSeeds
+/**
+ *  \param  NewSeeds [std::vector<GW_Index>&] The new seeds.
+ *  \date   10-19-2026
+ *
+ *  Propagate from each new seed in parallel, each propagation being bounded
+ *	by the shared distance map, then assign the vertex whose distance has
+ *	decreased to the seed that reached them first.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::AddSeeds( const std::vector<GW_Index>& NewSeeds )
+{
+	GW_I32 nNbrSeeds = (GW_I32) NewSeeds.size();
+	if( nNbrSeeds==0 )
+		return;
+	GW_I32 nNbrThreads = 1;
+#ifdef _OPENMP
+	nNbrThreads = nNbrThreads_>0 ? nNbrThreads_ : omp_get_max_threads();
+#endif
+	nNbrThreads = GW_MIN( nNbrThreads, nNbrSeeds );
+
+	/* each propagation is reset once, then only on the vertex it reached */
+	while( (GW_I32) Propagation_.size()<nNbrThreads )
+	{
+		GW_CompactGeodesicMesh* pPropagation = new GW_CompactGeodesicMesh( Mesh_ );
+		pPropagation->ResetGeodesicMesh();
+		pPropagation->SetWeight( pWeight_ );
+		pPropagation->SetDistanceBound( &Distance_[0] );
+		Propagation_.push_back( pPropagation );
+	}
+
+	std::vector< std::vector<GW_SampledVertex> > Reached( nNbrSeeds );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) schedule(dynamic,1)
+#endif
+	for( GW_I32 i=0; i<nNbrSeeds; ++i )
+	{
+	#ifdef _OPENMP
+		GW_CompactGeodesicMesh* pPropagation = Propagation_[omp_get_thread_num()];
+	#else
+		GW_CompactGeodesicMesh* pPropagation = Propagation_[0];
+	#endif
+		pPropagation->AddStartVertex( NewSeeds[i], 0 );
+		pPropagation->PerformFastMarching();
+		const std::vector<GW_Index>& Touched = pPropagation->GetTouchedVertex();
+		for( size_t k=0; k<Touched.size(); ++k )
+		{
+			GW_Index nVert = Touched[k];
+			if( pPropagation->GetState(nVert)==GW_CompactGeodesicMesh::kDead )
+			{
+				GW_SampledVertex v = { nVert, pPropagation->GetDistance(nVert) };
+				Reached[i].push_back( v );
+			}
+		}
+		pPropagation->ResetTouchedVertex();
+	}
+
+	/* the shared map holds the minimum over all the propagations */
+	for( GW_I32 i=0; i<nNbrSeeds; ++i )
+	{
+		GW_Index nSeed = (GW_Index) Seeds_.size();
+		Seeds_.push_back( NewSeeds[i] );
+		for( size_t k=0; k<Reached[i].size(); ++k )
+		{
+			GW_Index nVert = Reached[i][k].nVert;
+			if( Reached[i][k].rDistance==Distance_[nVert] )
+			{
+				Voronoi_[nVert] = nSeed;
+				this->HeapUpdate( nVert );
+			}
+		}
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::AddFarthestSeeds
+/**
+ *  \param  nNbrSeeds [GW_U32] Number of seeds to add.
+ *  \param  nBatchSize [GW_U32] Maximum number of seeds propagated together.
+ *  \date   10-19-2026
+ *
+ *  Farthest point sampling : each new seed is the vertex the farthest from
+ *	the previous ones. With a batch size of 1 this is the exact greedy
+ *	sampling, otherwise see \c SelectBatch.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::AddFarthestSeeds( GW_U32 nNbrSeeds, GW_U32 nBatchSize )
+{
+	std::vector<GW_Index> NewSeeds;
+	GW_U32 nNbrAdded = 0;
+	while( nNbrAdded<nNbrSeeds )
+	{
+		this->SelectBatch( GW_MIN( GW_MAX(nBatchSize,(GW_U32) 1), nNbrSeeds-nNbrAdded ), NewSeeds );
+		if( NewSeeds.empty() )
+			break;
+		this->AddSeeds( NewSeeds );
+		nNbrAdded += (GW_U32) NewSeeds.size();
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::SelectBatch
+/**
+ *  \param  nBatchSize [GW_U32] Maximum number of seeds.
+ *  \param  NewSeeds [std::vector<GW_Index>&] The seeds selected.
+ *  \date   10-19-2026
+ *
+ *  Take the farthest vertex, at distance R, then the next farthest ones as
+ *	long as they are at distance at least R/2 and at euclidean distance more
+ *	than 2R/min(W) from the seeds already selected : their new Voronoi cells
+ *	have a radius less than R, so the propagations do not compete.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::SelectBatch( GW_U32 nBatchSize, std::vector<GW_Index>& NewSeeds )
+{
+	NewSeeds.clear();
+	if( Heap_.empty() )
+		return;
+	GW_Float R = HeapKey_[0];
+	GW_Float rMinDist2 = 2*R/rMinWeight_;
+	rMinDist2 = rMinDist2*rMinDist2;
+
+	std::vector<GW_Index> Popped;
+	size_t nMaxPop = 16*(size_t) nBatchSize;
+	while( NewSeeds.size()<nBatchSize && Popped.size()<nMaxPop && !Heap_.empty() )
+	{
+		if( !NewSeeds.empty() && (R<=0 || HeapKey_[0]<R/2) )
+			break;
+		GW_Index nVert = this->HeapPop();
+		Popped.push_back( nVert );
+		const GW_Float* p = Mesh_.GetPosition( nVert );
+		GW_Bool bIsFarEnough = GW_True;
+		for( size_t k=0; k<NewSeeds.size() && bIsFarEnough; ++k )
+		{
+			const GW_Float* q = Mesh_.GetPosition( NewSeeds[k] );
+			GW_Float rDist2 = (p[0]-q[0])*(p[0]-q[0]) + (p[1]-q[1])*(p[1]-q[1]) + (p[2]-q[2])*(p[2]-q[2]);
+			bIsFarEnough = rDist2>rMinDist2;
+		}
+		if( bIsFarEnough )
+			NewSeeds.push_back( nVert );
+	}
+
+	/* the distances are updated when the seeds are added */
+	for( size_t k=0; k<Popped.size(); ++k )
+		this->HeapPush( Popped[k] );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::HeapUpdate
+/**
+ *  \param  nVert [GW_Index] A vertex whose distance has changed.
+ *  \date   10-19-2026
+ *
+ *  The distance of a vertex only decreases, but a constraint set by
+ *	\c Reset can be above it, so both directions are handled.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::HeapUpdate( GW_Index nVert )
+{
+	GW_Index i = HeapPos_[nVert];
+	if( i==GW_CompactMesh::kNoIndex )
+		return;
+	GW_Float rKey = this->GetKey( nVert );
+	if( rKey>HeapKey_[i] )
+		this->HeapSiftUp( i, nVert, rKey );
+	else
+		this->HeapSiftDown( i, nVert, rKey );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::HeapSiftUp
+/**
+ *  \param  i [GW_Index] Position of the hole.
+ *  \param  nVert [GW_Index] Vertex to put in the hole.
+ *  \param  rKey [GW_Float] Its key.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::HeapSiftUp( GW_Index i, GW_Index nVert, GW_Float rKey )
+{
+	while( i>0 )
+	{
+		GW_Index nParent = (i-1)/2;
+		if( HeapKey_[nParent]>=rKey )
+			break;
+		Heap_[i] = Heap_[nParent];
+		HeapKey_[i] = HeapKey_[nParent];
+		HeapPos_[Heap_[i]] = i;
+		i = nParent;
+	}
+	Heap_[i] = nVert;
+	HeapKey_[i] = rKey;
+	HeapPos_[nVert] = i;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::HeapSiftDown
+/**
+ *  \param  i [GW_Index] Position of the hole.
+ *  \param  nVert [GW_Index] Vertex to put in the hole.
+ *  \param  rKey [GW_Float] Its key.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::HeapSiftDown( GW_Index i, GW_Index nVert, GW_Float rKey )
+{
+	GW_Index nSize = (GW_Index) Heap_.size();
+	while( 2*i+1<nSize )
+	{
+		GW_Index nChild = 2*i+1;
+		if( nChild+1<nSize && HeapKey_[nChild+1]>HeapKey_[nChild] )
+			nChild++;
+		if( rKey>=HeapKey_[nChild] )
+			break;
+		Heap_[i] = Heap_[nChild];
+		HeapKey_[i] = HeapKey_[nChild];
+		HeapPos_[Heap_[i]] = i;
+		i = nChild;
+	}
+	Heap_[i] = nVert;
+	HeapKey_[i] = rKey;
+	HeapPos_[nVert] = i;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::HeapPush
+/**
+ *  \param  nVert [GW_Index] The vertex.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FarthestPointSampler::HeapPush( GW_Index nVert )
+{
+	Heap_.push_back( nVert );
+	HeapKey_.push_back( 0 );
+	this->HeapSiftUp( (GW_Index) Heap_.size()-1, nVert, this->GetKey(nVert) );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::HeapPop
+/**
+ *  \return [GW_Index] The vertex the farthest from the seeds.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_Index GW_FarthestPointSampler::HeapPop()
+{
+	GW_Index nTop = Heap_.front();
+	HeapPos_[nTop] = GW_CompactMesh::kNoIndex;
+	GW_Index nLast = Heap_.back();
+	GW_Float rLastKey = HeapKey_.back();
+	Heap_.pop_back();
+	HeapKey_.pop_back();
+	if( !Heap_.empty() )
+		this->HeapSiftDown( 0, nLast, rLastKey );
+	return nTop;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
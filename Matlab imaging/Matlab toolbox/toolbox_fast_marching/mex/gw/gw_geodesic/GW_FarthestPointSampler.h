@@ -0,0 +1,124 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FarthestPointSampler.h
+ *  \brief  Definition of class \c GW_FarthestPointSampler
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_FARTHESTPOINTSAMPLER_H_
+#define _GW_FARTHESTPOINTSAMPLER_H_
+
+#include "../gw_core/GW_Config.h"
+#include "../gw_core/GW_CompactMesh.h"
+#include "GW_CompactGeodesicMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_FarthestPointSampler
+ *  \brief  Incremental farthest point sampling and geodesic Voronoi diagram.
+ *  \date   10-19-2026
+ *
+ *  Keeps the distance of each vertex to the nearest seed and the Voronoi
+ *	cell it belongs to. When a seed is added, the fast marching from this
+ *	seed is bounded by the current distances, so only the new Voronoi cell
+ *	(and its border) is explored, and only the vertex it reached are reset
+ *	afterward. The farthest vertex is maintained in a max heap.
+ *
+ *	In batch mode, several seeds are added at once and propagated on
+ *	different threads, sharing the distance map through lock free atomic
+ *	updates. The seeds of a batch are taken among the farthest vertex,
+ *	their distance must be at least half of the largest one, and they must
+ *	be far enough apart that their new cells cannot overlap. This is an
+ *	approximation of the sequential sampling, which it gives for a batch
+ *	of size 1.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_FarthestPointSampler
+{
+
+public:
+
+    /*------------------------------------------------------------------------------*/
+    /** \name Constructor and destructor */
+    /*------------------------------------------------------------------------------*/
+    //@{
+    GW_FarthestPointSampler( const GW_CompactMesh& Mesh );
+    virtual ~GW_FarthestPointSampler();
+    //@}
+
+	void Reset( const GW_Float* pConstraint = NULL );
+	void SetWeight( const GW_Float* pWeight );
+	void SetNbrThreads( GW_I32 nNbrThreads );
+
+	//-------------------------------------------------------------------------
+    /** \name Sampling. */
+    //-------------------------------------------------------------------------
+    //@{
+	void AddSeed( GW_U32 nVert );
+	void AddSeeds( const std::vector<GW_Index>& NewSeeds );
+	void AddFarthestSeeds( GW_U32 nNbrSeeds, GW_U32 nBatchSize = 1 );
+	GW_Index GetFarthestVertex() const;
+    //@}
+
+	//-------------------------------------------------------------------------
+    /** \name Results. */
+    //-------------------------------------------------------------------------
+    //@{
+	GW_U32 GetNbrSeeds() const;
+	GW_Index GetSeed( GW_U32 nNum ) const;
+	GW_Float GetDistance( GW_U32 nVert ) const;
+	GW_Index GetVoronoi( GW_U32 nVert ) const;
+    //@}
+
+private:
+
+	GW_Float GetKey( GW_Index nVert ) const;
+	void HeapUpdate( GW_Index nVert );
+	void HeapPush( GW_Index nVert );
+	GW_Index HeapPop();
+	void HeapSiftUp( GW_Index i, GW_Index nVert, GW_Float rKey );
+	void HeapSiftDown( GW_Index i, GW_Index nVert, GW_Float rKey );
+	void SelectBatch( GW_U32 nBatchSize, std::vector<GW_Index>& NewSeeds );
+
+	/** the mesh we sample */
+	const GW_CompactMesh& Mesh_;
+	/** distance to the nearest seed, shared by the propagations */
+	T_FloatVector Distance_;
+	/** number of the nearest seed, kNoIndex if not reached */
+	std::vector<GW_Index> Voronoi_;
+	/** the seeds, in order of insertion */
+	std::vector<GW_Index> Seeds_;
+	/** weight of each vertex, NULL for 1 */
+	const GW_Float* pWeight_;
+	GW_Float rMinWeight_;
+	GW_I32 nNbrThreads_;
+	/** one propagation per thread */
+	std::vector<GW_CompactGeodesicMesh*> Propagation_;
+
+	/** max heap of the vertex ordered by GetKey */
+	std::vector<GW_Index> Heap_;
+	T_FloatVector HeapKey_;
+	std::vector<GW_Index> HeapPos_;
+
+};
+
+
+} // End namespace GW
+
+#ifdef GW_USE_INLINE
+    #include "GW_FarthestPointSampler.inl"
+#endif
+
+
+#endif // _GW_FARTHESTPOINTSAMPLER_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FarthestPointSampler.inl
+ *  \brief  Inlined methods for \c GW_FarthestPointSampler
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#include "GW_FarthestPointSampler.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::SetNbrThreads
+/**
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_FarthestPointSampler::SetNbrThreads( GW_I32 nNbrThreads )
+{
+	nNbrThreads_ = nNbrThreads;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetNbrSeeds
+/**
+ *  \return [GW_U32] The number.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_U32 GW_FarthestPointSampler::GetNbrSeeds() const
+{
+	return (GW_U32) Seeds_.size();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetSeed
+/**
+ *  \param  nNum [GW_U32] Number of the seed.
+ *  \return [GW_Index] Its vertex.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_FarthestPointSampler::GetSeed( GW_U32 nNum ) const
+{
+	return Seeds_[nNum];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetDistance
+/**
+ *  \param  nVert [GW_U32] The vertex.
+ *  \return [GW_Float] Its distance to the nearest seed.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_FarthestPointSampler::GetDistance( GW_U32 nVert ) const
+{
+	return Distance_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetVoronoi
+/**
+ *  \param  nVert [GW_U32] The vertex.
+ *  \return [GW_Index] Number of its nearest seed, kNoIndex if not reached.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_FarthestPointSampler::GetVoronoi( GW_U32 nVert ) const
+{
+	return Voronoi_[nVert];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetFarthestVertex
+/**
+ *  \return [GW_Index] The vertex the farthest from the seeds.
+ *  \date   10-19-2026
+ *
+ *  Vertex not reached by the seeds count as distance 0.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Index GW_FarthestPointSampler::GetFarthestVertex() const
+{
+	return Heap_.empty() ? GW_CompactMesh::kNoIndex : Heap_.front();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FarthestPointSampler::GetKey
+/**
+ *  \param  nVert [GW_Index] The vertex.
+ *  \return [GW_Float] Its priority in the heap.
+ *  \date   10-19-2026
+ *
+ *  The distance, clamped to \c GW_INFINITE for the vertex no seed can
+ *	reach, so that a component without seed is sampled first.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_FarthestPointSampler::GetKey( GW_Index nVert ) const
+{
+	GW_Float d = Distance_[nVert];
+	return d>=GW_INFINITE ? GW_INFINITE : d;
+}
+
+
+} // End namespace GW
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -115,6 +115,9 @@ protected:
 
 private:
 
+	/** shares the update formulas */
+	friend class GW_CompactGeodesicMesh;
+
 	GW_Float ComputeVertexDistance( GW_GeodesicFace& CurrentFace, GW_GeodesicVertex& CurrentVertex, 
 									GW_GeodesicVertex& Vert1, GW_GeodesicVertex& Vert2, GW_GeodesicVertex& CurrentFront );
 
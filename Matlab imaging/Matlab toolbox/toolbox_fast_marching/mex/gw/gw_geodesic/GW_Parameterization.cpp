@@ -797,6 +797,172 @@ void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrix& K )
 	}
 }
 
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ComputeCotan
+/**
+ *  \param  Verti [GW_Vertex&] First vertex of the edge.
+ *  \param  Vertj [GW_Vertex&] Second vertex of the edge.
+ *  \param  Vertk [GW_Vertex&] Opposite vertex.
+ *  \return [GW_Float] Cotangent of the angle at the opposite vertex.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_Float GW_Parameterization::ComputeCotan( GW_Vertex& Verti, GW_Vertex& Vertj, GW_Vertex& Vertk )
+{
+	GW_Vector3D e1 = Verti.GetPosition()-Vertk.GetPosition();	e1.Normalize();
+	GW_Vector3D e2 = Vertj.GetPosition()-Vertk.GetPosition();	e2.Normalize();
+	GW_Float dot = e1*e2;
+	if( dot==1 )
+		return 0;
+	return dot/sqrt(1-dot*dot);
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ComputeConformalRow
+/**
+ *  \param  Vert [GW_Vertex&] The vertex.
+ *  \param  pRow [GW_SparseMatrixCSR::GW_Triplet*] The entries of its row, room for GetNumberNeighbor()+1.
+ *  \return [GW_U32] The number of entries.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_U32 GW_Parameterization::ComputeConformalRow( GW_Vertex& Vert, GW_SparseMatrixCSR::GW_Triplet* pRow )
+{
+	GW_U32 i = Vert.GetID();
+	GW_U32 n = 0;
+	GW_Float rTotalWeight = 0;
+	for( GW_VertexIterator it = Vert.BeginVertexIterator(); it!=Vert.EndVertexIterator(); ++it )
+	{
+		GW_Vertex* pVertj = *it; GW_ASSERT( pVertj!=NULL );
+		GW_Vertex* pVertL = it.GetLeftVertex();
+		GW_Vertex* pVertR = it.GetRightVertex();
+		GW_Float rVal = 0;
+		if( pVertL!=NULL )
+			rVal += GW_Parameterization::ComputeCotan( Vert, *pVertj, *pVertL );
+		if( pVertR!=NULL )
+			rVal += GW_Parameterization::ComputeCotan( Vert, *pVertj, *pVertR );
+		pRow[n].nRow = i;
+		pRow[n].nCol = pVertj->GetID();
+		pRow[n].rVal = rVal;
+		n++;
+		rTotalWeight += rVal;
+	}
+	if( rTotalWeight==0 )		// should not happen
+		return GW_Parameterization::ComputeTutteRow( Vert, pRow );
+	pRow[n].nRow = i;
+	pRow[n].nCol = i;
+	pRow[n].rVal = -rTotalWeight;
+	return n+1;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ComputeTutteRow
+/**
+ *  \param  Vert [GW_Vertex&] The vertex.
+ *  \param  pRow [GW_SparseMatrixCSR::GW_Triplet*] The entries of its row, room for GetNumberNeighbor()+1.
+ *  \return [GW_U32] The number of entries.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_U32 GW_Parameterization::ComputeTutteRow( GW_Vertex& Vert, GW_SparseMatrixCSR::GW_Triplet* pRow )
+{
+	GW_U32 i = Vert.GetID();
+	GW_U32 nNeigSize_i = Vert.GetNumberNeighbor();
+	GW_U32 n = 0;
+	GW_Float rTotalWeight = 0;
+	for( GW_VertexIterator it = Vert.BeginVertexIterator(); it!=Vert.EndVertexIterator(); ++it )
+	{
+		GW_Vertex* pVertj = *it; GW_ASSERT( pVertj!=NULL );
+		GW_U32 nNeigSize_j = pVertj->GetNumberNeighbor();
+		GW_Float rVal = 1.0/sqrt( (GW_Float) nNeigSize_i*nNeigSize_j );
+		pRow[n].nRow = i;
+		pRow[n].nCol = pVertj->GetID();
+		pRow[n].rVal = rVal;
+		n++;
+		rTotalWeight += rVal;
+	}
+	pRow[n].nRow = i;
+	pRow[n].nCol = i;
+	pRow[n].rVal = -rTotalWeight;
+	return n+1;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::BuildMatrixFromRows
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh.
+ *  \param  K [GW_SparseMatrixCSR&] The matrix, one row per vertex.
+ *  \param  pRowFunc [T_RowFunction] Compute the row of a vertex.
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ *
+ *  The room of each row is known from the valence of the vertex, so the
+ *	rows are computed in parallel, each thread writing in its own part of
+ *	the triplet list.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::BuildMatrixFromRows( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, T_RowFunction pRowFunc, GW_I32 nNbrThreads )
+{
+	GW_I32 p = (GW_I32) Mesh.GetNbrVertex();
+	/* room for each row */
+	std::vector<GW_U32> RowStart(p+1,0);
+	for( GW_I32 i=0; i<p; ++i )
+	{
+		GW_Vertex* pVert = Mesh.GetVertex(i);	GW_ASSERT( pVert!=NULL );
+		RowStart[i+1] = RowStart[i] + pVert->GetNumberNeighbor()+1;
+	}
+	GW_SparseMatrixCSR::T_TripletVector Triplets( RowStart[p] );
+	std::vector<GW_U32> RowSize(p,0);
+	/* fill each row */
+#ifdef _OPENMP
+	if( nNbrThreads<=0 )
+		nNbrThreads = omp_get_max_threads();
+	#pragma omp parallel for num_threads(nNbrThreads) schedule(dynamic,256)
+#endif
+	for( GW_I32 i=0; i<p; ++i )
+	{
+		GW_Vertex* pVert = Mesh.GetVertex(i);
+		RowSize[i] = pRowFunc( *pVert, &Triplets[RowStart[i]] );
+		GW_ASSERT( RowSize[i]<=RowStart[i+1]-RowStart[i] );
+	}
+	/* remove the unused room */
+	GW_U32 n = 0;
+	for( GW_I32 i=0; i<p; ++i )
+	for( GW_U32 k=0; k<RowSize[i]; ++k )
+		Triplets[n++] = Triplets[RowStart[i]+k];
+	Triplets.resize( n );
+	K.SetNbrThreads( nNbrThreads );
+	K.BuildFromTriplets( p, Triplets );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::BuildConformalMatrix
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh.
+ *  \param  K [GW_SparseMatrixCSR&] The cotangent weight matrix.
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::BuildConformalMatrix( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_I32 nNbrThreads )
+{
+	GW_Parameterization::BuildMatrixFromRows( Mesh, K, GW_Parameterization::ComputeConformalRow, nNbrThreads );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::BuildTutteMatrix
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh.
+ *  \param  K [GW_SparseMatrixCSR&] The Tutte weight matrix.
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::BuildTutteMatrix( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_I32 nNbrThreads )
+{
+	GW_Parameterization::BuildMatrixFromRows( Mesh, K, GW_Parameterization::ComputeTutteRow, nNbrThreads );
+}
+
 void GW_Parameterization::ResolutionSpectral( GW_MatrixNxP& K, GW_MatrixNxP& L, GW_U32 EIG )
 {
 	GW_U32 p = L.GetNbrCols();
@@ -936,37 +1102,7 @@ void GW_Parameterization::ResolutionBoundaryFree( GW_Mesh& Mesh, GW_SparseMatrix
 			/* we must adjust the corresponding row */
 			GW_Vertex* pVert1 = NULL;
 			GW_Vertex* pVert2 = NULL;
-			/* special case for boundary vertices : must turn IN CLOUNTERCLOCKWISE sense */
-			GW_Face* pFace = pVert->GetFace();	GW_ASSERT( pFace!=NULL );
-			// first find FIRST boundary vertex
-			GW_Face* pStartFace = pFace;
-			GW_Vertex* pDirVertex = pFace->GetNextVertex(*pVert);	GW_ASSERT( pDirVertex!=NULL );
-			pDirVertex = pFace->GetNextVertex(*pDirVertex);			GW_ASSERT( pDirVertex!=NULL );
-			GW_U32 num = 0;
-			while( pFace->GetFaceNeighbor(*pDirVertex)!=NULL && num<100 )
-			{
-				num++;
-				GW_Face* pPrevFace = pFace;
-				pFace = pFace->GetFaceNeighbor(*pDirVertex);
-				pDirVertex = pPrevFace->GetVertex(*pVert,*pDirVertex);	GW_ASSERT(pDirVertex!=NULL);
-			}
-			GW_ASSERT( num<100 );
-			//	GW_ASSERT( pFace!=pStartFace || pStartFace->GetFaceNeighbor(*pDirVertex)!=NULL );
-			pVert1 = pFace->GetVertex(*pVert,*pDirVertex);	GW_ASSERT(pVert1!=NULL);
-			// then find LAST vertex
-			pDirVertex = pVert1;
-			num = 0;
-			while( pFace->GetFaceNeighbor(*pDirVertex)!=NULL && num<100 ) 
-			{
-				num++;
-				GW_Face* pPrevFace = pFace;
-				pFace = pFace->GetFaceNeighbor(*pDirVertex);
-				pDirVertex = pPrevFace->GetVertex(*pVert,*pDirVertex);	GW_ASSERT(pDirVertex!=NULL);
-			}
-			GW_ASSERT( num<100 );
-			//	GW_ASSERT( pFace!=pStartFace || pStartFace->GetFaceNeighbor(*pDirVertex)!=NULL );
-			pVert2 = pFace->GetVertex(*pVert,*pDirVertex);	GW_ASSERT(pVert2!=NULL);
-			GW_ASSERT( pVert1!=NULL && pVert2!=NULL );
+			GW_Parameterization::GetBoundaryNeighbors( *pVert, pVert1, pVert2 );
 			GW_Float epsilon = 1;
 			/* X coords **********************************/
 			K1.SetData( i,pVert1->GetID()+p, +epsilon );		// add a constraint on -Y coordinate
@@ -984,28 +1120,7 @@ void GW_Parameterization::ResolutionBoundaryFree( GW_Mesh& Mesh, GW_SparseMatrix
 
 	/* add two more constraints : choose them as far as possible from one another */
 	GW_Vertex* pVert[2];
-	if( M!=NULL )	// use farthest vertices
-	{
-		GW_U32 i_max = 0, j_max = 0;
-		GW_Float dist_max = 0;
-		for( GW_U32 i=0; i<p; ++i )
-		for( GW_U32 j=0; j<i; ++j )
-		{
-			if( M->GetData(i,j)>dist_max )
-			{
-				dist_max = M->GetData(i,j);
-				i_max = i; j_max = j;
-			}
-		}
-		pVert[0] = Mesh.GetVertex(i_max);
-		pVert[1] = Mesh.GetVertex(j_max);
-	}
-	else
-	{
-		// use random
-		pVert[0] = Mesh.GetRandomVertex();
-		pVert[1] = Mesh.GetRandomVertex();
-	}
+	GW_Parameterization::ChooseFixedVertex( Mesh, M, pVert );
 
 	GW_Vector2D arbitrary_pos[2] = { GW_Vector2D(-2.5,0), GW_Vector2D(2.5,0) };
 	for( GW_U32 k=0; k<2; ++k )
@@ -1054,6 +1169,290 @@ void GW_Parameterization::ResolutionBoundaryFree( GW_Mesh& Mesh, GW_SparseMatrix
 void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrix& K, GW_MatrixNxP&  L, 
 								T_Vector2DMap* pInitialPos, T_TrissectorInfoMap* pTrissectorInfoMap, 
 								T_TrissectorInfoVector* pCyclicPosition )
+{
+	T_Vector2DMap Positions;	// position of boundary points
+	if( !GW_Parameterization::ComputeBoundaryPosition( Mesh, Positions, pInitialPos, pTrissectorInfoMap, pCyclicPosition ) )
+		return;
+	/* set up the new matrix ****************************************************/
+	GW_U32 p = Mesh.GetNbrVertex();
+	for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
+	{
+		GW_U32 i = it->first;
+		K.SetRowSize(i,0);
+		K.SetRowSize(i,1);
+		K.SetData(i,i,1);
+	}
+
+	/* solve the system *********************************************************/
+	GW_VectorND x(p, GW_Float(0));	// solution
+	for( GW_U32 coord = 0; coord<2; ++coord )
+	{
+		/* build RHS */
+		GW_VectorND b(p, GW_Float(0));	// rhs
+		for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
+		{
+			GW_U32 i = it->first;
+			GW_Vector2D	pos = it->second;
+			b.SetData(i, pos[coord]);
+		}
+
+		/* solve system */
+		cout << "  * System resolution.";
+		GW_Parameterization::SolveSystem( K, x, b );
+
+		for( GW_U32 j=0; j<p; ++j )
+			L.SetData(coord,j, x.GetData(j) );
+	}
+}
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionBoundaryFree
+/**
+ *  \param  Mesh [GW_Mesh&] The coarse mesh to flatten.
+ *  \param  K [GW_SparseMatrixCSR&] The weight matrix for the flattening.
+ *  \param  L [GW_MatrixNxP&] The position of the vertices, used as initial guess.
+ *  \param  M [GW_MatrixNxP*] The distance matrix.
+ *  \date   10-19-2026
+ * 
+ *  Same as the \c GW_SparseMatrix version, solved with a preconditioned
+ *	BiCGSTAB (the boundary constraints make the system non symmetric).
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionBoundaryFree( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, GW_MatrixNxP* M )
+{
+	GW_U32 p = Mesh.GetNbrVertex();
+	GW_ASSERT( K.GetDim()==p );
+
+	GW_OutputComment("Building the boundary free matrix.");
+	GW_SparseMatrixCSR::T_TripletVector Triplets;
+	Triplets.reserve( 2*K.GetNbrNonZero() + 8*p );
+	for( GW_U32 i=0; i<p; ++i )
+	{
+		/* set up X and Y line : make a copy */
+		for( GW_U32 entry=0; entry<K.GetRowSize(i); ++entry )
+		{
+			GW_SparseMatrixCSR::GW_Triplet t;
+			t.rVal = K.AccessEntry( i, entry, t.nCol );
+			t.nRow = i;
+			Triplets.push_back( t );
+			t.nRow += p;	t.nCol += p;
+			Triplets.push_back( t );
+		}
+		/* special constraint for boundary */
+		GW_Vertex* pVert = Mesh.GetVertex(i);	GW_ASSERT( pVert!=NULL );
+		if( pVert->IsBoundaryVertex() )
+		{
+			GW_Vertex* pVert1 = NULL;
+			GW_Vertex* pVert2 = NULL;
+			GW_Parameterization::GetBoundaryNeighbors( *pVert, pVert1, pVert2 );
+			GW_Float epsilon = 1;
+			GW_SparseMatrixCSR::GW_Triplet t;
+			/* X coords **********************************/
+			t.nRow = i;		t.nCol = pVert1->GetID()+p;	t.rVal = +epsilon;	Triplets.push_back( t );
+			t.nRow = i;		t.nCol = pVert2->GetID()+p;	t.rVal = -epsilon;	Triplets.push_back( t );
+			/* Y coords **********************************/
+			t.nRow = i+p;	t.nCol = pVert1->GetID();	t.rVal = -epsilon;	Triplets.push_back( t );
+			t.nRow = i+p;	t.nCol = pVert2->GetID();	t.rVal = +epsilon;	Triplets.push_back( t );
+		}
+	}
+	GW_SparseMatrixCSR K1;
+	K1.BuildFromTriplets( 2*p, Triplets );
+
+	/* add two more constraints : choose them as far as possible from one another */
+	GW_Vertex* pVert[2];
+	GW_Parameterization::ChooseFixedVertex( Mesh, M, pVert );
+	GW_Vector2D arbitrary_pos[2] = { GW_Vector2D(-2.5,0), GW_Vector2D(2.5,0) };
+	std::vector<GW_Float> x0(2*p, 0);		// fixed values
+	std::vector<GW_Bool> bFixed(2*p, GW_False);
+	for( GW_U32 k=0; k<2; ++k )
+	{
+		GW_U32 i = pVert[k]->GetID();
+		x0[i]	= arbitrary_pos[k][0];
+		x0[i+p]	= arbitrary_pos[k][1];
+		bFixed[i] = bFixed[i+p] = GW_True;
+	}
+
+	/* move the fixed values to the rhs */
+	std::vector<GW_Float> b(2*p);	// rhs
+	std::vector<GW_Float> x(2*p);	// solution
+	K1.Multiply( &x0[0], &b[0] );
+	for( GW_U32 i=0; i<2*p; ++i )
+	{
+		b[i] = bFixed[i] ? x0[i] : -b[i];
+		x[i] = bFixed[i] ? x0[i] : L.GetData( i/p, i%p );
+	}
+	K1.ConstrainVariables( bFixed );
+
+	cout << "  * System resolution.";
+	GW_U32 nNbrIter = 0;
+	GW_Float err = K1.SolveBiCGSTAB( &x[0], &b[0], &nNbrIter );
+	cout << " " << nNbrIter << " iterations, residual " << err << "." << endl;
+
+	for( GW_U32 j=0; j<p; ++j )
+	{
+		L.SetData(0,j, x[j] );
+		L.SetData(1,j, x[j+p] );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ResolutionBoundaryFixed
+/**
+ *  \param  Mesh [GW_Mesh&] The coarse mesh to flatten.
+ *  \param  K [GW_SparseMatrixCSR&] The weight matrix for the flattening, modified.
+ *  \param  L [GW_MatrixNxP&] The position of the vertices, used as initial guess.
+ *  \date   10-19-2026
+ * 
+ *  Same as the \c GW_SparseMatrix version. The fixed vertex are moved to
+ *	the right hand side so that the system stays symmetric, and is solved
+ *	with a preconditioned conjugate gradient. The preconditioner is shared
+ *	by the X and Y coordinates.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, 
+								T_Vector2DMap* pInitialPos, T_TrissectorInfoMap* pTrissectorInfoMap, 
+								T_TrissectorInfoVector* pCyclicPosition )
+{
+	T_Vector2DMap Positions;	// position of boundary points
+	if( !GW_Parameterization::ComputeBoundaryPosition( Mesh, Positions, pInitialPos, pTrissectorInfoMap, pCyclicPosition ) )
+		return;
+	GW_U32 p = Mesh.GetNbrVertex();
+	GW_ASSERT( K.GetDim()==p );
+	/* the weight matrix is negative, make it positive for the CG */
+	K.Scale( -1 );
+
+	std::vector<GW_Bool> bFixed(p, GW_False);
+	for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
+		bFixed[it->first] = GW_True;
+	/* build RHS, the fixed values are moved to the rhs */
+	std::vector<GW_Float> x0(p), b[2];
+	for( GW_U32 coord = 0; coord<2; ++coord )
+	{
+		std::fill( x0.begin(), x0.end(), 0 );
+		for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
+			x0[it->first] = it->second[coord];
+		b[coord].resize(p);
+		K.Multiply( &x0[0], &b[coord][0] );
+		for( GW_U32 i=0; i<p; ++i )
+			b[coord][i] = bFixed[i] ? x0[i] : -b[coord][i];
+	}
+	K.ConstrainVariables( bFixed );
+
+	/* solve the system *********************************************************/
+	std::vector<GW_Float> x(p);	// solution
+	for( GW_U32 coord = 0; coord<2; ++coord )
+	{
+		for( GW_U32 i=0; i<p; ++i )
+			x[i] = bFixed[i] ? b[coord][i] : L.GetData(coord,i);
+		cout << "  * System resolution.";
+		GW_U32 nNbrIter = 0;
+		GW_Float err = K.SolveCG( &x[0], &b[coord][0], &nNbrIter );
+		cout << " " << nNbrIter << " iterations, residual " << err << "." << endl;
+		for( GW_U32 j=0; j<p; ++j )
+			L.SetData(coord,j, x[j] );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::GetBoundaryNeighbors
+/**
+ *  \param  Vert [GW_Vertex&] A boundary vertex.
+ *  \param  pVert1 [GW_Vertex*&] Its first neighbor along the boundary.
+ *  \param  pVert2 [GW_Vertex*&] Its last neighbor along the boundary.
+ *  \date   10-19-2026
+ *
+ *  Turn around the vertex to find its two neighbors on the boundary.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::GetBoundaryNeighbors( GW_Vertex& Vert, GW_Vertex*& pVert1, GW_Vertex*& pVert2 )
+{
+	/* special case for boundary vertices : must turn IN CLOUNTERCLOCKWISE sense */
+	GW_Face* pFace = Vert.GetFace();	GW_ASSERT( pFace!=NULL );
+	// first find FIRST boundary vertex
+	GW_Face* pStartFace = pFace;
+	GW_Vertex* pDirVertex = pFace->GetNextVertex(Vert);	GW_ASSERT( pDirVertex!=NULL );
+	pDirVertex = pFace->GetNextVertex(*pDirVertex);			GW_ASSERT( pDirVertex!=NULL );
+	GW_U32 num = 0;
+	while( pFace->GetFaceNeighbor(*pDirVertex)!=NULL && num<100 )
+	{
+		num++;
+		GW_Face* pPrevFace = pFace;
+		pFace = pFace->GetFaceNeighbor(*pDirVertex);
+		pDirVertex = pPrevFace->GetVertex(Vert,*pDirVertex);	GW_ASSERT(pDirVertex!=NULL);
+	}
+	GW_ASSERT( num<100 );
+	//	GW_ASSERT( pFace!=pStartFace || pStartFace->GetFaceNeighbor(*pDirVertex)!=NULL );
+	pVert1 = pFace->GetVertex(Vert,*pDirVertex);	GW_ASSERT(pVert1!=NULL);
+	// then find LAST vertex
+	pDirVertex = pVert1;
+	num = 0;
+	while( pFace->GetFaceNeighbor(*pDirVertex)!=NULL && num<100 ) 
+	{
+		num++;
+		GW_Face* pPrevFace = pFace;
+		pFace = pFace->GetFaceNeighbor(*pDirVertex);
+		pDirVertex = pPrevFace->GetVertex(Vert,*pDirVertex);	GW_ASSERT(pDirVertex!=NULL);
+	}
+	GW_ASSERT( num<100 );
+	//	GW_ASSERT( pFace!=pStartFace || pStartFace->GetFaceNeighbor(*pDirVertex)!=NULL );
+	pVert2 = pFace->GetVertex(Vert,*pDirVertex);	GW_ASSERT(pVert2!=NULL);
+	GW_ASSERT( pVert1!=NULL && pVert2!=NULL );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ChooseFixedVertex
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh to flatten.
+ *  \param  M [GW_MatrixNxP*] The distance matrix, or NULL.
+ *  \param  pVert [GW_Vertex*[2]] The two vertex whose position is fixed.
+ *  \date   10-19-2026
+ *
+ *  Choose the vertex as far as possible from one another, or at random
+ *	without distance matrix.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_Parameterization::ChooseFixedVertex( GW_Mesh& Mesh, GW_MatrixNxP* M, GW_Vertex* pVert[2] )
+{
+	GW_U32 p = Mesh.GetNbrVertex();
+	if( M!=NULL )	// use farthest vertices
+	{
+		GW_U32 i_max = 0, j_max = 0;
+		GW_Float dist_max = 0;
+		for( GW_U32 i=0; i<p; ++i )
+		for( GW_U32 j=0; j<i; ++j )
+		{
+			if( M->GetData(i,j)>dist_max )
+			{
+				dist_max = M->GetData(i,j);
+				i_max = i; j_max = j;
+			}
+		}
+		pVert[0] = Mesh.GetVertex(i_max);
+		pVert[1] = Mesh.GetVertex(j_max);
+	}
+	else
+	{
+		// use random
+		pVert[0] = Mesh.GetRandomVertex();
+		pVert[1] = Mesh.GetRandomVertex();
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_Parameterization::ComputeBoundaryPosition
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh to flatten.
+ *  \param  Positions [T_Vector2DMap&] The position of the boundary vertex.
+ *  \param  pInitialPos [T_Vector2DMap*] Positions given by the user, or NULL.
+ *  \param  pTrissectorInfoMap [T_TrissectorInfoMap*] Base points of a convex polygon, or NULL for a disk.
+ *  \param  pCyclicPosition [T_TrissectorInfoVector*] Position of the base points.
+ *  \return [GW_Bool] Did it succeed ?
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_Bool GW_Parameterization::ComputeBoundaryPosition( GW_Mesh& Mesh, T_Vector2DMap& Positions, T_Vector2DMap* pInitialPos, 
+								T_TrissectorInfoMap* pTrissectorInfoMap, T_TrissectorInfoVector* pCyclicPosition )
 {
 	/* extract boundary *******************************************************/
 	std::list<T_VertexList> boundary_list;
@@ -1062,13 +1461,12 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 	{
 		GW_OutputComment("Closed mesh, can't flatten this mesh.");
 		GW_ASSERT( GW_False );
-		return;
+		return GW_False;
 	}
 	if( boundary_list.size()>1 )
 		GW_OutputComment("Warning, this mesh has more than 1 boundary.");
 	T_VertexList boundary = boundary_list.front();
 	/* find vertex position **************************************************/
-	T_Vector2DMap Positions;	// position of boundary points
 	if( pInitialPos!=NULL )
 	{
 		Positions = *pInitialPos;
@@ -1105,7 +1503,7 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 		}
 		GW_ASSERT( it_start != boundary.end() );
 		if( it_start==boundary.end() )
-			return;
+			return GW_False;
 		/* now extract each sub-boundary */
 		std::list<T_VertexList> boundary_pieces;
 		IT_VertexList it_cur = it_start;
@@ -1179,39 +1577,9 @@ void GW_Parameterization::ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatri
 		}
 
 	}
-	/* set up the new matrix ****************************************************/
-	GW_U32 p = Mesh.GetNbrVertex();
-	for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
-	{
-		GW_U32 i = it->first;
-		K.SetRowSize(i,0);
-		K.SetRowSize(i,1);
-		K.SetData(i,i,1);
-	}
-
-	/* solve the system *********************************************************/
-	GW_VectorND x(p, GW_Float(0));	// solution
-	for( GW_U32 coord = 0; coord<2; ++coord )
-	{
-		/* build RHS */
-		GW_VectorND b(p, GW_Float(0));	// rhs
-		for( IT_Vector2DMap it=Positions.begin(); it!=Positions.end(); ++it )
-		{
-			GW_U32 i = it->first;
-			GW_Vector2D	pos = it->second;
-			b.SetData(i, pos[coord]);
-		}
-
-		/* solve system */
-		cout << "  * System resolution.";
-		GW_Parameterization::SolveSystem( K, x, b );
-
-		for( GW_U32 j=0; j<p; ++j )
-			L.SetData(coord,j, x.GetData(j) );
-	}
+	return GW_True;
 }
 
-
 /*------------------------------------------------------------------------------*/
 // Name : GW_Parameterization::ParameterizeMesh
 /**
@@ -1269,7 +1637,7 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 
 	GW_U32 EIG = 0;
 	GW_MatrixNxP K_full(p,p,0.0);	// a symmetric matrix whose eigenvalues are the embedding
-	GW_SparseMatrix	K_sparse(p);
+	GW_SparseMatrixCSR K_sparse(p);
 	GW_Bool bUseSparse = GW_False;
 	
 	switch(ParamType) 
@@ -1294,7 +1662,7 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 	case kGeodesicConformal:
 		{
 			/* build the weight matrix */
-			BuildConformalMatrix(VoronoiMesh, K_sparse, &M);
+			BuildConformalMatrix(VoronoiMesh, K_sparse);
 			EIG = p-2;	//	first eigenvalue
 			bUseSparse = GW_True;
 		}
@@ -1305,7 +1673,22 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 	}
 
 	/* contains position of points */
-	GW_MatrixNxP L(2,p);
+	GW_MatrixNxP L(2,p,0.0);
+
+	if( !bUseSparse && ResolType!=kSpectral )
+	{
+		/* keep the non zero entries of the full matrix */
+		GW_SparseMatrixCSR::T_TripletVector Triplets;
+		for( GW_U32 i=0; i<p; ++i )
+		for( GW_U32 j=0; j<p; ++j )
+		{
+			GW_SparseMatrixCSR::GW_Triplet t;
+			t.nRow = i; t.nCol = j; t.rVal = K_full.GetData(i,j);
+			if( t.rVal!=0 )
+				Triplets.push_back( t );
+		}
+		K_sparse.BuildFromTriplets( p, Triplets );
+	}
 
 	switch(ResolType) {
 	case kSpectral:
@@ -1314,13 +1697,9 @@ void GW_Parameterization::ParameterizeMesh( GW_GeodesicMesh& Mesh, GW_VoronoiMes
 		ResolutionSpectral( K_full, L, EIG );
 		break;
 	case kBoundaryFree:
-		if( !bUseSparse )
-			K_sparse.BuildFromFull(K_full);
 		ResolutionBoundaryFree( VoronoiMesh, K_sparse, L, &M );
 		break;
 	case kBoundaryFixed:
-		if( !bUseSparse )
-			K_sparse.BuildFromFull(K_full);
 		ResolutionBoundaryFixed( VoronoiMesh, K_sparse,L );
 	default:
 		break;
@@ -15,6 +15,7 @@
 #include "../gw_core/GW_ProgressBar.h"
 #include "GW_GeodesicMesh.h"
 #include "GW_VoronoiMesh.h"
+#include "../gw_maths/GW_SparseMatrixCSR.h"
 
 namespace GW {
 
@@ -194,6 +195,13 @@ public:
 	static void ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrix& K, GW_MatrixNxP&  L, 
 			T_Vector2DMap* pInitialPos = NULL, T_TrissectorInfoMap* pTrissectorInfoMap = NULL, 
 			T_TrissectorInfoVector* pCyclicPosition = NULL );
+	/* same with a CSR matrix, solved with multithreaded preconditioned solvers */
+	static void BuildConformalMatrix( GW_Mesh& VoronoiMesh, GW_SparseMatrixCSR& K, GW_I32 nNbrThreads = 0 );
+	static void BuildTutteMatrix( GW_Mesh& VoronoiMesh, GW_SparseMatrixCSR& K, GW_I32 nNbrThreads = 0 );
+	static void ResolutionBoundaryFree( GW_Mesh& VoronoiMesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, GW_MatrixNxP* M = NULL );
+	static void ResolutionBoundaryFixed( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, GW_MatrixNxP&  L, 
+			T_Vector2DMap* pInitialPos = NULL, T_TrissectorInfoMap* pTrissectorInfoMap = NULL, 
+			T_TrissectorInfoVector* pCyclicPosition = NULL );
 
 	void ParameterizeRegion( GW_GeodesicVertex& Seed, GW_GeodesicMesh& BaseDomain );
 	void ParameterizeAllRegions( T_GeodesicVertexList& VertList );
@@ -243,6 +251,17 @@ private:
 
 	/* system resolution *********************************************************************/
 	static void SolveSystem( GW_SparseMatrix& M, GW_VectorND& x, GW_VectorND& b );
+	static void GetBoundaryNeighbors( GW_Vertex& Vert, GW_Vertex*& pVert1, GW_Vertex*& pVert2 );
+	static void ChooseFixedVertex( GW_Mesh& Mesh, GW_MatrixNxP* M, GW_Vertex* pVert[2] );
+	static GW_Bool ComputeBoundaryPosition( GW_Mesh& Mesh, T_Vector2DMap& Positions, T_Vector2DMap* pInitialPos, 
+			T_TrissectorInfoMap* pTrissectorInfoMap, T_TrissectorInfoVector* pCyclicPosition );
+
+	/* CSR matrix assembly *******************************************************************/
+	typedef GW_U32 (*T_RowFunction)( GW_Vertex& Vert, GW_SparseMatrixCSR::GW_Triplet* pRow );
+	static void BuildMatrixFromRows( GW_Mesh& Mesh, GW_SparseMatrixCSR& K, T_RowFunction pRowFunc, GW_I32 nNbrThreads );
+	static GW_U32 ComputeConformalRow( GW_Vertex& Vert, GW_SparseMatrixCSR::GW_Triplet* pRow );
+	static GW_U32 ComputeTutteRow( GW_Vertex& Vert, GW_SparseMatrixCSR::GW_Triplet* pRow );
+	static GW_Float ComputeCotan( GW_Vertex& Verti, GW_Vertex& Vertj, GW_Vertex& Vertk );
 
 	/** record information about a cut */
 	class GW_EdgeCut
@@ -0,0 +1,489 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_SparseMatrixCSR.h
+ *  \brief  Definition of class \c GW_SparseMatrixCSR
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_SPARSEMATRIXCSR_H_
+#define _GW_SPARSEMATRIXCSR_H_
+
+#include "GW_MathsConfig.h"
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_SparseMatrixCSR
+ *  \brief  A square sparse matrix in compressed row storage, with its solvers.
+ *  \date   10-19-2026
+ *
+ *  The matrix is assembled from a list of (row,col,value) triplets, sorted
+ *	in parallel, duplicated entries being summed. The products, dot products
+ *	and vector updates of the iterative solvers are multithreaded with
+ *	OpenMP. The ILU(0) preconditioner (which is the incomplete Cholesky
+ *	factorization for a symmetric matrix) is computed once and kept until
+ *	the matrix is modified, so that solving for several right hand sides
+ *	(e.g. the x and y coordinates of a parameterization) only pays it once.
+ *	The solvers start from the value of \c x, which allows warm starts.
+ *
+ *	Unlike \c GW_SparseMatrix, it does not need \b LASPACK.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_SparseMatrixCSR
+{
+public:
+
+	enum T_PreconditionerType
+	{
+		Preconditioner_Jacobi,
+		Preconditioner_ILU,
+		Preconditioner_NULL			// no preconditioner
+	};
+
+	/** an entry of the matrix, before assembly */
+	struct GW_Triplet
+	{
+		GW_U32 nRow;
+		GW_U32 nCol;
+		GW_Float rVal;
+		bool operator<( const GW_Triplet& t ) const
+		{
+			return nRow<t.nRow || (nRow==t.nRow && nCol<t.nCol);
+		}
+	};
+	typedef std::vector<GW_Triplet> T_TripletVector;
+
+	GW_SparseMatrixCSR( GW_U32 nSize = 0 )
+	:	nSize_			( nSize ),
+		RowStart_		( nSize+1, 0 ),
+		PrecondType_	( Preconditioner_NULL ),
+		bPrecondValid_	( false ),
+		nNbrThreads_	( 0 )
+	{
+		/* NOTHING */
+	}
+
+	GW_U32 GetDim() const
+	{
+		return nSize_;
+	}
+	GW_U32 GetNbrNonZero() const
+	{
+		return (GW_U32) Col_.size();
+	}
+	/** number of threads used by the solvers, <=0 for all */
+	void SetNbrThreads( GW_I32 nNbrThreads )
+	{
+		nNbrThreads_ = nNbrThreads;
+	}
+
+	//-------------------------------------------------------------------------
+	/** \name accessors */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_U32 GetRowSize( GW_U32 i ) const
+	{
+		GW_ASSERT( i<nSize_ );
+		return RowStart_[i+1]-RowStart_[i];
+	}
+	/** access element by element, columns are sorted in each row */
+	GW_Float AccessEntry( GW_U32 i, GW_U32 entry, GW_U32& j ) const
+	{
+		GW_ASSERT( entry<this->GetRowSize(i) );
+		j = Col_[RowStart_[i]+entry];
+		return Val_[RowStart_[i]+entry];
+	}
+	GW_Float GetData( GW_U32 i, GW_U32 j ) const
+	{
+		GW_ASSERT( i<nSize_ && j<nSize_ );
+		std::vector<GW_U32>::const_iterator itBegin = Col_.begin()+RowStart_[i];
+		std::vector<GW_U32>::const_iterator itEnd = Col_.begin()+RowStart_[i+1];
+		std::vector<GW_U32>::const_iterator it = std::lower_bound( itBegin, itEnd, j );
+		if( it==itEnd || *it!=j )
+			return 0;
+		return Val_[it-Col_.begin()];
+	}
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name assembly */
+	//-------------------------------------------------------------------------
+	//@{
+	/** build the matrix from the triplets, which are sorted in place */
+	void BuildFromTriplets( GW_U32 nSize, T_TripletVector& Triplets )
+	{
+		GW_SparseMatrixCSR::SortTriplets( Triplets, this->GetNbrThreads() );
+		nSize_ = nSize;
+		RowStart_.assign( nSize+1, 0 );
+		Col_.clear();
+		Val_.clear();
+		Col_.reserve( Triplets.size() );
+		Val_.reserve( Triplets.size() );
+		for( size_t k=0; k<Triplets.size(); ++k )
+		{
+			const GW_Triplet& t = Triplets[k];
+			GW_ASSERT( t.nRow<nSize && t.nCol<nSize );
+			if( k>0 && t.nRow==Triplets[k-1].nRow && t.nCol==Triplets[k-1].nCol )
+			{
+				Val_.back() += t.rVal;
+				continue;
+			}
+			Col_.push_back( t.nCol );
+			Val_.push_back( t.rVal );
+			RowStart_[t.nRow+1]++;
+		}
+		for( GW_U32 i=0; i<nSize; ++i )
+			RowStart_[i+1] += RowStart_[i];
+		bPrecondValid_ = false;
+	}
+	void Scale( GW_Float rFactor )
+	{
+		for( size_t k=0; k<Val_.size(); ++k )
+			Val_[k] *= rFactor;
+		bPrecondValid_ = false;
+	}
+	/** Replace the rows and columns of the fixed variables by the identity.
+		The right hand side must be computed before, as b-A*x0 where x0 holds
+		the fixed values (0 elsewhere), with b[i]=x0[i] on the fixed rows. */
+	void ConstrainVariables( const std::vector<GW_Bool>& bFixed )
+	{
+		GW_ASSERT( bFixed.size()==nSize_ );
+		for( GW_U32 i=0; i<nSize_; ++i )
+		for( GW_U32 k=RowStart_[i]; k<RowStart_[i+1]; ++k )
+		{
+			GW_U32 j = Col_[k];
+			if( bFixed[i] || bFixed[j] )
+				Val_[k] = (i==j) ? 1 : 0;
+		}
+		bPrecondValid_ = false;
+	}
+	//@}
+
+	/** y = A*x */
+	void Multiply( const GW_Float* x, GW_Float* y ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+		for( GW_I32 i=0; i<n; ++i )
+		{
+			GW_Float s = 0;
+			for( GW_U32 k=RowStart_[i]; k<RowStart_[i+1]; ++k )
+				s += Val_[k]*x[Col_[k]];
+			y[i] = s;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	/** \name iterative solvers */
+	//-------------------------------------------------------------------------
+	//@{
+	/** Preconditioned conjugate gradient, for a symmetric definite matrix.
+		Stops when |b-A*x|<=eps*|b|, return |b-A*x|. */
+	GW_Float SolveCG( GW_Float* x, const GW_Float* b, GW_U32* pNbrIter = NULL,
+					GW_Float eps = 1e-10, GW_U32 nMaxIter = 2000, T_PreconditionerType Precond = Preconditioner_ILU )
+	{
+		this->ComputePreconditioner( Precond );
+		GW_U32 n = nSize_;
+		std::vector<GW_Float> r(n), z(n), p(n), Ap(n);
+		this->Multiply( x, &Ap[0] );
+		this->Sub( b, &Ap[0], &r[0] );
+		GW_Float rTol = eps*sqrt( this->Dot(b,b) );
+		GW_Float rErr = sqrt( this->Dot(&r[0],&r[0]) );
+		this->ApplyPreconditioner( &r[0], &z[0] );
+		p = z;
+		GW_Float rz = this->Dot( &r[0], &z[0] );
+		GW_U32 nIter = 0;
+		while( nIter<nMaxIter && rErr>rTol )
+		{
+			this->Multiply( &p[0], &Ap[0] );
+			GW_Float pAp = this->Dot( &p[0], &Ap[0] );
+			if( pAp==0 )
+				break;
+			GW_Float alpha = rz/pAp;
+			this->Axpy( alpha, &p[0], x );
+			this->Axpy( -alpha, &Ap[0], &r[0] );
+			rErr = sqrt( this->Dot(&r[0],&r[0]) );
+			nIter++;
+			if( rErr<=rTol )
+				break;
+			this->ApplyPreconditioner( &r[0], &z[0] );
+			GW_Float rzNew = this->Dot( &r[0], &z[0] );
+			this->Xpby( &z[0], rzNew/rz, &p[0] );
+			rz = rzNew;
+		}
+		if( pNbrIter!=NULL )
+			*pNbrIter = nIter;
+		return rErr;
+	}
+	/** Right preconditioned BiCGSTAB, for a general matrix.
+		Stops when |b-A*x|<=eps*|b|, return |b-A*x|. */
+	GW_Float SolveBiCGSTAB( GW_Float* x, const GW_Float* b, GW_U32* pNbrIter = NULL,
+					GW_Float eps = 1e-10, GW_U32 nMaxIter = 2000, T_PreconditionerType Precond = Preconditioner_ILU )
+	{
+		this->ComputePreconditioner( Precond );
+		GW_U32 n = nSize_;
+		std::vector<GW_Float> r(n), r0(n), p(n,0), v(n,0), s(n), t(n), y(n), z(n);
+		this->Multiply( x, &t[0] );
+		this->Sub( b, &t[0], &r[0] );
+		r0 = r;
+		GW_Float rTol = eps*sqrt( this->Dot(b,b) );
+		GW_Float rErr = sqrt( this->Dot(&r[0],&r[0]) );
+		GW_Float rho = 1, alpha = 1, omega = 1;
+		GW_U32 nIter = 0;
+		while( nIter<nMaxIter && rErr>rTol )
+		{
+			GW_Float rhoNew = this->Dot( &r0[0], &r[0] );
+			if( rhoNew==0 )
+				break;		// breakdown
+			/* p = r + beta*(p-omega*v) */
+			this->Axpy( -omega, &v[0], &p[0] );
+			this->Xpby( &r[0], (rhoNew/rho)*(alpha/omega), &p[0] );
+			this->ApplyPreconditioner( &p[0], &y[0] );
+			this->Multiply( &y[0], &v[0] );
+			GW_Float r0v = this->Dot( &r0[0], &v[0] );
+			if( r0v==0 )
+				break;
+			alpha = rhoNew/r0v;
+			/* s = r-alpha*v */
+			s = r;
+			this->Axpy( -alpha, &v[0], &s[0] );
+			this->Axpy( alpha, &y[0], x );
+			nIter++;
+			rErr = sqrt( this->Dot(&s[0],&s[0]) );
+			if( rErr<=rTol )
+				break;
+			this->ApplyPreconditioner( &s[0], &z[0] );
+			this->Multiply( &z[0], &t[0] );
+			GW_Float tt = this->Dot( &t[0], &t[0] );
+			omega = tt>0 ? this->Dot( &t[0], &s[0] )/tt : 0;
+			this->Axpy( omega, &z[0], x );
+			/* r = s-omega*t */
+			r = s;
+			this->Axpy( -omega, &t[0], &r[0] );
+			rErr = sqrt( this->Dot(&r[0],&r[0]) );
+			rho = rhoNew;
+			if( omega==0 )
+				break;
+		}
+		if( pNbrIter!=NULL )
+			*pNbrIter = nIter;
+		return rErr;
+	}
+	//@}
+
+private:
+
+	/** below this size the loops are not worth threading */
+	enum { GW_CSR_PARALLEL_MIN = 10000 };
+
+	GW_I32 GetNbrThreads() const
+	{
+#ifdef _OPENMP
+		return nNbrThreads_>0 ? nNbrThreads_ : omp_get_max_threads();
+#else
+		return 1;
+#endif
+	}
+
+	/** sort each chunk on its own thread, then merge the chunks pairwise */
+	static void SortTriplets( T_TripletVector& Triplets, GW_I32 nNbrThreads )
+	{
+#ifdef _OPENMP
+		if( Triplets.size()<(size_t) 65536*nNbrThreads )
+			nNbrThreads = 1;
+		std::vector<size_t> Bound(nNbrThreads+1);
+		for( GW_I32 c=0; c<=nNbrThreads; ++c )
+			Bound[c] = Triplets.size()*c/nNbrThreads;
+		#pragma omp parallel for num_threads(nNbrThreads)
+		for( GW_I32 c=0; c<nNbrThreads; ++c )
+			std::sort( Triplets.begin()+Bound[c], Triplets.begin()+Bound[c+1] );
+		for( GW_I32 w=1; w<nNbrThreads; w*=2 )
+		{
+			#pragma omp parallel for num_threads(nNbrThreads)
+			for( GW_I32 c=0; c<nNbrThreads-w; c+=2*w )
+				std::inplace_merge( Triplets.begin()+Bound[c], Triplets.begin()+Bound[c+w],
+									Triplets.begin()+Bound[GW_MIN(c+2*w,nNbrThreads)] );
+		}
+#else
+		std::sort( Triplets.begin(), Triplets.end() );
+#endif
+	}
+
+	//-------------------------------------------------------------------------
+	/** \name preconditioners */
+	//-------------------------------------------------------------------------
+	//@{
+	void ComputePreconditioner( T_PreconditionerType Precond )
+	{
+		if( bPrecondValid_ && Precond==PrecondType_ )
+			return;
+		PrecondType_ = Precond;
+		bPrecondValid_ = true;
+		GW_U32 n = nSize_;
+		/* position of the diagonal in each row */
+		Diag_.assign( n, (GW_U32) -1 );
+		for( GW_U32 i=0; i<n; ++i )
+		for( GW_U32 k=RowStart_[i]; k<RowStart_[i+1]; ++k )
+			if( Col_[k]==i )
+				Diag_[i] = k;
+		if( Precond==Preconditioner_ILU && !this->ComputeILU() )
+			PrecondType_ = Preconditioner_Jacobi;		// zero pivot
+		if( PrecondType_==Preconditioner_Jacobi )
+		{
+			Precond_.resize( n );
+			for( GW_U32 i=0; i<n; ++i )
+			{
+				GW_Float d = Diag_[i]!=(GW_U32) -1 ? Val_[Diag_[i]] : 0;
+				Precond_[i] = d!=0 ? 1/d : 1;
+			}
+		}
+	}
+	/** ILU(0) : same sparsity as the matrix, L has a unit diagonal */
+	bool ComputeILU()
+	{
+		GW_U32 n = nSize_;
+		Precond_ = Val_;
+		std::vector<GW_U32> Pos( n, (GW_U32) -1 );
+		for( GW_U32 i=0; i<n; ++i )
+		{
+			if( Diag_[i]==(GW_U32) -1 )
+				return false;
+			for( GW_U32 k=RowStart_[i]; k<RowStart_[i+1]; ++k )
+				Pos[Col_[k]] = k;
+			for( GW_U32 k=RowStart_[i]; k<Diag_[i]; ++k )
+			{
+				/* eliminate entry (i,c) using row c */
+				GW_U32 c = Col_[k];
+				GW_Float rPivot = Precond_[Diag_[c]];
+				if( rPivot==0 )
+					return false;
+				GW_Float l = Precond_[k] /= rPivot;
+				for( GW_U32 kk=Diag_[c]+1; kk<RowStart_[c+1]; ++kk )
+					if( Pos[Col_[kk]]!=(GW_U32) -1 )
+						Precond_[Pos[Col_[kk]]] -= l*Precond_[kk];
+			}
+			for( GW_U32 k=RowStart_[i]; k<RowStart_[i+1]; ++k )
+				Pos[Col_[k]] = (GW_U32) -1;
+			if( Precond_[Diag_[i]]==0 )
+				return false;
+		}
+		return true;
+	}
+	/** z = M^-1 * r */
+	void ApplyPreconditioner( const GW_Float* r, GW_Float* z ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+		switch( PrecondType_ )
+		{
+		case Preconditioner_Jacobi:
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+			for( GW_I32 i=0; i<n; ++i )
+				z[i] = Precond_[i]*r[i];
+			break;
+		case Preconditioner_ILU:
+			/* the triangular solves are sequential */
+			for( GW_I32 i=0; i<n; ++i )
+			{
+				GW_Float s = r[i];
+				for( GW_U32 k=RowStart_[i]; k<Diag_[i]; ++k )
+					s -= Precond_[k]*z[Col_[k]];
+				z[i] = s;
+			}
+			for( GW_I32 i=n-1; i>=0; --i )
+			{
+				GW_Float s = z[i];
+				for( GW_U32 k=Diag_[i]+1; k<RowStart_[i+1]; ++k )
+					s -= Precond_[k]*z[Col_[k]];
+				z[i] = s/Precond_[Diag_[i]];
+			}
+			break;
+		default:
+			memcpy( z, r, nSize_*sizeof(GW_Float) );
+		}
+	}
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name vector helpers */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_Float Dot( const GW_Float* a, const GW_Float* b ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+		GW_Float s = 0;
+#ifdef _OPENMP
+		#pragma omp parallel for reduction(+:s) num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+		for( GW_I32 i=0; i<n; ++i )
+			s += a[i]*b[i];
+		return s;
+	}
+	/** y += a*x */
+	void Axpy( GW_Float a, const GW_Float* x, GW_Float* y ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+		for( GW_I32 i=0; i<n; ++i )
+			y[i] += a*x[i];
+	}
+	/** y = x + b*y */
+	void Xpby( const GW_Float* x, GW_Float b, GW_Float* y ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+		for( GW_I32 i=0; i<n; ++i )
+			y[i] = x[i] + b*y[i];
+	}
+	/** r = a-b */
+	void Sub( const GW_Float* a, const GW_Float* b, GW_Float* r ) const
+	{
+		GW_I32 n = (GW_I32) nSize_;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(this->GetNbrThreads()) if(n>GW_CSR_PARALLEL_MIN)
+#endif
+		for( GW_I32 i=0; i<n; ++i )
+			r[i] = a[i]-b[i];
+	}
+	//@}
+
+	GW_U32 nSize_;
+	/** entries of row i are [RowStart_[i],RowStart_[i+1]) */
+	std::vector<GW_U32> RowStart_;
+	std::vector<GW_U32> Col_;
+	std::vector<GW_Float> Val_;
+
+	/** position of the diagonal entry of each row */
+	std::vector<GW_U32> Diag_;
+	/** ILU factors (same layout as Val_) or inverse of the diagonal */
+	std::vector<GW_Float> Precond_;
+	T_PreconditionerType PrecondType_;
+	bool bPrecondValid_;
+
+	GW_I32 nNbrThreads_;
+};
+
+} // End namespace GW
+
+
+#endif // _GW_SPARSEMATRIXCSR_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1104 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FastMeshLoader.cpp
+ *  \brief  Definition of class \c GW_FastMeshLoader
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+
+#ifdef GW_SCCSID
+    static const char* sccsid = "@(#) GW_FastMeshLoader.cpp(c) Gabriel Peyr2026";
+#endif // GW_SCCSID
+
+#include "stdafx.h"
+#include "GW_FastMeshLoader.h"
+#include <string.h>
+#include <ctype.h>
+#ifdef __UNIX__
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#else
+	#include <windows.h>
+#endif
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+using namespace GW;
+
+/** below this size an ASCII file is parsed in one chunk */
+#define GW_FASTLOADER_CHUNK_MIN (1<<20)
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_MappedFile constructor
+/**
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_MappedFile::GW_MappedFile()
+:	pData_	( NULL ),
+	nSize_	( 0 )
+#ifdef __UNIX__
+	,nFile_	( -1 )
+#else
+	,hFile_	( INVALID_HANDLE_VALUE ),
+	hMapping_	( NULL )
+#endif
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_MappedFile destructor
+/**
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_MappedFile::~GW_MappedFile()
+{
+	this->Close();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_MappedFile::Open
+/**
+ *  \param  name [char*] File name.
+ *  \return [GW_Bool] Was the mapping successful ?
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_Bool GW_MappedFile::Open( const char* name )
+{
+	this->Close();
+#ifdef __UNIX__
+	nFile_ = open( name, O_RDONLY );
+	if( nFile_<0 )
+		return GW_False;
+	struct stat st;
+	if( fstat(nFile_, &st)!=0 )
+	{
+		this->Close();
+		return GW_False;
+	}
+	nSize_ = (size_t) st.st_size;
+	if( nSize_==0 )
+		return GW_True;
+	void* pData = mmap( NULL, nSize_, PROT_READ, MAP_PRIVATE, nFile_, 0 );
+	if( pData==MAP_FAILED )
+	{
+		this->Close();
+		return GW_False;
+	}
+	/* the chunks are read in parallel, ask for the whole file */
+	madvise( pData, nSize_, MADV_WILLNEED );
+	pData_ = (const char*) pData;
+#else
+	hFile_ = CreateFileA( name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if( hFile_==INVALID_HANDLE_VALUE )
+		return GW_False;
+	LARGE_INTEGER size;
+	if( !GetFileSizeEx( (HANDLE) hFile_, &size ) )
+	{
+		this->Close();
+		return GW_False;
+	}
+	nSize_ = (size_t) size.QuadPart;
+	if( nSize_==0 )
+		return GW_True;
+	hMapping_ = CreateFileMappingA( (HANDLE) hFile_, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( hMapping_!=NULL )
+		pData_ = (const char*) MapViewOfFile( (HANDLE) hMapping_, FILE_MAP_READ, 0, 0, 0 );
+	if( pData_==NULL )
+	{
+		this->Close();
+		return GW_False;
+	}
+#endif
+	return GW_True;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_MappedFile::Close
+/**
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_MappedFile::Close()
+{
+#ifdef __UNIX__
+	if( pData_!=NULL )
+		munmap( (void*) pData_, nSize_ );
+	if( nFile_>=0 )
+		close( nFile_ );
+	nFile_ = -1;
+#else
+	if( pData_!=NULL )
+		UnmapViewOfFile( pData_ );
+	if( hMapping_!=NULL )
+		CloseHandle( (HANDLE) hMapping_ );
+	if( hFile_!=INVALID_HANDLE_VALUE )
+		CloseHandle( (HANDLE) hFile_ );
+	hMapping_ = NULL;
+	hFile_ = INVALID_HANDLE_VALUE;
+#endif
+	pData_ = NULL;
+	nSize_ = 0;
+}
+
+
+/* text helpers ****************************************************************/
+
+static inline GW_Bool IsBlank( char c )
+{
+	return c==' ' || c=='\t' || c=='\r';
+}
+
+static inline const char* SkipBlank( const char* p, const char* end )
+{
+	while( p<end && IsBlank(*p) )
+		++p;
+	return p;
+}
+
+static inline const char* SkipLine( const char* p, const char* end )
+{
+	const char* q = (const char*) memchr( p, '\n', end-p );
+	return q==NULL ? end : q+1;
+}
+
+/** a data line is neither empty nor a comment */
+static inline GW_Bool IsDataLine( const char* p, const char* end )
+{
+	p = SkipBlank( p, end );
+	return p<end && *p!='\n' && *p!='#';
+}
+
+/** skip white spaces, new lines and '#' comments */
+static const char* SkipSpaceAndComments( const char* p, const char* end )
+{
+	while( p<end )
+	{
+		if( IsBlank(*p) || *p=='\n' )
+			++p;
+		else if( *p=='#' )
+			p = SkipLine( p, end );
+		else
+			break;
+	}
+	return p;
+}
+
+static const double aPow10[] = {	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+									1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/** Parse a decimal number without going through the locale of strtod.
+	The mantissa is accumulated as an integer, so that the usual values
+	(less than 16 digits and small exponents) are exactly rounded. */
+static GW_Bool ParseFloat( const char*& p, const char* end, double& rVal )
+{
+	const char* q = SkipBlank( p, end );
+	GW_Bool bNeg = GW_False;
+	if( q<end && (*q=='-' || *q=='+') )
+	{
+		bNeg = (*q=='-');
+		++q;
+	}
+	unsigned long long m = 0;
+	int nDigits = 0, e = 0;
+	GW_Bool bAny = GW_False;
+	for( ; q<end && (unsigned char)(*q-'0')<10; ++q )
+	{
+		if( nDigits<19 )
+		{
+			m = m*10 + (*q-'0');
+			if( m!=0 )
+				nDigits++;
+		}
+		else
+			e++;
+		bAny = GW_True;
+	}
+	if( q<end && *q=='.' )
+	{
+		for( ++q; q<end && (unsigned char)(*q-'0')<10; ++q )
+		{
+			if( nDigits<19 )
+			{
+				m = m*10 + (*q-'0');
+				if( m!=0 )
+					nDigits++;
+				e--;
+			}
+			bAny = GW_True;
+		}
+	}
+	if( !bAny )
+		return GW_False;
+	if( q<end && (*q=='e' || *q=='E') )
+	{
+		const char* r = q+1;
+		int nSign = 1, nExp = 0;
+		if( r<end && (*r=='-' || *r=='+') )
+		{
+			nSign = (*r=='-') ? -1 : 1;
+			++r;
+		}
+		if( r<end && (unsigned char)(*r-'0')<10 )
+		{
+			for( ; r<end && (unsigned char)(*r-'0')<10; ++r )
+				if( nExp<10000 )
+					nExp = nExp*10 + (*r-'0');
+			e += nSign*nExp;
+			q = r;
+		}
+	}
+	double v = (double) m;
+	if( e<0 )
+		v = (e>=-22) ? v/aPow10[-e] : v*pow(10.0, e);
+	else if( e>0 )
+		v = (e<=22) ? v*aPow10[e] : v*pow(10.0, e);
+	rVal = bNeg ? -v : v;
+	p = q;
+	return GW_True;
+}
+
+static GW_Bool ParseInt( const char*& p, const char* end, GW_I32& nVal )
+{
+	const char* q = SkipBlank( p, end );
+	GW_Bool bNeg = GW_False;
+	if( q<end && (*q=='-' || *q=='+') )
+	{
+		bNeg = (*q=='-');
+		++q;
+	}
+	if( q>=end || (unsigned char)(*q-'0')>=10 )
+		return GW_False;
+	GW_I32 n = 0;
+	for( ; q<end && (unsigned char)(*q-'0')<10; ++q )
+		n = n*10 + (*q-'0');
+	nVal = bNeg ? -n : n;
+	p = q;
+	return GW_True;
+}
+
+/** Cut [pBegin,pEnd[ in chunks of whole lines. */
+static void SplitInChunks( const char* pBegin, const char* pEnd, GW_I32 nNbrThreads, std::vector<const char*>& Chunks )
+{
+	size_t nSize = pEnd-pBegin;
+	size_t nNbrChunks = 1;
+	if( nSize>GW_FASTLOADER_CHUNK_MIN && nNbrThreads>1 )
+		nNbrChunks = 4*nNbrThreads;
+	Chunks.resize( nNbrChunks+1 );
+	Chunks[0] = pBegin;
+	for( size_t c=1; c<nNbrChunks; ++c )
+	{
+		const char* p = pBegin + (nSize*c)/nNbrChunks;
+		if( p<Chunks[c-1] )
+			p = Chunks[c-1];
+		else if( p>pBegin && p[-1]!='\n' )
+			p = SkipLine( p, pEnd );
+		Chunks[c] = p;
+	}
+	Chunks[nNbrChunks] = pEnd;
+}
+
+/** Split a polygon in a fan of triangles. */
+static inline void AddPolygon( std::vector<GW_Index>& Faces, const std::vector<GW_I32>& Poly )
+{
+	for( size_t k=2; k<Poly.size(); ++k )
+	{
+		Faces.push_back( (GW_Index) Poly[0] );
+		Faces.push_back( (GW_Index) Poly[k-1] );
+		Faces.push_back( (GW_Index) Poly[k] );
+	}
+}
+
+/** Concatenate the faces found by each chunk. */
+static void GatherFaces( std::vector< std::vector<GW_Index> >& ChunkFaces, std::vector<GW_Index>& Faces, GW_I32 nNbrThreads )
+{
+	GW_I32 nNbrChunks = (GW_I32) ChunkFaces.size();
+	std::vector<size_t> Start( nNbrChunks+1, 0 );
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+		Start[c+1] = Start[c] + ChunkFaces[c].size();
+	Faces.resize( Start[nNbrChunks] );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads)
+#endif
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+	{
+		if( !ChunkFaces[c].empty() )
+			memcpy( &Faces[Start[c]], &ChunkFaces[c][0], ChunkFaces[c].size()*sizeof(GW_Index) );
+		std::vector<GW_Index>().swap( ChunkFaces[c] );
+	}
+}
+
+/* PLY helpers *****************************************************************/
+
+enum { kInt8, kUint8, kInt16, kUint16, kInt32, kUint32, kFloat32, kFloat64, kNbrPlyTypes };
+static const size_t aPlyTypeSize[kNbrPlyTypes] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+static GW_I32 GetPlyType( const string& name )
+{
+	static const char* aNames[kNbrPlyTypes][2] = {
+		{"char","int8"}, {"uchar","uint8"}, {"short","int16"}, {"ushort","uint16"},
+		{"int","int32"}, {"uint","uint32"}, {"float","float32"}, {"double","float64"} };
+	for( GW_I32 i=0; i<kNbrPlyTypes; ++i )
+		if( name==aNames[i][0] || name==aNames[i][1] )
+			return i;
+	return -1;
+}
+
+/** Read a binary scalar, swapping its bytes if the file is not in the host order. */
+static inline double ReadPlyBinary( const char* p, GW_I32 nType, GW_Bool bSwap )
+{
+	unsigned char b[8];
+	size_t n = aPlyTypeSize[nType];
+	if( bSwap )
+	{
+		for( size_t k=0; k<n; ++k )
+			b[k] = p[n-1-k];
+	}
+	else
+		memcpy( b, p, n );
+	switch( nType )
+	{
+	case kInt8:		{ signed char v;	memcpy( &v, b, 1 ); return v; }
+	case kUint8:	{ unsigned char v;	memcpy( &v, b, 1 ); return v; }
+	case kInt16:	{ short v;			memcpy( &v, b, 2 ); return v; }
+	case kUint16:	{ unsigned short v;	memcpy( &v, b, 2 ); return v; }
+	case kInt32:	{ int v;			memcpy( &v, b, 4 ); return v; }
+	case kUint32:	{ unsigned int v;	memcpy( &v, b, 4 ); return v; }
+	case kFloat32:	{ float v;			memcpy( &v, b, 4 ); return v; }
+	default:		{ double v;			memcpy( &v, b, 8 ); return v; }
+	}
+}
+
+struct GW_PlyProperty
+{
+	string Name;
+	GW_I32 nType;
+	/** type of the count of a list, -1 for a scalar */
+	GW_I32 nCountType;
+};
+
+struct GW_PlyElement
+{
+	GW_PlyElement()
+	{ nCount = 0; nX = nY = nZ = nIndices = -1; }
+	string Name;
+	GW_U32 nCount;
+	std::vector<GW_PlyProperty> Props;
+	/** rank of the properties we read, -1 if absent */
+	GW_I32 nX, nY, nZ, nIndices;
+};
+typedef std::vector<GW_PlyElement> T_PlyElementVector;
+
+/** Find the properties we read in the vertex and face elements. */
+static void SetupPlyElements( T_PlyElementVector& Elements, GW_I32& nVertexElem, GW_I32& nFaceElem )
+{
+	nVertexElem = nFaceElem = -1;
+	for( GW_I32 e=0; e<(GW_I32) Elements.size(); ++e )
+	{
+		GW_PlyElement& Elem = Elements[e];
+		for( GW_I32 k=0; k<(GW_I32) Elem.Props.size(); ++k )
+		{
+			const GW_PlyProperty& Prop = Elem.Props[k];
+			if( Prop.nCountType<0 )
+			{
+				if( Prop.Name=="x" ) Elem.nX = k;
+				if( Prop.Name=="y" ) Elem.nY = k;
+				if( Prop.Name=="z" ) Elem.nZ = k;
+			}
+			else if( Prop.Name=="vertex_indices" || Prop.Name=="vertex_index" )
+				Elem.nIndices = k;
+		}
+		if( Elem.Name=="vertex" && nVertexElem<0 )
+			nVertexElem = e;
+		if( Elem.Name=="face" && nFaceElem<0 )
+			nFaceElem = e;
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : ParseAsciiElements
+/**
+ *  \param  pBegin [char*] Start of the body, after the header.
+ *  \param  pEnd [char*] End of the file.
+ *  \param  Elements [T_PlyElementVector&] Description of the rows.
+ *  \return [GW_I32] GW_OK if the parsing was successful.
+ *  \date   10-19-2026
+ *
+ *  Parse the rows of an ASCII PLY or OFF file. Each chunk first counts its
+ *	rows, so that it knows which element and which vertex its rows are.
+ */
+/*------------------------------------------------------------------------------*/
+static GW_I32 ParseAsciiElements( const char* pBegin, const char* pEnd, const T_PlyElementVector& Elements,
+					GW_I32 nVertexElem, GW_I32 nFaceElem, GW_I32 nNbrThreads,
+					T_FloatVector& Positions, std::vector<GW_Index>& Faces )
+{
+	std::vector<const char*> Chunks;
+	SplitInChunks( pBegin, pEnd, nNbrThreads, Chunks );
+	GW_I32 nNbrChunks = (GW_I32) Chunks.size()-1;
+
+	/* first pass : count the rows of each chunk */
+	std::vector<size_t> RowStart( nNbrChunks+1, 0 );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads)
+#endif
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+	{
+		size_t nRows = 0;
+		for( const char* p=Chunks[c]; p<Chunks[c+1]; p = SkipLine(p, Chunks[c+1]) )
+			if( IsDataLine(p, Chunks[c+1]) )
+				nRows++;
+		RowStart[c+1] = nRows;
+	}
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+		RowStart[c+1] += RowStart[c];
+	GW_I32 nNbrElements = (GW_I32) Elements.size();
+	std::vector<size_t> ElemStart( nNbrElements+1, 0 );
+	for( GW_I32 e=0; e<nNbrElements; ++e )
+		ElemStart[e+1] = ElemStart[e] + Elements[e].nCount;
+	if( RowStart[nNbrChunks]<ElemStart[nNbrElements] )
+		return GW_ERROR;		// truncated file
+
+	Positions.resize( nVertexElem>=0 ? 3*Elements[nVertexElem].nCount : 0 );
+
+	/* second pass : parse each row */
+	std::vector< std::vector<GW_Index> > ChunkFaces( nNbrChunks );
+	GW_Bool bError = GW_False;
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) schedule(dynamic,1)
+#endif
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+	{
+		const char* end = Chunks[c+1];
+		size_t nRow = RowStart[c];
+		GW_I32 e = 0;
+		std::vector<GW_I32> Poly;
+		GW_Bool bChunkError = GW_False;
+		for( const char* p=Chunks[c]; p<end && nRow<ElemStart[nNbrElements] && !bChunkError; p = SkipLine(p, end) )
+		{
+			if( !IsDataLine(p, end) )
+				continue;
+			while( nRow>=ElemStart[e+1] )
+				e++;
+			const GW_PlyElement& Elem = Elements[e];
+			if( e==nVertexElem )
+			{
+				GW_Float* pPos = &Positions[3*(nRow-ElemStart[e])];
+				GW_I32 nLast = GW_MAX( Elem.nX, GW_MAX(Elem.nY, Elem.nZ) );
+				for( GW_I32 k=0; k<=nLast && !bChunkError; ++k )
+				{
+					double v = 0;
+					GW_I32 n = 1;
+					if( Elem.Props[k].nCountType>=0 && !ParseInt(p, end, n) )
+						bChunkError = GW_True;
+					for( GW_I32 i=0; i<n && !bChunkError; ++i )
+						bChunkError = !ParseFloat( p, end, v );
+					if( k==Elem.nX ) pPos[0] = v;
+					if( k==Elem.nY ) pPos[1] = v;
+					if( k==Elem.nZ ) pPos[2] = v;
+				}
+			}
+			else if( e==nFaceElem )
+			{
+				for( GW_I32 k=0; k<=Elem.nIndices && !bChunkError; ++k )
+				{
+					GW_I32 n = 1;
+					if( Elem.Props[k].nCountType>=0 && !ParseInt(p, end, n) )
+						bChunkError = GW_True;
+					if( k==Elem.nIndices )
+					{
+						Poly.resize( GW_MAX(n,0) );
+						for( GW_I32 i=0; i<n && !bChunkError; ++i )
+							bChunkError = !ParseInt( p, end, Poly[i] );
+						AddPolygon( ChunkFaces[c], Poly );
+					}
+					else
+					{
+						double v;
+						for( GW_I32 i=0; i<n && !bChunkError; ++i )
+							bChunkError = !ParseFloat( p, end, v );
+					}
+				}
+			}
+			nRow++;
+		}
+		if( bChunkError )
+			bError = GW_True;
+	}
+	if( bError )
+		return GW_ERROR;
+	GatherFaces( ChunkFaces, Faces, nNbrThreads );
+	return GW_OK;
+}
+
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader constructor
+/**
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_FastMeshLoader::GW_FastMeshLoader()
+:	nNbrThreads_	( 0 )
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader destructor
+/**
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_FastMeshLoader::~GW_FastMeshLoader()
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::SetNbrThreads
+/**
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FastMeshLoader::SetNbrThreads( GW_I32 nNbrThreads )
+{
+	nNbrThreads_ = nNbrThreads;
+}
+
+GW_I32 GW_FastMeshLoader::GetNbrThreads() const
+{
+#ifdef _OPENMP
+	return nNbrThreads_>0 ? nNbrThreads_ : omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::Parse
+/**
+ *  \param  name [char*] File name, its extension gives the format.
+ *  \return [GW_I32] GW_OK if the loading was successful.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::Parse( const char* name )
+{
+	Position_.clear();
+	Face_.clear();
+	string str(name);
+	string::size_type n = str.find_last_of( "." );
+	if( n==string::npos )
+		return GW_ERROR;
+	string ext = str.substr( n+1 );
+	for( string::size_type i=0; i<ext.size(); ++i )
+		ext[i] = (char) tolower( ext[i] );
+	if( ext!="ply" && ext!="off" && ext!="obj" )
+		return GW_ERROR;
+
+	GW_MappedFile File;
+	if( !File.Open(name) )
+		return GW_Error_Opening_File;
+	GW_I32 nRet = GW_ERROR;
+	if( ext=="ply" )
+		nRet = this->ParsePLY( File.GetData(), File.GetSize() );
+	else if( ext=="off" )
+		nRet = this->ParseOFF( File.GetData(), File.GetSize() );
+	else
+		nRet = this->ParseOBJ( File.GetData(), File.GetSize() );
+	if( nRet!=GW_OK )
+		return nRet;
+
+	/* check the indices */
+	GW_Index nNbrVertex = (GW_Index) this->GetNbrVertex();
+	GW_I32 nNbrIndices = (GW_I32) Face_.size();
+	GW_I32 nNbrWrong = 0;
+	GW_I32 nNbrThreads = this->GetNbrThreads();
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) reduction(+:nNbrWrong)
+#endif
+	for( GW_I32 i=0; i<nNbrIndices; ++i )
+		if( Face_[i]>=nNbrVertex )
+			nNbrWrong++;
+	if( nNbrWrong>0 )
+	{
+		Face_.clear();
+		return GW_ERROR;
+	}
+	return GW_OK;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::ParsePLY
+/**
+ *  \param  pData [char*] The content of the file.
+ *  \param  nSize [size_t] Its size.
+ *  \return [GW_I32] GW_OK if the parsing was successful.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::ParsePLY( const char* pData, size_t nSize )
+{
+	const char* end = pData+nSize;
+	if( nSize<4 || strncmp(pData, "ply", 3)!=0 )
+		return GW_ERROR;
+
+	/* read the header ***********************************************************/
+	enum { kAscii, kBinaryLE, kBinaryBE } Format = kAscii;
+	T_PlyElementVector Elements;
+	const char* p = SkipLine( pData, end );
+	GW_Bool bHeaderDone = GW_False;
+	while( p<end && !bHeaderDone )
+	{
+		const char* q = SkipLine( p, end );
+		/* split the line in words */
+		std::vector<string> Words;
+		const char* w = p;
+		while( GW_True )
+		{
+			w = SkipBlank( w, q );
+			if( w>=q || *w=='\n' )
+				break;
+			const char* s = w;
+			while( w<q && !IsBlank(*w) && *w!='\n' )
+				++w;
+			Words.push_back( string(s, w) );
+		}
+		p = q;
+		if( Words.empty() || Words[0]=="comment" || Words[0]=="obj_info" )
+			continue;
+		if( Words[0]=="end_header" )
+			bHeaderDone = GW_True;
+		else if( Words[0]=="format" && Words.size()>=2 )
+		{
+			if( Words[1]=="ascii" )
+				Format = kAscii;
+			else if( Words[1]=="binary_little_endian" )
+				Format = kBinaryLE;
+			else if( Words[1]=="binary_big_endian" )
+				Format = kBinaryBE;
+			else
+				return GW_ERROR;
+		}
+		else if( Words[0]=="element" && Words.size()>=3 )
+		{
+			GW_PlyElement Elem;
+			Elem.Name = Words[1];
+			Elem.nCount = (GW_U32) strtoul( Words[2].c_str(), NULL, 10 );
+			Elements.push_back( Elem );
+		}
+		else if( Words[0]=="property" && !Elements.empty() )
+		{
+			GW_PlyProperty Prop;
+			if( Words.size()>=5 && Words[1]=="list" )
+			{
+				Prop.nCountType = GetPlyType( Words[2] );
+				Prop.nType = GetPlyType( Words[3] );
+				Prop.Name = Words[4];
+				if( Prop.nCountType<0 )
+					return GW_ERROR;
+			}
+			else if( Words.size()>=3 )
+			{
+				Prop.nCountType = -1;
+				Prop.nType = GetPlyType( Words[1] );
+				Prop.Name = Words[2];
+			}
+			else
+				return GW_ERROR;
+			if( Prop.nType<0 )
+				return GW_ERROR;
+			Elements.back().Props.push_back( Prop );
+		}
+	}
+	if( !bHeaderDone )
+		return GW_ERROR;
+	GW_I32 nVertexElem, nFaceElem;
+	SetupPlyElements( Elements, nVertexElem, nFaceElem );
+	if( nVertexElem<0 )
+		return GW_ERROR;
+	const GW_PlyElement& VertexElem = Elements[nVertexElem];
+	if( VertexElem.nX<0 || VertexElem.nY<0 || VertexElem.nZ<0 )
+		return GW_ERROR;
+	if( nFaceElem>=0 && Elements[nFaceElem].nIndices<0 )
+		nFaceElem = -1;
+	GW_I32 nNbrThreads = this->GetNbrThreads();
+
+	if( Format==kAscii )
+		return ParseAsciiElements( p, end, Elements, nVertexElem, nFaceElem, nNbrThreads, Position_, Face_ );
+
+	/* binary body ***************************************************************/
+	const GW_U32 nOne = 1;
+	GW_Bool bHostLE = (*(const char*) &nOne)==1;
+	GW_Bool bSwap = (Format==kBinaryLE) != bHostLE;
+	std::vector<GW_I32> Poly;
+	for( GW_I32 e=0; e<(GW_I32) Elements.size(); ++e )
+	{
+		const GW_PlyElement& Elem = Elements[e];
+		/* rows of fixed size can be skipped or read in parallel */
+		GW_Bool bFixed = GW_True;
+		size_t nRowSize = 0;
+		std::vector<size_t> Offset( Elem.Props.size(), 0 );
+		for( size_t k=0; k<Elem.Props.size(); ++k )
+		{
+			Offset[k] = nRowSize;
+			if( Elem.Props[k].nCountType>=0 )
+				bFixed = GW_False;
+			nRowSize += aPlyTypeSize[Elem.Props[k].nType];
+		}
+		if( bFixed )
+		{
+			if( (size_t) (end-p)<nRowSize*Elem.nCount )
+				return GW_ERROR;
+			if( e==nVertexElem )
+			{
+				Position_.resize( 3*Elem.nCount );
+				GW_I32 nNbrRows = (GW_I32) Elem.nCount;
+				const char* pRows = p;
+				GW_I32 aProp[3] = { Elem.nX, Elem.nY, Elem.nZ };
+#ifdef _OPENMP
+				#pragma omp parallel for num_threads(nNbrThreads) if(nNbrRows>10000)
+#endif
+				for( GW_I32 i=0; i<nNbrRows; ++i )
+				{
+					const char* pRow = pRows + i*nRowSize;
+					for( GW_U32 k=0; k<3; ++k )
+						Position_[3*i+k] = ReadPlyBinary( pRow+Offset[aProp[k]], Elem.Props[aProp[k]].nType, bSwap );
+				}
+			}
+			p += nRowSize*Elem.nCount;
+			continue;
+		}
+		/* rows with lists must be walked through */
+		if( e==nVertexElem )
+			Position_.resize( 3*Elem.nCount );
+		if( e==nFaceElem )
+			Face_.reserve( 3*Elem.nCount );
+		for( GW_U32 i=0; i<Elem.nCount; ++i )
+		for( GW_I32 k=0; k<(GW_I32) Elem.Props.size(); ++k )
+		{
+			const GW_PlyProperty& Prop = Elem.Props[k];
+			size_t nTypeSize = aPlyTypeSize[Prop.nType];
+			if( Prop.nCountType<0 )
+			{
+				if( (size_t) (end-p)<nTypeSize )
+					return GW_ERROR;
+				if( e==nVertexElem && (k==Elem.nX || k==Elem.nY || k==Elem.nZ) )
+				{
+					GW_U32 nCoord = (k==Elem.nX) ? 0 : ((k==Elem.nY) ? 1 : 2);
+					Position_[3*i+nCoord] = ReadPlyBinary( p, Prop.nType, bSwap );
+				}
+				p += nTypeSize;
+				continue;
+			}
+			size_t nCountSize = aPlyTypeSize[Prop.nCountType];
+			if( (size_t) (end-p)<nCountSize )
+				return GW_ERROR;
+			GW_I32 n = (GW_I32) ReadPlyBinary( p, Prop.nCountType, bSwap );
+			p += nCountSize;
+			if( n<0 || (size_t) (end-p)<n*nTypeSize )
+				return GW_ERROR;
+			if( e==nFaceElem && k==Elem.nIndices )
+			{
+				Poly.resize( n );
+				for( GW_I32 j=0; j<n; ++j )
+					Poly[j] = (GW_I32) ReadPlyBinary( p+j*nTypeSize, Prop.nType, bSwap );
+				AddPolygon( Face_, Poly );
+			}
+			p += n*nTypeSize;
+		}
+	}
+	return GW_OK;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::ParseOFF
+/**
+ *  \param  pData [char*] The content of the file.
+ *  \param  nSize [size_t] Its size.
+ *  \return [GW_I32] GW_OK if the parsing was successful.
+ *  \date   10-19-2026
+ *
+ *  Only the ASCII OFF format is supported. Extra values on a row (colors,
+ *	or the comma written by \c GW_OFFLoader::Save) are skipped.
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::ParseOFF( const char* pData, size_t nSize )
+{
+	const char* end = pData+nSize;
+	const char* p = SkipSpaceAndComments( pData, end );
+	/* the key word, e.g. OFF, COFF or NOFF */
+	const char* s = p;
+	while( p<end && !IsBlank(*p) && *p!='\n' )
+		++p;
+	string Key( s, p );
+	if( Key.size()<3 || Key.compare(Key.size()-3, 3, "OFF")!=0 )
+		return GW_ERROR;
+	if( SkipBlank(p, end)<end && strncmp(SkipBlank(p, end), "BINARY", 6)==0 )
+		return GW_ERROR;
+	/* number of vertex, face and edges */
+	GW_I32 nCount[3];
+	for( GW_U32 i=0; i<3; ++i )
+	{
+		p = SkipSpaceAndComments( p, end );
+		if( !ParseInt(p, end, nCount[i]) || nCount[i]<0 )
+			return GW_ERROR;
+	}
+	p = SkipLine( p, end );
+
+	/* describe the rows as a PLY file */
+	T_PlyElementVector Elements(2);
+	Elements[0].Name = "vertex";
+	Elements[0].nCount = nCount[0];
+	Elements[1].Name = "face";
+	Elements[1].nCount = nCount[1];
+	const char* aCoords[3] = { "x", "y", "z" };
+	for( GW_U32 i=0; i<3; ++i )
+	{
+		GW_PlyProperty Prop;
+		Prop.Name = aCoords[i];
+		Prop.nType = kFloat32;
+		Prop.nCountType = -1;
+		Elements[0].Props.push_back( Prop );
+	}
+	GW_PlyProperty Prop;
+	Prop.Name = "vertex_indices";
+	Prop.nType = kInt32;
+	Prop.nCountType = kInt32;
+	Elements[1].Props.push_back( Prop );
+	GW_I32 nVertexElem, nFaceElem;
+	SetupPlyElements( Elements, nVertexElem, nFaceElem );
+
+	return ParseAsciiElements( p, end, Elements, nVertexElem, nFaceElem, this->GetNbrThreads(), Position_, Face_ );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::ParseOBJ
+/**
+ *  \param  pData [char*] The content of the file.
+ *  \param  nSize [size_t] Its size.
+ *  \return [GW_I32] GW_OK if the parsing was successful.
+ *  \date   10-19-2026
+ *
+ *  Only the 'v' and 'f' lines are read. The faces can use the v, v/vt,
+ *	v//vn or v/vt/vn forms, and negative (relative) indices.
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::ParseOBJ( const char* pData, size_t nSize )
+{
+	const char* pEnd = pData+nSize;
+	GW_I32 nNbrThreads = this->GetNbrThreads();
+	std::vector<const char*> Chunks;
+	SplitInChunks( pData, pEnd, nNbrThreads, Chunks );
+	GW_I32 nNbrChunks = (GW_I32) Chunks.size()-1;
+
+	/* first pass : count the vertex of each chunk */
+	std::vector<size_t> VertStart( nNbrChunks+1, 0 );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads)
+#endif
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+	{
+		const char* end = Chunks[c+1];
+		size_t nVert = 0;
+		for( const char* p=Chunks[c]; p<end; p = SkipLine(p, end) )
+		{
+			const char* q = SkipBlank( p, end );
+			if( q+1<end && q[0]=='v' && IsBlank(q[1]) )
+				nVert++;
+		}
+		VertStart[c+1] = nVert;
+	}
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+		VertStart[c+1] += VertStart[c];
+	Position_.resize( 3*VertStart[nNbrChunks] );
+
+	/* second pass : parse vertex and faces */
+	std::vector< std::vector<GW_Index> > ChunkFaces( nNbrChunks );
+	GW_Bool bError = GW_False;
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) schedule(dynamic,1)
+#endif
+	for( GW_I32 c=0; c<nNbrChunks; ++c )
+	{
+		const char* end = Chunks[c+1];
+		GW_I32 nVert = (GW_I32) VertStart[c];
+		std::vector<GW_I32> Poly;
+		GW_Bool bChunkError = GW_False;
+		for( const char* p=Chunks[c]; p<end && !bChunkError; p = SkipLine(p, end) )
+		{
+			p = SkipBlank( p, end );
+			if( p+1>=end || !IsBlank(p[1]) )
+				continue;
+			if( p[0]=='v' )
+			{
+				p += 2;
+				for( GW_U32 k=0; k<3 && !bChunkError; ++k )
+				{
+					double v;
+					bChunkError = !ParseFloat( p, end, v );
+					Position_[3*nVert+k] = v;
+				}
+				nVert++;
+			}
+			else if( p[0]=='f' )
+			{
+				p += 2;
+				Poly.clear();
+				while( GW_True )
+				{
+					p = SkipBlank( p, end );
+					if( p>=end || *p=='\n' || *p=='#' )
+						break;
+					GW_I32 n;
+					if( !ParseInt(p, end, n) || n==0 )
+					{
+						bChunkError = GW_True;
+						break;
+					}
+					Poly.push_back( n<0 ? nVert+n : n-1 );
+					/* skip the texture and normal indices */
+					while( p<end && !IsBlank(*p) && *p!='\n' )
+						++p;
+				}
+				AddPolygon( ChunkFaces[c], Poly );
+			}
+		}
+		if( bChunkError )
+			bError = GW_True;
+	}
+	if( bError )
+		return GW_ERROR;
+	GatherFaces( ChunkFaces, Face_, nNbrThreads );
+	return GW_OK;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::FillMesh
+/**
+ *  \param  Mesh [GW_Mesh&] The mesh to fill.
+ *  \param  bFlipFaces [GW_Bool] Reverse the orientation of the faces ?
+ *  \date   10-19-2026
+ *
+ *  The vertex and faces are still created one by one by the mesh, since it
+ *	owns them.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FastMeshLoader::FillMesh( GW_Mesh& Mesh, GW_Bool bFlipFaces ) const
+{
+	GW_U32 nNbrVertex = this->GetNbrVertex();
+	GW_U32 nNbrFace = this->GetNbrFace();
+	Mesh.SetNbrVertex( nNbrVertex );
+	for( GW_U32 i=0; i<nNbrVertex; ++i )
+	{
+		GW_Vertex* pVert = &Mesh.CreateNewVertex();
+		pVert->SetPosition( GW_Vector3D(Position_[3*i], Position_[3*i+1], Position_[3*i+2]) );
+		Mesh.SetVertex( i, pVert );
+	}
+	Mesh.SetNbrFace( nNbrFace );
+	for( GW_U32 i=0; i<nNbrFace; ++i )
+	{
+		GW_Face* pFace = &Mesh.CreateNewFace();
+		for( GW_U32 k=0; k<3; ++k )
+		{
+			GW_Vertex* pVert = Mesh.GetVertex( Face_[3*i+k] );
+			GW_ASSERT( pVert!=NULL );
+			if( !bFlipFaces )
+				pFace->SetVertex( *pVert, k );
+			else
+				pFace->SetVertex( *pVert, 2-k );
+		}
+		Mesh.SetFace( i, pFace );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::FillMesh
+/**
+ *  \param  Mesh [GW_CompactMesh&] The mesh to fill.
+ *  \param  bFlipFaces [GW_Bool] Reverse the orientation of the faces ?
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FastMeshLoader::FillMesh( GW_CompactMesh& Mesh, GW_Bool bFlipFaces ) const
+{
+	GW_I32 nNbrVertex = (GW_I32) this->GetNbrVertex();
+	GW_I32 nNbrFace = (GW_I32) this->GetNbrFace();
+	GW_I32 nNbrThreads = this->GetNbrThreads();
+	Mesh.SetNbrVertex( nNbrVertex );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) if(nNbrVertex>10000)
+#endif
+	for( GW_I32 i=0; i<nNbrVertex; ++i )
+		Mesh.SetPosition( i, Position_[3*i], Position_[3*i+1], Position_[3*i+2] );
+	Mesh.SetNbrFace( nNbrFace );
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nNbrThreads) if(nNbrFace>10000)
+#endif
+	for( GW_I32 i=0; i<nNbrFace; ++i )
+	{
+		if( !bFlipFaces )
+			Mesh.SetFace( i, Face_[3*i], Face_[3*i+1], Face_[3*i+2] );
+		else
+			Mesh.SetFace( i, Face_[3*i+2], Face_[3*i+1], Face_[3*i] );
+	}
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::Load
+/**
+ *  \param  Mesh [GW_Mesh&] Mesh to load data to.
+ *  \param  name [char*] File name.
+ *  \param  bFlipFaces [GW_Bool] Reverse the orientation of the faces ?
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \return [GW_I32] GW_OK if the loading was successful.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::Load( GW_Mesh& Mesh, const char* name, GW_Bool bFlipFaces, GW_I32 nNbrThreads )
+{
+	GW_FastMeshLoader Loader;
+	Loader.SetNbrThreads( nNbrThreads );
+	GW_I32 nRet = Loader.Parse( name );
+	if( nRet==GW_OK )
+		Loader.FillMesh( Mesh, bFlipFaces );
+	return nRet;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FastMeshLoader::Load
+/**
+ *  \param  Mesh [GW_CompactMesh&] Mesh to load data to.
+ *  \param  name [char*] File name.
+ *  \param  bFlipFaces [GW_Bool] Reverse the orientation of the faces ?
+ *  \param  nNbrThreads [GW_I32] Number of threads, <=0 for all of them.
+ *  \return [GW_I32] GW_OK if the loading was successful.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FastMeshLoader::Load( GW_CompactMesh& Mesh, const char* name, GW_Bool bFlipFaces, GW_I32 nNbrThreads )
+{
+	GW_FastMeshLoader Loader;
+	Loader.SetNbrThreads( nNbrThreads );
+	GW_I32 nRet = Loader.Parse( name );
+	if( nRet==GW_OK )
+		Loader.FillMesh( Mesh, bFlipFaces );
+	return nRet;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FastMeshLoader.h
+ *  \brief  Definition of class \c GW_FastMeshLoader
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_FASTMESHLOADER_H_
+#define _GW_FASTMESHLOADER_H_
+
+#include "../gw_core/GW_Config.h"
+#include "../gw_core/GW_Mesh.h"
+#include "../gw_core/GW_CompactMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_MappedFile
+ *  \brief  A read only memory mapping of a whole file.
+ *  \date   10-19-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_MappedFile
+{
+
+public:
+
+	GW_MappedFile();
+	virtual ~GW_MappedFile();
+
+	GW_Bool Open( const char* name );
+	void Close();
+
+	const char* GetData() const
+	{ return pData_; }
+	size_t GetSize() const
+	{ return nSize_; }
+
+private:
+
+	const char* pData_;
+	size_t nSize_;
+#ifdef __UNIX__
+	int nFile_;
+#else
+	void* hFile_;
+	void* hMapping_;
+#endif
+
+};
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_FastMeshLoader
+ *  \brief  Loader for large .ply, .off and .obj files.
+ *  \date   10-19-2026
+ *
+ *  The file is memory mapped and decoded into flat arrays of positions
+ *	(kept as \c GW_Float, so the coordinates are not rounded) and triangle
+ *	indices (polygons are split in fans). Binary PLY (little or
+ *	big endian, any scalar type) is decoded directly from the mapping, the
+ *	vertex element in parallel when its rows have a fixed size. ASCII files
+ *	are cut in chunks of whole lines that are parsed in parallel: a first
+ *	pass counts the rows of each chunk so that every chunk knows where its
+ *	vertex go, then a second pass parses the numbers.
+ *
+ *	Only the geometry is read (no colors, normals or texture coordinates).
+ *	The arrays can then feed a \c GW_CompactMesh without any allocation per
+ *	element, or a \c GW_Mesh.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_FastMeshLoader
+{
+
+public:
+
+	GW_FastMeshLoader();
+	virtual ~GW_FastMeshLoader();
+
+	void SetNbrThreads( GW_I32 nNbrThreads );
+
+	//-------------------------------------------------------------------------
+	/** \name Parsing. */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_I32 Parse( const char* name );
+	GW_I32 ParsePLY( const char* pData, size_t nSize );
+	GW_I32 ParseOFF( const char* pData, size_t nSize );
+	GW_I32 ParseOBJ( const char* pData, size_t nSize );
+	//@}
+
+	//-------------------------------------------------------------------------
+	/** \name Results. */
+	//-------------------------------------------------------------------------
+	//@{
+	GW_U32 GetNbrVertex() const
+	{ return (GW_U32) Position_.size()/3; }
+	GW_U32 GetNbrFace() const
+	{ return (GW_U32) Face_.size()/3; }
+	/** x,y,z coords of each vertex */
+	const T_FloatVector& GetPositions() const
+	{ return Position_; }
+	/** the 3 vertex of each triangle */
+	const std::vector<GW_Index>& GetFaces() const
+	{ return Face_; }
+	void FillMesh( GW_Mesh& Mesh, GW_Bool bFlipFaces = GW_False ) const;
+	void FillMesh( GW_CompactMesh& Mesh, GW_Bool bFlipFaces = GW_False ) const;
+	//@}
+
+	static GW_I32 Load( GW_Mesh& Mesh, const char* name, GW_Bool bFlipFaces = GW_False, GW_I32 nNbrThreads = 0 );
+	static GW_I32 Load( GW_CompactMesh& Mesh, const char* name, GW_Bool bFlipFaces = GW_False, GW_I32 nNbrThreads = 0 );
+
+private:
+
+	GW_I32 GetNbrThreads() const;
+
+	/** x,y,z coords of each vertex */
+	T_FloatVector Position_;
+	/** the 3 vertex of each triangle */
+	std::vector<GW_Index> Face_;
+	GW_I32 nNbrThreads_;
+
+};
+
+} // End namespace GW
+
+
+#endif // _GW_FASTMESHLOADER_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Gabriel Peyr
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -234,8 +234,7 @@ GW_I32 GW_PLYLoader::Load(GW_Mesh& Mesh, const char *name, const char* mode, GW_
 	free(elist); //allocated by ply_open_for_reading
 
 	/* close the PLY files */
-	close_ply( in_ply );
-	fclose( pFile );
+	close_ply( in_ply );	// also close pFile
 
 	return GW_OK;
 }
@@ -101,7 +101,9 @@ GW_I32 GW_Toolkit::LoadFile(const char* file_name)
 #define FLIP_FACES GW_True
 			GW_BasicDisplayer Displayer_;
 			cout << "Loading PLY file " << file_name << "... ";
-			GW_I32 nRet = GW_PLYLoader::Load( Mesh_, file_name, MODE, EXTRA_PAD, FLIP_FACES );
+			GW_I32 nRet = GW_FastMeshLoader::Load( Mesh_, file_name, FLIP_FACES );
+			if( nRet<0 )	// fall back on the ply library
+				nRet = GW_PLYLoader::Load( Mesh_, file_name, MODE, EXTRA_PAD, FLIP_FACES );
 			if( nRet<0 )
 			{
 				cout << endl << "Can't load file.";
@@ -234,7 +236,9 @@ GW_I32 GW_Toolkit::LoadFile(const char* file_name)
 		else if( ext=="off" )
 		{	
 			cout << "Loading OFF file " << file_name << " ... ";
-			GW_I32 nRet = GW_OFFLoader::Load( Mesh_, file_name );
+			GW_I32 nRet = GW_FastMeshLoader::Load( Mesh_, file_name );
+			if( nRet<0 )
+				nRet = GW_OFFLoader::Load( Mesh_, file_name );
 			if( nRet<0 )
 			{
 				cout << endl << "Can't load file.";
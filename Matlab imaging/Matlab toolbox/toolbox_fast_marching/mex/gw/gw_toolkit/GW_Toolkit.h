@@ -18,6 +18,7 @@
 #include "../gw_core/GW_Mesh.h"
 #include "../gw_toolkit/GW_ASELoader.h"
 #include "../gw_toolkit/GW_PLYLoader.h"
+#include "../gw_toolkit/GW_FastMeshLoader.h"
 #include "../gw_toolkit/GW_VRMLLoader.h"
 #include "../gw_toolkit/GW_OFFLoader.h"
 #include "../gw_toolkit/GW_OBJLoader.h"
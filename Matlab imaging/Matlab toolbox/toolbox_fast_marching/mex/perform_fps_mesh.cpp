@@ -0,0 +1,161 @@
+/*=================================================================
+% perform_fps_mesh - farthest point sampling and geodesic Voronoi diagram on a 3D mesh.
+%
+%   [points,D,Q] = perform_fps_mesh(vertex, faces, W, points, nbr_points, L, batch_size, nb_threads);
+%
+%	'points' are the initial seeds (0-based), the output is the initial seeds
+%		followed by the 'nbr_points' new ones.
+%   'D' is the distance to the seeds, computed before the last seed is added
+%		(which is the farthest vertex of D), 1e9 if not reached.
+%	'Q' is the nearest seed of each vertex (0-based vertex index), -1 if not reached.
+%	'W' is the weight (inverse of the speed) of each vertex.
+%	'L' is an upper bound on the distance ([] for none).
+%	'batch_size' is the number of seeds propagated in parallel (1 for the
+%		exact greedy sampling), using 'nb_threads' threads (0 for all).
+%
+%   Copyright (c) 2004 Gabriel Peyr
+*=================================================================*/
+
+#include <math.h>
+#include "config.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <list>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <string.h>
+using std::string;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+#include "mex.h"
+#include "gw/gw_core/GW_Config.h"
+#include "gw/gw_core/GW_MathsWrapper.h"
+#include "gw/gw_geodesic/GW_FarthestPointSampler.h"
+using namespace GW;
+
+
+#define faces_(k,i) faces[k+3*i]
+#define vertex_(k,i) vertex[k+3*i]
+
+
+void mexFunction(	int nlhs, mxArray *plhs[],
+				 int nrhs, const mxArray*prhs[] )
+{
+	/* retrive arguments */
+	if( nrhs<5 )
+		mexErrMsgTxt("5 to 8 input arguments are required.");
+	if( nlhs<1 )
+		mexErrMsgTxt("1 to 3 output arguments are required.");
+
+	// arg1 : vertex
+	double* vertex = mxGetPr(prhs[0]);
+	int nverts = mxGetN(prhs[0]);
+	if( mxGetM(prhs[0])!=3 )
+		mexErrMsgTxt("vertex must be of size 3 x nverts.");
+	// arg2 : faces
+	double* faces = mxGetPr(prhs[1]);
+	int nfaces = mxGetN(prhs[1]);
+	if( mxGetM(prhs[1])!=3 )
+		mexErrMsgTxt("face must be of size 3 x nfaces.");
+	// arg3 : W
+	double* Ww = mxGetPr(prhs[2]);
+	if( mxGetM(prhs[2])*mxGetN(prhs[2])==0 )
+		Ww = NULL;
+	else if( (int) mxGetM(prhs[2])!=nverts )
+		mexErrMsgTxt("W must be of same size as vertex.");
+	// arg4 : points
+	double* start_points = mxGetPr(prhs[3]);
+	int nstart = mxGetM(prhs[3])*mxGetN(prhs[3]);
+	// arg5 : nbr_points
+	int nbr_points = (int) *mxGetPr(prhs[4]);
+	// arg6 : L
+	double* L = NULL;
+	if( nrhs>=6 && mxGetM(prhs[5])*mxGetN(prhs[5])>0 )
+	{
+		L = mxGetPr(prhs[5]);
+		if( (int) mxGetM(prhs[5])!=nverts )
+			mexErrMsgTxt("L must be of size nverts.");
+	}
+	// arg7 : batch_size
+	int batch_size = 1;
+	if( nrhs>=7 )
+		batch_size = GW_MAX( (int) *mxGetPr(prhs[6]), 1 );
+	// arg8 : nb_threads
+	int nb_threads = 0;
+	if( nrhs>=8 )
+		nb_threads = (int) *mxGetPr(prhs[7]);
+
+	// create the mesh
+	GW_CompactMesh Mesh;
+	Mesh.SetNbrVertex(nverts);
+	for( int i=0; i<nverts; ++i )
+		Mesh.SetPosition( i, vertex_(0,i),vertex_(1,i),vertex_(2,i) );
+	Mesh.SetNbrFace(nfaces);
+	for( int i=0; i<nfaces; ++i )
+	{
+		int i0 = (int) faces_(0,i), i1 = (int) faces_(1,i), i2 = (int) faces_(2,i);
+		if( i0<0 || i0>=nverts || i1<0 || i1>=nverts || i2<0 || i2>=nverts )
+			mexErrMsgTxt("faces must index vertex.");
+		Mesh.SetFace( i, i0,i1,i2 );
+	}
+	Mesh.BuildConnectivity( nb_threads );
+
+	// propagate from the initial seeds
+	GW_FarthestPointSampler Sampler( Mesh );
+	Sampler.SetNbrThreads( nb_threads );
+	Sampler.SetWeight( Ww );
+	Sampler.Reset( L );
+	std::vector<GW_Index> Seeds;
+	for( int i=0; i<nstart; ++i )
+	{
+		int k = (int) start_points[i];
+		if( k<0 || k>=nverts )
+			mexErrMsgTxt("points must index vertex.");
+		Seeds.push_back( k );
+	}
+	Sampler.AddSeeds( Seeds );
+
+	// farthest seeds, the last one is not propagated
+	if( nbr_points>1 )
+		Sampler.AddFarthestSeeds( nbr_points-1, batch_size );
+	GW_U32 nbr_seeds = Sampler.GetNbrSeeds();
+	GW_Index last = GW_CompactMesh::kNoIndex;
+	if( nbr_points>0 )
+		last = Sampler.GetFarthestVertex();
+
+	// first output : points
+	plhs[0] = mxCreateDoubleMatrix(1, nbr_seeds + (last!=GW_CompactMesh::kNoIndex), mxREAL);
+	double* points = mxGetPr(plhs[0]);
+	for( GW_U32 i=0; i<nbr_seeds; ++i )
+		points[i] = Sampler.GetSeed(i);
+	if( last!=GW_CompactMesh::kNoIndex )
+		points[nbr_seeds] = last;
+	// second output : distance
+	if( nlhs>=2 )
+	{
+		plhs[1] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		double* D = mxGetPr(plhs[1]);
+		for( int i=0; i<nverts; ++i )
+			D[i] = Sampler.GetDistance(i);
+	}
+	// third output : Voronoi segmentation
+	if( nlhs>=3 )
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		double* Q = mxGetPr(plhs[2]);
+		for( int i=0; i<nverts; ++i )
+		{
+			GW_Index k = Sampler.GetVoronoi(i);
+			if( k==GW_CompactMesh::kNoIndex )
+				Q[i] = -1;
+			else
+				Q[i] = Sampler.GetSeed(k);
+		}
+	}
+
+	return;
+}
@@ -33,7 +33,7 @@ using std::endl;
 #include "mex.h"
 #include "gw/gw_core/GW_Config.h"
 #include "gw/gw_core/GW_MathsWrapper.h"
-#include "gw/gw_geodesic/GW_GeodesicMesh.h"
+#include "gw/gw_geodesic/GW_CompactGeodesicMesh.h"
 using namespace GW;
 
 
@@ -69,19 +69,17 @@ double* Q = NULL;	// nearest neighbor
 #define vertex_(k,i) vertex[k+3*i]
 
 
-GW_Float WeightCallback(GW_GeodesicVertex& Vert)
+GW_CompactGeodesicMesh* pMesh = NULL;
+
+GW_Float WeightCallback( GW_U32 i )
 {
-	GW_U32 i = Vert.GetID();
 	return Ww[i];
 }
 
-GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert )
+GW_Bool StopMarchingCallback( GW_U32 i )
 {
 	// check if the end point has been reached
-	GW_U32 i = Vert.GetID();
-//	display_message("ind %d",i );
-//	display_message("dist %f",Vert.GetDistance() );
-	if( Vert.GetDistance()>dmax )
+	if( pMesh->GetDistance(i)>dmax )
 		return true;
 	for( int k=0; k<nend; ++k )
 		if( end_points[k]==i )
@@ -89,20 +87,18 @@ GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert )
 	return false;
 }
 int nbr_iter = 0;
-GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist )
+GW_Bool InsersionCallback( GW_U32 i, GW_Float rNewDist )
 {
 	// check if the distance of the new point is less than the given distance
-	GW_U32 i = Vert.GetID();
 	bool doinsersion = nbr_iter<=niter_max;
 	if( L!=NULL )
 		doinsersion = doinsersion && (rNewDist<L[i]);
 	nbr_iter++;
 	return doinsersion;
 }
-GW_Float HeuristicCallback( GW_GeodesicVertex& Vert )
+GW_Float HeuristicCallback( GW_U32 i )
 {
 	// return the heuristic distance
-	GW_U32 i = Vert.GetID();
 	return H[i];
 }
 
@@ -195,66 +191,60 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL); 
 	Q = mxGetPr(plhs[2]);
 
-	// create the mesh
-	GW_GeodesicMesh Mesh;
-	Mesh.SetNbrVertex(nverts);
-	for( int i=0; i<nverts; ++i )
+	// check the indices before anything is built, mexErrMsgTxt does not return
+	for( int i=0; i<nfaces; ++i )
 	{
-		GW_GeodesicVertex& vert = (GW_GeodesicVertex&) Mesh.CreateNewVertex();
-		vert.SetPosition( GW_Vector3D(vertex_(0,i),vertex_(1,i),vertex_(2,i)) );
-		Mesh.SetVertex(i, &vert);
+		int i0 = (int) faces_(0,i), i1 = (int) faces_(1,i), i2 = (int) faces_(2,i);
+		if( i0<0 || i0>=nverts || i1<0 || i1>=nverts || i2<0 || i2>=nverts )
+			mexErrMsgTxt("faces must index vertex."); 
 	}
-	Mesh.SetNbrFace(nfaces);
-	for( int i=0; i<nfaces; ++i )
+	for( int i=0; i<nstart; ++i )
 	{
-		GW_GeodesicFace& face = (GW_GeodesicFace&) Mesh.CreateNewFace();
-		GW_Vertex* v1 = Mesh.GetVertex((int) faces_(0,i)); GW_ASSERT( v1!=NULL );
-		GW_Vertex* v2 = Mesh.GetVertex((int) faces_(1,i)); GW_ASSERT( v2!=NULL );
-		GW_Vertex* v3 = Mesh.GetVertex((int) faces_(2,i)); GW_ASSERT( v3!=NULL );
-		face.SetVertex( *v1,*v2,*v3 );
-		Mesh.SetFace(i, &face);
+		int k = (int) start_points[i];
+		if( k<0 || k>=nverts )
+			mexErrMsgTxt("start_points must index vertex."); 
 	}
+
+	// create the mesh : flat arrays, connectivity built by sorting the edges
+	GW_CompactMesh Mesh;
+	Mesh.SetNbrVertex(nverts);
+	for( int i=0; i<nverts; ++i )
+		Mesh.SetPosition( i, vertex_(0,i),vertex_(1,i),vertex_(2,i) );
+	Mesh.SetNbrFace(nfaces);
+	for( int i=0; i<nfaces; ++i )
+		Mesh.SetFace( i, (int) faces_(0,i), (int) faces_(1,i), (int) faces_(2,i) );
 	Mesh.BuildConnectivity();
 
 	// set up fast marching	
-	Mesh.ResetGeodesicMesh();
+	GW_CompactGeodesicMesh Propagation( Mesh );
+	Propagation.ResetGeodesicMesh();
 	for( int i=0; i<nstart; ++i )
 	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
-		GW_ASSERT( v!=NULL );
-		Mesh.AddStartVertex( *v );
+		// initialize the distance of the starting points
+		Propagation.AddStartVertex( (int) start_points[i], values!=NULL ? values[i] : 0 );
 	}
-	Mesh.SetUpFastMarching();
-	Mesh.RegisterWeightCallbackFunction( WeightCallback );
-	Mesh.RegisterForceStopCallbackFunction( StopMarchingCallback );
-	Mesh.RegisterVertexInsersionCallbackFunction( InsersionCallback );
+	Propagation.RegisterWeightCallbackFunction( WeightCallback );
+	Propagation.RegisterForceStopCallbackFunction( StopMarchingCallback );
+	Propagation.RegisterVertexInsersionCallbackFunction( InsersionCallback );
 	if( H!=NULL )
-		Mesh.RegisterHeuristicToGoalCallbackFunction( HeuristicCallback );
-	// initialize the distance of the starting points
-	if( values!=NULL )
-	for( int i=0; i<nstart; ++i )
-	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
-		GW_ASSERT( v!=NULL );
-		v->SetDistance( values[i] );
-	}
+		Propagation.RegisterHeuristicToGoalCallbackFunction( HeuristicCallback );
 	
-	// perform fast marching
+	// perform fast marching, pMesh is only valid for the callbacks
 //	display_message("itermax=%d", niter_max);
-	Mesh.PerformFastMarching();
+	pMesh = &Propagation;
+	Propagation.PerformFastMarching();
+	pMesh = NULL;
 
 	// output result
 	for( int i=0; i<nverts; ++i )
 	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) i);
-		GW_ASSERT( v!=NULL );
-		D[i] = v->GetDistance();
-		S[i] = v->GetState();
-		GW_GeodesicVertex* v1 = v->GetFront();
-		if( v1==NULL )
+		D[i] = Propagation.GetDistance(i);
+		S[i] = Propagation.GetState(i);
+		GW_Index k = Propagation.GetFront(i);
+		if( k==GW_CompactMesh::kNoIndex )
 			Q[i] = -1;
 		else
-			Q[i] = v1->GetID();
+			Q[i] = k;
 	}
 	
 
@@ -5,15 +5,19 @@
 // Written 8/04 by N. Howe
 //
 // Input:
-//   img:  binary silhouette image
+//   img:  binary silhouette image, or binary volume
+//   nthread:  number of threads for volumes (optional, 0 for all)
 //
 // Output:
-//   skg:  skeleton gradient transform
+//   skg:  skeleton gradient transform (for volumes the feature chord
+//         measure of compute_skeleton_gradient_3d(), not the perimeter
+//         span of images)
 //   skr:  skeleton radius
 //
 //***************************************************************************
 
 #include "mex.h"
+#include "distance_transform.h"
 
 //***************************************************************************
 
@@ -24,6 +28,7 @@
 #define errCheck(a,b) if (!(a)) mexErrMsgTxt((b));
 #define cutBounds(i) (((i)>0) ? (((i)<ncut) ? cut[(i)]:mxGetInf()):-mxGetInf())
 #define MOD(x,n) (((x)%(n)<0) ? ((x)%(n)+(n)):((x)%(n)))
+#define SLAB 8  // number of slices of the slabs of a volume
 
 //***************************************************************************
 
@@ -397,6 +402,151 @@ compute_skeleton_gradient(T *img, int nrow, int ncol, int nlhs,
 }
 // end of compute_skeleton_gradient()
 
+//****************************************************************************
+//
+// compute_skeleton_gradient_3d() is the version for volumes.
+//
+// As in 2D the volume is surrounded by background.  The feature transform
+// (nearest background voxel of each voxel) is computed by an exact
+// separable distance transform: the passes along the first two dimensions
+// are done slice by slice on slabs of SLAB slices, the pass along the
+// slices on groups of columns, in parallel in both cases.  Then the slabs
+// are processed in parallel, each reading a halo of one slice on both
+// sides.  The radius is the squared distance to the nearest background
+// voxel.
+//
+// The gradient is not the one of the 2D version: the perimeter span has
+// no counterpart on the boundary surface of a volume.  Instead the
+// gradient of a voxel is the largest distance between its nearest
+// background voxel and the one of a 6-neighbor that is not deeper than
+// itself.  It is about the local thickness of the shape on the medial
+// surface (one voxel thick) and about one voxel elsewhere, so thresholding
+// it prunes the small branches too, but its values and thresholds do not
+// compare with those of images.
+//
+// The slabs only split the work among the threads, the whole volume is
+// kept in memory: besides the outputs, one float distance and one 32 bit
+// label per voxel of the volume padded by one voxel on each side.
+//
+// R/O img:  the volume
+// R/O nrow, ncol, nslice:  volume dimensions
+// R/O nthread:  number of threads (0 for all)
+// R/O nlhs:  number of arguments to return
+// W/O plhs:  array of return arguments (0 = gradient, 1 = radius)
+//
+
+template <class T> void
+compute_skeleton_gradient_3d(T *img, int nrow, int ncol, int nslice,
+                             int nthread, int nlhs, mxArray **plhs) {
+  int prow = nrow+2, pcol = ncol+2, pslice = nslice+2;
+  size_t pplane = (size_t)prow*pcol;
+  size_t psize = pplane*pslice;
+  mwSize sdims[2] = {(mwSize)prow, (mwSize)pcol};
+  mwSize pdims[3] = {(mwSize)prow, (mwSize)pcol, (mwSize)pslice};
+  mwSize dims[3] = {(mwSize)nrow, (mwSize)ncol, (mwSize)nslice};
+  float *dist;
+  unsigned int *feat;
+  double *skg, *rad = NULL;
+  int islab, nslab;
+
+  errCheck(psize < 0xffffffffu,"Volume too large.");
+#ifdef _OPENMP
+  if (nthread <= 0) {
+    nthread = omp_get_max_threads();
+  }
+#endif
+
+  // squared distance and nearest background voxel, in the padded volume
+  dist = (float*)mxMalloc(psize*sizeof(float));
+  feat = (unsigned int*)mxMalloc(psize*sizeof(unsigned int));
+
+  // initialization and passes along the rows and columns, by slabs
+  nslab = (pslice+SLAB-1)/SLAB;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+#endif
+  for (islab = 0; islab < nslab; islab++) {
+    for (int k = islab*SLAB; k < MIN((islab+1)*SLAB,pslice); k++) {
+      float *ds = dist+k*pplane;
+      unsigned int *fs = feat+k*pplane;
+      for (int j = 0; j < pcol; j++) {
+        for (int i = 0; i < prow; i++) {
+          size_t p = i+j*(size_t)prow;
+          bool inside = (i > 0)&&(i <= nrow)&&(j > 0)&&(j <= ncol)
+            &&(k > 0)&&(k <= nslice);
+          if (inside&&img[(i-1)+(j-1)*(size_t)nrow+(k-1)*(size_t)nrow*ncol]) {
+            ds[p] = std::numeric_limits<float>::infinity();
+          } else {
+            ds[p] = 0;
+          }
+          fs[p] = (unsigned int)(p+k*pplane);
+        }
+      }
+      edt_pass(ds,fs,sdims,2,0,1.0,1);
+      edt_pass(ds,fs,sdims,2,1,1.0,1);
+    }
+  }
+  // pass along the slices
+  edt_pass(dist,feat,pdims,3,2,1.0,nthread);
+
+  // create output
+  plhs[0] = mxCreateNumericArray(3,dims,mxDOUBLE_CLASS,mxREAL);
+  skg = mxGetPr(plhs[0]);
+  if (nlhs > 1) {
+    plhs[1] = mxCreateNumericArray(3,dims,mxDOUBLE_CLASS,mxREAL);
+    rad = mxGetPr(plhs[1]);
+  }
+
+  // ridge detection, by slabs with a halo of one slice
+  nslab = (nslice+SLAB-1)/SLAB;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+#endif
+  for (islab = 0; islab < nslab; islab++) {
+    const long offset[6] = {-1, 1, -(long)prow, (long)prow,
+                            -(long)pplane, (long)pplane};
+    for (int k = islab*SLAB; k < MIN((islab+1)*SLAB,nslice); k++) {
+      for (int j = 0; j < ncol; j++) {
+        for (int i = 0; i < nrow; i++) {
+          size_t o = i+j*(size_t)nrow+k*(size_t)nrow*ncol;
+          size_t p = (i+1)+(j+1)*(size_t)prow+(k+1)*pplane;
+          if (dist[p] > 0) {
+            size_t f = feat[p];
+            long fi = (long)(f%prow), fj = (long)((f/prow)%pcol);
+            long fk = (long)(f/pplane);
+            double maxd = 0;
+            for (int n = 0; n < 6; n++) {
+              size_t q = p+offset[n];
+              if ((dist[q] < dist[p])||((dist[q] == dist[p])&&(offset[n] > 0))) {
+                size_t g = feat[q];
+                long gi = (long)(g%prow), gj = (long)((g/prow)%pcol);
+                long gk = (long)(g/pplane);
+                double d = SQR((double)(fi-gi))+SQR((double)(fj-gj))
+                  +SQR((double)(fk-gk));
+                maxd = MAX(maxd,d);
+              }
+            }
+            skg[o] = sqrt(maxd);
+            if (rad) {
+              rad[o] = dist[p];
+            }
+          } else {
+            skg[o] = 0;
+            if (rad) {
+              rad[o] = 0;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // free space
+  mxFree(dist);
+  mxFree(feat);
+}
+// end of compute_skeleton_gradient_3d()
+
 //***************************************************************************
 //
 // Gateway driver to call the calculation from Matlab.
@@ -406,11 +556,11 @@ compute_skeleton_gradient(T *img, int nrow, int ncol, int nlhs,
 
 void 
 mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
-  int nrow, ncol;
+  int nrow, ncol, nslice, nthread = 0;
   double *img;
 
   // check for proper number of arguments
-  errCheck(nrhs == 1,"Exactly one input argument required.");
+  errCheck((nrhs == 1)||(nrhs == 2),"One or two input arguments required.");
   errCheck(nlhs <= 2,"Too many output arguments.");
 
   // check format of arguments
@@ -419,6 +569,22 @@ mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
   nrow = mxGetM(prhs[0]);
   ncol = mxGetN(prhs[0]);
   img = mxGetPr(prhs[0]);
+  if (nrhs > 1) {
+    nthread = (int)mxGetScalar(prhs[1]);
+  }
+
+  if (mxGetNumberOfDimensions(prhs[0]) == 3) {
+    // process volume
+    ncol = mxGetDimensions(prhs[0])[1];
+    nslice = mxGetDimensions(prhs[0])[2];
+    if (mxIsDouble(prhs[0])) {
+      compute_skeleton_gradient_3d(img,nrow,ncol,nslice,nthread,nlhs,plhs);
+    } else {
+      compute_skeleton_gradient_3d((unsigned char *)img,nrow,ncol,nslice,
+                                   nthread,nlhs,plhs);
+    }
+    return;
+  }
 
   // process image
   if (mxIsDouble(prhs[0])) {
@@ -7,6 +7,15 @@ function [points,D] = perform_farthest_point_sampling_mesh( vertex,faces, points
 %   points can be [] or can be a (nb.points,1) matrix of already computed 
 %       sampling locations.
 %
+%   If perform_fps_mesh is compiled, the distance map is updated
+%       incrementally, each new point only explores its Voronoi cell.
+%   options.W is the weight (inverse speed) on each vertex (default 1).
+%   options.batch_size is the number of points added together, which are
+%       propagated in parallel using options.nb_threads threads (0 for all).
+%       With batch_size>1 (default 1), the points of a batch are picked
+%       among the farthest ones, far enough apart, so the sampling is only
+%       approximately the farthest point one.
+%
 %   See also: perform_fast_marching_mesh.
 %   
 %   Copyright (c) 2007 Gabriel Peyre
@@ -33,6 +42,18 @@ else
     % initial distance map
     L = min(zeros(n,1) + Inf, L1);
 end
+
+if exist('perform_fps_mesh')==3
+    W = getoptions(options, 'W', ones(n,1));
+    batch_size = getoptions(options, 'batch_size', 1);
+    nb_threads = getoptions(options, 'nb_threads', 0);
+    L1 = max(min(L1(:),1e9),-1e9);
+    [points,D] = perform_fps_mesh(vertex,faces-1, W(:), points(:)-1, nbr_iter, L1, batch_size, nb_threads);
+    points = points+1;
+    D(D>1e8) = 0;
+    return;
+end
+
 for i=1:nbr_iter
     if nbr_iter>5
         progressbar( i, nbr_iter );
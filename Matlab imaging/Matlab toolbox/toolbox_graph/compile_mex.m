@@ -1,4 +1,11 @@
 % compile mex file for dijkstra
+% both use mex/sparse_dijkstra.hpp, perform_dijkstra_fast processes the
+% start points in parallel when compiled with OpenMP
 
-mex mex/perform_dijkstra_propagation.cpp mex/fheap/fib.cpp 
-mex mex/dijkstra.cpp -o perform_dijkstra_fast 
\ No newline at end of file
+if ispc
+    mex -largeArrayDims mex/perform_dijkstra_propagation.cpp
+    mex -largeArrayDims COMPFLAGS="$COMPFLAGS /openmp" mex/dijkstra.cpp -output perform_dijkstra_fast
+else
+    mex -largeArrayDims mex/perform_dijkstra_propagation.cpp
+    mex -largeArrayDims CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/dijkstra.cpp -output perform_dijkstra_fast
+end
@@ -0,0 +1,169 @@
+/*------------------------------------------------------------------------------*/
+/**
+*  \file   sparse_dijkstra.hpp
+*  \brief  Dijkstra shortest paths on a Matlab sparse matrix.
+*
+*  Shared by toolbox_graph/mex/dijkstra.cpp (perform_dijkstra_fast),
+*  toolbox_graph/mex/perform_dijkstra_propagation.cpp and by
+*  piotr/toolbox/matlab/private/dijkstra1.cpp, which keeps an identical copy
+*  of this file so that each toolbox compiles on its own.
+*
+*  The graph is read in place from the CSC arrays of the sparse matrix: the
+*  edges leaving node k are ir[jc[k]]...ir[jc[k+1]-1] with lengths
+*  pr[jc[k]]...pr[jc[k+1]-1]. The priority queue is an indexed 4-ary heap
+*  whose arrays are allocated once and reused for every source, and
+*  independent sources are distributed over OpenMP threads (one engine per
+*  thread) when compiled with OpenMP.
+*/
+/*------------------------------------------------------------------------------*/
+#ifndef _SPARSE_DIJKSTRA_HPP_
+#define _SPARSE_DIJKSTRA_HPP_
+
+#include <vector>
+#include <cstddef>
+#include "mex.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/** Indexed 4-ary min heap of nodes 0..n-1. Keys live in the heap array next
+    to the node ids, pos[v] is the position of v in the heap or -1. */
+class dary_heap {
+  std::vector<double> _key;
+  std::vector<int> _id;
+  std::vector<int> _pos;
+  int _size;
+
+  void place( int i, int v, double k ) { _key[i]=k; _id[i]=v; _pos[v]=i; }
+
+  void sift_up( int i, int v, double k ) {
+    while( i>0 ) {
+      int p=(i-1)>>2; if( _key[p]<=k ) break;
+      place(i,_id[p],_key[p]); i=p;
+    }
+    place(i,v,k);
+  }
+
+  void sift_down( int i, int v, double k ) {
+    for( ;; ) {
+      int c=4*i+1, e=c+4, m; if( c>=_size ) break;
+      if( e>_size ) e=_size;
+      m=c; for( c++; c<e; c++ ) if( _key[c]<_key[m] ) m=c;
+      if( _key[m]>=k ) break;
+      place(i,_id[m],_key[m]); i=m;
+    }
+    place(i,v,k);
+  }
+
+public:
+  dary_heap() : _size(0) {}
+  void resize( int n ) { _key.resize(n); _id.resize(n); _pos.assign(n,-1); _size=0; }
+  bool empty() const { return _size==0; }
+  bool contains( int v ) const { return _pos[v]>=0; }
+  void push( int v, double k ) { sift_up(_size++,v,k); }
+  void decrease( int v, double k ) { sift_up(_pos[v],v,k); }
+  int pop() {
+    int v=_id[0]; _pos[v]=-1;
+    if( --_size>0 ) sift_down(0,_id[_size],_key[_size]);
+    return v;
+  }
+  void clear() { for( int i=0; i<_size; i++ ) _pos[_id[i]]=-1; _size=0; }
+};
+
+/** Dijkstra engine on a sparse matrix. One object per thread. */
+class sparse_dijkstra {
+public:
+  enum { kDead=-1, kOpen=0, kFar=1 };
+
+  /** Optional behaviour of run(), the defaults give plain Dijkstra. */
+  struct options {
+    double inf;            // distance of unreached nodes
+    double d0;             // distance of the sources
+    const double *H;       // heuristic (A*), nodes are ordered by D+H
+    const bool *is_end;    // stop once one of these nodes is reached
+    long nb_iter_max;      // stop after this many nodes (<0 for no limit)
+    options() : inf(mxGetInf()), d0(0), H(NULL), is_end(NULL), nb_iter_max(-1) {}
+  };
+
+  sparse_dijkstra( int n, const double *pr, const mwIndex *ir, const mwIndex *jc )
+    : _n(n), _pr(pr), _ir(ir), _jc(jc), _state(n,kFar), _monotone(true) { _heap.resize(n); }
+
+  /** Runs from nSrc sources (0 indexed) at once. Fills D (n), P (n, 1 indexed
+      predecessor or -1, may be NULL) and the state of every node. Returns
+      the number of nodes that were reached, or -1 if a source is repeated. */
+  long run( const int *src, int nSrc, double *D, double *P, const options &o ) {
+    int i, ii; long nIter=0; double d, a;
+    for( i=0; i<_n; i++ ) { D[i]=o.inf; _state[i]=kFar; }
+    if( P ) for( i=0; i<_n; i++ ) P[i]=-1;
+    _heap.clear(); _monotone=true;
+    for( int k=0; k<nSrc; k++ ) {
+      i=src[k]; if( _state[i]!=kFar ) return -1;
+      D[i]=o.d0; _state[i]=kOpen; _heap.push(i,key(o,D,i));
+    }
+    while( !_heap.empty() && (o.nb_iter_max<0 || nIter<o.nb_iter_max) ) {
+      i=_heap.pop(); _state[i]=kDead; nIter++; d=D[i];
+      for( mwIndex k=_jc[i]; k<_jc[i+1]; k++ ) {
+        ii=(int) _ir[k]; a=d+_pr[k];
+        if( _state[ii]==kFar ) {
+          D[ii]=a; if( P ) P[ii]=i+1;
+          _state[ii]=kOpen; _heap.push(ii,key(o,D,ii));
+        } else if( a<D[ii] ) {
+          D[ii]=a;
+          // a dead node can only improve with a heuristic that is not consistent
+          if( _state[ii]==kDead ) { _monotone=false; continue; }
+          if( P ) P[ii]=i+1;
+          _heap.decrease(ii,key(o,D,ii));
+        }
+      }
+      if( o.is_end && o.is_end[i] ) break;
+    }
+    return nIter;
+  }
+
+  /** State of every node (kDead, kOpen or kFar) after the last run. */
+  const signed char* state() const { return &_state[0]; }
+
+  /** False if the last run had to lower the distance of a dead node. */
+  bool monotone() const { return _monotone; }
+
+private:
+  static double key( const options &o, const double *D, int i ) {
+    return o.H ? D[i]+o.H[i] : D[i];
+  }
+
+  int _n;
+  const double *_pr;
+  const mwIndex *_ir, *_jc;
+  dary_heap _heap;
+  std::vector<signed char> _state;
+  bool _monotone;
+};
+
+/** Single source Dijkstra from each of the nSrc sources (0 indexed, must be
+    valid). D and P (may be NULL) are nSrc x n column major matrices, row i
+    holds the result for src[i]. Sources are split among nThreads threads
+    (<1 means all available), each with its own engine and buffers. */
+inline void sparse_dijkstra_multi( int n, const double *pr, const mwIndex *ir,
+  const mwIndex *jc, const int *src, int nSrc, double *D, double *P,
+  const sparse_dijkstra::options &o, int nThreads=-1 )
+{
+  #ifdef _OPENMP
+  if( nThreads<1 ) nThreads=omp_get_max_threads();
+  if( nThreads>nSrc ) nThreads=nSrc;
+  #pragma omp parallel num_threads(nThreads)
+  #endif
+  {
+    sparse_dijkstra dijk(n,pr,ir,jc);
+    std::vector<double> D1(n), P1(P ? n : 0);
+    #ifdef _OPENMP
+    #pragma omp for schedule(dynamic)
+    #endif
+    for( int i=0; i<nSrc; i++ ) {
+      dijk.run(src+i,1,&D1[0],P ? &P1[0] : NULL,o);
+      for( int j=0; j<n; j++ ) D[i+(size_t)j*nSrc]=D1[j];
+      if( P ) for( int j=0; j<n; j++ ) P[i+(size_t)j*nSrc]=P1[j];
+    }
+  }
+}
+
+#endif // _SPARSE_DIJKSTRA_HPP_
@@ -1,7 +1,11 @@
 clear all;
 fprintf('Compiling mex files ... ');
 
-% compile mex files
-mex mex/perform_adaptive_filtering.cpp
+% compile mex files (with OpenMP for the multithreaded filtering)
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/perform_adaptive_filtering.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/perform_adaptive_filtering.cpp
+end
 
 disp('done.');
\ No newline at end of file
@@ -1,26 +1,48 @@
 /*=================================================================
 % perform_adaptive_filtering - perform adaptive filtering
-%
-%   B = perform_adaptive_filtering(A,H,I);
-%
+%   
+%   B = perform_adaptive_filtering(A,H,I [,nb_threads]);
+%   
 %   A is an n1 x n2 input image.
 %   H is a p1 x p2 x m matrix, each H(:,:,k) being a filter.
 %       Note that p1 and p2 should be odd integers.
 %       Note that during filter, H(:,:,k) is automatically normalized
-%       to sum to 1.
-%   I is a p1 x p2 matrix of integer in {1,...,m}. I(i,j) is the filter to 
+%       by the sum of its absolute values (only the taps that fall
+%       inside the image are taken into account).
+%   I is a n1 x n2 matrix of integer in {1,...,m}. I(i,j) is the filter to
 %       use in pixel (i,j)
-%   B is an n x p output image.
-%
-%       B(i,j) = sum_x A(i+x1,j+x1) H(x1,x2,I(i,j))
+%   B is an n1 x n2 output image.
+%   nb_threads is the number of threads (default : all of them).
+%   
+%       B(i,j) = sum_x A(i+x1,j+x2) H(x1,x2,I(i,j))
+%   
+%   The image is processed by tiles (in parallel when compiled with OpenMP).
+%   In each tile, the pixels are grouped by filter. Each filter is
+%   factored by an SVD, and when it has a low rank (e.g. separable
+%   filters, rank 1) and enough pixels of the tile use it, it is applied
+%   to the whole tile by 1D passes, otherwise it is applied directly in
+%   each of its pixels. The normalization is read in summed area tables
+%   of |H(:,:,k)|.
 %   
 %   Copyright (c) 2006 Gabriel Peyr
 *=================================================================*/
 
 #include "mex.h"
+#include <math.h>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 #define		GW_ABS(a)       ((a) > 0 ? (a) : -(a))			//!<	Returns the absolute value a
+#define		GW_MIN(a,b)     ((a) < (b) ? (a) : (b))
+#define		GW_MAX(a,b)     ((a) > (b) ? (a) : (b))
+
+/* size of the tiles */
+#define TILE_SIZE 64
+/* singular values below this (relative to the largest) are dropped */
+#define SVD_TOLERANCE 1e-12
 
 
 #define A_(i,j) A[(i)+n1*(j)]
@@ -28,6 +50,101 @@
 #define I_(i,j) I[(i)+n1*(j)]
 #define H_(i,j,k) H[(i)+p1*(j)+p1*p2*(k)]
 
+/* one filter, with its low rank factorization
+    H(s1,s2) = sum_r U(s1,r) V(s2,r)
+   and the summed area table of |H| */
+struct filter
+{ 
+    const double* H;
+    int rank;
+    std::vector<double> U;  // p1 x rank
+    std::vector<double> V;  // p2 x rank
+    std::vector<double> S;  // (p1+1) x (p2+1)
+    double total;
+};
+
+/* one-sided Jacobi SVD of the p1 x p2 matrix H,
+   keeps only the significant singular values */
+void factor_filter( filter& f, const double* H, int p1, int p2 )
+{ 
+    std::vector<double> W(H, H+p1*p2);
+    std::vector<double> X(p2*p2, 0.0);
+    for( int j=0; j<p2; ++j )
+        X[j+p2*j] = 1;
+    for( int sweep=0; sweep<60; ++sweep )
+    {
+        bool rotated = false;
+        for( int a=0; a<p2-1; ++a )
+        for( int b=a+1; b<p2; ++b )
+        {
+            double* wa = &W[p1*a];
+            double* wb = &W[p1*b];
+            double alpha = 0, beta = 0, gamma = 0;
+            for( int i=0; i<p1; ++i )
+            {
+                alpha += wa[i]*wa[i];
+                beta  += wb[i]*wb[i];
+                gamma += wa[i]*wb[i];
+            }
+            if( GW_ABS(gamma) <= 1e-15*sqrt(alpha*beta) )
+                continue;
+            rotated = true;
+            double zeta = (beta-alpha)/(2*gamma);
+            double t = (zeta>=0 ? 1 : -1) / ( GW_ABS(zeta) + sqrt(1+zeta*zeta) );
+            double c = 1/sqrt(1+t*t);
+            double s = c*t;
+            for( int i=0; i<p1; ++i )
+            {
+                double x = wa[i], y = wb[i];
+                wa[i] = c*x - s*y;
+                wb[i] = s*x + c*y;
+            }
+            for( int i=0; i<p2; ++i )
+            {
+                double x = X[i+p2*a], y = X[i+p2*b];
+                X[i+p2*a] = c*x - s*y;
+                X[i+p2*b] = s*x + c*y;
+            }
+        }
+        if( !rotated )
+            break;
+    }
+    // the singular values are the norms of the columns of W
+    std::vector<double> sigma(p2);
+    double smax = 0;
+    for( int j=0; j<p2; ++j )
+    {
+        double s = 0;
+        for( int i=0; i<p1; ++i )
+            s += W[i+p1*j]*W[i+p1*j];
+        sigma[j] = sqrt(s);
+        smax = GW_MAX(smax, sigma[j]);
+    }
+    f.rank = 0;
+    f.U.clear(); f.V.clear();
+    for( int j=0; j<p2; ++j )
+    {
+        if( sigma[j]<=SVD_TOLERANCE*smax )
+            continue;
+        f.U.insert( f.U.end(), W.begin()+p1*j, W.begin()+p1*(j+1) );
+        f.V.insert( f.V.end(), X.begin()+p2*j, X.begin()+p2*(j+1) );
+        f.rank++;
+    }
+}
+
+void init_filter( filter& f, const double* H, int p1, int p2 )
+{ 
+    f.H = H;
+    factor_filter(f, H, p1, p2);
+    f.S.assign( (p1+1)*(p2+1), 0.0 );
+    for( int s2=0; s2<p2; ++s2 )
+    for( int s1=0; s1<p1; ++s1 )
+        f.S[(s1+1)+(p1+1)*(s2+1)] = GW_ABS(H[s1+p1*s2])
+            + f.S[s1+(p1+1)*(s2+1)] + f.S[(s1+1)+(p1+1)*s2] - f.S[s1+(p1+1)*s2];
+    f.total = 0;
+    for( int k=0; k<p1*p2; ++k )
+        f.total += GW_ABS(H[k]);
+}
 
 void mexFunction(	int nlhs, mxArray *plhs[], 
 				 int nrhs, const mxArray*prhs[] ) 
@@ -46,7 +163,9 @@ void mexFunction(	int nlhs, mxArray *plhs[],
     // secong argument : input filters
     int p1 = mxGetDimensions(prhs[1])[0];
     int p2 = mxGetDimensions(prhs[1])[1];
-    int m = mxGetDimensions(prhs[1])[2];
+    int m = 1;
+    if( mxGetNumberOfDimensions(prhs[1])>2 )
+        m = mxGetDimensions(prhs[1])[2];
     double* H = mxGetPr(prhs[1]);
     if( (p1%2)!=1 || (p2%2)!=1 )
         mexErrMsgTxt("Filters should be of odd size."); 
@@ -57,6 +176,14 @@ void mexFunction(	int nlhs, mxArray *plhs[],
     double* I = mxGetPr(prhs[2]);
     if( a1!=n1 || a2!=n2 )
         mexErrMsgTxt("Array A and I should be of the same size."); 
+    for( int k=0; k<n1*n2; ++k )
+        if( !(I[k]>=1 && I[k]<m+1) )
+            mexErrMsgTxt("I should contain integers in {1,...,m}.");
+
+    // fourth argument : number of threads
+    int nb_threads = 0;
+    if( nrhs>=4 )
+        nb_threads = (int) mxGetScalar(prhs[3]);
 
     // output results
 	plhs[0] = mxCreateDoubleMatrix(n1, n2, mxREAL);
@@ -65,25 +192,141 @@ void mexFunction(	int nlhs, mxArray *plhs[],
     int q1 = (p1-1)/2;
     int q2 = (p2-1)/2;
 
-    // perform filtering
-    for( int j=0; j<n2; ++j )
+    std::vector<filter> filters(m);
+    for( int h=0; h<m; ++h )
+        init_filter( filters[h], &H_(0,0,h), p1, p2 );
+
+    int t1 = (n1+TILE_SIZE-1)/TILE_SIZE;
+    int t2 = (n2+TILE_SIZE-1)/TILE_SIZE;
+    int nb_tiles = t1*t2;
+
+#ifdef _OPENMP
+    if( nb_threads<=0 )
+        nb_threads = omp_get_max_threads();
+#pragma omp parallel num_threads(nb_threads)
+#endif
     {
-        for( int i=0; i<n1; ++i )
+        // per thread buffers
+        std::vector<double> P;      // zero padded tile of A
+        std::vector<double> T;      // result of the 1D pass along the first dimension
+        std::vector<int> count(m+1), start(m+1), pixels;
+        std::vector<int> used;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for( int t=0; t<nb_tiles; ++t )
         {
-            // number of the filter
-            int h = (int) (I_(i,j)-1);
-            B_(i,j) = 0;
-            double v = 0;   // normalization value
-            for( int s1=-q1; s1<=q1; ++s1 )
-            for( int s2=-q2; s2<=q2; ++s2 )
+            int i0 = (t%t1)*TILE_SIZE, i1 = GW_MIN(i0+TILE_SIZE, n1);
+            int j0 = (t/t1)*TILE_SIZE, j1 = GW_MIN(j0+TILE_SIZE, n2);
+            int m1 = i1-i0, m2 = j1-j0;
+            // P(x1,x2) = A(i0-q1+x1, j0-q2+x2), zero outside of the image
+            int r1 = m1+2*q1, r2 = m2+2*q2;
+            P.assign(r1*r2, 0.0);
+            for( int x2=GW_MAX(0,q2-j0); x2<r2 && j0-q2+x2<n2; ++x2 )
             {
-                if( (i+s1>=0) && (i+s1<n1) && (j+s2>=0) && (j+s2<n2)  )
+                int xa = GW_MAX(0,q1-i0), xb = GW_MIN(r1, n1-i0+q1);
+                for( int x1=xa; x1<xb; ++x1 )
+                    P[x1+r1*x2] = A_(i0-q1+x1, j0-q2+x2);
+            }
+
+            // group the pixels of the tile by filter
+            used.clear();
+            for( int j=j0; j<j1; ++j )
+            for( int i=i0; i<i1; ++i )
+            {
+                int h = (int) (I_(i,j)-1);
+                if( count[h]==0 )
+                    used.push_back(h);
+                count[h]++;
+            }
+            int s = 0;
+            for( size_t u=0; u<used.size(); ++u )
+            {
+                start[used[u]] = s;
+                s += count[used[u]];
+                count[used[u]] = start[used[u]];
+            }
+            pixels.resize(m1*m2);
+            for( int j=j0; j<j1; ++j )
+            for( int i=i0; i<i1; ++i )
+                pixels[ count[(int) (I_(i,j)-1)]++ ] = (i-i0) + m1*(j-j0);
+
+            for( size_t u=0; u<used.size(); ++u )
+            {
+                int h = used[u];
+                const filter& f = filters[h];
+                int* pix = &pixels[start[h]];
+                int c = count[h]-start[h];
+                count[h] = 0;
+                // compare the number of operations of the two methods
+                double cost_direct = (double) c*p1*p2;
+                double cost_separable = (double) f.rank*( (double) m1*r2*p1 + (double) c*p2 );
+                if( f.rank>0 && cost_separable<cost_direct )
+                {
+                    for( int k=0; k<c; ++k )
+                        B[i0+(pix[k]%m1) + n1*(j0+pix[k]/m1)] = 0;
+                    T.resize(m1*r2);
+                    for( int r=0; r<f.rank; ++r )
+                    {
+                        const double* U = &f.U[p1*r];
+                        const double* V = &f.V[p2*r];
+                        // pass along the first dimension on the whole tile
+                        for( int x2=0; x2<r2; ++x2 )
+                        {
+                            const double* Pc = &P[r1*x2];
+                            double* Tc = &T[m1*x2];
+                            for( int x1=0; x1<m1; ++x1 )
+                                Tc[x1] = 0;
+                            for( int s1=0; s1<p1; ++s1 )
+                            {
+                                double w = U[s1];
+                                for( int x1=0; x1<m1; ++x1 )
+                                    Tc[x1] += w*Pc[x1+s1];
+                            }
+                        }
+                        // pass along the second dimension on the pixels only
+                        for( int k=0; k<c; ++k )
+                        {
+                            int x1 = pix[k]%m1, x2 = pix[k]/m1;
+                            double v = 0;
+                            for( int s2=0; s2<p2; ++s2 )
+                                v += V[s2]*T[x1+m1*(x2+s2)];
+                            B[i0+x1 + n1*(j0+x2)] += v;
+                        }
+                    }
+                }
+                else
+                {
+                    for( int k=0; k<c; ++k )
+                    {
+                        int x1 = pix[k]%m1, x2 = pix[k]/m1;
+                        double v = 0;
+                        for( int s2=0; s2<p2; ++s2 )
+                        {
+                            const double* Pc = &P[x1+r1*(x2+s2)];
+                            const double* Hc = f.H + p1*s2;
+                            for( int s1=0; s1<p1; ++s1 )
+                                v += Pc[s1]*Hc[s1];
+                        }
+                        B[i0+x1 + n1*(j0+x2)] = v;
+                    }
+                }
+                // normalization by the sum of |H| over the taps inside the image
+                for( int k=0; k<c; ++k )
                 {
-                    B_(i,j) += A_( i+s1,j+s2 ) * H_( s1+q1,s2+q2,h );
-                    v += GW_ABS(H_( s1+q1,s2+q2,h ));
+                    int i = i0 + pix[k]%m1, j = j0 + pix[k]/m1;
+                    double v = f.total;
+                    if( i<q1 || i>=n1-q1 || j<q2 || j>=n2-q2 )
+                    {
+                        int a = GW_MAX(0,q1-i), b = GW_MIN(p1, n1-i+q1);
+                        int a2 = GW_MAX(0,q2-j), b2 = GW_MIN(p2, n2-j+q2);
+                        v =   f.S[b+(p1+1)*b2] - f.S[a+(p1+1)*b2]
+                            - f.S[b+(p1+1)*a2] + f.S[a+(p1+1)*a2];
+                    }
+                    B_(i,j) /= v;
                 }
             }
-            B_(i,j) /= v;
         }
     }
 }
@@ -1,7 +1,11 @@
 % compile mex file
 
 
-mex mex/perform_nlmeans_mex.cpp
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/perform_nlmeans_mex.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/perform_nlmeans_mex.cpp
+end
 % mex mex/perform_nlmeans.cpp -o perform_nl_means_mex
 % mex mex/compute_pairwise_distance.cpp
 % mex mex/denoising_nn.cpp
\ No newline at end of file
@@ -1,7 +1,7 @@
 /*=================================================================
 % denoise - denoise an image.
 %
-%   [M1,Wx,Wy] = perform_nlmeans_vectorized(Ma,H,Ha,Vx,Vy,T,max_dist,do_median,mask,exlude_self);
+%   [M1,Wx,Wy] = perform_nlmeans_vectorized(Ma,H,Ha,Vx,Vy,T,max_dist,do_median,do_patchwise,mask_process,mask_copy,exlude_self,nb_best,nb_threads);
 %
 %	Ma is the image used to perform denoising.
 %	H is a high dimensional representation (generaly patch wise) of the image to denoise.
@@ -12,10 +12,18 @@
 %	max_dist restricts the search size around position given by Vx,Vy.
 %	mask_process restrict the area of filtering (useful for inpainting)
 %	exclude_self avoid to take into account the central pixel
+%	nb_best if >0, only the nb_best closest patches of the search window
+%		are used (as for block matching grouping), default 0 (all).
+%	nb_threads is the number of threads (default : all of them).
 %	
 %	M1 is the denoised image
 %	Wx is the new center x position for next seach (center of best fit)
 %	Wy is the new center y position for next seach (center of best fit)
+%
+%	The best fits Wx,Wy of a pass are good search centers Vx,Vy for the
+%	next one : with nb_best>0 the candidates around the center are tested
+%	first, which gives early a tight bound to stop the distance
+%	computations of the other candidates.
 %   
 %   Copyright (c) 2006 Gabriel Peyr
 *=================================================================*/
@@ -26,15 +34,21 @@
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
+#include <vector>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+	#define USE_SSE2
+	#include <emmintrin.h>
+#endif
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
 
 #define access(M,a,b,c) M[(a)+m*(b)+m*n*(c)]
 #define accessa(Ma,a,b,c) Ma[(a)+ma*(b)+ma*na*(c)]
 
 #define Ma_(a,b,c) accessa(Ma,a,b,c)
-#define Ha_(a,b,c) accessa(Ha,a,b,c)
-#define w_(a,b) accessa(w,a,b,0)
 
-#define H_(a,b,c) access(H,a,b,c)
 #define M1_(a,b,c) access(M1,a,b,c)
 #define Vx_(a,b) access(Vx,a,b,0)
 #define Vy_(a,b) access(Vy,a,b,0)
@@ -46,6 +60,13 @@
 #define CHECK_MASK_PROCESS(i,j) if( mask_process==NULL || mask_process_(i,j)>0.5 )
 #define CHECK_MASK_COPY(i,j) if( mask_copy==NULL || mask_copy_(i,j)<0.5 )
 
+// the patch of pixel (a,b), its k coefficients are contiguous
+#define Hp_(a,b) (Hp + ((a)+m*(b))*k)
+#define Hap_(a,b) (Hap + ((a)+ma*(b))*k)
+
+// size of the tiles of pixels given to each thread
+#define TILE_SIZE 16
+
 
 /* Global variables */
 int n = -1;	// width of M
@@ -56,6 +77,8 @@ double* M1 = NULL;	// output
 double* Ma = NULL;	// exemplar image to transfer 
 double* H = NULL;	// vectorized patches to denoise
 double* Ha = NULL;	// vectorized exemplar patches to transfer
+double* Hp = NULL;	// H with the coefficients of each patch contiguous
+double* Hap = NULL;	// Ha with the coefficients of each patch contiguous
 double* Vx = NULL;
 double* Vy = NULL;
 double* Wx = NULL;
@@ -63,7 +86,6 @@ double* Wy = NULL;
 double* mask_process = NULL;
 double* mask_copy = NULL;
 bool exclude_self = false;
-double* w = NULL;
 int k = -1;			// dimensionality of the vectorized patches H,Ha
 int s = -1;			// number of color chanels of M,Ma
 double T = 0.05f;	// width of the gaussian
@@ -71,6 +93,8 @@ int max_dist = 10;	// max distance for searching
 bool do_median= false; // use L1 fit
 bool do_patchwise = false;
 bool use_lun= false; // use L1 or L2 for distances
+int nb_best = 0;	// number of candidates kept, 0 for all
+int nb_threads = 0;	// number of threads, 0 for all
 
 inline void display_message(const char* mess, int v)
 {
@@ -122,23 +146,65 @@ inline double weight_laplacian(double x)
 #define weight_func weight_gaussian
 
 /* 
-	compute the SQUARE distance between two windows.
-	(i,j) is the center for the pixel to denoise (in H)
-	(i1,j1) is the center for the potential pixel (in Ha), 
-	k is the dimensionality of the vectors
+	compute the sum of the SQUARE differences (or of the absolute
+	differences with use_lun) between two vectors x and y of size k.
+	The computation stops as soon as the sum is larger than bound.
 */
 inline
-double dist_windows( int i, int j, int i1, int j1 )
+double dist_sum( const double* x, const double* y, double bound )
 {
+	int a = 0;
 	double dist = 0;
-	for( int a=0; a<k; ++a )
+	if( use_lun )
+	{
+		for( ; a<k; ++a )
+			dist += GW_ABS(x[a]-y[a]);
+		return dist;
+	}
+#ifdef USE_SSE2
+	__m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+	for( ; a+4<=k; a+=4 )
+	{
+		__m128d d0 = _mm_sub_pd( _mm_loadu_pd(x+a), _mm_loadu_pd(y+a) );
+		__m128d d1 = _mm_sub_pd( _mm_loadu_pd(x+a+2), _mm_loadu_pd(y+a+2) );
+		s0 = _mm_add_pd( s0, _mm_mul_pd(d0,d0) );
+		s1 = _mm_add_pd( s1, _mm_mul_pd(d1,d1) );
+		if( (a&15)==12 )
+		{
+			double t[2];
+			_mm_storeu_pd( t, _mm_add_pd(s0,s1) );
+			if( t[0]+t[1]>bound )
+				return t[0]+t[1];
+		}
+	}
+	double t[2];
+	_mm_storeu_pd( t, _mm_add_pd(s0,s1) );
+	dist = t[0]+t[1];
+#else
+	double d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+	for( ; a+4<=k; a+=4 )
+	{
+		double e0 = x[a]-y[a], e1 = x[a+1]-y[a+1], e2 = x[a+2]-y[a+2], e3 = x[a+3]-y[a+3];
+		d0 += e0*e0; d1 += e1*e1; d2 += e2*e2; d3 += e3*e3;
+		if( (a&15)==12 && d0+d1+d2+d3>bound )
+			return d0+d1+d2+d3;
+	}
+	dist = (d0+d1)+(d2+d3);
+#endif
+	for( ; a<k; ++a )
 	{
-		double d = H_(i,j,a) - Ha_(i1,j1,a);
-		if( use_lun ) 
-			dist += GW_ABS(d);
-		else
-			dist += d*d;
+		double d = x[a]-y[a];
+		dist += d*d;
 	}
+	return dist;
+}
+
+/*
+	compute the distance between two windows, from the output of dist_sum.
+*/
+inline
+double dist_windows( double dist )
+{
 	if( use_lun )
 		return dist/k;
 	else
@@ -164,140 +230,270 @@ int pixel_cmp(const void *a1, const void *a2)
   	return 0;
 }
 
-double compute_weights(int i, int j, int i_min,int i_max,int j_min,int j_max)
+// the search window of a pixel, and the buffers of a thread
+struct window
 {		
+	int i_min, i_max, j_min, j_max;
+	std::vector<double> w;		// weight of each pixel of the window
+	std::vector<double> d;		// distance sum of each pixel of the window
+	std::vector< std::pair<double,int> > best;	// heap of the nb_best candidates
+	std::vector<pixel> vals;	// for the median
+};
+
+#define w_(i1,j1) win.w[((i1)-win.i_min)*(win.j_max-win.j_min+1)+((j1)-win.j_min)]
+
+inline void set_window( int i, int j, window& win )
+{
+	// center for the search
+	int ic = (int) Vx_(i,j);
+	int jc = (int) Vy_(i,j);
+	win.i_min = GW_MAX(0,ic-max_dist);
+	win.i_max = GW_MIN(ma-1,ic+max_dist);
+	win.j_min = GW_MAX(0,jc-max_dist);
+	win.j_max = GW_MIN(na-1,jc+max_dist);
+}
+
+/* test the candidate (i1,j1) for the nb_best selection */
+inline void test_candidate( int i, int j, int i1, int j1, window& win )
+{
+	int wj = win.j_max-win.j_min+1;
+	int num = (i1-win.i_min)*wj + (j1-win.j_min);
+	if( win.d[num]>=0 )
+		return;	// already tested
+	if( exclude_self && i1==i && j1==j )
+	{
+		win.d[num] = HUGE_VAL;
+		return;
+	}
+	std::vector< std::pair<double,int> >& best = win.best;
+	bool full = (int) best.size()>=nb_best;
+	double d = dist_sum( Hp_(i,j), Hap_(i1,j1), full ? best.front().first : HUGE_VAL );
+	win.d[num] = d;
+	if( !full )
+	{
+		best.push_back( std::pair<double,int>(d,num) );
+		std::push_heap( best.begin(), best.end() );
+	}
+	else if( d<best.front().first )
+	{
+		std::pop_heap( best.begin(), best.end() );
+		best.back() = std::pair<double,int>(d,num);
+		std::push_heap( best.begin(), best.end() );
+	}
+}
+
+double compute_weights(int i, int j, window& win)
+{
+	int i_min = win.i_min, i_max = win.i_max, j_min = win.j_min, j_max = win.j_max;
+	int wj = j_max-j_min+1;
+	int nw = (i_max-i_min+1)*wj;
+	win.w.resize(nw);
 	double dmin = 1e9; // value of minimum distance
 	double w_sum = 0;	// sum of all weights
-	for( int i1=i_min; i1<=i_max; ++i1 )	// pixels of Ma
-	for( int j1=j_min; j1<=j_max; ++j1 )
+	if( nb_best<=0 || nb_best>=nw )
 	{
-		if( (!exclude_self) || (i1!=i) || (j1!=j) )
+		const double* x = Hp_(i,j);
+		for( int i1=i_min; i1<=i_max; ++i1 )	// pixels of Ma
+		for( int j1=j_min; j1<=j_max; ++j1 )
 		{
-		double ww = dist_windows( i,j, i1,j1 );
-		if( ww<dmin )
+			if( (!exclude_self) || (i1!=i) || (j1!=j) )
+			{
+			double ww = dist_windows( dist_sum( x, Hap_(i1,j1), HUGE_VAL ) );
+			if( ww<dmin )
+			{
+				// update best fit
+				Wx_(i,j) = i1; Wy_(i,j) = j1;
+				dmin = ww;
+			}
+			ww = weight_func(ww);
+			w_sum += ww;
+			w_(i1,j1) = ww;
+			}
+			else
+				w_(i1,j1) = 0;
+		}
+	}
+	else
+	{
+		// keep the nb_best closest candidates
+		win.d.assign(nw, -1);
+		win.best.clear();
+		// first the neighbors of the center of the search (the previous best fit)
+		int ic = GW_MIN( GW_MAX((int) Vx_(i,j), i_min), i_max );
+		int jc = GW_MIN( GW_MAX((int) Vy_(i,j), j_min), j_max );
+		test_candidate( i,j, ic,jc, win );
+		for( int i1=GW_MAX(ic-1,i_min); i1<=GW_MIN(ic+1,i_max); ++i1 )
+		for( int j1=GW_MAX(jc-1,j_min); j1<=GW_MIN(jc+1,j_max); ++j1 )
+			test_candidate( i,j, i1,j1, win );
+		for( int i1=i_min; i1<=i_max; ++i1 )
+		for( int j1=j_min; j1<=j_max; ++j1 )
+			test_candidate( i,j, i1,j1, win );
+		std::fill( win.w.begin(), win.w.end(), 0.0 );
+		int num_min = nw;
+		for( size_t c=0; c<win.best.size(); ++c )
 		{
-			// update best fit
-			Wx_(i,j) = i1; Wy_(i,j) = j1;
-			dmin = ww;
+			int num = win.best[c].second;
+			double ww = dist_windows( win.best[c].first );
+			if( ww<dmin || (ww==dmin && num<num_min) )
+			{
+				dmin = ww;
+				num_min = num;
+			}
+			ww = weight_func(ww);
+			w_sum += ww;
+			win.w[num] = ww;
 		}
-		ww = weight_func(ww);
-		w_sum += ww;
-		w_(i1,j1) = ww;
+		if( num_min<nw )
+		{
+			// update best fit
+			Wx_(i,j) = i_min + num_min/wj;
+			Wy_(i,j) = j_min + num_min%wj;
 		}
-		else
-			w_(i1,j1) = 0;
 	}
 	if( w_sum<1e-9 )
 	{
 		// too low weights : using best fit
 		// display_messagef("w_sum=%.8f", w_sum);
 		w_sum = 1;
-		w_((int) Wx_(i,j),(int) Wy_(i,j)) = 1;
+		int i1 = (int) Wx_(i,j), j1 = (int) Wy_(i,j);
+		if( i1>=i_min && i1<=i_max && j1>=j_min && j1<=j_max )
+			w_(i1,j1) = 1;
 	}
 	return w_sum;
 }
 
-void denoise()
-{		
-	int i,j;
-	// allocate some space to do the sorting operation
-	pixel* vals = NULL;
-	if( do_median )
-		vals = (pixel*) malloc( (2*max_dist+1)*(2*max_dist+1)*sizeof(pixel) );
-	for( i=0; i<m; ++i ) // pixels of M
-	for( j=0; j<n; ++j )
+void denoise_pixel(int i, int j, window& win)
+{
+	set_window(i,j, win);
+	int i_min = win.i_min, i_max = win.i_max, j_min = win.j_min, j_max = win.j_max;
+	double w_sum = compute_weights(i,j, win);
+	/* perform reconstruction */
+	for( int a=0; a<s; ++a )
 	{
-		CHECK_MASK_PROCESS(i,j)
+		M1_(i,j,a) = 0;
+		if( !do_median )
 		{
-			
-		// center for the search
-		int ic = Vx_(i,j);
-		int jc = Vy_(i,j);
-		/* compute the weight for each windows */
-		int i_min = GW_MAX(0,ic-max_dist);
-		int i_max = GW_MIN(ma-1,ic+max_dist);
-		int j_min = GW_MAX(0,jc-max_dist);
-		int j_max = GW_MIN(na-1,jc+max_dist);
-//		display_message("max_dist=%d", max_dist);
-		double w_sum = compute_weights(i,j, i_min,i_max,j_min,j_max);
-		/* perform reconstruction */
-		for( int a=0; a<s; ++a )
-		{
-			M1_(i,j,a) = 0;
-			if( !do_median )
+			// traditional mean
+			for( int i1=i_min; i1<=i_max; ++i1 )
+			for( int j1=j_min; j1<=j_max; ++j1 )
 			{
-				// traditional mean
-				for( int i1=i_min; i1<=i_max; ++i1 )
-				for( int j1=j_min; j1<=j_max; ++j1 )
-				{
-					M1_(i,j,a) = M1_(i,j,a) + w_(i1,j1)/w_sum*Ma_(i1,j1,a);
-				}
+				M1_(i,j,a) = M1_(i,j,a) + w_(i1,j1)/w_sum*Ma_(i1,j1,a);
 			}
-			else	// median
+		}
+		else	// median
+		{
+			// create the list for ranking
+			win.vals.resize( (i_max-i_min+1)*(j_max-j_min+1) );
+			pixel* vals = &win.vals[0];
+			int count = -1;
+			for( int i1=i_min; i1<=i_max; ++i1 )
+			for( int j1=j_min; j1<=j_max; ++j1 )
 			{
-				// create the list for ranking
-				int count = -1;
-				for( int i1=i_min; i1<=i_max; ++i1 )
-				for( int j1=j_min; j1<=j_max; ++j1 )
+				// if( i1!=i || j1!=j )
 				{
-					// if( i1!=i || j1!=j )
-					{
-						count++;
-						vals[count].v =  Ma_(i1,j1,a);
-						vals[count].i = i1;
-						vals[count].j = j1;	
-					}
+					count++;
+					vals[count].v =  Ma_(i1,j1,a);
+					vals[count].i = i1;
+					vals[count].j = j1;
 				}
+			}
+			if( i>=i_min && i<=i_max && j>=j_min && j<=j_max )
 				w_sum -= w_(i,j);
-				// do the sorting
-				qsort(vals, count+1, sizeof(pixel), pixel_cmp);
-				// extract medial rank
-				double wcum = 0; int count1 = -1;
-				while( wcum<=w_sum/2 && count1<count )
-				{
-					count1++;
-					wcum = wcum + w_(vals[count1].i,vals[count1].j);
-					//display_messagef("v=%f",vals[count1].v);
-				}
-				//display_messagef("opt=%f",(double) count1);
-				// the medial value is count1
-				M1_(i,j,a) = vals[count1].v;
+			// do the sorting
+			qsort(vals, count+1, sizeof(pixel), pixel_cmp);
+			// extract medial rank
+			double wcum = 0; int count1 = -1;
+			while( wcum<=w_sum/2 && count1<count )
+			{
+				count1++;
+				wcum = wcum + w_(vals[count1].i,vals[count1].j);
+				//display_messagef("v=%f",vals[count1].v);
 			}
+			//display_messagef("opt=%f",(double) count1);
+			// the medial value is count1
+			M1_(i,j,a) = vals[count1].v;
 		}
-		
+	}
+}
+
+void denoise()
+{		
+	int t1 = (m+TILE_SIZE-1)/TILE_SIZE;
+	int t2 = (n+TILE_SIZE-1)/TILE_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nb_threads)
+#endif
+	{
+	window win;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for( int t=0; t<t1*t2; ++t )
+	{
+		int i0 = (t%t1)*TILE_SIZE, j0 = (t/t1)*TILE_SIZE;
+		for( int i=i0; i<GW_MIN(i0+TILE_SIZE,m); ++i ) // pixels of M
+		for( int j=j0; j<GW_MIN(j0+TILE_SIZE,n); ++j )
+		{
+			CHECK_MASK_PROCESS(i,j)
+				denoise_pixel(i,j, win);
 		}
 	}
-	if( do_median )
-		free(vals);
+	}
 }
 
 int wdist = 3; // width of the patches
 double lambda = 0.5;
 int niter = 1; 
 
+// accumulation buffers of a tile, which cover the tile widened by wdist
+#define Acc_(a,b,c) Acc[((a)-r_min)+tm*((b)-c_min)+tm*tn*(c)]
+#define Cat_(a,b,c) Cat[((a)-r_min)+tm*((b)-c_min)+tm*tn*(c)]
+
 void denoise_patchwise()
 {		
 	double* Cac = (double*) malloc( m*n*s*sizeof(double) );
 	// clear the accumulation buffers
 	memset(Cac,0,m*n*s*sizeof(double));
-	for( int i=0; i<m; ++i ) // pixels of M
-	for( int j=0; j<n; ++j )
+	int t1 = (m+TILE_SIZE-1)/TILE_SIZE;
+	int t2 = (n+TILE_SIZE-1)/TILE_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nb_threads)
+#endif
+	{
+	window win;
+	// each thread accumulates a tile at a time in its own buffers
+	int tw = TILE_SIZE+2*wdist;
+	std::vector<double> acc_buffer(tw*tw*s), cat_buffer(tw*tw*s);
+	double* Acc = &acc_buffer[0];
+	double* Cat = &cat_buffer[0];
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+	for( int t=0; t<t1*t2; ++t )
+	{
+	int i0 = (t%t1)*TILE_SIZE, j0 = (t/t1)*TILE_SIZE;
+	// pixels that the patches of the tile can reach
+	int r_min = GW_MAX(0,i0-wdist), r_max = GW_MIN(m-1,i0+TILE_SIZE-1+wdist);
+	int c_min = GW_MAX(0,j0-wdist), c_max = GW_MIN(n-1,j0+TILE_SIZE-1+wdist);
+	int tm = r_max-r_min+1, tn = c_max-c_min+1;
+	std::fill( acc_buffer.begin(), acc_buffer.begin()+tm*tn*s, 0.0 );
+	std::fill( cat_buffer.begin(), cat_buffer.begin()+tm*tn*s, 0.0 );
+	for( int i=i0; i<GW_MIN(i0+TILE_SIZE,m); ++i ) // pixels of M
+	for( int j=j0; j<GW_MIN(j0+TILE_SIZE,n); ++j )
 	{
 		CHECK_MASK_PROCESS(i,j)
 		{
-		// center for the search
-		int ic = Vx_(i,j);
-		int jc = Vy_(i,j);
 		// compute explorating region around (ic,jc)
-		int i_min = GW_MAX(0,ic-max_dist);
-		int i_max = GW_MIN(ma-1,ic+max_dist);
-		int j_min = GW_MAX(0,jc-max_dist);
-		int j_max = GW_MIN(na-1,jc+max_dist);
+		set_window(i,j, win);
+		int i_min = win.i_min, i_max = win.i_max, j_min = win.j_min, j_max = win.j_max;
 		// compute weight
-		double w_sum = compute_weights(i,j, i_min,i_max,j_min,j_max);
+		double w_sum = compute_weights(i,j, win);
 		for( int i1=i_min; i1<=i_max; ++i1 )
 		for( int j1=j_min; j1<=j_max; ++j1 )
 		{
+			double ww = w_(i1,j1);
+			if( ww==0 )
+				continue;
 			// all the correct points at distance wdist
 			int ti_min = -wdist;
 			ti_min = GW_MAX( GW_MAX( ti_min, -i ), -i1 );
@@ -319,13 +515,26 @@ void denoise_patchwise()
 				{
 					CHECK_MASK_COPY(i1+ti,j1+tj)
 					{
-						M1_(i+ti,j+tj,a) += w_(i1,j1)*Ma_(i1+ti,j1+tj,a);
-						Cac_(i+ti,j+tj,a) += w_(i1,j1);
+						Acc_(i+ti,j+tj,a) += ww*Ma_(i1+ti,j1+tj,a);
+						Cat_(i+ti,j+tj,a) += ww;
 					}
 				}
 			}
 		}
 	} // end if mask_process
+	}
+	// add the tile to the result, neighboring tiles overlap
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+	for( int a=0; a<s; ++a )
+	for( int j=c_min; j<=c_max; ++j )
+	for( int i=r_min; i<=r_max; ++i )
+	{
+		M1_(i,j,a) += Acc_(i,j,a);
+		Cac_(i,j,a) += Cat_(i,j,a);
+	}
+	}
 	}	
 	// normalize the result
 	for( int a=0; a<s; ++a )
@@ -343,11 +552,22 @@ void denoise_patchwise()
 	free(Cac);
 }
 
+/* copy the m x n x k array H into Hp where the coefficients of each patch are contiguous */
+void interleave_patches( const double* H, double* Hp, int m, int n, int k )
+{
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nb_threads)
+#endif
+	for( int p=0; p<m*n; ++p )
+		for( int a=0; a<k; ++a )
+			Hp[p*k+a] = H[p+m*n*a];
+}
+
 void mexFunction(	int nlhs, mxArray *plhs[], 
 					int nrhs, const mxArray*prhs[] ) 
 { 
-	if( nrhs<4 ) 
-		mexErrMsgTxt("4 input arguments required."); 
+	if( nrhs<5 )
+		mexErrMsgTxt("5 input arguments required.");
 	if( nlhs!=3 )
 		mexErrMsgTxt("3 output arguments required.");
 		
@@ -418,9 +638,21 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	exclude_self = false;
 	if( nrhs>=12 )  
 		exclude_self = *mxGetPr(prhs[11])>0.5;
+	// -- input 13 : nb_best
+	nb_best = 0;
+	if( nrhs>=13 )
+		nb_best = (int) *mxGetPr(prhs[12]);
+	// -- input 14 : nb_threads
+	nb_threads = 0;
+	if( nrhs>=14 )
+		nb_threads = (int) *mxGetPr(prhs[13]);
 	// check
-	if( nlhs>12 ) 
+	if( nrhs>14 )
 		mexErrMsgTxt("Too many input arguments.");
+#ifdef _OPENMP
+	if( nb_threads<=0 )
+		nb_threads = omp_get_max_threads();
+#endif
 		
 	// use robust distance with median
 //	use_lun = do_median;
@@ -428,7 +660,7 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 
 	
 	// -- outpout 1 : M1 -- 
-	int dims[3] = {m,n,s};
+	mwSize dims[3] = {(mwSize) m,(mwSize) n,(mwSize) s};
 	plhs[0] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL );	
 	M1 = mxGetPr(plhs[0]);
 	
@@ -439,15 +671,16 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	Wy = mxGetPr(plhs[2]);
 
 
-	// matrix of the weights for each pixel (same size as Ma)
-	w = (double*) malloc( ma*na*sizeof(double) );
-	memset(w,0,ma*na*sizeof(double));
+	// contiguous patches for the distance computations
+	Hp = (double*) malloc( m*n*k*sizeof(double) );
+	Hap = (double*) malloc( ma*na*k*sizeof(double) );
+	interleave_patches( H, Hp, m,n,k );
+	interleave_patches( Ha, Hap, ma,na,k );
     /* Do the actual computations in a subroutine */
 	if( !do_patchwise )
 		denoise();
 	else
 		denoise_patchwise();
-	free( w );
+	free( Hp );
+	free( Hap );
 }
-
-
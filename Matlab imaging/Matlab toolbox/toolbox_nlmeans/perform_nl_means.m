@@ -17,6 +17,11 @@ function [M1,Wx,Wy,mask_copy] = perform_nl_means(M, options)
 %       do_median: set to 0 (default) to perform traditional NLMeans,
 %           or set to 1 to perform L1 robust NLMeans 
 %           (usefull to deal with salt and pepper noise)
+%       nb_best: if >0, only the nb_best closest patches of each
+%           search window are averaged (default 0, all of them).
+%       nb_threads: number of threads (default 0, all of them).
+%       Vx,Vy: centers of the search in Ma, e.g. the best fits Wx,Wy
+%           returned by a previous call.
 %
 %   To avoid manipulating too high dimensional vectors, this code uses
 %   a PCA. Set options.ndims to control the dimension of the PCA (e.g. 25).
@@ -37,6 +42,8 @@ max_dist = getoptions(options, 'max_dist', 10);
 mask_process = getoptions(options, 'mask_process', []);
 mask_copy = getoptions(options, 'mask_copy', []);
 exclude_self = getoptions(options, 'exclude_self', 0);
+nb_best = getoptions(options, 'nb_best', 0);
+nb_threads = getoptions(options, 'nb_threads', 0);
 
 [m,n,s] = size(M);
 [ma,na,sa] = size(Ma);
@@ -64,7 +71,7 @@ if not(isfield(options, 'H'))
 else
     H = options.H;
 end
-[M1,Wx,Wy] = perform_nlmeans_mex(Ma,H,Ha,Vx-1,Vy-1,T,max_dist, do_median, do_patchwise, mask_process, mask_copy, exclude_self);
+[M1,Wx,Wy] = perform_nlmeans_mex(Ma,H,Ha,Vx-1,Vy-1,T,max_dist, do_median, do_patchwise, mask_process, mask_copy, exclude_self, nb_best, nb_threads);
 % convert back to matlab notation >0
 Wx = Wx + 1;
 Wy = Wy + 1;
@@ -66,8 +66,13 @@ void Allocator::optimalAllocate (CoeffSet **coeff, int nSets,
     return;                //   -- if this is within the budget, do it
   
   lambdaHigh = 1000000.0;
-  Real lastRateHigh = -1;
+  Real lastRateHigh;
+  rateHigh = -1;
   do {
+    // small budgets (e.g. for tiles) may never be reached -- remember
+    //   the last rate so that we can tell when lambda stops mattering
+    lastRateHigh = rateHigh;
+
     // try to use the smallest possible # of bits
     allocateLambda (coeff, nSets, lambdaHigh, rateHigh, distHigh, weight);
 
@@ -89,8 +94,14 @@ void Allocator::optimalAllocate (CoeffSet **coeff, int nSets,
     error ("Failed to bracket bit budget = %d: rateLow = %g rateHigh = %g\n", 
 	   budget, rateLow, rateHigh);
   
-  while (lambdaHigh - lambdaLow > 0.01)  {
+  // Real may be a float, so for large lambdas the midpoint rounds to
+  //   one of the end points long before the interval is 0.01 wide --
+  //   stop there, and never take more steps than the precision allows
+  currentRate = rateHigh;
+  for (int iter = 0; iter < 64 && lambdaHigh - lambdaLow > 0.01; iter++)  {
     lambda = (lambdaLow + lambdaHigh)/2.0;
+    if (lambda <= lambdaLow || lambda >= lambdaHigh)
+      break;
     
     allocateLambda (coeff, nSets, lambda, currentRate, currentDist, weight);
     
@@ -22,24 +22,32 @@
 #include "coeffset.hh"
 #include "allocator.hh"
 #include "quantizer.hh"
+#include "tile.hh"
 /*---------------------------------------------------------------------------*/
 void decompress     (Image **image, Wavelet *wavelet, int nStages, 
 		     int capacity, int paramPrecision, char *filename, 
-		     int nQuant, int monolayer);
+		     int nQuant, int monolayer, int *region);
 /*---------------------------------------------------------------------------*/
 
 int main (int argc, char **argv)
 {
   char *program = argv[0];
 
-  if (argc < 3)  {
-    fprintf (stderr, "Usage: %s [encoded image][decoded image]\n",
+  if (argc < 3 || (argc > 3 && argc < 7))  {
+    fprintf (stderr, 
+	     "Usage: %s [encoded image][decoded image][left top width height]\n",
 	     program);
+    fprintf (stderr, 
+	     "left top width height: region to decode from a tiled image (optional)\n");
     exit(0);
   }
 
   char *infile_name = argv[1];
   char *outfile_name = argv[2];
+  int region[4] = { 0, 0, -1, -1 };
+  if (argc > 3)
+    for (int i = 0; i < 4; i++)
+      region[i] = atoi(argv[3+i]);
   printf ("Reading compressed image %s, writing %s\n\n", 
 	  infile_name, outfile_name);
 
@@ -56,7 +64,7 @@ int main (int argc, char **argv)
 
   Image *reconstruct;
   decompress (&reconstruct, wavelet, nStages, capacity, paramPrecision,
-	      infile_name, nQuant, monolayer);
+	      infile_name, nQuant, monolayer, region);
 #ifdef PGM
   reconstruct->savePGM (outfile_name);
 #else
@@ -83,109 +91,31 @@ int main (int argc, char **argv)
 //                          used on any subband.  
 // char *filename        Name of compressed file
 // int monolayer         TRUE for non-embedded quantizer, FALSE for embedded
+// int *region           left, top, width and height of the part of a
+//                          tiled image to decode (-1 for the full width
+//                          or height); ignored for untiled images
 
 /*---------------------------------------------------------------------------*/
 void decompress (Image **image, Wavelet *wavelet, int nStages, 
 		 int capacity, int paramPrecision, char *filename, 
-		 int maxQuant, int monolayer)
+		 int maxQuant, int monolayer, int *region)
 {
-  int i;
-
   // open compressed image file
   ifstream infile (filename, ios::in | ios::nocreate | ios::binary);
   if (!infile) {
     error ("Unable to open file %s", filename);
   }
 
-  // Create I/O interface object for arithmetic decoder
-  Decoder *decoder = new Decoder (infile);
-
-  // Read image dimensions from file
-  int hsize = decoder->readPositive ();
-  int vsize = decoder->readPositive ();
-  //  printf ("hsize = %d, vsize = %d\n", hsize, vsize);
-
-  // Create an empty transform of the appropriate size -- fill it in
-  //    as coefficients are decoded
-  WaveletTransform *transform = 
-    new WaveletTransform (wavelet, hsize, vsize, nStages);
-
-  // For each subband allocate a CoeffSet, an EntropyCoder, and a
-  //    Quantizer (don't need to know anything about errors here)
-  int nSets = transform->nSubbands;
-  CoeffSet **coeff = new CoeffSet* [nSets];
-  EntropyCoder **entropy = new EntropyCoder* [nSets];
-  Quantizer **quant = new Quantizer* [nSets];
-  // Quantizer precision for each subband
-  int *precision = new int [nSets];
-
-  for (i = 0; i < nSets; i++) {
-    if (monolayer) {
-      // Use uniform quantizer and single layer escape coder for each
-      //   subband
-      entropy[i] = new EscapeCoder (capacity);
-      // Assume all subbands have pdf's centered around 0 except the
-      //   low pass subband 0
-      quant[i]   = new UniformQuant 
-	((MonoLayerCoder *)entropy[i], paramPrecision, i != 0);
-    } else {
-      // Use a layered quantizer with dead zones and a layered entropy
-      //   coder for each subband
-      entropy [i] = new LayerCoder (maxQuant, i != 0, capacity);
-      // Assume all subbands have pdf's centered around 0 except the
-      //   low pass subband 0
-      quant [i] = new LayerQuant 
-	((MultiLayerCoder *)entropy[i], paramPrecision, i != 0, maxQuant);
-    }
-    // Indicate that each set of coefficients to be read corresponds
-    //    to a subband
-    coeff[i]   = new CoeffSet (transform->subband(i),
-			       transform->subbandSize[i], quant[i]);
-  }
-
-  for (i = 0; i < nSets; i++) {
-    // Read quantizer parameters for each subband
-    coeff[i]->readHeader (decoder, precision[i]);
-    /*
-    if (monolayer) {
-      printf ("coeff[%d]->qmin = %g  qmax = %g  qmean = %g  precision=%d\n", i,
-	      ((UniformQuant *)(coeff[i]->quant))->qmin, 
-	      ((UniformQuant *)(coeff[i]->quant))->qmax,
-	      ((UniformQuant *)(coeff[i]->quant))->qmean,
-	      precision[i]);
-    } else {
-      printf ("coeff[%d]->qmin = %g  qmax = %g  qmean = %g precision=%d\n", i,
-	      ((LayerQuant *)(coeff[i]->quant))->qmin, 
-	      ((LayerQuant *)(coeff[i]->quant))->qmax,
-	      ((LayerQuant *)(coeff[i]->quant))->qmean,
-	      precision[i]);
-    }
-    */
-  }
-  for (i = 0; i < nSets; i++) {
-    // Read, decode, and dequantize coefficients for each subband
-    coeff[i]->decode (decoder, precision[i]);
-  }
+  if (isTiled (infile))
+    *image = decodeTiles (infile, wavelet, nStages, capacity,
+			  paramPrecision, maxQuant, monolayer, 
+			  region[0], region[1], region[2], region[3]);
+  else
+    *image = decodeImage (infile, wavelet, nStages, capacity,
+			  paramPrecision, maxQuant, monolayer);
 
   // Close file
-  delete decoder;
   infile.close ();
-
-  // Clean up
-  for (i = 0; i < nSets; i++) {
-    delete entropy[i];
-    delete quant[i];
-    delete coeff[i];
-  }
-  delete [] entropy;
-  delete [] quant;
-  delete [] coeff;
-  delete [] precision;
-
-  // Allocate image and invert transform
-  *image = new Image (hsize, vsize);
-  transform->invert (*image);
-  delete transform;
 }
   
 /*---------------------------------------------------------------------------*/
@@ -22,11 +22,13 @@
 #include "coeffset.hh"
 #include "allocator.hh"
 #include "quantizer.hh"
+#include "tile.hh"
 /*---------------------------------------------------------------------------*/
 void compress       (Image *image, Wavelet *wavelet, int nStages, 
 		     int capacity, Real p, Real *weight,
 		     int paramPrecision, int budget, int nQuant, 
-		     Real minStepSize, char *filename, int monolayer);
+		     Real minStepSize, char *filename, int monolayer,
+		     int tileSize);
 /*---------------------------------------------------------------------------*/
 
 int main (int argc, char **argv)
@@ -36,7 +38,7 @@ int main (int argc, char **argv)
 #ifdef PGM
   if (argc < 4)  {
     fprintf (stderr, 
-	     "Usage: %s [image][output][ratio]\n",
+	     "Usage: %s [image][output][ratio][tile size]\n",
 	     program);
     fprintf (stderr, 
 	     "image: image to be compressed (in PGM format)\n");
@@ -44,11 +46,14 @@ int main (int argc, char **argv)
 	     "output: name of compressed image\n");
     fprintf (stderr, 
 	     "ratio: compression ratio\n");
+    fprintf (stderr, 
+	     "tile size: code independent tiles of about this size (optional)\n");
     exit(0);
   }
   char *infile_name = argv[1];
   char *outfile_name = argv[2];
   Real ratio = atof(argv[3]);
+  int tileSize = (argc > 4) ? atoi(argv[4]) : 0;
 
   // Load the image to be coded
   Image *image = new Image (infile_name);
@@ -60,7 +65,7 @@ int main (int argc, char **argv)
 #else
   if (argc < 6)  {
     fprintf (stderr, 
-	     "Usage: %s [image][width][height][output][ratio]\n",
+	     "Usage: %s [image][width][height][output][ratio][tile size]\n",
 	     program);
     fprintf (stderr, 
 	     "image: image to be compressed (in RAW format)\n");
@@ -70,6 +75,8 @@ int main (int argc, char **argv)
 	     "output: name of compressed image\n");
     fprintf (stderr, 
 	     "ratio: compression ratio\n");
+    fprintf (stderr, 
+	     "tile size: code independent tiles of about this size (optional)\n");
     exit(0);
   }
   char *infile_name = argv[1];
@@ -77,6 +84,7 @@ int main (int argc, char **argv)
   int vsize = atoi(argv[3]);
   char *outfile_name = argv[4];
   Real ratio = atof(argv[5]);
+  int tileSize = (argc > 6) ? atoi(argv[6]) : 0;
   int budget = (int)((Real)(hsize*vsize)/ratio);  // (assumes 8 bit pixels)
   printf ("Reading %d x %d image %s, writing %s\nCompression ratio %g:1\n", 
 	  hsize, vsize, infile_name, outfile_name, ratio);
@@ -106,7 +114,7 @@ int main (int argc, char **argv)
 
   compress (image, wavelet, nStages, capacity, p, weight, 
 	    paramPrecision, budget, nQuant, minStepSize, outfile_name, 
-	    monolayer);
+	    monolayer, tileSize);
 
   delete [] weight;
   delete image;
@@ -136,122 +144,34 @@ int main (int argc, char **argv)
 //                          expended on fine-scale subbands
 // char *filename        name for compressed file
 // int monolayer         TRUE for non-embedded quantizer, FALSE for embedded
+// int tileSize          > 0 to code tiles of about this size concurrently
+//                          (see tile.hh), 0 to code the whole image
 
 /*---------------------------------------------------------------------------*/
 void compress (Image *image, Wavelet *wavelet, int nStages, 
 	       int capacity, Real p, Real *weight,
 	       int paramPrecision, int budget, int nQuant, 
-	       Real minStepSize, char *filename, int monolayer)
+	       Real minStepSize, char *filename, int monolayer,
+	       int tileSize)
 {
-  int i;
-  // Compute the wavelet transform of the given image
-  WaveletTransform *transform = 
-    new WaveletTransform (wavelet, image, nStages); 
-
-  // For each subband allocate a CoeffSet, an error metric, an
-  // EntropyCoder, and a Quantizer
-  int nSets = transform->nSubbands;
-  CoeffSet **coeff = new CoeffSet* [nSets];
-  ErrorMetric **err = new ErrorMetric* [nSets];
-  EntropyCoder **entropy = new EntropyCoder* [nSets];
-  Quantizer **quant = new Quantizer* [nSets];
-
-  for (i = 0; i < nSets; i++) {
-    // Use an L^p error metric for each subband
-    err[i] = new LpError (p);
-
-    if (monolayer) {
-      // Use uniform quantizer and single layer escape coder for each
-      //   subband
-      entropy[i] = new EscapeCoder  (capacity);
-      // Assume all subbands have pdf's centered around 0 except the
-      //   low pass subband 0
-      quant[i]   = new UniformQuant ((MonoLayerCoder *)entropy[i],
-				     paramPrecision, i != 0, err[i]);
-    } else {
-      // Use a layered quantizer with dead zones and a layered entropy
-      //   coder for each subband
-      entropy [i] = new LayerCoder (nQuant, i != 0, capacity);
-      // Assume all subbands have pdf's centered around 0 except the
-      //   low pass subband 0
-      quant [i] = new LayerQuant ((MultiLayerCoder *)entropy[i],
-				  paramPrecision, i != 0, nQuant, err[i]);
-    }
-    // Partition the wavelet transformed coefficients into subbands --
-    //   each subband will have a different quantizer
-    coeff[i]   = new CoeffSet (transform->subband(i),
-			       transform->subbandSize[i], quant[i]);
-
-    // For each subband determine the rate and distortion for each of
-    //    the possible nQuant quantizers
-    coeff[i]->getRateDist (nQuant, minStepSize);
-  }
-  
-  Allocator *allocator = new Allocator ();
-  // Use rate/distortion information for each subband to find bit
-  //    allocation that minimizes total (weighted) distortion subject
-  //    to a byte budget
-  budget -= nSets * 4;  // subtract off approximate size of header info
-  allocator->optimalAllocate (coeff, nSets, budget, TRUE, weight);
-  printf ("Target rate = %d bytes\n", budget);
-  // Display the resulting allocation
-  allocator->print (coeff, nSets);
-
   // Open output file
   ofstream outfile (filename, ios::out | ios::trunc | ios::binary);
   if (!outfile) {
     error ("Unable to open file %s", filename);
   }
-  // Create I/O interface object for arithmetic coder
-  Encoder *encoder = new Encoder (outfile);
-
-  // Write image size to output file
-  encoder->writePositive (image->hsize);
-  encoder->writePositive (image->vsize);
-  //  printf ("hsize = %d, vsize = %d\n", image->hsize, image->vsize);
 
-  for (i = 0; i < nSets; i++) {
-    // Write quantizer parameters for each subband to file
-    coeff[i]->writeHeader (encoder, allocator->precision[i]);
-    /*
-    if (monolayer) {
-      printf ("coeff[%d]->qmin = %g  qmax = %g  qmean = %g  precision=%d\n", i,
-    	      ((UniformQuant *)(coeff[i]->quant))->qmin, 
-	      ((UniformQuant *)(coeff[i]->quant))->qmax,
-	      ((UniformQuant *)(coeff[i]->quant))->qmean,
-	      allocator->precision[i]);
-    } else {
-      printf ("coeff[%d]->qmin = %g  qmax = %g  qmean = %g precision=%d\n", i,
-	      ((LayerQuant *)(coeff[i]->quant))->qmin, 
-	      ((LayerQuant *)(coeff[i]->quant))->qmax,
-	      ((LayerQuant *)(coeff[i]->quant))->qmean,
-	      allocator->precision[i]);
-    }
-    */
-  }
-  for (i = 0; i < nSets; i++) {
-    // Quantize and write entropy coded coefficients for each subband
-    coeff[i]->encode (encoder, allocator->precision[i]);
+  if (tileSize > 0) {
+    encodeTiles (image, tileSize, wavelet, nStages, capacity, p, weight,
+		 paramPrecision, budget, nQuant, minStepSize, outfile,
+		 monolayer);
+    printf ("Wrote %d bytes of tiles\n", (int)outfile.tellp ());
+  } else {
+    encodeImage (image, wavelet, nStages, capacity, p, weight,
+		 paramPrecision, budget, nQuant, minStepSize, outfile,
+		 monolayer, TRUE);
   }
 
-  // Flush bits from arithmetic coder and close file
-  encoder->flush ();
-  delete encoder;
   outfile.close ();
-
-  // Clean up
-  for (i = 0; i < nSets; i++) {
-    delete err[i];
-    delete entropy[i];
-    delete quant[i];
-    delete coeff[i];
-  }
-  delete [] err;
-  delete [] entropy;
-  delete [] quant;
-  delete [] coeff;
-  delete allocator;
-  delete transform;
 }
 
 /*---------------------------------------------------------------------------*/
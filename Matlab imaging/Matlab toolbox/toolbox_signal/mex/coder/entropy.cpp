@@ -188,27 +188,30 @@ LayerCoder::LayerCoder (int nLayers, int signedSym, int capacity) :
   int i, j;
   nFreq = new int [nLayers];
   freq = new iHistogram** [nLayers];
+  resetAt = new int* [nLayers];
 
   if (signedSym)
     nFreq[0] = 3;
   else
     nFreq[0] = 2;
-  freq[0] = new iHistogram* [nFreq[0]];
 
   for (i = 1; i < nLayers; i++) {
     if (signedSym)
       nFreq[i] = 2 * nFreq[i-1] + 1;
     else 
       nFreq[i] = 2 * nFreq[i-1];
-    freq[i] = new iHistogram* [nFreq[i]];
   }
 
   for (i = 0; i < nLayers; i++) {
+    freq[i] = new iHistogram* [nFreq[i]];
+    resetAt[i] = new int [nFreq[i]];
     for (j = 0; j < nFreq[i]; j++) {
-      freq[i][j] = new iHistogram (3, capacity);
+      freq[i][j] = NULL;
+      resetAt[i][j] = 0;
     }
   }
 
+  generation = 0;
   reset ();
 }
 
@@ -220,8 +223,10 @@ LayerCoder::~LayerCoder ()
       delete freq[i][j];
     }
     delete [] freq[i];
+    delete [] resetAt[i];
   }
   delete [] freq;
+  delete [] resetAt;
   delete [] nFreq;
 }
 
@@ -235,27 +240,28 @@ LayerCoder::~LayerCoder ()
 //    0, 1  -- 1 will be added to all incoming symbols
 
 void LayerCoder::reset ()
+{
+  // histograms are reset when they are next used
+  generation++;
+}
+
+/*---------------------------------------------------------------------------*/
+iHistogram *LayerCoder::histogram (int layer, int context)
 {
   int plusCounts[3] =  {0, 1, 1};
   int zeroCounts[3] =  {1, 1, 1};
-  int i, j;
 
-  if (signedSym) {
-    for (i = 0; i < nLayers; i++) {
-      for (j = -nFreq[i]/2; j < 0; j++)
-	freq[i][j+nFreq[i]/2]->InitCounts (plusCounts);
-	//	freq[i][j+nFreq[i]/2]->InitCounts (minus_counts);
-      freq[i][nFreq[i]/2]->InitCounts (zeroCounts);
-      for (j = 1; j <= nFreq[i]/2; j++)
-	freq[i][j+nFreq[i]/2]->InitCounts (plusCounts);
-    }
-  } else {
-    for (i = 0; i < nLayers; i++) {
-      for (j = 0; j < nFreq[i]; j++) {
-	freq[i][j]->InitCounts (plusCounts);
-      }
-    }
+  if (freq[layer][context] == NULL)
+    freq[layer][context] = new iHistogram (3, histoCapacity);
+
+  if (resetAt[layer][context] != generation) {
+    if (signedSym && context == nFreq[layer]/2)
+      freq[layer][context]->InitCounts (zeroCounts);
+    else
+      freq[layer][context]->InitCounts (plusCounts);
+    resetAt[layer][context] = generation;
   }
+  return freq[layer][context];
 }
 
 /*---------------------------------------------------------------------------*/
@@ -267,12 +273,13 @@ Real LayerCoder::write (Encoder *encoder, int symbol, char update,
   if (signedSym) {
     context += nFreq[layer]/2;
   }
+  iHistogram *h = histogram (layer, context);
   if (encoder != NULL)
-    encoder->writeSymbol (symbol, freq[layer][context]);
-  Real bits = freq[layer][context]->Entropy(symbol);
+    encoder->writeSymbol (symbol, h);
+  Real bits = h->Entropy(symbol);
   
   if (update)
-    freq[layer][context]->IncCount(symbol);
+    h->IncCount(symbol);
   return bits;
 }
 
@@ -286,9 +293,10 @@ int LayerCoder::read  (Decoder *decoder, char update, int layer, int context)
     context += nFreq[layer]/2;
   }
 
-  symbol = decoder->readSymbol (freq[layer][context]);
+  iHistogram *h = histogram (layer, context);
+  symbol = decoder->readSymbol (h);
   if (update)
-    freq[layer][context]->IncCount(symbol);
+    h->IncCount(symbol);
 
   symbol--;
   return symbol;
@@ -301,10 +309,11 @@ Real LayerCoder::cost (int symbol, char update, int layer, int context)
   if (signedSym) {
     context += nFreq[layer]/2;
   }
-  Real bits = freq[layer][context]->Entropy(symbol);
+  iHistogram *h = histogram (layer, context);
+  Real bits = h->Entropy(symbol);
   
   if (update)
-    freq[layer][context]->IncCount(symbol);
+    h->IncCount(symbol);
   return bits;
 }
 
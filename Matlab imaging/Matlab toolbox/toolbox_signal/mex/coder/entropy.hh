@@ -173,6 +173,14 @@ public:
   int nLayers;          // # of bitplane layers
   int *nFreq;           // # of frequency counts for each layer
   iHistogram *** freq;  // frequency counts for each context
+
+protected:
+  // Most of the 2^nLayers contexts are never seen, so histograms are
+  //   created, and reset, on first use after a reset
+  iHistogram *histogram (int layer, int context);
+
+  int generation;       // # of resets so far
+  int **resetAt;        // generation at which each histogram was reset
 };
 
 /*---------------------------------------------------------------------------*/
@@ -61,6 +61,18 @@ Real AntoniniAnalysis[] =  {  3.782845550699535e-02,
 			     -2.384946501937986e-02,
 			      3.782845550699535e-02 };
 
+// Lifting factorization of the 7/9 filters (I. Daubechies and
+// W. Sweldens, "Factoring wavelet transforms into lifting steps",
+// J. Fourier Anal. Appl., Vol. 4, pp. 247-269, 1998), scaled to match
+// the normalization and the sign of the high pass filter above.
+
+Real AntoniniLifting [] = { -1.586134342059924e+00,
+			    -5.298011857296100e-02,
+			     8.829110755309340e-01,
+			     4.435068520439710e-01,
+			     1.149604398860242e+00,
+			    -8.698644516247808e-01 };
+
 // Unpublished 18/10 filter from Villasenor's group
 
 Real Villa1810Synthesis [] = { 9.544158682436510e-04,
@@ -264,7 +276,7 @@ FilterSet Daub4     (FALSE, Daub4Coeffs,         4, 0);
 FilterSet Daub6     (FALSE, Daub6Coeffs,         6, 0);
 FilterSet Daub8     (FALSE, Daub8Coeffs,         8, 0);
 FilterSet Antonini  (TRUE,  AntoniniAnalysis,    9, -4, 
-		            AntoniniSynthesis,   7, -3);
+		            AntoniniSynthesis,   7, -3, AntoniniLifting, 4);
 FilterSet Villa1810 (TRUE,  Villa1810Analysis,  10, -4,
 		            Villa1810Synthesis, 18, -8);
 FilterSet Adelson   (TRUE,  AdelsonCoeffs,       9, -4);
@@ -323,13 +335,23 @@ void Filter::copy (const Filter& filter)
 
 FilterSet::FilterSet (int symmetric, 
 	     Real *anLow, int anLowSize, int anLowFirst,  
-	     Real *synLow, int synLowSize, int synLowFirst) : 
+	     Real *synLow, int synLowSize, int synLowFirst,
+	     Real *lift, int nLift) : 
              symmetric(symmetric) 
 {
   int i, sign;
 
   analysisLow = new Filter (anLowSize, anLowFirst, anLow);
 
+  // Lifting steps plus the two scale factors
+  nLifting = nLift;
+  lifting = NULL;
+  if (lift != NULL && nLift > 0) {
+    lifting = new Real [nLift+2];
+    for (i = 0; i < nLift+2; i++)
+      lifting[i] = lift[i];
+  }
+
   // If no synthesis coeffs are given, assume wavelet is orthogonal
   if (synLow == NULL)  {
     synthesisLow = new Filter (*analysisLow);
@@ -426,6 +448,8 @@ FilterSet::~FilterSet ()
   delete analysisHigh;
   delete synthesisLow;
   delete synthesisHigh;
+  if (lifting != NULL)
+    delete [] lifting;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -436,6 +460,8 @@ FilterSet& FilterSet::operator= (const FilterSet filterset)
   delete analysisHigh;
   delete synthesisLow;
   delete synthesisHigh;
+  if (lifting != NULL)
+    delete [] lifting;
   copy (filterset);
   return *this;
 }
@@ -449,6 +475,14 @@ void FilterSet::copy (const FilterSet& filterset)
   analysisHigh = new Filter (*(filterset.analysisHigh));
   synthesisLow = new Filter (*(filterset.synthesisLow));
   synthesisHigh = new Filter (*(filterset.synthesisHigh));
+
+  nLifting = filterset.nLifting;
+  lifting = NULL;
+  if (filterset.lifting != NULL) {
+    lifting = new Real [nLifting+2];
+    for (int i = 0; i < nLifting+2; i++)
+      lifting[i] = filterset.lifting[i];
+  }
 }
 
 /*---------------------------------------------------------------------------*/
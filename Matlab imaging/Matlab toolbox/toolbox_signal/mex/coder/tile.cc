@@ -0,0 +1,542 @@
+/*---------------------------------------------------------------------------*/
+// Baseline Wavelet Transform Coder Construction Kit
+//
+// Permission is granted to use this software for research purposes as
+// long as this notice stays attached to this software.
+//
+/*---------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream.h>
+#include <strstream.h>
+#include "transform.hh"
+#include "coeffset.hh"
+#include "allocator.hh"
+#include "quantizer.hh"
+#include "tile.hh"
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// Compress an image to a stream
+//
+// Image *image          Image to be compressed
+// Wavelet *wavelet      Wavelet to use for transform
+// int nStages           # of stages to use in transform
+// int capacity          Capacity of histograms for arithmetic coder
+// Real p                Exponent for L^p error metric
+// Real *weight          Perceptual weights for subbands
+// int paramPrecision    Precision for storing quantizer parameters --
+//                          precision = n means params are stored with
+//                          accuracy 2^(-n)
+// int budget            Total # of bytes for compressed image
+// int nQuant            # of different quantizer resolutions to
+//                          consider for each subband.  Step size for
+//                          quantizer k is roughly (max coeff - min coeff)/2^k
+// Real minStepSize      # minimum quantizer step size to consider --
+//                          prevents too much effort from being
+//                          expended on fine-scale subbands
+// ostream &out          Stream for the compressed image
+// int monolayer         TRUE for non-embedded quantizer, FALSE for embedded
+// int verbose           TRUE to print the allocation
+
+/*---------------------------------------------------------------------------*/
+void encodeImage (Image *image, Wavelet *wavelet, int nStages,
+		  int capacity, Real p, Real *weight,
+		  int paramPrecision, int budget, int nQuant,
+		  Real minStepSize, ostream &out, int monolayer,
+		  int verbose)
+{
+  int i;
+  // Compute the wavelet transform of the given image
+  WaveletTransform *transform =
+    new WaveletTransform (wavelet, image, nStages);
+
+  // For each subband allocate a CoeffSet, an error metric, an
+  // EntropyCoder, and a Quantizer
+  int nSets = transform->nSubbands;
+  CoeffSet **coeff = new CoeffSet* [nSets];
+  ErrorMetric **err = new ErrorMetric* [nSets];
+  EntropyCoder **entropy = new EntropyCoder* [nSets];
+  Quantizer **quant = new Quantizer* [nSets];
+
+  for (i = 0; i < nSets; i++) {
+    // Use an L^p error metric for each subband
+    err[i] = new LpError (p);
+
+    if (monolayer) {
+      // Use uniform quantizer and single layer escape coder for each
+      //   subband
+      entropy[i] = new EscapeCoder  (capacity);
+      // Assume all subbands have pdf's centered around 0 except the
+      //   low pass subband 0
+      quant[i]   = new UniformQuant ((MonoLayerCoder *)entropy[i],
+				     paramPrecision, i != 0, err[i]);
+    } else {
+      // Use a layered quantizer with dead zones and a layered entropy
+      //   coder for each subband
+      entropy [i] = new LayerCoder (nQuant, i != 0, capacity);
+      // Assume all subbands have pdf's centered around 0 except the
+      //   low pass subband 0
+      quant [i] = new LayerQuant ((MultiLayerCoder *)entropy[i],
+				  paramPrecision, i != 0, nQuant, err[i]);
+    }
+    // Partition the wavelet transformed coefficients into subbands --
+    //   each subband will have a different quantizer
+    coeff[i]   = new CoeffSet (transform->subband(i),
+			       transform->subbandSize[i], quant[i]);
+
+    // For each subband determine the rate and distortion for each of
+    //    the possible nQuant quantizers
+    coeff[i]->getRateDist (nQuant, minStepSize);
+  }
+
+  Allocator *allocator = new Allocator ();
+  // Use rate/distortion information for each subband to find bit
+  //    allocation that minimizes total (weighted) distortion subject
+  //    to a byte budget
+  budget -= nSets * 4;  // subtract off approximate size of header info
+  allocator->optimalAllocate (coeff, nSets, budget, TRUE, weight);
+  if (verbose) {
+    printf ("Target rate = %d bytes\n", budget);
+    // Display the resulting allocation
+    allocator->print (coeff, nSets);
+  }
+
+  // Create I/O interface object for arithmetic coder
+  Encoder *encoder = new Encoder (out);
+
+  // Write image size to output file
+  encoder->writePositive (image->hsize);
+  encoder->writePositive (image->vsize);
+
+  for (i = 0; i < nSets; i++) {
+    // Write quantizer parameters for each subband to file
+    coeff[i]->writeHeader (encoder, allocator->precision[i]);
+  }
+  for (i = 0; i < nSets; i++) {
+    // Quantize and write entropy coded coefficients for each subband
+    coeff[i]->encode (encoder, allocator->precision[i]);
+  }
+
+  // Flush bits from arithmetic coder
+  encoder->flush ();
+  delete encoder;
+
+  // Clean up
+  for (i = 0; i < nSets; i++) {
+    delete err[i];
+    delete entropy[i];
+    delete quant[i];
+    delete coeff[i];
+  }
+  delete [] err;
+  delete [] entropy;
+  delete [] quant;
+  delete [] coeff;
+  delete allocator;
+  delete transform;
+}
+
+/*---------------------------------------------------------------------------*/
+// Decompress an image from a stream
+//
+// istream &in           Stream holding the compressed image
+// Wavelet *wavelet      Wavelet to use for transform
+// int nStages           # of stages to use in transform
+// int capacity          Capacity of histograms for arithmetic coder
+// int paramPrecision    Precision for storing quantizer parameters --
+//                          precision = n means params are stored with
+//                          accuracy 2^(-n)
+// int maxQuant          Maximum # of different quantizer resolutions
+//                          used on any subband.
+// int monolayer         TRUE for non-embedded quantizer, FALSE for embedded
+
+/*---------------------------------------------------------------------------*/
+Image *decodeImage (istream &in, Wavelet *wavelet, int nStages,
+		    int capacity, int paramPrecision, int maxQuant,
+		    int monolayer)
+{
+  int i;
+
+  // Create I/O interface object for arithmetic decoder
+  Decoder *decoder = new Decoder (in);
+
+  // Read image dimensions from file
+  int hsize = decoder->readPositive ();
+  int vsize = decoder->readPositive ();
+
+  // Create an empty transform of the appropriate size -- fill it in
+  //    as coefficients are decoded
+  WaveletTransform *transform =
+    new WaveletTransform (wavelet, hsize, vsize, nStages);
+
+  // For each subband allocate a CoeffSet, an EntropyCoder, and a
+  //    Quantizer (don't need to know anything about errors here)
+  int nSets = transform->nSubbands;
+  CoeffSet **coeff = new CoeffSet* [nSets];
+  EntropyCoder **entropy = new EntropyCoder* [nSets];
+  Quantizer **quant = new Quantizer* [nSets];
+  // Quantizer precision for each subband
+  int *precision = new int [nSets];
+
+  for (i = 0; i < nSets; i++) {
+    if (monolayer) {
+      // Use uniform quantizer and single layer escape coder for each
+      //   subband
+      entropy[i] = new EscapeCoder (capacity);
+      // Assume all subbands have pdf's centered around 0 except the
+      //   low pass subband 0
+      quant[i]   = new UniformQuant
+	((MonoLayerCoder *)entropy[i], paramPrecision, i != 0);
+    } else {
+      // Use a layered quantizer with dead zones and a layered entropy
+      //   coder for each subband
+      entropy [i] = new LayerCoder (maxQuant, i != 0, capacity);
+      // Assume all subbands have pdf's centered around 0 except the
+      //   low pass subband 0
+      quant [i] = new LayerQuant
+	((MultiLayerCoder *)entropy[i], paramPrecision, i != 0, maxQuant);
+    }
+    // Indicate that each set of coefficients to be read corresponds
+    //    to a subband
+    coeff[i]   = new CoeffSet (transform->subband(i),
+			       transform->subbandSize[i], quant[i]);
+  }
+
+  for (i = 0; i < nSets; i++) {
+    // Read quantizer parameters for each subband
+    coeff[i]->readHeader (decoder, precision[i]);
+  }
+  for (i = 0; i < nSets; i++) {
+    // Read, decode, and dequantize coefficients for each subband
+    coeff[i]->decode (decoder, precision[i]);
+  }
+
+  delete decoder;
+
+  // Clean up
+  for (i = 0; i < nSets; i++) {
+    delete entropy[i];
+    delete quant[i];
+    delete coeff[i];
+  }
+  delete [] entropy;
+  delete [] quant;
+  delete [] coeff;
+  delete [] precision;
+
+  // Allocate image and invert transform
+  Image *image = new Image (hsize, vsize);
+  transform->invert (image);
+  delete transform;
+
+  return image;
+}
+
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+// Tile grid: nTiles (size, tileSize) tiles along each side, tile k
+//   covering tileStart (size, n, k) .. tileStart (size, n, k+1)-1
+
+static int nTiles (int size, int tileSize)
+{
+  int n = (size + tileSize/2)/tileSize;
+  return (n < 1) ? 1 : n;
+}
+
+static int tileStart (int size, int n, int k)
+{
+  return (int)(((double)size*k)/n);
+}
+
+/*---------------------------------------------------------------------------*/
+// Byte budget of a width x height tile, and the smallest budget a tile
+//   may get: encodeImage spends 4 bytes per subband on its header, and
+//   we want at least as much again for the coefficients
+
+static int tileBudget (int budget, const Image *image, int width, int height)
+{
+  return (int)((double)budget*width*height /
+	       ((double)image->hsize*image->vsize));
+}
+
+static int tileMinBudget (int width, int height, int nStages)
+{
+  return 2 * (3*tileStages (width, height, nStages) + 1) * 4;
+}
+
+// TRUE if every tile of the grid for tileSize gets its minimum budget.
+//   Tiles differ by at most one pixel in width and height, so it is
+//   enough to check the extreme sizes.
+
+static int tilesFit (const Image *image, int tileSize, int nStages,
+		     int budget)
+{
+  int nCols = nTiles (image->hsize, tileSize);
+  int nRows = nTiles (image->vsize, tileSize);
+
+  budget -= 16 + 4*(nCols*nRows+1);
+
+  int w[2], h[2];
+  w[0] = image->hsize/nCols;  w[1] = (image->hsize+nCols-1)/nCols;
+  h[0] = image->vsize/nRows;  h[1] = (image->vsize+nRows-1)/nRows;
+
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 2; j++)
+      if (tileBudget (budget, image, w[i], h[j]) <
+	  tileMinBudget (w[i], h[j], nStages))
+	return FALSE;
+  return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+// Copy a width x height block between images
+
+static void copyBlock (const Image *from, int fromLeft, int fromTop,
+		       Image *to, int toLeft, int toTop,
+		       int width, int height)
+{
+  for (int j = 0; j < height; j++) {
+    const Real *src = from->value + (fromTop+j)*from->hsize + fromLeft;
+    Real *dst = to->value + (toTop+j)*to->hsize + toLeft;
+    for (int i = 0; i < width; i++)
+      dst[i] = src[i];
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+// 4 byte big-endian integers for the container header
+
+static void writeWord (ostream &out, long word)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+    out.put ((char)((word >> shift) & 0xff));
+}
+
+static long readWord (istream &in)
+{
+  long word = 0;
+  for (int i = 0; i < 4; i++)
+    word = (word << 8) | (in.get () & 0xff);
+  return word;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int tileStages (int hsize, int vsize, int nStages)
+{
+  // each step needs a low pass subband of more than 2 samples, as in
+  //   Wavelet::transform2d
+  int steps = 0;
+  while (steps < nStages && hsize > 2 && vsize > 2) {
+    hsize = (hsize+1)/2;
+    vsize = (vsize+1)/2;
+    steps++;
+  }
+  return (steps < 1) ? 1 : steps;
+}
+
+/*---------------------------------------------------------------------------*/
+
+int isTiled (istream &in)
+{
+  char magic[4];
+  streampos start = in.tellg ();
+
+  in.read (magic, 4);
+  int tiled = (in.gcount () == 4);
+  for (int i = 0; tiled && i < 4; i++)
+    tiled = (magic[i] == TileMagic[i]);
+
+  in.clear ();
+  in.seekg (start);
+  return tiled;
+}
+
+/*---------------------------------------------------------------------------*/
+// Compress an image as independently coded tiles
+//
+// int tileSize          Nominal width and height of the tiles
+//
+// The other arguments are those of encodeImage; budget is the total
+// for the whole container and is shared among the tiles in proportion
+// to their area.  If that leaves a tile too few bytes for its header
+// and some coefficients, the tiles are made larger (and fewer) until
+// it does not; the tile size used is the one stored in the container.
+
+/*---------------------------------------------------------------------------*/
+void encodeTiles (Image *image, int tileSize, Wavelet *wavelet,
+		  int nStages, int capacity, Real p, Real *weight,
+		  int paramPrecision, int budget, int nQuant,
+		  Real minStepSize, ostream &out, int monolayer)
+{
+  int t;
+
+  // Grow the tiles until each can pay for its header
+  int size = tileSize;
+  while (!tilesFit (image, size, nStages, budget)) {
+    if (nTiles (image->hsize, size) == 1 && nTiles (image->vsize, size) == 1)
+      error ("Budget of %d bytes is too small for a tiled image", budget);
+    size++;
+  }
+  if (size != tileSize) {
+    printf ("Tile size %d is too small for the budget, using %d\n",
+	    tileSize, size);
+    tileSize = size;
+  }
+
+  int nCols = nTiles (image->hsize, tileSize);
+  int nRows = nTiles (image->vsize, tileSize);
+  int n = nCols*nRows;
+
+  // subtract off the container header
+  long *offset = new long [n+1];
+  offset[0] = 16 + 4*(n+1);
+  budget -= offset[0];
+
+  // Code the tiles into in-core buffers
+  ostrstream **tile = new ostrstream* [n];
+
+#pragma omp parallel for schedule(dynamic)
+  for (t = 0; t < n; t++) {
+    int left = tileStart (image->hsize, nCols, t%nCols);
+    int top = tileStart (image->vsize, nRows, t/nCols);
+    int hsize = tileStart (image->hsize, nCols, t%nCols+1) - left;
+    int vsize = tileStart (image->vsize, nRows, t/nCols+1) - top;
+
+    Image *part = new Image (hsize, vsize);
+    copyBlock (image, left, top, part, 0, 0, hsize, vsize);
+
+    tile[t] = new ostrstream;
+    encodeImage (part, wavelet, tileStages (hsize, vsize, nStages),
+		 capacity, p, weight, paramPrecision,
+		 tileBudget (budget, image, hsize, vsize), nQuant,
+		 minStepSize, *tile[t], monolayer);
+    delete part;
+  }
+
+  for (t = 0; t < n; t++)
+    offset[t+1] = offset[t] + tile[t]->pcount ();
+
+  // Write the header, the offset table and the tiles
+  out.write (TileMagic, 4);
+  writeWord (out, image->hsize);
+  writeWord (out, image->vsize);
+  writeWord (out, tileSize);
+  for (t = 0; t <= n; t++)
+    writeWord (out, offset[t]);
+
+  for (t = 0; t < n; t++) {
+    out.write (tile[t]->str (), tile[t]->pcount ());
+    tile[t]->freeze (0);
+    delete tile[t];
+  }
+
+  delete [] tile;
+  delete [] offset;
+}
+
+/*---------------------------------------------------------------------------*/
+// Decompress a tiled image, or the part of it in the region of
+//   interest given by left, top, width and height (a width or height
+//   of -1 extends the region to the edge of the image).  Only the
+//   tiles that overlap the region are read and decoded.
+
+/*---------------------------------------------------------------------------*/
+Image *decodeTiles (istream &in, Wavelet *wavelet, int nStages,
+		    int capacity, int paramPrecision, int maxQuant,
+		    int monolayer, int left, int top, int width, int height)
+{
+  int t;
+  char magic[4];
+  streampos start = in.tellg ();
+
+  // Read the header
+  in.read (magic, 4);
+  for (t = 0; t < 4; t++)
+    if (!in || magic[t] != TileMagic[t])
+      error ("Not a tiled image");
+
+  int hsize = readWord (in);
+  int vsize = readWord (in);
+  int tileSize = readWord (in);
+  if (!in || hsize < 1 || vsize < 1 || tileSize < 1)
+    error ("Corrupt tiled image header");
+
+  int nCols = nTiles (hsize, tileSize);
+  int nRows = nTiles (vsize, tileSize);
+  int n = nCols*nRows;
+  long *offset = new long [n+1];
+  for (t = 0; t <= n; t++)
+    offset[t] = readWord (in);
+
+  // Clip the region of interest to the image
+  if (width < 0)
+    width = hsize;
+  if (height < 0)
+    height = vsize;
+  left = max (0, left);
+  top = max (0, top);
+  width = min (width, hsize-left);
+  height = min (height, vsize-top);
+  if (width < 1 || height < 1)
+    error ("Region of interest is outside the %d x %d image",
+	   hsize, vsize);
+
+  // Read the tiles that overlap the region
+  char **data = new char* [n];
+  for (t = 0; t < n; t++) {
+    int col = t%nCols, row = t/nCols;
+    data[t] = NULL;
+    if (tileStart (hsize, nCols, col+1) <= left ||
+	tileStart (hsize, nCols, col) >= left+width ||
+	tileStart (vsize, nRows, row+1) <= top ||
+	tileStart (vsize, nRows, row) >= top+height)
+      continue;
+
+    if (offset[t+1] <= offset[t])
+      error ("Corrupt tiled image header");
+    data[t] = new char [offset[t+1]-offset[t]];
+    in.seekg (start + (streamoff)offset[t]);
+    in.read (data[t], offset[t+1]-offset[t]);
+    if (!in)
+      error ("Tiled image is truncated");
+  }
+
+  Image *image = new Image (width, height);
+
+  // Decode them
+#pragma omp parallel for schedule(dynamic)
+  for (t = 0; t < n; t++) {
+    if (data[t] == NULL)
+      continue;
+
+    int tileLeft = tileStart (hsize, nCols, t%nCols);
+    int tileTop = tileStart (vsize, nRows, t/nCols);
+    int tileHsize = tileStart (hsize, nCols, t%nCols+1) - tileLeft;
+    int tileVsize = tileStart (vsize, nRows, t/nCols+1) - tileTop;
+
+    istrstream stream (data[t], offset[t+1]-offset[t]);
+    Image *part = decodeImage (stream, wavelet,
+			       tileStages (tileHsize, tileVsize, nStages),
+			       capacity, paramPrecision, maxQuant, monolayer);
+    if (part->hsize != tileHsize || part->vsize != tileVsize)
+      error ("Corrupt tile %d in tiled image", t);
+
+    // Copy the overlap with the region
+    int x0 = max (left, tileLeft), y0 = max (top, tileTop);
+    int x1 = min (left+width, tileLeft+tileHsize);
+    int y1 = min (top+height, tileTop+tileVsize);
+    copyBlock (part, x0-tileLeft, y0-tileTop, image, x0-left, y0-top,
+	       x1-x0, y1-y0);
+
+    delete part;
+    delete [] data[t];
+  }
+
+  delete [] data;
+  delete [] offset;
+  return image;
+}
+
+/*---------------------------------------------------------------------------*/
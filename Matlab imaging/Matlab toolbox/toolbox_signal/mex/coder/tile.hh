@@ -0,0 +1,79 @@
+/*---------------------------------------------------------------------------*/
+// Baseline Wavelet Transform Coder Construction Kit
+//
+// Permission is granted to use this software for research purposes as
+// long as this notice stays attached to this software.
+//
+/*---------------------------------------------------------------------------*/
+// tile.hh
+//
+// Coding of whole images and of tiled images.
+//
+// A tiled image is cut into a grid of roughly tileSize x tileSize
+// tiles.  Each tile is coded on its own -- with its own transform,
+// quantizers and allocator, and a share of the byte budget
+// proportional to its area -- so the tiles are coded concurrently
+// (using OpenMP when it is available) and any one of them can be
+// decoded without the others.  The tiles are stored in a container:
+//
+//    magic          4 bytes, TileMagic
+//    hsize, vsize   image size
+//    tileSize       nominal tile size
+//    offset[]       nTiles+1 byte offsets of the tile streams from
+//                   the start of the container, in raster order
+//    tile streams   each in the format written by encodeImage
+//
+// where all numbers are stored as 4 byte big-endian integers.  The
+// grid has max(1, round(hsize/tileSize)) columns of nearly equal
+// width, and likewise for the rows, so the decoder can recompute the
+// tile boundaries from the header.  Tiles too small for nStages
+// transform steps use fewer steps.
+//
+// Functions:
+// ----------
+// encodeImage     Transform, allocate bits for and code a single image
+//                 to a stream (the format of the untiled coder)
+// decodeImage     Read an image written by encodeImage
+// encodeTiles     Code an image as a tiled container
+// decodeTiles     Decode a tiled container, or only the tiles that
+//                 cover a region of interest.  The container is read
+//                 with seeks, so the stream must be seekable.
+// isTiled         TRUE if a stream starts with a tiled container (the
+//                 stream position is left unchanged)
+// tileStages      # of transform steps used for a tile
+//
+/*---------------------------------------------------------------------------*/
+#ifndef _TILE_
+#define _TILE_
+#include <iostream.h>
+#include "transform.hh"
+/*---------------------------------------------------------------------------*/
+
+// first byte can't start an untiled stream (it would be a 1 pixel wide
+//   image)
+const char TileMagic[4] = { '\377', 'W', 'T', 'C' };
+
+void encodeImage (Image *image, Wavelet *wavelet, int nStages,
+		  int capacity, Real p, Real *weight,
+		  int paramPrecision, int budget, int nQuant,
+		  Real minStepSize, ostream &out, int monolayer,
+		  int verbose = FALSE);
+Image *decodeImage (istream &in, Wavelet *wavelet, int nStages,
+		    int capacity, int paramPrecision, int maxQuant,
+		    int monolayer);
+
+void encodeTiles (Image *image, int tileSize, Wavelet *wavelet,
+		  int nStages, int capacity, Real p, Real *weight,
+		  int paramPrecision, int budget, int nQuant,
+		  Real minStepSize, ostream &out, int monolayer);
+Image *decodeTiles (istream &in, Wavelet *wavelet, int nStages,
+		    int capacity, int paramPrecision, int maxQuant,
+		    int monolayer, int left = 0, int top = 0,
+		    int width = -1, int height = -1);
+
+int isTiled    (istream &in);
+int tileStages (int hsize, int vsize, int nStages);
+
+/*---------------------------------------------------------------------------*/
+#endif
+/*---------------------------------------------------------------------------*/
@@ -29,6 +29,8 @@ Wavelet::Wavelet (FilterSet *filterset)
   synthesisLow = filterset->synthesisLow;
   synthesisHigh = filterset->synthesisHigh;
   symmetric = filterset->symmetric;
+  nLifting = filterset->nLifting;
+  lifting = filterset->lifting;
 
   // amount of space to leave for padding vectors for symmetric extensions
   npad = max(analysisLow->size, analysisHigh->size);
@@ -184,28 +186,33 @@ void Wavelet::transform2d (Real *input, Real *output, int hsize, int vsize,
 	error ("Low pass subband is too small");
       }
 
-      // Do a convolution on the low pass portion of each row
-      for (j = 0; j < vLowSize; j++)  {
-	 // Copy row j to data array
-	 copy (output+(j*hsize), temp_in+npad, hLowSize);
+      if (lifting != NULL && sym_ext == 1) {
+	// Same subbands from the lifting steps of the filters
+	transform_lifting (output, hsize, hLowSize, vLowSize);
+      } else {
+	// Do a convolution on the low pass portion of each row
+	for (j = 0; j < vLowSize; j++)  {
+	   // Copy row j to data array
+	   copy (output+(j*hsize), temp_in+npad, hLowSize);
 	 
-	 // Convolve with low and high pass filters
-	 transform_step (temp_in, temp_out, hLowSize, sym_ext);
+	   // Convolve with low and high pass filters
+	   transform_step (temp_in, temp_out, hLowSize, sym_ext);
 
-	 // Copy back to image
-	 copy (temp_out+npad, output+(j*hsize), hLowSize);
-      }
+	   // Copy back to image
+	   copy (temp_out+npad, output+(j*hsize), hLowSize);
+	}
 
-      // Now do a convolution on the low pass portion of  each column
-      for (j = 0; j < hLowSize; j++)  {
-	 // Copy column j to data array
-	 copy (output+j, hsize, temp_in+npad, vLowSize);
+	// Now do a convolution on the low pass portion of  each column
+	for (j = 0; j < hLowSize; j++)  {
+	   // Copy column j to data array
+	   copy (output+j, hsize, temp_in+npad, vLowSize);
 	 
-	 // Convolve with low and high pass filters
-	 transform_step (temp_in, temp_out, vLowSize, sym_ext);
+	   // Convolve with low and high pass filters
+	   transform_step (temp_in, temp_out, vLowSize, sym_ext);
 
-	 // Copy back to image
-	 copy (temp_out+npad, output+j, hsize, vLowSize);
+	   // Copy back to image
+	   copy (temp_out+npad, output+j, hsize, vLowSize);
+	}
       }
 
       // Now convolve low-pass portion again
@@ -255,6 +262,13 @@ void Wavelet::invert2d (Real *input, Real *output, int hsize, int vsize,
    copy (input, output, hsize*vsize);
 
    while (nsteps--)  {
+      if (lifting != NULL && sym_ext == 1) {
+	// Undo the lifting steps of the filters
+	invert_lifting (output, hsize, hLowSize[nsteps], hHighSize[nsteps],
+			vLowSize[nsteps], vHighSize[nsteps]);
+	continue;
+      }
+
       // Do a reconstruction for each of the columns
       for (j = 0; j < hLowSize[nsteps]+hHighSize[nsteps]; j++)  {
 	 // Copy column j to data array
@@ -430,6 +444,212 @@ void Wavelet::invert_step (Real *input, Real *output, int size, int sym_ext)
    delete [] temp;
 }
 
+/*---------------------------------------------------------------------------*/
+// Lifting version of transform_step and invert_step for filter sets
+// with a lifting factorization.  Each step adds a multiple of the sum
+// of two neighbors from the other channel,
+//      high[i] += c * (low[i] + low[i+1])       (predict)
+//      low[i]  += c * (high[i-1] + high[i])      (update)
+// and neighbors outside the signal are mirrored, which gives the same
+// (1,1) symmetric extension that transform_step uses.  Rows are split
+// into their even and odd samples first; columns are lifted a strip of
+// LiftWidth columns at a time so that each step is a loop over
+// contiguous values.  Rows and strips are independent and are spread
+// over the available processors.
+
+const int LiftWidth = 64;
+
+/*---------------------------------------------------------------------------*/
+// y[i] += c * (x[i+shift] + x[i+shift+1]), i = 0..ny-1, with the x
+// indices clamped to 0..nx-1.  Entry i of y and x holds width
+// consecutive values, stride apart.
+
+static void lift_step (Real *y, int ny, const Real *x, int nx, int shift,
+		       Real c, int stride, int width)
+{
+  int i, k, i0, i1;
+
+  if (nx == 0)
+    return;
+
+  // entries first..last-1 have both neighbors inside the signal
+  int first = min (-shift, ny);
+  int last = max (first, min (ny, nx-1-shift));
+
+  if (width == 1) {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (i = first; i < last; i++)
+      y[i] += c * (x[i+shift] + x[i+shift+1]);
+  } else {
+    for (i = first; i < last; i++) {
+      Real *yi = y + i*stride;
+      const Real *x0 = x + (i+shift)*stride, *x1 = x0 + stride;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (k = 0; k < width; k++)
+	yi[k] += c * (x0[k] + x1[k]);
+    }
+  }
+
+  // the others, at either end
+  for (i = 0; i < ny; i++) {
+    if (i == first)
+      i = last;
+    if (i >= ny)
+      break;
+    i0 = max (0, min (nx-1, i+shift));
+    i1 = max (0, min (nx-1, i+shift+1));
+    for (k = 0; k < width; k++)
+      y[i*stride+k] += c * (x[i0*stride+k] + x[i1*stride+k]);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+// Run the lifting steps (or undo them if inverse is TRUE) on the low
+// and high pass channels low[0..lowSize-1], high[0..highSize-1]
+
+void Wavelet::lift (Real *low, Real *high, int lowSize, int highSize,
+		    int stride, int width, int inverse)
+{
+  int i, k, step;
+  Real lowScale = lifting[nLifting], highScale = lifting[nLifting+1];
+
+  if (inverse) {
+    lowScale = 1.0/lowScale;
+    highScale = 1.0/highScale;
+    for (i = 0; i < lowSize; i++)
+      for (k = 0; k < width; k++)
+	low[i*stride+k] *= lowScale;
+    for (i = 0; i < highSize; i++)
+      for (k = 0; k < width; k++)
+	high[i*stride+k] *= highScale;
+  }
+
+  for (k = 0; k < nLifting; k++) {
+    step = inverse ? nLifting-1-k : k;
+    Real c = inverse ? -lifting[step] : lifting[step];
+
+    if (step % 2 == 0)
+      lift_step (high, highSize, low, lowSize, 0, c, stride, width);
+    else
+      lift_step (low, lowSize, high, highSize, -1, c, stride, width);
+  }
+
+  if (!inverse) {
+    for (i = 0; i < lowSize; i++)
+      for (k = 0; k < width; k++)
+	low[i*stride+k] *= lowScale;
+    for (i = 0; i < highSize; i++)
+      for (k = 0; k < width; k++)
+	high[i*stride+k] *= highScale;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+// Transform the hLowSize x vLowSize low pass corner of output in place
+
+void Wavelet::transform_lifting (Real *output, int hsize, int hLowSize,
+				 int vLowSize)
+{
+  int hLow = (hLowSize+1)/2, hHigh = hLowSize/2;
+  int vLow = (vLowSize+1)/2, vHigh = vLowSize/2;
+  int nStrips = (hLowSize + LiftWidth-1)/LiftWidth;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    int i, j, k;
+    Real *temp = new Real [max (hLowSize, LiftWidth*vLowSize)];
+
+    // Rows: even samples become the low pass, odd ones the high pass
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (j = 0; j < vLowSize; j++) {
+      Real *row = output + j*hsize;
+      for (i = 0; i < hLow; i++)
+	temp[i] = row[2*i];
+      for (i = 0; i < hHigh; i++)
+	temp[hLow+i] = row[2*i+1];
+      lift (temp, temp+hLow, hLow, hHigh, 1, 1, FALSE);
+      copy (temp, row, hLowSize);
+    }
+
+    // Columns, one strip at a time
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (k = 0; k < nStrips; k++) {
+      int first = k*LiftWidth;
+      int width = min (LiftWidth, hLowSize-first);
+      for (j = 0; j < vLowSize; j++)
+	copy (output + j*hsize + first, 
+	      temp + ((j%2) ? vLow + j/2 : j/2)*width, width);
+      lift (temp, temp+vLow*width, vLow, vHigh, width, width, FALSE);
+      for (j = 0; j < vLowSize; j++)
+	copy (temp + j*width, output + j*hsize + first, width);
+    }
+
+    delete [] temp;
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+// Invert one level of the transform in place: the subbands of the
+// (hLowSize+hHighSize) x (vLowSize+vHighSize) corner of output are
+// combined into the higher resolution low pass image
+
+void Wavelet::invert_lifting (Real *output, int hsize, int hLowSize, 
+			      int hHighSize, int vLowSize, int vHighSize)
+{
+  int hLength = hLowSize+hHighSize, vLength = vLowSize+vHighSize;
+  int nStrips = (hLength + LiftWidth-1)/LiftWidth;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    int i, j, k;
+    Real *temp = new Real [max (hLength, LiftWidth*vLength)];
+
+    // Columns, one strip at a time
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (k = 0; k < nStrips; k++) {
+      int first = k*LiftWidth;
+      int width = min (LiftWidth, hLength-first);
+      for (j = 0; j < vLength; j++)
+	copy (output + j*hsize + first, temp + j*width, width);
+      lift (temp, temp+vLowSize*width, vLowSize, vHighSize, 
+	    width, width, TRUE);
+      for (j = 0; j < vLength; j++)
+	copy (temp + ((j%2) ? vLowSize + j/2 : j/2)*width, 
+	      output + j*hsize + first, width);
+    }
+
+    // Rows: interleave the low and high pass samples again
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (j = 0; j < vLength; j++) {
+      Real *row = output + j*hsize;
+      copy (row, temp, hLength);
+      lift (temp, temp+hLowSize, hLowSize, hHighSize, 1, 1, TRUE);
+      for (i = 0; i < hLowSize; i++)
+	row[2*i] = temp[i];
+      for (i = 0; i < hHighSize; i++)
+	row[2*i+1] = temp[hLowSize+i];
+    }
+
+    delete [] temp;
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 // Do symmetric extension of data using prescribed symmetries
 //   Original values are in output[npad] through output[npad+size-1]
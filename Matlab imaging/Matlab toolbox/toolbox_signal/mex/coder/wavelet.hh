@@ -40,11 +40,12 @@ protected:
 class FilterSet {
 public:
   FilterSet () {symmetric = FALSE; analysisLow = analysisHigh =
-		synthesisLow = synthesisHigh = NULL;};
+		synthesisLow = synthesisHigh = NULL;
+		nLifting = 0; lifting = NULL;};
   FilterSet (int symmetric, 
 	     Real *anLow, int anLowSize, int anLowFirst,  
 	     Real *synLow = NULL, int synLowSize = 0, int
-	     synLowFirst = 0);
+	     synLowFirst = 0, Real *lift = NULL, int nLift = 0);
   FilterSet (const FilterSet &filterset);
   ~FilterSet ();
 
@@ -57,6 +58,13 @@ public:
   Filter *analysisLow, *analysisHigh, *synthesisLow,
     *synthesisHigh;
 
+  // Optional lifting factorization of a symmetric odd length filter
+  // set: nLifting predict/update coefficients, alternating and
+  // starting with a predict step, followed by the low pass and high
+  // pass scale factors.  NULL if the filters have none.
+  int nLifting;
+  Real *lifting;
+
 protected:
   void copy (const FilterSet& filterset);
 };
@@ -82,6 +90,8 @@ public:
   Filter *analysisLow, *analysisHigh;    // H and G
   Filter *synthesisLow, *synthesisHigh;  // H~ and G~
   int symmetric;  // TRUE if filter set is symmetric
+  int nLifting;   // lifting steps of the filter set (0 if none)
+  Real *lifting;
 
   void symmetric_extension (Real *output, int size, int left_ext, int
 			    right_ext, int symmetry);
@@ -92,6 +102,14 @@ public:
   void transform_step (Real *input, Real *output, int size, int sym_ext);
   void invert_step (Real *input, Real *output, int size, int sym_ext);
 
+  // one level of the 2d transform computed by lifting, in place
+  void transform_lifting (Real *output, int hsize, int hLowSize,
+			  int vLowSize);
+  void invert_lifting (Real *output, int hsize, int hLowSize, 
+		       int hHighSize, int vLowSize, int vHighSize);
+  void lift (Real *low, Real *high, int lowSize, int highSize,
+	     int stride, int width, int inverse);
+
   // copy length elements from p1 to p2
   void copy (const Real *p1, Real *p2, const int length)
   {int temp = length; while(temp--) *p2++ = *p1++;}
@@ -1,7 +1,11 @@
 clear all;
 fprintf('Compiling mex files ... ');
 
-% Orthogonal matching pursuit
-mex mex/mat_omp.c mex/perform_omp.c mex/invert.c mex/matrix_vector.c -o perform_omp_mex
+% Orthogonal matching pursuit (Batch-OMP, signals coded in parallel with OpenMP)
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/mat_omp.c mex/perform_omp.c -output perform_omp_mex
+else
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/mat_omp.c mex/perform_omp.c -output perform_omp_mex
+end
 
 disp('done.');
\ No newline at end of file
@@ -1,87 +1,62 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#include <unistd.h>
 
 #include "config.h"
 #include "matrix_vector.h"
 #include "mex.h"
-// #include "perform_omp.c"
-extern vector_t perform_omp(matrix_t a, vector_t b, int k);
 
-/* Global variables */
-double *x=NULL;
-int ah=-1;
-int aw=-1;
-int bh=-1;
-int bw=-1;
-int kh=-1;
-int kw=-1;
-double *k=NULL;
-double *a=NULL;
-double *b=NULL;
+#define MAX_TOL 0.001
 
-void test_omp() {
-  int i;
-  matrix_t amatrix;
-  vector_t bvector, xvector;
-
-  srand(time(0));
-
-  if (ah>aw) {
-    mexErrMsgTxt("a has more rows than columns.");
-  }
-  if (ah!=bh) {
-    mexErrMsgTxt("a and b dimensions do not match.");
-  }
-  if (bw!=1) {
-    mexErrMsgTxt("b must be a vector");
-  }
-
-  if ((kh!=1) || (kw!=1)) {
-    mexErrMsgTxt("k must be an integer");
-  }
-  
-  amatrix.h=ah;
-  amatrix.w=aw;
-  amatrix.matrix=a;
-  
-  bvector.h=bh;
-  bvector.vector=b;
-  
-  xvector=perform_omp(amatrix, bvector, (int)k[0]);
-
-  for (i=0;i<xvector.h;i++) {
-    x[i]=xvector.vector[i];
-  }
-  
-  free(xvector.vector);
-}
+extern int perform_omp(matrix_t a, matrix_t b, int k, double tol, matrix_t x);
 
+/* x = perform_omp_mex(a, b, k [, tol])
+   a : dictionary (h x w), b : signals (h x P), one per column,
+   k : maximum number of atoms, tol : relative residual to stop at
+   (default 1e-3, 0 to always pick k atoms).
+   x : coefficients (w x P) */
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) { 
-  if(nrhs<2)
-    mexErrMsgTxt("2 input arguments required."); 
-  if(nlhs!=1)
+  matrix_t amatrix, bmatrix, xmatrix;
+  double tol=MAX_TOL;
+
+  if(nrhs<3)
+    mexErrMsgTxt("3 input arguments required."); 
+  if(nlhs>1)
     mexErrMsgTxt("1 output arguments required.");
-		
+  if (!mxIsDouble(prhs[0]) || !mxIsDouble(prhs[1]) || mxIsComplex(prhs[0]) || mxIsComplex(prhs[1]) || mxIsSparse(prhs[0]) || mxIsSparse(prhs[1]))
+    mexErrMsgTxt("a and b must be real full double matrices.");
+  if (mxGetNumberOfDimensions(prhs[0])!=2 || mxGetNumberOfDimensions(prhs[1])!=2)
+    mexErrMsgTxt("a and b must be matrices.");
+
   /* -- input 1 : a -- */
-  ah=mxGetDimensions(prhs[0])[0];
-  aw=mxGetDimensions(prhs[0])[1];
-  a=mxGetPr(prhs[0]);
-	
+  amatrix.h=(int)mxGetM(prhs[0]);
+  amatrix.w=(int)mxGetN(prhs[0]);
+  amatrix.matrix=mxGetPr(prhs[0]);
+
   /* -- input 2 : b -- */
-  bh=mxGetDimensions(prhs[1])[0];
-  bw=mxGetDimensions(prhs[1])[1];
-  b=mxGetPr(prhs[1]);
+  bmatrix.h=(int)mxGetM(prhs[1]);
+  bmatrix.w=(int)mxGetN(prhs[1]);
+  bmatrix.matrix=mxGetPr(prhs[1]);
+
+  if (amatrix.h!=bmatrix.h)
+    mexErrMsgTxt("a and b dimensions do not match.");
 
   /* -- input 3 : k -- */
-  kh=mxGetDimensions(prhs[2])[0];
-  kw=mxGetDimensions(prhs[2])[1];
-  k=mxGetPr(prhs[2]);
+  if (mxGetNumberOfElements(prhs[2])!=1)
+    mexErrMsgTxt("k must be an integer");
+
+  /* -- input 4 : tol -- */
+  if (nrhs>3) {
+    if (mxGetNumberOfElements(prhs[3])!=1)
+      mexErrMsgTxt("tol must be a scalar");
+    tol=mxGetScalar(prhs[3]);
+  }
 
   /* -- outpout 1 : x --  */
-  plhs[0]=mxCreateDoubleMatrix(aw, 1, mxREAL);	
-  x=mxGetPr(plhs[0]);
+  plhs[0]=mxCreateDoubleMatrix(amatrix.w, bmatrix.w, mxREAL);
+  xmatrix.h=amatrix.w;
+  xmatrix.w=bmatrix.w;
+  xmatrix.matrix=mxGetPr(plhs[0]);
 
-  test_omp();
+  if (perform_omp(amatrix, bmatrix, (int)mxGetScalar(prhs[2]), tol, xmatrix)!=0)
+    mexErrMsgTxt("Out of memory.");
 }
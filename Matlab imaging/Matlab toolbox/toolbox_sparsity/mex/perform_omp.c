@@ -1,130 +1,194 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-#include "invert.h"
 #include "matrix_vector.h"
 
 #define MAX_TOL 0.001
+/* relative pivot under which a new atom is taken as dependent on the chosen ones */
+#define MIN_PIVOT 1e-12
+
+/* per-thread Batch-OMP workspace */
+typedef struct {
+  double *alpha0;   /* a'*b of the current signal */
+  double *alpha;    /* a'*residual */
+  double *L;        /* Cholesky factor of G(I,I), row major, k_max*k_max */
+  double *gamma;    /* coefficients on the chosen atoms */
+  double *w;
+  int *indices;
+  char *chosen;
+} omp_work_t;
+
+static void free_work(omp_work_t *wk) {
+  free(wk->alpha0); free(wk->alpha); free(wk->L);
+  free(wk->gamma); free(wk->w); free(wk->indices); free(wk->chosen);
+}
 
-vector_t perform_omp(matrix_t a, vector_t b, int k) {
-  int i, i_max, j, ii, j_max;
-  double e0, s, m;
-  vector_t x_sol, indices, residual, pinv_times_b;
-  matrix_t pinv_a_extr, a_extr;
-
-  indices.h=0;
-  indices.vector=(double *)malloc(a.w*sizeof(double));
-  if (indices.vector==NULL) {
-    fprintf(stderr,"malloc() error.\n");
-    exit(EXIT_FAILURE);
-  }
-  for (i=0;i<indices.h;i++) indices.vector[i]=0;
-  
-  residual.h=b.h;
-  residual.vector=(double *)malloc(residual.h*sizeof(double));
-  if (residual.vector==NULL) {
-    fprintf(stderr,"malloc() error.\n");
-    exit(EXIT_FAILURE);
-  }
-  x_sol.h=a.w;
-  x_sol.vector=(double *)malloc(x_sol.h*sizeof(double));
-  if (x_sol.vector==NULL) {
-    fprintf(stderr,"malloc() error.\n");
-    exit(EXIT_FAILURE);
-  }
-
-  a_extr.w=a.w;
-  a_extr.h=a.h;
-  a_extr.matrix=(double *)malloc(a_extr.w*a_extr.h*sizeof(double));
-  if (a_extr.matrix==NULL) {
-    fprintf(stderr,"malloc() error.\n");
-    exit(EXIT_FAILURE);
-  }
-
-  pinv_times_b.h=a.w;
-  pinv_times_b.vector=(double *)malloc(pinv_times_b.h*sizeof(double));
-  if (pinv_times_b.vector==NULL) {
-    fprintf(stderr,"malloc() error.\n");
-    exit(EXIT_FAILURE);
-  }
-
-  for (i=0;i<residual.h;i++) {
-    residual.vector[i]=b.vector[i];
+static int alloc_work(omp_work_t *wk, int w, int k_max) {
+  wk->alpha0=(double *)malloc(w*sizeof(double));
+  wk->alpha=(double *)malloc(w*sizeof(double));
+  wk->L=(double *)malloc((size_t)k_max*k_max*sizeof(double));
+  wk->gamma=(double *)malloc(k_max*sizeof(double));
+  wk->w=(double *)malloc(k_max*sizeof(double));
+  wk->indices=(int *)malloc(k_max*sizeof(int));
+  wk->chosen=(char *)calloc(w,sizeof(char));
+  if (!wk->alpha0 || !wk->alpha || !wk->L || !wk->gamma || !wk->w || !wk->indices || !wk->chosen) {
+    free_work(wk);
+    return 0;
   }
+  return 1;
+}
 
-  e0=norm_l2(residual);
-
-  i_max=a.h;
-  if ((k<i_max)&&(k>0)) {
-    i_max=k;
+/* Batch-OMP of one signal b against the dictionary a whose Gram matrix is g.
+   The solution on the chosen atoms grows through rank-1 updates of the
+   Cholesky factor of g(I,I), so no pseudo-inverse is ever recomputed and the
+   residual itself is never formed: alpha = a'*b - g(:,I)*gamma, and the
+   residual energy follows from the same products. */
+static void omp_signal(const matrix_t a, const double *g, const double *b, int k_max, double tol, double *x, omp_work_t *wk) {
+  int i, j, ii, s, j_max;
+  double e0, err, delta, m, v, d;
+  const double *col;
+  double *L=wk->L;
+
+  for (j=0;j<a.w;j++) x[j]=0;
+
+  e0=0;
+  for (i=0;i<a.h;i++) e0+=b[i]*b[i];
+  if (e0==0) return;
+
+  for (j=0;j<a.w;j++) {
+    col=a.matrix+(size_t)j*a.h;
+    v=0;
+    for (i=0;i<a.h;i++) v+=col[i]*b[i];
+    wk->alpha0[j]=v;
+    wk->alpha[j]=v;
   }
 
-  for (i=0;i<i_max;i++) {
-    
+  for (s=0;s<k_max;s++) {
     /* on cherche l'indice du max de A'*r */
     m=0;
-    j_max=0;
-    for (ii=0;ii<a.w;ii++) {
-      s=0;
-      for (j=0;j<a.h;j++) {
-	s+=a.matrix[j+ii*a.h]*residual.vector[j];
-      }
-
-      if (s>m) {
-	m=s;
-	j_max=ii;
-      }
-      if (-s>m) {
-	m=-s;
-	j_max=ii;
+    j_max=-1;
+    for (j=0;j<a.w;j++) {
+      v=fabs(wk->alpha[j]);
+      if (v>m && !wk->chosen[j]) {
+        m=v;
+        j_max=j;
       }
     }
-
-    indices.vector[i]=j_max;
-    indices.h++;
-
-    /* calcul de r =  x - a(:,indices(1:j)) *( pinv(a(:,indices(1:j))) * b ) */
-    for (ii=0;ii<a.h;ii++) {
-      a_extr.matrix[ii+i*a.h]=a.matrix[ii+j_max*a.h];
+    if (j_max<0) break;
+
+    /* L = [L 0; w' sqrt(g(j,j)-w'w)] with L*w = g(I,j) */
+    col=g+(size_t)j_max*a.w;
+    d=col[j_max];
+    for (ii=0;ii<s;ii++) {
+      v=col[wk->indices[ii]];
+      for (j=0;j<ii;j++) v-=L[ii*k_max+j]*wk->w[j];
+      wk->w[ii]=v/L[ii*k_max+ii];
+      d-=wk->w[ii]*wk->w[ii];
+    }
+    if (d<=MIN_PIVOT*col[j_max]) break;
+    for (j=0;j<s;j++) L[s*k_max+j]=wk->w[j];
+    L[s*k_max+s]=sqrt(d);
+    wk->indices[s]=j_max;
+    wk->chosen[j_max]=1;
+
+    /* gamma = (L*L') \ alpha0(I) */
+    for (ii=0;ii<=s;ii++) {
+      v=wk->alpha0[wk->indices[ii]];
+      for (j=0;j<ii;j++) v-=L[ii*k_max+j]*wk->gamma[j];
+      wk->gamma[ii]=v/L[ii*k_max+ii];
+    }
+    for (ii=s;ii>=0;ii--) {
+      v=wk->gamma[ii];
+      for (j=ii+1;j<=s;j++) v-=L[j*k_max+ii]*wk->gamma[j];
+      wk->gamma[ii]=v/L[ii*k_max+ii];
     }
-    a_extr.w=i+1;
-
-    pinv_a_extr=pseudo_invert(a_extr);
 
-    for (ii=0;ii<pinv_a_extr.h;ii++) {
-      pinv_times_b.vector[ii]=0;
-      for (j=0;j<pinv_a_extr.w;j++) {
-	pinv_times_b.vector[ii]+=pinv_a_extr.matrix[ii+pinv_a_extr.h*j]*b.vector[j];
-      }
+    /* alpha = alpha0 - g(:,I)*gamma */
+    for (j=0;j<a.w;j++) wk->alpha[j]=wk->alpha0[j];
+    for (ii=0;ii<=s;ii++) {
+      col=g+(size_t)wk->indices[ii]*a.w;
+      v=wk->gamma[ii];
+      for (j=0;j<a.w;j++) wk->alpha[j]-=v*col[j];
     }
-    pinv_times_b.h=pinv_a_extr.h;
 
-    for (ii=0;ii<residual.h;ii++) {
-      residual.vector[ii]=b.vector[ii];
-      for (j=0;j<a_extr.w;j++) {
-	residual.vector[ii]-=a_extr.matrix[ii+a_extr.h*j]*pinv_times_b.vector[j];
+    /* |r|^2 = |b|^2 - gamma'*g(I,I)*gamma, with g(I,I)*gamma = alpha0(I)-alpha(I) */
+    if (tol>0) {
+      delta=0;
+      for (ii=0;ii<=s;ii++) delta+=wk->gamma[ii]*(wk->alpha0[wk->indices[ii]]-wk->alpha[wk->indices[ii]]);
+      err=e0-delta;
+      if (sqrt(err>0 ? err/e0 : 0)<tol) {
+        s++;
+        break;
       }
     }
+  }
 
-    if ((norm_l2(residual)/e0)<MAX_TOL) {
-      /* sortie de la boucle */
-      i=a.w;
-    }
+  for (ii=0;ii<s;ii++) {
+    x[wk->indices[ii]]=wk->gamma[ii];
+    wk->chosen[wk->indices[ii]]=0;
+  }
+}
 
-    del_matrix(pinv_a_extr);
+/* Codes every column of b over the columns of a into the columns of x
+   (a.w x b.w). At most k atoms per signal (all of them if k<=0), stopping
+   earlier once |r|/|b| < tol (never if tol<=0). The Gram matrix a'*a is
+   computed once and the signals are shared among the OpenMP threads.
+   Returns 0, or -1 when memory could not be allocated. */
+int perform_omp(matrix_t a, matrix_t b, int k, double tol, matrix_t x) {
+  int i, j, failed=0;
+  double *g, v;
+  const double *ci, *cj;
+
+  int k_max=a.h;
+  if ((k<k_max)&&(k>0)) {
+    k_max=k;
+  }
+  if (k_max>a.w) k_max=a.w;
+  if (k_max<1 || b.w<1) {
+    for (i=0;i<x.w*x.h;i++) x.matrix[i]=0;
+    return 0;
   }
 
-  for (j=0;j<x_sol.h;j++) {
-    x_sol.vector[j]=0;
+  g=(double *)malloc((size_t)a.w*a.w*sizeof(double));
+  if (g==NULL) return -1;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i,ci,cj,v) schedule(dynamic,16)
+#endif
+  for (j=0;j<a.w;j++) {
+    cj=a.matrix+(size_t)j*a.h;
+    for (i=0;i<=j;i++) {
+      int l;
+      ci=a.matrix+(size_t)i*a.h;
+      v=0;
+      for (l=0;l<a.h;l++) v+=ci[l]*cj[l];
+      g[i+(size_t)j*a.w]=v;
+      g[j+(size_t)i*a.w]=v;
+    }
   }
-  for (j=0;j<indices.h;j++) {
-    x_sol.vector[(int)(indices.vector[j])]=pinv_times_b.vector[j];
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(|:failed)
+#endif
+  {
+    omp_work_t wk;
+    int jj, ok;
+    ok=alloc_work(&wk,a.w,k_max);
+    if (!ok) failed=1;
+    /* every thread has to reach the loop, even without a workspace */
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,64)
+#endif
+    for (jj=0;jj<b.w;jj++) {
+      if (ok) omp_signal(a,g,b.matrix+(size_t)jj*b.h,k_max,tol,x.matrix+(size_t)jj*x.h,&wk);
+    }
+    if (ok) free_work(&wk);
   }
 
-  del_vector(indices);
-  del_vector(residual);
-  del_vector(pinv_times_b);
-  del_matrix(a_extr);
-  
-  return x_sol;
+  free(g);
+  return failed ? -1 : 0;
 }
@@ -16,7 +16,9 @@ function X = perform_omp(D,Y,options)
 %       |Y-D*X| < tol*|Y|
 %
 %	This code calls the fast mex version of Antoine Grolleau
-%	when possible.
+%	when possible (options.use_mex=1). The mex codes all the columns of Y
+%	in one call with Batch-OMP: the Gram matrix D'*D is computed once and
+%	the signals are shared among the OpenMP threads.
 %
 %   Copyright (c) 2006 Gabriel Peyre
 
@@ -41,10 +43,7 @@ verb = getoptions(options, 'verb', 1);
 
 if isfield(options, 'use_mex') && options.use_mex==1 && exist('perform_omp_mex')==3
     % use fast mex interface
-    X = zeros(K,P);
-    for k=1:P
-        X(:,k) = perform_omp_mex(D,Y(:,k),nbr_max_atoms);
-    end
+    X = perform_omp_mex(D,Y,nbr_max_atoms,tol);
     return;
 end
 
@@ -59,15 +59,24 @@ end
 %% Toolbox files
 disp('---> Compiling wavelet transforms mex files.');
 
-mex mex/perform_79_transform.cpp
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/perform_79_transform.cpp
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/perform_lifting_transform.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/perform_79_transform.cpp
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/perform_lifting_transform.cpp
+end
 mex mex/perform_haar_transform.cpp
-mex mex/perform_lifting_transform.cpp
 
 
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 %% Toolbox files
 disp('---> Compiling matlabSpyrTool needed mex files.');
-mex  mex/simoncelli/upConv.c mex/simoncelli/wrap.c mex/simoncelli/convolve.c mex/simoncelli/edges.c
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" mex/simoncelli/upConv.c mex/simoncelli/wrap.c mex/simoncelli/convolve.c mex/simoncelli/edges.c
+else
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" mex/simoncelli/upConv.c mex/simoncelli/wrap.c mex/simoncelli/convolve.c mex/simoncelli/edges.c
+end
 
 
 
@@ -76,5 +85,10 @@ mex  mex/simoncelli/upConv.c mex/simoncelli/wrap.c mex/simoncelli/convolve.c mex
 disp('---> Compiling rice wavelet toolbox mex files.');
 mex rwt/mdwt.c rwt/mdwt_r.c
 mex rwt/midwt.c rwt/midwt_r.c
-mex rwt/mrdwt.c rwt/mrdwt_r.c
-mex rwt/mirdwt.c rwt/mirdwt_r.c
\ No newline at end of file
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" rwt/mrdwt.c rwt/mrdwt_r.c
+    mex COMPFLAGS="$COMPFLAGS /openmp" rwt/mirdwt.c rwt/mirdwt_r.c
+else
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" rwt/mrdwt.c rwt/mrdwt_r.c
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" rwt/mirdwt.c rwt/mirdwt_r.c
+end
\ No newline at end of file
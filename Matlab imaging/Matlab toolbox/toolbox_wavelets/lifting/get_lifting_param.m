@@ -14,15 +14,9 @@ switch lower(type)
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 case {'haar'}
     
-    error('Not implemented.');
-    % parameter for a 7/9 wavelet transform
-    alpha = -1.586134342;
-    beta = -0.05298011854;
-    gamma = 0.8829110762;
-    delta = 0.4435068522;
-    zeta = 1.149604398;
-    step_types = [0,1,0,1,2];
-    step_param = [alpha,beta,gamma,delta,zeta];
+    % parameter for a haar transform : d=d-s, s=s+d/2, then normalization
+    step_types = [5,5,6,6,2];
+    step_param = [-1,0,1/2,0,sqrt(2)];
     
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 case {'7_9'}
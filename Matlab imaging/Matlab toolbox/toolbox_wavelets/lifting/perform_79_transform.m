@@ -4,9 +4,12 @@
 %
 %   y = perform_79_transform(x, Jmin, dir, options);
 %
-%   Perform a 1D in place
+%   Perform a 1D, 2D or 3D in place
 %   wavelet transform of 'x' using a 7/9 wavelet.
 %   The boundary conditions are handled using symmetric reflexion.
+%   In 2D and 3D each level transforms the columns, then the rows (then
+%   the slices), see 'perform_lifting_transform'.
+%   'x' can be single or double, y has the same class.
 %
 %   'options' is an (optional) structure that can contain:
 %       - 'verb' : control verbosity.
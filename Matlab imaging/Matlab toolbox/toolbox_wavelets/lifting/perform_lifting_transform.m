@@ -5,7 +5,13 @@
 %
 %   y = perform_lifting_transform(x, step_type, step_param, Jmin, dir);
 %
-%   x: the 1D signal to transform in place.
+%   x: the 1D signal to transform in place, or a 2D or 3D array (single
+%       or double). At each level the steps are applied along the first
+%       dimension, then the second (then the third), on the coarse grid
+%       left by the previous level; the backward transform goes the other
+%       way. The number of levels follows the largest dimension. The
+%       columns and slices are processed by strips of neighbouring lines,
+%       spread over OpenMP threads.
 %   step_type: an integer array telling the succession of steps.
 %       0 is for 'predict' step : detail channel is computed using
 %           predicted value from coarse scale.
@@ -13,6 +19,9 @@
 %           value from detail channel to enforce moment conservation.
 %       2 is for 'scaling' step : coarse channel is multiplied by some
 %           'zeta' factor, while coarse channel is divided by 'zeta'.
+%       3 and 4 scale only the details and only the coarse channel.
+%       5 and 6 are asymmetric predict and update, they come in pairs
+%           of consecutive steps, see 'perform_lifting_transform_slow'.
 %   step_param : same length as step_types, 1 parameter for each step.
 %   Jmin: the coarsest scale. If Jmin=0, then it
 %       will perform a full transform (i.e. last coarse value is the mean).
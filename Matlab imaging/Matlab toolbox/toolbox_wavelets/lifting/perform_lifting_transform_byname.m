@@ -4,7 +4,7 @@ function y = perform_lifting_transform_byname(x, Jmin, dir, type, options)
 %
 %   y = perform_lifting_transform_byname(x, Jmin, dir, type, options);
 %
-%   Perform a 1D in place
+%   Perform a 1D in place (2D and 3D with the mex)
 %   wavelet transform of 'x' using a wavelet specified via string 'type'.
 %   The boundary conditions are handled using symmetric reflexion.
 %
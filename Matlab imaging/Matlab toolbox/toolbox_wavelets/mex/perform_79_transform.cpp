@@ -1,71 +1,72 @@
-/*=================================================================
+/*=================================================================
 % perform_79_transform - compute a wavelet biorthogonal 79 transform
 %
 % y = perform_79_transform(x,Jmin,dir);
+%
+%   x can be a 1D, 2D or 3D single or double array.
 %   
-%   Copyright (c) 2004 Gabriel Peyr
-*=================================================================*/
-#include "mex.h"
+%   Copyright (c) 2004 Gabriel Peyr
+*=================================================================*/
+#include "mex.h"
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
 #include <vector>
-#include <algorithm>
-#include "perform_79_transform.h"
-
-/* Global variables */
-int n, p;			// size
-int dir = 1;
-int Jmin = 0;
-double* y = NULL;
-double* x = NULL;
-
-void mexFunction(	int nlhs, mxArray *plhs[], 
-                 int nrhs, const mxArray*prhs[] ) 
-{ 
-    /* retrieve arguments */
-    if( nrhs<1 || nrhs>3 ) 
-        mexErrMsgTxt("1-3 input arguments are required."); 
-    if( nlhs!=1 ) 
+#include <algorithm>
+#include "perform_79_transform.h"
+
+/* Global variables */
+int dims[3];		// size
+int dir = 1;
+int Jmin = 0;
+
+void mexFunction(	int nlhs, mxArray *plhs[], 
+                 int nrhs, const mxArray*prhs[] ) 
+{ 
+    /* retrieve arguments */
+    if( nrhs<1 || nrhs>3 ) 
+        mexErrMsgTxt("1-3 input arguments are required."); 
+    if( nlhs!=1 ) 
         mexErrMsgTxt("1 output arguments are required."); 
 
     // first argument
-    n = mxGetM(prhs[0]);
-    p = mxGetN(prhs[0]);
-    if( n==1 )
+    if( !mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0]) )
+        mexErrMsgTxt("x should be a single or double array."); 
+    if( mxIsComplex(prhs[0]) )
+        mexErrMsgTxt("x should be real."); 
+    int nd = mxGetNumberOfDimensions(prhs[0]);
+    if( nd>3 )
+        mexErrMsgTxt("7-9 transform works only for 1D, 2D and 3D arrays."); 
+    const mwSize* d = mxGetDimensions(prhs[0]);
+    dims[0] = d[0]; dims[1] = d[1]; dims[2] = (nd==3) ? d[2] : 1;
+    if( dims[0]==1 )
     {
-        n = p;
-        p = 1;
+        // row vector
+        dims[0] = dims[1];
+        dims[1] = 1;
     }
-    
-    if( p>1 )
-        mexErrMsgTxt("7-9 transform not yet implemented for 2D matrix."); 
-
-    x = mxGetPr(prhs[0]);
 
     // second input : Jmin
     if( nrhs>=2 )
-        Jmin = (int) *mxGetPr(prhs[1]);
+        Jmin = (int) mxGetScalar(prhs[1]);
     else
         Jmin = 0;
 
     // third input : dir
     if( nrhs>=3 )
-        dir = (int) *mxGetPr(prhs[2]);
+        dir = (int) mxGetScalar(prhs[2]);
     else
         dir = 1;
 
     if( dir!=1 && dir!=-1 )
         mexErrMsgTxt("dir should be either +1 or -1."); 
 
-    // first ouput : y
-    plhs[0] = mxCreateDoubleMatrix(n, p, mxREAL); 
-    y = mxGetPr(plhs[0]);
-
-    memcpy( y, x, n*p*sizeof(double) );
-    // perform the transform
-    if( p==1 )
-        perform_79_transform_1d( y, n, Jmin, dir );
-    else
-        perform_79_transform_2d( y, n, Jmin, dir );
-}
\ No newline at end of file
+    // first ouput : y, transformed in place
+    plhs[0] = mxDuplicateArray(prhs[0]);
+
+    // perform the transform
+    if( mxIsDouble(plhs[0]) )
+        perform_79_transform_nd( (double*) mxGetData(plhs[0]), dims, Jmin, dir );
+    else
+        perform_79_transform_nd( (float*) mxGetData(plhs[0]), dims, Jmin, dir );
+}
@@ -11,22 +11,32 @@
 
 #include "perform_lifting_transform.h"
 
-void perform_79_transform_1d( double* x, int n, int Jmin, int dir=1 )
-{
-    // perform the transform
-    const int step_type[] = {0,1,0,1,2};
-    const double alpha = -1.586134342;
-    const double beta  = -0.05298011854;
-    const double gamma = 0.8829110762;
-    const double delta = 0.4435068522;
-    const double zeta  = 1.149604398;
-    const double step_param[] = {alpha,beta,gamma,delta,zeta};
-    perform_lifting_transform_1d( x, n, 5, step_type, step_param, Jmin, dir );
+// lifting steps of the 7/9 biorthogonal wavelet
+static const int step_type_79[] = {0,1,0,1,2};
+static const double step_param_79[] = {
+    -1.586134342,       // alpha
+    -0.05298011854,     // beta
+    0.8829110762,       // gamma
+    0.4435068522,       // delta
+    1.149604398 };      // zeta
+
+// 1D, 2D or 3D in place transform, dims[] = {n,p,q}
+template<class T>
+void perform_79_transform_nd( T* x, const int* dims, int Jmin, int dir=1 )
+{
+    perform_lifting_transform_nd( x, dims, 5, step_type_79, step_param_79, Jmin, dir );
+}
+
+void perform_79_transform_1d( double* x, int n, int Jmin, int dir=1 )
+{
+    int dims[3] = {n,1,1};
+    perform_79_transform_nd( x, dims, Jmin, dir );
 }
 
 void perform_79_transform_2d( double* x, int n, int Jmin, int dir=1 )
 {
-    // not yet implemented
+    int dims[3] = {n,n,1};
+    perform_79_transform_nd( x, dims, Jmin, dir );
 }
 
 
@@ -37,4 +47,4 @@ void perform_79_transform_2d( double* x, int n, int Jmin, int dir=1 )
 //  Copyright (c) Gabriel Peyr
 ///////////////////////////////////////////////////////////////////////////////
 //                               END OF FILE                                 //
-///////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
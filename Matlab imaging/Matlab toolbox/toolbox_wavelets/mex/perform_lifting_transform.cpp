@@ -1,92 +1,93 @@
-/*=================================================================
+/*=================================================================
 % perform_lifting_transform - compute a wavelet biorthogonal 79 transform
 %
 % y = perform_lifting_transform( x, step_type, step_param, Jmin, dir );
+%
+%   x can be a 1D, 2D or 3D single or double array.
 %   
-%   Copyright (c) 2004 Gabriel Peyr
-*=================================================================*/
-#include "mex.h"
+%   Copyright (c) 2004 Gabriel Peyr
+*=================================================================*/
+#include "mex.h"
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
 #include <vector>
-#include <algorithm>
-#include "perform_79_transform.h"
-
-/* Global variables */
-int n, p;			// size
-int dir = 1;
-int Jmin = 0;
-double* y = NULL;
-double* x = NULL;
-
-void mexFunction(	int nlhs, mxArray *plhs[], 
-                 int nrhs, const mxArray*prhs[] ) 
-{ 
-    /* retrieve arguments */
-    if( nrhs<3 || nrhs>5 ) 
-        mexErrMsgTxt("3-5 input arguments are required."); 
-    if( nlhs!=1 ) 
+#include <algorithm>
+#include "perform_79_transform.h"
+
+/* Global variables */
+int dims[3];		// size
+int dir = 1;
+int Jmin = 0;
+
+void mexFunction(	int nlhs, mxArray *plhs[], 
+                 int nrhs, const mxArray*prhs[] ) 
+{ 
+    /* retrieve arguments */
+    if( nrhs<3 || nrhs>5 ) 
+        mexErrMsgTxt("3-5 input arguments are required."); 
+    if( nlhs!=1 ) 
         mexErrMsgTxt("1 output arguments are required."); 
 
     // first argument
-    n = mxGetM(prhs[0]);
-    p = mxGetN(prhs[0]);
-    if( n==1 )
+    if( !mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0]) )
+        mexErrMsgTxt("x should be a single or double array."); 
+    if( mxIsComplex(prhs[0]) )
+        mexErrMsgTxt("x should be real."); 
+    int nd = mxGetNumberOfDimensions(prhs[0]);
+    if( nd>3 )
+        mexErrMsgTxt("lifting transform works only for 1D, 2D and 3D arrays."); 
+    const mwSize* d = mxGetDimensions(prhs[0]);
+    dims[0] = d[0]; dims[1] = d[1]; dims[2] = (nd==3) ? d[2] : 1;
+    if( dims[0]==1 )
     {
-        n = p;
-        p = 1;
+        // row vector
+        dims[0] = dims[1];
+        dims[1] = 1;
     }
-    
-    if( p>1 )
-        mexErrMsgTxt("lifting transform not yet implemented for 2D matrix."); 
-
-    x = mxGetPr(prhs[0]);
 
     // input 2 : step_type
-    int nbr_step = mxGetM(prhs[1]);
-    if( nbr_step==1 )
-        nbr_step = mxGetN(prhs[1]);
+    if( !mxIsDouble(prhs[1]) || !mxIsDouble(prhs[2]) )
+        mexErrMsgTxt("step_type and step_param must be double arrays."); 
+    int nbr_step = mxGetNumberOfElements(prhs[1]);
     double* step_type = (double*) mxGetPr(prhs[1]);
 
     // input 3 : step_param
-    int tmp = mxGetM(prhs[2]);
-    if( tmp==1 )
-        tmp = mxGetN(prhs[2]);
-    if( tmp!=nbr_step )
+    if( (int) mxGetNumberOfElements(prhs[2])!=nbr_step )
         mexErrMsgTxt("step_type and step_param must be of same size."); 
     double* step_param = (double*) mxGetPr(prhs[2]);
 
     // input 4 : Jmin
     if( nrhs>=4 )
-        Jmin = (int) *mxGetPr(prhs[3]);
+        Jmin = (int) mxGetScalar(prhs[3]);
     else
         Jmin = 0;
 
     // input 5 : dir
-    if( nrhs>=4 )
-        dir = (int) *mxGetPr(prhs[4]);
+    if( nrhs>=5 )
+        dir = (int) mxGetScalar(prhs[4]);
     else
         dir = 1;
 
     if( dir!=1 && dir!=-1 )
         mexErrMsgTxt("dir should be either +1 or -1."); 
 
-    // first ouput : y
-    plhs[0] = mxCreateDoubleMatrix(n, p, mxREAL); 
-    y = mxGetPr(plhs[0]);
-
-    memcpy( y, x, n*p*sizeof(double) );
-
-    int* step_typei = new int[nbr_step];
-    for( int i=0; i<nbr_step; ++i )
-        step_typei[i] = (int) step_type[i];
-
-    // perform the transform
-    if( p==1 )
-        perform_lifting_transform_1d( y, n, nbr_step, step_typei, step_param, Jmin, dir );
-    else
-        perform_lifting_transform_2d( y, n, p, nbr_step, step_typei, step_param, Jmin, dir );
-
-    delete [] step_typei;
-}
\ No newline at end of file
+    std::vector<int> step_typei(nbr_step+1);
+    for( int i=0; i<nbr_step; ++i )
+        step_typei[i] = (int) step_type[i];
+
+    // first ouput : y, transformed in place
+    plhs[0] = mxDuplicateArray(prhs[0]);
+
+    // perform the transform
+    bool ok;
+    if( mxIsDouble(plhs[0]) )
+        ok = perform_lifting_transform_nd( (double*) mxGetData(plhs[0]), dims, nbr_step, &step_typei[0], step_param, Jmin, dir );
+    else
+        ok = perform_lifting_transform_nd( (float*) mxGetData(plhs[0]), dims, nbr_step, &step_typei[0], step_param, Jmin, dir );
+    if( !ok )
+    {
+        mxDestroyArray(plhs[0]);
+        mexErrMsgTxt("Problem with asymetric parameters, or unknown step type."); 
+    }
+}
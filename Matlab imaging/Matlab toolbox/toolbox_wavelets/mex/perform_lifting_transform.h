@@ -10,129 +10,274 @@
 #define _PERFORM_LIFTING_TRANSFORM_H_
 
 #include <math.h>
+#include <stddef.h>
 
 #define STEP_PREDICT 0
 #define STEP_UPDATE 1
 #define STEP_SCALE 2
+#define STEP_SCALE_D 3
+#define STEP_SCALE_S 4
+#define STEP_PREDICT_ASYM 5
+#define STEP_UPDATE_ASYM 6
 
+// number of neighbouring lines transformed together along the slow axes
+#define LIFTING_STRIP 16
+// below this many samples per pass the lines are not spread over threads
+#define LIFTING_MIN_PARALLEL 32768
 
-// coarse is x(0:h:n) and details is x(h/2:h:n)
-void step_predict( double* x, int n, int h, double alpha )
+/*------------------------------------------------------------------------------*/
+// The transform is in place: at the level of step h, along each axis, the
+// coarse coefs are x(0:h:n) and the details x(h/2:h:n). A pass applies one
+// lifting step to nl lines at once: the samples of the line are 'stride'
+// apart and the lines are 'lstride' apart. Along the slow axes the lines
+// are neighbours in memory, so the inner loop runs over them with unit
+// stride (at the finest level) and vectorizes.
+/*------------------------------------------------------------------------------*/
+
+// d[k] += a*s[k] + b*s[k+1], with s[k+1]=s[k] on the right boundary
+// (a==b and sym gives the symmetric predict d[k] += a*(s[k]+s[k+1]))
+template<class T>
+void lifting_predict( T* x, int n, int h, ptrdiff_t stride, int nl, ptrdiff_t lstride, T a, T b, bool sym )
 {
     int h2 = h>>1;  // h/2
-    double x2;
     for( int k=h2; k<n; k+=h )
     {
-        // d1[k] = d[k] + alpha*(s[k]+s[k+1])
-        if( k+h2<n )
-            x2 = x[k+h2];
+        T* __restrict d = x + k*stride;
+        const T* __restrict s0 = x + (k-h2)*stride;
+        const T* __restrict s1 = x + ( k+h2<n ? k+h2 : k-h2 )*stride;  // use symmetry
+        if( sym )
+            for( int l=0; l<nl; ++l )
+                d[l*lstride] = d[l*lstride] + a * ( s0[l*lstride]+s1[l*lstride] );
         else
-            x2 = x[k-h2]; // use symmetry
-        x[k] = x[k] + alpha * ( x[k-h2]+x2 );
+            for( int l=0; l<nl; ++l )
+                d[l*lstride] = d[l*lstride] + a*s0[l*lstride] + b*s1[l*lstride];
     }
 }
 
-void step_update( double* x, int n, int h, double beta )
+// s[k] += a*d[k] + b*d[k-1], with d[-1]=d[0] and d[k]=d[k-1] past the end
+template<class T>
+void lifting_update( T* x, int n, int h, ptrdiff_t stride, int nl, ptrdiff_t lstride, T a, T b, bool sym )
 {
     int h2 = h>>1;  // h/2
-    double x1, x2;
     for( int k=0; k<n; k+=h )
     {
-        // s1[k] = s[k] + beta*(d[k]+d[k-1]).
-        if( k-h2>0 )
-            x1 = x[k-h2];
+        T* __restrict s = x + k*stride;
+        const T* __restrict d1 = x + ( k-h2>0 ? k-h2 : k+h2 )*stride;  // use symmetry
+        const T* __restrict d0 = x + ( k+h2<n ? k+h2 : k-h2 )*stride;  // use symmetry
+        if( sym )
+            for( int l=0; l<nl; ++l )
+                s[l*lstride] = s[l*lstride] + a * ( d1[l*lstride]+d0[l*lstride] );
         else
-            x1 = x[k+h2]; // use symmetry
-        if( k+h2<n )
-            x2 = x[k+h2];
-        else
-            x2 = x[k-h2]; // use symmetry
-        x[k] = x[k] + beta * ( x1+x2 );
+            for( int l=0; l<nl; ++l )
+                s[l*lstride] = s[l*lstride] + a*d0[l*lstride] + b*d1[l*lstride];
     }
 }
 
-void step_scale( double* x, int n, int h, double zeta )
+// s *= zs, d /= zd (a plain scaling has zs=zd=zeta)
+template<class T>
+void lifting_scale( T* x, int n, int h, ptrdiff_t stride, int nl, ptrdiff_t lstride, T zs, T zd )
 {
     int h2 = h>>1;  // h/2
     for( int k=0; k<n; k+=h )
     {
-        // s1=s*zeta; d1=d/zeta;
-        x[k] *= zeta;
-        if( k+h2<n )
-            x[k+h2] /= zeta;
+        T* __restrict s = x + k*stride;
+        if( zs!=1 )
+            for( int l=0; l<nl; ++l )
+                s[l*lstride] *= zs;
+        if( k+h2<n && zd!=1 )
+        {
+            T* __restrict d = x + (k+h2)*stride;
+            for( int l=0; l<nl; ++l )
+                d[l*lstride] /= zd;
+        }
     }
 }
 
-void perform_lifting_transform_1d_fwd( double* x, int n, 
-                                  int nbr_steps, const int* step_type, const double* step_param, int Jmin )
+// one lifting step, asymmetric steps come as pairs of parameters (p, p1)
+struct lifting_step_t
 {
-    int Jmax = log2( n )-1;
-    int h = 1;
-    for( int j=1; j<=Jmax-Jmin+1; ++j )
+    int type;
+    double p, p1;
+};
+
+// Turn the Matlab step lists into steps, merging the asymmetric pairs.
+// Returns the number of steps, or -1 if a 5 or 6 step is not paired.
+inline int lifting_parse_steps( int nbr_steps, const int* step_type, const double* step_param, lifting_step_t* steps )
+{
+    int m = 0;
+    for( int s=0; s<nbr_steps; ++s )
     {
-        h *= 2;
-        // coarse is x(0:h:n) and details is x(h/2:h:n)
-        for( int s=0; s<nbr_steps; ++s ) 
+        steps[m].type = step_type[s];
+        steps[m].p = steps[m].p1 = step_param[s];
+        if( step_type[s]==STEP_PREDICT_ASYM || step_type[s]==STEP_UPDATE_ASYM )
         {
-            switch( step_type[s] )
-            {
-            case STEP_PREDICT:
-                step_predict( x, n, h, step_param[s] );
-                break;
-            case STEP_UPDATE:
-                step_update( x, n, h, step_param[s] );
-                break;
-            case STEP_SCALE:
-                step_scale( x, n, h, step_param[s] );
-                break;
-            }
+            if( s+1>=nbr_steps || step_type[s+1]!=step_type[s] )
+                return -1;
+            steps[m].p1 = step_param[++s];
         }
+        else if( step_type[s]<STEP_PREDICT || step_type[s]>STEP_SCALE_S )
+            return -1;
+        m++;
     }
+    return m;
 }
 
+// apply the steps of one level (or their inverse) to a bundle of lines
+template<class T>
+void lifting_apply_steps( T* x, int n, int h, ptrdiff_t stride, int nl, ptrdiff_t lstride, 
+                          int nbr_steps, const lifting_step_t* steps, int dir )
+{
+    for( int i=0; i<nbr_steps; ++i )
+    {
+        const lifting_step_t& st = steps[ dir==1 ? i : nbr_steps-1-i ];
+        T sg = (T) dir;
+        switch( st.type )
+        {
+        case STEP_PREDICT:
+            lifting_predict( x, n, h, stride, nl, lstride, sg*(T)st.p, sg*(T)st.p, true );
+            break;
+        case STEP_UPDATE:
+            lifting_update( x, n, h, stride, nl, lstride, sg*(T)st.p, sg*(T)st.p, true );
+            break;
+        case STEP_PREDICT_ASYM:
+            lifting_predict( x, n, h, stride, nl, lstride, sg*(T)st.p, sg*(T)st.p1, false );
+            break;
+        case STEP_UPDATE_ASYM:
+            lifting_update( x, n, h, stride, nl, lstride, sg*(T)st.p, sg*(T)st.p1, false );
+            break;
+        case STEP_SCALE:
+            if( dir==1 )
+                lifting_scale( x, n, h, stride, nl, lstride, (T)st.p, (T)st.p );
+            else
+                lifting_scale( x, n, h, stride, nl, lstride, (T)(1.0/st.p), (T)(1.0/st.p) );
+            break;
+        case STEP_SCALE_D:
+            lifting_scale( x, n, h, stride, nl, lstride, (T)1, (T)( dir==1 ? 1.0/st.p : st.p ) );
+            break;
+        case STEP_SCALE_S:
+            lifting_scale( x, n, h, stride, nl, lstride, (T)( dir==1 ? st.p : 1.0/st.p ), (T)1 );
+            break;
+        }
+    }
+}
 
-void perform_lifting_transform_1d_bwd( double* x, int n, 
-                                      int nbr_steps, const int* step_type, const double* step_param, int Jmin )
-{   
-    int Jmax = log2( n )-1;
-    int h = 1<<(Jmax-Jmin+2);
-    for( int j=Jmax-Jmin+1; j>0; --j )
+// One level along axis 'a' of a (up to) 3D array. Along the other axes only
+// the samples on the grid of spacing h/2 take part.
+template<class T>
+void lifting_pass( T* x, const int* dims, int a, int h, int nbr_steps, const lifting_step_t* steps, int dir )
+{
+    int g = h>>1;
+    ptrdiff_t st[3];
+    int c[3];
+    st[0] = 1; st[1] = dims[0]; st[2] = (ptrdiff_t)dims[0]*dims[1];
+    for( int b=0; b<3; ++b )
+        c[b] = (dims[b]+g-1)/g;     // samples on the grid
+#ifdef _OPENMP
+    ptrdiff_t work = (ptrdiff_t)c[0]*c[1]*c[2];
+#endif
+    int b1, b2;     // the two other axes
+    if( a==0 )
+    {
+        // lines along the fast axis, one at a time
+        b1 = 1; b2 = 2;
+        int nlines = c[b1]*c[b2];
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) if(work>LIFTING_MIN_PARALLEL)
+#endif
+        for( int t=0; t<nlines; ++t )
+        {
+            T* line = x + (t%c[b1])*g*st[b1] + (t/c[b1])*g*st[b2];
+            lifting_apply_steps( line, dims[a], h, st[a], 1, 1, nbr_steps, steps, dir );
+        }
+    }
+    else
     {
-        h /= 2;
-        // coarse is x(0:h:n) and details is x(h/2:h:n)
-        for( int s=nbr_steps-1; s>=0; --s ) 
+        // strips of LIFTING_STRIP lines along the fast axis
+        b1 = 0; b2 = (a==1) ? 2 : 1;
+        int nstrips = (c[b1]+LIFTING_STRIP-1)/LIFTING_STRIP;
+        int ntasks = nstrips*c[b2];
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) if(work>LIFTING_MIN_PARALLEL)
+#endif
+        for( int t=0; t<ntasks; ++t )
         {
-            switch( step_type[s] )
-            {
-            case STEP_PREDICT:
-                step_predict( x, n, h, -step_param[s] );
-                break;
-            case STEP_UPDATE:
-                step_update( x, n, h, -step_param[s] );
-                break;
-            case STEP_SCALE:
-                step_scale( x, n, h, 1.0/step_param[s] );
-                break;
-            }
+            int s = t%nstrips;
+            int nl = c[b1]-s*LIFTING_STRIP;
+            if( nl>LIFTING_STRIP )
+                nl = LIFTING_STRIP;
+            T* strip = x + (ptrdiff_t)s*LIFTING_STRIP*g*st[b1] + (t/nstrips)*g*st[b2];
+            lifting_apply_steps( strip, dims[a], h, st[a], nl, g*st[b1], nbr_steps, steps, dir );
         }
     }
 }
 
+// Multilevel separable transform of a 1D, 2D or 3D array (dims[2]==1 for 2D).
+// At each level the axes are transformed in turn (in reverse order for the
+// backward transform). Jmax = log2(largest dimension)-1.
+template<class T>
+void perform_lifting_levels( T* x, const int* dims, 
+                                  int nbr_steps, const lifting_step_t* steps, int Jmin, int dir )
+{
+    int nmax = 1;
+    for( int b=0; b<3; ++b )
+        if( dims[b]>nmax )
+            nmax = dims[b];
+    int Jmax = (int) log2( (double) nmax )-1;
+    int L = Jmax-Jmin+1;
+    if( L<=0 )
+        return;
+    if( dir==1 )
+    {
+        int h = 1;
+        for( int j=1; j<=L; ++j )
+        {
+            h *= 2;
+            for( int a=0; a<3; ++a )
+                if( (h>>1)<dims[a] )
+                    lifting_pass( x, dims, a, h, nbr_steps, steps, dir );
+        }
+    }
+    else
+    {
+        int h = 1<<(L+1);
+        for( int j=L; j>0; --j )
+        {
+            h /= 2;
+            for( int a=2; a>=0; --a )
+                if( (h>>1)<dims[a] )
+                    lifting_pass( x, dims, a, h, nbr_steps, steps, dir );
+        }
+    }
+}
+
+// step lists as given from Matlab (see perform_lifting_transform.m)
+template<class T>
+bool perform_lifting_transform_nd( T* x, const int* dims, 
+                                  int nbr_steps, const int* step_type, const double* step_param, 
+                                  int Jmin = 0, int dir=1 )
+{
+    lifting_step_t* steps = new lifting_step_t[nbr_steps>0 ? nbr_steps : 1];
+    int m = lifting_parse_steps( nbr_steps, step_type, step_param, steps );
+    if( m>=0 )
+        perform_lifting_levels( x, dims, m, steps, Jmin, dir );
+    delete [] steps;
+    return m>=0;
+}
+
 void perform_lifting_transform_1d( double* x, int n, 
                                   int nbr_steps, const int* step_type, const double* step_param, 
                                   int Jmin = 0, int dir=1 )
 {
-    if( dir==1 )
-        perform_lifting_transform_1d_fwd( x, n, nbr_steps, step_type, step_param, Jmin );
-    else
-        perform_lifting_transform_1d_bwd( x, n, nbr_steps, step_type, step_param, Jmin );
+    int dims[3] = {n,1,1};
+    perform_lifting_transform_nd( x, dims, nbr_steps, step_type, step_param, Jmin, dir );
 }
 
 void perform_lifting_transform_2d( double* x, int n, int p,
                                   int nbr_steps, const int* step_type, const double* step_param, 
                                   int Jmin = 0, int dir=1 )
 {
-
+    int dims[3] = {n,p,1};
+    perform_lifting_transform_nd( x, dims, nbr_steps, step_type, step_param, Jmin, dir );
 }
 
 #endif // _PERFORM_LIFTING_TRANSFORM_H_
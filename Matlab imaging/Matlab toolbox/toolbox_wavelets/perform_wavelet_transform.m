@@ -281,18 +281,21 @@ if ~iscell(x)
     Jmax = log2(n)-1;
     %%% FORWARD TRANSFORM %%%
     L = Jmax-Jmin+1;
-    [yl,yh,L] = mrdwt(x, qmf, L);
     % turn into cell array
     if ndim==1
+        [yl,yh,L] = mrdwt(x, qmf, L);
         y = cat(2,yl,yh);
         y = transfert_ti(y);
     else
         %% 2D %%
+        % one level at a time, so that only the bands of the current
+        % level are held next to the cell array
+        yl = x;
         for j=Jmax:-1:Jmin
+            s = Jmax-j+1;
+            [yl,yh] = mrdwt(yl, qmf, s, s);
             for q=1:3
-                s = 3*(Jmax-j)+q-1;
-                M = yh(:,s*n+1:(s+1)*n);
-                y{ 3*(j-Jmin)+q } = M;
+                y{ 3*(j-Jmin)+q } = yh(:,(q-1)*n+1:q*n);
             end
         end
         y{ 3*(Jmax-Jmin)+4 } = yl;
@@ -317,14 +320,12 @@ else
             warning('Jmin is not correct.');
             L = (length(x)-1)/3;
         end
-        yl = x{ 3*(Jmax-Jmin)+4 };
-        yh = zeros( n,3*L*n );
-        for j=Jmax:-1:Jmin
-            for q=1:3
-                s = 3*(Jmax-j)+q-1;
-                yh(:,s*n+1:(s+1)*n) = x{ 3*(j-Jmin)+q };
-            end
+        %%% BACKWARD TRANSFORM, one level at a time %%%
+        y = x{ 3*L+1 };
+        for s=L:-1:1
+            y = mirdwt(y, [x{ 3*(L-s)+(1:3) }], dqmf, s, s);
         end
+        return;
     end
     
     %%% BACKWARD TRANSFORM %%%
@@ -16,6 +16,8 @@ Change History: Fixed code such that the result has the same dimension as the
                 input for 1D problems. Also, added some standard error checking.
 		Jan Erik Odegard <odegard@ece.rice.edu> Wed Jun 14 1995
 
+                Accept single precision input and an optional first level
+                L0, see mirdwt_r.c.
 */
 
 #include <math.h>
@@ -29,38 +31,48 @@ Change History: Fixed code such that the result has the same dimension as the
 #define even(x)  ((x & 1) ? 0 : 1)
 #define isint(x) ((x - floor(x)) > 0.0 ? 0 : 1)
 
+void MIRDWT(void *x, const void *yh, int single, int m, int n, double *h,
+	    int lh, int L0, int L);
+
 
 void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
 
 {
-  double *x, *h,  *yl, *yh, *Lf, *Lr;
-  int m, n, mh, nh, h_col, h_row, lh, L, i, po2, j;
+  double *h, *Lf, *Lr;
+  void *x, *yh;
+  int m, n, mh, nh, h_col, h_row, lh, L, L0, i, po2, j, single;
   double mtest, ntest;
 
   /* check for correct # of input variables */
-  if (nrhs>4){
-    mexErrMsgTxt("There are at most 4 input parameters allowed!");
+  if (nrhs>5){
+    mexErrMsgTxt("There are at most 5 input parameters allowed!");
     return;
   }
   if (nrhs<3){
     mexErrMsgTxt("There are at least 3 input parameters required!");
     return;
   }
-  yl = mxGetPr(prhs[0]);
+  if ((!mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0])) || mxIsComplex(prhs[0]))
+    mexErrMsgTxt("The lowpass component must be a real double or single array");
+  if (mxGetClassID(prhs[1]) != mxGetClassID(prhs[0]) || mxIsComplex(prhs[1]))
+    mexErrMsgTxt("The highpass components must be real and of the class of the lowpass component");
+  single = mxIsSingle(prhs[0]);
   n = mxGetN(prhs[0]); 
   m = mxGetM(prhs[0]); 
-  yh = mxGetPr(prhs[1]);
+  yh = mxGetData(prhs[1]);
   nh = mxGetN(prhs[1]); 
   mh = mxGetM(prhs[1]); 
-  h = mxGetPr(prhs[2]);
   h_col = mxGetN(prhs[2]); 
   h_row = mxGetM(prhs[2]); 
   if (h_col>h_row)
     lh = h_col;
   else  
     lh = h_row;
-  if (nrhs == 4){
-    L = (int) *mxGetPr(prhs[3]);
+  h = (double *)mxCalloc(lh,sizeof(double));
+  for (i=0; i<lh; i++)
+    h[i] = mxIsSingle(prhs[2]) ? ((float *)mxGetData(prhs[2]))[i] : mxGetPr(prhs[2])[i];
+  if (nrhs >= 4){
+    L = (int) mxGetScalar(prhs[3]);
     if (L < 0)
       mexErrMsgTxt("The number of levels, L, must be a non-negative integer");
   }
@@ -84,15 +96,21 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
       return;
     }
   }
+  L0 = 1;
+  if (nrhs == 5){
+    L0 = (int) mxGetScalar(prhs[4]);
+    if (L0 < 1 || L0 > max(L,1))
+      mexErrMsgTxt("The first level, L0, must be an integer in 1..L");
+  }
   /* check for consistency of rows and columns of yl, yh */
   if (min(m,n) > 1){
-    if((m != mh) | (3*n*L != nh)){
+    if((m != mh) | (3*n*max(L-L0+1,0) != nh)){
       mexErrMsgTxt("Dimensions of first two input matrices not consistent!");
       return;
     }
   }
   else{
-    if((m != mh) | (n*L != nh)){
+    if((m != mh) | (n*max(L-L0+1,0) != nh)){
       mexErrMsgTxt("Dimensions of first two input vectors not consistent!");{
 	return;
       }
@@ -110,10 +128,11 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
     if (!isint(ntest))
       mexErrMsgTxt("The matrix column dimension must be of size n*2^(L)");
   }
-  plhs[0] = mxCreateDoubleMatrix(m,n,mxREAL);
-  x = mxGetPr(plhs[0]);
+  plhs[0] = mxDuplicateArray(prhs[0]);
+  x = mxGetData(plhs[0]);
   plhs[1] = mxCreateDoubleMatrix(1,1,mxREAL);
   Lr = mxGetPr(plhs[1]);
   *Lr = L;
-  MIRDWT(x, m, n, h, lh, L, yl, yh);
+  MIRDWT(x, yh, single, m, n, h, lh, L0, L);
+  mxFree(h);
 }
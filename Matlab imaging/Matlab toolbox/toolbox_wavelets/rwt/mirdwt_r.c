@@ -48,8 +48,15 @@ Change History: Fixed the code such that 1D vectors passed to it can be in
 
                 Fix minor bug to allow maximum number of levels
 
+                Filter with the dilated filter on blocks of neighbouring
+                rows/columns (rwt_atrous.h) instead of gathering the
+                polyphase sequences one at a time, in parallel with OpenMP.
+                Single precision input, and a first level L0 so that the
+                levels can be inverted one at a time. Fixed the write past
+                the end of g1 for filters of even length.
+
 MATLAB description:
-%function x = mirdwt(yl,yh,h,L);
+%function x = mirdwt(yl,yh,h,L,L0);
 % 
 % function computes the inverse redundant discrete wavelet transform y for a
 % 1D or  2D input signal. redundant means here that the subsampling after
@@ -65,154 +72,146 @@ MATLAB description:
 %       L    : number of levels. in case of a 1D signal length(yl) must be
 %              divisible by 2^L; in case of a 2D signal the row and the
 %              column dimension must be divisible by 2^L.
+%       L0   : first level (default 1). yh then only holds the levels
+%              L0..L and x is the lowpass of level L0-1, so that
+%              yl = mirdwt(yl,yh_j,h,j,j) for j=L..1 inverts the
+%              transform one level at a time.
 %   
 %    Output:
-%	x    : finite length 1D or 2D signal
+%	x    : finite length 1D or 2D signal (same class as yl)
 %
 % see also: mdwt, midwt, mrdwt
 
 */
 #include <math.h>
 #include <stdio.h>
+#include "mex.h"
+#include "rwt_atrous.h"
 
 #define max(a, b) ((a) > (b) ? (a) : (b))
-#define mat(a, i, j) (*(a + (m*(j)+i)))  /* macro for matrix indices */
-
-#ifdef __STDC__
-MIRDWT(double *x, int m, int n, double *h, int lh, int L,
-       double *yl, double *yh)
-#else
-MIRDWT(x, m, n, h, lh, L, yl, yh)
-double *x, *h, *yl, *yh;
-int m, n, lh, L;
+
+/* one level of the redundant synthesis, in place on x. yh holds the
+   band of a 1D signal, or the [lh hl hh] bands of a 2D signal; xh is a
+   m x n scratch array of the class of x. */
+static void mirdwt_level(void *x, const void *yh, void *xh, int single,
+			 int m, int n, double *g0, double *g1, int lh,
+			 int sample_f, double *work, size_t wsize)
+{
+  int len, s, n_s, ic;
+  size_t shift = (size_t)(lh-1)*sample_f, mn = (size_t)m*n;
+
+  if (m == 1){
+    /* 1D: one lane, blocks of outputs in parallel */
+    double *extl = work, *exth, *out;
+    int nb = (n+RWT_BLOCK-1)/RWT_BLOCK, b;
+    len = n + (lh-1)*sample_f;
+    exth = extl + len;
+    out = exth + len;
+    rwt_gather(x, single, 0, 1, 1, n, rwt_start(n,shift), len, extl);
+    rwt_gather(yh, single, 0, 1, 1, n, rwt_start(n,shift), len, exth);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(n*lh>RWT_MIN_PARALLEL)
+#endif
+    for (b=0; b<nb; b++){
+      size_t k0 = (size_t)b*RWT_BLOCK;
+      size_t lb = n-k0 < RWT_BLOCK ? n-k0 : RWT_BLOCK;
+      rwt_synthesis_lanes(extl+k0, exth+k0, lb, sample_f, g0, g1, lh,
+			  out+k0);
+    }
+    rwt_scatter(x, single, 0, 1, 1, n, out);
+    return;
+  }
+
+  /* go by columns: LL/LH into x, HL/HH into xh */
+  len = m + (lh-1)*sample_f;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(mn*lh>RWT_MIN_PARALLEL)
+#endif
+  for (ic=0; ic<n; ic++){
+    double *ext = work + wsize*rwt_thread_num();
+    double *out = ext + (size_t)4*len;
+    size_t off = (size_t)m*ic;
+    int start = rwt_start(m,shift);
+    rwt_gather(x, single, off, 1, 1, m, start, len, ext);
+    rwt_gather(yh, single, off, 1, 1, m, start, len, ext+len);
+    rwt_gather(yh, single, mn+off, 1, 1, m, start, len, ext+2*len);
+    rwt_gather(yh, single, 2*mn+off, 1, 1, m, start, len, ext+3*len);
+    rwt_synthesis_lanes(ext, ext+len, m, sample_f, g0, g1, lh, out);
+    rwt_synthesis_lanes(ext+2*len, ext+3*len, m, sample_f, g0, g1, lh,
+			out+m);
+    rwt_scatter(x, single, off, 1, 1, m, out);
+    rwt_scatter(xh, single, off, 1, 1, m, out+m);
+  }
+
+  /* go by rows: strips of RWT_STRIP neighbouring rows */
+  len = n + (lh-1)*sample_f;
+  n_s = (m+RWT_STRIP-1)/RWT_STRIP;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(mn*lh>RWT_MIN_PARALLEL)
 #endif
+  for (s=0; s<n_s; s++){
+    double *extl = work + wsize*rwt_thread_num();
+    double *exth = extl + (size_t)len*RWT_STRIP;
+    double *out = exth + (size_t)len*RWT_STRIP;
+    int r0 = s*RWT_STRIP;
+    int R = m-r0 < RWT_STRIP ? m-r0 : RWT_STRIP;
+    int start = rwt_start(n,shift);
+    rwt_gather(x, single, r0, m, R, n, start, len, extl);
+    rwt_gather(xh, single, r0, m, R, n, start, len, exth);
+    rwt_synthesis_lanes(extl, exth, (size_t)n*R, (size_t)sample_f*R,
+			g0, g1, lh, out);
+    rwt_scatter(x, single, r0, m, R, n, out);
+  }
+}
+
+/* x holds the lowpass of level L on entry and the lowpass of level L0-1
+   on exit. yh holds the highpass components of the levels L0..L. */
+void MIRDWT(void *x, const void *yh, int single, int m, int n, double *h,
+	    int lh, int L0, int L)
 {
-  double  *g0, *g1, *ydummyll, *ydummylh, *ydummyhl;
-  double *ydummyhh, *xdummyl , *xdummyh, *xh;
-  long i, j;
-  int actual_L, actual_m, actual_n, c_o_a, ir, n_c, n_cb, n_c_o, lhm1;
-  int ic, n_r, n_rb, n_r_o, c_o_a_p2n, sample_f;
-  xh = (double *)mxCalloc(m*n,sizeof(double));
-  xdummyl = (double *)mxCalloc(max(m,n),sizeof(double));
-  xdummyh = (double *)mxCalloc(max(m,n),sizeof(double));
-  ydummyll = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  ydummylh = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  ydummyhl = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  ydummyhh = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  g0 = (double *)mxCalloc(lh,sizeof(double));
-  g1 = (double *)mxCalloc(lh,sizeof(double));
-  
+  double *g0, *g1, *work;
+  void *xh = NULL;
+  size_t wsize, band, esize = single ? sizeof(float) : sizeof(double);
+  int i, actual_L, sample_f, span;
+
   if (n==1){
     n = m;
     m = 1;
   }
-  /* analysis lowpass and highpass */
+  if (L < L0)
+    return;
+  g0 = (double *)mxCalloc(lh,sizeof(double));
+  g1 = (double *)mxCalloc(lh,sizeof(double));
+  /* synthesis lowpass and highpass */
   for (i=0; i<lh; i++){
     g0[i] = h[i]/2;
     g1[i] = h[lh-i-1]/2;
   }
-  for (i=1; i<=lh; i+=2)
+  for (i=1; i<lh; i+=2)
     g1[i] = -g1[i];
-  
-  lhm1 = lh - 1;
-  /* 2^L */
-  sample_f = 1;
-  for (i=1; i<L; i++)
-    sample_f = sample_f*2;
-  actual_m = m/sample_f;
-  actual_n = n/sample_f;
-  /* restore yl in x */
-  for (i=0;i<m*n;i++)
-    x[i] = yl[i];
-  
-  /* main loop */
-  for (actual_L=L; actual_L >= 1; actual_L--){
-    /* actual (level dependent) column offset */
-    if (m==1)
-      c_o_a = n*(actual_L-1);
-    else
-      c_o_a = 3*n*(actual_L-1);
-    c_o_a_p2n = c_o_a + 2*n;
-    
-    /* go by columns in case of a 2D signal*/
-    if (m>1){
-      n_rb = m/actual_m;                 /* # of row blocks per column */
-      for (ic=0; ic<n; ic++){            /* loop over column */
-	for (n_r=0; n_r<n_rb; n_r++){    /* loop within one column */
-	  /* store in dummy variables */
-	  ir = -sample_f + n_r;
-	  for (i=0; i<actual_m; i++){    
-	    ir = ir + sample_f;
-	    ydummyll[i+lhm1] = mat(x, ir, ic);  
-	    ydummylh[i+lhm1] = mat(yh, ir, c_o_a+ic);  
-	    ydummyhl[i+lhm1] = mat(yh, ir,c_o_a+n+ic);  
-	    ydummyhh[i+lhm1] = mat(yh, ir, c_o_a_p2n+ic);   
-	  }
-	  /* perform filtering and adding: first LL/LH, then HL/HH */
-	  bpconv(xdummyl, actual_m, g0, g1, lh, ydummyll, ydummylh); 
-	  bpconv(xdummyh, actual_m, g0, g1, lh, ydummyhl, ydummyhh); 
-	  /* store dummy variables in matrices */
-	  ir = -sample_f + n_r;
-	  for (i=0; i<actual_m; i++){    
-	    ir = ir + sample_f;
-	    mat(x, ir, ic) = xdummyl[i];  
-	    mat(xh, ir, ic) = xdummyh[i];  
-	  }
-	}
-      }
-    }
-    
-    /* go by rows */
-    n_cb = n/actual_n;                 /* # of column blocks per row */
-    for (ir=0; ir<m; ir++){            /* loop over rows */
-      for (n_c=0; n_c<n_cb; n_c++){    /* loop within one row */      
-	/* store in dummy variable */
-	ic = -sample_f + n_c;
-	for  (i=0; i<actual_n; i++){    
-	  ic = ic + sample_f;
-	  ydummyll[i+lhm1] = mat(x, ir, ic);  
-	  if (m>1)
-	    ydummyhh[i+lhm1] = mat(xh, ir, ic);  
-	  else
-	    ydummyhh[i+lhm1] = mat(yh, ir, c_o_a+ic);  
-	} 
-	/* perform filtering lowpass/highpass */
-	bpconv(xdummyl, actual_n, g0, g1, lh, ydummyll, ydummyhh); 
-	/* restore dummy variables in matrices */
-	ic = -sample_f + n_c;
-	for (i=0; i<actual_n; i++){    
-	  ic = ic + sample_f;
-	  mat(x, ir, ic) = xdummyl[i];  
-	}
-      }
-    }
-    sample_f = sample_f/2;
-    actual_m = actual_m*2;
-    actual_n = actual_n*2;
-  }
-}
 
-#ifdef __STDC__
-bpconv(double *x_out, int lx, double *g0, double *g1, int lh,
-       double *x_inl, double *x_inh)
-#else
-bpconv(x_out, lx, g0, g1, lh, x_inl, x_inh)
-double *x_inl, *x_inh, *g0, *g1, *x_out;
-int lx, lh;
-#endif
-{
-  int i, j;
-  double x0;
- 
-  for (i=lh-2; i > -1; i--){
-    x_inl[i] = x_inl[lx+i];
-    x_inh[i] = x_inh[lx+i];
+  /* work space for the coarsest level, one slice per thread */
+  span = (lh-1)*(1<<(L-1));
+  if (m == 1)
+    wsize = (size_t)2*(n+span) + n;
+  else{
+    wsize = max((size_t)2*(n+span)*RWT_STRIP + (size_t)n*RWT_STRIP,
+		(size_t)4*(m+span) + (size_t)2*m);
+    xh = mxMalloc((size_t)m*n*esize);
   }
-  for (i=0; i<lx; i++){
-    x0 = 0;
-    for (j=0; j<lh; j++)
-      x0 = x0 + x_inl[j+i]*g0[lh-1-j] +
-	x_inh[j+i]*g1[lh-1-j];
-    x_out[i] = x0;
+  work = (double *)mxMalloc(wsize*(m == 1 ? 1 : rwt_max_threads())*
+			    sizeof(double));
+
+  band = (size_t)m*n*(m == 1 ? 1 : 3)*esize;
+  sample_f = 1<<(L-1);
+  for (actual_L=L; actual_L >= L0; actual_L--){
+    mirdwt_level(x, (const char *)yh + band*(actual_L-L0), xh, single,
+		 m, n, g0, g1, lh, sample_f, work, wsize);
+    sample_f = sample_f/2;
   }
+  mxFree(work);
+  if (xh)
+    mxFree(xh);
+  mxFree(g0);
+  mxFree(g1);
 }
@@ -15,6 +15,9 @@ or as part of any commercial product is specifically reserved for the author.
 Change History: Fixed code such that the result has the same dimension as the 
                 input for 1D problems. Also, added some standard error checking.
 		Jan Erik Odegard <odegard@ece.rice.edu> Wed Jun 14 1995
+
+                Accept single precision input and an optional first level
+                L0, see mrdwt_r.c.
 */
 
 #include <math.h>
@@ -28,35 +31,45 @@ Change History: Fixed code such that the result has the same dimension as the
 #define even(x)  ((x & 1) ? 0 : 1)
 #define isint(x) ((x - floor(x)) > 0.0 ? 0 : 1)
 
+void MRDWT(void *yl, void *yh, int single, int m, int n, double *h, int lh,
+	   int L0, int L);
+
 
 void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
 
 {
-  double *x, *h,  *yl, *yh, *Lf, *Lr;
-  int m, n, h_col, h_row, lh, L, i, po2, j;
+  double *h, *Lf, *Lr;
+  void *yl, *yh;
+  int m, n, h_col, h_row, lh, L, L0, i, po2, j, single;
   double mtest, ntest;
+  mxClassID cls;
 
   /* check for correct # of input variables */
-  if (nrhs>3){
-    mexErrMsgTxt("There are at most 3 input parameters allowed!");
+  if (nrhs>4){
+    mexErrMsgTxt("There are at most 4 input parameters allowed!");
     return;
   }
   if (nrhs<2){
     mexErrMsgTxt("There are at least 2 input parameters required!");
     return;
   }
-  x = mxGetPr(prhs[0]);
+  if ((!mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0])) || mxIsComplex(prhs[0]))
+    mexErrMsgTxt("The input signal must be a real double or single array");
+  single = mxIsSingle(prhs[0]);
+  cls = mxGetClassID(prhs[0]);
   n = mxGetN(prhs[0]); 
   m = mxGetM(prhs[0]); 
-  h = mxGetPr(prhs[1]);
   h_col = mxGetN(prhs[1]); 
   h_row = mxGetM(prhs[1]); 
   if (h_col>h_row)
     lh = h_col;
   else  
     lh = h_row;
-  if (nrhs == 3){
-    L = (int) *mxGetPr(prhs[2]);
+  h = (double *)mxCalloc(lh,sizeof(double));
+  for (i=0; i<lh; i++)
+    h[i] = mxIsSingle(prhs[1]) ? ((float *)mxGetData(prhs[1]))[i] : mxGetPr(prhs[1])[i];
+  if (nrhs >= 3){
+    L = (int) mxGetScalar(prhs[2]);
     if (L < 0)
       mexErrMsgTxt("The number of levels, L, must be a non-negative integer");
   }
@@ -80,6 +93,12 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
       return;
     }
   }
+  L0 = 1;
+  if (nrhs == 4){
+    L0 = (int) mxGetScalar(prhs[3]);
+    if (L0 < 1 || L0 > max(L,1))
+      mexErrMsgTxt("The first level, L0, must be an integer in 1..L");
+  }
   /* Check the ROW dimension of input */
   if(m > 1){
     mtest = (double) m/pow(2.0, (double) L);
@@ -92,15 +111,16 @@ void mexFunction(int nlhs,mxArray *plhs[],int nrhs,const mxArray *prhs[])
     if (!isint(ntest))
       mexErrMsgTxt("The matrix column dimension must be of size n*2^(L)");
   }
-  plhs[0] = mxCreateDoubleMatrix(m,n,mxREAL);
-  yl = mxGetPr(plhs[0]);
+  plhs[0] = mxDuplicateArray(prhs[0]);
+  yl = mxGetData(plhs[0]);
   if (min(m,n) == 1)
-    plhs[1] = mxCreateDoubleMatrix(m,L*n,mxREAL);
+    plhs[1] = mxCreateNumericMatrix(m,max(L-L0+1,0)*n,cls,mxREAL);
   else
-    plhs[1] = mxCreateDoubleMatrix(m,3*L*n,mxREAL);
-  yh = mxGetPr(plhs[1]);
+    plhs[1] = mxCreateNumericMatrix(m,3*max(L-L0+1,0)*n,cls,mxREAL);
+  yh = mxGetData(plhs[1]);
   plhs[2] = mxCreateDoubleMatrix(1,1,mxREAL);
   Lr = mxGetPr(plhs[2]);
   *Lr = L;
-  MRDWT(x, m, n, h, lh, L, yl, yh);
+  MRDWT(yl, yh, single, m, n, h, lh, L0, L);
+  mxFree(h);
 }
@@ -46,8 +46,14 @@ Change History: Fixed the code such that 1D vectors passed to it can be in
 		C compilers as well as for ANSI C compilers
 		Jan Erik Odegard <odegard@ece.rice.edu> Wed Jun 14 1995
 
+                Filter with the dilated filter on blocks of neighbouring
+                rows/columns (rwt_atrous.h) instead of gathering the
+                polyphase sequences one at a time, in parallel with OpenMP.
+                Single precision input, and a first level L0 so that the
+                levels can be computed one at a time.
+
 MATLAB description:
-%[yl,yh] = mrdwt(x,h,L);
+%[yl,yh] = mrdwt(x,h,L,L0);
 % 
 % function computes the redundant discrete wavelet transform y for a 1D or
 % 2D input signal . redundant means here that the subsampling after each
@@ -61,10 +67,14 @@ MATLAB description:
 %       L    : number of levels. in case of a 1D signal length(x) must be
 %              divisible by 2^L; in case of a 2D signal the row and the
 %              column dimension must be divisible by 2^L.
+%       L0   : first level computed (default 1). x is then the lowpass
+%              of level L0-1 and yh only holds the levels L0..L, so that
+%              [yl,yh] = mrdwt(yl,h,j,j) for j=1..L yields the
+%              transform one level at a time.
 %   
 %    Output:
-%       yl   : lowpass component
-%       yh   : highpass components
+%       yl   : lowpass component (same class as x, double or single)
+%       yh   : highpass components of the levels L0..L
 %
 % see also: mdwt, midwt, mirdwt
 
@@ -73,39 +83,98 @@ MATLAB description:
 
 #include <math.h>
 #include <stdio.h>
+#include "mex.h"
+#include "rwt_atrous.h"
 
-/*#define mat(a, i, j) (a[m*(j)+i]) */
-#define mat(a, i, j) (*(a + (m*(j)+i))) 
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
-#ifdef __STDC__
-MRDWT(double *x, int m, int n, double *h, int lh, int L,
-      double *yl, double *yh)
-#else
-MRDWT(x, m, n, h, lh, L, yl, yh)
-double *x, *h, *yl, *yh;
-int m, n, lh, L;
+/* one level of the redundant analysis, in place on yl. yh receives the
+   band of a 1D signal, or the [lh hl hh] bands of a 2D signal. */
+static void mrdwt_level(void *yl, void *yh, int single, int m, int n,
+			double *h0, double *h1, int lh, int sample_f,
+			double *work, size_t wsize)
+{
+  int len, s, n_s, ic;
+  size_t mn = (size_t)m*n;
+
+  if (m == 1){
+    /* 1D: one lane, blocks of outputs in parallel */
+    double *ext = work, *outl, *outh;
+    int nb = (n+RWT_BLOCK-1)/RWT_BLOCK, b;
+    len = n + (lh-1)*sample_f;
+    outl = ext + len;
+    outh = outl + n;
+    rwt_gather(yl, single, 0, 1, 1, n, 0, len, ext);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(n*lh>RWT_MIN_PARALLEL)
+#endif
+    for (b=0; b<nb; b++){
+      size_t k0 = (size_t)b*RWT_BLOCK;
+      size_t lb = n-k0 < RWT_BLOCK ? n-k0 : RWT_BLOCK;
+      rwt_analysis_lanes(ext+k0, lb, sample_f, h0, h1, lh, outl+k0, outh+k0);
+    }
+    rwt_scatter(yl, single, 0, 1, 1, n, outl);
+    rwt_scatter(yh, single, 0, 1, 1, n, outh);
+    return;
+  }
+
+  /* go by rows: strips of RWT_STRIP neighbouring rows */
+  len = n + (lh-1)*sample_f;
+  n_s = (m+RWT_STRIP-1)/RWT_STRIP;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(mn*lh>RWT_MIN_PARALLEL)
 #endif
+  for (s=0; s<n_s; s++){
+    double *ext = work + wsize*rwt_thread_num();
+    double *outl = ext + (size_t)len*RWT_STRIP;
+    double *outh = outl + (size_t)n*RWT_STRIP;
+    int r0 = s*RWT_STRIP;
+    int R = m-r0 < RWT_STRIP ? m-r0 : RWT_STRIP;
+    rwt_gather(yl, single, r0, m, R, n, 0, len, ext);
+    rwt_analysis_lanes(ext, (size_t)n*R, (size_t)sample_f*R, h0, h1, lh,
+		       outl, outh);
+    rwt_scatter(yl, single, r0, m, R, n, outl);
+    rwt_scatter(yh, single, r0, m, R, n, outh);
+  }
+
+  /* go by columns: first LL/LH, then HL/HH */
+  len = m + (lh-1)*sample_f;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(mn*lh>RWT_MIN_PARALLEL)
+#endif
+  for (ic=0; ic<n; ic++){
+    double *extl = work + wsize*rwt_thread_num();
+    double *exth = extl + len;
+    double *out = exth + len;
+    size_t off = (size_t)m*ic;
+    rwt_gather(yl, single, off, 1, 1, m, 0, len, extl);
+    rwt_gather(yh, single, off, 1, 1, m, 0, len, exth);
+    rwt_analysis_lanes(extl, m, sample_f, h0, h1, lh, out, out+m);
+    rwt_analysis_lanes(exth, m, sample_f, h0, h1, lh, out+2*m, out+3*m);
+    rwt_scatter(yl, single, off, 1, 1, m, out);
+    rwt_scatter(yh, single, off, 1, 1, m, out+m);
+    rwt_scatter(yh, single, mn+off, 1, 1, m, out+2*m);
+    rwt_scatter(yh, single, 2*mn+off, 1, 1, m, out+3*m);
+  }
+}
+
+/* yl holds x on entry and the lowpass of level L on exit. yh receives
+   the highpass components of the levels L0..L. */
+void MRDWT(void *yl, void *yh, int single, int m, int n, double *h, int lh,
+	   int L0, int L)
 {
-  double *tmp;
-  double  *h0, *h1, *ydummyll, *ydummylh, *ydummyhl;
-  double *ydummyhh, *xdummyl , *xdummyh;
-  long i, j;
-  int actual_L, actual_m, actual_n, c_o_a, ir, n_c, n_cb, n_c_o;
-  int ic, n_r, n_rb, n_r_o, c_o_a_p2n, sample_f;
-  xdummyl = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  xdummyh = (double *)mxCalloc(max(m,n)+lh-1,sizeof(double));
-  ydummyll = (double *)mxCalloc(max(m,n),sizeof(double));
-  ydummylh = (double *)mxCalloc(max(m,n),sizeof(double));
-  ydummyhl = (double *)mxCalloc(max(m,n),sizeof(double));
-  ydummyhh = (double *)mxCalloc(max(m,n),sizeof(double));
-  h0 = (double *)mxCalloc(lh,sizeof(double));
-  h1 = (double *)mxCalloc(lh,sizeof(double));
+  double *h0, *h1, *work;
+  size_t wsize, band;
+  int i, actual_L, sample_f, span;
 
   if (n==1){
     n = m;
     m = 1;
-  }  
+  }
+  if (L < L0)
+    return;
+  h0 = (double *)mxCalloc(lh,sizeof(double));
+  h1 = (double *)mxCalloc(lh,sizeof(double));
   /* analysis lowpass and highpass */
   for (i=0; i<lh; i++){
     h0[i] = h[lh-i-1];
@@ -113,99 +182,25 @@ int m, n, lh, L;
   }
   for (i=0; i<lh; i+=2)
     h1[i] = -h1[i];
-  
-  actual_m = 2*m;
-  actual_n = 2*n;
-  for (i=0; i<m*n; i++)
-    yl[i] = x[i];
-  
-  /* main loop */
-  sample_f = 1;
-  for (actual_L=1; actual_L <= L; actual_L++){
-    actual_m = actual_m/2;
-    actual_n = actual_n/2;
-    /* actual (level dependent) column offset */
-    if (m==1)
-      c_o_a = n*(actual_L-1);
-    else
-      c_o_a = 3*n*(actual_L-1);
-    c_o_a_p2n = c_o_a + 2*n;
-    
-    /* go by rows */
-    n_cb = n/actual_n;                 /* # of column blocks per row */
-    for (ir=0; ir<m; ir++){            /* loop over rows */
-      for (n_c=0; n_c<n_cb; n_c++){    /* loop within one row */      
-	/* store in dummy variable */
-	ic = -sample_f + n_c;
-	for (i=0; i<actual_n; i++){    
-	  ic = ic + sample_f;
-	  xdummyl[i] = mat(yl, ir, ic);  
-	}
-	/* perform filtering lowpass/highpass */
-	fpconv(xdummyl, actual_n, h0, h1, lh, ydummyll, ydummyhh); 
-	/* restore dummy variables in matrices */
-	ic = -sample_f + n_c;
-	for  (i=0; i<actual_n; i++){    
-	  ic = ic + sample_f;
-	  mat(yl, ir, ic) = ydummyll[i];  
-	  mat(yh, ir, c_o_a+ic) = ydummyhh[i];  
-	} 
-      }
-    }
-      
-    /* go by columns in case of a 2D signal*/
-    if (m>1){
-      n_rb = m/actual_m;                 /* # of row blocks per column */
-      for (ic=0; ic<n; ic++){            /* loop over column */
-	for (n_r=0; n_r<n_rb; n_r++){    /* loop within one column */
-	  /* store in dummy variables */
-	  ir = -sample_f + n_r;
-	  for (i=0; i<actual_m; i++){    
-	    ir = ir + sample_f;
-	    xdummyl[i] = mat(yl, ir, ic);  
-	    xdummyh[i] = mat(yh, ir,c_o_a+ic);  
-	  }
-	  /* perform filtering: first LL/LH, then HL/HH */
-	  fpconv(xdummyl, actual_m, h0, h1, lh, ydummyll, ydummylh); 
-	  fpconv(xdummyh, actual_m, h0, h1, lh, ydummyhl, ydummyhh); 
-	  /* restore dummy variables in matrices */
-	  ir = -sample_f + n_r;
-	  for (i=0; i<actual_m; i++){    
-	    ir = ir + sample_f;
-	    mat(yl, ir, ic) = ydummyll[i];  
-	    mat(yh, ir, c_o_a+ic) = ydummylh[i];  
-	    mat(yh, ir,c_o_a+n+ic) = ydummyhl[i];  
-	    mat(yh, ir, c_o_a_p2n+ic) = ydummyhh[i];  
-	  }
-	}
-      }
-    }
-    sample_f = sample_f*2;
-  }
-}
 
-#ifdef __STDC__
-fpconv(double *x_in, int lx, double *h0, double *h1, int lh,
-       double *x_outl, double *x_outh)
-#else
-fpconv(x_in, lx, h0, h1, lh, x_outl, x_outh)
-double *x_in, *h0, *h1, *x_outl, *x_outh;
-int lx, lh;
-#endif
-{
-  int i, j;
-  double x0, x1;
-
-  for (i=lx; i < lx+lh-1; i++)
-    x_in[i] = x_in[i-lx];
-  for (i=0; i<lx; i++){
-    x0 = 0;
-    x1 = 0;
-    for (j=0; j<lh; j++){
-      x0 = x0 + x_in[j+i]*h0[lh-1-j];
-      x1 = x1 + x_in[j+i]*h1[lh-1-j];
-    }
-    x_outl[i] = x0;
-    x_outh[i] = x1;
+  /* work space for the coarsest level, one slice per thread */
+  span = (lh-1)*(1<<(L-1));
+  if (m == 1)
+    wsize = (size_t)3*n + span;
+  else
+    wsize = max((size_t)(n+span)*RWT_STRIP + (size_t)2*n*RWT_STRIP,
+		(size_t)2*(m+span) + (size_t)4*m);
+  work = (double *)mxMalloc(wsize*(m == 1 ? 1 : rwt_max_threads())*
+			    sizeof(double));
+
+  band = (size_t)m*n*(m == 1 ? 1 : 3)*(single ? sizeof(float) : sizeof(double));
+  sample_f = 1<<(L0-1);
+  for (actual_L=L0; actual_L <= L; actual_L++){
+    mrdwt_level(yl, (char *)yh + band*(actual_L-L0), single, m, n,
+		h0, h1, lh, sample_f, work, wsize);
+    sample_f = sample_f*2;
   }
+  mxFree(work);
+  mxFree(h0);
+  mxFree(h1);
 }
@@ -0,0 +1,143 @@
+/*
+File Name: rwt_atrous.h
+
+Shared kernels of the redundant transforms MRDWT and MIRDWT.
+
+Level j of the redundant transform filters with the filter dilated by
+sample_f = 2^(j-1), on a periodized signal. Instead of gathering the
+sample_f polyphase sequences of every row and column, the kernels below
+work on R interleaved lanes stored as ext[t*R+r]: the sample t of the
+dilated filter tap k sits at ext[(t+k*sample_f)*R+r], so each tap is one
+contiguous multiply-add over the whole block, which the compiler turns
+into SIMD code. Lanes are R neighbouring rows for the row pass and a
+single column for the column pass.
+
+The taps are accumulated in the same order as fpconv/bpconv did, so the
+double precision results are unchanged. Single precision arrays are
+filtered in double and rounded when stored back.
+*/
+
+#ifndef RWT_ATROUS_H
+#define RWT_ATROUS_H
+
+#include <stddef.h>
+#include "mex.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#define rwt_max_threads() omp_get_max_threads()
+#define rwt_thread_num()  omp_get_thread_num()
+#else
+#define rwt_max_threads() 1
+#define rwt_thread_num()  0
+#endif
+
+#define RWT_STRIP 16      /* rows filtered together in the row pass */
+#define RWT_BLOCK 1024    /* outputs accumulated while they stay in L1 */
+#define RWT_MIN_PARALLEL 32768
+
+/* ext[t*R+r] = a[off + r + stride*((start+t) mod n)], t = 0..len-1 */
+static __inline void rwt_gather(const void *a, int single, size_t off,
+				size_t stride, int R, int n, int start,
+				int len, double *ext)
+{
+  int t, r, c = start;
+  for (t=0; t<len; t++){
+    if (single){
+      const float *p = (const float *)a + off + stride*c;
+      for (r=0; r<R; r++)
+	ext[(size_t)t*R+r] = p[r];
+    }
+    else{
+      const double *p = (const double *)a + off + stride*c;
+      for (r=0; r<R; r++)
+	ext[(size_t)t*R+r] = p[r];
+    }
+    if (++c == n)
+      c = 0;
+  }
+}
+
+/* a[off + r + stride*i] = out[i*R+r], i = 0..n-1 */
+static __inline void rwt_scatter(void *a, int single, size_t off,
+				 size_t stride, int R, int n,
+				 const double *out)
+{
+  int i, r;
+  for (i=0; i<n; i++){
+    if (single){
+      float *p = (float *)a + off + stride*i;
+      for (r=0; r<R; r++)
+	p[r] = (float)out[(size_t)i*R+r];
+    }
+    else{
+      double *p = (double *)a + off + stride*i;
+      for (r=0; r<R; r++)
+	p[r] = out[(size_t)i*R+r];
+    }
+  }
+}
+
+/* first sample of the periodic extension delayed by shift samples */
+static __inline int rwt_start(int n, size_t shift)
+{
+  return (int)((n - shift%n) % n);
+}
+
+/* analysis: outl/outh[k] = sum_j ext[k+j*step]*h0/h1[lh-1-j], k < len */
+static __inline void rwt_analysis_lanes(const double *__restrict ext,
+					size_t len, size_t step,
+					const double *h0, const double *h1,
+					int lh, double *__restrict outl,
+					double *__restrict outh)
+{
+  size_t kb, ke, k;
+  int j;
+  for (kb=0; kb<len; kb+=RWT_BLOCK){
+    ke = kb+RWT_BLOCK < len ? kb+RWT_BLOCK : len;
+    for (k=kb; k<ke; k++){
+      outl[k] = 0;
+      outh[k] = 0;
+    }
+    for (j=0; j<lh; j++){
+      const double *__restrict src = ext + j*step;
+      const double c0 = h0[lh-1-j], c1 = h1[lh-1-j];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (k=kb; k<ke; k++){
+	outl[k] = outl[k] + src[k]*c0;
+	outh[k] = outh[k] + src[k]*c1;
+      }
+    }
+  }
+}
+
+/* synthesis: out[k] = sum_j extl[k+j*step]*g0[lh-1-j]
+                      + exth[k+j*step]*g1[lh-1-j], k < len */
+static __inline void rwt_synthesis_lanes(const double *__restrict extl,
+					 const double *__restrict exth,
+					 size_t len, size_t step,
+					 const double *g0, const double *g1,
+					 int lh, double *__restrict out)
+{
+  size_t kb, ke, k;
+  int j;
+  for (kb=0; kb<len; kb+=RWT_BLOCK){
+    ke = kb+RWT_BLOCK < len ? kb+RWT_BLOCK : len;
+    for (k=kb; k<ke; k++)
+      out[k] = 0;
+    for (j=0; j<lh; j++){
+      const double *__restrict srcl = extl + j*step;
+      const double *__restrict srch = exth + j*step;
+      const double c0 = g0[lh-1-j], c1 = g1[lh-1-j];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (k=kb; k<ke; k++)
+	out[k] = out[k] + srcl[k]*c0 + srch[k]*c1;
+    }
+  }
+}
+
+#endif
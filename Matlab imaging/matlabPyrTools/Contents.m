@@ -44,6 +44,8 @@
 %   setPyrBand - Insert an image into (any type of) pyramid as a subband 
 %   pyrBandIndices - Returns indices for given band in a pyramid vector
 %   maxPyrHt   - compute maximum number of scales in a pyramid
+%   buildPyr   - Build a Laplacian, wavelet or steerable pyramid [MEX file]
+%   reconPyr   - Reconstruct a whole pyramid built by buildPyr [MEX file]
 %
 % Gaussian/Laplacian Pyramids:
 %   buildGpyr  - Build a Gaussian pyramid of an input signal/image.
@@ -0,0 +1,172 @@
+/*
+[PYR, INDICES] = buildPyr(TYPE, IM, HT, FILTS, EDGES);
+  Build a pyramid of TYPE 'lpyr', 'spyr' or 'wpyr' in a single call.
+  >>> See buildLpyr.m, buildSpyr.m and buildWpyr.m for documentation <<<
+  FILTS is a cell array with the filters used by the M-file:
+    'lpyr': {FILT1, FILT2}
+    'spyr': {LO0FILT, HI0FILT, LOFILT, BFILTS}
+    'wpyr': {FILT, HFILT}
+  HT is not checked against maxPyrHt; the M-files do that.
+  This is a matlab interface to the build_*pyr functions of pyramid.c.
+*/
+
+#define V4_COMPAT
+#include <matrix.h>  /* Matlab matrices */
+#include <mex.h>
+#include <string.h>
+#include <math.h>
+
+#include "pyramid.h"
+
+#define notDblMtx(it) (!mxIsNumeric(it) || !mxIsDouble(it) || mxIsSparse(it) || mxIsComplex(it))
+
+/* filter I of the FILTS cell array; VECTOR filters become columns */
+static void get_filter(const mxArray *filts, int i, int vector, PYR_FILT *f)
+  {
+  const mxArray *arg = mxGetCell(filts, i);
+
+  if ((arg == NULL) || notDblMtx(arg))
+    mexErrMsgTxt("FILTS must contain non-sparse double float matrices.");
+  f->taps = mxGetPr(arg);
+  f->x_dim = (int) mxGetM(arg);
+  f->y_dim = (int) mxGetN(arg);
+  if (vector)
+      {
+      if ((f->x_dim > 1) && (f->y_dim > 1))
+	mexErrMsgTxt("FILTS must contain 1D filters (i.e., vectors) for this pyramid.");
+      f->x_dim *= f->y_dim;
+      f->y_dim = 1;
+      }
+  if (f->x_dim*f->y_dim == 0)
+    mexErrMsgTxt("FILTS must not contain empty filters.");
+  }
+
+void mexFunction(int nlhs,	     /* Num return vals on lhs */
+		 mxArray *plhs[],    /* Matrices on lhs      */
+		 int nrhs,	     /* Num args on rhs    */
+		 const mxArray *prhs[]     /* Matrices on rhs */
+		 )
+  {
+  double *image, *pyr, *ind;
+  int x_idim, y_idim, ht, nrows, nbands = 0, bsz, b, i, status;
+  int *xs, *ys;
+  size_t size;
+  const mxArray *arg0,*arg1,*arg2,*arg3;
+  PYR_FILT filt[4], *bfilts = NULL;
+  char type[8], edges[15] = "reflect1";
+
+  if (nrhs<4) mexErrMsgTxt("requres at least 4 args.");
+
+  /* ARG 1: TYPE */
+  arg0 = prhs[0];
+  if (!mxIsChar(arg0)) mexErrMsgTxt("TYPE arg must be a string.");
+  mxGetString(arg0,type,8);
+
+  /* ARG 2: IMAGE */
+  arg1 = prhs[1];
+  if notDblMtx(arg1) mexErrMsgTxt("IMAGE arg must be a non-sparse double float matrix.");
+  if (mxGetNumberOfDimensions(arg1) != 2) mexErrMsgTxt("IMAGE arg must be 2D.");
+  image = mxGetPr(arg1);
+  x_idim = (int) mxGetM(arg1); /* X is inner index! */
+  y_idim = (int) mxGetN(arg1);
+  if (x_idim*y_idim == 0) mexErrMsgTxt("IMAGE arg must not be empty.");
+
+  /* ARG 3: HT */
+  arg2 = prhs[2];
+  if (notDblMtx(arg2) || (mxGetM(arg2) * mxGetN(arg2) != 1))
+    mexErrMsgTxt("HT arg must be a scalar.");
+  ht = (int) mxGetScalar(arg2);
+  if (ht < 0) ht = 0;
+
+  /* ARG 5 (optional): EDGES */
+  if (nrhs>4)
+      {
+      if (!mxIsChar(prhs[4]))
+	mexErrMsgTxt("EDGES arg must be a string.");
+      mxGetString(prhs[4],edges,15);
+      }
+  if ((strcmp(edges,"circular") != 0) && (edge_function(edges) == NULL))
+    mexErrMsgTxt("EDGES arg must name a valid edge-handler.");
+
+  /* ARG 4: FILTS */
+  arg3 = prhs[3];
+  if (!mxIsCell(arg3)) mexErrMsgTxt("FILTS arg must be a cell array.");
+
+  if (strcmp(type,"lpyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 2)
+	mexErrMsgTxt("FILTS arg must be {FILT1, FILT2} for a Laplacian pyramid.");
+      get_filter(arg3, 0, 1, &filt[0]);
+      get_filter(arg3, 1, 1, &filt[1]);
+      nrows = (ht > 1) ? ht : 1;
+      }
+  else if (strcmp(type,"spyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 4)
+	mexErrMsgTxt("FILTS arg must be {LO0FILT, HI0FILT, LOFILT, BFILTS} for a steerable pyramid.");
+      for (i=0; i<4; i++)
+	get_filter(arg3, i, 0, &filt[i]);
+      nbands = filt[3].y_dim;
+      bsz = (int) (sqrt((double) filt[3].x_dim) + 0.5);
+      if (bsz*bsz != filt[3].x_dim)
+	mexErrMsgTxt("BFILTS columns must hold square filters.");
+      bfilts = (PYR_FILT *) mxCalloc(nbands, sizeof(PYR_FILT));
+      for (b=0; b<nbands; b++)
+	  {
+	  bfilts[b].taps = filt[3].taps + b*filt[3].x_dim;
+	  bfilts[b].x_dim = bfilts[b].y_dim = bsz;
+	  }
+      nrows = 2 + ht*nbands;
+      }
+  else if (strcmp(type,"wpyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 2)
+	mexErrMsgTxt("FILTS arg must be {FILT, HFILT} for a wavelet pyramid.");
+      get_filter(arg3, 0, 1, &filt[0]);
+      get_filter(arg3, 1, 1, &filt[1]);
+      nrows = 3*ht + 1;
+      }
+  else
+    mexErrMsgTxt("TYPE arg must be 'lpyr', 'spyr' or 'wpyr'.");
+
+  /* subband sizes, and the pyramid and indices to fill */
+  xs = (int *) mxCalloc(2*nrows, sizeof(int));
+  ys = xs + nrows;
+  if (type[0] == 'l')
+    nrows = lpyr_sizes(x_idim, y_idim, ht, xs, ys);
+  else if (type[0] == 's')
+    nrows = spyr_sizes(x_idim, y_idim, ht, nbands, xs, ys);
+  else
+    nrows = wpyr_sizes(x_idim, y_idim, ht, filt[0].x_dim, xs, ys);
+
+  plhs[1] = (mxArray *) mxCreateDoubleMatrix(nrows,2,mxREAL);
+  if (plhs[1] == NULL) mexErrMsgTxt("Cannot allocate result matrix");
+  ind = mxGetPr(plhs[1]);
+  for (size = 0, i=0; i<nrows; i++)
+      {
+      ind[i] = xs[i];
+      ind[nrows+i] = ys[i];
+      size += (size_t)xs[i]*ys[i];
+      }
+
+  plhs[0] = (mxArray *) mxCreateDoubleMatrix(size,1,mxREAL);
+  if (plhs[0] == NULL) mexErrMsgTxt("Cannot allocate result matrix");
+  pyr = mxGetPr(plhs[0]);
+
+  if (type[0] == 'l')
+    status = build_lpyr(image, x_idim, y_idim, ht, &filt[0], &filt[1],
+			edges, pyr);
+  else if (type[0] == 's')
+    status = build_spyr(image, x_idim, y_idim, ht, &filt[0], &filt[1],
+			&filt[2], bfilts, nbands, edges, pyr);
+  else
+    status = build_wpyr(image, x_idim, y_idim, ht, &filt[0], &filt[1],
+			edges, pyr);
+
+  mxFree((char *) xs);
+  if (bfilts != NULL) mxFree((char *) bfilts);
+  if (status != 0)
+    mexErrMsgTxt("Cannot build pyramid: FILTS larger than a subband, or out of memory.");
+
+  return;
+  }
@@ -7,8 +7,17 @@
 %
 % Rob Young, 9/08
 
-mex upConv.c convolve.c wrap.c edges.c
-mex corrDn.c convolve.c wrap.c edges.c
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" upConv.c convolve.c wrap.c edges.c
+    mex COMPFLAGS="$COMPFLAGS /openmp" corrDn.c convolve.c wrap.c edges.c
+    mex COMPFLAGS="$COMPFLAGS /openmp" buildPyr.c pyramid.c convolve.c wrap.c edges.c
+    mex COMPFLAGS="$COMPFLAGS /openmp" reconPyr.c pyramid.c convolve.c wrap.c edges.c
+else
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" upConv.c convolve.c wrap.c edges.c
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" corrDn.c convolve.c wrap.c edges.c
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" buildPyr.c pyramid.c convolve.c wrap.c edges.c
+    mex CFLAGS="\$CFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" reconPyr.c pyramid.c convolve.c wrap.c edges.c
+end
 mex histo.c
 %mex innerProd.c
 mex pointOp.c
@@ -11,6 +11,8 @@
 ;;;      8/97: Bug: when calling internal_reduce with edges in {reflect1,repeat,
 ;;;            extend} and an even filter dimension.  Solution: embed the filter
 ;;;            in the upper-left corner of a filter with odd Y and X dimensions.
+;;;            CENTER sections: vectorized row kernels, separable filters
+;;;            applied as two 1D passes, OpenMP over rows.
 ;;;  ----------------------------------------------------------------
 ;;;    Object-Based Vision and Image Understanding System (OBVIUS),
 ;;;      Copyright 1988, Vision Science Group,  Media Laboratory,  
@@ -34,6 +36,344 @@
   of the filter is assumed to be (floor(x_fdim/2), floor(y_fdim/2)).
 ------------------------------------------------------------------------ */
 
+/*
+  --------------------------------------------------------------------
+  Fast paths for the CENTER sections, where the filter lies entirely
+  inside the image and the edge handler returns it unchanged.  The
+  eight border sections still go through the edge-handling functions,
+  so the boundary rules are exactly those of edges.c.
+
+  Dense filters: a row of results is accumulated tap by tap, each tap
+  being one multiply-add over the whole row, which the compiler
+  vectorizes.  Every result still adds the taps in the order of
+  INPROD/INPROD2, so the output is bit-identical to the scalar loops.
+
+  Rank-1 (separable) filters with both dimensions > 1 are applied as
+  two 1D passes.  These agree with the 2D filter to rounding error.
+------------------------------------------------------------------------ */
+
+#define CTR_BLOCK 256	   /* results accumulated at once by reduce */
+#define RANK1_TOL 16.0e-16 /* relative tolerance of the rank-1 test */
+
+/* floor(a/b) and ceil(a/b) for b>0 */
+static int floor_div(int a, int b)
+  {
+  return((a>=0) ? (a/b) : -((-a+b-1)/b));
+  }
+static int ceil_div(int a, int b)
+  {
+  return(floor_div(a+b-1,b));
+  }
+
+/* number of positions start, start+step, ... below stop */
+static int n_steps(int start, int step, int stop)
+  {
+  return((start<stop) ? (stop-start+step-1)/step : 0);
+  }
+
+/* Factor FILT as COL*ROW (COL along y, ROW along x).  Returns 0 for
+   filters that are 1D or not rank-1. */
+static int rank1_filter(double *filt, int x_fdim, int y_fdim,
+			double *col, double *row)
+  {
+  int x, y, px = 0, py = 0;
+  double fmax = 0.0, piv;
+
+  if ((x_fdim IS 1) OR (y_fdim IS 1)) return(0);
+  for (y=0; y<y_fdim; y++)
+    for (x=0; x<x_fdim; x++)
+      if (ABS(filt[y*x_fdim+x]) > fmax)
+	{ fmax = ABS(filt[y*x_fdim+x]); px = x; py = y; }
+  if (fmax IS 0.0) return(0);
+  piv = filt[py*x_fdim+px];
+  for (x=0; x<x_fdim; x++) row[x] = filt[py*x_fdim+x];
+  for (y=0; y<y_fdim; y++) col[y] = filt[y*x_fdim+px]/piv;
+  for (y=0; y<y_fdim; y++)
+    for (x=0; x<x_fdim; x++)
+      if (ABS(filt[y*x_fdim+x]-col[y]*row[x]) > RANK1_TOL*fmax)
+	return(0);
+  return(1);
+  }
+
+/* RESULT[j*x_res_dim+i] = <FILT, IMAGE window at (x0+i*x_step,
+   y0+j*y_step)> for i<nx, j<ny, taps summed in raster order. */
+static void reduce_center_dense(double *image, int x_dim, double *filt,
+				int x_fdim, int y_fdim,
+				int x0, int x_step, int nx,
+				int y0, int y_step, int ny,
+				double *result, int x_res_dim)
+  {
+  int j;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)nx*ny*x_fdim*y_fdim > 1e5)
+#endif
+  for (j=0; j<ny; j++)
+    {
+    double acc[CTR_BLOCK];
+    int ib, i, n, fx, fy;
+    for (ib=0; ib<nx; ib+=CTR_BLOCK)
+      {
+      double *__restrict out = result + (size_t)j*x_res_dim + ib;
+      n = (nx-ib < CTR_BLOCK) ? nx-ib : CTR_BLOCK;
+      for (i=0; i<n; i++) acc[i] = 0.0;
+      for (fy=0; fy<y_fdim; fy++)
+	{
+	const double *src_row = image + (size_t)(y0+j*y_step+fy)*x_dim
+				      + x0 + ib*x_step;
+	for (fx=0; fx<x_fdim; fx++)
+	  {
+	  const double *__restrict src = src_row + fx;
+	  const double t = filt[fy*x_fdim+fx];
+	  if (x_step IS 1)
+	    {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+	    for (i=0; i<n; i++) acc[i] += src[i]*t;
+	    }
+	  else
+	    {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+	    for (i=0; i<n; i++) acc[i] += src[i*x_step]*t;
+	    }
+	  }
+	}
+      for (i=0; i<n; i++) out[i] = acc[i];
+      }
+    }
+  }
+
+/* Separable version of reduce_center: ROW along x, then COL along y.
+   Returns -1 if the temporary rows cannot be allocated. */
+static int reduce_center_sep(double *image, int x_dim,
+			     double *col, double *row,
+			     int x_fdim, int y_fdim,
+			     int x0, int x_step, int nx,
+			     int y0, int y_step, int ny,
+			     double *result, int x_res_dim)
+  {
+  int r, j, n_rows = (ny-1)*y_step + y_fdim;
+  double *hrows = (double *) malloc((size_t)n_rows*nx*sizeof(double));
+
+  if (hrows IS NULL) return(-1);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)n_rows*nx*x_fdim > 1e5)
+#endif
+  for (r=0; r<n_rows; r++)
+    {
+    double *__restrict h = hrows + (size_t)r*nx;
+    const double *src_row = image + (size_t)(y0+r)*x_dim + x0;
+    int i, fx;
+    for (i=0; i<nx; i++) h[i] = 0.0;
+    for (fx=0; fx<x_fdim; fx++)
+      {
+      const double *__restrict src = src_row + fx;
+      const double t = row[fx];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (i=0; i<nx; i++) h[i] += src[i*x_step]*t;
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)ny*nx*y_fdim > 1e5)
+#endif
+  for (j=0; j<ny; j++)
+    {
+    double *__restrict out = result + (size_t)j*x_res_dim;
+    int i, fy;
+    for (i=0; i<nx; i++) out[i] = 0.0;
+    for (fy=0; fy<y_fdim; fy++)
+      {
+      const double *__restrict h = hrows + (size_t)(j*y_step+fy)*nx;
+      const double t = col[fy];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (i=0; i<nx; i++) out[i] += h[i]*t;
+      }
+    }
+
+  free(hrows);
+  return(0);
+  }
+
+/* CENTER section of internal_reduce */
+static void reduce_center(double *image, int x_dim, double *filt,
+			  int x_fdim, int y_fdim,
+			  int x0, int x_step, int nx,
+			  int y0, int y_step, int ny,
+			  double *result, int x_res_dim)
+  {
+  int sep = 0;
+  double *col = (double *) malloc((x_fdim+y_fdim)*sizeof(double));
+
+  if ((col ISNT NULL) AND rank1_filter(filt, x_fdim, y_fdim, col, col+y_fdim))
+    sep = (reduce_center_sep(image, x_dim, col, col+y_fdim, x_fdim, y_fdim,
+			     x0, x_step, nx, y0, y_step, ny,
+			     result, x_res_dim) IS 0);
+  if (col ISNT NULL) free(col);
+  if (!sep)
+    reduce_center_dense(image, x_dim, filt, x_fdim, y_fdim,
+			x0, x_step, nx, y0, y_step, ny, result, x_res_dim);
+  }
+
+/* Add the contributions of the CENTER image samples IMAGE[j*x_im_dim+i]
+   (placed at x0+i*x_step, y0+j*y_step) to the results x_a <= x < x_b
+   of result row y.  For each result, the samples are taken with i
+   ascending, then j ascending: the order in which the CENTER loop of
+   internal_expand adds them. */
+static void expand_center_row(double *image, int x_im_dim, double *filt,
+			      int x_fdim, int y_fdim,
+			      int x0, int x_step, int nx,
+			      int y0, int y_step, int ny,
+			      double *result, int x_dim,
+			      int y, int x_a, int x_b)
+  {
+  double *res = result + (size_t)y*x_dim;
+  int j_lo = ceil_div(y-y0-y_fdim+1, y_step);
+  int j_hi = floor_div(y-y0, y_step);
+  int q, d, j, p, p_a, p_b, p_lo, p_hi, fx;
+
+  if (j_lo < 0) j_lo = 0;
+  if (j_hi > ny-1) j_hi = ny-1;
+
+  for (q=0; q<x_step; q++)     /* results x = x0+q+p*x_step */
+    {
+    p_a = ceil_div(x_a-x0-q, x_step);
+    p_b = ceil_div(x_b-x0-q, x_step);
+    for (d=(x_fdim-1-q)/x_step; d>=0; d--)   /* sample i = p-d */
+      {
+      fx = q + d*x_step;
+      if (fx >= x_fdim) continue;
+      p_lo = (p_a > d) ? p_a : d;
+      p_hi = (p_b < nx+d) ? p_b : nx+d;
+      for (j=j_lo; j<=j_hi; j++)
+	{
+	double *__restrict out = res + x0 + q;
+	const double *__restrict src = image + (size_t)j*x_im_dim - d;
+	const double t = filt[(y-y0-j*y_step)*x_fdim + fx];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+	for (p=p_lo; p<p_hi; p++)
+	  out[p*x_step] += src[p]*t;
+	}
+      }
+    }
+  }
+
+/* Separable contribution of the CENTER samples to the results in
+   [x_a,x_b) x [y_a,y_b), which only receive CENTER samples.  Returns -1
+   if the temporary rows cannot be allocated. */
+static int expand_center_sep(double *image, int x_im_dim,
+			     double *col, double *row,
+			     int x_fdim, int y_fdim,
+			     int x0, int x_step, int nx,
+			     int y0, int y_step, int ny,
+			     double *result, int x_dim,
+			     int x_a, int x_b, int y_a, int y_b)
+  {
+  int j_lo = ceil_div(y_a-y0-y_fdim+1, y_step);
+  int j_hi = floor_div(y_b-1-y0, y_step);
+  int n_x = x_b-x_a, j, y;
+  double *hrows;
+
+  if (j_lo < 0) j_lo = 0;
+  if (j_hi > ny-1) j_hi = ny-1;
+  hrows = (double *) malloc((size_t)(j_hi-j_lo+1)*n_x*sizeof(double));
+  if (hrows IS NULL) return(-1);
+
+  /* along x: upsampled sample rows j_lo..j_hi filtered by ROW */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)(j_hi-j_lo+1)*n_x*x_fdim > 1e5)
+#endif
+  for (j=j_lo; j<=j_hi; j++)
+    {
+    double *h = hrows + (size_t)(j-j_lo)*n_x;
+    const double *src = image + (size_t)j*x_im_dim;
+    int x, i, fx;
+    for (x=0; x<n_x; x++) h[x] = 0.0;
+    for (fx=0; fx<x_fdim; fx++)
+      {
+      int x_first = x_a + (((x0+fx-x_a)%x_step)+x_step)%x_step;
+      const double t = row[fx];
+      for (x=x_first, i=(x_first-x0-fx)/x_step; x<x_b; x+=x_step, i++)
+	h[x-x_a] += src[i]*t;
+      }
+    }
+
+  /* along y */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)(y_b-y_a)*n_x*y_fdim > 1e5)
+#endif
+  for (y=y_a; y<y_b; y++)
+    {
+    double *__restrict out = result + (size_t)y*x_dim + x_a;
+    int jj, x;
+    for (jj=floor_div(y-y0, y_step); jj>=0 AND y-y0-jj*y_step<y_fdim; jj--)
+      {
+      const double *__restrict h = hrows + (size_t)(jj-j_lo)*n_x;
+      const double t = col[y-y0-jj*y_step];
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+      for (x=0; x<n_x; x++) out[x] += h[x]*t;
+      }
+    }
+
+  free(hrows);
+  return(0);
+  }
+
+/* CENTER section of internal_expand: all results touched by the CENTER
+   samples, row by row.  Separable filters are applied in two passes to
+   the results that only receive CENTER samples. */
+static void expand_center(double *image, int x_im_dim, double *filt,
+			  int x_fdim, int y_fdim,
+			  int x0, int x_step, int nx,
+			  int y0, int y_step, int ny,
+			  double *result, int x_dim)
+  {
+  int x_end = x0 + (nx-1)*x_step + x_fdim;
+  int y_end = y0 + (ny-1)*y_step + y_fdim;
+  int x_a = x0 - x_step + x_fdim, x_b = x0 + nx*x_step;
+  int y_a = y0 - y_step + y_fdim, y_b = y0 + ny*y_step;
+  int y, sep = 0;
+  double *col = (double *) malloc((x_fdim+y_fdim)*sizeof(double));
+
+  if (x_a < x0) x_a = x0;
+  if (x_b > x_end) x_b = x_end;
+  if (y_a < y0) y_a = y0;
+  if (y_b > y_end) y_b = y_end;
+  if ((col ISNT NULL) AND (x_a < x_b) AND (y_a < y_b) AND
+      rank1_filter(filt, x_fdim, y_fdim, col, col+y_fdim))
+    sep = (expand_center_sep(image, x_im_dim, col, col+y_fdim, x_fdim, y_fdim,
+			     x0, x_step, nx, y0, y_step, ny, result, x_dim,
+			     x_a, x_b, y_a, y_b) IS 0);
+  if (col ISNT NULL) free(col);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if((double)nx*ny*x_fdim*y_fdim > 1e5)
+#endif
+  for (y=y0; y<y_end; y++)
+    if (sep AND (y >= y_a) AND (y < y_b))
+      {
+      expand_center_row(image, x_im_dim, filt, x_fdim, y_fdim, x0, x_step, nx,
+			y0, y_step, ny, result, x_dim, y, x0, x_a);
+      expand_center_row(image, x_im_dim, filt, x_fdim, y_fdim, x0, x_step, nx,
+			y0, y_step, ny, result, x_dim, y, x_b, x_end);
+      }
+    else
+      expand_center_row(image, x_im_dim, filt, x_fdim, y_fdim, x0, x_step, nx,
+			y0, y_step, ny, result, x_dim, y, x0, x_end);
+  }
+
 /* abstract out the inner product computation */
 #define INPROD(XCNR,YCNR)  \
         { \
@@ -72,7 +412,7 @@ int internal_reduce(image, x_dim, y_dim, filt, temp, x_fdim, y_fdim,
   int y_ctr_start = ((y_fdim==1)?0:1);
   int x_fmid = x_fdim/2;
   int y_fmid = y_fdim/2;
-  int base_res_pos;
+  int base_res_pos, n_ctr_x, n_ctr_y;
   fptr reflect = edge_function(edges);  /* look up edge-handling function */
 
   if (!reflect) return(-1);
@@ -124,13 +464,18 @@ int internal_reduce(image, x_dim, y_dim, filt, temp, x_fdim, y_fdim,
     }
 
   (*reflect)(filt,x_fdim,y_fdim,0,0,temp,REDUCE);
-  for (;				      /* CENTER */
-       x_pos<x_ctr_stop;
-       x_pos+=x_step, base_res_pos++) 
-    for (y_pos=y_ctr_start, res_pos=base_res_pos;
-	 y_pos<y_ctr_stop;
-	 y_pos+=y_step, res_pos+=x_res_dim)
-      INPROD(x_pos,y_pos)
+  n_ctr_x = n_steps(x_pos,x_step,x_ctr_stop);
+  n_ctr_y = n_steps(y_ctr_start,y_step,y_ctr_stop);
+  if (n_ctr_x > 0)			      /* CENTER */
+    {
+    reduce_center(image,x_dim,temp,x_fdim,y_fdim,
+		  x_pos,x_step,n_ctr_x,y_ctr_start,y_step,n_ctr_y,
+		  result+base_res_pos,x_res_dim);
+    x_pos += n_ctr_x*x_step;
+    base_res_pos += n_ctr_x;
+    y_pos = y_ctr_start + n_ctr_y*y_step;
+    res_pos = base_res_pos - 1 + n_ctr_y*x_res_dim;
+    }
 
   for (;				      /* RIGHT EDGE */
        x_pos<x_stop;
@@ -219,6 +564,7 @@ int internal_expand(image,filt,temp,x_fdim,y_fdim,
   int x_fmid = x_fdim/2;
   int y_fmid = y_fdim/2;
   int base_im_pos, x_im_dim = (x_stop-x_start+x_step-1)/x_step;
+  int n_ctr_x, n_ctr_y;
   fptr reflect = edge_function(edges);  /* look up edge-handling function */	 
 
   if (!reflect) return(-1);
@@ -270,13 +616,19 @@ int internal_expand(image,filt,temp,x_fdim,y_fdim,
     }
 
   (*reflect)(filt,x_fdim,y_fdim,0,0,temp,EXPAND);
-  for (;				      /* CENTER */
-       x_pos<x_ctr_stop;
-       x_pos+=x_step, base_im_pos++) 
-    for (y_pos=y_ctr_start, im_pos=base_im_pos;
-	 y_pos<y_ctr_stop;
-	 y_pos+=y_step, im_pos+=x_im_dim)
-      INPROD2(x_pos,y_pos)
+  n_ctr_x = n_steps(x_pos,x_step,x_ctr_stop);
+  n_ctr_y = n_steps(y_ctr_start,y_step,y_ctr_stop);
+  if (n_ctr_x > 0)			      /* CENTER */
+    {
+    if (n_ctr_y > 0)
+      expand_center(image+base_im_pos,x_im_dim,temp,x_fdim,y_fdim,
+		    x_pos,x_step,n_ctr_x,y_ctr_start,y_step,n_ctr_y,
+		    result,x_dim);
+    x_pos += n_ctr_x*x_step;
+    base_im_pos += n_ctr_x;
+    y_pos = y_ctr_start + n_ctr_y*y_step;
+    im_pos = base_im_pos - 1 + n_ctr_y*x_im_dim;
+    }
 
   for (;				      /* RIGHT EDGE */
        x_pos<x_stop;
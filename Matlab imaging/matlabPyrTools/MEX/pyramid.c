@@ -0,0 +1,697 @@
+/*
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;;;  File: pyramid.c
+;;;  Description: Build and collapse Laplacian, steerable and wavelet
+;;;    pyramids in a single call (see buildPyr.c and reconPyr.c).
+;;;    Each function runs the same sequence of corrDn/upConv operations
+;;;    as the corresponding M-file, so the subbands are identical, but
+;;;    without the round trips through Matlab.  The pyramid is stored
+;;;    as in the M code: all subbands concatenated in column order, with
+;;;    their [X Y] sizes in the XS and YS arrays (the rows of INDICES).
+;;;
+;;;    The subbands of one level are independent and are computed in
+;;;    parallel when compiled with OpenMP; the convolutions inside run
+;;;    on one thread in that case.  Reconstructions add the subbands
+;;;    into the result in the order of the M code.
+;;;
+;;;    All functions return 0, or -1 on an allocation failure or an
+;;;    unknown edge handler.
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pyramid.h"
+
+#define BAND_SIZE(xs,ys,i) ((size_t)(xs)[i]*(ys)[i])
+
+/*
+ --------------------------------------------------------------------
+ corrDn and upConv without the argument parsing of corrDn.c and
+ upConv.c: STOP is the image size (corr_dn) or the result size
+ (up_conv), and up_conv adds into RESULT.
+ -------------------------------------------------------------------- */
+
+int corr_dn(image, x_idim, y_idim, filt, edges,
+	    x_step, y_step, x_start, y_start, result)
+  register image_type *image, *result;
+  register int x_idim, y_idim, x_step, y_step, x_start, y_start;
+  PYR_FILT *filt;
+  char *edges;
+  {
+  image_type *temp;
+  int status;
+
+  if ((filt->x_dim > x_idim) OR (filt->y_dim > y_idim)) return(-1);
+
+  if (strcmp(edges,"circular") IS 0)
+    return(internal_wrap_reduce(image, x_idim, y_idim,
+				filt->taps, filt->x_dim, filt->y_dim,
+				x_start, x_step, x_idim,
+				y_start, y_step, y_idim, result));
+
+  temp = (image_type *) calloc(filt->x_dim*filt->y_dim, sizeof(image_type));
+  if (temp IS NULL) return(-1);
+  status = internal_reduce(image, x_idim, y_idim,
+			   filt->taps, temp, filt->x_dim, filt->y_dim,
+			   x_start, x_step, x_idim, y_start, y_step, y_idim,
+			   result, edges);
+  free((char *) temp);
+  return(status);
+  }
+
+int up_conv(image, x_idim, y_idim, filt, edges,
+	    x_step, y_step, x_start, y_start, result, x_rdim, y_rdim)
+  register image_type *image, *result;
+  register int x_idim, y_idim, x_step, y_step, x_start, y_start;
+  int x_rdim, y_rdim;
+  PYR_FILT *filt;
+  char *edges;
+  {
+  image_type *taps = filt->taps, *temp;
+  int x_fdim = filt->x_dim, y_fdim = filt->y_dim;
+  int x, y, status;
+
+  if ( (((x_rdim-x_start+x_step-1) / x_step) ISNT x_idim) OR
+       (((y_rdim-y_start+y_step-1) / y_step) ISNT y_idim) )
+    return(-1);
+
+  /* same work-around as upConv.c for even-length kernels */
+  if ((!strcmp(edges,"reflect1") OR !strcmp(edges,"extend") OR
+       !strcmp(edges,"repeat"))
+      AND
+      ((x_fdim%2 IS 0) OR (y_fdim%2 IS 0)))
+      {
+      x_fdim = 2*(filt->x_dim/2)+1;
+      y_fdim = 2*(filt->y_dim/2)+1;
+      taps = (image_type *) calloc(x_fdim*y_fdim, sizeof(image_type));
+      if (taps IS NULL) return(-1);
+      for (y=0; y<filt->y_dim; y++)
+	for (x=0; x<filt->x_dim; x++)
+	  taps[y*x_fdim + x] = filt->taps[y*filt->x_dim + x];
+      }
+
+  if ((x_fdim > x_rdim) OR (y_fdim > y_rdim))
+    status = -1;
+  else if (strcmp(edges,"circular") IS 0)
+    status = internal_wrap_expand(image, taps, x_fdim, y_fdim,
+				  x_start, x_step, x_rdim,
+				  y_start, y_step, y_rdim,
+				  result, x_rdim, y_rdim);
+  else
+    {
+    temp = (image_type *) calloc(x_fdim*y_fdim, sizeof(image_type));
+    if (temp IS NULL)
+      status = -1;
+    else
+      {
+      status = internal_expand(image, taps, temp, x_fdim, y_fdim,
+			       x_start, x_step, x_rdim,
+			       y_start, y_step, y_rdim,
+			       result, x_rdim, y_rdim, edges);
+      free((char *) temp);
+      }
+    }
+
+  if (taps ISNT filt->taps) free((char *) taps);
+  return(status);
+  }
+
+/* the transposed version of a vector filter */
+static PYR_FILT transposed(PYR_FILT *filt)
+  {
+  PYR_FILT t;
+  t.taps = filt->taps;
+  t.x_dim = filt->y_dim;
+  t.y_dim = filt->x_dim;
+  return(t);
+  }
+
+/*
+ --------------------------------------------------------------------
+ Subband sizes.  These follow buildSpyr.m, buildLpyr.m and buildWpyr.m
+ (including their choice of 1D or 2D filtering at every level).
+ -------------------------------------------------------------------- */
+
+int spyr_sizes(x_dim, y_dim, ht, nbands, xs, ys)
+  int x_dim, y_dim, ht, nbands, *xs, *ys;
+  {
+  int lev, b, n = 0;
+
+  xs[n] = x_dim; ys[n++] = y_dim;
+  for (lev=0; lev<ht; lev++)
+      {
+      for (b=0; b<nbands; b++)
+	{ xs[n] = x_dim; ys[n++] = y_dim; }
+      x_dim = (x_dim+1)/2;
+      y_dim = (y_dim+1)/2;
+      }
+  xs[n] = x_dim; ys[n++] = y_dim;
+  return(n);
+  }
+
+int lpyr_sizes(x_dim, y_dim, ht, xs, ys)
+  int x_dim, y_dim, ht, *xs, *ys;
+  {
+  int n = 0;
+
+  for (; ht > 1; ht--)
+      {
+      xs[n] = x_dim; ys[n++] = y_dim;
+      if (y_dim IS 1)
+	x_dim = (x_dim+1)/2;
+      else if (x_dim IS 1)
+	y_dim = (y_dim+1)/2;
+      else
+	{
+	x_dim = (x_dim+1)/2;
+	y_dim = (y_dim+1)/2;
+	}
+      }
+  xs[n] = x_dim; ys[n++] = y_dim;
+  return(n);
+  }
+
+int wpyr_sizes(x_dim, y_dim, ht, filt_size, xs, ys)
+  int x_dim, y_dim, ht, filt_size, *xs, *ys;
+  {
+  int stag = (filt_size%2 IS 0) ? 2 : 1;
+  int n = 0;
+
+  for (; ht > 0; ht--)
+      {
+      if (y_dim IS 1)
+	{
+	xs[n] = x_dim/2; ys[n++] = 1;
+	x_dim = (x_dim-stag+2)/2;
+	}
+      else if (x_dim IS 1)
+	{
+	xs[n] = 1; ys[n++] = y_dim/2;
+	y_dim = (y_dim-stag+2)/2;
+	}
+      else
+	{
+	xs[n] = x_dim/2;          ys[n++] = (y_dim-stag+2)/2;
+	xs[n] = (x_dim-stag+2)/2; ys[n++] = y_dim/2;
+	xs[n] = x_dim/2;          ys[n++] = y_dim/2;
+	x_dim = (x_dim-stag+2)/2;
+	y_dim = (y_dim-stag+2)/2;
+	}
+      }
+  xs[n] = x_dim; ys[n++] = y_dim;
+  return(n);
+  }
+
+/*
+ --------------------------------------------------------------------
+ Steerable pyramid (buildSpyr.m, reconSpyr.m).  BFILTS holds the
+ NBANDS oriented filters.
+ -------------------------------------------------------------------- */
+
+int build_spyr(image, x_dim, y_dim, ht, lo0filt, hi0filt, lofilt,
+	       bfilts, nbands, edges, pyr)
+  image_type *image, *pyr;
+  int x_dim, y_dim, ht, nbands;
+  PYR_FILT *lo0filt, *hi0filt, *lofilt, *bfilts;
+  char *edges;
+  {
+  size_t size = (size_t)x_dim*y_dim, off = size;
+  image_type *lo, *nlo, *tmp;
+  int lev, b, status = 0;
+
+  lo = (image_type *) calloc(size, sizeof(image_type));
+  nlo = (image_type *) calloc((size_t)((x_dim+1)/2)*((y_dim+1)/2),
+			      sizeof(image_type));
+  if ((lo IS NULL) OR (nlo IS NULL))
+    { free((char *) lo); free((char *) nlo); return(-1); }
+
+  /* residual highpass and the initial lowpass */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(|:status)
+#endif
+  for (b=0; b<2; b++)
+    if (b IS 0)
+      status |= corr_dn(image, x_dim, y_dim, hi0filt, edges,
+			1, 1, 0, 0, pyr);
+    else
+      status |= corr_dn(image, x_dim, y_dim, lo0filt, edges,
+			1, 1, 0, 0, lo);
+
+  for (lev=0; (lev<ht) AND (status IS 0); lev++)
+      {
+      size = (size_t)x_dim*y_dim;
+
+      /* the oriented bands and the next lowpass, written in place */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) reduction(|:status)
+#endif
+      for (b=0; b<=nbands; b++)
+	if (b < nbands)
+	  status |= corr_dn(lo, x_dim, y_dim, &bfilts[b], edges,
+			    1, 1, 0, 0, pyr + off + b*size);
+	else
+	  status |= corr_dn(lo, x_dim, y_dim, lofilt, edges,
+			    2, 2, 0, 0, nlo);
+
+      off += nbands*size;
+      x_dim = (x_dim+1)/2;
+      y_dim = (y_dim+1)/2;
+      tmp = lo; lo = nlo; nlo = tmp;
+      }
+
+  if (status IS 0)
+    memcpy(pyr + off, lo, (size_t)x_dim*y_dim*sizeof(image_type));
+
+  free((char *) lo);
+  free((char *) nlo);
+  return(status ? -1 : 0);
+  }
+
+int recon_spyr(pyr, nrows, xs, ys, lo0filt, hi0filt, lofilt,
+	       bfilts, nbands, edges, result)
+  image_type *pyr, *result;
+  int nrows, *xs, *ys, nbands;
+  PYR_FILT *lo0filt, *hi0filt, *lofilt, *bfilts;
+  char *edges;
+  {
+  int ht = (nbands > 0) ? (nrows-2)/nbands : 0;
+  int lev, b, row, x_dim, y_dim, status = 0;
+  size_t *off, size;
+  image_type *lo, *res;
+
+  off = (size_t *) malloc(nrows*sizeof(size_t));
+  if (off IS NULL) return(-1);
+  for (off[0] = 0, row=1; row<nrows; row++)
+    off[row] = off[row-1] + BAND_SIZE(xs,ys,row-1);
+
+  /* lowpass residual, expanded and combined with the bands of every
+     level, coarse to fine */
+  lo = pyr + off[nrows-1];
+  x_dim = xs[nrows-1];
+  y_dim = ys[nrows-1];
+  for (lev=ht-1; (lev>=0) AND (status IS 0); lev--)
+      {
+      row = 1 + lev*nbands;
+      size = BAND_SIZE(xs,ys,row);
+      res = (image_type *) calloc(size, sizeof(image_type));
+      if (res IS NULL) { status = -1; break; }
+      status |= up_conv(lo, x_dim, y_dim, lofilt, edges, 2, 2, 0, 0,
+			res, xs[row], ys[row]);
+      for (b=0; (b<nbands) AND (status IS 0); b++)
+	status |= up_conv(pyr + off[row+b], xs[row+b], ys[row+b],
+			  &bfilts[b], edges, 1, 1, 0, 0,
+			  res, xs[row], ys[row]);
+      if (lo ISNT pyr + off[nrows-1]) free((char *) lo);
+      lo = res;
+      x_dim = xs[row];
+      y_dim = ys[row];
+      }
+
+  if (status IS 0)
+    {
+    memset(result, 0, (size_t)x_dim*y_dim*sizeof(image_type));
+    status |= up_conv(lo, x_dim, y_dim, lo0filt, edges, 1, 1, 0, 0,
+		      result, x_dim, y_dim);
+    if (status IS 0)
+      status |= up_conv(pyr, xs[0], ys[0], hi0filt, edges, 1, 1, 0, 0,
+			result, x_dim, y_dim);
+    }
+
+  if (lo ISNT pyr + off[nrows-1]) free((char *) lo);
+  free((char *) off);
+  return(status ? -1 : 0);
+  }
+
+/*
+ --------------------------------------------------------------------
+ Laplacian pyramid (buildLpyr.m, reconLpyr.m).  FILT1 and FILT2 are
+ vectors; they are applied along X and then Y as in the M code.
+ -------------------------------------------------------------------- */
+
+/* lowpass/expand step of one level: EXPANDED (x_dim,y_dim) is the
+   upsampled version of LO (nx,ny) */
+static int lpyr_expand(lo, nx, ny, filt2, edges, expanded, x_dim, y_dim)
+  image_type *lo, *expanded;
+  int nx, ny, x_dim, y_dim;
+  PYR_FILT *filt2;
+  char *edges;
+  {
+  PYR_FILT f = *filt2, ft = transposed(filt2);
+  image_type *hi;
+  int status;
+
+  if (x_dim IS 1)
+    return(up_conv(lo, nx, ny, &ft, edges, 1, 2, 0, 0,
+		   expanded, x_dim, y_dim));
+  if (y_dim IS 1)
+    return(up_conv(lo, nx, ny, &f, edges, 2, 1, 0, 0,
+		   expanded, x_dim, y_dim));
+
+  hi = (image_type *) calloc((size_t)x_dim*ny, sizeof(image_type));
+  if (hi IS NULL) return(-1);
+  status = up_conv(lo, nx, ny, &f, edges, 2, 1, 0, 0, hi, x_dim, ny);
+  if (status IS 0)
+    status = up_conv(hi, x_dim, ny, &ft, edges, 1, 2, 0, 0,
+		     expanded, x_dim, y_dim);
+  free((char *) hi);
+  return(status);
+  }
+
+int build_lpyr(image, x_dim, y_dim, ht, filt1, filt2, edges, pyr)
+  image_type *image, *pyr;
+  int x_dim, y_dim, ht;
+  PYR_FILT *filt1, *filt2;
+  char *edges;
+  {
+  PYR_FILT f = *filt1, ft = transposed(filt1);
+  image_type *im = image, *lo, *lo2 = NULL;
+  size_t i, size;
+  int nx, ny, status = 0;
+
+  for (; (ht > 1) AND (status IS 0); ht--)
+      {
+      size = (size_t)x_dim*y_dim;
+      if (y_dim IS 1)
+	{ nx = (x_dim+1)/2; ny = 1; }
+      else if (x_dim IS 1)
+	{ nx = 1; ny = (y_dim+1)/2; }
+      else
+	{ nx = (x_dim+1)/2; ny = (y_dim+1)/2; }
+
+      lo2 = (image_type *) calloc((size_t)nx*ny, sizeof(image_type));
+      if (lo2 IS NULL) { status = -1; break; }
+      if (y_dim IS 1)
+	status = corr_dn(im, x_dim, y_dim, &f, edges, 2, 1, 0, 0, lo2);
+      else if (x_dim IS 1)
+	status = corr_dn(im, x_dim, y_dim, &ft, edges, 1, 2, 0, 0, lo2);
+      else
+	{
+	lo = (image_type *) calloc((size_t)x_dim*ny, sizeof(image_type));
+	if (lo IS NULL)
+	  status = -1;
+	else
+	  {
+	  status = corr_dn(im, x_dim, y_dim, &ft, edges, 1, 2, 0, 0, lo);
+	  if (status IS 0)
+	    status = corr_dn(lo, x_dim, ny, &f, edges, 2, 1, 0, 0, lo2);
+	  free((char *) lo);
+	  }
+	}
+
+      /* band = im - upConv(lo2), computed in the pyramid itself */
+      memset(pyr, 0, size*sizeof(image_type));
+      if (status IS 0)
+	status = lpyr_expand(lo2, nx, ny, filt2, edges, pyr, x_dim, y_dim);
+      for (i=0; i<size; i++)
+	pyr[i] = im[i] - pyr[i];
+
+      pyr += size;
+      if (im ISNT image) free((char *) im);
+      im = lo2;
+      x_dim = nx;
+      y_dim = ny;
+      }
+
+  if (status IS 0)
+    memcpy(pyr, im, (size_t)x_dim*y_dim*sizeof(image_type));
+  if (im ISNT image) free((char *) im);
+  return(status ? -1 : 0);
+  }
+
+int recon_lpyr(pyr, nrows, xs, ys, filt2, edges, result)
+  image_type *pyr, *result;
+  int nrows, *xs, *ys;
+  PYR_FILT *filt2;
+  char *edges;
+  {
+  image_type *lo, *res = NULL, *band;
+  size_t i, size, off = 0;
+  int row, status = 0;
+
+  for (row=0; row<nrows-1; row++)
+    off += BAND_SIZE(xs,ys,row);
+
+  lo = pyr + off;
+  for (row=nrows-2; (row>=0) AND (status IS 0); row--)
+      {
+      size = BAND_SIZE(xs,ys,row);
+      band = pyr + (off -= size);
+      res = (row IS 0) ? result : (image_type *) malloc(size*sizeof(image_type));
+      if (res IS NULL) { status = -1; break; }
+      memset(res, 0, size*sizeof(image_type));
+      status = lpyr_expand(lo, xs[row+1], ys[row+1], filt2, edges,
+			   res, xs[row], ys[row]);
+      for (i=0; i<size; i++)
+	res[i] = res[i] + band[i];
+      if (row < nrows-2) free((char *) lo);
+      lo = res;
+      }
+
+  if ((status ISNT 0) AND (res ISNT NULL) AND (res ISNT result))
+    free((char *) res);
+  if (nrows IS 1)
+    for (i=0; i<BAND_SIZE(xs,ys,0); i++)
+      result[i] = 0.0 + pyr[i];
+  return(status ? -1 : 0);
+  }
+
+/*
+ --------------------------------------------------------------------
+ Separable QMF/wavelet pyramid (buildWpyr.m, reconWpyr.m).  FILT is
+ the lowpass vector and HFILT its modulated version; even-length
+ filters are staggered by one sample as in the M code.
+ -------------------------------------------------------------------- */
+
+int build_wpyr(image, x_dim, y_dim, ht, filt, hfilt, edges, pyr)
+  image_type *image, *pyr;
+  int x_dim, y_dim, ht;
+  PYR_FILT *filt, *hfilt;
+  char *edges;
+  {
+  PYR_FILT ft = transposed(filt), hft = transposed(hfilt);
+  int stag = ((filt->x_dim*filt->y_dim)%2 IS 0) ? 2 : 1;
+  image_type *im = image, *lo, *hi, *lolo;
+  int xl, xh, yl, yh, t, status = 0;
+
+  for (; (ht > 0) AND (status IS 0); ht--)
+      {
+      if ((y_dim IS 1) OR (x_dim IS 1))
+	{
+	/* 1D: lowpass to the next level, highpass to the pyramid */
+	xl = (y_dim IS 1) ? (x_dim-stag+2)/2 : 1;
+	yl = (y_dim IS 1) ? 1 : (y_dim-stag+2)/2;
+	lolo = (image_type *) calloc((size_t)xl*yl, sizeof(image_type));
+	if (lolo IS NULL) { status = -1; break; }
+	if (y_dim IS 1)
+	  {
+	  status |= corr_dn(im, x_dim, y_dim, filt, edges,
+			    2, 1, stag-1, 0, lolo);
+	  status |= corr_dn(im, x_dim, y_dim, hfilt, edges,
+			    2, 1, 1, 0, pyr);
+	  pyr += x_dim/2;
+	  }
+	else
+	  {
+	  status |= corr_dn(im, x_dim, y_dim, &ft, edges,
+			    1, 2, 0, stag-1, lolo);
+	  status |= corr_dn(im, x_dim, y_dim, &hft, edges,
+			    1, 2, 0, 1, pyr);
+	  pyr += y_dim/2;
+	  }
+	}
+      else
+	{
+	xl = (x_dim-stag+2)/2; xh = x_dim/2;
+	yl = (y_dim-stag+2)/2; yh = y_dim/2;
+	lo = (image_type *) calloc((size_t)xl*y_dim, sizeof(image_type));
+	hi = (image_type *) calloc((size_t)xh*y_dim, sizeof(image_type));
+	lolo = (image_type *) calloc((size_t)xl*yl, sizeof(image_type));
+	if ((lo IS NULL) OR (hi IS NULL) OR (lolo IS NULL))
+	  {
+	  free((char *) lo); free((char *) hi); free((char *) lolo);
+	  status = -1;
+	  break;
+	  }
+
+	/* filter along X ... */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(|:status)
+#endif
+	for (t=0; t<2; t++)
+	  if (t IS 0)
+	    status |= corr_dn(im, x_dim, y_dim, filt, edges,
+			      2, 1, stag-1, 0, lo);
+	  else
+	    status |= corr_dn(im, x_dim, y_dim, hfilt, edges,
+			      2, 1, 1, 0, hi);
+
+	/* ... then along Y, straight into the pyramid */
+	if (status IS 0)
+	  {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) reduction(|:status)
+#endif
+	  for (t=0; t<4; t++)
+	    switch (t)
+	      {
+	      case 0:
+		status |= corr_dn(hi, xh, y_dim, &ft, edges,
+				  1, 2, 0, stag-1, pyr);
+		break;
+	      case 1:
+		status |= corr_dn(lo, xl, y_dim, &hft, edges,
+				  1, 2, 0, 1, pyr + (size_t)xh*yl);
+		break;
+	      case 2:
+		status |= corr_dn(hi, xh, y_dim, &hft, edges,
+				  1, 2, 0, 1, pyr + (size_t)xh*yl + (size_t)xl*yh);
+		break;
+	      default:
+		status |= corr_dn(lo, xl, y_dim, &ft, edges,
+				  1, 2, 0, stag-1, lolo);
+	      }
+	  }
+
+	free((char *) lo);
+	free((char *) hi);
+	pyr += (size_t)xh*yl + (size_t)xl*yh + (size_t)xh*yh;
+	}
+
+      if (im ISNT image) free((char *) im);
+      im = lolo;
+      x_dim = xl;
+      y_dim = yl;
+      }
+
+  if (status IS 0)
+    memcpy(pyr, im, (size_t)x_dim*y_dim*sizeof(image_type));
+  if (im ISNT image) free((char *) im);
+  return(status ? -1 : 0);
+  }
+
+/* reconWpyr.m, one level: returns the reconstruction of the subbands
+   starting at row 0 in *RES, sized (*X_RES, *Y_RES) */
+static int recon_wpyr_level(pyr, nrows, xs, ys, filt, hfilt, stag, edges,
+			    res, x_res, y_res)
+  image_type *pyr, **res;
+  int nrows, *xs, *ys, stag, *x_res, *y_res;
+  PYR_FILT *filt, *hfilt;
+  char *edges;
+  {
+  PYR_FILT ft = transposed(filt), hft = transposed(hfilt);
+  image_type *lo, *ires[4] = {NULL, NULL, NULL, NULL};
+  size_t off[4];
+  int nb, row, x_lo, y_lo, xr, yr, t, status = 0;
+
+  if ((xs[0] IS 1) OR (ys[0] IS 1))
+    {
+    nb = 1;
+    for (xr = yr = 0, row=0; row<nrows; row++)
+      { xr += xs[row]; yr += ys[row]; }
+    if (xs[0] IS 1) xr = 1; else yr = 1;
+    }
+  else
+    {
+    nb = 3;
+    if (nrows < 4) return(-1);
+    xr = xs[0] + xs[1];
+    yr = ys[0] + ys[1];
+    }
+  if (nrows < nb+1) return(-1);
+
+  for (off[0] = 0, row=1; row<=nb; row++)
+    off[row] = off[row-1] + BAND_SIZE(xs,ys,row-1);
+
+  /* lowpass: coarser levels, or the residual itself */
+  if (nrows > nb+1)
+    status = recon_wpyr_level(pyr + off[nb], nrows-nb, xs+nb, ys+nb,
+			      filt, hfilt, stag, edges, &lo, &x_lo, &y_lo);
+  else
+    { lo = pyr + off[nb]; x_lo = xs[nb]; y_lo = ys[nb]; }
+  if (status ISNT 0) return(-1);
+
+  *res = (image_type *) calloc((size_t)xr*yr, sizeof(image_type));
+  if (*res IS NULL) status = -1;
+  else if (xs[0] IS 1)
+    {
+    status |= up_conv(lo, x_lo, y_lo, &ft, edges, 1, 2, 0, stag-1,
+		      *res, xr, yr);
+    if (status IS 0)
+      status |= up_conv(pyr, xs[0], ys[0], &hft, edges, 1, 2, 0, 1,
+			*res, xr, yr);
+    }
+  else if (ys[0] IS 1)
+    {
+    status |= up_conv(lo, x_lo, y_lo, filt, edges, 2, 1, stag-1, 0,
+		      *res, xr, yr);
+    if (status IS 0)
+      status |= up_conv(pyr, xs[0], ys[0], hfilt, edges, 2, 1, 1, 0,
+			*res, xr, yr);
+    }
+  else
+    {
+    /* expand along Y in parallel: lowpass, bands 1, 2 and 3 */
+    int x_ires[4];
+    x_ires[0] = xs[1]; x_ires[1] = xs[0]; x_ires[2] = xs[1]; x_ires[3] = xs[0];
+    for (t=0; t<4; t++)
+      {
+      ires[t] = (image_type *) calloc((size_t)x_ires[t]*yr, sizeof(image_type));
+      if (ires[t] IS NULL) status = -1;
+      }
+    if (status IS 0)
+      {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) reduction(|:status)
+#endif
+      for (t=0; t<4; t++)
+	if (t IS 0)
+	  status |= up_conv(lo, x_lo, y_lo, &ft, edges, 1, 2, 0, stag-1,
+			    ires[0], x_ires[0], yr);
+	else
+	  status |= up_conv(pyr + off[t-1], xs[t-1], ys[t-1],
+			    (t IS 1) ? &ft : &hft, edges,
+			    1, 2, 0, (t IS 1) ? stag-1 : 1,
+			    ires[t], x_ires[t], yr);
+      }
+
+    /* ... then along X, into the result in the M-file order */
+    for (t=0; (t<4) AND (status IS 0); t++)
+      status |= up_conv(ires[t], x_ires[t], yr, (t%2 IS 0) ? filt : hfilt,
+			edges, 2, 1, (t%2 IS 0) ? stag-1 : 1, 0,
+			*res, xr, yr);
+    for (t=0; t<4; t++)
+      free((char *) ires[t]);
+    }
+
+  if (nrows > nb+1) free((char *) lo);
+  if ((status ISNT 0) AND (*res ISNT NULL))
+    { free((char *) *res); *res = NULL; }
+  *x_res = xr;
+  *y_res = yr;
+  return(status ? -1 : 0);
+  }
+
+int recon_wpyr(pyr, nrows, xs, ys, filt, hfilt, edges, result)
+  image_type *pyr, *result;
+  int nrows, *xs, *ys;
+  PYR_FILT *filt, *hfilt;
+  char *edges;
+  {
+  int stag = ((filt->x_dim*filt->y_dim)%2 IS 0) ? 2 : 1;
+  image_type *res;
+  int x_res, y_res;
+
+  if (nrows IS 1)
+    {
+    memcpy(result, pyr, BAND_SIZE(xs,ys,0)*sizeof(image_type));
+    return(0);
+    }
+  if (recon_wpyr_level(pyr, nrows, xs, ys, filt, hfilt, stag, edges,
+		       &res, &x_res, &y_res) ISNT 0)
+    return(-1);
+  memcpy(result, res, (size_t)x_res*y_res*sizeof(image_type));
+  free((char *) res);
+  return(0);
+  }
@@ -0,0 +1,45 @@
+/*
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;;;  File: pyramid.h
+;;;  Description: Header file for pyramid.c
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+*/
+
+#include "convolve.h"
+
+/* A filter as seen by corrDn/upConv: X is the inner (Matlab row) index */
+typedef struct
+  {
+  image_type *taps;
+  int x_dim, y_dim;
+  } PYR_FILT;
+
+int corr_dn(image_type *image, int x_idim, int y_idim, PYR_FILT *filt,
+	    char *edges, int x_step, int y_step, int x_start, int y_start,
+	    image_type *result);
+int up_conv(image_type *image, int x_idim, int y_idim, PYR_FILT *filt,
+	    char *edges, int x_step, int y_step, int x_start, int y_start,
+	    image_type *result, int x_rdim, int y_rdim);
+
+/* Subband sizes of a pyramid, one row per band.  XS and YS must hold
+   the number of rows, which is returned. */
+int spyr_sizes(int x_dim, int y_dim, int ht, int nbands, int *xs, int *ys);
+int lpyr_sizes(int x_dim, int y_dim, int ht, int *xs, int *ys);
+int wpyr_sizes(int x_dim, int y_dim, int ht, int filt_size,
+	       int *xs, int *ys);
+
+int build_spyr(image_type *image, int x_dim, int y_dim, int ht,
+	       PYR_FILT *lo0filt, PYR_FILT *hi0filt, PYR_FILT *lofilt,
+	       PYR_FILT *bfilts, int nbands, char *edges, image_type *pyr);
+int recon_spyr(image_type *pyr, int nrows, int *xs, int *ys,
+	       PYR_FILT *lo0filt, PYR_FILT *hi0filt, PYR_FILT *lofilt,
+	       PYR_FILT *bfilts, int nbands, char *edges, image_type *result);
+int build_lpyr(image_type *image, int x_dim, int y_dim, int ht,
+	       PYR_FILT *filt1, PYR_FILT *filt2, char *edges, image_type *pyr);
+int recon_lpyr(image_type *pyr, int nrows, int *xs, int *ys,
+	       PYR_FILT *filt2, char *edges, image_type *result);
+int build_wpyr(image_type *image, int x_dim, int y_dim, int ht,
+	       PYR_FILT *filt, PYR_FILT *hfilt, char *edges, image_type *pyr);
+int recon_wpyr(image_type *pyr, int nrows, int *xs, int *ys,
+	       PYR_FILT *filt, PYR_FILT *hfilt, char *edges,
+	       image_type *result);
@@ -0,0 +1,175 @@
+/*
+RES = reconPyr(TYPE, PYR, INDICES, FILTS, EDGES);
+  Reconstruct a whole pyramid of TYPE 'lpyr', 'spyr' or 'wpyr'.
+  >>> See reconLpyr.m, reconSpyr.m and reconWpyr.m for documentation <<<
+  FILTS is a cell array with the filters used by the M-file:
+    'lpyr': {FILT2}
+    'spyr': {LO0FILT, HI0FILT, LOFILT, BFILTS}
+    'wpyr': {FILT, HFILT}
+  All levels and bands are used (LEVS = BANDS = 'all' in the M-files).
+  This is a matlab interface to the recon_*pyr functions of pyramid.c.
+*/
+
+#define V4_COMPAT
+#include <matrix.h>  /* Matlab matrices */
+#include <mex.h>
+#include <string.h>
+#include <math.h>
+
+#include "pyramid.h"
+
+#define notDblMtx(it) (!mxIsNumeric(it) || !mxIsDouble(it) || mxIsSparse(it) || mxIsComplex(it))
+
+/* filter I of the FILTS cell array; VECTOR filters become columns */
+static void get_filter(const mxArray *filts, int i, int vector, PYR_FILT *f)
+  {
+  const mxArray *arg = mxGetCell(filts, i);
+
+  if ((arg == NULL) || notDblMtx(arg))
+    mexErrMsgTxt("FILTS must contain non-sparse double float matrices.");
+  f->taps = mxGetPr(arg);
+  f->x_dim = (int) mxGetM(arg);
+  f->y_dim = (int) mxGetN(arg);
+  if (vector)
+      {
+      if ((f->x_dim > 1) && (f->y_dim > 1))
+	mexErrMsgTxt("FILTS must contain 1D filters (i.e., vectors) for this pyramid.");
+      f->x_dim *= f->y_dim;
+      f->y_dim = 1;
+      }
+  if (f->x_dim*f->y_dim == 0)
+    mexErrMsgTxt("FILTS must not contain empty filters.");
+  }
+
+void mexFunction(int nlhs,	     /* Num return vals on lhs */
+		 mxArray *plhs[],    /* Matrices on lhs      */
+		 int nrhs,	     /* Num args on rhs    */
+		 const mxArray *prhs[]     /* Matrices on rhs */
+		 )
+  {
+  double *pyr, *ind, *result;
+  int nrows, nbands = 0, bsz, b, i, status;
+  int *xs, *ys, x_rdim, y_rdim;
+  size_t size;
+  const mxArray *arg0,*arg1,*arg2,*arg3;
+  PYR_FILT filt[4], *bfilts = NULL;
+  char type[8], edges[15] = "reflect1";
+
+  if (nrhs<4) mexErrMsgTxt("requres at least 4 args.");
+
+  /* ARG 1: TYPE */
+  arg0 = prhs[0];
+  if (!mxIsChar(arg0)) mexErrMsgTxt("TYPE arg must be a string.");
+  mxGetString(arg0,type,8);
+
+  /* ARG 2: PYR */
+  arg1 = prhs[1];
+  if notDblMtx(arg1) mexErrMsgTxt("PYR arg must be a non-sparse double float matrix.");
+  pyr = mxGetPr(arg1);
+
+  /* ARG 3: INDICES */
+  arg2 = prhs[2];
+  if notDblMtx(arg2) mexErrMsgTxt("INDICES arg must be a double float matrix.");
+  if ((mxGetN(arg2) != 2) || (mxGetM(arg2) < 1))
+    mexErrMsgTxt("INDICES arg must have two columns.");
+  nrows = (int) mxGetM(arg2);
+  ind = mxGetPr(arg2);
+  xs = (int *) mxCalloc(2*nrows, sizeof(int));
+  ys = xs + nrows;
+  for (size = 0, i=0; i<nrows; i++)
+      {
+      xs[i] = (int) ind[i];
+      ys[i] = (int) ind[nrows+i];
+      if ((xs[i] < 1) || (ys[i] < 1))
+	mexErrMsgTxt("INDICES arg must hold positive subband sizes.");
+      size += (size_t)xs[i]*ys[i];
+      }
+  if (size != mxGetNumberOfElements(arg1))
+    mexErrMsgTxt("PYR and INDICES args are incompatible.");
+
+  /* ARG 5 (optional): EDGES */
+  if (nrhs>4)
+      {
+      if (!mxIsChar(prhs[4]))
+	mexErrMsgTxt("EDGES arg must be a string.");
+      mxGetString(prhs[4],edges,15);
+      }
+  if ((strcmp(edges,"circular") != 0) && (edge_function(edges) == NULL))
+    mexErrMsgTxt("EDGES arg must name a valid edge-handler.");
+
+  /* ARG 4: FILTS, and the size of the result */
+  arg3 = prhs[3];
+  if (!mxIsCell(arg3)) mexErrMsgTxt("FILTS arg must be a cell array.");
+
+  if (strcmp(type,"lpyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 1)
+	mexErrMsgTxt("FILTS arg must be {FILT2} for a Laplacian pyramid.");
+      get_filter(arg3, 0, 1, &filt[0]);
+      x_rdim = xs[0];
+      y_rdim = ys[0];
+      }
+  else if (strcmp(type,"spyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 4)
+	mexErrMsgTxt("FILTS arg must be {LO0FILT, HI0FILT, LOFILT, BFILTS} for a steerable pyramid.");
+      for (i=0; i<4; i++)
+	get_filter(arg3, i, 0, &filt[i]);
+      nbands = filt[3].y_dim;
+      bsz = (int) (sqrt((double) filt[3].x_dim) + 0.5);
+      if (bsz*bsz != filt[3].x_dim)
+	mexErrMsgTxt("BFILTS columns must hold square filters.");
+      if ((nrows < 2) || ((nrows > 2) && ((nrows-2) % nbands != 0)))
+	mexErrMsgTxt("INDICES arg does not match the number of bands in BFILTS.");
+      bfilts = (PYR_FILT *) mxCalloc(nbands, sizeof(PYR_FILT));
+      for (b=0; b<nbands; b++)
+	  {
+	  bfilts[b].taps = filt[3].taps + b*filt[3].x_dim;
+	  bfilts[b].x_dim = bfilts[b].y_dim = bsz;
+	  }
+      x_rdim = xs[1];  /* size of the finest lowpass band */
+      y_rdim = ys[1];
+      }
+  else if (strcmp(type,"wpyr") == 0)
+      {
+      if (mxGetNumberOfElements(arg3) != 2)
+	mexErrMsgTxt("FILTS arg must be {FILT, HFILT} for a wavelet pyramid.");
+      get_filter(arg3, 0, 1, &filt[0]);
+      get_filter(arg3, 1, 1, &filt[1]);
+      if (nrows == 1)
+	{ x_rdim = xs[0]; y_rdim = ys[0]; }
+      else if (xs[0] == 1)
+	{ x_rdim = 1; for (y_rdim = 0, i=0; i<nrows; i++) y_rdim += ys[i]; }
+      else if (ys[0] == 1)
+	{ y_rdim = 1; for (x_rdim = 0, i=0; i<nrows; i++) x_rdim += xs[i]; }
+      else
+	{
+	if (nrows < 4)
+	  mexErrMsgTxt("INDICES arg does not describe a wavelet pyramid.");
+	x_rdim = xs[0] + xs[1];
+	y_rdim = ys[0] + ys[1];
+	}
+      }
+  else
+    mexErrMsgTxt("TYPE arg must be 'lpyr', 'spyr' or 'wpyr'.");
+
+  plhs[0] = (mxArray *) mxCreateDoubleMatrix(x_rdim,y_rdim,mxREAL);
+  if (plhs[0] == NULL) mexErrMsgTxt("Cannot allocate result matrix");
+  result = mxGetPr(plhs[0]);
+
+  if (type[0] == 'l')
+    status = recon_lpyr(pyr, nrows, xs, ys, &filt[0], edges, result);
+  else if (type[0] == 's')
+    status = recon_spyr(pyr, nrows, xs, ys, &filt[0], &filt[1], &filt[2],
+			bfilts, nbands, edges, result);
+  else
+    status = recon_wpyr(pyr, nrows, xs, ys, &filt[0], &filt[1],
+			edges, result);
+
+  mxFree((char *) xs);
+  if (bfilts != NULL) mxFree((char *) bfilts);
+  if (status != 0)
+    mexErrMsgTxt("Cannot reconstruct pyramid: INDICES and FILTS are incompatible, or out of memory.");
+
+  return;
+  }
@@ -72,6 +72,11 @@ end
 
 %------------------------------------------------------------
 
+if (exist('buildPyr') == 3)	% MEX version: all levels in one call
+  [pyr,pind] = buildPyr('lpyr', im, ht, {filt1, filt2}, edges);
+  return;
+end
+
 if (ht <= 1)
 
   pyr = im(:);
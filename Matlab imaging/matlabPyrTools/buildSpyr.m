@@ -52,6 +52,11 @@ end
 
 %-----------------------------------------------------------------
 
+if (exist('buildPyr') == 3)	% MEX version: all levels in one call
+  [pyr,pind] = buildPyr('spyr', im, ht, {lo0filt, hi0filt, lofilt, bfilts}, edges);
+  return;
+end
+
 hi0 = corrDn(im, hi0filt, edges);
 lo0 = corrDn(im, lo0filt, edges);
 
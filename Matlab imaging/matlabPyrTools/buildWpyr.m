@@ -64,6 +64,11 @@ else
   end
 end
 
+if (exist('buildPyr') == 3)	% MEX version: all levels in one call
+  [pyr,pind] = buildPyr('wpyr', im, ht, {filt, hfilt}, edges);
+  return;
+end
+
 if (ht <= 0)
 
   pyr = im(:);
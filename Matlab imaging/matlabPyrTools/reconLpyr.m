@@ -54,6 +54,12 @@ if isstr(filt2)
 end
 
 filt2 = filt2(:);
+
+if ( (exist('reconPyr') == 3) & isequal(levs, [1:maxLev]') )
+  res = reconPyr('lpyr', pyr, ind, {filt2}, edges);	% MEX version
+  return;
+end
+
 res_sz = ind(1,:);
 
 if any(levs > 1)
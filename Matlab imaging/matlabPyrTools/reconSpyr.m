@@ -75,6 +75,11 @@ else
   bands = bands(:);
 end
 
+if ( (exist('reconPyr') == 3) & isequal(levs, [0:maxLev]') & isequal(bands, [1:nbands]') )
+  res = reconPyr('spyr', pyr, pind, {lo0filt, hi0filt, lofilt, bfilts}, edges);	% MEX version
+  return;
+end
+
 if (spyrHt(pind) == 0)
   if (any(levs==1))
     res1 = pyrBand(pyr,pind,2);
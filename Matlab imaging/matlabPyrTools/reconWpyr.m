@@ -82,6 +82,11 @@ else
 	stag = 1;
 end
 
+if ( (exist('reconPyr') == 3) & isequal(levs, [1:maxLev]') & isequal(bands, [1:3]') )
+  res = reconPyr('wpyr', pyr, ind, {filt, hfilt}, edges);	% MEX version
+  return;
+end
+
 %% Compute size of result image: assumes critical sampling (boundaries correct)
 res_sz = ind(1,:);
 if (res_sz(1) == 1)
@@ -0,0 +1,36 @@
+#include "mex.h"
+
+#ifndef MATLAB_MEX_FILE
+#define MATLAB_MEX_FILE
+#endif
+
+#include "sparse_matlab_like_matrix.hpp"
+#include "QC_full_sparse_pairwise.hpp"
+
+void mexFunction(int nout, mxArray *out[],
+                 int nin, const mxArray *in[]) {
+
+    if (nin<4||nin>5) mexErrMsgTxt("4 or 5 arguments are required");
+    if (nout>1) mexErrMsgTxt("Too many output arguments");
+    if (!mxIsDouble(in[0]) || mxIsSparse(in[0]) ||
+        (!mxIsEmpty(in[1]) && (!mxIsDouble(in[1]) || mxIsSparse(in[1])))) {
+        mexErrMsgTxt("P and Q should be full double matrices");
+    }
+    size_t N= mxGetM(in[0]);
+    if (!mxIsEmpty(in[1]) && mxGetM(in[1])!=N) mexErrMsgTxt("P and Q should have the same number of rows");
+    if (!mxIsSparse(in[2]) || !mxIsDouble(in[2]) || mxGetM(in[2])!=N || mxGetN(in[2])!=N) {
+        mexErrMsgTxt("A should be a sparse NxN double matrix");
+    }
+    
+    const double* P= static_cast<const double*>( mxGetData(in[0]) );
+    const double* Q= mxIsEmpty(in[1]) ? NULL : static_cast<const double*>( mxGetData(in[1]) );
+    size_t nP= mxGetN(in[0]);
+    size_t nQ= mxIsEmpty(in[1]) ? nP : mxGetN(in[1]);
+    sparse_matlab_like_matrix A(in[2]);
+    const double m= mxGetScalar(in[3]);
+    int num_threads= (nin>=5) ? static_cast<int>(mxGetScalar(in[4])) : -1;
+    
+    out[0]= mxCreateDoubleMatrix(nP, nQ, mxREAL);
+    QC_full_sparse_pairwise()(P, nP, Q, nQ, A, m, N, mxGetPr(out[0]), num_threads);
+
+}
@@ -0,0 +1,158 @@
+#ifndef QC_FULL_SPARSE_PAIRWISE_HPP
+#define QC_FULL_SPARSE_PAIRWISE_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include "sparse_matlab_like_matrix.hpp"
+#include "QC_utils.hpp"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+struct QC_full_sparse_pairwise {
+
+    ///--------------------------------------------------------------------------------
+    /// Computes QC_full_sparse between all pairs of histograms. See QC_full_sparse.hpp.
+    ///
+    /// P: nP full histograms of size N, one after the other.
+    /// Q: nQ full histograms of size N, one after the other. If NULL, P is compared
+    ///    to itself and only half of the pairs are computed (QC is symmetric).
+    /// A: The bin-similarity matrix.
+    /// m: the normalization factor.
+    /// dist: Output, the nPxnQ (or nPxnP) distances in column major order, that is the
+    ///       distance between the i-th histogram of P and the j-th of Q is dist[i+j*nP].
+    /// num_threads: Number of threads (when compiled with OpenMP). -1 means all available.
+    ///
+    /// A'*P and A'*Q are computed once for all histograms, so the normalization of a
+    /// pair costs O(N) and only the quadratic form costs O(nnz(A)).
+    ///--------------------------------------------------------------------------------
+    void operator()(const double* P, size_t nP, const double* Q, size_t nQ,
+                    const sparse_matlab_like_matrix& A, double m, size_t N,
+                    double* dist, int num_threads= -1) {
+
+        const bool self= (Q==NULL);
+        if (self) {
+            Q= P;
+            nQ= nP;
+        }
+        
+        // A'*P and A'*Q
+        std::vector<double> AP(nP*N);
+        std::vector<double> AQ(self ? 0 : nQ*N);
+        multiply_transposed(A, P, nP, N, &AP[0], num_threads);
+        if (!self) multiply_transposed(A, Q, nQ, N, &AQ[0], num_threads);
+        const double* AQp= self ? &AP[0] : &AQ[0];
+
+        #ifdef _OPENMP
+        if (num_threads<1) num_threads= omp_get_max_threads();
+        #pragma omp parallel num_threads(num_threads)
+        #endif
+        {
+            std::vector<double> D(N), Y(N); // per thread scratch
+            #ifdef _OPENMP
+            #pragma omp for schedule(dynamic)
+            #endif
+            for (long i=0; i<static_cast<long>(nP); ++i) {
+                size_t jb= 0;
+                if (self) {
+                    dist[i+i*nP]= 0.0;
+                    jb= i+1;
+                }
+                for (size_t j=jb; j<nQ; ++j) {
+                    double d= pair(P+i*N, Q+j*N, &AP[i*N], AQp+j*N, A, m, N, &D[0], &Y[0]);
+                    dist[i+j*nP]= d;
+                    if (self) dist[j+i*nP]= d;
+                }
+            }
+        }
+    } // operator()
+
+private:
+
+    // y[k]= sum_c sr[c]*x[irs[c]], c in column k of A
+    // The x[irs[c]] are gathered one by one; SSE2 only pairs the multiply-adds.
+    static double sparse_dot(const double* sr, const size_t* irs,
+                             const double* x, size_t cb, size_t ce) {
+        size_t c= cb;
+        double s= 0.0;
+        #ifdef __SSE2__
+        __m128d s2= _mm_setzero_pd();
+        for (; c+2<=ce; c+=2) {
+            __m128d x2= _mm_set_pd(x[irs[c+1]], x[irs[c]]);
+            s2= _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(sr+c), x2));
+        }
+        double t[2];
+        _mm_storeu_pd(t, s2);
+        s= t[0]+t[1];
+        #endif
+        for (; c<ce; ++c) s+= sr[c]*x[irs[c]];
+        return s;
+    } // sparse_dot
+
+    static void multiply_transposed(const sparse_matlab_like_matrix& A,
+                                    const double* X, size_t n, size_t N,
+                                    double* AX, int num_threads) {
+        #ifdef _OPENMP
+        if (num_threads<1) num_threads= omp_get_max_threads();
+        #pragma omp parallel for num_threads(num_threads)
+        #endif
+        for (long h=0; h<static_cast<long>(n); ++h) {
+            for (size_t k=0; k<N; ++k) {
+                AX[h*N+k]= sparse_dot(A.sr(), A.irs(), X+h*N, A.jcs()[k], A.jcs()[k+1]);
+            }
+        }
+    } // multiply_transposed
+
+    // QC of one pair, given A'*P and A'*Q. D and Y are scratch of size N.
+    static double pair(const double* P, const double* Q,
+                       const double* AP, const double* AQ,
+                       const sparse_matlab_like_matrix& A, double m, size_t N,
+                       double* D, double* Y) {
+        size_t k= 0;
+        #ifdef __SSE2__
+        // the common m==0.5 (QCS) normalization is a square root
+        if (m==0.5) {
+            const __m128d zero= _mm_setzero_pd();
+            for (; k+2<=N; k+=2) {
+                __m128d z= _mm_add_pd(_mm_loadu_pd(AP+k), _mm_loadu_pd(AQ+k));
+                __m128d d= _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(P+k), _mm_loadu_pd(Q+k)), _mm_sqrt_pd(z));
+                _mm_storeu_pd(D+k, _mm_and_pd(d, _mm_cmpneq_pd(z, zero)));
+            }
+        }
+        #endif
+        for (; k<N; ++k) {
+            double z= AP[k]+AQ[k];
+            D[k]= (z!=0.0) ? (P[k]-Q[k])/(pow(z,m)) : 0.0;
+        }
+
+        // Y= A'*D (skipping the bins where D is zero), then dist= D'*Y
+        for (k=0; k<N; ++k) {
+            Y[k]= (D[k]==0.0) ? 0.0 : sparse_dot(A.sr(), A.irs(), D, A.jcs()[k], A.jcs()[k+1]);
+        }
+        double dist= 0.0;
+        k= 0;
+        #ifdef __SSE2__
+        __m128d s2= _mm_setzero_pd();
+        for (; k+2<=N; k+=2) {
+            s2= _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(D+k), _mm_loadu_pd(Y+k)));
+        }
+        double t[2];
+        _mm_storeu_pd(t, s2);
+        dist= t[0]+t[1];
+        #endif
+        for (; k<N; ++k) dist+= D[k]*Y[k];
+
+        if (dist<0) {
+            return 0.0;
+        } else {
+            return sqrt(dist);
+        }
+    } // pair
+    
+};
+
+#endif
@@ -0,0 +1,19 @@
+% [dist]= QC_full_sparse_pairwise(P, Q, A, m, nThreads)
+% 
+% Computes QC_full_sparse between all pairs of histograms with one call, in
+% parallel (when compiled with OpenMP, see compile_QC). See QC documentation.
+%
+% P - NxnP full matrix, each column is a histogram.
+% Q - NxnQ full matrix, each column is a histogram. If empty ([]), P is
+%     compared with itself and only half of the pairs are computed.
+% A - sparse NxN bin-similarity matrix.
+% m - the normalization factor.
+% nThreads - number of threads. Default value is all available threads.
+%
+% dist - nPxnQ matrix, dist(i,j) is the QC distance between P(:,i) and Q(:,j).
+%
+% Note that the input is not checked as in QC.
+
+
+
+% Implementation in a mex file.
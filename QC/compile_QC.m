@@ -1,4 +1,10 @@
 mex -O -largeArrayDims -DNDEBUG QC_full_sparse.cxx
+% multithreaded with OpenMP
+if (ispc)
+    mex -O -largeArrayDims -DNDEBUG COMPFLAGS="$COMPFLAGS /openmp" QC_full_sparse_pairwise.cxx
+else
+    mex -O -largeArrayDims -DNDEBUG CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" QC_full_sparse_pairwise.cxx
+end
 mex -O -largeArrayDims -DNDEBUG fast_sift_bin_similarity_matrix.cxx
 mex -O -largeArrayDims -DNDEBUG fast_color_spatial_ground_similarity_pruning.cxx
 mex -O -largeArrayDims -DNDEBUG check_if_QC_valid_bin_similarity_matrix.cxx
@@ -33,12 +33,20 @@ dist3= QC(P,Q,fA,m);
 fprintf('Computing QC             (P,Q: full, A: full)   took %f seconds.\n',toc);
 assert(abs(dist3-dist1)<QC_EPSILON);
 
+% Many distances - all pairs of the columns of [P Q] with one call
+tic 
+dist4= QC_full_sparse_pairwise([P(:) Q(:)],[],A,m);
+fprintf('Computing QC_full_sparse_pairwise (all pairs of P and Q) took %f seconds.\n',toc);
+assert(abs(dist4(1,2)-dist1)<QC_EPSILON);
+
 fprintf('\nExplanations:\n');
 fprintf(' 1. Calling QC_full_sparse directly is the fastest method as\n');
 fprintf('    we avoid checks of input and call the mex file directly.\n');
 fprintf(' 2. Calling QC with a full A (bin-simialrity matrix) is \n');
 fprintf('    slowest because T (threshold) is small and it runs \n');
 fprintf('    with time complexity of O(N^2) instead of O(NT).\n');
+fprintf(' 3. For many distances use QC_full_sparse_pairwise instead of\n');
+fprintf('    a loop, it normalizes each histogram once and is parallel.\n');
 
 
 % Copyright (c) 2010, Ofir Pele
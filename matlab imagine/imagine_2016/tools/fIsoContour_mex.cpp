@@ -10,18 +10,14 @@
 // ========================================================================
 
 #include "mex.h"
-#include <queue>
+#include <vector>
 #include <cmath>
+#include "fRegionGrowing.h"
 
 #define NQUEUES             100	// number of FIFO queues
 
 using namespace std;
 
-long             lNZ, lNX, lNY;     // The image dimensions;
-double          dRegMax, dPercentage;
-double          *pdImg;             // pointer to the image
-queue<long>     *aqQueue;			// vector of FIFO queues
-
 // ========================================================================
 // Inline function to determin minimum of two numbers
 inline double ifMin(double a, double b)
@@ -47,21 +43,22 @@ inline double ifMax(double a, double b)
 // *** FUNCTION fPop
 // ***
 // *** Function that pops a voxel location from the highest priority
-// *** non-empty queue which fulfills the region growing criterion.
+// *** non-empty queue which fulfills the region growing criterion. The
+// *** queues before iFirstQueue are empty.
 // ***
 // ========================================================================
-long fPop() {
+long fPop(CRingQueue *aqQueue, int &iFirstQueue, const double *pdImg, double &dRegMax, double dPercentage) {
 	long lInd; // Index of the voxel
     
     // --------------------------------------------------------------------
     // Loop over the queues, start with highest priority (0)
-    for (int iQueueInd = 0; iQueueInd < NQUEUES; iQueueInd++) {
+    for (; iFirstQueue < NQUEUES; iFirstQueue++) {
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // While there are still entries in the queue, pop and determine
         // whether it fullfills the region growing criterion.
-        while (!aqQueue[iQueueInd].empty()) {
-            lInd = aqQueue[iQueueInd].front();aqQueue[iQueueInd].pop();
+        while (!aqQueue[iFirstQueue].empty()) {
+            lInd = aqQueue[iFirstQueue].pop();
             dRegMax = ifMax(pdImg[lInd], dRegMax);
             if (pdImg[lInd] >= dRegMax*dPercentage) return lInd;// Return if valid entry found
         }
@@ -77,39 +74,6 @@ long fPop() {
 
 
 
-// ========================================================================
-// ***
-// *** FUNCTION fGetNHood
-// ***
-// *** Get the 6-neighbourhood of voxel lLinInd
-// ***
-// ========================================================================
-void fGetNHood(const long lLinInd, long& lNHoodSize, long* lNHood) {
-	long lX, lY, lZ, lTemp;
-    
-    lNHoodSize = 0;
-    
-    lY = lLinInd % lNY; // get y coordinate, add +/-1 if in image range
-	if (lY >       0) lNHood[lNHoodSize++] = lLinInd - 1;
-	if (lY < lNY - 1) lNHood[lNHoodSize++] = lLinInd + 1;
-    
-	lTemp = lLinInd/lNY; // That is a floor() operation in c
-	lX = lTemp % lNX; // get x coordinate, add +/-1 if in image range. X increment is lNY
-	if (lX >       0) lNHood[lNHoodSize++] = lLinInd - lNY;
-	if (lX < lNX - 1) lNHood[lNHoodSize++] = lLinInd + lNY;
-    
-    if (lNZ > 1) { // 3D case
-        lZ = lTemp/lNX; // z coordinate, add +/-1 if in image range. Z increment is lNX*lNY
-        if (lZ >       0) lNHood[lNHoodSize++] = lLinInd - lNX*lNY;
-        if (lZ < lNZ - 1) lNHood[lNHoodSize++] = lLinInd + lNX*lNY;
-    }
-}
-// ========================================================================
-// *** END OF FUNCTION fGetNHood
-// ========================================================================
-
-
-
 // ========================================================================
 // ***
 // *** FUNCTION fGetMinMax
@@ -117,7 +81,7 @@ void fGetNHood(const long lLinInd, long& lNHoodSize, long* lNHood) {
 // *** Get the minimum and maximum value of an array
 // ***
 // ========================================================================
-void fGetMinMax(double *pdArray, long lLength, double &dMin, double &dMax)
+void fGetMinMax(const double *pdArray, long lLength, double &dMin, double &dMax)
 {
     dMax   = 0.0;
     dMin   = double(1e15);
@@ -154,9 +118,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
     // 1st input: Image (get dimensions as well)
     if (!mxIsDouble(prhs[0])) mexErrMsgTxt("First input argument must be of type double.");
     mxArray* pArray = mxDuplicateArray(prhs[0]);
-    pdImg = (double*) mxGetData(pArray);
-    const int* pSize = mxGetDimensions(prhs[0]);
+    double *pdImg = (double*) mxGetData(pArray);
+    const mwSize* pSize = mxGetDimensions(prhs[0]);
     long lNDims = mxGetNumberOfDimensions(prhs[0]);
+    long lNZ, lNX, lNY; // The image dimensions
     lNY = long(pSize[0]);
 	lNX = long(pSize[1]);
     if (lNDims == 3) {
@@ -177,7 +142,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
     // 3rd input: The isocontour percentage
-    dPercentage = 0.5; // 50 % is the default
+    double dPercentage = 0.5; // 50 % is the default
     if (nrhs > 2) dPercentage = double(*mxGetPr(prhs[2]));
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -197,44 +162,52 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
     // Get pointer to output arguments and allocate memory for the corresponding objects
     plhs[0] = mxCreateNumericArray(lNDims, pSize, mxLOGICAL_CLASS, mxREAL);	// create output array
     bool *pbMask = (bool*) mxGetData(plhs[0]);						// get data pointer to mask
-    bool *pbCandidate = (bool*) mxGetData(mxCreateNumericArray(lNDims, pSize, mxLOGICAL_CLASS, mxREAL));	// create output array
     
     // --------------------------------------------------------------------
     // Start of the real functionality
     
-    aqQueue = new queue<long>[NQUEUES];
+    // Neighbourhood bits of the voxels, and their candidate flag
+    vector<unsigned char> aiNHood(lImSize);
+    unsigned char *piNHood = &aiNHood[0];
+    long    alOffset[6];
+    int     iNOffsets = fInitNHood(lNY, lNX, lNZ, alOffset, piNHood);
+    vector<CRingQueue> aqQueue(NQUEUES);
+    int     iFirstQueue = NQUEUES;
     
-    long    lNHoodSize;
-    long    alNHood[6];
     long    lRegSize = 1;
     long    lQueueInd;
     
-    dRegMax = pdImg[lLinInd];
+    double  dRegMax = pdImg[lLinInd];
     pbMask[lLinInd] = true;
-    pbCandidate[lLinInd] = true;
+    piNHood[lLinInd] |= CANDIDATE;
     
     // --------------------------------------------------------------------
     while (lRegSize < lImSize) {
 
-        fGetNHood(lLinInd, lNHoodSize, alNHood);
-        for (int iI = 0; iI < lNHoodSize; iI++) {
-            lLinInd = alNHood[iI];
-            if (pbCandidate[lLinInd]) continue;
+        unsigned char iBits = piNHood[lLinInd];
+        long lCenter = lLinInd;
+        for (int iI = 0; iI < iNOffsets; iI++) {
+            if (!(iBits & (1 << iI))) continue;
+            lLinInd = lCenter + alOffset[iI];
+            if (piNHood[lLinInd] & CANDIDATE) continue;
             
-            pbCandidate[lLinInd] = true;
+            piNHood[lLinInd] |= CANDIDATE;
             lQueueInd = long((1.0 - pdImg[lLinInd])*(NQUEUES - 1));
             if (lQueueInd > NQUEUES - 1) lQueueInd = NQUEUES - 1;
             aqQueue[lQueueInd].push(lLinInd);
+            if (lQueueInd < iFirstQueue) iFirstQueue = int(lQueueInd);
         }
         
-        lLinInd = fPop();
-        if (lLinInd < 0) return; // Return if no suiting candidates
+        lLinInd = fPop(&aqQueue[0], iFirstQueue, pdImg, dRegMax, dPercentage);
+        if (lLinInd < 0) break; // Stop if no suiting candidates
         
         pbMask[lLinInd] = true;
         lRegSize++;
     }
     // End of while loop
     // --------------------------------------------------------------------
+    
+    mxDestroyArray(pArray);
 }
 // ========================================================================
 // *** END OF MAIN MEX FUNCTION RegionGrowing_mex
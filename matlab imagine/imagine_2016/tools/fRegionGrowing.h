@@ -0,0 +1,108 @@
+// ========================================================================
+// ***
+// *** fRegionGrowing.h
+// ***
+// *** Shared helpers of the region growing mex files in this folder: a
+// *** flat ring buffer FIFO queue and the precomputed neighbourhood of
+// *** the voxels, which replace std::queue and the per voxel division and
+// *** modulo of fGetNHood.
+// ***
+// ========================================================================
+
+#ifndef FREGIONGROWING_H
+#define FREGIONGROWING_H
+
+#include <vector>
+
+#define CANDIDATE          0x40	// flag of a voxel which has been queued
+
+
+
+// ========================================================================
+// ***
+// *** CLASS CRingQueue
+// ***
+// *** FIFO queue of voxel indices in one flat ring buffer, which grows
+// *** by doubling.
+// ***
+// ========================================================================
+class CRingQueue {
+public:
+    CRingQueue() : lHead(0), lCount(0) {}
+
+    bool empty() const { return lCount == 0; }
+
+    void push(long lInd) {
+        long lCapacity = long(alBuffer.size());
+        if (lCount == lCapacity) {
+            // Unroll the ring into a buffer of twice the size
+            std::vector<long> alNew(lCapacity > 0 ? 2*lCapacity : 1024);
+            for (long lI = 0; lI < lCount; lI++)
+                alNew[lI] = alBuffer[(lHead + lI) % lCapacity];
+            alBuffer.swap(alNew);
+            lHead = 0;
+            lCapacity = long(alBuffer.size());
+        }
+        long lTail = lHead + lCount;
+        if (lTail >= lCapacity) lTail -= lCapacity;
+        alBuffer[lTail] = lInd;
+        lCount++;
+    }
+
+    long pop() {
+        long lInd = alBuffer[lHead];
+        if (++lHead == long(alBuffer.size())) lHead = 0;
+        lCount--;
+        return lInd;
+    }
+
+private:
+    std::vector<long> alBuffer;
+    long              lHead, lCount;
+};
+// ========================================================================
+// *** END OF CLASS CRingQueue
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTION fInitNHood
+// ***
+// *** The 4-/6-neighbour offsets, and for every voxel a byte with a bit
+// *** for each neighbour inside the image range (bit iI for offset iI).
+// *** Returns the number of offsets.
+// ***
+// ========================================================================
+inline int fInitNHood(long lNY, long lNX, long lNZ, long *alOffset, unsigned char *piNHood)
+{
+    alOffset[0] = -1;       alOffset[1] = 1;
+    alOffset[2] = -lNY;     alOffset[3] = lNY;
+    alOffset[4] = -lNX*lNY; alOffset[5] = lNX*lNY;
+
+    for (long lZ = 0; lZ < lNZ; lZ++) {
+        unsigned char iZBits = 0;
+        if (lNZ > 1) {
+            if (lZ >       0) iZBits |= 0x10;
+            if (lZ < lNZ - 1) iZBits |= 0x20;
+        }
+        for (long lX = 0; lX < lNX; lX++) {
+            unsigned char iXBits = iZBits;
+            if (lX >       0) iXBits |= 0x04;
+            if (lX < lNX - 1) iXBits |= 0x08;
+            for (long lY = 0; lY < lNY; lY++) {
+                unsigned char iBits = iXBits;
+                if (lY >       0) iBits |= 0x01;
+                if (lY < lNY - 1) iBits |= 0x02;
+                *piNHood++ = iBits;
+            }
+        }
+    }
+    return (lNZ > 1) ? 6 : 4;
+}
+// ========================================================================
+// *** END OF FUNCTION fInitNHood
+// ========================================================================
+
+#endif
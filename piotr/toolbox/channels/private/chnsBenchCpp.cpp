@@ -0,0 +1,63 @@
+/*******************************************************************************
+* Piotr's Computer Vision Matlab Toolbox      Version 3.30
+* Copyright 2014 Piotr Dollar.  [pdollar-at-gmail.com]
+* Licensed under the Simplified BSD License [see external/bsd.txt]
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "rgbConvertMex.cpp"
+#include "convConst.cpp"
+#include "imResampleMex.cpp"
+#include "gradientMex.cpp"
+#include "../../videos/private/opticalFlowHsMex.cpp"
+
+// Standalone micro-benchmarks for every kernel built on sse.hpp. Compile once
+// per instruction set and compare the timings, for example:
+//  g++ -O3 -msse2 chnsBenchCpp.cpp -o bench_sse2
+//  g++ -O3 -mavx2 chnsBenchCpp.cpp -o bench_avx2
+//  g++ -O3 -mavx512f chnsBenchCpp.cpp -o bench_avx512
+//  g++ -O3 -DSIMD_LEVEL=0 chnsBenchCpp.cpp -o bench_scalar
+// Usage: bench [h w nReps] (defaults to a 480x640x3 image and 20 repetitions).
+
+// time nReps calls of X and print the average in ms
+#define BENCH(name,X) { clock_t t0=clock(); for(r=0; r<nReps; r++) { X; } \
+  printf("%-14s %9.3f ms\n",name,1e3*(clock()-t0)/CLOCKS_PER_SEC/nReps); }
+
+int main(int argc, const char* argv[])
+{
+  // parse arguments and report the instruction set in use
+  int h=480, w=640, nReps=20, d=3, r;
+  if( argc>2 ) { h=atoi(argv[1]); w=atoi(argv[2]); }
+  if( argc>3 ) nReps=atoi(argv[3]);
+  printf("%s (%d floats per vector), %dx%dx%d, %d reps\n",
+    SIMD_NAME, SIMD_W, h, w, d, nReps);
+  if( !simdSupported() ) { printf("CPU lacks %s.\n",SIMD_NAME); return 1; }
+
+  // initialize random input and output arrays (aligned like Matlab arrays)
+  const int n=h*w, sf=sizeof(float); float *I, *J, *O, *M, *Or, *H, *Vx, *Vy;
+  I = (float*) alMalloc(n*d*sf,SIMD_ALIGN); O = (float*) alMalloc(n*d*sf,16);
+  M = (float*) alMalloc(n*sf,16); Or = (float*) alMalloc(n*sf,16);
+  H = (float*) wrCalloc(n*d,sf); Vx=(float*) wrCalloc(n,sf);
+  Vy = (float*) wrCalloc(n,sf); srand(0);
+  for( int i=0; i<n*d; i++ ) I[i]=rand()/(float)RAND_MAX;
+
+  // time each kernel in turn
+  BENCH("rgb2luv",J=rgbConvert(I,n,d,2,1.0f); wrFree(J));
+  BENCH("convBox",convBox(I,O,h,w,d,4,1));
+  BENCH("convTri",convTri(I,O,h,w,d,4,1));
+  BENCH("convTri1",convTri1(I,O,h,w,d,2.0f,1));
+  BENCH("convTri1/2",convTri1(I,O,h,w,d,2.0f,2));
+  BENCH("conv11/2",conv11(I,O,h,w,d,1,2));
+  BENCH("resample/2",resample(I,O,h,h/2,w,w/2,d,1.0f));
+  BENCH("resample.7",resample(I,O,h,h*7/10,w,w*7/10,d,1.0f));
+  BENCH("grad2",grad2(I,O,H,h,w,d));
+  BENCH("gradMag",gradMag(I,M,Or,h,w,d,true));
+  BENCH("gradMagNorm",gradMagNorm(M,O,h,w,.005f));
+  BENCH("gradHist",memset(H,0,n*sf); gradHist(M,Or,H,h,w,4,6,0,false));
+  BENCH("opticalFlowHs",opticalFlowHsMex(Vx,Vy,I,I+n,I+2*n,O,h,w,10));
+
+  // free memory and return
+  alFree(I); alFree(O); alFree(M); alFree(Or);
+  wrFree(H); wrFree(Vx); wrFree(Vy); return 0;
+}
@@ -5,6 +5,7 @@
 *******************************************************************************/
 #include "wrappers.hpp"
 #include <string.h>
+#define SIMD_SOURCE "convConst.cpp" // compiled once per instruction set
 #include "sse.hpp"
 
 // convolve one column of I by a 2rx1 ones filter
@@ -26,13 +27,14 @@ void convBoxY( float *I, float *O, int h, int r, int s ) {
 // convolve I by a 2r+1 x 2r+1 ones filter (uses SSE)
 void convBox( float *I, float *O, int h, int w, int d, int r, int s ) {
   float nrm = 1.0f/((2*r+1)*(2*r+1)); int i, j, k=(s-1)/2, h0, h1, w0;
-  if(h%4==0) h0=h1=h; else { h0=h-(h%4); h1=h0+4; } w0=(w/s)*s;
-  float *T=(float*) alMalloc(h1*sizeof(float),16);
+  h0=h-(h%SIMD_W); h1=(h0==h) ? h : h0+SIMD_W; w0=(w/s)*s;
+  float *T=(float*) alMalloc(h1*sizeof(float),SIMD_ALIGN);
   while(d-- > 0) {
     // initialize T
     memset( T, 0, h1*sizeof(float) );
-    for(i=0; i<=r; i++) for(j=0; j<h0; j+=4) INC(T[j],LDu(I[j+i*h]));
-    for(j=0; j<h0; j+=4) STR(T[j],MUL(nrm,SUB(MUL(2,LD(T[j])),LDu(I[j+r*h]))));
+    for(i=0; i<=r; i++) for(j=0; j<h0; j+=SIMD_W) INC(T[j],LDu(I[j+i*h]));
+    for(j=0; j<h0; j+=SIMD_W)
+      STR(T[j],MUL(nrm,SUB(MUL(2,LD(T[j])),LDu(I[j+r*h]))));
     for(i=0; i<=r; i++) for(j=h0; j<h; j++ ) T[j]+=I[j+i*h];
     for(j=h0; j<h; j++ ) T[j]=nrm*(2*T[j]-I[j+r*h]);
     // prepare and convolve each column in turn
@@ -40,7 +42,7 @@ void convBox( float *I, float *O, int h, int w, int d, int r, int s ) {
     for( i=1; i<w0; i++ ) {
       float *Il=I+(i-1-r)*h; if(i<=r) Il=I+(r-i)*h;
       float *Ir=I+(i+r)*h; if(i>=w-r) Ir=I+(2*w-r-i-1)*h;
-      for(j=0; j<h0; j+=4) DEC(T[j],MUL(nrm,SUB(LDu(Il[j]),LDu(Ir[j]))));
+      for(j=0; j<h0; j+=SIMD_W) DEC(T[j],MUL(nrm,SUB(LDu(Il[j]),LDu(Ir[j]))));
       for(j=h0; j<h; j++ ) T[j]-=nrm*(Il[j]-Ir[j]);
       k++; if(k==s) { k=0; convBoxY(T,O,h,r,s); O+=h/s; }
     }
@@ -52,17 +54,20 @@ void convBox( float *I, float *O, int h, int w, int d, int r, int s ) {
 // convolve one column of I by a [1; 1] filter (uses SSE)
 void conv11Y( float *I, float *O, int h, int side, int s ) {
   #define C4(m,o) ADD(LDu(I[m*j-1+o]),LDu(I[m*j+o]))
-  int j=0, k=((~((size_t) O) + 1) & 15)/4;
+  int j=0, k=simdOffset(O);
   const int d = (side % 4 >= 2) ? 1 : 0, h2=(h-d)/2;
   if( s==2 ) {
+    if(k>h2) k=h2;
     for( ; j<k; j++ ) O[j]=I[2*j+d]+I[2*j+d+1];
-    for( ; j<h2-4; j+=4 ) STR(O[j],_mm_shuffle_ps(C4(2,d+1),C4(2,d+5),136));
+    for( ; j<h2-SIMD_W; j+=SIMD_W )
+      STR(O[j],EVEN(C4(2,d+1),C4(2,d+1+SIMD_W)));
     for( ; j<h2; j++ ) O[j]=I[2*j+d]+I[2*j+d+1];
     if(d==1 && h%2==0) O[j]=2*I[2*j+d];
   } else {
-    if(d==0) { O[0]=2*I[0]; j++; if(k==0) k=4; }
+    if(d==0) { O[0]=2*I[0]; j++; if(k==0) k=SIMD_W; }
+    if(k>h-d) k=h-d;
     for( ; j<k; j++ ) O[j]=I[j-1+d]+I[j+d];
-    for( ; j<h-4-d; j+=4 ) STR(O[j],C4(1,d) );
+    for( ; j<h-SIMD_W-d; j+=SIMD_W ) STR(O[j],C4(1,d) );
     for( ; j<h-d; j++ ) O[j]=I[j-1+d]+I[j+d];
     if(d==1) { O[j]=2*I[j]; j++; }
   }
@@ -72,10 +77,11 @@ void conv11Y( float *I, float *O, int h, int side, int s ) {
 // convolve I by a [1 1; 1 1] filter (uses SSE)
 void conv11( float *I, float *O, int h, int w, int d, int side, int s ) {
   const float nrm = 0.25f; int i, j;
-  float *I0, *I1, *T = (float*) alMalloc(h*sizeof(float),16);
+  float *I0, *I1, *T = (float*) alMalloc(h*sizeof(float),SIMD_ALIGN);
   for( int d0=0; d0<d; d0++ ) for( i=s/2; i<w; i+=s ) {
     I0=I1=I+i*h+d0*h*w; if(side%2) { if(i<w-1) I1+=h; } else { if(i) I0-=h; }
-    for( j=0; j<h-4; j+=4 ) STR( T[j], MUL(nrm,ADD(LDu(I0[j]),LDu(I1[j]))) );
+    for( j=0; j<h-SIMD_W; j+=SIMD_W )
+      STR( T[j], MUL(nrm,ADD(LDu(I0[j]),LDu(I1[j]))) );
     for( ; j<h; j++ ) T[j]=nrm*(I0[j]+I1[j]);
     conv11Y(T,O,h,side,s); O+=h/s;
   }
@@ -103,14 +109,16 @@ void convTriY( float *I, float *O, int h, int r, int s ) {
 // convolve I by a 2rx1 triangle filter (uses SSE)
 void convTri( float *I, float *O, int h, int w, int d, int r, int s ) {
   r++; float nrm = 1.0f/(r*r*r*r); int i, j, k=(s-1)/2, h0, h1, w0;
-  if(h%4==0) h0=h1=h; else { h0=h-(h%4); h1=h0+4; } w0=(w/s)*s;
-  float *T=(float*) alMalloc(2*h1*sizeof(float),16), *U=T+h1;
+  h0=h-(h%SIMD_W); h1=(h0==h) ? h : h0+SIMD_W; w0=(w/s)*s;
+  float *T=(float*) alMalloc(2*h1*sizeof(float),SIMD_ALIGN), *U=T+h1;
   while(d-- > 0) {
     // initialize T and U
-    for(j=0; j<h0; j+=4) STR(U[j], STR(T[j], LDu(I[j])));
-    for(i=1; i<r; i++) for(j=0; j<h0; j+=4) INC(U[j],INC(T[j],LDu(I[j+i*h])));
-    for(j=0; j<h0; j+=4) STR(U[j],MUL(nrm,(SUB(MUL(2,LD(U[j])),LD(T[j])))));
-    for(j=0; j<h0; j+=4) STR(T[j],0);
+    for(j=0; j<h0; j+=SIMD_W) STR(U[j], STR(T[j], LDu(I[j])));
+    for(i=1; i<r; i++) for(j=0; j<h0; j+=SIMD_W)
+      INC(U[j],INC(T[j],LDu(I[j+i*h])));
+    for(j=0; j<h0; j+=SIMD_W)
+      STR(U[j],MUL(nrm,(SUB(MUL(2,LD(U[j])),LD(T[j])))));
+    for(j=0; j<h0; j+=SIMD_W) STR(T[j],0);
     for(j=h0; j<h; j++ ) U[j]=T[j]=I[j];
     for(i=1; i<r; i++) for(j=h0; j<h; j++ ) U[j]+=T[j]+=I[j+i*h];
     for(j=h0; j<h; j++ ) { U[j] = nrm * (2*U[j]-T[j]); T[j]=0; }
@@ -119,7 +127,7 @@ void convTri( float *I, float *O, int h, int w, int d, int r, int s ) {
     for( i=1; i<w0; i++ ) {
       float *Il=I+(i-1-r)*h; if(i<=r) Il=I+(r-i)*h; float *Im=I+(i-1)*h;
       float *Ir=I+(i-1+r)*h; if(i>w-r) Ir=I+(2*w-r-i)*h;
-      for( j=0; j<h0; j+=4 ) {
+      for( j=0; j<h0; j+=SIMD_W ) {
         INC(T[j],ADD(LDu(Il[j]),LDu(Ir[j]),MUL(-2,LDu(Im[j]))));
         INC(U[j],MUL(nrm,LD(T[j])));
       }
@@ -134,16 +142,18 @@ void convTri( float *I, float *O, int h, int w, int d, int r, int s ) {
 // convolve one column of I by a [1 p 1] filter (uses SSE)
 void convTri1Y( float *I, float *O, int h, float p, int s ) {
   #define C4(m,o) ADD(ADD(LDu(I[m*j-1+o]),MUL(p,LDu(I[m*j+o]))),LDu(I[m*j+1+o]))
-  int j=0, k=((~((size_t) O) + 1) & 15)/4, h2=(h-1)/2;
+  int j=0, k=simdOffset(O), h2=(h-1)/2;
   if( s==2 ) {
+    if(k>h2) k=h2;
     for( ; j<k; j++ ) O[j]=I[2*j]+p*I[2*j+1]+I[2*j+2];
-    for( ; j<h2-4; j+=4 ) STR(O[j],_mm_shuffle_ps(C4(2,1),C4(2,5),136));
+    for( ; j<h2-SIMD_W; j+=SIMD_W )
+      STR(O[j],EVEN(C4(2,1),C4(2,1+SIMD_W)));
     for( ; j<h2; j++ ) O[j]=I[2*j]+p*I[2*j+1]+I[2*j+2];
     if( h%2==0 ) O[j]=I[2*j]+(1+p)*I[2*j+1];
   } else {
-    O[j]=(1+p)*I[j]+I[j+1]; j++; if(k==0) k=(h<=4) ? h-1 : 4;
+    O[j]=(1+p)*I[j]+I[j+1]; j++; if(k==0) k=SIMD_W; if(k>h-1) k=h-1;
     for( ; j<k; j++ ) O[j]=I[j-1]+p*I[j]+I[j+1];
-    for( ; j<h-4; j+=4 ) STR(O[j],C4(1,0));
+    for( ; j<h-SIMD_W; j+=SIMD_W ) STR(O[j],C4(1,0));
     for( ; j<h-1; j++ ) O[j]=I[j-1]+p*I[j]+I[j+1];
     O[j]=I[j-1]+(1+p)*I[j];
   }
@@ -152,11 +162,11 @@ void convTri1Y( float *I, float *O, int h, float p, int s ) {
 
 // convolve I by a [1 p 1] filter (uses SSE)
 void convTri1( float *I, float *O, int h, int w, int d, float p, int s ) {
-  const float nrm = 1.0f/((p+2)*(p+2)); int i, j, h0=h-(h%4);
-  float *Il, *Im, *Ir, *T=(float*) alMalloc(h*sizeof(float),16);
+  const float nrm = 1.0f/((p+2)*(p+2)); int i, j, h0=h-(h%SIMD_W);
+  float *Il, *Im, *Ir, *T=(float*) alMalloc(h*sizeof(float),SIMD_ALIGN);
   for( int d0=0; d0<d; d0++ ) for( i=s/2; i<w; i+=s ) {
     Il=Im=Ir=I+i*h+d0*h*w; if(i>0) Il-=h; if(i<w-1) Ir+=h;
-    for( j=0; j<h0; j+=4 )
+    for( j=0; j<h0; j+=SIMD_W )
       STR(T[j],MUL(nrm,ADD(ADD(LDu(Il[j]),MUL(p,LDu(Im[j]))),LDu(Ir[j]))));
     for( j=h0; j<h; j++ ) T[j]=nrm*(Il[j]+p*Im[j]+Ir[j]);
     convTri1Y(T,O,h,p,s); O+=h/s;
@@ -186,7 +196,7 @@ void convMaxY( float *I, float *O, float *T, int h, int r ) {
 // convolve I by a 2rx1 max filter
 void convMax( float *I, float *O, int h, int w, int d, int r ) {
   if( r>w-1 ) r=w-1; if( r>h-1 ) r=h-1; int m=2*r+1;
-  float *T=(float*) alMalloc(m*2*sizeof(float),16);
+  float *T=(float*) alMalloc(m*2*sizeof(float),SIMD_ALIGN);
   for( int d0=0; d0<d; d0++ ) for( int x=0; x<w; x++ ) {
     float *Oc=O+d0*h*w+h*x, *Ic=I+d0*h*w+h*x;
     convMaxY(Ic,Oc,T,h,r);
@@ -196,7 +206,7 @@ void convMax( float *I, float *O, int h, int w, int d, int r ) {
 
 // B=convConst(type,A,r,s); fast 2D convolutions (see convTri.m and convBox.m)
 #ifdef MATLAB_MEX_FILE
-void mexFunction( int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[] ) {
+void mexSimd( int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[] ) {
   int *ns, ms[3], nDims, d, m, r, s; float *A, *B, p;
   mxClassID id; char type[1024];
 
@@ -247,4 +257,5 @@ void mexFunction( int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[] ) {
     mexErrMsgTxt("Invalid type.");
   }
 }
+SIMD_MEX(mexSimd)
 #endif
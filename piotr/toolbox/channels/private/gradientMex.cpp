@@ -6,30 +6,29 @@
 #include "wrappers.hpp"
 #include <math.h>
 #include "string.h"
+#define SIMD_SOURCE "gradientMex.cpp" // compiled once per instruction set
 #include "sse.hpp"
 
 #define PI 3.14159265f
 
 // compute x and y gradients for just one column (uses sse)
 void grad1( float *I, float *Gx, float *Gy, int h, int w, int x ) {
-  int y, y1; float *Ip, *In, r; __m128 *_Ip, *_In, *_G, _r;
-  // compute column of Gx
-  Ip=I-h; In=I+h; r=.5f;
+  int y, y1; float *Ip, *In, r; vecf *_G, _r;
+  // compute column of Gx (only the output needs to be aligned)
+  Ip=I-h; In=I+h; r=.5f; y=0;
   if(x==0) { r=1; Ip+=h; } else if(x==w-1) { r=1; In-=h; }
-  if( h<4 || h%4>0 || (size_t(I)&15) || (size_t(Gx)&15) ) {
-    for( y=0; y<h; y++ ) *Gx++=(*In++-*Ip++)*r;
-  } else {
-    _G=(__m128*) Gx; _Ip=(__m128*) Ip; _In=(__m128*) In; _r = SET(r);
-    for(y=0; y<h; y+=4) *_G++=MUL(SUB(*_In++,*_Ip++),_r);
+  if( !(size_t(Gx)&(SIMD_ALIGN-1)) ) { _r = SET(r);
+    for(; y<=h-SIMD_W; y+=SIMD_W) STR(Gx[y],MUL(SUB(LDu(In[y]),LDu(Ip[y])),_r));
   }
+  for( ; y<h; y++ ) Gx[y]=(In[y]-Ip[y])*r;
   // compute column of Gy
   #define GRADY(r) *Gy++=(*In++-*Ip++)*r;
   Ip=I; In=Ip+1;
   // GRADY(1); Ip--; for(y=1; y<h-1; y++) GRADY(.5f); In--; GRADY(1);
-  y1=((~((size_t) Gy) + 1) & 15)/4; if(y1==0) y1=4; if(y1>h-1) y1=h-1;
+  y1=simdOffset(Gy); if(y1==0) y1=SIMD_W; if(y1>h-1) y1=h-1;
   GRADY(1); Ip--; for(y=1; y<y1; y++) GRADY(.5f);
-  _r = SET(.5f); _G=(__m128*) Gy;
-  for(; y+4<h-1; y+=4, Ip+=4, In+=4, Gy+=4)
+  _r = SET(.5f); _G=(vecf*) Gy;
+  for(; y+SIMD_W<h-1; y+=SIMD_W, Ip+=SIMD_W, In+=SIMD_W, Gy+=SIMD_W)
     *_G++=MUL(SUB(LDu(*In),LDu(*Ip)),_r);
   for(; y<h-1; y++) GRADY(.5f); In--; GRADY(1);
   #undef GRADY
@@ -56,20 +55,21 @@ float* acosTable() {
 
 // compute gradient magnitude and orientation at each location (uses sse)
 void gradMag( float *I, float *M, float *O, int h, int w, int d, bool full ) {
-  int x, y, y1, c, h4, s; float *Gx, *Gy, *M2; __m128 *_Gx, *_Gy, *_M2, _m;
+  int x, y, y1, c, h4, hv, s; float *Gx, *Gy, *M2; vecf *_Gx, *_Gy, *_M2, _m;
   float *acost = acosTable(), acMult=10000.0f;
-  // allocate memory for storing one column of output (padded so h4%4==0)
-  h4=(h%4==0) ? h : h-(h%4)+4; s=d*h4*sizeof(float);
-  M2=(float*) alMalloc(s,16); _M2=(__m128*) M2;
-  Gx=(float*) alMalloc(s,16); _Gx=(__m128*) Gx;
-  Gy=(float*) alMalloc(s,16); _Gy=(__m128*) Gy;
+  // allocate memory for storing one column of output (padded so h4%SIMD_W==0)
+  h4=(h%SIMD_W==0) ? h : h-(h%SIMD_W)+SIMD_W; hv=h4/SIMD_W;
+  s=d*h4*sizeof(float);
+  M2=(float*) alMalloc(s,SIMD_ALIGN); _M2=(vecf*) M2;
+  Gx=(float*) alMalloc(s,SIMD_ALIGN); _Gx=(vecf*) Gx;
+  Gy=(float*) alMalloc(s,SIMD_ALIGN); _Gy=(vecf*) Gy;
   // compute gradient magnitude and orientation for each column
   for( x=0; x<w; x++ ) {
     // compute gradients (Gx, Gy) with maximum squared magnitude (M2)
     for(c=0; c<d; c++) {
       grad1( I+x*h+c*w*h, Gx+c*h4, Gy+c*h4, h, w, x );
-      for( y=0; y<h4/4; y++ ) {
-        y1=h4/4*c+y;
+      for( y=0; y<hv; y++ ) {
+        y1=hv*c+y;
         _M2[y1]=ADD(MUL(_Gx[y1],_Gx[y1]),MUL(_Gy[y1],_Gy[y1]));
         if( c==0 ) continue; _m = CMPGT( _M2[y1], _M2[y] );
         _M2[y] = OR( AND(_m,_M2[y1]), ANDNOT(_m,_M2[y]) );
@@ -78,7 +78,7 @@ void gradMag( float *I, float *M, float *O, int h, int w, int d, bool full ) {
       }
     }
     // compute gradient mangitude (M) and normalize Gx
-    for( y=0; y<h4/4; y++ ) {
+    for( y=0; y<hv; y++ ) {
       _m = MIN( RCPSQRT(_M2[y]), SET(1e10f) );
       _M2[y] = RCP(_m);
       if(O) _Gx[y] = MUL( MUL(_Gx[y],_m), SET(acMult) );
@@ -88,9 +88,9 @@ void gradMag( float *I, float *M, float *O, int h, int w, int d, bool full ) {
     // compute and store gradient orientation (O) via table lookup
     if( O!=0 ) for( y=0; y<h; y++ ) O[x*h+y] = acost[(int)Gx[y]];
     if( O!=0 && full ) {
-      y1=((~size_t(O+x*h)+1)&15)/4; y=0;
+      y1=simdOffset(O+x*h); if(y1>h) y1=h; y=0;
       for( ; y<y1; y++ ) O[y+x*h]+=(Gy[y]<0)*PI;
-      for( ; y<h-4; y+=4 ) STRu( O[y+x*h],
+      for( ; y<h-SIMD_W; y+=SIMD_W ) STRu( O[y+x*h],
         ADD( LDu(O[y+x*h]), AND(CMPLT(LDu(Gy[y]),SET(0.f)),SET(PI)) ) );
       for( ; y<h; y++ ) O[y+x*h]+=(Gy[y]<0)*PI;
     }
@@ -100,11 +100,11 @@ void gradMag( float *I, float *M, float *O, int h, int w, int d, bool full ) {
 
 // normalize gradient magnitude at each location (uses sse)
 void gradMagNorm( float *M, float *S, int h, int w, float norm ) {
-  __m128 *_M, *_S, _norm; int i=0, n=h*w, n4=n/4;
-  _S = (__m128*) S; _M = (__m128*) M; _norm = SET(norm);
-  bool sse = !(size_t(M)&15) && !(size_t(S)&15);
+  vecf *_M, *_S, _norm; int i=0, n=h*w, n4=n/SIMD_W;
+  _S = (vecf*) S; _M = (vecf*) M; _norm = SET(norm);
+  bool sse = !(size_t(M)&(SIMD_ALIGN-1)) && !(size_t(S)&(SIMD_ALIGN-1));
   if(sse) for(; i<n4; i++) { *_M=MUL(*_M,RCP(ADD(*_S++,_norm))); _M++; }
-  if(sse) i*=4; for(; i<n; i++) M[i] /= (S[i] + norm);
+  if(sse) i*=SIMD_W; for(; i<n; i++) M[i] /= (S[i] + norm);
 }
 
 // helper for gradHist, quantize O and M into O0, O1 and M0, M1 (uses sse)
@@ -113,19 +113,19 @@ void gradQuantize( float *O, float *M, int *O0, int *O1, float *M0, float *M1,
 {
   // assumes all *OUTPUT* matrices are 4-byte aligned
   int i, o0, o1; float o, od, m;
-  __m128i _o0, _o1, *_O0, *_O1; __m128 _o, _od, _m, *_M0, *_M1;
+  veci _o0, _o1, *_O0, *_O1; vecf _o, _od, _m, *_M0, *_M1;
   // define useful constants
   const float oMult=(float)nOrients/(full?2*PI:PI); const int oMax=nOrients*nb;
-  const __m128 _norm=SET(norm), _oMult=SET(oMult), _nbf=SET((float)nb);
-  const __m128i _oMax=SET(oMax), _nb=SET(nb);
+  const vecf _norm=SET(norm), _oMult=SET(oMult), _nbf=SET((float)nb);
+  const veci _oMax=SET(oMax), _nb=SET(nb);
   // perform the majority of the work with sse
-  _O0=(__m128i*) O0; _O1=(__m128i*) O1; _M0=(__m128*) M0; _M1=(__m128*) M1;
-  if( interpolate ) for( i=0; i<=n-4; i+=4 ) {
+  _O0=(veci*) O0; _O1=(veci*) O1; _M0=(vecf*) M0; _M1=(vecf*) M1;
+  if( interpolate ) for( i=0; i<=n-SIMD_W; i+=SIMD_W ) {
     _o=MUL(LDu(O[i]),_oMult); _o0=CVT(_o); _od=SUB(_o,CVT(_o0));
     _o0=CVT(MUL(CVT(_o0),_nbf)); _o0=AND(CMPGT(_oMax,_o0),_o0); *_O0++=_o0;
     _o1=ADD(_o0,_nb); _o1=AND(CMPGT(_oMax,_o1),_o1); *_O1++=_o1;
     _m=MUL(LDu(M[i]),_norm); *_M1=MUL(_od,_m); *_M0++=SUB(_m,*_M1); _M1++;
-  } else for( i=0; i<=n-4; i+=4 ) {
+  } else for( i=0; i<=n-SIMD_W; i+=SIMD_W ) {
     _o=MUL(LDu(O[i]),_oMult); _o0=CVT(ADD(_o,SET(.5f)));
     _o0=CVT(MUL(CVT(_o0),_nbf)); _o0=AND(CMPGT(_oMax,_o0),_o0); *_O0++=_o0;
     *_M0++=MUL(LDu(M[i]),_norm); *_M1++=SET(0.f); *_O1++=SET(0);
@@ -150,8 +150,10 @@ void gradHist( float *M, float *O, float *H, int h, int w,
   const int hb=h/bin, wb=w/bin, h0=hb*bin, w0=wb*bin, nb=wb*hb;
   const float s=(float)bin, sInv=1/s, sInv2=1/s/s;
   float *H0, *H1, *M0, *M1; int x, y; int *O0, *O1; float xb, init;
-  O0=(int*)alMalloc(h*sizeof(int),16); M0=(float*) alMalloc(h*sizeof(float),16);
-  O1=(int*)alMalloc(h*sizeof(int),16); M1=(float*) alMalloc(h*sizeof(float),16);
+  O0=(int*)alMalloc(h*sizeof(int),SIMD_ALIGN);
+  O1=(int*)alMalloc(h*sizeof(int),SIMD_ALIGN);
+  M0=(float*) alMalloc(h*sizeof(float),SIMD_ALIGN);
+  M1=(float*) alMalloc(h*sizeof(float),SIMD_ALIGN);
   // main loop
   for( x=0; x<w0; x++ ) {
     // compute target orientation bins for entire column - very fast
@@ -181,7 +183,7 @@ void gradHist( float *M, float *O, float *H, int h, int w,
 
     } else {
       // interpolate using trilinear interpolation
-      float ms[4], xyd, yb, xd, yd; __m128 _m, _m0, _m1;
+      float ms[4], xyd, yb, xd, yd;
       bool hasLf, hasRt; int xb0, yb0;
       if( x==0 ) { init=(0+.5f)*sInv-0.5f; xb=init; }
       hasLf = xb>=0; xb0 = hasLf?(int)xb:-1; hasRt = xb0 < wb-1;
@@ -189,25 +191,22 @@ void gradHist( float *M, float *O, float *H, int h, int w,
       // macros for code conciseness
       #define GHinit yd=yb-yb0; yb+=sInv; H0=H+xb0*hb+yb0; xyd=xd*yd; \
         ms[0]=1-xd-yd+xyd; ms[1]=yd-xyd; ms[2]=xd-xyd; ms[3]=xyd;
-      #define GH(H,ma,mb) H1=H; STRu(*H1,ADD(LDu(*H1),MUL(ma,mb)));
+      #define GH(H,k,m) H1=H; H1[0]+=ms[k]*m; H1[1]+=ms[k+1]*m;
       // leading rows, no top bin
       for( ; y<bin/2; y++ ) {
         yb0=-1; GHinit;
         if(hasLf) { H0[O0[y]+1]+=ms[1]*M0[y]; H0[O1[y]+1]+=ms[1]*M1[y]; }
         if(hasRt) { H0[O0[y]+hb+1]+=ms[3]*M0[y]; H0[O1[y]+hb+1]+=ms[3]*M1[y]; }
       }
-      // main rows, has top and bottom bins, use SSE for minor speedup
+      // main rows, has top and bottom bins
       if( softBin<0 ) for( ; ; y++ ) {
-        yb0 = (int) yb; if(yb0>=hb-1) break; GHinit; _m0=SET(M0[y]);
-        if(hasLf) { _m=SET(0,0,ms[1],ms[0]); GH(H0+O0[y],_m,_m0); }
-        if(hasRt) { _m=SET(0,0,ms[3],ms[2]); GH(H0+O0[y]+hb,_m,_m0); }
+        yb0 = (int) yb; if(yb0>=hb-1) break; GHinit;
+        if(hasLf) { GH(H0+O0[y],0,M0[y]); }
+        if(hasRt) { GH(H0+O0[y]+hb,2,M0[y]); }
       } else for( ; ; y++ ) {
         yb0 = (int) yb; if(yb0>=hb-1) break; GHinit;
-        _m0=SET(M0[y]); _m1=SET(M1[y]);
-        if(hasLf) { _m=SET(0,0,ms[1],ms[0]);
-          GH(H0+O0[y],_m,_m0); GH(H0+O1[y],_m,_m1); }
-        if(hasRt) { _m=SET(0,0,ms[3],ms[2]);
-          GH(H0+O0[y]+hb,_m,_m0); GH(H0+O1[y]+hb,_m,_m1); }
+        if(hasLf) { GH(H0+O0[y],0,M0[y]); GH(H0+O1[y],0,M1[y]); }
+        if(hasRt) { GH(H0+O0[y]+hb,2,M0[y]); GH(H0+O1[y]+hb,2,M1[y]); }
       }
       // final rows, no bottom bin
       for( ; y<h0; y++ ) {
@@ -312,7 +311,7 @@ void fhog( float *M, float *O, float *H, int h, int w, int binSize,
   hogChannels( H+nbo*0, R1, N, hb, wb, nOrients*2, clip, 1 );
   hogChannels( H+nbo*2, R2, N, hb, wb, nOrients*1, clip, 1 );
   hogChannels( H+nbo*3, R1, N, hb, wb, nOrients*2, clip, 2 );
-  wrFree(N); mxFree(R1); wrFree(R2);
+  wrFree(N); wrFree(R1); wrFree(R2);
 }
 
 /******************************************************************************/
@@ -402,7 +401,7 @@ void mGradHist( int nl, mxArray *pl[], int nr, const mxArray *pr[] ) {
 }
 
 // inteface to various gradient functions (see corresponding Matlab functions)
-void mexFunction( int nl, mxArray *pl[], int nr, const mxArray *pr[] ) {
+void mexSimd( int nl, mxArray *pl[], int nr, const mxArray *pr[] ) {
   int f; char action[1024]; f=mxGetString(pr[0],action,1024); nr--; pr++;
   if(f) mexErrMsgTxt("Failed to get action.");
   else if(!strcmp(action,"gradient2")) mGrad2(nl,pl,nr,pr);
@@ -411,4 +410,5 @@ void mexFunction( int nl, mxArray *pl[], int nr, const mxArray *pr[] ) {
   else if(!strcmp(action,"gradientHist")) mGradHist(nl,pl,nr,pr);
   else mexErrMsgTxt("Invalid action.");
 }
+SIMD_MEX(mexSimd)
 #endif
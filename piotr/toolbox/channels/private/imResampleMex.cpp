@@ -7,6 +7,7 @@
 #include "string.h"
 #include <math.h>
 #include <typeinfo>
+#define SIMD_SOURCE "imResampleMex.cpp" // compiled once per instruction set
 #include "sse.hpp"
 typedef unsigned char uchar;
 
@@ -18,9 +19,9 @@ template<class T> void resampleCoef( int ha, int hb, int &n, int *&yas,
   bool ds=ha>hb; int nMax; bd[0]=bd[1]=0;
   if(ds) { n=0; nMax=ha+(pad>2 ? pad : 2)*hb; } else { n=nMax=hb; }
   // initialize memory
-  wts = (T*)alMalloc(nMax*sizeof(T),16);
-  yas = (int*)alMalloc(nMax*sizeof(int),16);
-  ybs = (int*)alMalloc(nMax*sizeof(int),16);
+  wts = (T*)alMalloc(nMax*sizeof(T),SIMD_ALIGN);
+  yas = (int*)alMalloc(nMax*sizeof(int),SIMD_ALIGN);
+  ybs = (int*)alMalloc(nMax*sizeof(int),SIMD_ALIGN);
   if( ds ) for( int yb=0; yb<hb; yb++ ) {
     // create coefficients for downsampling
     T ya0f=yb*sInv, ya1f=ya0f+sInv, W=0;
@@ -45,8 +46,9 @@ template<class T> void resampleCoef( int ha, int hb, int &n, int *&yas,
 template<class T>
 void resample( T *A, T *B, int ha, int hb, int wa, int wb, int d, T r ) {
   int hn, wn, x, x1, y, z, xa, xb, ya; T *A0, *A1, *A2, *A3, *B0, wt, wt1;
-  T *C = (T*) alMalloc((ha+4)*sizeof(T),16); for(y=ha; y<ha+4; y++) C[y]=0;
-  bool sse = (typeid(T)==typeid(float)) && !(size_t(A)&15) && !(size_t(B)&15);
+  T *C = (T*) alMalloc((ha+4)*sizeof(T),SIMD_ALIGN);
+  for(y=ha; y<ha+4; y++) C[y]=0;
+  bool sse = typeid(T)==typeid(float); // only C is accessed aligned
   // get coefficients for resampling along w and h
   int *xas, *xbs, *yas, *ybs; T *xwts, *ywts; int xbd[2], ybd[2];
   resampleCoef<T>( wa, wb, wn, xas, xbs, xwts, xbd, 0 );
@@ -63,7 +65,7 @@ void resample( T *A, T *B, int ha, int hb, int wa, int wb, int d, T r ) {
     Bf0=(float*) B0; Cf=(float*) C;
     ywtsf=(float*) ywts; wtf=(float) wt; wt1f=(float) wt1;
     // resample along x direction (A -> C)
-    #define FORs(X) if(sse) for(; y<ha-4; y+=4) STR(Cf[y],X);
+    #define FORs(X) if(sse) for(; y<ha-SIMD_W; y+=SIMD_W) STR(Cf[y],X);
     #define FORr(X) for(; y<ha; y++) C[y] = X;
     if( wa==2*wb ) {
       FORs( ADD(LDu(Af0[y]),LDu(Af1[y])) );
@@ -100,10 +102,11 @@ void resample( T *A, T *B, int ha, int hb, int wa, int wb, int d, T r ) {
     #undef FORr
     // resample along y direction (B -> C)
     if( ha==hb*2 ) {
-      T r2 = r/2; int k=((~((size_t) B0) + 1) & 15)/4; y=0;
+      T r2 = r/2; int k=simdOffset(Bf0); y=0; if(k>hb) k=hb;
       for( ; y<k; y++ )  B0[y]=(C[2*y]+C[2*y+1])*r2;
-      if(sse) for(; y<hb-4; y+=4) STR(Bf0[y],MUL((float)r2,_mm_shuffle_ps(ADD(
-        LDu(Cf[2*y]),LDu(Cf[2*y+1])),ADD(LDu(Cf[2*y+4]),LDu(Cf[2*y+5])),136)));
+      if(sse) for(; y<hb-SIMD_W; y+=SIMD_W) STR(Bf0[y],MUL((float)r2,EVEN(
+        ADD(LDu(Cf[2*y]),LDu(Cf[2*y+1])),
+        ADD(LDu(Cf[2*y+SIMD_W]),LDu(Cf[2*y+SIMD_W+1])))));
       for( ; y<hb; y++ ) B0[y]=(C[2*y]+C[2*y+1])*r2;
     } else if( ha==hb*3 ) {
       for(y=0; y<hb; y++) B0[y]=(C[3*y]+C[3*y+1]+C[3*y+2])*(r/3);
@@ -131,7 +134,7 @@ void resample( T *A, T *B, int ha, int hb, int wa, int wb, int d, T r ) {
 
 // B = imResampleMex(A,hb,wb,nrm); see imResample.m for usage details
 #ifdef MATLAB_MEX_FILE
-void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+void mexSimd(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
   int *ns, ms[3], n, m, nCh, nDims;
   void *A, *B; mxClassID id; double nrm;
 
@@ -167,4 +170,5 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     mexErrMsgTxt("Unsupported type.");
   }
 }
+SIMD_MEX(mexSimd)
 #endif
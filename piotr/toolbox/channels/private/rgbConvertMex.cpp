@@ -6,6 +6,7 @@
 #include "wrappers.hpp"
 #include <cmath>
 #include <typeinfo>
+#define SIMD_SOURCE "rgbConvertMex.cpp" // compiled once per instruction set
 #include "sse.hpp"
 
 // Constants for rgb2luv conversion and lookup table for y-> l conversion
@@ -50,11 +51,10 @@ template<class iT, class oT> void rgb2luv( iT *I, oT *J, int n, oT nrm ) {
   }
 }
 
-// Convert from rgb to luv using sse
+// Convert from rgb to luv using sse (unaligned loads, so only n%SIMD_W matters)
 template<class iT> void rgb2luv_sse( iT *I, float *J, int n, float nrm ) {
   const int k=256; float R[k], G[k], B[k];
-  if( (size_t(R)&15||size_t(G)&15||size_t(B)&15||size_t(I)&15||size_t(J)&15)
-    || n%4>0 ) { rgb2luv(I,J,n,nrm); return; }
+  if( n%SIMD_W>0 ) { rgb2luv(I,J,n,nrm); return; }
   int i=0, i1, n1; float minu, minv, un, vn, mr[3], mg[3], mb[3];
   float *lTable = rgb2luv_setup(nrm,mr,mg,mb,minu,minv,un,vn);
   while( i<n ) {
@@ -68,36 +68,33 @@ template<class iT> void rgb2luv_sse( iT *I, float *J, int n, float nrm ) {
     } else { R1=((float*)I)+i; G1=R1+n; B1=G1+n; }
     // compute RGB -> XYZ
     for( int j=0; j<3; j++ ) {
-      __m128 _mr, _mg, _mb, *_J=(__m128*) (J1+j*n);
-      __m128 *_R=(__m128*) R1, *_G=(__m128*) G1, *_B=(__m128*) B1;
+      vecf _mr, _mg, _mb; float *J2=J1+j*n;
       _mr=SET(mr[j]); _mg=SET(mg[j]); _mb=SET(mb[j]);
-      for( i1=i; i1<n1; i1+=4 ) *(_J++) = ADD( ADD(MUL(*(_R++),_mr),
-        MUL(*(_G++),_mg)),MUL(*(_B++),_mb));
+      for( i1=0; i1<n1-i; i1+=SIMD_W ) STRu(J2[i1], ADD( ADD(
+        MUL(LDu(R1[i1]),_mr), MUL(LDu(G1[i1]),_mg)), MUL(LDu(B1[i1]),_mb)));
     }
     { // compute XZY -> LUV (without doing L lookup/normalization)
-      __m128 _c15, _c3, _cEps, _c52, _c117, _c1024, _cun, _cvn;
+      vecf _c15, _c3, _cEps, _c52, _c117, _c1024, _cun, _cvn;
       _c15=SET(15.0f); _c3=SET(3.0f); _cEps=SET(1e-35f);
       _c52=SET(52.0f); _c117=SET(117.0f), _c1024=SET(1024.0f);
       _cun=SET(13*un); _cvn=SET(13*vn);
-      __m128 *_X, *_Y, *_Z, _x, _y, _z;
-      _X=(__m128*) J1; _Y=(__m128*) (J1+n); _Z=(__m128*) (J1+2*n);
-      for( i1=i; i1<n1; i1+=4 ) {
-        _x = *_X; _y=*_Y; _z=*_Z;
+      float *X=J1, *Y=J1+n, *Z=J1+2*n; vecf _x, _y, _z;
+      for( i1=0; i1<n1-i; i1+=SIMD_W ) {
+        _x = LDu(X[i1]); _y=LDu(Y[i1]); _z=LDu(Z[i1]);
         _z = RCP(ADD(_x,ADD(_cEps,ADD(MUL(_c15,_y),MUL(_c3,_z)))));
-        *(_X++) = MUL(_c1024,_y);
-        *(_Y++) = SUB(MUL(MUL(_c52,_x),_z),_cun);
-        *(_Z++) = SUB(MUL(MUL(_c117,_y),_z),_cvn);
+        STRu(X[i1],MUL(_c1024,_y));
+        STRu(Y[i1],SUB(MUL(MUL(_c52,_x),_z),_cun));
+        STRu(Z[i1],SUB(MUL(MUL(_c117,_y),_z),_cvn));
       }
     }
     { // perform lookup for L and finalize computation of U and V
       for( i1=i; i1<n1; i1++ ) J[i1] = lTable[(int)J[i1]];
-      __m128 *_L, *_U, *_V, _l, _cminu, _cminv;
-      _L=(__m128*) J1; _U=(__m128*) (J1+n); _V=(__m128*) (J1+2*n);
+      float *L=J1, *U=J1+n, *V=J1+2*n; vecf _l, _cminu, _cminv;
       _cminu=SET(minu); _cminv=SET(minv);
-      for( i1=i; i1<n1; i1+=4 ) {
-        _l = *(_L++);
-        *_U = SUB(MUL(_l,*_U),_cminu); _U++;
-        *_V = SUB(MUL(_l,*_V),_cminv); _V++;
+      for( i1=0; i1<n1-i; i1+=SIMD_W ) {
+        _l = LDu(L[i1]);
+        STRu(U[i1],SUB(MUL(_l,LDu(U[i1])),_cminu));
+        STRu(V[i1],SUB(MUL(_l,LDu(V[i1])),_cminv));
       }
     }
     i = n1;
@@ -154,7 +151,7 @@ oT* rgbConvert( iT *I, int n, int d, int flag, oT nrm ) {
   int i, n1=d*(n<1000?n/10:100); oT thr = oT(1.001);
   if(flag>1 && nrm==1) for(i=0; i<n1; i++) if(I[i]>thr)
     wrError("For floats all values in I must be smaller than 1.");
-  bool useSse = n%4==0 && typeid(oT)==typeid(float);
+  bool useSse = n%SIMD_W==0 && typeid(oT)==typeid(float);
   if( flag==2 && useSse )
     for(i=0; i<d/3; i++) rgb2luv_sse(I+i*n*3,(float*)(J+i*n*3),n,(float)nrm);
   else if( (flag==0 && d==1) || flag==1 ) normalize(I,J,n*d,nrm);
@@ -167,7 +164,7 @@ oT* rgbConvert( iT *I, int n, int d, int flag, oT nrm ) {
 
 // J = rgbConvertMex(I,flag,single); see rgbConvert.m for usage details
 #ifdef MATLAB_MEX_FILE
-void mexFunction(int nl, mxArray *pl[], int nr, const mxArray *pr[]) {
+void mexSimd(int nl, mxArray *pl[], int nr, const mxArray *pr[]) {
   const int *dims; int nDims, n, d, dims1[3]; void *I; void *J; int flag;
   bool single; mxClassID idIn, idOut;
 
@@ -208,4 +205,5 @@ void mexFunction(int nl, mxArray *pl[], int nr, const mxArray *pr[]) {
   pl[0] = mxCreateNumericMatrix(0,0,idOut,mxREAL);
   mxSetData(pl[0],J); mxSetDimensions(pl[0],(const mwSize*) dims1,3);
 }
+SIMD_MEX(mexSimd)
 #endif
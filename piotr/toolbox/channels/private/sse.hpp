@@ -5,58 +5,493 @@
 *******************************************************************************/
 #ifndef _SSE_HPP_
 #define _SSE_HPP_
+
+// Width agnostic SIMD wrappers. The widest instruction set enabled at compile
+// time is used unless SIMD_LEVEL is defined explicitly (e.g. -DSIMD_LEVEL=0).
+// Kernels should only rely on SIMD_W (floats per vector) and SIMD_ALIGN (bytes
+// required by LD/STR) and never assume a vector holds exactly 4 floats. Note
+// that RCP and RCPSQRT are approximate (12 bits for SSE2/AVX2/NEON, 14 bits
+// for AVX-512, exact for the scalar fallback) so results differ slightly.
+//
+// Runtime dispatch: a source that defines SIMD_SOURCE (its path relative to
+// this file) before including sse.hpp is compiled again inside the namespaces
+// simdAvx2 and simdAvx512 with the matching instruction set enabled for those
+// functions only, so a single build runs on any x86 cpu. SIMD_CALL(f) selects
+// f for the widest instruction set the cpu supports and SIMD_MEX(f) defines a
+// mexFunction calling it. Without a compiler that supports per function
+// targets (gcc>=4.9, clang, msvc>=2017), or with SIMD_LEVEL defined, only the
+// compile time instruction set is built.
+#define SIMD_SCALAR 0
+#define SIMD_SSE2   1
+#define SIMD_NEON   2
+#define SIMD_AVX2   3
+#define SIMD_AVX512 4
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || \
+  defined(_M_X64)
+#define SIMD_X86
+#endif
+
+// instruction set of the code outside the simdAvx* namespaces
+#ifdef SIMD_LEVEL
+#define SIMD_BASE SIMD_LEVEL
+#define SIMD_MULTI 0
+#else
+#if defined(__AVX512F__)
+#define SIMD_BASE SIMD_AVX512
+#elif defined(__AVX2__)
+#define SIMD_BASE SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP>=2)
+#define SIMD_BASE SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_BASE SIMD_NEON
+#else
+#define SIMD_BASE SIMD_SCALAR
+#endif
+#if defined(SIMD_X86) && ( defined(__clang__) || (defined(_MSC_VER) && \
+  _MSC_VER>=1911) || __GNUC__>4 || (__GNUC__==4 && __GNUC_MINOR__>=9) )
+#define SIMD_MULTI 1
+#else
+#define SIMD_MULTI 0
+#endif
+#define SIMD_LEVEL SIMD_BASE
+#endif
+
+#if SIMD_MULTI || SIMD_BASE==SIMD_AVX512 || SIMD_BASE==SIMD_AVX2
+#include <immintrin.h>
+#elif SIMD_BASE==SIMD_SSE2
 #include <emmintrin.h> // SSE2:<e*.h>, SSE3:<p*.h>, SSE4:<s*.h>
+#elif SIMD_BASE==SIMD_NEON
+#include <arm_neon.h>
+#endif
+#include <math.h>
+
+// widest SIMD_LEVEL supported by the cpu (and os) running the code
+#ifdef SIMD_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+inline void simdCpuid( int r[4], int f ) { __cpuidex(r,f,0); }
+inline unsigned long long simdXgetbv() { return _xgetbv(0); }
+#else
+#include <cpuid.h>
+inline void simdCpuid( int r[4], int f ) {
+  unsigned int *u=(unsigned int*) r; __cpuid_count(f,0,u[0],u[1],u[2],u[3]); }
+inline unsigned long long simdXgetbv() {
+  unsigned int a, d; __asm__ volatile("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+  return ((unsigned long long) d<<32) | a; }
+#endif
+inline int simdCpuDetect() {
+  int r[4]; simdCpuid(r,0); const int n=r[0]; unsigned long long xcr=0;
+  simdCpuid(r,1); if(!(r[3]&(1<<26))) return SIMD_SCALAR;
+  const bool osx = (r[2]&(1<<27))!=0; if(osx) xcr=simdXgetbv();
+  if( n<7 || !osx || (xcr&6)!=6 ) return SIMD_SSE2;
+  simdCpuid(r,7); if(!(r[1]&(1<<5))) return SIMD_SSE2;
+  if( !(r[1]&(1<<16)) || (xcr&0xe6)!=0xe6 ) return SIMD_AVX2;
+  return SIMD_AVX512;
+}
+inline int simdCpuLevel() { static const int l=simdCpuDetect(); return l; }
+#elif SIMD_BASE==SIMD_NEON
+inline int simdCpuLevel() { return SIMD_NEON; }
+#else
+inline int simdCpuLevel() { return SIMD_SCALAR; }
+#endif
+
+// f for the widest instruction set compiled that the cpu supports
+#if SIMD_MULTI && SIMD_BASE<SIMD_AVX512
+#define SIMD_CALL512(f) simdCpuLevel()>=SIMD_AVX512 ? simdAvx512::f :
+#else
+#define SIMD_CALL512(f)
+#endif
+#if SIMD_MULTI && SIMD_BASE<SIMD_AVX2
+#define SIMD_CALL256(f) simdCpuLevel()>=SIMD_AVX2 ? simdAvx2::f :
+#else
+#define SIMD_CALL256(f)
+#endif
+#define SIMD_CALL(f) (SIMD_CALL512(f) SIMD_CALL256(f) f)
+
+#endif
+
+// compile SIMD_SOURCE for the instruction sets above SIMD_BASE
+#if defined(SIMD_SOURCE) && !defined(SIMD_PASS) && SIMD_MULTI
+#define SIMD_PASS
+#if SIMD_BASE<SIMD_AVX2
+#undef SIMD_LEVEL
+#define SIMD_LEVEL SIMD_AVX2
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))),apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+namespace simdAvx2 {
+#include SIMD_SOURCE
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+#if SIMD_BASE<SIMD_AVX512
+#undef SIMD_LEVEL
+#define SIMD_LEVEL SIMD_AVX512
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))),\
+  apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+namespace simdAvx512 {
+#include SIMD_SOURCE
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+#undef SIMD_LEVEL
+#define SIMD_LEVEL SIMD_BASE
+#undef SIMD_PASS
+#endif
+#ifndef SIMD_PASS
+#undef SIMD_SOURCE
+#endif
+
+// width and name of SIMD_LEVEL (set again after compiling each namespace)
+#undef SIMD_W
+#undef SIMD_NAME
+#if SIMD_LEVEL==SIMD_AVX512
+#define SIMD_W 16
+#define SIMD_NAME "AVX-512"
+#elif SIMD_LEVEL==SIMD_AVX2
+#define SIMD_W 8
+#define SIMD_NAME "AVX2"
+#elif SIMD_LEVEL==SIMD_SSE2
+#define SIMD_W 4
+#define SIMD_NAME "SSE2"
+#elif SIMD_LEVEL==SIMD_NEON
+#define SIMD_W 4
+#define SIMD_NAME "NEON"
+#else
+#define SIMD_W 1
+#define SIMD_NAME "scalar"
+#endif
+
+// alignment (in bytes) of LD/STR and of buffers obtained via alMalloc
+#undef SIMD_ALIGN
+#define SIMD_ALIGN (SIMD_W<4 ? 16 : 4*SIMD_W)
+
+// wrappers for SIMD_LEVEL, once for each instruction set (and namespace)
+#if SIMD_LEVEL==SIMD_AVX512 && !defined(_SSE_HPP_AVX512_)
+#define _SSE_HPP_AVX512_
+#define SIMD_WRAPPERS
+#elif SIMD_LEVEL==SIMD_AVX2 && !defined(_SSE_HPP_AVX2_)
+#define _SSE_HPP_AVX2_
+#define SIMD_WRAPPERS
+#elif SIMD_LEVEL==SIMD_SSE2 && !defined(_SSE_HPP_SSE2_)
+#define _SSE_HPP_SSE2_
+#define SIMD_WRAPPERS
+#elif SIMD_LEVEL==SIMD_NEON && !defined(_SSE_HPP_NEON_)
+#define _SSE_HPP_NEON_
+#define SIMD_WRAPPERS
+#elif SIMD_LEVEL==SIMD_SCALAR && !defined(_SSE_HPP_SCALAR_)
+#define _SSE_HPP_SCALAR_
+#define SIMD_WRAPPERS
+#endif
+#ifdef SIMD_WRAPPERS
+#undef SIMD_WRAPPERS
+
+#if SIMD_LEVEL==SIMD_AVX512
+typedef __m512 vecf; typedef __m512i veci;
+#elif SIMD_LEVEL==SIMD_AVX2
+typedef __m256 vecf; typedef __m256i veci;
+#elif SIMD_LEVEL==SIMD_SSE2
+typedef __m128 vecf; typedef __m128i veci;
+#elif SIMD_LEVEL==SIMD_NEON
+typedef float32x4_t vecf; typedef int32x4_t veci;
+#else
+struct vecf { float f; }; struct veci { int i; };
+#endif
+
+#define RETf inline vecf
+#define RETi inline veci
+
+#if SIMD_LEVEL==SIMD_AVX512
+#define CASTi(x) _mm512_castps_si512(x)
+#define CASTf(x) _mm512_castsi512_ps(x)
+
+// set, load and store values
+RETf SET( const float &x ) { return _mm512_set1_ps(x); }
+RETi SET( const int &x ) { return _mm512_set1_epi32(x); }
+RETf LD( const float &x ) { return _mm512_load_ps(&x); }
+RETf LDu( const float &x ) { return _mm512_loadu_ps(&x); }
+RETf STR( float &x, const vecf y ) { _mm512_store_ps(&x,y); return y; }
+RETf STR1( float &x, const vecf y ) {
+  _mm_store_ss(&x,_mm512_castps512_ps128(y)); return y; }
+RETf STRu( float &x, const vecf y ) { _mm512_storeu_ps(&x,y); return y; }
+
+// arithmetic operators
+RETi ADD( const veci x, const veci y ) { return _mm512_add_epi32(x,y); }
+RETf ADD( const vecf x, const vecf y ) { return _mm512_add_ps(x,y); }
+RETf SUB( const vecf x, const vecf y ) { return _mm512_sub_ps(x,y); }
+RETf MUL( const vecf x, const vecf y ) { return _mm512_mul_ps(x,y); }
+RETf MIN( const vecf x, const vecf y ) { return _mm512_min_ps(x,y); }
+RETf RCP( const vecf x ) { return _mm512_rcp14_ps(x); }
+RETf RCPSQRT( const vecf x ) { return _mm512_rsqrt14_ps(x); }
+
+// logical operators (AVX-512F only has integer logic, cast through veci)
+RETf AND( const vecf x, const vecf y ) {
+  return CASTf(_mm512_and_si512(CASTi(x),CASTi(y))); }
+RETi AND( const veci x, const veci y ) { return _mm512_and_si512(x,y); }
+RETf ANDNOT( const vecf x, const vecf y ) {
+  return CASTf(_mm512_andnot_si512(CASTi(x),CASTi(y))); }
+RETf OR( const vecf x, const vecf y ) {
+  return CASTf(_mm512_or_si512(CASTi(x),CASTi(y))); }
+RETf XOR( const vecf x, const vecf y ) {
+  return CASTf(_mm512_xor_si512(CASTi(x),CASTi(y))); }
+
+// comparison operators (expand comparison masks to all ones/zeros lanes)
+#define MASK(m) _mm512_maskz_set1_epi32(m,-1)
+RETf CMPGT( const vecf x, const vecf y ) {
+  return CASTf(MASK(_mm512_cmp_ps_mask(x,y,_CMP_GT_OQ))); }
+RETf CMPLT( const vecf x, const vecf y ) {
+  return CASTf(MASK(_mm512_cmp_ps_mask(x,y,_CMP_LT_OQ))); }
+RETi CMPGT( const veci x, const veci y ) {
+  return MASK(_mm512_cmpgt_epi32_mask(x,y)); }
+RETi CMPLT( const veci x, const veci y ) {
+  return MASK(_mm512_cmpgt_epi32_mask(y,x)); }
+#undef MASK
+
+// conversion operators
+RETf CVT( const veci x ) { return _mm512_cvtepi32_ps(x); }
+RETi CVT( const vecf x ) { return _mm512_cvttps_epi32(x); }
+
+// even elements of the concatenation [x y] (used for downsampling by 2)
+RETf EVEN( const vecf x, const vecf y ) {
+  const veci i=_mm512_set_epi32(30,28,26,24,22,20,18,16,14,12,10,8,6,4,2,0);
+  return _mm512_permutex2var_ps(x,i,y); }
+
+#undef CASTi
+#undef CASTf
+#elif SIMD_LEVEL==SIMD_AVX2
+
+// set, load and store values
+RETf SET( const float &x ) { return _mm256_set1_ps(x); }
+RETi SET( const int &x ) { return _mm256_set1_epi32(x); }
+RETf LD( const float &x ) { return _mm256_load_ps(&x); }
+RETf LDu( const float &x ) { return _mm256_loadu_ps(&x); }
+RETf STR( float &x, const vecf y ) { _mm256_store_ps(&x,y); return y; }
+RETf STR1( float &x, const vecf y ) {
+  _mm_store_ss(&x,_mm256_castps256_ps128(y)); return y; }
+RETf STRu( float &x, const vecf y ) { _mm256_storeu_ps(&x,y); return y; }
 
-#define RETf inline __m128
-#define RETi inline __m128i
+// arithmetic operators
+RETi ADD( const veci x, const veci y ) { return _mm256_add_epi32(x,y); }
+RETf ADD( const vecf x, const vecf y ) { return _mm256_add_ps(x,y); }
+RETf SUB( const vecf x, const vecf y ) { return _mm256_sub_ps(x,y); }
+RETf MUL( const vecf x, const vecf y ) { return _mm256_mul_ps(x,y); }
+RETf MIN( const vecf x, const vecf y ) { return _mm256_min_ps(x,y); }
+RETf RCP( const vecf x ) { return _mm256_rcp_ps(x); }
+RETf RCPSQRT( const vecf x ) { return _mm256_rsqrt_ps(x); }
+
+// logical operators
+RETf AND( const vecf x, const vecf y ) { return _mm256_and_ps(x,y); }
+RETi AND( const veci x, const veci y ) { return _mm256_and_si256(x,y); }
+RETf ANDNOT( const vecf x, const vecf y ) { return _mm256_andnot_ps(x,y); }
+RETf OR( const vecf x, const vecf y ) { return _mm256_or_ps(x,y); }
+RETf XOR( const vecf x, const vecf y ) { return _mm256_xor_ps(x,y); }
+
+// comparison operators
+RETf CMPGT( const vecf x, const vecf y ) {
+  return _mm256_cmp_ps(x,y,_CMP_GT_OQ); }
+RETf CMPLT( const vecf x, const vecf y ) {
+  return _mm256_cmp_ps(x,y,_CMP_LT_OQ); }
+RETi CMPGT( const veci x, const veci y ) { return _mm256_cmpgt_epi32(x,y); }
+RETi CMPLT( const veci x, const veci y ) { return _mm256_cmpgt_epi32(y,x); }
+
+// conversion operators
+RETf CVT( const veci x ) { return _mm256_cvtepi32_ps(x); }
+RETi CVT( const vecf x ) { return _mm256_cvttps_epi32(x); }
+
+// even elements of the concatenation [x y] (shuffle works per 128-bit lane)
+RETf EVEN( const vecf x, const vecf y ) {
+  __m256d t=_mm256_castps_pd(_mm256_shuffle_ps(x,y,136));
+  return _mm256_castpd_ps(_mm256_permute4x64_pd(t,0xD8)); }
+
+#elif SIMD_LEVEL==SIMD_SSE2
 
 // set, load and store values
 RETf SET( const float &x ) { return _mm_set1_ps(x); }
-RETf SET( float x, float y, float z, float w ) { return _mm_set_ps(x,y,z,w); }
 RETi SET( const int &x ) { return _mm_set1_epi32(x); }
 RETf LD( const float &x ) { return _mm_load_ps(&x); }
 RETf LDu( const float &x ) { return _mm_loadu_ps(&x); }
-RETf STR( float &x, const __m128 y ) { _mm_store_ps(&x,y); return y; }
-RETf STR1( float &x, const __m128 y ) { _mm_store_ss(&x,y); return y; }
-RETf STRu( float &x, const __m128 y ) { _mm_storeu_ps(&x,y); return y; }
-RETf STR( float &x, const float y ) { return STR(x,SET(y)); }
+RETf STR( float &x, const vecf y ) { _mm_store_ps(&x,y); return y; }
+RETf STR1( float &x, const vecf y ) { _mm_store_ss(&x,y); return y; }
+RETf STRu( float &x, const vecf y ) { _mm_storeu_ps(&x,y); return y; }
 
 // arithmetic operators
-RETi ADD( const __m128i x, const __m128i y ) { return _mm_add_epi32(x,y); }
-RETf ADD( const __m128 x, const __m128 y ) { return _mm_add_ps(x,y); }
-RETf ADD( const __m128 x, const __m128 y, const __m128 z ) {
-  return ADD(ADD(x,y),z); }
-RETf ADD( const __m128 a, const __m128 b, const __m128 c, const __m128 &d ) {
-  return ADD(ADD(ADD(a,b),c),d); }
-RETf SUB( const __m128 x, const __m128 y ) { return _mm_sub_ps(x,y); }
-RETf MUL( const __m128 x, const __m128 y ) { return _mm_mul_ps(x,y); }
-RETf MUL( const __m128 x, const float y ) { return MUL(x,SET(y)); }
-RETf MUL( const float x, const __m128 y ) { return MUL(SET(x),y); }
-RETf INC( __m128 &x, const __m128 y ) { return x = ADD(x,y); }
-RETf INC( float &x, const __m128 y ) { __m128 t=ADD(LD(x),y); return STR(x,t); }
-RETf DEC( __m128 &x, const __m128 y ) { return x = SUB(x,y); }
-RETf DEC( float &x, const __m128 y ) { __m128 t=SUB(LD(x),y); return STR(x,t); }
-RETf MIN( const __m128 x, const __m128 y ) { return _mm_min_ps(x,y); }
-RETf RCP( const __m128 x ) { return _mm_rcp_ps(x); }
-RETf RCPSQRT( const __m128 x ) { return _mm_rsqrt_ps(x); }
+RETi ADD( const veci x, const veci y ) { return _mm_add_epi32(x,y); }
+RETf ADD( const vecf x, const vecf y ) { return _mm_add_ps(x,y); }
+RETf SUB( const vecf x, const vecf y ) { return _mm_sub_ps(x,y); }
+RETf MUL( const vecf x, const vecf y ) { return _mm_mul_ps(x,y); }
+RETf MIN( const vecf x, const vecf y ) { return _mm_min_ps(x,y); }
+RETf RCP( const vecf x ) { return _mm_rcp_ps(x); }
+RETf RCPSQRT( const vecf x ) { return _mm_rsqrt_ps(x); }
 
 // logical operators
-RETf AND( const __m128 x, const __m128 y ) { return _mm_and_ps(x,y); }
-RETi AND( const __m128i x, const __m128i y ) { return _mm_and_si128(x,y); }
-RETf ANDNOT( const __m128 x, const __m128 y ) { return _mm_andnot_ps(x,y); }
-RETf OR( const __m128 x, const __m128 y ) { return _mm_or_ps(x,y); }
-RETf XOR( const __m128 x, const __m128 y ) { return _mm_xor_ps(x,y); }
+RETf AND( const vecf x, const vecf y ) { return _mm_and_ps(x,y); }
+RETi AND( const veci x, const veci y ) { return _mm_and_si128(x,y); }
+RETf ANDNOT( const vecf x, const vecf y ) { return _mm_andnot_ps(x,y); }
+RETf OR( const vecf x, const vecf y ) { return _mm_or_ps(x,y); }
+RETf XOR( const vecf x, const vecf y ) { return _mm_xor_ps(x,y); }
 
 // comparison operators
-RETf CMPGT( const __m128 x, const __m128 y ) { return _mm_cmpgt_ps(x,y); }
-RETf CMPLT( const __m128 x, const __m128 y ) { return _mm_cmplt_ps(x,y); }
-RETi CMPGT( const __m128i x, const __m128i y ) { return _mm_cmpgt_epi32(x,y); }
-RETi CMPLT( const __m128i x, const __m128i y ) { return _mm_cmplt_epi32(x,y); }
+RETf CMPGT( const vecf x, const vecf y ) { return _mm_cmpgt_ps(x,y); }
+RETf CMPLT( const vecf x, const vecf y ) { return _mm_cmplt_ps(x,y); }
+RETi CMPGT( const veci x, const veci y ) { return _mm_cmpgt_epi32(x,y); }
+RETi CMPLT( const veci x, const veci y ) { return _mm_cmplt_epi32(x,y); }
 
 // conversion operators
-RETf CVT( const __m128i x ) { return _mm_cvtepi32_ps(x); }
-RETi CVT( const __m128 x ) { return _mm_cvttps_epi32(x); }
+RETf CVT( const veci x ) { return _mm_cvtepi32_ps(x); }
+RETi CVT( const vecf x ) { return _mm_cvttps_epi32(x); }
+
+// even elements of the concatenation [x y]
+RETf EVEN( const vecf x, const vecf y ) { return _mm_shuffle_ps(x,y,136); }
+
+#elif SIMD_LEVEL==SIMD_NEON
+#define CASTu(x) vreinterpretq_u32_f32(x)
+#define CASTf(x) vreinterpretq_f32_u32(x)
+
+// set, load and store values
+RETf SET( const float &x ) { return vdupq_n_f32(x); }
+RETi SET( const int &x ) { return vdupq_n_s32(x); }
+RETf LD( const float &x ) { return vld1q_f32(&x); }
+RETf LDu( const float &x ) { return vld1q_f32(&x); }
+RETf STR( float &x, const vecf y ) { vst1q_f32(&x,y); return y; }
+RETf STR1( float &x, const vecf y ) { vst1q_lane_f32(&x,y,0); return y; }
+RETf STRu( float &x, const vecf y ) { vst1q_f32(&x,y); return y; }
+
+// arithmetic operators (one Newton step brings RCP* to SSE precision)
+RETi ADD( const veci x, const veci y ) { return vaddq_s32(x,y); }
+RETf ADD( const vecf x, const vecf y ) { return vaddq_f32(x,y); }
+RETf SUB( const vecf x, const vecf y ) { return vsubq_f32(x,y); }
+RETf MUL( const vecf x, const vecf y ) { return vmulq_f32(x,y); }
+RETf MIN( const vecf x, const vecf y ) { return vminq_f32(x,y); }
+RETf RCP( const vecf x ) {
+  vecf r=vrecpeq_f32(x); return vmulq_f32(vrecpsq_f32(x,r),r); }
+RETf RCPSQRT( const vecf x ) {
+  vecf r=vrsqrteq_f32(x); return vmulq_f32(vrsqrtsq_f32(vmulq_f32(x,r),r),r); }
+
+// logical operators
+RETf AND( const vecf x, const vecf y ) {
+  return CASTf(vandq_u32(CASTu(x),CASTu(y))); }
+RETi AND( const veci x, const veci y ) { return vandq_s32(x,y); }
+RETf ANDNOT( const vecf x, const vecf y ) {
+  return CASTf(vbicq_u32(CASTu(y),CASTu(x))); }
+RETf OR( const vecf x, const vecf y ) {
+  return CASTf(vorrq_u32(CASTu(x),CASTu(y))); }
+RETf XOR( const vecf x, const vecf y ) {
+  return CASTf(veorq_u32(CASTu(x),CASTu(y))); }
+
+// comparison operators
+RETf CMPGT( const vecf x, const vecf y ) { return CASTf(vcgtq_f32(x,y)); }
+RETf CMPLT( const vecf x, const vecf y ) { return CASTf(vcltq_f32(x,y)); }
+RETi CMPGT( const veci x, const veci y ) {
+  return vreinterpretq_s32_u32(vcgtq_s32(x,y)); }
+RETi CMPLT( const veci x, const veci y ) {
+  return vreinterpretq_s32_u32(vcltq_s32(x,y)); }
+
+// conversion operators
+RETf CVT( const veci x ) { return vcvtq_f32_s32(x); }
+RETi CVT( const vecf x ) { return vcvtq_s32_f32(x); }
+
+// even elements of the concatenation [x y]
+RETf EVEN( const vecf x, const vecf y ) { return vuzpq_f32(x,y).val[0]; }
+
+#undef CASTu
+#undef CASTf
+#else
+// scalar fallback, vectors hold a single float (or int) and logic is bitwise
+inline int BITS( float x ) { union { float f; int i; } u; u.f=x; return u.i; }
+inline float FLT( int x ) { union { float f; int i; } u; u.i=x; return u.f; }
+RETf VEC( float x ) { vecf v; v.f=x; return v; }
+RETi VEC( int x ) { veci v; v.i=x; return v; }
+
+// set, load and store values
+RETf SET( const float &x ) { return VEC(x); }
+RETi SET( const int &x ) { return VEC(x); }
+RETf LD( const float &x ) { return VEC(x); }
+RETf LDu( const float &x ) { return VEC(x); }
+RETf STR( float &x, const vecf y ) { x=y.f; return y; }
+RETf STR1( float &x, const vecf y ) { x=y.f; return y; }
+RETf STRu( float &x, const vecf y ) { x=y.f; return y; }
+
+// arithmetic operators
+RETi ADD( const veci x, const veci y ) { return VEC(x.i+y.i); }
+RETf ADD( const vecf x, const vecf y ) { return VEC(x.f+y.f); }
+RETf SUB( const vecf x, const vecf y ) { return VEC(x.f-y.f); }
+RETf MUL( const vecf x, const vecf y ) { return VEC(x.f*y.f); }
+RETf MIN( const vecf x, const vecf y ) { return VEC(x.f<y.f ? x.f : y.f); }
+RETf RCP( const vecf x ) { return VEC(1/x.f); }
+RETf RCPSQRT( const vecf x ) { return VEC(1/sqrtf(x.f)); }
+
+// logical operators
+RETf AND( const vecf x, const vecf y ) { return VEC(FLT(BITS(x.f)&BITS(y.f))); }
+RETi AND( const veci x, const veci y ) { return VEC(x.i&y.i); }
+RETf ANDNOT( const vecf x, const vecf y ) {
+  return VEC(FLT(~BITS(x.f)&BITS(y.f))); }
+RETf OR( const vecf x, const vecf y ) { return VEC(FLT(BITS(x.f)|BITS(y.f))); }
+RETf XOR( const vecf x, const vecf y ) { return VEC(FLT(BITS(x.f)^BITS(y.f))); }
+
+// comparison operators
+RETf CMPGT( const vecf x, const vecf y ) { return VEC(FLT(x.f>y.f ? -1 : 0)); }
+RETf CMPLT( const vecf x, const vecf y ) { return VEC(FLT(x.f<y.f ? -1 : 0)); }
+RETi CMPGT( const veci x, const veci y ) { return VEC(x.i>y.i ? -1 : 0); }
+RETi CMPLT( const veci x, const veci y ) { return VEC(x.i<y.i ? -1 : 0); }
+
+// conversion operators
+RETf CVT( const veci x ) { return VEC((float) x.i); }
+RETi CVT( const vecf x ) { return VEC((int) x.f); }
+
+// even elements of the concatenation [x y]
+RETf EVEN( const vecf x, const vecf ) { return x; }
+
+#endif
+
+// width independent helpers built on top of the above
+RETf STR( float &x, const float y ) { return STR(x,SET(y)); }
+RETf ADD( const vecf x, const vecf y, const vecf z ) {
+  return ADD(ADD(x,y),z); }
+RETf ADD( const vecf a, const vecf b, const vecf c, const vecf &d ) {
+  return ADD(ADD(ADD(a,b),c),d); }
+RETf MUL( const vecf x, const float y ) { return MUL(x,SET(y)); }
+RETf MUL( const float x, const vecf y ) { return MUL(SET(x),y); }
+RETf INC( vecf &x, const vecf y ) { return x = ADD(x,y); }
+RETf INC( float &x, const vecf y ) { vecf t=ADD(LD(x),y); return STR(x,t); }
+RETf DEC( vecf &x, const vecf y ) { return x = SUB(x,y); }
+RETf DEC( float &x, const vecf y ) { vecf t=SUB(LD(x),y); return STR(x,t); }
+
+// number of floats before x reaches a SIMD_ALIGN boundary
+inline int simdOffset( const float *x ) {
+  return int(((~((size_t) x) + 1) & (SIMD_ALIGN-1))/sizeof(float)); }
 
 #undef RETf
 #undef RETi
+
+// true if the instruction set the code was compiled for can run on this cpu
+inline bool simdSupported() { return simdCpuLevel()>=SIMD_LEVEL; }
+
+#endif
+
+// mexFunction calling f (see SIMD_CALL), only outside the simdAvx* namespaces
+#undef SIMD_MEX
+#ifdef SIMD_PASS
+#define SIMD_MEX(f)
+#else
+#define SIMD_MEX(f) void mexFunction( int nl, mxArray *pl[], int nr, \
+  const mxArray *pr[] ) { \
+  if(!simdSupported()) mexErrMsgTxt("CPU lacks " SIMD_NAME ", recompile."); \
+  SIMD_CALL(f)(nl,pl,nr,pr); }
 #endif
@@ -6,6 +6,13 @@
 % toolboxCompile. Note that this will disable parallelization and make some
 % routines (in particular training certain classifier) much slower.
 %
+% The channels/ and videos/ code is vectorized via channels/private/sse.hpp.
+% Each of these mex files contains its kernels for SSE2, AVX2 (8 floats) and
+% AVX-512 (16 floats) vectors and uses the widest one the cpu supports, so no
+% compiler flags are needed and the mex files run on any x86 cpu (compilers
+% without per function targets, gcc<4.9 or msvc<2017, only build SSE2). Use
+% channels/private/chnsBenchCpp.cpp to time the kernels of each of them.
+%
 % USAGE
 %  toolboxCompile
 %
@@ -41,7 +48,7 @@ fs={'channels/convConst.cpp', 'channels/gradientMex.cpp',...
   'images/nlfiltersep_max.c', 'images/nlfiltersep_sum.c', ...
   'videos/ktComputeW_c.c', 'videos/ktHistcRgb_c.c', ...
   'videos/opticalFlowHsMex.cpp' };
-n=length(fs); useOmp=zeros(1,n); if(~ismac), useOmp([6 9])=1; end
+n=length(fs); useOmp=zeros(1,n); if(~ismac), useOmp([6 9 19])=1; end
 
 % compile every funciton in turn (special case for dijkstra)
 disp('Compiling Piotr''s Toolbox.......................');
@@ -56,7 +63,14 @@ for i=1:n
 end
 try %#ok<ALIGN>
   d=[rd '/matlab/private/']; fprintf(' -> %s\n',[d 'dijkstra1.cpp']);
-  mex([d 'fibheap.cpp'], [d 'dijkstra1.cpp'], '-largeArrayDims', ...
-    opts{:}, [d 'dijkstra1.' mexext]);
+  if(ismac), optsi=opts; else optsi=[optsOmp opts]; end
+  % sparse_dijkstra.hpp is a copy of the toolbox_graph header, check that
+  % the two have not drifted apart when both toolboxes are present
+  g=fullfile(rd,'..','..','Matlab imaging','Matlab toolbox','toolbox_graph',...
+    'mex','sparse_dijkstra.hpp');
+  h=[d 'sparse_dijkstra.hpp'];
+  if(exist(g,'file') && ~isequal(fileread(g),fileread(h)))
+    warning('%s differs from its original %s',h,g); end
+  mex([d 'dijkstra1.cpp'], '-largeArrayDims', optsi{:}, [d 'dijkstra1.' mexext]);
 catch err, fprintf(errmsg,[f1 e],err.message); end
 disp('..................................Done Compiling'); toc;
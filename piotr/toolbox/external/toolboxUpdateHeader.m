@@ -26,7 +26,7 @@ ds=dir(root); ds=ds([ds.isdir]); ds={ds.name};
 ds=ds(3:end); ds=setdiff(ds,{'.git','doc'});
 subds = { '/', '/private/' };
 exts = {'m','c','cpp','h','hpp'};
-omit = {'Contents.m','fibheap.h','fibheap.cpp'};
+omit = {'Contents.m','sparse_dijkstra.hpp'};
 
 for i=1:length(ds)
   for j=1:length(subds)
@@ -2,19 +2,21 @@ function [D,P] = dijkstra( G, varargin )
 % Runs Dijkstra's shortest path algorithm on a distance matrix.
 %
 % Runs Dijkstra's on the given SPARSE nxn distance matrix G, where missing
-% values mean no edge (infinite distance). Uses a Finonacci heap resulting
-% in fast computation. Finds the shortest path distance from every point
+% values mean no edge (infinite distance). Uses an indexed 4-ary heap
+% directly on the sparse matrix, and sources are processed in parallel (if
+% compiled with OpenMP). Finds the shortest path distance from every point
 % S(i) in the 1xp source vector S to every other point j, resulting in a
 % pxn distance matrix D. P(i,j) contains the second to last node on the
 % path from S(i) to j. If point j is not reachable from point S(i) then
 % D(i,j)=inf and P(i,j)=-1.
 %
 % USAGE
-%   [D P] = dijkstra( G, [S] )
+%   [D P] = dijkstra( G, [S], [nThreads] )
 %
 % INPUT
 %   G   - sparse nxn distance matrix
 %   S   - 1xp array of source indices i
+%   nThreads - [all] number of threads over which sources are split
 %
 % OUPUT
 %   D   - pxn - shortest path lengths from S(i) to j
@@ -6,7 +6,7 @@ function [Vx,Vy,reliab] = opticalFlow( I1, I2, varargin )
 %  HS: http://en.wikipedia.org/wiki/Horn-Schunck_method
 %  SD: Simple block-based sum of absolute differences flow
 % LK is a local, fast method (the implementation is fully vectorized).
-% HS is a global, slower method (an SSE implementation is provided).
+% HS is a global, slower method (an SSE/OpenMP implementation is provided).
 % SD is a simple but potentially expensive approach.
 %
 % Common parameters: 'smooth' determines smoothing prior to computing flow
@@ -19,7 +19,9 @@ function [Vx,Vy,reliab] = opticalFlow( I1, I2, varargin )
 % and SD. 'nBlock' determines number of blocks tested in each direction for
 % SD, computation time is O(nBlock^2). For HS, 'alpha' controls tradeoff
 % between data and smoothness term (and smoothness of flow) and 'nIter'
-% determines number of gradient decent steps.
+% determines number of gradient decent steps. Setting 'omega' in (0,2) for
+% HS replaces the Jacobi steps by red-black SOR sweeps which converge in far
+% fewer iterations (omega=1.9 works well, nIter may then be reduced).
 %
 % USAGE
 %  [Vx,Vy,reliab] = opticalFlow( I1, I2, pFlow )
@@ -36,6 +38,7 @@ function [Vx,Vy,reliab] = opticalFlow( I1, I2, varargin )
 %   .nBlock     - [5] number of tested blocks [SD only]
 %   .alpha      - [1] smoothness constraint [HS only]
 %   .nIter      - [250] number of iterations [HS only]
+%   .omega      - [0] SOR relaxation in (0,2), 0 uses Jacobi steps [HS only]
 %
 % OUTPUTS
 %  Vx, Vy   - x,y components of flow  [Vx>0->right, Vy>0->down]
@@ -58,6 +61,7 @@ function [Vx,Vy,reliab] = opticalFlow( I1, I2, varargin )
 %  prm={'smooth',1,'radius',10,'alpha',20,'nIter',250,'type'};
 %  tic, [Vx1,Vy1]=opticalFlow(I1,I2,prm{:},'LK'); toc
 %  tic, [Vx2,Vy2]=opticalFlow(I1,I2,prm{:},'HS'); toc
+%  tic, [Vx4,Vy4]=opticalFlow(I1,I2,prm{:},'HS','omega',1.9); toc
 %  tic, [Vx3,Vy3]=opticalFlow(I1,I2,prm{:},'SD','minScale',1); toc
 %  figure(1); im([Vx1 Vy1; Vx2 Vy2; Vx3 Vy3]); colormap jet;
 %
@@ -69,9 +73,10 @@ function [Vx,Vy,reliab] = opticalFlow( I1, I2, varargin )
 
 % get default parameters and do error checking
 dfs={ 'type','LK', 'smooth',1, 'filt',0, 'minScale',1/64, ...
-  'maxScale',1, 'radius',10, 'nBlock',5, 'alpha',1, 'nIter',250 };
-[type,smooth,filt,minScale,maxScale,radius,nBlock,alpha,nIter] = ...
+  'maxScale',1, 'radius',10, 'nBlock',5, 'alpha',1, 'nIter',250, 'omega',0 };
+[type,smooth,filt,minScale,maxScale,radius,nBlock,alpha,nIter,omega] = ...
   getPrmDflt(varargin,dfs,1);
+assert(omega>=0 && omega<2);
 assert(any(strcmp(type,{'LK','HS','SD'})));
 if( ~ismatrix(I1) || ~ismatrix(I2) || any(size(I1)~=size(I2)) )
   error('Input images must be 2D and have same dimensions.'); end
@@ -94,7 +99,7 @@ for s=1:max(1,nScales + round(log2(maxScale)))
   % run optical flow on current scale
   switch type
     case 'LK', [Vx1,Vy1,reliab]=opticalFlowLk(I1s,I2s,radius);
-    case 'HS', [Vx1,Vy1,reliab]=opticalFlowHs(I1s,I2s,alpha,nIter);
+    case 'HS', [Vx1,Vy1,reliab]=opticalFlowHs(I1s,I2s,alpha,nIter,omega);
     case 'SD', [Vx1,Vy1,reliab]=opticalFlowSd(I1s,I2s,radius,nBlock,1);
   end
   Vx=Vx+Vx1; Vy=Vy+Vy1;
@@ -123,7 +128,7 @@ Vy = AAdeti .* (-AAxy.*ABxt + AAxx.*AByt);
 reliab = 0.5*AAtr - 0.5*sqrt(AAtr.^2-4*AAdet);
 end
 
-function [Vx,Vy,reliab] = opticalFlowHs( I1, I2, alpha, nIter )
+function [Vx,Vy,reliab] = opticalFlowHs( I1, I2, alpha, nIter, omega )
 % compute derivatives (averaging over 2x2 neighborhoods)
 pad = @(I,p) imPad(I,p,'replicate');
 crop = @(I,c) I(1+c:end-c,1+c:end-c);
@@ -136,7 +141,7 @@ Et=pad(Et,[0 2 1 1])+pad(Et,[1 1 1 1])+pad(Et,[1 1 0 2])+pad(Et,[0 2 0 2]);
 Z=1./(alpha*alpha + Ex.*Ex + Ey.*Ey); reliab=crop(Z,1);
 % iterate updating Ux and Vx in each iter
 if( 1 )
-  [Vx,Vy]=opticalFlowHsMex(Ex,Ey,Et,Z,nIter);
+  [Vx,Vy]=opticalFlowHsMex(Ex,Ey,Et,Z,nIter,omega);
   Vx=crop(Vx,1); Vy=crop(Vy,1);
 else
   Ex=crop(Ex,1); Ey=crop(Ey,1); Et=crop(Et,1); Z=crop(Z,1);
@@ -4,49 +4,99 @@
 * Licensed under the Simplified BSD License [see external/bsd.txt]
 *******************************************************************************/
 #include "string.h"
-#include "mex.h"
+#include "../../channels/private/wrappers.hpp"
+#ifdef USEOMP
+#include <omp.h>
+#endif
+// compiled once per instruction set (path relative to sse.hpp)
+#define SIMD_SOURCE "../../videos/private/opticalFlowHsMex.cpp"
 #include "../../channels/private/sse.hpp"
 
 // run nIter iterations of Horn & Schunk optical flow (alters Vx, Vy)
 void opticalFlowHsMex( float *Vx, float *Vy, const float *Ex, const float *Ey,
-  const float *Et, const float *Z, const int h, const int w, const int nIter )
+  const float *Et, const float *Z, const int h, const int w, const int nIter,
+  int nThreads=1 )
 {
-  int x, y, x1, i, t, s; float my, mx, m, *Vx0, *Vy0;
-  s=w*h*sizeof(float); Vx0=new float[s]; Vy0=new float[s];
-  for( t=0; t<nIter; t++ ) {
-    memcpy(Vx0,Vx,s); memcpy(Vy0,Vy,s);
-    for( x=1; x<w-1; x++ ) {
+  // Jacobi iterations ping-pong between (Vx,Vy) and a second pair of buffers,
+  // borders are never written so the buffers start out as copies of (Vx,Vy)
+  const size_t s=size_t(w)*h*sizeof(float); float *Tx, *Ty, *Vx0, *Vy0, *Vx1,
+    *Vy1, *t0; Tx=(float*) wrMalloc(s); Ty=(float*) wrMalloc(s);
+  memcpy(Tx,Vx,s); memcpy(Ty,Vy,s); Vx0=Vx; Vy0=Vy; Vx1=Tx; Vy1=Ty;
+  #ifdef USEOMP
+  nThreads = nThreads<omp_get_max_threads() ? nThreads : omp_get_max_threads();
+  #else
+  (void) nThreads;
+  #endif
+  for( int t=0; t<nIter; t++ ) {
+    #ifdef USEOMP
+    #pragma omp parallel for num_threads(nThreads)
+    #endif
+    for( int x=1; x<w-1; x++ ) {
+      int y, x1=x*h, i; float my, mx, m;
       // do as much work as possible in SSE (assume non-aligned memory)
-      for( y=1; y<h-4; y+=4 ) {
-        x1=x*h; i=x1+y; __m128 _mx, _my, _m;
+      for( y=1; y<h-SIMD_W; y+=SIMD_W ) {
+        i=x1+y; vecf _mx, _my, _m;
         _my=MUL(ADD(LDu(Vy0[x1-h+y]),LDu(Vy0[x1+h+y]),
           LDu(Vy0[x1+y-1]),LDu(Vy0[x1+y+1])),.25f);
         _mx=MUL(ADD(LDu(Vx0[x1-h+y]),LDu(Vx0[x1+h+y]),
           LDu(Vx0[x1+y-1]),LDu(Vx0[x1+y+1])),.25f);
         _m=MUL(ADD(MUL(LDu(Ey[i]),_my),MUL(LDu(Ex[i]),_mx),
           LDu(Et[i])),LDu(Z[i]));
-        STRu(Vx[i],SUB(_mx,MUL(LDu(Ex[i]),_m)));
-        STRu(Vy[i],SUB(_my,MUL(LDu(Ey[i]),_m)));
+        STRu(Vx1[i],SUB(_mx,MUL(LDu(Ex[i]),_m)));
+        STRu(Vy1[i],SUB(_my,MUL(LDu(Ey[i]),_m)));
       }
       // do remainder of work in regular loop
       for( ; y<h-1; y++ ) {
-        x1=x*h; i=x1+y;
+        i=x1+y;
         mx=.25f*(Vx0[x1-h+y]+Vx0[x1+h+y]+Vx0[x1+y-1]+Vx0[x1+y+1]);
         my=.25f*(Vy0[x1-h+y]+Vy0[x1+h+y]+Vy0[x1+y-1]+Vy0[x1+y+1]);
         m = (Ex[i]*mx + Ey[i]*my + Et[i])*Z[i];
-        Vx[i]=mx-Ex[i]*m; Vy[i]=my-Ey[i]*m;
+        Vx1[i]=mx-Ex[i]*m; Vy1[i]=my-Ey[i]*m;
       }
     }
+    t0=Vx0; Vx0=Vx1; Vx1=t0; t0=Vy0; Vy0=Vy1; Vy1=t0;
   }
-  delete [] Vx0; delete [] Vy0;
+  // after an odd number of iterations the result is in the second buffers
+  if( Vx0!=Vx ) { memcpy(Vx,Vx0,s); memcpy(Vy,Vy0,s); }
+  wrFree(Tx); wrFree(Ty);
 }
 
-// [Vx,Vy]=opticalFlowHsMex(Ex,Ey,Et,Z,nIter); - helper for opticalFlow
-void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
-  size_t h, w, nIter; float *Is[4], *Vx, *Vy;
+// run nIter red-black SOR sweeps of Horn & Schunk optical flow (in place)
+void opticalFlowHsSor( float *Vx, float *Vy, const float *Ex, const float *Ey,
+  const float *Et, const float *Z, const int h, const int w, const int nIter,
+  const float omega, int nThreads=1 )
+{
+  // pixels with (x+y)%2==c only depend on pixels of the other color, so each
+  // half sweep updates in place and columns can be split among threads
+  #ifdef USEOMP
+  nThreads = nThreads<omp_get_max_threads() ? nThreads : omp_get_max_threads();
+  #else
+  (void) nThreads;
+  #endif
+  for( int t=0; t<nIter; t++ ) for( int c=0; c<2; c++ ) {
+    #ifdef USEOMP
+    #pragma omp parallel for num_threads(nThreads)
+    #endif
+    for( int x=1; x<w-1; x++ ) {
+      const int x1=x*h; float my, mx, m;
+      for( int i=x1+1+((x+1+c)&1); i<x1+h-1; i+=2 ) {
+        mx=.25f*(Vx[i-h]+Vx[i+h]+Vx[i-1]+Vx[i+1]);
+        my=.25f*(Vy[i-h]+Vy[i+h]+Vy[i-1]+Vy[i+1]);
+        m = (Ex[i]*mx + Ey[i]*my + Et[i])*Z[i];
+        Vx[i]+=omega*(mx-Ex[i]*m-Vx[i]); Vy[i]+=omega*(my-Ey[i]*m-Vy[i]);
+      }
+    }
+  }
+}
+
+// [Vx,Vy]=opticalFlowHsMex(Ex,Ey,Et,Z,nIter,[omega],[nThreads]);
+// helper for opticalFlow, omega>0 selects red-black SOR over Jacobi updates
+#ifdef MATLAB_MEX_FILE
+void mexSimd(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+  size_t h, w, nIter; float *Is[4], *Vx, *Vy, omega; int nThreads;
 
   // Error checking on arguments
-  if( nrhs!=5 ) mexErrMsgTxt("Five inputs expected.");
+  if( nrhs<5 || nrhs>7 ) mexErrMsgTxt("Five to seven inputs expected.");
   if( nlhs!=2 ) mexErrMsgTxt("Two outputs expected.");
   h = mxGetM(prhs[0]); w = mxGetN(prhs[0]);
   for( int i=0; i<4; i++ ) {
@@ -55,6 +105,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     Is[i] = (float*) mxGetData(prhs[i]);
   }
   nIter = (int) mxGetScalar(prhs[4]);
+  omega = (nrhs<6) ? 0 : (float) mxGetScalar(prhs[5]);
+  nThreads = (nrhs<7) ? 100000 : (int) mxGetScalar(prhs[6]);
+  if( omega<0 || omega>=2 ) mexErrMsgTxt("omega must be in [0,2).");
 
   // create output matricies
   plhs[0] = mxCreateNumericMatrix(int(h),int(w),mxSINGLE_CLASS,mxREAL);
@@ -63,5 +116,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
   Vy = (float*) mxGetData(plhs[1]);
 
   // run optical flow
-  opticalFlowHsMex(Vx,Vy,Is[0],Is[1],Is[2],Is[3],int(h),int(w),nIter);
+  if( omega>0 ) opticalFlowHsSor(Vx,Vy,Is[0],Is[1],Is[2],Is[3],
+    int(h),int(w),int(nIter),omega,nThreads);
+  else opticalFlowHsMex(Vx,Vy,Is[0],Is[1],Is[2],Is[3],
+    int(h),int(w),int(nIter),nThreads);
 }
+SIMD_MEX(mexSimd)
+#endif
@@ -1,78 +1,37 @@
 #include "mex.h"
-#include "GLTree.cpp"
+#include "KDTreeMex.h"
 /* the gateway function */
 //la chiamata deve essere ptr=BuildGLtree(p)
+//p is [N x dim] single or double, the tree keeps its own copy of it
 
-void mexFunction( int nlhs, mxArray *plhs[1],
-                  int nrhs, const mxArray *prhs[1])
+template<class T>
+KDTreeBase* BuildTree(const mxArray *p)
 {
- 
- //dichiarazioni variabili   
- double       *p;
-
- int N,i;
- GLTREE* ptr;
- 
-  
- 
-  if(nrhs!=1) 
-    mexErrMsgTxt("One Input required.");
-
-  
-    if( !mxIsDouble(prhs[0]))
- { mexErrMsgTxt("Input must be double arrays ");
-         } 
-
+    return new KDTree<T>((const T*)mxGetData(p), (int)mxGetM(p), (int)mxGetN(p), (int)mxGetClassID(p));
+}
 
-    
-    
-       N=mxGetN(prhs[0]);//dimensione dei punti
+void mexFunction( int nlhs, mxArray *plhs[],
+                  int nrhs, const mxArray *prhs[])
+{
+    KDTreeBase* ptr;
 
-      if(N!=3) 
-    mexErrMsgTxt("Only 3D input required.");
-     
-     
-     N=mxGetM(prhs[0]);//dimensione dell'array
-    
+    if(nrhs!=1)
+        mexErrMsgTxt("One Input required.");
 
-      
-       p = mxGetPr(prhs[0]);//puntatore all'array dei punti
-    
-      Coord3D* pstruct=new Coord3D[N]; 
-       
-      //copying the point array to GLTree data structure
-      for (i=0;i<N;i++)
-      {
-          
-       pstruct[i].x=p[i];
-        pstruct[i].y=p[i+N];
-         pstruct[i].z=p[i+2*N];
-//       mexPrintf(" %4.4f   %4.4f   %4.4f\n",p[i],p[i+N],p[i+N+N]);
-      }
-       
-     ptr=new GLTREE(pstruct,N);//chiamata al costruttore
-//       ptr=&Tree;//creo il puntatore all'albero
-     // mexPrintf("puntatore= %4.4x\n",ptr);//stampa il puntatore
-      
-        
-        
-     //return the program a pointer to the created tree
-     plhs[0] = mxCreateDoubleMatrix(1,1,mxREAL);//crea il puntatore all'output
-     double* ptrtree = mxGetPr(plhs[0]);//rendi double* GLTREE* 
-     ptrtree[0]=(long) ptr;//copia il puntatore 
-     
-     
-     
-     //trying to remake it a tree pointer
-     // verifico se la conversione riporta al puntatore originario
-     //ptr=(GLTREE*)(long(ptrtree[0]));
-    // mexPrintf("puntatore= %4.4x\n",ptr);
-  
-     
-     
-}
+    if( !mxIsDouble(prhs[0]) && !mxIsSingle(prhs[0]))
+        mexErrMsgTxt("Input must be a single or double array ");
 
+    if( mxIsComplex(prhs[0]) || mxGetNumberOfDimensions(prhs[0])!=2 || mxGetN(prhs[0])<1)
+        mexErrMsgTxt("Input must be a real [N x dim] array ");
 
+    if( mxGetM(prhs[0])>(size_t)0x7fffffff )
+        mexErrMsgTxt("Too many points ");
 
+    if(mxIsDouble(prhs[0]))
+        ptr=BuildTree<double>(prhs[0]);
+    else
+        ptr=BuildTree<float>(prhs[0]);
 
-        
+    //return the program a handle to the created tree
+    plhs[0] = CreateKDTreeHandle(ptr);
+}
@@ -1,14 +1,15 @@
-% BuildGLTree construct a GL-Tree from a 2D point cloud
+% BuildGLTree construct a k-d tree from an N-D point cloud
 %
 % SYNTAX
-% ptrtree=BuildGLTree(px,py);
+% ptrtree=BuildGLTree(p);
 %
 % INPUT PARAMETERS
-%   px,py: [Nx1] double vectors of the x and y coordinates of points.
+%   p: [Nxdim] single or double array, one point per row.
 %     
 %
 % OUTPUT PARAMETERS
-%   ptrtree: a pointer to the created data structure
+%   ptrtree: uint64 handle to the created data structure, pass it to
+%            KNNSearch, RadiusSearch and finally DeleteGLTree
 %
 %
 % GENERAL INFORMATIONS
@@ -16,11 +17,11 @@
 %     - GLTree is an exact method no approximation is done. If you find a
 %      different value from the expected this means you found a bug so please
 %      send a report to the author.
-%     - GLTree works on double precision so these must be double vectors.
-%     - GLTree do not support 3D points.
-%     - The Data structure will be computed in linear time with the number of points.
-%     - GLTree is faster on uniformly random data. On sparse ones should work
-%      properly but may be  slower
+%     - The tree works in the precision of p, single halves the memory.
+%     - The tree keeps its own copy of the points, p may be cleared.
+%     - Points of any dimension are supported, the tree splits at the median
+%      of the widest dimension so it does not depend on uniform data.
+%     - Compile with OpenMP (see TestMexFiles) to build and search in parallel.
 %
 %
 %For question, suggestion, bug reports
@@ -1,55 +1,18 @@
 #include "mex.h"
-#include "GLTree.cpp"
+#include "KDTreeMex.h"
 /* the gateway function */
 //la chiamata deve essere DeleteGLtree(Tree)
 
-void mexFunction( int nlhs,const mxArray *plhs[], 
-        int nrhs, const mxArray *prhs[1]) {
-    
-    
-    //dichiarazione variabili
-    GLTREE* Tree;
-    double *ptrtree;
-    
-    
-    
-     if(nrhs!=1){ mexErrMsgTxt("Only one input supported.");}
-    
-    
-    
-    
-    ptrtree = mxGetPr(prhs[0]);//puntatore all'albero precedentemente fornito
-    
-    
-    Tree=(GLTREE*)((long)(ptrtree[0]));//ritrasformo il puntatore passato
-    
-    if(Tree==NULL)
-    { mexErrMsgTxt("Invalid tree pointer");
-    }
-    
-    
-    //chiamo il distruttore
-    
-     delete Tree;
-//    Tree.~GLTREE();
-    
-   
-   
-    
-    
-    
-    
-    
-    //trying to remake it a tree pointer
-    // verifico se la conversione riporta al puntatore originario
-    //ptr=(GLTREE*)(long(ptrtree[0]));
-    // mexPrintf("puntatore= %4.4x\n",ptr);
-    
-    
-    
-}
-
+void mexFunction( int nlhs, mxArray *plhs[],
+        int nrhs, const mxArray *prhs[]) {
 
+    KDTreeBase* Tree;
 
+    if(nrhs!=1){ mexErrMsgTxt("Only one input supported.");}
 
+    //validates the handle, a tree deleted twice is reported instead of freed again
+    Tree = ReleaseKDTreeHandle(prhs[0]);
 
+    //chiamo il distruttore
+    delete Tree;
+}
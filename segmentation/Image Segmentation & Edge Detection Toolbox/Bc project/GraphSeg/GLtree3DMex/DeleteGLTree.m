@@ -4,10 +4,9 @@
 % DeleteGLTree(ptrtree);
 %
 % INPUT PARAMETERS
-%       ptrtree: a pointer to the previously constructed  GLtree.Warning
-%                if the pointer is uncorrect it will cause a crash, there is
-%                no way to check this in the mex routine, you have to check
-%                yourself in your script.
+%       ptrtree: the uint64 handle returned by BuildGLTree. Handles that
+%                were not made by BuildGLTree, or trees already deleted,
+%                raise an error.
 %     
 %
 % OUTPUT PARAMETERS
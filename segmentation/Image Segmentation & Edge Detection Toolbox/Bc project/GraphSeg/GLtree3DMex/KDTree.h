@@ -0,0 +1,379 @@
+//KDTree.h
+//Balanced k-d tree over N-D float or double points, replacing the 3-D
+//GLTree grid. The tree keeps its own copy of the points, permuted into
+//leaf order, so queries never touch the MATLAB reference array again.
+//Batched kNN and radius queries run over OpenMP threads, every thread
+//owning its own candidate buffer.
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define KDTREE_LEAFSIZE 16
+//subtrees with more points than this are built as separate OpenMP tasks
+#define KDTREE_TASKSIZE 65536
+//tasks need OpenMP 3.0, MSVC /openmp (2.0) builds the tree serially
+#if defined(_OPENMP) && _OPENMP >= 200805
+#define KDTREE_TASKS
+#endif
+
+//Common part of every tree, used by the mex gateways to find out the
+//point class before casting to the typed tree.
+class KDTreeBase
+{
+public:
+    KDTreeBase(int classID, int dim, int n) : m_classID(classID), m_dim(dim), m_n(n) {}
+    virtual ~KDTreeBase() {}
+    int ClassID() const { return m_classID; }
+    int Dim() const { return m_dim; }
+    int NumPoints() const { return m_n; }
+protected:
+    int m_classID;
+    int m_dim;
+    int m_n;
+};
+
+template<class T>
+struct KDNode
+{
+    int dim;        //split dimension, -1 for a leaf
+    T split;        //split value, points with x[dim]<=split go left
+    int begin, end; //range of permuted points below this node
+    int right;      //index of the right child, the left one is this+1
+};
+
+//Fixed size max-heap holding the k best candidates of one query.
+template<class T>
+class KDKBest
+{
+public:
+    void Reset(int k)
+    {
+        m_k = k; m_n = 0;
+        m_d.resize(k); m_id.resize(k);
+    }
+    T Worst() const { return (m_n<m_k) ? (T)HUGE_VAL : m_d[0]; }
+    void Push(T d, int id)
+    {
+        int i, c;
+        if(m_n<m_k)
+        {
+            //sift up
+            i = m_n++;
+            while(i>0 && m_d[(i-1)/2]<d)
+            {
+                m_d[i] = m_d[(i-1)/2]; m_id[i] = m_id[(i-1)/2];
+                i = (i-1)/2;
+            }
+            m_d[i] = d; m_id[i] = id;
+            return;
+        }
+        if(d>=m_d[0]) return;
+        //replace the root and sift down
+        i = 0;
+        for(;;)
+        {
+            c = 2*i+1;
+            if(c>=m_n) break;
+            if(c+1<m_n && m_d[c+1]>m_d[c]) c++;
+            if(m_d[c]<=d) break;
+            m_d[i] = m_d[c]; m_id[i] = m_id[c];
+            i = c;
+        }
+        m_d[i] = d; m_id[i] = id;
+    }
+    //Empty the heap into d/id, farthest first (the order of GLTree)
+    int Drain(T *d, int *id)
+    {
+        int n = m_n, cnt = m_n, i, c;
+        T dl; int il;
+        while(m_n>0)
+        {
+            d[cnt-m_n] = m_d[0]; id[cnt-m_n] = m_id[0];
+            m_n--;
+            dl = m_d[m_n]; il = m_id[m_n];
+            i = 0;
+            for(;;)
+            {
+                c = 2*i+1;
+                if(c>=m_n) break;
+                if(c+1<m_n && m_d[c+1]>m_d[c]) c++;
+                if(m_d[c]<=dl) break;
+                m_d[i] = m_d[c]; m_id[i] = m_id[c];
+                i = c;
+            }
+            if(m_n>0) { m_d[i] = dl; m_id[i] = il; }
+        }
+        return n;
+    }
+private:
+    int m_k, m_n;
+    std::vector<T> m_d;
+    std::vector<int> m_id;
+};
+
+template<class T>
+class KDTree : public KDTreeBase
+{
+public:
+    //p: n points of dimension dim, column major (n x dim) as MATLAB stores them
+    KDTree(const T *p, int n, int dim, int classID);
+
+    //Squared distance k nearest neighbours of nq column major queries.
+    //idx/dist are nq x k column major, farthest first, zero based ids.
+    //Queries with q==NULL are the tree points themselves (kNN graph).
+    void KNearest(const T *q, int nq, int k, int *idx, T *dist) const;
+
+    //All points within radius r of each query, zero based. Results are
+    //grouped by query and sorted by distance within a query.
+    void Radius(const T *q, int nq, T r, std::vector<int> &qid, std::vector<int> &idx, std::vector<T> &dist) const;
+
+private:
+    int NodeCount(int m) const { return (m<=KDTREE_LEAFSIZE) ? 1 : 1+NodeCount(m/2)+NodeCount(m-m/2); }
+    void Build(int node, int begin, int end, const T *p, int n);
+    void SearchK(int node, const T *x, KDKBest<T> &best) const;
+    void SearchR(int node, const T *x, T r2, std::vector<std::pair<T,int> > &hits) const;
+    T Dist2(const T *a, const T *b) const
+    {
+        T d = 0, t;
+        for(int j=0; j<m_dim; j++) { t = a[j]-b[j]; d += t*t; }
+        return d;
+    }
+    //copy query i (column major, nq rows) or tree point i into x
+    void GetQuery(const T *q, int nq, int i, T *x) const
+    {
+        int j;
+        if(q==NULL) { for(j=0; j<m_dim; j++) x[j] = m_pts[(size_t)m_iperm[i]*m_dim+j]; }
+        else { for(j=0; j<m_dim; j++) x[j] = q[i+(size_t)nq*j]; }
+    }
+
+    std::vector<KDNode<T> > m_nodes;
+    std::vector<int> m_perm;    //permuted position -> original point id
+    std::vector<int> m_iperm;   //original point id -> permuted position
+    std::vector<T> m_pts;       //points in permuted order, row major
+};
+
+template<class T>
+KDTree<T>::KDTree(const T *p, int n, int dim, int classID) : KDTreeBase(classID, dim, n)
+{
+    int i, j;
+    m_perm.resize(n);
+    for(i=0; i<n; i++) m_perm[i] = i;
+    m_nodes.resize(n>0 ? NodeCount(n) : 0);
+    if(n>0)
+    {
+#ifdef KDTREE_TASKS
+        #pragma omp parallel
+        {
+            #pragma omp single
+            Build(0, 0, n, p, n);
+        }
+#else
+        Build(0, 0, n, p, n);
+#endif
+    }
+    m_pts.resize((size_t)n*dim);
+    m_iperm.resize(n);
+#ifdef _OPENMP
+    #pragma omp parallel for private(j)
+#endif
+    for(i=0; i<n; i++)
+    {
+        m_iperm[m_perm[i]] = i;
+        for(j=0; j<dim; j++) m_pts[(size_t)i*dim+j] = p[m_perm[i]+(size_t)n*j];
+    }
+}
+
+template<class T>
+struct KDLess
+{
+    const T *p; size_t off;
+    bool operator()(int a, int b) const { return p[a+off]<p[b+off]; }
+};
+
+template<class T>
+void KDTree<T>::Build(int node, int begin, int end, const T *p, int n)
+{
+    KDNode<T> &nd = m_nodes[node];
+    int m = end-begin, mid, i, j, best;
+    T lo, hi, v, spread, bestspread;
+    nd.begin = begin; nd.end = end;
+    if(m<=KDTREE_LEAFSIZE)
+    {
+        nd.dim = -1; nd.split = 0; nd.right = -1;
+        return;
+    }
+    //split on the dimension with the largest spread, at the median
+    best = 0; bestspread = -1;
+    for(j=0; j<m_dim; j++)
+    {
+        lo = hi = p[m_perm[begin]+(size_t)n*j];
+        for(i=begin+1; i<end; i++)
+        {
+            v = p[m_perm[i]+(size_t)n*j];
+            if(v<lo) lo = v; else if(v>hi) hi = v;
+        }
+        spread = hi-lo;
+        if(spread>bestspread) { bestspread = spread; best = j; }
+    }
+    mid = begin+m/2;
+    KDLess<T> cmp; cmp.p = p; cmp.off = (size_t)n*best;
+    std::nth_element(m_perm.begin()+begin, m_perm.begin()+mid, m_perm.begin()+end, cmp);
+    nd.dim = best;
+    nd.split = p[m_perm[mid]+(size_t)n*best];
+    //the median goes right, so everything left is <= split
+    nd.right = node+1+NodeCount(m/2);
+    int right = nd.right;
+#ifdef KDTREE_TASKS
+    if(m>KDTREE_TASKSIZE)
+    {
+        #pragma omp task
+        Build(node+1, begin, mid, p, n);
+        #pragma omp task
+        Build(right, mid, end, p, n);
+        #pragma omp taskwait
+        return;
+    }
+#endif
+    Build(node+1, begin, mid, p, n);
+    Build(right, mid, end, p, n);
+}
+
+template<class T>
+void KDTree<T>::SearchK(int node, const T *x, KDKBest<T> &best) const
+{
+    const KDNode<T> &nd = m_nodes[node];
+    int i;
+    if(nd.dim<0)
+    {
+        for(i=nd.begin; i<nd.end; i++)
+        {
+            best.Push(Dist2(&m_pts[(size_t)i*m_dim], x), m_perm[i]);
+        }
+        return;
+    }
+    T diff = x[nd.dim]-nd.split;
+    if(diff<=0)
+    {
+        SearchK(node+1, x, best);
+        if(diff*diff<best.Worst()) SearchK(nd.right, x, best);
+    }
+    else
+    {
+        SearchK(nd.right, x, best);
+        if(diff*diff<best.Worst()) SearchK(node+1, x, best);
+    }
+}
+
+template<class T>
+void KDTree<T>::SearchR(int node, const T *x, T r2, std::vector<std::pair<T,int> > &hits) const
+{
+    const KDNode<T> &nd = m_nodes[node];
+    int i;
+    T d;
+    if(nd.dim<0)
+    {
+        for(i=nd.begin; i<nd.end; i++)
+        {
+            d = Dist2(&m_pts[(size_t)i*m_dim], x);
+            if(d<=r2) hits.push_back(std::pair<T,int>(d, m_perm[i]));
+        }
+        return;
+    }
+    T diff = x[nd.dim]-nd.split;
+    if(diff<=0 || diff*diff<=r2) SearchR(node+1, x, r2, hits);
+    if(diff>0 || diff*diff<=r2) SearchR(nd.right, x, r2, hits);
+}
+
+template<class T>
+void KDTree<T>::KNearest(const T *q, int nq, int k, int *idx, T *dist) const
+{
+    if(m_n==0 || k<=0) return;
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+        KDKBest<T> best;
+        std::vector<T> x(m_dim), d(k);
+        std::vector<int> id(k);
+        int i, j;
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 256)
+#endif
+        for(int s=0; s<nq; s++)
+        {
+            //the tree points are visited in leaf order, so neighbouring
+            //queries walk the same part of the tree
+            if(q==NULL) { i = m_perm[s]; std::copy(&m_pts[(size_t)s*m_dim], &m_pts[(size_t)s*m_dim]+m_dim, x.begin()); }
+            else { i = s; GetQuery(q, nq, i, &x[0]); }
+            best.Reset(k);
+            SearchK(0, &x[0], best);
+            best.Drain(&d[0], &id[0]);
+            for(j=0; j<k; j++)
+            {
+                idx[i+(size_t)nq*j] = id[j];
+                dist[i+(size_t)nq*j] = d[j];
+            }
+        }
+    }
+}
+
+template<class T>
+void KDTree<T>::Radius(const T *q, int nq, T r, std::vector<int> &qid, std::vector<int> &idx, std::vector<T> &dist) const
+{
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    //every thread answers one contiguous block of queries into its own
+    //buffers, so concatenating the buffers keeps the results query ordered
+    std::vector<std::vector<int> > tqid(nthreads), tidx(nthreads);
+    std::vector<std::vector<T> > tdist(nthreads);
+    qid.clear(); idx.clear(); dist.clear();
+    if(m_n==0) return;
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(nthreads)
+#endif
+    {
+        int t = 0, nt = 1, i;
+        size_t h;
+#ifdef _OPENMP
+        t = omp_get_thread_num(); nt = omp_get_num_threads();
+#endif
+        std::vector<T> x(m_dim);
+        std::vector<std::pair<T,int> > hits;
+        int first = (int)(((long long)nq*t)/nt), last = (int)(((long long)nq*(t+1))/nt);
+        for(i=first; i<last; i++)
+        {
+            GetQuery(q, nq, i, &x[0]);
+            hits.clear();
+            SearchR(0, &x[0], r*r, hits);
+            std::sort(hits.begin(), hits.end());
+            for(h=0; h<hits.size(); h++)
+            {
+                tqid[t].push_back(i);
+                tidx[t].push_back(hits[h].second);
+                tdist[t].push_back(hits[h].first);
+            }
+        }
+    }
+    size_t total = 0, off;
+    int t;
+    for(t=0; t<nthreads; t++) total += tqid[t].size();
+    qid.resize(total); idx.resize(total); dist.resize(total);
+    for(t=0, off=0; t<nthreads; t++)
+    {
+        std::copy(tqid[t].begin(), tqid[t].end(), qid.begin()+off);
+        std::copy(tidx[t].begin(), tidx[t].end(), idx.begin()+off);
+        std::copy(tdist[t].begin(), tdist[t].end(), dist.begin()+off);
+        off += tqid[t].size();
+    }
+}
+
+#endif
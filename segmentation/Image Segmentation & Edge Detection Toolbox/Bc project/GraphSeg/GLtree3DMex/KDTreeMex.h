@@ -0,0 +1,133 @@
+//KDTreeMex.h
+//Handle helpers shared by BuildGLTree, KNNSearch, RadiusSearch and
+//DeleteGLTree. The tree pointer travels to MATLAB in a uint64 scalar,
+//never through a double. The handles of the live trees are listed in
+//the root appdata, which the four mex files share, and a handle is only
+//dereferenced once it is found in that list.
+#ifndef KDTREEMEX_H
+#define KDTREEMEX_H
+
+#include "mex.h"
+#include "KDTree.h"
+
+typedef unsigned long long KDTreeHandle;
+
+#define KDTREE_APPDATA "GLTreeHandles"
+
+//uint64 row of the live handles, or [] if no tree was built yet
+mxArray* GetKDTreeList()
+{
+    mxArray *in[2], *list;
+    in[0] = mxCreateDoubleScalar(0);
+    in[1] = mxCreateString(KDTREE_APPDATA);
+    mexCallMATLAB(1, &list, 2, in, "getappdata");
+    mxDestroyArray(in[0]);
+    mxDestroyArray(in[1]);
+    return list;
+}
+
+//Store the list of live handles and destroy it
+void SetKDTreeList(mxArray *list)
+{
+    mxArray *in[3];
+    in[0] = mxCreateDoubleScalar(0);
+    in[1] = mxCreateString(KDTREE_APPDATA);
+    in[2] = list;
+    mexCallMATLAB(0, NULL, 3, in, "setappdata");
+    mxDestroyArray(in[0]);
+    mxDestroyArray(in[1]);
+    mxDestroyArray(list);
+}
+
+//Copy the live handles to a new list, leaving out h, and appending it
+//when add is set
+void UpdateKDTreeList(KDTreeHandle h, bool add)
+{
+    mxArray *list = GetKDTreeList(), *out;
+    size_t i, j = 0, n = (mxGetClassID(list)==mxUINT64_CLASS) ? mxGetNumberOfElements(list) : 0;
+    const KDTreeHandle *src = (const KDTreeHandle*)mxGetData(list);
+    KDTreeHandle *dst;
+    out = mxCreateNumericMatrix(1, n+1, mxUINT64_CLASS, mxREAL);
+    dst = (KDTreeHandle*)mxGetData(out);
+    for(i=0; i<n; i++)
+        if(src[i]!=h) dst[j++] = src[i];
+    if(add) dst[j++] = h;
+    mxSetN(out, j);
+    mxDestroyArray(list);
+    SetKDTreeList(out);
+}
+
+bool IsLiveKDTree(KDTreeHandle h)
+{
+    mxArray *list = GetKDTreeList();
+    size_t i, n = (mxGetClassID(list)==mxUINT64_CLASS) ? mxGetNumberOfElements(list) : 0;
+    const KDTreeHandle *src = (const KDTreeHandle*)mxGetData(list);
+    bool live = false;
+    for(i=0; i<n && !live; i++)
+        live = (src[i]==h);
+    mxDestroyArray(list);
+    return live;
+}
+
+mxArray* CreateKDTreeHandle(KDTreeBase *tree)
+{
+    mxArray *h = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+    *(KDTreeHandle*)mxGetData(h) = (KDTreeHandle)(size_t)tree;
+    UpdateKDTreeList((KDTreeHandle)(size_t)tree, true);
+    return h;
+}
+
+KDTreeBase* GetKDTreeHandle(const mxArray *x)
+{
+    KDTreeHandle h;
+    if(mxGetNumberOfElements(x)!=1 || mxGetClassID(x)!=mxUINT64_CLASS)
+        mexErrMsgTxt("Tree handle must be the uint64 scalar returned by BuildGLTree");
+    h = *(KDTreeHandle*)mxGetData(x);
+    if(h==0 || !IsLiveKDTree(h))
+        mexErrMsgTxt("Invalid tree handle, the tree does not exist or was deleted");
+    return (KDTreeBase*)(size_t)h;
+}
+
+//Validate the handle and remove it from the live trees, the caller
+//deletes the returned tree
+KDTreeBase* ReleaseKDTreeHandle(const mxArray *x)
+{
+    KDTreeBase *tree = GetKDTreeHandle(x);
+    UpdateKDTreeList((KDTreeHandle)(size_t)tree, false);
+    return tree;
+}
+
+//Return a [n x dim] query array in the class of the tree, converting
+//when needed. *tmp is set when the caller must mxDestroyArray it.
+mxArray* GetKDTreeQueries(const mxArray *q, KDTreeBase *tree, bool *tmp)
+{
+    mxArray *out;
+    size_t i, n;
+    *tmp = false;
+    if(!mxIsDouble(q) && !mxIsSingle(q))
+        mexErrMsgTxt("Query points must be single or double");
+    if(mxIsComplex(q) || mxGetNumberOfDimensions(q)!=2)
+        mexErrMsgTxt("Query points must be a real [Nq x dim] array");
+    if((int)mxGetN(q)!=tree->Dim())
+        mexErrMsgTxt("Query points must have the dimension of the tree points");
+    if(mxGetClassID(q)==(mxClassID)tree->ClassID())
+        return (mxArray*)q;
+    n = mxGetNumberOfElements(q);
+    out = mxCreateNumericMatrix(mxGetM(q), mxGetN(q), (mxClassID)tree->ClassID(), mxREAL);
+    if(mxIsDouble(q))
+    {
+        const double *src = (const double*)mxGetData(q);
+        float *dst = (float*)mxGetData(out);
+        for(i=0; i<n; i++) dst[i] = (float)src[i];
+    }
+    else
+    {
+        const float *src = (const float*)mxGetData(q);
+        double *dst = (double*)mxGetData(out);
+        for(i=0; i<n; i++) dst[i] = (double)src[i];
+    }
+    *tmp = true;
+    return out;
+}
+
+#endif
@@ -1,20 +1,21 @@
-% KNNSearch query a GL-tree for k nearest neighbor(kNN)
+% KNNSearch query a k-d tree for k nearest neighbor(kNN)
 %
 % SYNTAX
 %
-% [kNNG]=KNNSearch(,qp,ptrtree,k);       short
+% [kNNG]=KNNSearch(p,qp,ptrtree,k);       short
 % [kNNG,Dist]=KNNSearch(p,qp,ptrtree,k);  long
+% [kNNG,Dist]=KNNSearch([],[],ptrtree,k); kNN graph of the reference points
 %
 % INPUT PARAMETERS
 % 
-%       p: [Nx3] double array coordinates of reference points
+%       p: [Nxdim] reference points, kept for compatibility and not used,
+%          the tree holds its own copy. May be [].
 % 
-%       qp: [Nqx3] double array coordinates of query points
+%       qp: [Nqxdim] single or double array coordinates of query points.
+%           [] queries every reference point against the tree, which is
+%           the kNN graph (each point is its own nearest neighbour).
 %
-%       ptrtree: a pointer to the previously constructed  GLtree.Warning
-%                if the pointer is uncorrect it will cause a crash, there is
-%                no way to check this in the mex routine, you have to check
-%                yourself in your script.
+%       ptrtree: the uint64 handle returned by BuildGLTree.
 %
 %       k: number of neighbors
 %
@@ -23,6 +24,7 @@
 %      kNNG: [Nqxk] array, each rows contains the kNN indexes
 %            So in row one there are kNN to first query
 %           point, in row two to the second etc...
+%           The nearest neighbour is in the last column.
 % 
 %      Dist: [Nqxk] array, Facultative output, each rows contains the
 %                   distance values of the  found kNN.
@@ -33,7 +35,8 @@
 % GENERAL INFORMATIONS
 %
 %         -This function is faster if all query points are given once
-%         instead of looping and pass one point each loop.
+%         instead of looping and pass one point each loop, the queries
+%         are shared among the OpenMP threads.
 %
 %
 %  For question, suggestion, bug reports
@@ -0,0 +1,81 @@
+#include "mex.h"
+#include <math.h>
+#include "KDTreeMex.h"
+
+/* the gateway function */
+// In matlab la funzione deve essere
+//[qid,idc,dist]=RadiusSearch(qp,ptrtree,r)
+//qp=[] queries the reference points themselves.
+
+template<class T>
+void RunSearch(KDTreeBase *base, const mxArray *q, double r, int nlhs, mxArray *plhs[])
+{
+    const KDTree<T> *Tree = static_cast<const KDTree<T>*>(base);
+    const T *qp = NULL;
+    int Nq;
+    size_t i, n;
+    bool tmp = false;
+    mxArray *qa = NULL;
+    std::vector<int> qid, idc;
+    std::vector<T> distances;
+
+    if(q==NULL)
+        Nq = Tree->NumPoints();
+    else
+    {
+        qa = GetKDTreeQueries(q, base, &tmp);
+        qp = (const T*)mxGetData(qa);
+        Nq = (int)mxGetM(qa);
+    }
+
+    //Run all the queries
+    Tree->Radius(qp, Nq, (T)r, qid, idc, distances);
+    if(tmp) mxDestroyArray(qa);
+
+    n = qid.size();
+    plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+    double *out = mxGetPr(plhs[0]);
+    for (i=0; i<n; i++) out[i] = qid[i]+1;//convert to matlab notation
+    if (nlhs>1)
+    {
+        plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        out = mxGetPr(plhs[1]);
+        for (i=0; i<n; i++) out[i] = idc[i]+1;
+    }
+    if (nlhs>2)
+    {
+        plhs[2] = mxCreateDoubleMatrix(n, 1, mxREAL);
+        out = mxGetPr(plhs[2]);
+        for (i=0; i<n; i++) out[i] = sqrt((double)distances[i]);
+    }
+}
+
+void mexFunction( int nlhs, mxArray *plhs[],
+int nrhs,  const mxArray *prhs[])
+{
+    KDTreeBase *Tree;
+    const mxArray *q;
+    double r;
+
+    // Errors check
+    if(nrhs!=3)
+        mexErrMsgTxt("Three inputs required.");
+
+    if(nlhs>3)
+        mexErrMsgTxt("Maximum three outputs supported");
+
+    Tree = GetKDTreeHandle(prhs[1]);
+
+    if(mxGetNumberOfElements(prhs[2])!=1 || !mxIsNumeric(prhs[2]))
+        mexErrMsgTxt("r must be a scalar");
+    r = mxGetScalar(prhs[2]);
+    if (!(r>=0))
+        mexErrMsgTxt("r must be non negative");
+
+    q = mxIsEmpty(prhs[0]) ? NULL : prhs[0];
+
+    if(Tree->ClassID()==mxSINGLE_CLASS)
+        RunSearch<float>(Tree, q, r, nlhs, plhs);
+    else
+        RunSearch<double>(Tree, q, r, nlhs, plhs);
+}
@@ -0,0 +1,44 @@
+% RadiusSearch query a k-d tree for all the points within a radius
+%
+% SYNTAX
+%
+% [qid,idc,Dist]=RadiusSearch(qp,ptrtree,r);
+% [qid,idc,Dist]=RadiusSearch([],ptrtree,r);  radius graph of the reference points
+%
+% INPUT PARAMETERS
+%
+%       qp: [Nqxdim] single or double array coordinates of query points,
+%           [] queries every reference point against the tree.
+%
+%       ptrtree: the uint64 handle returned by BuildGLTree.
+%
+%       r: search radius, points at distance <= r are returned
+%
+% OUTPUT PARAMETERS
+%
+%      qid: [Mx1] index of the query point of each pair
+%
+%      idc: [Mx1] index of the reference point of each pair
+%
+%      Dist: [Mx1] distance between the two points
+%
+%      The pairs are grouped by query and sorted by distance inside each
+%      query, sparse(qid,idc,Dist) gives the radius graph as a matrix.
+%
+%
+% GENERAL INFORMATIONS
+%
+%         -This function is faster if all query points are given once
+%         instead of looping and pass one point each loop, the queries
+%         are shared among the OpenMP threads.
+%
+%
+%  For question, suggestion, bug reports
+%  giaccariluigi@msn.com
+% 
+% Visit my website:
+% http://giaccariluigi.altervista.org/blog/
+%
+%  Author : Luigi Giaccari
+%  Last Update: 2/1/2009
+%  Created : 8/8/2008
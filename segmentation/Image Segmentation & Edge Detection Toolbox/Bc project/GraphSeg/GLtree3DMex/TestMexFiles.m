@@ -9,12 +9,27 @@ close all
 %% Compile
 fprintf('COMPILING:\n')
  
-mex BuildGLTree.cpp
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" BuildGLTree.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" BuildGLTree.cpp
+end
 fprintf('\tBuildGLTree : mex succesfully completed.\n') 
 
-mex KNNSearch.cpp
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" KNNSearch.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" KNNSearch.cpp
+end
 fprintf('\tKNNSearch : mex succesfully completed.\n') 
 
+if ispc
+    mex COMPFLAGS="$COMPFLAGS /openmp" RadiusSearch.cpp
+else
+    mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" RadiusSearch.cpp
+end
+fprintf('\tRadiusSearch : mex succesfully completed.\n') 
+
 mex DeleteGLTree.cpp
 fprintf('\tDeleteGLTree : mex succesfully completed.\n\n') 
 
@@ -37,7 +52,7 @@ fprintf('RANDOM POINTS GENERATED\n\n')
 fprintf('BUILDING THE DATA STRUCTURE:\n')
 tic
 ptrtree=BuildGLTree(p);
-fprintf('\tGLTree built in %4.4f s\n\treturned pointer %4.0f:\n\n',toc,ptrtree);
+fprintf('\tGLTree built in %4.4f s\n\treturned handle %u:\n\n',toc,ptrtree);
 
 
 % 
@@ -16,22 +16,15 @@ function [knng, knng_dist] = knng_search(img, numOnns)
 height = size(img, 1);
 width = size(img, 2);
 numOpixels = height*width;
-Ref_set = zeros(numOpixels, 3);
-Ref_idx=1;
-for x=1:width
-    for y=1:height
-        gray = img(y, x);
-        Ref_set(Ref_idx, :)=[x, y, gray];
-        Ref_idx = Ref_idx+1;
-    end
-end
+%feature points in column major pixel order, [x, y, gray] per row
+[Y, X] = ndgrid(1:height, 1:width);
+Ref_set = [X(:), Y(:), reshape(img(:, :, 1), numOpixels, 1)];
 
 Ref_set(:, 1)=Ref_set(:, 1)/width;
 Ref_set(:, 2)=Ref_set(:, 2)/height;
-Query_set = Ref_set;
-%begin knn search:
+%begin knn search, the empty query set asks for the kNN graph of Ref_set:
 pTree = BuildGLTree(Ref_set);
-[knng, knng_dist] = KNNSearch(Ref_set, Query_set, pTree, numOnns);
+[knng, knng_dist] = KNNSearch([], [], pTree, numOnns);
 %#debug:
 %min(knng_dist)
 knng = knng-1;
@@ -23,20 +23,28 @@
 %For the fast implementation of K-NEAREST NEIGHBORS SEARCH in 3D.
 
 % add all needed function paths
-addpath .\coherenceFilter
-addpath .\GLtree3DMex
+addpath(fullfile('.', 'coherenceFilter'))
+addpath(fullfile('.', 'GLtree3DMex'))
 %% Compile
 fprintf('COMPILING:\n')
 mex GraphSeg_mex.cpp
 fprintf('\tGraphSeg_mex.cpp: mex succesfully completed.\n') 
 
-mex .\GLtree3DMex\BuildGLTree.cpp
+if ispc
+    mex('COMPFLAGS="$COMPFLAGS /openmp"', fullfile('GLtree3DMex', 'BuildGLTree.cpp'))
+else
+    mex('CXXFLAGS="$CXXFLAGS -fopenmp"', 'LDFLAGS="$LDFLAGS -fopenmp"', fullfile('GLtree3DMex', 'BuildGLTree.cpp'))
+end
 fprintf('\tBuildGLTree : mex succesfully completed.\n') 
 
-mex .\GLtree3DMex\KNNSearch.cpp
+if ispc
+    mex('COMPFLAGS="$COMPFLAGS /openmp"', fullfile('GLtree3DMex', 'KNNSearch.cpp'))
+else
+    mex('CXXFLAGS="$CXXFLAGS -fopenmp"', 'LDFLAGS="$LDFLAGS -fopenmp"', fullfile('GLtree3DMex', 'KNNSearch.cpp'))
+end
 fprintf('\tKNNSearch : mex succesfully completed.\n') 
 
-mex .\GLtree3DMex\DeleteGLTree.cpp
+mex(fullfile('GLtree3DMex', 'DeleteGLTree.cpp'))
 fprintf('\tDeleteGLTree : mex succesfully completed.\n\n') 
 %end of Complie#
 %load an gray image:
@@ -6,11 +6,39 @@
 // *** wrapper file 'RegionGrowing.m' for details on its usage.
 // ***
 // *** Compile this file by making the directiory containing this file
-// *** your current Matlab working directory and typing 
+// *** your current Matlab working directory and typing
 // ***
 // *** >> mex RegionGrowing_mex.cpp
 // ***
-// *** in the Matlab console.
+// *** in the Matlab console. The multi-seed mode runs in parallel if
+// *** compiled with OpenMP, e.g.
+// ***
+// *** >> mex CXXFLAGS="\$CXXFLAGS -fopenmp" LDFLAGS="\$LDFLAGS -fopenmp" RegionGrowing_mex.cpp
+// ***
+// *** Usage:
+// ***
+// ***   lMask = RegionGrowing_mex(dImg, iSeed, dMaxDif[, fDraw])
+// ***
+// *** Grows a region from the seed, see RegionGrowing.m.
+// ***
+// ***   hRG   = RegionGrowing_mex('open', dImg)
+// ***   lMask = RegionGrowing_mex(hRG, dImg, iSeed, dMaxDif[, fDraw])
+// ***           RegionGrowing_mex('close', hRG)
+// ***
+// *** The same with a handle which caches the neighbourhood and the
+// *** dynamic range of the image, for repeated (interactive) seeds on the
+// *** same image. Then the cost of a call only depends on the size of the
+// *** region, not on the size of the image. dImg must be the image the
+// *** handle was opened with.
+// ***
+// ***   lLabel = RegionGrowing_mex([hRG, ]dImg, iSeeds, dMaxDif)
+// ***
+// *** With several seeds (iSeeds is ndims x N), all seeds are flooded at
+// *** once: neighbouring voxels are connected if their intensities differ
+// *** less than dMaxDif, the connected components are found by a
+// *** concurrent union-find over the whole image, and lLabel (uint32) is
+// *** the number of the first seed in the component of each voxel (0 if
+// *** none).
 // ***
 // *** Copyright 2013 Christian Wuerslin, University of Tuebingen and
 // *** University of Stuttgart, Germany.
@@ -19,20 +47,20 @@
 // ========================================================================
 
 #include "mex.h"
-#include <queue>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
 #include <cmath>
 
 #define UPDATECYCLE3D     50000
 #define UPDATECYCLE2D      1000
 #define NQUEUES             100	// number of FIFO queues
+#define NHANDLES             32	// number of cached images
+#define CANDIDATE          0x40	// flag of a voxel which has been queued
 
 using namespace std;
 
-long             lNZ, lNX, lNY;     // The image dimensions;
-double           dMaxDif, dRegMean;
-double          *pdImg;             // pointer to the image
-queue<long>     *aqQueue;			// vector of FIFO queues
-
 // ========================================================================
 // Inline function to determin minimum of two numbers
 inline double ifMin(double a, double b)
@@ -55,67 +83,74 @@ inline double ifMax(double a, double b)
 
 // ========================================================================
 // ***
-// *** FUNCTION fPop
+// *** CLASS CRingQueue
 // ***
-// *** Function that pops a voxel location from the highest priority
-// *** non-empty queue which fulfills the region growing criterion.
+// *** FIFO queue of voxel indices in one flat ring buffer, which grows
+// *** by doubling and keeps its memory between calls.
 // ***
 // ========================================================================
-long fPop() {
-	long lInd; // Index of the voxel
-    
-    // --------------------------------------------------------------------
-    // Loop over the queues, start with highest priority (0)
-    for (int iQueueInd = 0; iQueueInd < NQUEUES; iQueueInd++) {
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // While there are still entries in the queue, pop and determine
-        // whether it fullfills the region growing criterion.
-        while (!aqQueue[iQueueInd].empty()) {
-            lInd = aqQueue[iQueueInd].front();aqQueue[iQueueInd].pop();
-            if (fabs(dRegMean - pdImg[lInd]) < dMaxDif) return lInd;// Return if valid entry found
+class CRingQueue {
+public:
+    CRingQueue() : lHead(0), lCount(0) {}
+
+    bool empty() const { return lCount == 0; }
+    void clear() { lHead = 0; lCount = 0; }
+
+    void push(long lInd) {
+        long lCapacity = long(alBuffer.size());
+        if (lCount == lCapacity) {
+            // Unroll the ring into a buffer of twice the size
+            vector<long> alNew(lCapacity > 0 ? 2*lCapacity : 1024);
+            for (long lI = 0; lI < lCount; lI++)
+                alNew[lI] = alBuffer[(lHead + lI) % lCapacity];
+            alBuffer.swap(alNew);
+            lHead = 0;
+            lCapacity = long(alBuffer.size());
         }
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        long lTail = lHead + lCount;
+        if (lTail >= lCapacity) lTail -= lCapacity;
+        alBuffer[lTail] = lInd;
+        lCount++;
     }
-    // --------------------------------------------------------------------
-    
-	return -1; // if all queues are empty
-}
+
+    long pop() {
+        long lInd = alBuffer[lHead];
+        if (++lHead == long(alBuffer.size())) lHead = 0;
+        lCount--;
+        return lInd;
+    }
+
+private:
+    vector<long> alBuffer;
+    long         lHead, lCount;
+};
 // ========================================================================
-// *** END OF FUNCTION fPop
+// *** END OF CLASS CRingQueue
 // ========================================================================
 
 
 
 // ========================================================================
 // ***
-// *** FUNCTION fGetNHood
+// *** STRUCT SRegionGrowing
 // ***
-// *** Get the 4-/6-neighbourhood of voxel lLinInd
+// *** The region growing engine of one image: the image dimensions, the
+// *** neighbour offsets, one byte per voxel with a bit for each neighbour
+// *** inside the image (and the candidate flag), the dynamic range and
+// *** the queues.
 // ***
 // ========================================================================
-void fGetNHood(const long lLinInd, long& lNHoodSize, long* lNHood) {
-	long lX, lY, lZ, lTemp;
-    
-    lNHoodSize = 0;
-    
-    lY = lLinInd % lNY; // get y coordinate, add +/-1 if in image range
-	if (lY >       0) lNHood[lNHoodSize++] = lLinInd - 1;
-	if (lY < lNY - 1) lNHood[lNHoodSize++] = lLinInd + 1;
-    
-	lTemp = lLinInd/lNY; // That is a floor() operation in c
-	lX = lTemp % lNX; // get x coordinate, add +/-1 if in image range. X increment is lNY
-	if (lX >       0) lNHood[lNHoodSize++] = lLinInd - lNY;
-	if (lX < lNX - 1) lNHood[lNHoodSize++] = lLinInd + lNY;
-    
-    if (lNZ > 1) { // 3D case
-        lZ = lTemp/lNX; // z coordinate, add +/-1 if in image range. Z increment is lNX*lNY
-        if (lZ >       0) lNHood[lNHoodSize++] = lLinInd - lNX*lNY;
-        if (lZ < lNZ - 1) lNHood[lNHoodSize++] = lLinInd + lNX*lNY;
-    }
-}
-// ========================================================================
-// *** END OF FUNCTION fGetNHood
+struct SRegionGrowing {
+    long                    lNY, lNX, lNZ, lImSize, lNDims;
+    long                    alOffset[6];
+    int                     iNOffsets;
+    double                  dMin, dMax;
+    vector<unsigned char>   aiNHood;
+    vector<long>            alTouched;  // voxels flagged as candidate
+    CRingQueue              aqQueue[NQUEUES];
+};
+
+SRegionGrowing *apRGHandles[NHANDLES];  // cached engines, see 'open'
 // ========================================================================
 
 
@@ -127,7 +162,7 @@ void fGetNHood(const long lLinInd, long& lNHoodSize, long* lNHood) {
 // *** Get the minimum and maximum value of an array
 // ***
 // ========================================================================
-void fGetMinMax(double *pdArray, long lLength, double &dMin, double &dMax)
+void fGetMinMax(const double *pdArray, long lLength, double &dMin, double &dMax)
 {
     dMax   = 0.0;
     dMin   = double(1e15);
@@ -145,129 +180,449 @@ void fGetMinMax(double *pdArray, long lLength, double &dMin, double &dMax)
 
 // ========================================================================
 // ***
-// *** MAIN MEX FUNCTION RegionGrowing_mex
+// *** FUNCTION fInitRegionGrowing
 // ***
-// *** See m-file for description
+// *** Set up the engine of an image: the 4-/6-neighbour offsets, and for
+// *** every voxel the bits of the neighbours inside the image range, thus
+// *** the neighbourhood of a voxel needs no division and modulo.
 // ***
 // ========================================================================
-void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+void fInitRegionGrowing(SRegionGrowing *pRG, const mxArray *pImg)
 {
-    // --------------------------------------------------------------------
-    // Check the number of the input and output arguments.
-    if(nrhs < 3)  mexErrMsgTxt("At least 3 input arguments required.");
-    if(nlhs != 1) mexErrMsgTxt("Exactly one ouput argument required.");
-    // --------------------------------------------------------------------
-    
-    // --------------------------------------------------------------------
-    // Get pointer/values to/of the input and outputs objects
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // 1st input: Image (get dimensions as well)
-    if (!mxIsDouble(prhs[0])) mexErrMsgTxt("First input argument must be of type double.");
-    pdImg = (double*) mxGetData(prhs[0]);
-    const int* pSize = mxGetDimensions(prhs[0]);
-    long lNDims = mxGetNumberOfDimensions(prhs[0]);
-    lNY = long(pSize[0]);
-	lNX = long(pSize[1]);
-    long lUpdateCycle;
-    if (lNDims == 3) {
-        lNZ = long(pSize[2]);
-        lUpdateCycle = UPDATECYCLE3D;
-    } else {
-        lNZ = 1;
-        lUpdateCycle = UPDATECYCLE2D;
-    }
-    
-    long    lImSize = lNX*lNY*lNZ;
-    
-    double  dMax, dMin;
-    fGetMinMax(pdImg, lImSize, dMin, dMax);
-    double  dDynamicRange = dMax - dMin;
-    
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // 2nd input: Seed point coordinates.
-    short *pSeed = (short*) mxGetPr(prhs[1]);
-    long lLinInd;
-    if (lNZ > 1)
-        lLinInd = long(pSeed[0]) - 1 + (long(pSeed[1]) - 1)*lNY + (long(pSeed[2]) - 1)*lNX*lNY;
-    else
-        lLinInd = long(pSeed[0]) - 1 + (long(pSeed[1]) - 1)*lNY;
-    
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // 3rd input: RG stoping difference.
-    dMaxDif = double(*mxGetPr(prhs[2]));
-    
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // Get pointer to output arguments and allocate memory for the corresponding objects
-    plhs[0] = mxCreateNumericArray(lNDims, pSize, mxLOGICAL_CLASS, mxREAL);	// create output array
-    bool *pbMask = (bool*) mxGetData(plhs[0]);						// get data pointer to mask
-        
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
-    // Create a parameter array for the call of the drawing function
-    mxArray *pParams[2];
-    bool bDraw = false;
-    if (nrhs > 3) {
-        pParams[0] = const_cast<mxArray *>(prhs[3]);
-        pParams[1] = const_cast<mxArray *>(plhs[0]);
-        bDraw = true;
+    const mwSize* pSize = mxGetDimensions(pImg);
+    pRG->lNDims = long(mxGetNumberOfDimensions(pImg));
+    pRG->lNY = long(pSize[0]);
+    pRG->lNX = long(pSize[1]);
+    pRG->lNZ = (pRG->lNDims == 3) ? long(pSize[2]) : 1;
+    pRG->lImSize = pRG->lNX*pRG->lNY*pRG->lNZ;
+
+    long lNY = pRG->lNY, lNX = pRG->lNX, lNZ = pRG->lNZ;
+    pRG->alOffset[0] = -1;       pRG->alOffset[1] = 1;
+    pRG->alOffset[2] = -lNY;     pRG->alOffset[3] = lNY;
+    pRG->alOffset[4] = -lNX*lNY; pRG->alOffset[5] = lNX*lNY;
+    pRG->iNOffsets = (lNZ > 1) ? 6 : 4;
+
+    pRG->aiNHood.resize(pRG->lImSize);
+    unsigned char *piNHood = &pRG->aiNHood[0];
+    for (long lZ = 0; lZ < lNZ; lZ++) {
+        unsigned char iZBits = 0;
+        if (lNZ > 1) {
+            if (lZ >       0) iZBits |= 0x10;
+            if (lZ < lNZ - 1) iZBits |= 0x20;
+        }
+        for (long lX = 0; lX < lNX; lX++) {
+            unsigned char iXBits = iZBits;
+            if (lX >       0) iXBits |= 0x04;
+            if (lX < lNX - 1) iXBits |= 0x08;
+            for (long lY = 0; lY < lNY; lY++) {
+                unsigned char iBits = iXBits;
+                if (lY >       0) iBits |= 0x01;
+                if (lY < lNY - 1) iBits |= 0x02;
+                *piNHood++ = iBits;
+            }
+        }
     }
 
-    // --------------------------------------------------------------------
-    // Start of the real functionality
-    
-    bool *pbCandidate = new bool [lNX * lNY * lNZ]();
-    aqQueue = new queue<long>[NQUEUES];
-    
-    long    lNHoodSize;
-    long    alNHood[6];
-    long    lInd;
+    fGetMinMax((const double*) mxGetData(pImg), pRG->lImSize, pRG->dMin, pRG->dMax);
+    pRG->alTouched.clear();
+}
+// ========================================================================
+// *** END OF FUNCTION fInitRegionGrowing
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTION fClearCandidates
+// ***
+// *** Empty the queues and clear only the candidate flags set since the
+// *** last call, so the engine is ready for the next seed.
+// ***
+// ========================================================================
+void fClearCandidates(SRegionGrowing *pRG)
+{
+    unsigned char *piNHood = &pRG->aiNHood[0];
+    vector<long>  &alTouched = pRG->alTouched;
+    for (int iQueueInd = 0; iQueueInd < NQUEUES; iQueueInd++) pRG->aqQueue[iQueueInd].clear();
+    for (size_t lI = 0; lI < alTouched.size(); lI++) piNHood[alTouched[lI]] &= ~CANDIDATE;
+    alTouched.clear();
+}
+// ========================================================================
+// *** END OF FUNCTION fClearCandidates
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTION fRegionGrow
+// ***
+// *** Grow the region of one seed. Voxels are popped from the highest
+// *** priority non-empty queue which fulfill the region growing criterion.
+// *** Afterwards the candidate flags are cleared, also if the drawing
+// *** function fails, so a cached engine stays valid.
+// ***
+// ========================================================================
+void fRegionGrow(SRegionGrowing *pRG, const double *pdImg, long lLinInd,
+                 double dMaxDif, bool *pbMask, mxArray **pParams)
+{
+    long    lImSize = pRG->lImSize;
+    long    lUpdateCycle = (pRG->lNZ > 1) ? UPDATECYCLE3D : UPDATECYCLE2D;
+    double  dDynamicRange = pRG->dMax - pRG->dMin;
+    unsigned char *piNHood = &pRG->aiNHood[0];
+    vector<long>  &alTouched = pRG->alTouched;
+    CRingQueue    *aqQueue = pRG->aqQueue;
+
     long    lRegSize = 1;
     long    lIterations = 0;
     long    lQueueInd;
-    
-    double  dDist;
+    int     iFirstQueue = NQUEUES; // queues before this one are empty
+
     double  dLastDif = 0.0;
-    
-    dRegMean = pdImg[lLinInd];
-    
+    double  dRegMean = pdImg[lLinInd];
+
     pbMask[lLinInd] = true;
-    pbCandidate[lLinInd] = true;
-    
+    piNHood[lLinInd] |= CANDIDATE;
+    alTouched.push_back(lLinInd);
+
     // --------------------------------------------------------------------
     while ((lRegSize < lImSize) && (dLastDif < dMaxDif)){
 
-        fGetNHood(lLinInd, lNHoodSize, alNHood);
-        for (int iI = 0; iI < lNHoodSize; iI++) {
-            lLinInd = alNHood[iI];
-            if (pbCandidate[lLinInd]) continue;
-            
-            pbCandidate[lLinInd] = true;
+        unsigned char iBits = piNHood[lLinInd];
+        long lCenter = lLinInd;
+        for (int iI = 0; iI < pRG->iNOffsets; iI++) {
+            if (!(iBits & (1 << iI))) continue;
+            lLinInd = lCenter + pRG->alOffset[iI];
+            if (piNHood[lLinInd] & CANDIDATE) continue;
+
+            piNHood[lLinInd] |= CANDIDATE;
+            alTouched.push_back(lLinInd);
             lQueueInd = long(fabs(pdImg[lLinInd] - dRegMean) / dDynamicRange * NQUEUES * 2);
             if (lQueueInd > NQUEUES - 1) lQueueInd = NQUEUES - 1;
             aqQueue[lQueueInd].push(lLinInd);
+            if (lQueueInd < iFirstQueue) iFirstQueue = int(lQueueInd);
         }
-        
-        lLinInd = fPop();
-        if (lLinInd < 0) {
-            delete [] aqQueue;
-            delete [] pbCandidate;
-            return;
+
+        // Pop from the highest priority (0) non-empty queue the first
+        // entry which fulfills the region growing criterion
+        lLinInd = -1;
+        for (; (iFirstQueue < NQUEUES) && (lLinInd < 0); iFirstQueue++) {
+            CRingQueue &qQueue = aqQueue[iFirstQueue];
+            while (!qQueue.empty()) {
+                long lInd = qQueue.pop();
+                if (fabs(dRegMean - pdImg[lInd]) < dMaxDif) { lLinInd = lInd; break; }
+            }
+            if (lLinInd >= 0) break;
         }
-        
+        if (lLinInd < 0) break; // if all queues are empty
+
         pbMask[lLinInd] = true;
         dRegMean = (dRegMean*double(lRegSize) + pdImg[lLinInd]);
         lRegSize++;
         dRegMean = dRegMean/double(lRegSize);
-        
-        if (!(lIterations % lUpdateCycle) && bDraw) {
-            mexCallMATLAB(0, 0, 2, pParams, "feval");
+
+        if (!(lIterations % lUpdateCycle) && pParams) {
+            mxArray *pError = mexCallMATLABWithTrap(0, 0, 2, pParams, "feval");
+            if (pError) {
+                fClearCandidates(pRG);
+                mexCallMATLAB(0, 0, 1, &pError, "rethrow");
+            }
         }
         lIterations++;
     }
     // End of while loop
     // --------------------------------------------------------------------
-    
-    delete [] aqQueue;
-    delete [] pbCandidate;
+
+    fClearCandidates(pRG);
+}
+// ========================================================================
+// *** END OF FUNCTION fRegionGrow
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTIONS fFind and fUnion
+// ***
+// *** Concurrent union-find: the root of a set is its smallest index, a
+// *** root is linked below a smaller root by compare-and-swap, and find
+// *** halves the paths it walks.
+// ***
+// ========================================================================
+inline long fFind(atomic<long> *plParent, long lInd)
+{
+    long lParent = plParent[lInd].load(memory_order_relaxed);
+    while (lParent != lInd) {
+        long lGrand = plParent[lParent].load(memory_order_relaxed);
+        if (lGrand != lParent)
+            plParent[lInd].compare_exchange_weak(lParent, lGrand, memory_order_relaxed);
+        lInd = lParent;
+        lParent = plParent[lInd].load(memory_order_relaxed);
+    }
+    return lInd;
+}
+
+inline void fUnion(atomic<long> *plParent, long lA, long lB)
+{
+    while (true) {
+        lA = fFind(plParent, lA);
+        lB = fFind(plParent, lB);
+        if (lA == lB) return;
+        if (lA < lB) { long lT = lA; lA = lB; lB = lT; }
+        long lExpected = lA; // lA is still a root if the swap succeeds
+        if (plParent[lA].compare_exchange_strong(lExpected, lB)) return;
+    }
+}
+// ========================================================================
+// *** END OF FUNCTIONS fFind and fUnion
+// ========================================================================
+
+
+
+inline bool fRootLess(const pair<long, unsigned int> &a, const pair<long, unsigned int> &b)
+{
+    return a.first < b.first;
+}
+
+// ========================================================================
+// ***
+// *** FUNCTION fFloodSeeds
+// ***
+// *** Multi-seed mode: union of all neighbouring voxels with an intensity
+// *** difference below dMaxDif (in parallel over the voxels), then every
+// *** voxel gets the number of the first seed in its component.
+// ***
+// ========================================================================
+void fFloodSeeds(SRegionGrowing *pRG, const double *pdImg, const vector<long> &alSeeds,
+                 double dMaxDif, unsigned int *piLabel)
+{
+    long lImSize = pRG->lImSize;
+    const unsigned char *piNHood = &pRG->aiNHood[0];
+    vector< atomic<long> > alParent(lImSize);
+    atomic<long> *plParent = &alParent[0];
+    long lI;
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (lI = 0; lI < lImSize; lI++) plParent[lI].store(lI, memory_order_relaxed);
+
+    // Only the forward neighbours, every edge is visited once
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 4096)
+#endif
+    for (lI = 0; lI < lImSize; lI++) {
+        unsigned char iBits = piNHood[lI];
+        for (int iI = 1; iI < pRG->iNOffsets; iI += 2) {
+            if (!(iBits & (1 << iI))) continue;
+            long lNeighbour = lI + pRG->alOffset[iI];
+            if (fabs(pdImg[lI] - pdImg[lNeighbour]) < dMaxDif) fUnion(plParent, lI, lNeighbour);
+        }
+    }
+
+    // Roots of the seed components, sorted for the lookup, the first seed
+    // of a component wins
+    vector< pair<long, unsigned int> > aRoots;
+    for (size_t lS = 0; lS < alSeeds.size(); lS++)
+        aRoots.push_back(make_pair(fFind(plParent, alSeeds[lS]), (unsigned int)(lS + 1)));
+    stable_sort(aRoots.begin(), aRoots.end(), fRootLess);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (lI = 0; lI < lImSize; lI++) {
+        long lRoot = fFind(plParent, lI);
+        vector< pair<long, unsigned int> >::const_iterator it =
+            lower_bound(aRoots.begin(), aRoots.end(), make_pair(lRoot, 0u), fRootLess);
+        piLabel[lI] = ((it != aRoots.end()) && (it->first == lRoot)) ? it->second : 0;
+    }
+}
+// ========================================================================
+// *** END OF FUNCTION fFloodSeeds
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTION fGetSeeds
+// ***
+// *** Linear indices of the seed point coordinates (one-based, of class
+// *** int16, uint16 or double). A vector is one seed, of which the first
+// *** ndims(Image) elements are used (as before), else the seeds are the
+// *** columns of a ndims(Image) x N matrix.
+// ***
+// ========================================================================
+void fGetSeeds(const mxArray *pSeed, SRegionGrowing *pRG, vector<long> &alSeeds)
+{
+    long lNCoords = (pRG->lNZ > 1) ? 3 : 2;
+    long lNSeeds;
+    if (((mxGetM(pSeed) == 1) || (mxGetN(pSeed) == 1)) && (mxGetNumberOfElements(pSeed) <= 3)) {
+        lNSeeds = 1;
+        if (long(mxGetNumberOfElements(pSeed)) < lNCoords)
+            mexErrMsgTxt("Seed point must have ndims(Image) coordinates.");
+    } else {
+        lNSeeds = long(mxGetN(pSeed));
+        if (long(mxGetM(pSeed)) != lNCoords)
+            mexErrMsgTxt("Seed points must be a ndims(Image) x N matrix.");
+    }
+
+    long lDims[3] = {pRG->lNY, pRG->lNX, pRG->lNZ};
+    alSeeds.resize(lNSeeds);
+    for (long lS = 0; lS < lNSeeds; lS++) {
+        long lCoord[3] = {0, 0, 0};
+        for (long lC = 0; lC < lNCoords; lC++) {
+            long lI = lS*lNCoords + lC;
+            switch (mxGetClassID(pSeed)) {
+                case mxDOUBLE_CLASS: lCoord[lC] = long(mxGetPr(pSeed)[lI]) - 1; break;
+                case mxINT16_CLASS:
+                case mxUINT16_CLASS: lCoord[lC] = long(((short*) mxGetData(pSeed))[lI]) - 1; break;
+                default: mexErrMsgTxt("Seed points must be of type int16, uint16 or double.");
+            }
+            if ((lCoord[lC] < 0) || (lCoord[lC] >= lDims[lC])) mexErrMsgTxt("Seed point outside the image.");
+        }
+        alSeeds[lS] = lCoord[0] + lCoord[1]*pRG->lNY + lCoord[2]*pRG->lNX*pRG->lNY;
+    }
+}
+// ========================================================================
+// *** END OF FUNCTION fGetSeeds
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** FUNCTIONS fGetHandle and fCloseHandles
+// ***
+// *** The cached engines are addressed by a uint32 handle (one-based
+// *** index), and freed when the mex file is cleared.
+// ***
+// ========================================================================
+long fGetHandle(const mxArray *pHandle)
+{
+    if ((mxGetClassID(pHandle) != mxUINT32_CLASS) || (mxGetNumberOfElements(pHandle) != 1))
+        mexErrMsgTxt("Handle must be a uint32 scalar.");
+    long lH = long(*(unsigned int*) mxGetData(pHandle)) - 1;
+    if ((lH < 0) || (lH >= NHANDLES) || !apRGHandles[lH]) mexErrMsgTxt("Handle is not valid.");
+    return lH;
+}
+
+void fCloseHandles()
+{
+    for (int iH = 0; iH < NHANDLES; iH++) {
+        delete apRGHandles[iH];
+        apRGHandles[iH] = 0;
+    }
+}
+// ========================================================================
+// *** END OF FUNCTIONS fGetHandle and fCloseHandles
+// ========================================================================
+
+
+
+// ========================================================================
+// ***
+// *** MAIN MEX FUNCTION RegionGrowing_mex
+// ***
+// *** See m-file and the top of this file for description
+// ***
+// ========================================================================
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+    mexAtExit(fCloseHandles);
+
+    // --------------------------------------------------------------------
+    // Handle commands: 'open' an image, 'close' a handle
+    if ((nrhs > 0) && mxIsChar(prhs[0])) {
+        char sCommand[8];
+        mxGetString(prhs[0], sCommand, sizeof(sCommand));
+        if (!strcmp(sCommand, "open")) {
+            if (nrhs != 2) mexErrMsgTxt("Usage: hRG = RegionGrowing_mex('open', dImg)");
+            if (!mxIsDouble(prhs[1])) mexErrMsgTxt("Image must be of type double.");
+            int iH = 0;
+            while ((iH < NHANDLES) && apRGHandles[iH]) iH++;
+            if (iH == NHANDLES) mexErrMsgTxt("Too many open handles, close some first.");
+            apRGHandles[iH] = new SRegionGrowing;
+            fInitRegionGrowing(apRGHandles[iH], prhs[1]);
+            plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT32_CLASS, mxREAL);
+            *(unsigned int*) mxGetData(plhs[0]) = (unsigned int)(iH + 1);
+        } else if (!strcmp(sCommand, "close")) {
+            if (nrhs != 2) mexErrMsgTxt("Usage: RegionGrowing_mex('close', hRG)");
+            long lH = fGetHandle(prhs[1]);
+            delete apRGHandles[lH];
+            apRGHandles[lH] = 0;
+        } else {
+            mexErrMsgTxt("Unknown command, use 'open' or 'close'.");
+        }
+        return;
+    }
+
+    // --------------------------------------------------------------------
+    // With a handle as first argument the other arguments are shifted
+    SRegionGrowing  RGTemp;
+    SRegionGrowing *pRG = &RGTemp;
+    int iArg = 0;
+    if ((nrhs > 0) && (mxGetClassID(prhs[0]) == mxUINT32_CLASS)) {
+        pRG = apRGHandles[fGetHandle(prhs[0])];
+        iArg = 1;
+    }
+
+    // --------------------------------------------------------------------
+    // Check the number of the input and output arguments.
+    if(nrhs - iArg < 3)  mexErrMsgTxt("At least 3 input arguments required.");
+    if(nlhs != 1) mexErrMsgTxt("Exactly one ouput argument required.");
+    // --------------------------------------------------------------------
+
+    // --------------------------------------------------------------------
+    // Get pointer/values to/of the input and outputs objects
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // 1st input: Image (get dimensions as well)
+    if (!mxIsDouble(prhs[iArg])) mexErrMsgTxt("First input argument must be of type double.");
+    const double *pdImg = (const double*) mxGetData(prhs[iArg]);
+    if (pRG == &RGTemp) {
+        fInitRegionGrowing(pRG, prhs[iArg]);
+    } else if (long(mxGetNumberOfElements(prhs[iArg])) != pRG->lImSize) {
+        mexErrMsgTxt("Image does not match the handle.");
+    }
+    const mwSize* pSize = mxGetDimensions(prhs[iArg]);
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // 2nd input: Seed point coordinates.
+    vector<long> alSeeds;
+    fGetSeeds(prhs[iArg + 1], pRG, alSeeds);
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // 3rd input: RG stoping difference.
+    double dMaxDif = double(*mxGetPr(prhs[iArg + 2]));
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // Several seeds: parallel flood, label output
+    if (alSeeds.size() > 1) {
+        plhs[0] = mxCreateNumericArray(pRG->lNDims, pSize, mxUINT32_CLASS, mxREAL);
+        fFloodSeeds(pRG, pdImg, alSeeds, dMaxDif, (unsigned int*) mxGetData(plhs[0]));
+        return;
+    }
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // Get pointer to output arguments and allocate memory for the corresponding objects
+    plhs[0] = mxCreateNumericArray(pRG->lNDims, pSize, mxLOGICAL_CLASS, mxREAL);	// create output array
+    bool *pbMask = (bool*) mxGetData(plhs[0]);						// get data pointer to mask
+
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // Create a parameter array for the call of the drawing function
+    mxArray *pParams[2];
+    bool bDraw = false;
+    if (nrhs - iArg > 3) {
+        pParams[0] = const_cast<mxArray *>(prhs[iArg + 3]);
+        pParams[1] = const_cast<mxArray *>(plhs[0]);
+        bDraw = true;
+    }
+
+    // --------------------------------------------------------------------
+    // Start of the real functionality
+    fRegionGrow(pRG, pdImg, alSeeds[0], dMaxDif, pbMask, bDraw ? pParams : 0);
 }
 // ========================================================================
 // *** END OF MAIN MEX FUNCTION RegionGrowing_mex
@@ -10,6 +10,16 @@ function lMask = RegionGrowing(dImg, dMaxDif, iSeed)
 %   If the seed point is not supplied, a GUI lets you select it. If no
 %   output is requested, the result of the region growing is visualized
 %
+%   lLABEL = REGIONGROWING(dIMG, dMAXDIF, iSEEDS) with several seed points
+%   (one per column) floods all seeds at once in parallel: neighbouring
+%   voxels are connected if their intensities differ less than dMAXDIF,
+%   and lLABEL holds for each voxel the number of the first seed in its
+%   connected component (0 if none).
+%
+%   For repeated seeds on the same image, open a handle with
+%   hRG = RegionGrowing_mex('open', dImg) and call
+%   RegionGrowing_mex(hRG, dImg, iSeed, dMaxDif), see RegionGrowing_mex.cpp.
+%
 % IMPORTANT NOTE: This Matlab function is a front-end for a fast mex
 % function. Compile it by making the directiory containing this file your
 % current Matlab working directory and typing
@@ -48,8 +58,8 @@ if nargin < 3
     iSeed = uint16(fGetSeed(dImg));
     if isempty(iSeed), return; end
 else
-    if numel(iSeed) ~= ndims(dImg), error('Invalid seed point! Must have ndims(dImg) elements!'); end
-    iSeed = uint16(iSeed(:));
+    if isempty(iSeed) || mod(numel(iSeed), ndims(dImg)) ~= 0, error('Invalid seed point! Must have ndims(dImg) elements!'); end
+    iSeed = uint16(reshape(iSeed, ndims(dImg), []));
 end
 % -------------------------------------------------------------------------
 
@@ -88,7 +98,7 @@ if ~nargout
     dImg = dImg./max(dImg(:));
     dImg = permute(dImg, [1 2 4 3]); % Change to RGB-mode
     dImg = repmat(dImg, [1 1 3 1]);
-    dMask = double(permute(lMask, [1 2 4 3])); 
+    dMask = double(permute(lMask > 0, [1 2 4 3])); 
     dMask = cat(3, dMask, zeros(size(dMask)), zeros(size(dMask))); % Make mask the red channel -> red overlay
     
     dImg = 1 - (1 - dImg).*(1 - dOPACITY.*dMask); % The 'screen' overlay mode